@@ -134,12 +134,14 @@ Array DebuggerMarshalls::ServersProfilerFrame::serialize() {
 		}
 	}
 
-	arr.push_back(script_functions.size() * 4);
+	arr.push_back(script_functions.size() * 6);
 	for (int i = 0; i < script_functions.size(); i++) {
 		arr.push_back(script_functions[i].sig_id);
 		arr.push_back(script_functions[i].call_count);
 		arr.push_back(script_functions[i].self_time);
 		arr.push_back(script_functions[i].total_time);
+		arr.push_back(script_functions[i].inline_cache_hits);
+		arr.push_back(script_functions[i].inline_cache_misses);
 	}
 	return arr;
 }
@@ -175,14 +177,16 @@ bool DebuggerMarshalls::ServersProfilerFrame::deserialize(const Array &p_arr) {
 	int func_size = p_arr[idx];
 	idx += 1;
 	CHECK_SIZE(p_arr, idx + func_size, "ServersProfilerFrame");
-	for (int i = 0; i < func_size / 4; i++) {
+	for (int i = 0; i < func_size / 6; i++) {
 		ScriptFunctionInfo fi;
 		fi.sig_id = p_arr[idx];
 		fi.call_count = p_arr[idx + 1];
 		fi.self_time = p_arr[idx + 2];
 		fi.total_time = p_arr[idx + 3];
+		fi.inline_cache_hits = p_arr[idx + 4];
+		fi.inline_cache_misses = p_arr[idx + 5];
 		script_functions.push_back(fi);
-		idx += 4;
+		idx += 6;
 	}
 	CHECK_END(p_arr, idx, "ServersProfilerFrame");
 	return true;
@@ -85,6 +85,8 @@ struct DebuggerMarshalls {
 		int call_count = 0;
 		float self_time = 0;
 		float total_time = 0;
+		int inline_cache_hits = 0;
+		int inline_cache_misses = 0;
 	};
 
 	// Servers profiler
@@ -106,6 +106,9 @@ struct LocalDebugger::ScriptsProfiler {
 			float tt = USEC_TO_SEC(pinfo[i].total_time);
 			float st = USEC_TO_SEC(pinfo[i].self_time);
 			print_line("\ttotal: " + rtos(tt) + "/" + itos(tt * 100 / total_time) + " % \tself: " + rtos(st) + "/" + itos(st * 100 / total_time) + " % tcalls: " + itos(pinfo[i].call_count));
+			if (pinfo[i].inline_cache_hits || pinfo[i].inline_cache_misses) {
+				print_line("\tinline cache hits: " + itos(pinfo[i].inline_cache_hits) + " misses: " + itos(pinfo[i].inline_cache_misses));
+			}
 		}
 	}
 
@@ -261,6 +261,8 @@ struct RemoteDebugger::ScriptsProfiler {
 			w[i].call_count = ptrs[i]->call_count;
 			w[i].total_time = ptrs[i]->total_time / 1000000.0;
 			w[i].self_time = ptrs[i]->self_time / 1000000.0;
+			w[i].inline_cache_hits = ptrs[i]->inline_cache_hits;
+			w[i].inline_cache_misses = ptrs[i]->inline_cache_misses;
 		}
 	}
 
@@ -386,6 +386,9 @@ public:
 		uint64_t call_count;
 		uint64_t total_time;
 		uint64_t self_time;
+		// Untyped member accesses and calls that could reuse an earlier lookup, or had to do it again.
+		uint64_t inline_cache_hits = 0;
+		uint64_t inline_cache_misses = 0;
 	};
 
 	virtual void profiling_start() = 0;
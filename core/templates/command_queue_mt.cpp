@@ -46,6 +46,17 @@ void CommandQueueMT::wait_for_flush() {
 	OS::get_singleton()->delay_usec(1000);
 }
 
+void CommandQueueMT::wait_for_commands() {
+	// Announce the consumer is going to sleep, then check again so a commit
+	// happening in between either is seen here or sees the flag and posts.
+	consumer_sleeping.store(true, std::memory_order_seq_cst);
+	if (read_ptr_and_epoch != committed_write_ptr_and_epoch.load(std::memory_order_seq_cst)) {
+		consumer_sleeping.store(false, std::memory_order_relaxed);
+		return;
+	}
+	sync->wait();
+}
+
 CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 	int idx = -1;
 
@@ -77,7 +88,7 @@ tryagain:
 		return false;
 	}
 
-	uint32_t size = *(uint32_t *)&command_mem[dealloc_ptr];
+	uint32_t size = _get_header(dealloc_ptr)->load(std::memory_order_acquire);
 
 	if (size == 0) {
 		// End of command buffer wrap down
@@ -91,9 +102,24 @@ tryagain:
 	}
 
 	dealloc_ptr += (size >> 1) + 8;
+	// The memory may be reused now, forget about commands that could still be coalesced.
+	coalesce_generation++;
 	return true;
 }
 
+CommandQueueMT::Stats CommandQueueMT::get_stats() {
+	lock();
+	Stats ret = stats;
+	unlock();
+	return ret;
+}
+
+void CommandQueueMT::reset_stats() {
+	lock();
+	stats = Stats();
+	unlock();
+}
+
 CommandQueueMT::CommandQueueMT(bool p_sync) {
 	command_mem_size = GLOBAL_DEF_RST("memory/limits/command_queue/multithreading_queue_size_kb", DEFAULT_COMMAND_MEM_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/command_queue/multithreading_queue_size_kb", PropertyInfo(Variant::INT, "memory/limits/command_queue/multithreading_queue_size_kb", PROPERTY_HINT_RANGE, "1,4096,1,or_greater"));
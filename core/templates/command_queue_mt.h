@@ -34,9 +34,12 @@
 #include "core/os/memory.h"
 #include "core/os/mutex.h"
 #include "core/os/semaphore.h"
+#include "core/templates/hashfuncs.h"
 #include "core/templates/simple_type.h"
 #include "core/typedefs.h"
 
+#include <atomic>
+
 #define COMMA(N) _COMMA_##N
 #define _COMMA_0
 #define _COMMA_1 ,
@@ -252,9 +255,18 @@
 		cmd->instance = p_instance;                                          \
 		cmd->method = p_method;                                              \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
-		unlock();                                                            \
-		if (sync)                                                            \
-			sync->post();                                                    \
+		commit_and_unlock();                                                 \
+	}
+
+#define DECL_PUSH_COALESCED(N)                                                                         \
+	template <class T, class M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>                                 \
+	void push_coalesced(uint64_t p_key, T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
+		CMD_TYPE(N) *cmd = allocate_and_lock<CMD_TYPE(N)>();                                           \
+		cmd->instance = p_instance;                                                                    \
+		cmd->method = p_method;                                                                        \
+		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                           \
+		supersede_coalesced(p_key, p_instance, cmd);                                                   \
+		commit_and_unlock();                                                                           \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -269,9 +281,7 @@
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
 		cmd->sync_sem = ss;                                                                    \
-		unlock();                                                                              \
-		if (sync)                                                                              \
-			sync->post();                                                                      \
+		commit_and_unlock();                                                                   \
 		ss->sem.wait();                                                                        \
 		ss->in_use = false;                                                                    \
 	}
@@ -287,15 +297,18 @@
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
 		cmd->sync_sem = ss;                                                           \
-		unlock();                                                                     \
-		if (sync)                                                                     \
-			sync->post();                                                             \
+		commit_and_unlock();                                                          \
 		ss->sem.wait();                                                               \
 		ss->in_use = false;                                                           \
 	}
 
 #define MAX_CMD_PARAMS 15
 
+// The queue has a single consumer (the server thread, or whoever calls
+// flush_all() when there is none) and any number of producers.
+// Producers serialize among themselves on a lock, the consumer never takes it:
+// commands become visible to it through an atomic write pointer, and it hands
+// memory back by clearing the 'in use' bit of each command header.
 class CommandQueueMT {
 	struct SyncSemaphore {
 		Semaphore sem;
@@ -329,19 +342,81 @@ class CommandQueueMT {
 
 	/***** BASE *******/
 
+public:
+	enum {
+		STATS_SIZE_BUCKETS = 8
+	};
+
+	struct Stats {
+		uint64_t commands = 0; // Commands written to the ring.
+		uint64_t coalesced = 0; // Pending commands skipped because a later push superseded them.
+		uint64_t bytes = 0; // Ring memory used by commands, including headers.
+		uint32_t max_command_size = 0;
+		// Commands by size, bucket i counts sizes up to 16 << i bytes (the last one also counts larger sizes).
+		uint64_t size_histogram[STATS_SIZE_BUCKETS] = {};
+		uint64_t full_waits = 0; // Times a producer had to wait for the consumer to make room.
+		uint64_t wakeups = 0; // Times the consumer thread was woken up.
+	};
+
+private:
 	enum {
 		DEFAULT_COMMAND_MEM_SIZE_KB = 256,
-		SYNC_SEMAPHORES = 8
+		SYNC_SEMAPHORES = 8,
+		COALESCE_SLOTS = 256,
+	};
+
+	// Second word of each command header, tells whether a later push may still supersede the command.
+	enum CommandState : uint32_t {
+		COMMAND_STATE_FIXED, // Regular command, always runs.
+		COMMAND_STATE_PENDING, // Coalescable and not flushed yet.
+		COMMAND_STATE_SUPERSEDED, // A later push replaced it, the consumer skips it.
+		COMMAND_STATE_CLAIMED, // The consumer took it, can no longer be superseded.
+	};
+
+	struct CoalesceSlot {
+		uint64_t key = 0;
+		const void *instance = nullptr;
+		const void *type = nullptr;
+		uint32_t offset = 0;
+		uint64_t generation = 0;
 	};
 
+	static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free, "Command headers are accessed atomically in place.");
+
 	uint8_t *command_mem = nullptr;
-	uint32_t read_ptr_and_epoch = 0;
-	uint32_t write_ptr_and_epoch = 0;
+	uint32_t read_ptr_and_epoch = 0; // Consumer side.
+	uint32_t write_ptr_and_epoch = 0; // Producer side, only visible to the consumer once committed.
+	std::atomic<uint32_t> committed_write_ptr_and_epoch = { 0 };
 	uint32_t dealloc_ptr = 0;
 	uint32_t command_mem_size = 0;
 	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
 	Mutex mutex;
 	Semaphore *sync = nullptr;
+	std::atomic<bool> consumer_sleeping = { false };
+
+	// Commands pushed with push_coalesced(), valid until the ring memory they live in is deallocated.
+	CoalesceSlot coalesce_slots[COALESCE_SLOTS];
+	uint64_t coalesce_generation = 1;
+
+	Stats stats;
+
+	_FORCE_INLINE_ std::atomic<uint32_t> *_get_header(uint32_t p_ptr) {
+		return reinterpret_cast<std::atomic<uint32_t> *>(&command_mem[p_ptr]);
+	}
+
+	_FORCE_INLINE_ std::atomic<uint32_t> *_get_state(const void *p_cmd) {
+		return reinterpret_cast<std::atomic<uint32_t> *>((uint8_t *)p_cmd - sizeof(uint32_t));
+	}
+
+	template <class C>
+	static const void *_get_coalesce_type() {
+		static const char type = 0;
+		return &type;
+	}
+
+	_FORCE_INLINE_ CoalesceSlot &_get_coalesce_slot(uint64_t p_key, const void *p_instance, const void *p_type) {
+		return coalesce_slots[hash_one_uint64(p_key ^ (uint64_t)(uintptr_t)p_instance ^ (uint64_t)(uintptr_t)p_type) & (COALESCE_SLOTS - 1)];
+	}
 
 	template <class T>
 	T *allocate() {
@@ -382,14 +457,11 @@ class CommandQueueMT {
 				ERR_FAIL_COND_V((command_mem_size - write_ptr) < 8, nullptr);
 				// zero means, wrap to beginning
 
-				uint32_t *p = (uint32_t *)&command_mem[write_ptr];
-				*p = 1;
+				_get_header(write_ptr)->store(1, std::memory_order_relaxed);
 				write_ptr_and_epoch = 0 | (1 & ~write_ptr_and_epoch); // Invert epoch.
 				// See if we can get the thread to run and clear up some more space while we wait.
 				// This is required if alloc_size * 2 + 4 > COMMAND_MEM_SIZE
-				if (sync) {
-					sync->post();
-				}
+				commit();
 				goto tryagain;
 			}
 		}
@@ -397,22 +469,34 @@ class CommandQueueMT {
 		// First bit used to mark if command is still in use (1)
 		// or if it has been destroyed and can be deallocated (0).
 		uint32_t size = (sizeof(T) + 8 - 1) & ~(8 - 1);
-		uint32_t *p = (uint32_t *)&command_mem[write_ptr];
-		*p = (size << 1) | 1;
+		_get_header(write_ptr)->store((size << 1) | 1, std::memory_order_relaxed);
+		_get_header(write_ptr + sizeof(uint32_t))->store(COMMAND_STATE_FIXED, std::memory_order_relaxed);
 		write_ptr += 8;
 		// allocate the command
 		T *cmd = memnew_placement(&command_mem[write_ptr], T);
 		write_ptr += size;
 		write_ptr_and_epoch = (write_ptr << 1) | (write_ptr_and_epoch & 1);
+
+		stats.commands++;
+		stats.bytes += size + 8;
+		stats.max_command_size = MAX(stats.max_command_size, size);
+		uint32_t bucket = 0;
+		while (bucket < STATS_SIZE_BUCKETS - 1 && (16u << bucket) < size) {
+			bucket++;
+		}
+		stats.size_histogram[bucket]++;
 		return cmd;
 	}
 
+	// Producers still serialize on the mutex: the lock covers only writing a command into the
+	// ring (and the coalescing table), never the consumer, which runs commands lock-free.
 	template <class T>
 	T *allocate_and_lock() {
 		lock();
 		T *ret;
 
 		while ((ret = allocate<T>()) == nullptr) {
+			stats.full_waits++;
 			unlock();
 			// sleep a little until fetch happened and some room is made
 			wait_for_flush();
@@ -422,26 +506,58 @@ class CommandQueueMT {
 		return ret;
 	}
 
-	bool flush_one(bool p_lock = true) {
-		if (p_lock) {
-			lock();
+	// Makes everything written so far visible to the consumer, waking it up if it went to sleep.
+	// Must be called with the lock held.
+	void commit() {
+		committed_write_ptr_and_epoch.store(write_ptr_and_epoch, std::memory_order_seq_cst);
+		if (sync && consumer_sleeping.exchange(false, std::memory_order_seq_cst)) {
+			stats.wakeups++;
+			sync->post();
 		}
+	}
+
+	void commit_and_unlock() {
+		commit();
+		unlock();
+	}
+
+	// Makes p_cmd the pending command for its key and cancels the previous one, if the consumer
+	// didn't take it yet. Must be called with the lock held, before p_cmd is committed.
+	template <class C, class T>
+	void supersede_coalesced(uint64_t p_key, T *p_instance, C *p_cmd) {
+		const void *type = _get_coalesce_type<C>();
+		CoalesceSlot &slot = _get_coalesce_slot(p_key, p_instance, type);
+		if (slot.generation == coalesce_generation && slot.key == p_key && slot.instance == p_instance && slot.type == type) {
+			C *previous = reinterpret_cast<C *>(&command_mem[slot.offset]);
+			uint32_t expected = COMMAND_STATE_PENDING;
+			// Commands are never rewritten, so the method can be read even while the consumer runs it.
+			if (previous->method == p_cmd->method && _get_state(previous)->compare_exchange_strong(expected, COMMAND_STATE_SUPERSEDED, std::memory_order_relaxed)) {
+				stats.coalesced++;
+			}
+		}
+
+		slot.key = p_key;
+		slot.instance = p_instance;
+		slot.type = type;
+		slot.offset = (uint8_t *)p_cmd - command_mem;
+		slot.generation = coalesce_generation;
+		_get_state(p_cmd)->store(COMMAND_STATE_PENDING, std::memory_order_relaxed);
+	}
+
+	bool flush_one() {
 	tryagain:
 
 		// tried to read an empty queue
-		if (read_ptr_and_epoch == write_ptr_and_epoch) {
-			if (p_lock) {
-				unlock();
-			}
+		if (read_ptr_and_epoch == committed_write_ptr_and_epoch.load(std::memory_order_acquire)) {
 			return false;
 		}
 
 		uint32_t read_ptr = read_ptr_and_epoch >> 1;
 		uint32_t size_ptr = read_ptr;
-		uint32_t size = *(uint32_t *)&command_mem[read_ptr] >> 1;
+		uint32_t size = _get_header(read_ptr)->load(std::memory_order_relaxed) >> 1;
 
 		if (size == 0) {
-			*(uint32_t *)&command_mem[read_ptr] = 0; // clear in-use bit.
+			_get_header(read_ptr)->store(0, std::memory_order_release); // clear in-use bit.
 			//end of ringbuffer, wrap
 			read_ptr_and_epoch = 0 | (1 & ~read_ptr_and_epoch); // Invert epoch.
 			goto tryagain;
@@ -455,27 +571,28 @@ class CommandQueueMT {
 
 		read_ptr_and_epoch = (read_ptr << 1) | (read_ptr_and_epoch & 1);
 
-		if (p_lock) {
-			unlock();
-		}
-		cmd->call();
-		if (p_lock) {
-			lock();
+		bool superseded = false;
+		std::atomic<uint32_t> *state = _get_state(cmd);
+		if (state->load(std::memory_order_relaxed) != COMMAND_STATE_FIXED) {
+			// Coalescable, claim it so a later push can no longer supersede it.
+			uint32_t expected = COMMAND_STATE_PENDING;
+			superseded = !state->compare_exchange_strong(expected, COMMAND_STATE_CLAIMED, std::memory_order_relaxed);
 		}
 
+		if (!superseded) {
+			cmd->call();
+		}
 		cmd->post();
 		cmd->~CommandBase();
-		*(uint32_t *)&command_mem[size_ptr] &= ~1;
+		_get_header(size_ptr)->store(size << 1, std::memory_order_release); // clear in-use bit.
 
-		if (p_lock) {
-			unlock();
-		}
 		return true;
 	}
 
 	void lock();
 	void unlock();
 	void wait_for_flush();
+	void wait_for_commands();
 	SyncSemaphore *_alloc_sync_sem();
 	bool dealloc_one();
 
@@ -484,6 +601,13 @@ public:
 	DECL_PUSH(0)
 	SPACE_SEP_LIST(DECL_PUSH, 15)
 
+	/* PUSH COMMANDS THAT REPLACE A PENDING ONE WITH THE SAME KEY */
+	// Only meant for setters where the last call wins: when a command for the same
+	// key, instance and method has not been flushed yet, it is skipped. The new command
+	// is always appended, so it still runs after anything pushed in between.
+	DECL_PUSH_COALESCED(0)
+	SPACE_SEP_LIST(DECL_PUSH_COALESCED, 15)
+
 	/* PUSH AND RET COMMANDS */
 	DECL_PUSH_AND_RET(0)
 	SPACE_SEP_LIST(DECL_PUSH_AND_RET, 15)
@@ -494,23 +618,25 @@ public:
 
 	void wait_and_flush_one() {
 		ERR_FAIL_COND(!sync);
-		sync->wait();
-		flush_one();
+		while (!flush_one()) {
+			wait_for_commands();
+		}
 	}
 
 	_FORCE_INLINE_ void flush_if_pending() {
-		if (unlikely(read_ptr_and_epoch != write_ptr_and_epoch)) {
+		if (unlikely(read_ptr_and_epoch != committed_write_ptr_and_epoch.load(std::memory_order_acquire))) {
 			flush_all();
 		}
 	}
 	void flush_all() {
 		//ERR_FAIL_COND(sync);
-		lock();
-		while (flush_one(false)) {
+		while (flush_one()) {
 		}
-		unlock();
 	}
 
+	Stats get_stats();
+	void reset_stats();
+
 	CommandQueueMT(bool p_sync);
 	~CommandQueueMT();
 };
@@ -526,6 +652,7 @@ public:
 #undef CMD_TYPE
 #undef CMD_ASSIGN_PARAM
 #undef DECL_PUSH
+#undef DECL_PUSH_COALESCED
 #undef CMD_RET_TYPE
 #undef DECL_PUSH_AND_RET
 #undef CMD_SYNC_TYPE
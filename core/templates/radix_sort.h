@@ -0,0 +1,191 @@
+/*************************************************************************/
+/*  radix_sort.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include "core/templates/local_vector.h"
+#include "core/templates/thread_work_pool.h"
+#include "core/typedefs.h"
+
+// Stable least significant digit radix sort on 128 bit keys, given by Keys as
+// a high and a low 64 bit word. Bytes that are the same in every key are
+// skipped, so keys packing a few narrow fields only pay for the ones that vary.
+// Large arrays are counted and scattered in parallel when a ThreadWorkPool is given.
+
+template <class T, class Keys>
+class RadixSort {
+	enum {
+		DIGITS = 16,
+		BUCKETS = 256,
+		PARALLEL_THRESHOLD = 8192,
+		CHUNK_SIZE = 4096,
+	};
+
+	struct Element {
+		uint64_t key[2]; // Low, high.
+		T value;
+	};
+
+	LocalVector<Element> elements[2];
+	LocalVector<uint32_t> gather_counts; // Chunks * DIGITS * BUCKETS.
+	LocalVector<uint32_t> chunk_offsets; // Chunks * BUCKETS.
+
+	T *array = nullptr;
+	uint32_t size = 0;
+	uint32_t chunk_size = 0;
+	uint32_t chunk_count = 0;
+	uint32_t digit = 0;
+	uint32_t src = 0;
+	Keys keys;
+
+	_FORCE_INLINE_ static uint32_t _get_digit(const Element &p_element, uint32_t p_digit) {
+		return (p_element.key[p_digit >> 3] >> ((p_digit & 7) << 3)) & 0xFF;
+	}
+
+	void _gather_chunk(uint32_t p_chunk, void *p_userdata) {
+		uint32_t from = p_chunk * chunk_size;
+		uint32_t to = MIN(from + chunk_size, size);
+		uint32_t *counts = &gather_counts[p_chunk * DIGITS * BUCKETS];
+		memset(counts, 0, sizeof(uint32_t) * DIGITS * BUCKETS);
+
+		Element *dst = elements[0].ptr();
+		for (uint32_t i = from; i < to; i++) {
+			Element &e = dst[i];
+			e.value = array[i];
+			e.key[0] = keys.get_low(array[i]);
+			e.key[1] = keys.get_high(array[i]);
+			for (uint32_t j = 0; j < DIGITS; j++) {
+				counts[j * BUCKETS + _get_digit(e, j)]++;
+			}
+		}
+	}
+
+	void _count_chunk(uint32_t p_chunk, void *p_userdata) {
+		uint32_t from = p_chunk * chunk_size;
+		uint32_t to = MIN(from + chunk_size, size);
+		uint32_t *counts = &chunk_offsets[p_chunk * BUCKETS];
+		memset(counts, 0, sizeof(uint32_t) * BUCKETS);
+
+		const Element *s = elements[src].ptr();
+		for (uint32_t i = from; i < to; i++) {
+			counts[_get_digit(s[i], digit)]++;
+		}
+	}
+
+	void _scatter_chunk(uint32_t p_chunk, void *p_userdata) {
+		uint32_t from = p_chunk * chunk_size;
+		uint32_t to = MIN(from + chunk_size, size);
+		uint32_t *offsets = &chunk_offsets[p_chunk * BUCKETS];
+
+		const Element *s = elements[src].ptr();
+		Element *d = elements[src ^ 1].ptr();
+		for (uint32_t i = from; i < to; i++) {
+			d[offsets[_get_digit(s[i], digit)]++] = s[i];
+		}
+	}
+
+	void _run(ThreadWorkPool *p_pool, void (RadixSort::*p_method)(uint32_t, void *)) {
+		if (p_pool) {
+			p_pool->do_work(chunk_count, this, p_method, (void *)nullptr);
+		} else {
+			for (uint32_t i = 0; i < chunk_count; i++) {
+				(this->*p_method)(i, nullptr);
+			}
+		}
+	}
+
+public:
+	void sort(T *p_array, uint32_t p_size, ThreadWorkPool *p_pool = nullptr) {
+		if (p_size < 2) {
+			return;
+		}
+
+		if (p_pool && (p_size < PARALLEL_THRESHOLD || p_pool->get_thread_count() < 2 || p_pool->is_working())) {
+			p_pool = nullptr;
+		}
+
+		array = p_array;
+		size = p_size;
+		chunk_size = p_pool ? uint32_t(CHUNK_SIZE) : p_size;
+		chunk_count = (size + chunk_size - 1) / chunk_size;
+
+		elements[0].resize(size);
+		elements[1].resize(size);
+		gather_counts.resize(chunk_count * DIGITS * BUCKETS);
+		chunk_offsets.resize(chunk_count * BUCKETS);
+
+		_run(p_pool, &RadixSort::_gather_chunk);
+
+		src = 0;
+		bool gathered_order = true;
+		for (digit = 0; digit < DIGITS; digit++) {
+			// Skip digits every key shares, they would not move anything.
+			uint32_t first_count = 0;
+			for (uint32_t c = 0; c < chunk_count; c++) {
+				first_count += gather_counts[(c * DIGITS + digit) * BUCKETS + _get_digit(elements[0][0], digit)];
+			}
+			if (first_count == size) {
+				continue;
+			}
+
+			if (gathered_order) {
+				// Nothing moved yet, reuse the counts from gathering.
+				for (uint32_t c = 0; c < chunk_count; c++) {
+					memcpy(&chunk_offsets[c * BUCKETS], &gather_counts[(c * DIGITS + digit) * BUCKETS], sizeof(uint32_t) * BUCKETS);
+				}
+			} else {
+				_run(p_pool, &RadixSort::_count_chunk);
+			}
+
+			// Each chunk writes its elements after the same bucket of the chunks before it, which keeps the sort stable.
+			uint32_t offset = 0;
+			for (uint32_t b = 0; b < BUCKETS; b++) {
+				for (uint32_t c = 0; c < chunk_count; c++) {
+					uint32_t count = chunk_offsets[c * BUCKETS + b];
+					chunk_offsets[c * BUCKETS + b] = offset;
+					offset += count;
+				}
+			}
+
+			_run(p_pool, &RadixSort::_scatter_chunk);
+			src ^= 1;
+			gathered_order = false;
+		}
+
+		const Element *s = elements[src].ptr();
+		for (uint32_t i = 0; i < size; i++) {
+			array[i] = s[i].value;
+		}
+		array = nullptr;
+	}
+};
+
+#endif // RADIX_SORT_H
@@ -80,6 +80,7 @@ public:
 	int sdfgi_get_pending_region_count(RID p_render_buffers) const override { return 0; }
 	AABB sdfgi_get_pending_region_bounds(RID p_render_buffers, int p_region) const override { return AABB(); }
 	uint32_t sdfgi_get_pending_region_cascade(RID p_render_buffers, int p_region) const override { return 0; }
+	void sdfgi_mark_static_dirty(RID p_render_buffers, const AABB &p_aabb) override {}
 
 	/* SKY API */
 
@@ -195,7 +196,7 @@ public:
 
 	TypedArray<Image> bake_render_uv2(RID p_base, const Vector<RID> &p_material_overrides, const Size2i &p_image_size) override { return TypedArray<Image>(); }
 
-	bool free(RID p_rid) override { return true; }
+	bool free(RID p_rid) override { return false; } // Owns nothing, let the scene free its instances.
 	void update() override {}
 	void sdfgi_set_debug_probe_select(const Vector3 &p_position, const Vector3 &p_dir) override {}
 
@@ -254,6 +255,7 @@ public:
 	void texture_set_detect_3d_callback(RID p_texture, RS::TextureDetectCallback p_callback, void *p_userdata) override {}
 	void texture_set_detect_normal_callback(RID p_texture, RS::TextureDetectCallback p_callback, void *p_userdata) override {}
 	void texture_set_detect_roughness_callback(RID p_texture, RS::TextureDetectRoughnessCallback p_callback, void *p_userdata) override {}
+	void texture_set_stream_callback(RID p_texture, const Size2i &p_full_size, RS::TextureStreamCallback p_callback, ObjectID p_owner) override {}
 
 	void texture_debug_usage(List<RS::TextureInfo> *r_info) override {}
 	void texture_set_force_redraw_if_visible(RID p_texture, bool p_enable) override {}
@@ -303,11 +305,30 @@ public:
 	void material_get_instance_shader_parameters(RID p_material, List<InstanceShaderParam> *r_parameters) override {}
 	void material_update_dependency(RID p_material, DependencyTracker *p_instance) override {}
 
-	/* MESH API */
+	void material_request_texture_stream_size(RID p_material, float p_pixel_size) override {}
 
-	RID mesh_allocate() override { return RID(); }
+	/* MESH API */
+	struct DummyMesh {
+		Vector<RS::SurfaceData> surfaces;
+		int blend_shape_count;
+		RS::BlendShapeMode blend_shape_mode;
+		Dependency dependency;
+	};
+	mutable RID_PtrOwner<DummyMesh> mesh_owner;
+
+	RID mesh_allocate() override {
+		DummyMesh *mesh = memnew(DummyMesh);
+		ERR_FAIL_COND_V(!mesh, RID());
+		mesh->blend_shape_count = 0;
+		mesh->blend_shape_mode = RS::BLEND_SHAPE_MODE_NORMALIZED;
+		return mesh_owner.make_rid(mesh);
+	}
 	void mesh_initialize(RID p_rid) override {}
-	void mesh_set_blend_shape_count(RID p_mesh, int p_blend_shape_count) override {}
+	void mesh_set_blend_shape_count(RID p_mesh, int p_blend_shape_count) override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND(!m);
+		m->blend_shape_count = p_blend_shape_count;
+	}
 	bool mesh_needs_instance(RID p_mesh, bool p_has_skeleton) override { return false; }
 	RID mesh_instance_create(RID p_base) override { return RID(); }
 	void mesh_instance_set_skeleton(RID p_mesh_instance, RID p_skeleton) override {}
@@ -317,53 +338,267 @@ public:
 	void reflection_probe_set_lod_threshold(RID p_probe, float p_ratio) override {}
 	float reflection_probe_get_lod_threshold(RID p_probe) const override { return 0.0; }
 
-	void mesh_add_surface(RID p_mesh, const RS::SurfaceData &p_surface) override {}
+	void mesh_add_surface(RID p_mesh, const RS::SurfaceData &p_surface) override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND(!m);
+		m->surfaces.push_back(p_surface);
+	}
 
-	int mesh_get_blend_shape_count(RID p_mesh) const override { return 0; }
+	int mesh_get_blend_shape_count(RID p_mesh) const override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND_V(!m, 0);
+		return m->blend_shape_count;
+	}
 
-	void mesh_set_blend_shape_mode(RID p_mesh, RS::BlendShapeMode p_mode) override {}
-	RS::BlendShapeMode mesh_get_blend_shape_mode(RID p_mesh) const override { return RS::BLEND_SHAPE_MODE_NORMALIZED; }
+	void mesh_set_blend_shape_mode(RID p_mesh, RS::BlendShapeMode p_mode) override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND(!m);
+		m->blend_shape_mode = p_mode;
+	}
+	RS::BlendShapeMode mesh_get_blend_shape_mode(RID p_mesh) const override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND_V(!m, RS::BLEND_SHAPE_MODE_NORMALIZED);
+		return m->blend_shape_mode;
+	}
 
 	void mesh_surface_update_region(RID p_mesh, int p_surface, int p_offset, const Vector<uint8_t> &p_data) override {}
 
 	void mesh_surface_set_material(RID p_mesh, int p_surface, RID p_material) override {}
 	RID mesh_surface_get_material(RID p_mesh, int p_surface) const override { return RID(); }
 
-	RS::SurfaceData mesh_get_surface(RID p_mesh, int p_surface) const override { return RS::SurfaceData(); }
-	int mesh_get_surface_count(RID p_mesh) const override { return 0; }
+	RS::SurfaceData mesh_get_surface(RID p_mesh, int p_surface) const override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND_V(!m, RS::SurfaceData());
+		ERR_FAIL_INDEX_V(p_surface, m->surfaces.size(), RS::SurfaceData());
+		return m->surfaces[p_surface];
+	}
+	int mesh_get_surface_count(RID p_mesh) const override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND_V(!m, 0);
+		return m->surfaces.size();
+	}
 
 	void mesh_set_custom_aabb(RID p_mesh, const AABB &p_aabb) override {}
 	AABB mesh_get_custom_aabb(RID p_mesh) const override { return AABB(); }
 
-	AABB mesh_get_aabb(RID p_mesh, RID p_skeleton = RID()) override { return AABB(); }
+	AABB mesh_get_aabb(RID p_mesh, RID p_skeleton = RID()) override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND_V(!m, AABB());
+		AABB aabb;
+		for (int i = 0; i < m->surfaces.size(); i++) {
+			if (i == 0) {
+				aabb = m->surfaces[i].aabb;
+			} else {
+				aabb.merge_with(m->surfaces[i].aabb);
+			}
+		}
+		return aabb;
+	}
 	void mesh_set_shadow_mesh(RID p_mesh, RID p_shadow_mesh) override {}
-	void mesh_clear(RID p_mesh) override {}
+	void mesh_clear(RID p_mesh) override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND(!m);
+		m->surfaces.clear();
+	}
 
 	/* MULTIMESH API */
+	struct DummyMultiMesh {
+		RID mesh;
+		int instances = 0;
+		RS::MultimeshTransformFormat xform_format = RS::MULTIMESH_TRANSFORM_3D;
+		uint32_t stride = 12;
+		int visible_instances = -1;
+		Vector<float> data;
+		AABB aabb;
+		bool dirty = false;
+		MultiMeshChunks chunks;
+		Dependency dependency;
+	};
+	mutable RID_PtrOwner<DummyMultiMesh> multimesh_owner;
 
-	RID multimesh_allocate() override { return RID(); }
+	// Updates the AABB and chunks the way a renderer does before drawing.
+	void _multimesh_update(DummyMultiMesh *p_multimesh) const {
+		if (!p_multimesh->dirty) {
+			return;
+		}
+		p_multimesh->dirty = false;
+
+		int instances = p_multimesh->visible_instances >= 0 ? p_multimesh->visible_instances : p_multimesh->instances;
+		bool has_mesh = mesh_owner.owns(p_multimesh->mesh);
+		AABB mesh_aabb = has_mesh ? const_cast<RasterizerStorageDummy *>(this)->mesh_get_aabb(p_multimesh->mesh) : AABB();
+		const float *data = p_multimesh->data.ptr();
+		p_multimesh->aabb = AABB();
+		for (int i = 0; i < instances && p_multimesh->xform_format == RS::MULTIMESH_TRANSFORM_3D; i++) {
+			AABB aabb = _multimesh_get_transform(p_multimesh, i).xform(mesh_aabb);
+			if (i == 0) {
+				p_multimesh->aabb = aabb;
+			} else {
+				p_multimesh->aabb.merge_with(aabb);
+			}
+		}
+
+		if (p_multimesh->chunks.size && p_multimesh->xform_format == RS::MULTIMESH_TRANSFORM_3D) {
+			p_multimesh->chunks.update(data, p_multimesh->stride, has_mesh ? instances : 0, p_multimesh->aabb, mesh_aabb);
+			p_multimesh->chunks.pack(data, p_multimesh->stride);
+		}
+	}
+	void _multimesh_changed(DummyMultiMesh *p_multimesh) {
+		p_multimesh->dirty = true;
+		p_multimesh->dependency.changed_notify(DEPENDENCY_CHANGED_AABB);
+	}
+	static Transform _multimesh_get_transform(const DummyMultiMesh *p_multimesh, int p_index) {
+		const float *d = p_multimesh->data.ptr() + p_index * p_multimesh->stride;
+		Transform t;
+		t.basis.elements[0] = Vector3(d[0], d[1], d[2]);
+		t.basis.elements[1] = Vector3(d[4], d[5], d[6]);
+		t.basis.elements[2] = Vector3(d[8], d[9], d[10]);
+		t.origin = Vector3(d[3], d[7], d[11]);
+		return t;
+	}
+
+	RID multimesh_allocate() override { return multimesh_owner.make_rid(memnew(DummyMultiMesh)); }
 	void multimesh_initialize(RID p_rid) override {}
-	void multimesh_allocate_data(RID p_multimesh, int p_instances, RS::MultimeshTransformFormat p_transform_format, bool p_use_colors = false, bool p_use_custom_data = false) override {}
-	int multimesh_get_instance_count(RID p_multimesh) const override { return 0; }
+	void multimesh_allocate_data(RID p_multimesh, int p_instances, RS::MultimeshTransformFormat p_transform_format, bool p_use_colors = false, bool p_use_custom_data = false) override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND(!multimesh);
+		multimesh->instances = p_instances;
+		multimesh->xform_format = p_transform_format;
+		multimesh->stride = (p_transform_format == RS::MULTIMESH_TRANSFORM_2D ? 8 : 12) + (p_use_colors ? 4 : 0) + (p_use_custom_data ? 4 : 0);
+		multimesh->visible_instances = MIN(multimesh->visible_instances, multimesh->instances);
+		multimesh->data.resize(p_instances * multimesh->stride);
+		multimesh->data.fill(0);
+		multimesh->chunks.clear();
+		_multimesh_changed(multimesh);
+		multimesh->dependency.changed_notify(DEPENDENCY_CHANGED_MULTIMESH);
+	}
+	int multimesh_get_instance_count(RID p_multimesh) const override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, 0);
+		return multimesh->instances;
+	}
 
-	void multimesh_set_mesh(RID p_multimesh, RID p_mesh) override {}
-	void multimesh_instance_set_transform(RID p_multimesh, int p_index, const Transform &p_transform) override {}
+	void multimesh_set_mesh(RID p_multimesh, RID p_mesh) override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND(!multimesh);
+		multimesh->mesh = p_mesh;
+		_multimesh_changed(multimesh);
+		multimesh->dependency.changed_notify(DEPENDENCY_CHANGED_MESH);
+	}
+	void multimesh_instance_set_transform(RID p_multimesh, int p_index, const Transform &p_transform) override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND(!multimesh);
+		ERR_FAIL_INDEX(p_index, multimesh->instances);
+		ERR_FAIL_COND(multimesh->xform_format != RS::MULTIMESH_TRANSFORM_3D);
+		float *d = multimesh->data.ptrw() + p_index * multimesh->stride;
+		for (int i = 0; i < 3; i++) {
+			d[i * 4 + 0] = p_transform.basis.elements[i][0];
+			d[i * 4 + 1] = p_transform.basis.elements[i][1];
+			d[i * 4 + 2] = p_transform.basis.elements[i][2];
+			d[i * 4 + 3] = p_transform.origin[i];
+		}
+		_multimesh_changed(multimesh);
+	}
 	void multimesh_instance_set_transform_2d(RID p_multimesh, int p_index, const Transform2D &p_transform) override {}
 	void multimesh_instance_set_color(RID p_multimesh, int p_index, const Color &p_color) override {}
 	void multimesh_instance_set_custom_data(RID p_multimesh, int p_index, const Color &p_color) override {}
 
-	RID multimesh_get_mesh(RID p_multimesh) const override { return RID(); }
-	AABB multimesh_get_aabb(RID p_multimesh) const override { return AABB(); }
+	RID multimesh_get_mesh(RID p_multimesh) const override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, RID());
+		return multimesh->mesh;
+	}
+	AABB multimesh_get_aabb(RID p_multimesh) const override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, AABB());
+		_multimesh_update(multimesh);
+		return multimesh->aabb;
+	}
 
-	Transform multimesh_instance_get_transform(RID p_multimesh, int p_index) const override { return Transform(); }
+	Transform multimesh_instance_get_transform(RID p_multimesh, int p_index) const override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, Transform());
+		ERR_FAIL_INDEX_V(p_index, multimesh->instances, Transform());
+		ERR_FAIL_COND_V(multimesh->xform_format != RS::MULTIMESH_TRANSFORM_3D, Transform());
+		return _multimesh_get_transform(multimesh, p_index);
+	}
 	Transform2D multimesh_instance_get_transform_2d(RID p_multimesh, int p_index) const override { return Transform2D(); }
 	Color multimesh_instance_get_color(RID p_multimesh, int p_index) const override { return Color(); }
 	Color multimesh_instance_get_custom_data(RID p_multimesh, int p_index) const override { return Color(); }
-	void multimesh_set_buffer(RID p_multimesh, const Vector<float> &p_buffer) override {}
-	Vector<float> multimesh_get_buffer(RID p_multimesh) const override { return Vector<float>(); }
+	void multimesh_set_buffer(RID p_multimesh, const Vector<float> &p_buffer) override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND(!multimesh);
+		ERR_FAIL_COND(p_buffer.size() != multimesh->instances * (int)multimesh->stride);
+		multimesh->data = p_buffer;
+		_multimesh_changed(multimesh);
+	}
+	Vector<float> multimesh_get_buffer(RID p_multimesh) const override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, Vector<float>());
+		return multimesh->data;
+	}
+
+	void multimesh_set_visible_instances(RID p_multimesh, int p_visible) override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND(!multimesh);
+		ERR_FAIL_COND(p_visible < -1 || p_visible > multimesh->instances);
+		multimesh->visible_instances = p_visible;
+		_multimesh_changed(multimesh);
+		multimesh->dependency.changed_notify(DEPENDENCY_CHANGED_MULTIMESH_VISIBLE_INSTANCES);
+	}
+	int multimesh_get_visible_instances(RID p_multimesh) const override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, 0);
+		return multimesh->visible_instances;
+	}
 
-	void multimesh_set_visible_instances(RID p_multimesh, int p_visible) override {}
-	int multimesh_get_visible_instances(RID p_multimesh) const override { return 0; }
+	void multimesh_set_chunk_size(RID p_multimesh, int p_size) override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND(!multimesh);
+		ERR_FAIL_COND(p_size < 0);
+		multimesh->chunks.size = p_size;
+		multimesh->chunks.clear();
+		_multimesh_changed(multimesh);
+	}
+	int multimesh_get_chunk_size(RID p_multimesh) const override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, 0);
+		return multimesh->chunks.size;
+	}
+
+	const AABB *multimesh_get_chunk_aabbs(RID p_multimesh, uint32_t &r_chunk_count) const override {
+		r_chunk_count = 0;
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, nullptr);
+		_multimesh_update(multimesh);
+		r_chunk_count = multimesh->chunks.aabbs.size();
+		return r_chunk_count ? multimesh->chunks.aabbs.ptr() : nullptr;
+	}
+	void multimesh_set_visible_chunks(RID p_multimesh, const uint8_t *p_visible) override {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND(!multimesh);
+		if (!multimesh->chunks.visible.is_empty() && multimesh->chunks.set_visible(p_visible)) {
+			multimesh->chunks.pack(multimesh->data.ptr(), multimesh->stride);
+		}
+	}
+
+	// The instance data a renderer would draw, only the visible chunks when chunked.
+	Vector<float> multimesh_get_draw_buffer(RID p_multimesh) const {
+		DummyMultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		ERR_FAIL_COND_V(!multimesh, Vector<float>());
+		_multimesh_update(multimesh);
+		const float *from = multimesh->data.ptr();
+		int instances = multimesh->visible_instances >= 0 ? multimesh->visible_instances : multimesh->instances;
+		if (multimesh->chunks.size && multimesh->xform_format == RS::MULTIMESH_TRANSFORM_3D) {
+			from = multimesh->chunks.data.ptr();
+			instances = multimesh->chunks.visible_instances;
+		}
+		Vector<float> data;
+		data.resize(instances * multimesh->stride);
+		if (instances) {
+			memcpy(data.ptrw(), from, data.size() * sizeof(float));
+		}
+		return data;
+	}
 
 	/* IMMEDIATE API */
 
@@ -391,6 +626,7 @@ public:
 	int skeleton_get_bone_count(RID p_skeleton) const override { return 0; }
 	void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform) override {}
 	Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const override { return Transform(); }
+	void skeleton_set_bone_transforms(RID p_skeleton, const PackedFloat32Array &p_transforms) override {}
 	void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform) override {}
 	Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const override { return Transform2D(); }
 
@@ -463,7 +699,18 @@ public:
 	float reflection_probe_get_origin_max_distance(RID p_probe) const override { return 0.0; }
 	bool reflection_probe_renders_shadows(RID p_probe) const override { return false; }
 
-	void base_update_dependency(RID p_base, DependencyTracker *p_instance) override {}
+	void base_update_dependency(RID p_base, DependencyTracker *p_instance) override {
+		if (mesh_owner.owns(p_base)) {
+			DummyMesh *mesh = mesh_owner.getornull(p_base);
+			p_instance->update_dependency(&mesh->dependency);
+		} else if (multimesh_owner.owns(p_base)) {
+			DummyMultiMesh *multimesh = multimesh_owner.getornull(p_base);
+			p_instance->update_dependency(&multimesh->dependency);
+			if (mesh_owner.owns(multimesh->mesh)) {
+				base_update_dependency(multimesh->mesh, p_instance);
+			}
+		}
+	}
 	void skeleton_update_dependency(RID p_base, DependencyTracker *p_instance) override {}
 
 	/* DECAL API */
@@ -554,6 +801,7 @@ public:
 
 	RID particles_allocate() override { return RID(); }
 	void particles_initialize(RID p_rid) override {}
+	void particles_set_mode(RID p_particles, RS::ParticlesMode p_mode) override {}
 	void particles_emit(RID p_particles, const Transform &p_transform, const Vector3 &p_velocity, const Color &p_color, const Color &p_custom, uint32_t p_emit_flags) override {}
 	void particles_set_emitting(RID p_particles, bool p_emitting) override {}
 	void particles_set_amount(RID p_particles, int p_amount) override {}
@@ -662,13 +910,34 @@ public:
 	void render_target_set_sdf_size_and_scale(RID p_render_target, RS::ViewportSDFOversize p_size, RS::ViewportSDFScale p_scale) override {}
 	Rect2i render_target_get_sdf_rect(RID p_render_target) const override { return Rect2i(); }
 
-	RS::InstanceType get_base_type(RID p_rid) const override { return RS::INSTANCE_NONE; }
+	RS::InstanceType get_base_type(RID p_rid) const override {
+		if (mesh_owner.owns(p_rid)) {
+			return RS::INSTANCE_MESH;
+		} else if (multimesh_owner.owns(p_rid)) {
+			return RS::INSTANCE_MULTIMESH;
+		}
+		return RS::INSTANCE_NONE;
+	}
 	bool free(RID p_rid) override {
 		if (texture_owner.owns(p_rid)) {
 			// delete the texture
 			DummyTexture *texture = texture_owner.getornull(p_rid);
 			texture_owner.free(p_rid);
 			memdelete(texture);
+		} else if (mesh_owner.owns(p_rid)) {
+			// delete the mesh
+			DummyMesh *mesh = mesh_owner.getornull(p_rid);
+			mesh->dependency.deleted_notify(p_rid);
+			mesh_owner.free(p_rid);
+			memdelete(mesh);
+		} else if (multimesh_owner.owns(p_rid)) {
+			// delete the multimesh
+			DummyMultiMesh *multimesh = multimesh_owner.getornull(p_rid);
+			multimesh->dependency.deleted_notify(p_rid);
+			multimesh_owner.free(p_rid);
+			memdelete(multimesh);
+		} else {
+			return false;
 		}
 		return true;
 	}
@@ -676,6 +945,7 @@ public:
 	bool has_os_feature(const String &p_feature) const override { return false; }
 
 	void update_dirty_resources() override {}
+	void update_texture_streaming() override {}
 
 	void set_debug_generate_wireframes(bool p_generate) override {}
 
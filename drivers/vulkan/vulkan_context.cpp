@@ -1911,6 +1911,10 @@ VkPhysicalDeviceLimits VulkanContext::get_device_limits() const {
 	return gpu_props.limits;
 }
 
+const VkPhysicalDeviceFeatures &VulkanContext::get_device_features() const {
+	return physical_device_features;
+}
+
 RID VulkanContext::local_device_create() {
 	LocalDevice ld;
 
@@ -256,6 +256,7 @@ public:
 
 	VkFormat get_screen_format() const;
 	VkPhysicalDeviceLimits get_device_limits() const;
+	const VkPhysicalDeviceFeatures &get_device_features() const;
 
 	void set_setup_buffer(const VkCommandBuffer &pCommandBuffer);
 	void append_command_buffer(const VkCommandBuffer &pCommandBuffer);
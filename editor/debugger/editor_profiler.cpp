@@ -363,6 +363,9 @@ void EditorProfiler::_update_frame() {
 			item->set_text(1, _get_time_as_text(m, time, it.calls));
 
 			item->set_text(2, itos(it.calls));
+			if (it.inline_cache_hits || it.inline_cache_misses) {
+				item->set_tooltip(2, vformat(TTR("Inline cache hits: %d\nInline cache misses: %d"), it.inline_cache_hits, it.inline_cache_misses));
+			}
 
 			if (plot_sigs.has(it.signature)) {
 				item->set_checked(0, true);
@@ -66,6 +66,8 @@ public:
 				float self = 0;
 				float total = 0;
 				int calls = 0;
+				int inline_cache_hits = 0;
+				int inline_cache_misses = 0;
 			};
 
 			Vector<Item> items;
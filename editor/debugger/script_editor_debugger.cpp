@@ -651,6 +651,8 @@ void ScriptEditorDebugger::_parse_message(const String &p_msg, const Array &p_da
 			int calls = frame.script_functions[i].call_count;
 			float total = frame.script_functions[i].total_time;
 			float self = frame.script_functions[i].self_time;
+			int inline_cache_hits = frame.script_functions[i].inline_cache_hits;
+			int inline_cache_misses = frame.script_functions[i].inline_cache_misses;
 
 			EditorProfiler::Metric::Category::Item item;
 			if (profiler_signature.has(signature)) {
@@ -675,6 +677,8 @@ void ScriptEditorDebugger::_parse_message(const String &p_msg, const Array &p_da
 			item.calls = calls;
 			item.self = self;
 			item.total = total;
+			item.inline_cache_hits = inline_cache_hits;
+			item.inline_cache_misses = inline_cache_misses;
 			funcs.items.write[i] = item;
 		}
 
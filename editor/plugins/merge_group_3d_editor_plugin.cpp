@@ -0,0 +1,98 @@
+/*************************************************************************/
+/*  merge_group_3d_editor_plugin.cpp                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "merge_group_3d_editor_plugin.h"
+
+void MergeGroup3DEditorPlugin::_merge() {
+	if (!merge_group) {
+		return;
+	}
+
+	LocalVector<MeshInstance3D *> merged;
+	LocalVector<MeshInstance3D *> sources;
+	merge_group->build_merged_meshes(merged, sources);
+	if (merged.is_empty()) {
+		EditorNode::get_singleton()->show_warning(TTR("Nothing to merge.\nAt least two visible static MeshInstance3D nodes are needed."));
+		return;
+	}
+
+	Node *owner = merge_group->get_owner() ? merge_group->get_owner() : merge_group;
+
+	UndoRedo *ur = EditorNode::get_singleton()->get_undo_redo();
+	ur->create_action(TTR("Merge Meshes"));
+	for (uint32_t i = 0; i < merged.size(); i++) {
+		ur->add_do_method(merge_group, "add_child", merged[i], true);
+		ur->add_do_method(merged[i], "set_owner", owner);
+		ur->add_do_reference(merged[i]);
+		ur->add_undo_method(merge_group, "remove_child", merged[i]);
+	}
+	// Keep the originals in the saved scene, so merging can be undone by deleting the merged meshes.
+	for (uint32_t i = 0; i < sources.size(); i++) {
+		ur->add_do_method(sources[i], "set_visible", false);
+		ur->add_undo_method(sources[i], "set_visible", true);
+	}
+	ur->commit_action();
+}
+
+void MergeGroup3DEditorPlugin::edit(Object *p_object) {
+	MergeGroup3D *s = Object::cast_to<MergeGroup3D>(p_object);
+	if (!s) {
+		return;
+	}
+
+	merge_group = s;
+}
+
+bool MergeGroup3DEditorPlugin::handles(Object *p_object) const {
+	return p_object->is_class("MergeGroup3D");
+}
+
+void MergeGroup3DEditorPlugin::make_visible(bool p_visible) {
+	if (p_visible) {
+		merge->show();
+	} else {
+		merge->hide();
+	}
+}
+
+MergeGroup3DEditorPlugin::MergeGroup3DEditorPlugin(EditorNode *p_node) {
+	editor = p_node;
+	merge = memnew(Button);
+	merge->set_flat(true);
+	merge->set_icon(editor->get_gui_base()->get_theme_icon("Bake", "EditorIcons"));
+	merge->set_text(TTR("Merge Meshes"));
+	merge->hide();
+	merge->connect("pressed", callable_mp(this, &MergeGroup3DEditorPlugin::_merge));
+	add_control_to_container(CONTAINER_SPATIAL_EDITOR_MENU, merge);
+	merge_group = nullptr;
+}
+
+MergeGroup3DEditorPlugin::~MergeGroup3DEditorPlugin() {
+}
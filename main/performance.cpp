@@ -77,6 +77,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(RENDER_COMMANDS_IN_FRAME);
+	BIND_ENUM_CONSTANT(RENDER_COALESCED_COMMANDS_IN_FRAME);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -120,6 +122,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/driver/output_latency",
+		"raster/commands_queued",
+		"raster/commands_coalesced",
 
 	};
 
@@ -182,6 +186,10 @@ float Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case RENDER_COMMANDS_IN_FRAME:
+			return RS::get_singleton()->get_render_info(RS::INFO_COMMANDS_IN_FRAME);
+		case RENDER_COALESCED_COMMANDS_IN_FRAME:
+			return RS::get_singleton()->get_render_info(RS::INFO_COALESCED_COMMANDS_IN_FRAME);
 
 		default: {
 		}
@@ -221,6 +229,8 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
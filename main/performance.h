@@ -91,6 +91,8 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		RENDER_COMMANDS_IN_FRAME,
+		RENDER_COALESCED_COMMANDS_IN_FRAME,
 		MONITOR_MAX
 	};
 
@@ -1420,6 +1420,8 @@ int NativeScriptLanguage::profiling_get_accumulated_data(ProfilingInfo *p_info_a
 		p_info_arr[current].self_time = d->get().self_time;
 		p_info_arr[current].total_time = d->get().total_time;
 		p_info_arr[current].signature = d->get().signature;
+		p_info_arr[current].inline_cache_hits = 0;
+		p_info_arr[current].inline_cache_misses = 0;
 		current++;
 	}
 
@@ -1445,6 +1447,8 @@ int NativeScriptLanguage::profiling_get_frame_data(ProfilingInfo *p_info_arr, in
 			p_info_arr[current].self_time = d->get().last_frame_self_time;
 			p_info_arr[current].total_time = d->get().last_frame_total_time;
 			p_info_arr[current].signature = d->get().signature;
+			p_info_arr[current].inline_cache_hits = 0;
+			p_info_arr[current].inline_cache_misses = 0;
 			current++;
 		}
 	}
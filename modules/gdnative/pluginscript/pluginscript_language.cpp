@@ -262,6 +262,8 @@ int PluginScriptLanguage::profiling_get_accumulated_data(ProfilingInfo *p_info_a
 			p_info_arr[i].call_count = info[i].call_count;
 			p_info_arr[i].total_time = info[i].total_time;
 			p_info_arr[i].self_time = info[i].self_time;
+			p_info_arr[i].inline_cache_hits = 0;
+			p_info_arr[i].inline_cache_misses = 0;
 			godot_string_name_destroy(&info[i].signature);
 		}
 	}
@@ -281,6 +283,8 @@ int PluginScriptLanguage::profiling_get_frame_data(ProfilingInfo *p_info_arr, in
 			p_info_arr[i].call_count = info[i].call_count;
 			p_info_arr[i].total_time = info[i].total_time;
 			p_info_arr[i].self_time = info[i].self_time;
+			p_info_arr[i].inline_cache_hits = 0;
+			p_info_arr[i].inline_cache_misses = 0;
 			godot_string_name_destroy(&info[i].signature);
 		}
 	}
@@ -40,10 +40,15 @@
 #include "core/os/file_access.h"
 #include "core/os/os.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_byte_code_cache.h"
+#include "gdscript_byte_codegen.h"
 #include "gdscript_cache.h"
 #include "gdscript_compiler.h"
+#include "gdscript_jit.h"
 #include "gdscript_parser.h"
+#include "gdscript_sampler.h"
 #include "gdscript_warning.h"
+#include "scene/main/scene_tree.h"
 
 #ifdef TESTS_ENABLED
 #include "tests/gdscript_test_runner.h"
@@ -809,8 +814,11 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 
 	valid = false;
-	GDScriptParser parser;
-	Error err = parser.parse(source, path, false);
+	// Scripts parsed ahead of time don't need to be parsed again, see GDScriptCache::preparse_scripts().
+	Ref<GDScriptParserRef> preparsed = GDScriptCache::take_preparsed_parser(path, source);
+	GDScriptParser source_parser;
+	GDScriptParser &parser = preparsed.is_valid() ? *preparsed->get_parser() : source_parser;
+	Error err = preparsed.is_valid() ? OK : parser.parse(source, path, false);
 	if (err) {
 		if (EngineDebugger::is_active()) {
 			GDScriptLanguage::get_singleton()->debug_break_parse(get_path(), parser.get_errors().front()->get().line, "Parser Error: " + parser.get_errors().front()->get().message);
@@ -1029,12 +1037,46 @@ void GDScript::_bind_methods() {
 }
 
 Vector<uint8_t> GDScript::get_as_byte_code() const {
-	return Vector<uint8_t>();
-};
+	Vector<uint8_t> byte_code;
+	if (GDScriptByteCodeCache::save(this, byte_code) != OK) {
+		return Vector<uint8_t>();
+	}
+	return byte_code;
+}
 
-// TODO: Fully remove this. There's not this kind of "bytecode" anymore.
 Error GDScript::load_byte_code(const String &p_path) {
-	return ERR_COMPILATION_FAILED;
+	Error err;
+	Vector<uint8_t> byte_code = FileAccess::get_file_as_array(p_path, &err);
+	ERR_FAIL_COND_V_MSG(err, err, "Cannot open file '" + p_path + "'.");
+
+	// If the source is still around, only trust byte code built from it.
+	if (!path.is_empty() && path != p_path && FileAccess::exists(path)) {
+		if (!GDScriptByteCodeCache::is_built_from(byte_code, GDScriptCache::get_source_code(path))) {
+			return ERR_FILE_UNRECOGNIZED;
+		}
+	}
+
+	return load_byte_code_from_buffer(byte_code);
+}
+
+Error GDScript::load_byte_code_from_buffer(const Vector<uint8_t> &p_buffer) {
+	{
+		MutexLock lock(GDScriptLanguage::singleton->lock);
+		ERR_FAIL_COND_V(instances.size(), ERR_ALREADY_IN_USE);
+	}
+
+	Error err = GDScriptByteCodeCache::load(this, p_buffer);
+	if (err) {
+		return err;
+	}
+
+	for (Map<StringName, Ref<GDScript>>::Element *E = subclasses.front(); E; E = E->next()) {
+		_set_subclass_path(E->get(), path);
+	}
+
+	_init_rpc_methods_properties();
+
+	return OK;
 }
 
 Error GDScript::load_source_code(const String &p_path) {
@@ -1273,6 +1315,7 @@ GDScript::~GDScript() {
 	for (Map<StringName, GDScriptFunction *>::Element *E = member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
+	GDScriptFunction::invalidate_direct_calls();
 
 	if (GDScriptCache::singleton) { // Cache may have been already destroyed at engine shutdown.
 		GDScriptCache::remove_script(get_path());
@@ -1771,6 +1814,17 @@ void GDScriptLanguage::init() {
 		_add_global(E->get().name, E->get().ptr);
 	}
 
+	// The parser fills these tables on first use, do it now since scripts can be parsed on several threads at once.
+	GDScriptParser::get_builtin_type(StringName());
+	GDScriptParser::get_real_class_name(StringName());
+
+	if (GLOBAL_GET("debug/gdscript/sampling_profiler/enabled") && !Engine::get_singleton()->is_editor_hint()) {
+		GDScriptSampler::start(MAX(1, int(GLOBAL_GET("debug/gdscript/sampling_profiler/interval_usec"))));
+	}
+
+	// Done when the first script is loaded, see preparse_startup_scripts().
+	startup_scripts_preparse_pending = preparse_scripts && !Engine::get_singleton()->is_editor_hint();
+
 #ifdef TESTS_ENABLED
 	GDScriptTests::GDScriptTestRunner::handle_cmdline();
 #endif
@@ -1790,6 +1844,15 @@ Error GDScriptLanguage::execute_file(const String &p_path) {
 }
 
 void GDScriptLanguage::finish() {
+	GDScriptFunctionState::clear_frame_pool();
+
+	if (GDScriptSampler::is_active()) {
+		GDScriptSampler::stop();
+		String path = GLOBAL_GET("debug/gdscript/sampling_profiler/output_path");
+		if (GDScriptSampler::save_folded_stacks(path) == OK) {
+			print_line(vformat("GDScript: Saved %d samples to \"%s\".", GDScriptSampler::get_sample_count(), path));
+		}
+	}
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -1807,6 +1870,12 @@ void GDScriptLanguage::profiling_start() {
 		elem->self()->profile.last_frame_call_count = 0;
 		elem->self()->profile.last_frame_self_time = 0;
 		elem->self()->profile.last_frame_total_time = 0;
+		elem->self()->profile.inline_cache_hits = 0;
+		elem->self()->profile.inline_cache_misses = 0;
+		elem->self()->profile.frame_inline_cache_hits = 0;
+		elem->self()->profile.frame_inline_cache_misses = 0;
+		elem->self()->profile.last_frame_inline_cache_hits = 0;
+		elem->self()->profile.last_frame_inline_cache_misses = 0;
 		elem = elem->next();
 	}
 
@@ -1836,6 +1905,8 @@ int GDScriptLanguage::profiling_get_accumulated_data(ProfilingInfo *p_info_arr,
 		p_info_arr[current].call_count = elem->self()->profile.call_count;
 		p_info_arr[current].self_time = elem->self()->profile.self_time;
 		p_info_arr[current].total_time = elem->self()->profile.total_time;
+		p_info_arr[current].inline_cache_hits = elem->self()->profile.inline_cache_hits;
+		p_info_arr[current].inline_cache_misses = elem->self()->profile.inline_cache_misses;
 		p_info_arr[current].signature = elem->self()->profile.signature;
 		elem = elem->next();
 		current++;
@@ -1860,6 +1931,8 @@ int GDScriptLanguage::profiling_get_frame_data(ProfilingInfo *p_info_arr, int p_
 			p_info_arr[current].call_count = elem->self()->profile.last_frame_call_count;
 			p_info_arr[current].self_time = elem->self()->profile.last_frame_self_time;
 			p_info_arr[current].total_time = elem->self()->profile.last_frame_total_time;
+			p_info_arr[current].inline_cache_hits = elem->self()->profile.last_frame_inline_cache_hits;
+			p_info_arr[current].inline_cache_misses = elem->self()->profile.last_frame_inline_cache_misses;
 			p_info_arr[current].signature = elem->self()->profile.signature;
 			current++;
 		}
@@ -2042,9 +2115,39 @@ void GDScriptLanguage::reload_tool_script(const Ref<Script> &p_script, bool p_so
 #endif
 }
 
+// Parses the scripts used by the autoloads and the main scene on all cores, before they get loaded one by one.
+void GDScriptLanguage::preparse_startup_scripts() {
+	// The work runs on the thread work pool of the scene tree, which only exists once the project starts.
+	if (likely(!startup_scripts_preparse_pending) || !SceneTree::get_singleton() || Thread::get_caller_id() != Thread::get_main_id()) {
+		return;
+	}
+	startup_scripts_preparse_pending = false;
+
+	Vector<String> paths;
+	Map<StringName, ProjectSettings::AutoloadInfo> autoloads = ProjectSettings::get_singleton()->get_autoload_list();
+	for (Map<StringName, ProjectSettings::AutoloadInfo>::Element *E = autoloads.front(); E; E = E->next()) {
+		paths.push_back(E->get().path);
+	}
+	String main_scene = GLOBAL_GET("application/run/main_scene");
+	if (!main_scene.is_empty()) {
+		paths.push_back(main_scene);
+	}
+
+	if (!paths.is_empty()) {
+		GDScriptCache::preparse_scripts(paths, *SceneTree::get_singleton()->get_thread_work_pool());
+		preparsed_scripts_pending = true;
+	}
+}
+
 void GDScriptLanguage::frame() {
 	calls = 0;
 
+	if (unlikely(preparsed_scripts_pending)) {
+		// Whatever the main scene and autoloads needed is loaded by now.
+		GDScriptCache::clear_preparsed_scripts();
+		preparsed_scripts_pending = false;
+	}
+
 #ifdef DEBUG_ENABLED
 	if (profiling) {
 		MutexLock lock(this->lock);
@@ -2054,9 +2157,13 @@ void GDScriptLanguage::frame() {
 			elem->self()->profile.last_frame_call_count = elem->self()->profile.frame_call_count;
 			elem->self()->profile.last_frame_self_time = elem->self()->profile.frame_self_time;
 			elem->self()->profile.last_frame_total_time = elem->self()->profile.frame_total_time;
+			elem->self()->profile.last_frame_inline_cache_hits = elem->self()->profile.frame_inline_cache_hits;
+			elem->self()->profile.last_frame_inline_cache_misses = elem->self()->profile.frame_inline_cache_misses;
 			elem->self()->profile.frame_call_count = 0;
 			elem->self()->profile.frame_self_time = 0;
 			elem->self()->profile.frame_total_time = 0;
+			elem->self()->profile.frame_inline_cache_hits = 0;
+			elem->self()->profile.frame_inline_cache_misses = 0;
 			elem = elem->next();
 		}
 	}
@@ -2279,6 +2386,36 @@ GDScriptLanguage::GDScriptLanguage() {
 		_call_stack = nullptr;
 	}
 
+	uint32_t optimizations = 0;
+	if (GLOBAL_DEF("debug/gdscript/optimizer/constant_folding", true)) {
+		optimizations |= GDScriptByteCodeGenerator::OPTIMIZE_CONSTANT_FOLDING;
+	}
+	if (GLOBAL_DEF("debug/gdscript/optimizer/copy_propagation", true)) {
+		optimizations |= GDScriptByteCodeGenerator::OPTIMIZE_COPY_PROPAGATION;
+	}
+	if (GLOBAL_DEF("debug/gdscript/optimizer/dead_store_elimination", true)) {
+		optimizations |= GDScriptByteCodeGenerator::OPTIMIZE_DEAD_STORE_ELIMINATION;
+	}
+	if (GLOBAL_DEF("debug/gdscript/optimizer/jump_threading", true)) {
+		optimizations |= GDScriptByteCodeGenerator::OPTIMIZE_JUMP_THREADING;
+	}
+	if (GLOBAL_DEF("debug/gdscript/optimizer/superinstructions", true)) {
+		optimizations |= GDScriptByteCodeGenerator::OPTIMIZE_SUPERINSTRUCTIONS;
+	}
+	GDScriptByteCodeGenerator::set_optimizations(optimizations);
+
+	GDScriptJIT::set_enabled(GLOBAL_DEF("debug/gdscript/jit/enabled", false));
+	GDScriptJIT::set_hot_threshold(GLOBAL_DEF("debug/gdscript/jit/hot_threshold", 1000));
+	ProjectSettings::get_singleton()->set_custom_property_info("debug/gdscript/jit/hot_threshold", PropertyInfo(Variant::INT, "debug/gdscript/jit/hot_threshold", PROPERTY_HINT_RANGE, "1,100000,1,or_greater"));
+	GDScriptJIT::set_verify(GLOBAL_DEF("debug/gdscript/jit/verify", false));
+
+	preparse_scripts = GLOBAL_DEF("debug/gdscript/startup/preparse_scripts", true);
+
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/enabled", false);
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/interval_usec", 1000);
+	ProjectSettings::get_singleton()->set_custom_property_info("debug/gdscript/sampling_profiler/interval_usec", PropertyInfo(Variant::INT, "debug/gdscript/sampling_profiler/interval_usec", PROPERTY_HINT_RANGE, "100,100000,1,or_greater"));
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/output_path", "user://gdscript_samples.folded");
+
 #ifdef DEBUG_ENABLED
 	GLOBAL_DEF("debug/gdscript/warnings/enable", true);
 	GLOBAL_DEF("debug/gdscript/warnings/treat_warnings_as_errors", false);
@@ -2350,10 +2487,11 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 		*r_error = ERR_FILE_CANT_OPEN;
 	}
 
-	Error err;
-	Ref<GDScript> script = GDScriptCache::get_full_script(p_path, err);
+	GDScriptLanguage::get_singleton()->preparse_startup_scripts();
 
-	// TODO: Reintroduce binary and encrypted scripts.
+	// Byte code is remapped from the script path, which is also what other scripts refer to it by.
+	Error err;
+	Ref<GDScript> script = GDScriptCache::get_full_script(p_original_path.is_empty() ? p_path : p_original_path, err);
 
 	if (script.is_null()) {
 		// Don't fail loading because of parsing error.
@@ -2369,8 +2507,8 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 
 void ResourceFormatLoaderGDScript::get_recognized_extensions(List<String> *p_extensions) const {
 	p_extensions->push_back("gd");
-	// TODO: Reintroduce binary and encrypted scripts.
-	// p_extensions->push_back("gdc");
+	p_extensions->push_back("gdc");
+	// TODO: Reintroduce encrypted scripts.
 	// p_extensions->push_back("gde");
 }
 
@@ -2380,14 +2518,18 @@ bool ResourceFormatLoaderGDScript::handles_type(const String &p_type) const {
 
 String ResourceFormatLoaderGDScript::get_resource_type(const String &p_path) const {
 	String el = p_path.get_extension().to_lower();
-	// TODO: Reintroduce binary and encrypted scripts.
-	if (el == "gd" /*|| el == "gdc" || el == "gde"*/) {
+	// TODO: Reintroduce encrypted scripts.
+	if (el == "gd" || el == "gdc" /*|| el == "gde"*/) {
 		return "GDScript";
 	}
 	return "";
 }
 
 void ResourceFormatLoaderGDScript::get_dependencies(const String &p_path, List<String> *p_dependencies, bool p_add_types) {
+	if (p_path.get_extension().to_lower() == "gdc") {
+		return; // Byte code loads what it depends on by itself.
+	}
+
 	FileAccessRef file = FileAccess::open(p_path, FileAccess::READ);
 	ERR_FAIL_COND_MSG(!file, "Cannot open file '" + p_path + "'.");
 
@@ -2401,7 +2543,8 @@ void ResourceFormatLoaderGDScript::get_dependencies(const String &p_path, List<S
 		return;
 	}
 
-	for (const List<String>::Element *E = parser.get_dependencies().front(); E; E = E->next()) {
+	List<String> deps = parser.get_dependencies();
+	for (const List<String>::Element *E = deps.front(); E; E = E->next()) {
 		p_dependencies->push_back(E->get());
 	}
 }
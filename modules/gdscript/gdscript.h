@@ -72,6 +72,7 @@ class GDScript : public Script {
 	friend class GDScriptFunction;
 	friend class GDScriptAnalyzer;
 	friend class GDScriptCompiler;
+	friend class GDScriptByteCodeCache;
 	friend class GDScriptLanguage;
 	friend struct GDScriptUtilityFunctionsDefinitions;
 
@@ -222,6 +223,7 @@ public:
 	void set_script_path(const String &p_path) { path = p_path; } //because subclasses need a path too...
 	Error load_source_code(const String &p_path);
 	Error load_byte_code(const String &p_path);
+	Error load_byte_code_from_buffer(const Vector<uint8_t> &p_buffer);
 
 	Vector<uint8_t> get_as_byte_code() const;
 
@@ -366,6 +368,11 @@ class GDScriptLanguage : public ScriptLanguage {
 	bool profiling;
 	uint64_t script_frame_time;
 
+	// See GDScriptCache::preparse_scripts().
+	bool preparse_scripts = true;
+	bool startup_scripts_preparse_pending = false;
+	bool preparsed_scripts_pending = false;
+
 	Map<String, ObjectID> orphan_subclasses;
 
 public:
@@ -504,6 +511,8 @@ public:
 
 	virtual void frame();
 
+	void preparse_startup_scripts();
+
 	virtual void get_public_functions(List<MethodInfo> *p_functions) const;
 	virtual void get_public_constants(List<Pair<String, Variant>> *p_constants) const;
 
@@ -0,0 +1,1339 @@
+/*************************************************************************/
+/*  gdscript_byte_code_cache.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_byte_code_cache.h"
+
+#include "core/config/engine.h"
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/templates/local_vector.h"
+#include "core/version.h"
+#include "gdscript.h"
+#include "gdscript_cache.h"
+
+// Bump whenever the layout below changes. Changes to the opcodes or the VM are
+// caught by the engine version stored in the header.
+#define BYTE_CODE_FORMAT_VERSION 3
+
+static const uint8_t byte_code_magic[4] = { 'G', 'D', 'S', 'C' };
+
+enum {
+	VARIANT_VALUE,
+	VARIANT_ARRAY,
+	VARIANT_DICTIONARY,
+	VARIANT_OBJECT_NULL,
+	VARIANT_OBJECT_GLOBAL,
+	VARIANT_OBJECT_SCRIPT,
+	VARIANT_OBJECT_RESOURCE,
+};
+
+enum {
+	SCRIPT_NONE,
+	SCRIPT_GDSCRIPT,
+	SCRIPT_RESOURCE,
+};
+
+static String _get_engine_version() {
+	return String(VERSION_FULL_BUILD) + "." + String(Engine::get_singleton()->get_version_info()["hash"]);
+}
+
+static uint64_t _get_source_hash(const String &p_source) {
+	// Never zero, so a zero hash can mean the source was not available.
+	return p_source.hash64() | 1;
+}
+
+/* WRITER */
+
+class GDScriptByteCodeCache::Writer {
+	struct OperatorSignature {
+		Variant::Operator op = Variant::OP_EQUAL;
+		Variant::Type left = Variant::NIL;
+		Variant::Type right = Variant::NIL;
+	};
+
+	struct MemberSignature {
+		Variant::Type type = Variant::NIL;
+		StringName name;
+	};
+
+	struct ConstructorSignature {
+		Variant::Type type = Variant::NIL;
+		int index = 0;
+	};
+
+	LocalVector<uint8_t> data;
+	Map<StringName, uint32_t> string_map;
+	Vector<StringName> strings;
+
+	bool lookups_built = false;
+	Map<Variant::ValidatedOperatorEvaluator, OperatorSignature> operator_lookup;
+	Map<Variant::ValidatedSetter, MemberSignature> setter_lookup;
+	Map<Variant::ValidatedGetter, MemberSignature> getter_lookup;
+	Map<Variant::ValidatedKeyedSetter, Variant::Type> keyed_setter_lookup;
+	Map<Variant::ValidatedKeyedGetter, Variant::Type> keyed_getter_lookup;
+	Map<Variant::ValidatedIndexedSetter, Variant::Type> indexed_setter_lookup;
+	Map<Variant::ValidatedIndexedGetter, Variant::Type> indexed_getter_lookup;
+	Map<Variant::ValidatedBuiltInMethod, MemberSignature> builtin_method_lookup;
+	Map<Variant::ValidatedConstructor, ConstructorSignature> constructor_lookup;
+	Map<Variant::ValidatedUtilityFunction, StringName> utility_lookup;
+	Map<GDScriptUtilityFunctions::FunctionPtr, StringName> gds_utility_lookup;
+	Map<const Object *, StringName> global_lookup;
+
+	void _build_lookups();
+
+	static String _get_script_fqn(const GDScript *p_script) {
+		return p_script->fully_qualified_name.is_empty() ? p_script->get_path() : p_script->fully_qualified_name;
+	}
+
+	void put_u32(uint32_t p_value) {
+		uint32_t pos = data.size();
+		data.resize(pos + 4);
+		encode_uint32(p_value, &data[pos]);
+	}
+
+	void put_u64(uint64_t p_value) {
+		uint32_t pos = data.size();
+		data.resize(pos + 8);
+		encode_uint64(p_value, &data[pos]);
+	}
+
+	void put_name(const StringName &p_name) {
+		const Map<StringName, uint32_t>::Element *E = string_map.find(p_name);
+		if (E) {
+			put_u32(E->get());
+			return;
+		}
+		uint32_t idx = strings.size();
+		string_map[p_name] = idx;
+		strings.push_back(p_name);
+		put_u32(idx);
+	}
+
+	Error put_variant(const Variant &p_value);
+	void put_optional_variant(const Variant &p_value);
+	void put_script(const Script *p_script);
+	void put_data_type(const GDScriptDataType &p_type);
+	void put_property_info(const PropertyInfo &p_info);
+	Error put_function(const GDScriptFunction *p_function);
+	void put_class_tree(const GDScript *p_script);
+	Error put_class(const GDScript *p_script);
+
+public:
+	Error write(const GDScript *p_script, Vector<uint8_t> &r_buffer);
+};
+
+void GDScriptByteCodeCache::Writer::_build_lookups() {
+	// Several signatures may share a function, any of them resolves to the same code on load.
+	for (int i = 0; i < Variant::VARIANT_MAX; i++) {
+		Variant::Type type = Variant::Type(i);
+
+		for (int op = 0; op < Variant::OP_MAX; op++) {
+			for (int j = 0; j < Variant::VARIANT_MAX; j++) {
+				Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator(Variant::Operator(op), type, Variant::Type(j));
+				if (evaluator && !operator_lookup.has(evaluator)) {
+					OperatorSignature signature;
+					signature.op = Variant::Operator(op);
+					signature.left = type;
+					signature.right = Variant::Type(j);
+					operator_lookup[evaluator] = signature;
+				}
+			}
+		}
+
+		List<StringName> members;
+		Variant::get_member_list(type, &members);
+		for (const List<StringName>::Element *E = members.front(); E; E = E->next()) {
+			MemberSignature signature;
+			signature.type = type;
+			signature.name = E->get();
+			setter_lookup[Variant::get_member_validated_setter(type, E->get())] = signature;
+			getter_lookup[Variant::get_member_validated_getter(type, E->get())] = signature;
+		}
+
+		keyed_setter_lookup[Variant::get_member_validated_keyed_setter(type)] = type;
+		keyed_getter_lookup[Variant::get_member_validated_keyed_getter(type)] = type;
+		indexed_setter_lookup[Variant::get_member_validated_indexed_setter(type)] = type;
+		indexed_getter_lookup[Variant::get_member_validated_indexed_getter(type)] = type;
+
+		List<StringName> methods;
+		Variant::get_builtin_method_list(type, &methods);
+		for (const List<StringName>::Element *E = methods.front(); E; E = E->next()) {
+			MemberSignature signature;
+			signature.type = type;
+			signature.name = E->get();
+			builtin_method_lookup[Variant::get_validated_builtin_method(type, E->get())] = signature;
+		}
+
+		for (int j = 0; j < Variant::get_constructor_count(type); j++) {
+			ConstructorSignature signature;
+			signature.type = type;
+			signature.index = j;
+			constructor_lookup[Variant::get_validated_constructor(type, j)] = signature;
+		}
+	}
+
+	List<StringName> utilities;
+	Variant::get_utility_function_list(&utilities);
+	for (const List<StringName>::Element *E = utilities.front(); E; E = E->next()) {
+		utility_lookup[Variant::get_validated_utility_function(E->get())] = E->get();
+	}
+
+	List<StringName> gds_utilities;
+	GDScriptUtilityFunctions::get_function_list(&gds_utilities);
+	for (const List<StringName>::Element *E = gds_utilities.front(); E; E = E->next()) {
+		gds_utility_lookup[GDScriptUtilityFunctions::get_function(E->get())] = E->get();
+	}
+
+	const Map<StringName, int> &globals = GDScriptLanguage::get_singleton()->get_global_map();
+	const Variant *global_array = GDScriptLanguage::get_singleton()->get_global_array();
+	for (const Map<StringName, int>::Element *E = globals.front(); E; E = E->next()) {
+		const Variant &global = global_array[E->get()];
+		if (global.get_type() == Variant::OBJECT && global.get_validated_object()) {
+			global_lookup[global.get_validated_object()] = E->key();
+		}
+	}
+
+	lookups_built = true;
+}
+
+Error GDScriptByteCodeCache::Writer::put_variant(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::ARRAY: {
+			Array array = p_value;
+			ERR_FAIL_COND_V_MSG(array.is_typed(), ERR_UNAVAILABLE, "Typed array constants can't be stored as byte code.");
+			put_u32(VARIANT_ARRAY);
+			put_u32(array.size());
+			for (int i = 0; i < array.size(); i++) {
+				Error err = put_variant(array[i]);
+				if (err) {
+					return err;
+				}
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary dictionary = p_value;
+			List<Variant> keys;
+			dictionary.get_key_list(&keys);
+			put_u32(VARIANT_DICTIONARY);
+			put_u32(keys.size());
+			for (const List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+				Error err = put_variant(E->get());
+				if (!err) {
+					err = put_variant(dictionary[E->get()]);
+				}
+				if (err) {
+					return err;
+				}
+			}
+		} break;
+		case Variant::OBJECT: {
+			Object *object = p_value.get_validated_object();
+			if (!object) {
+				put_u32(VARIANT_OBJECT_NULL);
+				break;
+			}
+
+			const GDScript *script = Object::cast_to<GDScript>(object);
+			if (script) {
+				put_u32(VARIANT_OBJECT_SCRIPT);
+				put_script(script);
+				break;
+			}
+
+			if (!lookups_built) {
+				_build_lookups();
+			}
+			const Map<const Object *, StringName>::Element *E = global_lookup.find(object);
+			if (E) {
+				put_u32(VARIANT_OBJECT_GLOBAL);
+				put_name(E->get());
+				break;
+			}
+
+			const Resource *resource = Object::cast_to<Resource>(object);
+			ERR_FAIL_COND_V_MSG(!resource || !resource->get_path().is_resource_file(), ERR_UNAVAILABLE, "Object constants that aren't globals or saved resources can't be stored as byte code.");
+			put_u32(VARIANT_OBJECT_RESOURCE);
+			put_name(resource->get_path());
+		} break;
+		case Variant::RID:
+		case Variant::CALLABLE:
+		case Variant::SIGNAL: {
+			ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "Constants of type '" + Variant::get_type_name(p_value.get_type()) + "' can't be stored as byte code.");
+		} break;
+		default: {
+			int len = 0;
+			Error err = encode_variant(p_value, nullptr, len);
+			ERR_FAIL_COND_V(err, err);
+
+			put_u32(VARIANT_VALUE);
+			put_u32(len);
+			uint32_t pos = data.size();
+			data.resize(pos + len);
+			encode_variant(p_value, &data[pos], len);
+		} break;
+	}
+	return OK;
+}
+
+// For editor-only data, which shouldn't prevent storing the whole script.
+void GDScriptByteCodeCache::Writer::put_optional_variant(const Variant &p_value) {
+	uint32_t mark = data.size();
+	if (put_variant(p_value) != OK) {
+		data.resize(mark);
+		put_variant(Variant());
+	}
+}
+
+void GDScriptByteCodeCache::Writer::put_script(const Script *p_script) {
+	if (!p_script) {
+		put_u32(SCRIPT_NONE);
+		return;
+	}
+
+	const GDScript *script = Object::cast_to<GDScript>(p_script);
+	if (script) {
+		put_u32(SCRIPT_GDSCRIPT);
+		put_name(_get_script_fqn(script));
+	} else {
+		put_u32(SCRIPT_RESOURCE);
+		put_name(p_script->get_path());
+	}
+}
+
+void GDScriptByteCodeCache::Writer::put_data_type(const GDScriptDataType &p_type) {
+	put_u32(p_type.kind);
+	put_u32(p_type.has_type);
+	put_u32(p_type.builtin_type);
+	put_name(p_type.native_type);
+	put_script(p_type.script_type);
+	// Types referring to their own script don't hold a reference to it, see GDScriptCompiler::_gdtype_from_datatype().
+	put_u32(p_type.script_type && p_type.script_type_ref.is_null());
+	put_u32(p_type.has_container_element_type());
+	if (p_type.has_container_element_type()) {
+		put_data_type(p_type.get_container_element_type());
+	}
+}
+
+void GDScriptByteCodeCache::Writer::put_property_info(const PropertyInfo &p_info) {
+	put_u32(p_info.type);
+	put_name(p_info.name);
+	put_name(p_info.class_name);
+	put_u32(p_info.hint);
+	put_name(p_info.hint_string);
+	put_u32(p_info.usage);
+}
+
+Error GDScriptByteCodeCache::Writer::put_function(const GDScriptFunction *p_function) {
+	if (!lookups_built) {
+		_build_lookups();
+	}
+
+	put_name(p_function->name);
+	put_u32(p_function->_static);
+	put_u32(p_function->rpc_mode);
+	put_u32(p_function->_initial_line);
+	put_data_type(p_function->return_type);
+
+	put_u32(p_function->_argument_count);
+	put_u32(p_function->argument_types.size());
+	for (int i = 0; i < p_function->argument_types.size(); i++) {
+		put_data_type(p_function->argument_types[i]);
+	}
+	put_u32(p_function->default_arguments.size());
+	for (int i = 0; i < p_function->default_arguments.size(); i++) {
+		put_u32(p_function->default_arguments[i]);
+	}
+
+#ifdef TOOLS_ENABLED
+	put_u32(p_function->arg_names.size());
+	for (int i = 0; i < p_function->arg_names.size(); i++) {
+		put_name(p_function->arg_names[i]);
+	}
+	put_u32(p_function->default_arg_values.size());
+	for (int i = 0; i < p_function->default_arg_values.size(); i++) {
+		put_optional_variant(p_function->default_arg_values[i]);
+	}
+#else
+	put_u32(0);
+	put_u32(0);
+#endif
+
+	put_u32(p_function->constants.size());
+	for (int i = 0; i < p_function->constants.size(); i++) {
+		Error err = put_variant(p_function->constants[i]);
+		if (err) {
+			return err;
+		}
+	}
+	put_u32(p_function->global_names.size());
+	for (int i = 0; i < p_function->global_names.size(); i++) {
+		put_name(p_function->global_names[i]);
+	}
+	put_u32(p_function->code.size());
+	for (int i = 0; i < p_function->code.size(); i++) {
+		put_u32(p_function->code[i]);
+	}
+
+	put_u32(p_function->operator_funcs.size());
+	for (int i = 0; i < p_function->operator_funcs.size(); i++) {
+		const Map<Variant::ValidatedOperatorEvaluator, OperatorSignature>::Element *E = operator_lookup.find(p_function->operator_funcs[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_u32(E->get().op);
+		put_u32(E->get().left);
+		put_u32(E->get().right);
+	}
+
+	put_u32(p_function->setters.size());
+	for (int i = 0; i < p_function->setters.size(); i++) {
+		const Map<Variant::ValidatedSetter, MemberSignature>::Element *E = setter_lookup.find(p_function->setters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_u32(E->get().type);
+		put_name(E->get().name);
+	}
+
+	put_u32(p_function->getters.size());
+	for (int i = 0; i < p_function->getters.size(); i++) {
+		const Map<Variant::ValidatedGetter, MemberSignature>::Element *E = getter_lookup.find(p_function->getters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_u32(E->get().type);
+		put_name(E->get().name);
+	}
+
+	put_u32(p_function->keyed_setters.size());
+	for (int i = 0; i < p_function->keyed_setters.size(); i++) {
+		const Map<Variant::ValidatedKeyedSetter, Variant::Type>::Element *E = keyed_setter_lookup.find(p_function->keyed_setters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_u32(E->get());
+	}
+
+	put_u32(p_function->keyed_getters.size());
+	for (int i = 0; i < p_function->keyed_getters.size(); i++) {
+		const Map<Variant::ValidatedKeyedGetter, Variant::Type>::Element *E = keyed_getter_lookup.find(p_function->keyed_getters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_u32(E->get());
+	}
+
+	put_u32(p_function->indexed_setters.size());
+	for (int i = 0; i < p_function->indexed_setters.size(); i++) {
+		const Map<Variant::ValidatedIndexedSetter, Variant::Type>::Element *E = indexed_setter_lookup.find(p_function->indexed_setters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_u32(E->get());
+	}
+
+	put_u32(p_function->indexed_getters.size());
+	for (int i = 0; i < p_function->indexed_getters.size(); i++) {
+		const Map<Variant::ValidatedIndexedGetter, Variant::Type>::Element *E = indexed_getter_lookup.find(p_function->indexed_getters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_u32(E->get());
+	}
+
+	put_u32(p_function->builtin_methods.size());
+	for (int i = 0; i < p_function->builtin_methods.size(); i++) {
+		const Map<Variant::ValidatedBuiltInMethod, MemberSignature>::Element *E = builtin_method_lookup.find(p_function->builtin_methods[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_u32(E->get().type);
+		put_name(E->get().name);
+	}
+
+	put_u32(p_function->constructors.size());
+	for (int i = 0; i < p_function->constructors.size(); i++) {
+		const Map<Variant::ValidatedConstructor, ConstructorSignature>::Element *E = constructor_lookup.find(p_function->constructors[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_u32(E->get().type);
+		put_u32(E->get().index);
+	}
+
+	put_u32(p_function->utilities.size());
+	for (int i = 0; i < p_function->utilities.size(); i++) {
+		const Map<Variant::ValidatedUtilityFunction, StringName>::Element *E = utility_lookup.find(p_function->utilities[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_name(E->get());
+	}
+
+	put_u32(p_function->gds_utilities.size());
+	for (int i = 0; i < p_function->gds_utilities.size(); i++) {
+		const Map<GDScriptUtilityFunctions::FunctionPtr, StringName>::Element *E = gds_utility_lookup.find(p_function->gds_utilities[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		put_name(E->get());
+	}
+
+	put_u32(p_function->methods.size());
+	for (int i = 0; i < p_function->methods.size(); i++) {
+		put_name(p_function->methods[i]->get_instance_class());
+		put_name(p_function->methods[i]->get_name());
+	}
+
+	put_u32(p_function->direct_calls.size());
+	for (int i = 0; i < p_function->direct_calls.size(); i++) {
+		put_script(p_function->direct_calls[i].script);
+		put_name(p_function->direct_calls[i].name);
+	}
+
+	// Inline caches are filled at runtime, only their number is stored.
+	put_u32(p_function->inline_caches.size());
+
+	put_u32(p_function->temporary_slots.size());
+	for (const Map<int, Variant::Type>::Element *E = p_function->temporary_slots.front(); E; E = E->next()) {
+		put_u32(E->key());
+		put_u32(E->get());
+	}
+
+	put_u32(p_function->stack_debug.size());
+	for (const List<GDScriptFunction::StackDebug>::Element *E = p_function->stack_debug.front(); E; E = E->next()) {
+		put_u32(E->get().line);
+		put_u32(E->get().pos);
+		put_u32(E->get().added);
+		put_name(E->get().identifier);
+	}
+
+	put_u32(p_function->_stack_size);
+	put_u32(p_function->_instruction_args_size);
+	put_u32(p_function->_ptrcall_args_size);
+
+	put_u32(p_function->lambdas.size());
+	for (int i = 0; i < p_function->lambdas.size(); i++) {
+		Error err = put_function(p_function->lambdas[i]);
+		if (err) {
+			return err;
+		}
+	}
+
+	return OK;
+}
+
+void GDScriptByteCodeCache::Writer::put_class_tree(const GDScript *p_script) {
+	put_u32(p_script->subclasses.size());
+	for (const Map<StringName, Ref<GDScript>>::Element *E = p_script->subclasses.front(); E; E = E->next()) {
+		put_name(E->key());
+		put_class_tree(E->get().ptr());
+	}
+}
+
+Error GDScriptByteCodeCache::Writer::put_class(const GDScript *p_script) {
+	ERR_FAIL_COND_V(!p_script->valid, ERR_INVALID_PARAMETER);
+
+	put_u32(p_script->tool);
+	put_name(p_script->name);
+	put_name(p_script->native.is_valid() ? p_script->native->get_name() : StringName());
+	put_script(p_script->base.ptr());
+
+	put_u32(p_script->members.size());
+	for (const Set<StringName>::Element *E = p_script->members.front(); E; E = E->next()) {
+		put_name(E->get());
+	}
+
+	put_u32(p_script->member_indices.size());
+	for (const Map<StringName, GDScript::MemberInfo>::Element *E = p_script->member_indices.front(); E; E = E->next()) {
+		put_name(E->key());
+		put_u32(E->get().index);
+		put_name(E->get().setter);
+		put_name(E->get().getter);
+		put_u32(E->get().rpc_mode);
+		put_data_type(E->get().data_type);
+	}
+
+	put_u32(p_script->member_info.size());
+	for (const Map<StringName, PropertyInfo>::Element *E = p_script->member_info.front(); E; E = E->next()) {
+		put_name(E->key());
+		put_property_info(E->get());
+	}
+
+	put_u32(p_script->_signals.size());
+	for (const Map<StringName, Vector<StringName>>::Element *E = p_script->_signals.front(); E; E = E->next()) {
+		put_name(E->key());
+		put_u32(E->get().size());
+		for (int i = 0; i < E->get().size(); i++) {
+			put_name(E->get()[i]);
+		}
+	}
+
+	put_u32(p_script->constants.size());
+	for (const Map<StringName, Variant>::Element *E = p_script->constants.front(); E; E = E->next()) {
+		put_name(E->key());
+		Error err = put_variant(E->get());
+		if (err) {
+			return err;
+		}
+	}
+
+	put_u32(p_script->member_functions.size());
+	for (const Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
+		Error err = put_function(E->get());
+		if (err) {
+			return err;
+		}
+	}
+
+#ifdef TOOLS_ENABLED
+	put_u32(p_script->member_lines.size());
+	for (const Map<StringName, int>::Element *E = p_script->member_lines.front(); E; E = E->next()) {
+		put_name(E->key());
+		put_u32(E->get());
+	}
+	put_u32(p_script->member_default_values.size());
+	for (const Map<StringName, Variant>::Element *E = p_script->member_default_values.front(); E; E = E->next()) {
+		put_name(E->key());
+		put_optional_variant(E->get());
+	}
+#else
+	put_u32(0);
+	put_u32(0);
+#endif
+
+	for (const Map<StringName, Ref<GDScript>>::Element *E = p_script->subclasses.front(); E; E = E->next()) {
+		Error err = put_class(E->get().ptr());
+		if (err) {
+			return err;
+		}
+	}
+
+	return OK;
+}
+
+Error GDScriptByteCodeCache::Writer::write(const GDScript *p_script, Vector<uint8_t> &r_buffer) {
+	put_class_tree(p_script);
+	Error err = put_class(p_script);
+	if (err) {
+		return err;
+	}
+
+	// The header and the string table go first, so they are known before the body is read.
+	CharString version = _get_engine_version().utf8();
+	Vector<CharString> utf8_strings;
+	utf8_strings.resize(strings.size());
+	int strings_size = 0;
+	for (int i = 0; i < strings.size(); i++) {
+		utf8_strings.write[i] = String(strings[i]).utf8();
+		strings_size += 4 + utf8_strings[i].length();
+	}
+
+	int header_size = 4 + 4 + 4 + version.length() + 4 + 8 + 4;
+	r_buffer.resize(header_size + strings_size + data.size());
+	uint8_t *w = r_buffer.ptrw();
+
+	memcpy(w, byte_code_magic, 4);
+	w += 4;
+	w += encode_uint32(BYTE_CODE_FORMAT_VERSION, w);
+	w += encode_uint32(version.length(), w);
+	memcpy(w, version.get_data(), version.length());
+	w += version.length();
+	w += encode_uint32(GDScriptFunction::OPCODE_END, w);
+	w += encode_uint64(p_script->source.is_empty() ? 0 : _get_source_hash(p_script->source), w);
+
+	w += encode_uint32(utf8_strings.size(), w);
+	for (int i = 0; i < utf8_strings.size(); i++) {
+		w += encode_uint32(utf8_strings[i].length(), w);
+		memcpy(w, utf8_strings[i].get_data(), utf8_strings[i].length());
+		w += utf8_strings[i].length();
+	}
+
+	if (data.size()) {
+		memcpy(w, data.ptr(), data.size());
+	}
+	return OK;
+}
+
+/* READER */
+
+class GDScriptByteCodeCache::Reader {
+	const uint8_t *data = nullptr;
+	uint32_t size = 0;
+	uint32_t pos = 0;
+	bool failed = false;
+
+	GDScript *root = nullptr;
+	Vector<StringName> strings;
+
+	uint32_t get_u32() {
+		if (pos + 4 > size) {
+			failed = true;
+			return 0;
+		}
+		uint32_t value = decode_uint32(&data[pos]);
+		pos += 4;
+		return value;
+	}
+
+	uint64_t get_u64() {
+		if (pos + 8 > size) {
+			failed = true;
+			return 0;
+		}
+		uint64_t value = decode_uint64(&data[pos]);
+		pos += 8;
+		return value;
+	}
+
+	// Counts are checked against the remaining data, so corrupt files can't trigger huge allocations.
+	uint32_t get_count() {
+		uint32_t count = get_u32();
+		if (count > size - pos) {
+			failed = true;
+			return 0;
+		}
+		return count;
+	}
+
+	String get_utf8() {
+		uint32_t len = get_count();
+		if (failed) {
+			return String();
+		}
+		String string;
+		string.parse_utf8((const char *)&data[pos], len);
+		pos += len;
+		return string;
+	}
+
+	StringName get_name() {
+		uint32_t idx = get_u32();
+		if (idx >= (uint32_t)strings.size()) {
+			failed = true;
+			return StringName();
+		}
+		return strings[idx];
+	}
+
+	Variant get_variant();
+	Script *get_script(Ref<Script> &r_ref);
+	GDScriptDataType get_data_type();
+	PropertyInfo get_property_info();
+	GDScriptFunction *get_function(GDScript *p_script);
+	void get_class_tree(GDScript *p_script);
+	Error get_class(GDScript *p_script);
+
+public:
+	Error read_header(const Vector<uint8_t> &p_buffer, uint64_t *r_source_hash = nullptr);
+	Error read(GDScript *p_script, const Vector<uint8_t> &p_buffer);
+};
+
+Error GDScriptByteCodeCache::Reader::read_header(const Vector<uint8_t> &p_buffer, uint64_t *r_source_hash) {
+	data = p_buffer.ptr();
+	size = p_buffer.size();
+	pos = 0;
+
+	ERR_FAIL_COND_V_MSG(size < 4 || memcmp(data, byte_code_magic, 4) != 0, ERR_FILE_UNRECOGNIZED, "Not a GDScript byte code file.");
+	pos = 4;
+
+	uint32_t format_version = get_u32();
+	String version = get_utf8();
+	uint32_t opcode_count = get_u32();
+	uint64_t source_hash = get_u64();
+	ERR_FAIL_COND_V(failed, ERR_FILE_CORRUPT);
+
+	if (format_version != BYTE_CODE_FORMAT_VERSION || version != _get_engine_version() || opcode_count != GDScriptFunction::OPCODE_END) {
+		ERR_FAIL_V_MSG(ERR_FILE_UNRECOGNIZED, "GDScript byte code was built by a different engine version (" + version + "), export the project again.");
+	}
+
+	if (r_source_hash) {
+		*r_source_hash = source_hash;
+	}
+	return OK;
+}
+
+Variant GDScriptByteCodeCache::Reader::get_variant() {
+	switch (get_u32()) {
+		case VARIANT_VALUE: {
+			uint32_t len = get_count();
+			if (failed) {
+				return Variant();
+			}
+			Variant value;
+			if (decode_variant(value, &data[pos], len) != OK) {
+				failed = true;
+			}
+			pos += len;
+			return value;
+		}
+		case VARIANT_ARRAY: {
+			Array array;
+			array.resize(get_count());
+			for (int i = 0; i < array.size() && !failed; i++) {
+				array[i] = get_variant();
+			}
+			return array;
+		}
+		case VARIANT_DICTIONARY: {
+			Dictionary dictionary;
+			uint32_t count = get_count();
+			for (uint32_t i = 0; i < count && !failed; i++) {
+				Variant key = get_variant();
+				dictionary[key] = get_variant();
+			}
+			return dictionary;
+		}
+		case VARIANT_OBJECT_NULL: {
+			return Variant((Object *)nullptr);
+		}
+		case VARIANT_OBJECT_GLOBAL: {
+			StringName name = get_name();
+			const Map<StringName, int> &globals = GDScriptLanguage::get_singleton()->get_global_map();
+			if (failed || !globals.has(name)) {
+				failed = true;
+				ERR_FAIL_V_MSG(Variant(), "Global '" + String(name) + "' used by GDScript byte code doesn't exist.");
+			}
+			return GDScriptLanguage::get_singleton()->get_global_array()[globals[name]];
+		}
+		case VARIANT_OBJECT_SCRIPT: {
+			Ref<Script> script;
+			get_script(script);
+			return script;
+		}
+		case VARIANT_OBJECT_RESOURCE: {
+			String path = get_name();
+			RES resource = failed ? RES() : ResourceLoader::load(path);
+			if (resource.is_null()) {
+				failed = true;
+				ERR_FAIL_V_MSG(Variant(), "Can't load resource '" + path + "' used by GDScript byte code.");
+			}
+			return resource;
+		}
+	}
+
+	failed = true;
+	return Variant();
+}
+
+Script *GDScriptByteCodeCache::Reader::get_script(Ref<Script> &r_ref) {
+	uint32_t kind = get_u32();
+	if (kind == SCRIPT_NONE || failed) {
+		return nullptr;
+	}
+
+	String name = get_name();
+	if (failed) {
+		return nullptr;
+	}
+
+	if (kind == SCRIPT_RESOURCE) {
+		r_ref = ResourceLoader::load(name);
+		if (r_ref.is_null()) {
+			failed = true;
+			ERR_FAIL_V_MSG(nullptr, "Can't load script '" + name + "' used by GDScript byte code.");
+		}
+		return r_ref.ptr();
+	}
+
+	// Fully qualified names are the script path followed by the names of the inner classes.
+	Vector<String> parts = name.split("::");
+	Ref<GDScript> script;
+	if (parts[0] == root->path) {
+		script = Ref<GDScript>(root);
+	} else if (parts.size() == 1) {
+		script = GDScriptCache::get_shallow_script(parts[0], root->path);
+	} else {
+		// Inner classes only exist once their script is loaded.
+		Error err = OK;
+		script = GDScriptCache::get_full_script(parts[0], err, root->path);
+	}
+
+	for (int i = 1; i < parts.size() && script.is_valid(); i++) {
+		const Map<StringName, Ref<GDScript>>::Element *E = script->subclasses.find(parts[i]);
+		script = E ? E->get() : Ref<GDScript>();
+	}
+
+	if (script.is_null()) {
+		failed = true;
+		ERR_FAIL_V_MSG(nullptr, "Can't find class '" + name + "' used by GDScript byte code.");
+	}
+
+	r_ref = script;
+	return script.ptr();
+}
+
+GDScriptDataType GDScriptByteCodeCache::Reader::get_data_type() {
+	GDScriptDataType type;
+	type.kind = GDScriptDataType::Kind(get_u32());
+	type.has_type = get_u32();
+	type.builtin_type = Variant::Type(get_u32());
+	type.native_type = get_name();
+	type.script_type = get_script(type.script_type_ref);
+	if (get_u32()) {
+		type.script_type_ref = Ref<Script>();
+	}
+	if (get_u32() && !failed) {
+		type.set_container_element_type(get_data_type());
+	}
+	return type;
+}
+
+PropertyInfo GDScriptByteCodeCache::Reader::get_property_info() {
+	PropertyInfo info;
+	info.type = Variant::Type(get_u32());
+	info.name = get_name();
+	info.class_name = get_name();
+	info.hint = PropertyHint(get_u32());
+	info.hint_string = get_name();
+	info.usage = get_u32();
+	return info;
+}
+
+GDScriptFunction *GDScriptByteCodeCache::Reader::get_function(GDScript *p_script) {
+	GDScriptFunction *function = memnew(GDScriptFunction);
+	function->_script = p_script;
+	function->source = root->path;
+
+	function->name = get_name();
+	function->_static = get_u32();
+	function->rpc_mode = MultiplayerAPI::RPCMode(get_u32());
+	function->_initial_line = get_u32();
+	function->return_type = get_data_type();
+
+	function->_argument_count = get_u32();
+	function->argument_types.resize(get_count());
+	for (int i = 0; i < function->argument_types.size() && !failed; i++) {
+		function->argument_types.write[i] = get_data_type();
+	}
+	function->default_arguments.resize(get_count());
+	for (int i = 0; i < function->default_arguments.size(); i++) {
+		function->default_arguments.write[i] = get_u32();
+	}
+
+	// Editor-only data, always stored so the format doesn't depend on the build.
+	uint32_t arg_name_count = get_count();
+	for (uint32_t i = 0; i < arg_name_count && !failed; i++) {
+#ifdef TOOLS_ENABLED
+		function->arg_names.push_back(get_name());
+#else
+		get_name();
+#endif
+	}
+	uint32_t default_arg_value_count = get_count();
+	for (uint32_t i = 0; i < default_arg_value_count && !failed; i++) {
+#ifdef TOOLS_ENABLED
+		function->default_arg_values.push_back(get_variant());
+#else
+		get_variant();
+#endif
+	}
+
+	function->constants.resize(get_count());
+	for (int i = 0; i < function->constants.size() && !failed; i++) {
+		function->constants.write[i] = get_variant();
+	}
+	function->global_names.resize(get_count());
+	for (int i = 0; i < function->global_names.size() && !failed; i++) {
+		function->global_names.write[i] = get_name();
+	}
+	function->code.resize(get_count());
+	for (int i = 0; i < function->code.size(); i++) {
+		function->code.write[i] = get_u32();
+	}
+
+	function->operator_funcs.resize(get_count());
+	for (int i = 0; i < function->operator_funcs.size() && !failed; i++) {
+		Variant::Operator op = Variant::Operator(get_u32());
+		Variant::Type left = Variant::Type(get_u32());
+		Variant::Type right = Variant::Type(get_u32());
+		if (op >= Variant::OP_MAX || left >= Variant::VARIANT_MAX || right >= Variant::VARIANT_MAX) {
+			failed = true;
+			break;
+		}
+		function->operator_funcs.write[i] = Variant::get_validated_operator_evaluator(op, left, right);
+	}
+
+	function->setters.resize(get_count());
+	for (int i = 0; i < function->setters.size() && !failed; i++) {
+		Variant::Type type = Variant::Type(get_u32());
+		StringName member = get_name();
+		function->setters.write[i] = type < Variant::VARIANT_MAX ? Variant::get_member_validated_setter(type, member) : nullptr;
+	}
+
+	function->getters.resize(get_count());
+	for (int i = 0; i < function->getters.size() && !failed; i++) {
+		Variant::Type type = Variant::Type(get_u32());
+		StringName member = get_name();
+		function->getters.write[i] = type < Variant::VARIANT_MAX ? Variant::get_member_validated_getter(type, member) : nullptr;
+	}
+
+	function->keyed_setters.resize(get_count());
+	for (int i = 0; i < function->keyed_setters.size() && !failed; i++) {
+		Variant::Type type = Variant::Type(get_u32());
+		function->keyed_setters.write[i] = type < Variant::VARIANT_MAX ? Variant::get_member_validated_keyed_setter(type) : nullptr;
+	}
+
+	function->keyed_getters.resize(get_count());
+	for (int i = 0; i < function->keyed_getters.size() && !failed; i++) {
+		Variant::Type type = Variant::Type(get_u32());
+		function->keyed_getters.write[i] = type < Variant::VARIANT_MAX ? Variant::get_member_validated_keyed_getter(type) : nullptr;
+	}
+
+	function->indexed_setters.resize(get_count());
+	for (int i = 0; i < function->indexed_setters.size() && !failed; i++) {
+		Variant::Type type = Variant::Type(get_u32());
+		function->indexed_setters.write[i] = type < Variant::VARIANT_MAX ? Variant::get_member_validated_indexed_setter(type) : nullptr;
+	}
+
+	function->indexed_getters.resize(get_count());
+	for (int i = 0; i < function->indexed_getters.size() && !failed; i++) {
+		Variant::Type type = Variant::Type(get_u32());
+		function->indexed_getters.write[i] = type < Variant::VARIANT_MAX ? Variant::get_member_validated_indexed_getter(type) : nullptr;
+	}
+
+	function->builtin_methods.resize(get_count());
+	for (int i = 0; i < function->builtin_methods.size() && !failed; i++) {
+		Variant::Type type = Variant::Type(get_u32());
+		StringName method = get_name();
+		function->builtin_methods.write[i] = type < Variant::VARIANT_MAX ? Variant::get_validated_builtin_method(type, method) : nullptr;
+	}
+
+	function->constructors.resize(get_count());
+	for (int i = 0; i < function->constructors.size() && !failed; i++) {
+		Variant::Type type = Variant::Type(get_u32());
+		int index = get_u32();
+		function->constructors.write[i] = type < Variant::VARIANT_MAX && index < Variant::get_constructor_count(type) ? Variant::get_validated_constructor(type, index) : nullptr;
+	}
+
+	function->utilities.resize(get_count());
+	for (int i = 0; i < function->utilities.size() && !failed; i++) {
+		function->utilities.write[i] = Variant::get_validated_utility_function(get_name());
+	}
+
+	function->gds_utilities.resize(get_count());
+	for (int i = 0; i < function->gds_utilities.size() && !failed; i++) {
+		function->gds_utilities.write[i] = GDScriptUtilityFunctions::get_function(get_name());
+	}
+
+	function->methods.resize(get_count());
+	for (int i = 0; i < function->methods.size() && !failed; i++) {
+		StringName class_name = get_name();
+		StringName method = get_name();
+		function->methods.write[i] = ClassDB::get_method(class_name, method);
+	}
+
+	function->direct_calls.resize(get_count());
+	for (int i = 0; i < function->direct_calls.size() && !failed; i++) {
+		// Only the address is compared at runtime, see OPCODE_CALL_SCRIPT_FUNCTION.
+		Ref<Script> script;
+		function->direct_calls.write[i].script = Object::cast_to<GDScript>(get_script(script));
+		function->direct_calls.write[i].name = get_name();
+	}
+
+	// Each cache belongs to an instruction, so there can't be more of them than code.
+	uint32_t inline_cache_count = get_u32();
+	if (inline_cache_count > uint32_t(function->code.size())) {
+		failed = true;
+		inline_cache_count = 0;
+	}
+	function->inline_caches.resize(inline_cache_count);
+
+	uint32_t temporary_slot_count = get_count();
+	for (uint32_t i = 0; i < temporary_slot_count && !failed; i++) {
+		int slot = get_u32();
+		function->temporary_slots[slot] = Variant::Type(get_u32());
+	}
+
+	uint32_t stack_debug_count = get_count();
+	for (uint32_t i = 0; i < stack_debug_count && !failed; i++) {
+		GDScriptFunction::StackDebug sd;
+		sd.line = get_u32();
+		sd.pos = get_u32();
+		sd.added = get_u32();
+		sd.identifier = get_name();
+		function->stack_debug.push_back(sd);
+	}
+
+	function->_stack_size = get_u32();
+	function->_instruction_args_size = get_u32();
+	function->_ptrcall_args_size = get_u32();
+
+	uint32_t lambda_count = get_count();
+	for (uint32_t i = 0; i < lambda_count && !failed; i++) {
+		function->lambdas.push_back(get_function(p_script));
+	}
+
+	// Any function that didn't resolve means the engine doesn't match what the script was built against.
+#define CHECK_RESOLVED(m_table)                          \
+	for (int i = 0; i < function->m_table.size(); i++) { \
+		if (!function->m_table[i]) {                     \
+			failed = true;                               \
+		}                                                \
+	}
+	CHECK_RESOLVED(operator_funcs);
+	CHECK_RESOLVED(setters);
+	CHECK_RESOLVED(getters);
+	CHECK_RESOLVED(keyed_setters);
+	CHECK_RESOLVED(keyed_getters);
+	CHECK_RESOLVED(indexed_setters);
+	CHECK_RESOLVED(indexed_getters);
+	CHECK_RESOLVED(builtin_methods);
+	CHECK_RESOLVED(constructors);
+	CHECK_RESOLVED(utilities);
+	CHECK_RESOLVED(gds_utilities);
+	CHECK_RESOLVED(methods);
+#undef CHECK_RESOLVED
+
+	// Same setup as GDScriptByteCodeGenerator::write_end().
+	function->_constant_count = function->constants.size();
+	function->_constants_ptr = function->constants.size() ? function->constants.ptrw() : nullptr;
+	function->_global_names_count = function->global_names.size();
+	function->_global_names_ptr = function->global_names.size() ? function->global_names.ptr() : nullptr;
+	function->_code_size = function->code.size();
+	function->_code_ptr = function->code.size() ? function->code.ptr() : nullptr;
+	function->_default_arg_count = function->default_arguments.size() ? function->default_arguments.size() - 1 : 0;
+	function->_default_arg_ptr = function->default_arguments.size() ? function->default_arguments.ptr() : nullptr;
+	function->_operator_funcs_count = function->operator_funcs.size();
+	function->_operator_funcs_ptr = function->operator_funcs.size() ? function->operator_funcs.ptr() : nullptr;
+	function->_setters_count = function->setters.size();
+	function->_setters_ptr = function->setters.size() ? function->setters.ptr() : nullptr;
+	function->_getters_count = function->getters.size();
+	function->_getters_ptr = function->getters.size() ? function->getters.ptr() : nullptr;
+	function->_keyed_setters_count = function->keyed_setters.size();
+	function->_keyed_setters_ptr = function->keyed_setters.size() ? function->keyed_setters.ptr() : nullptr;
+	function->_keyed_getters_count = function->keyed_getters.size();
+	function->_keyed_getters_ptr = function->keyed_getters.size() ? function->keyed_getters.ptr() : nullptr;
+	function->_indexed_setters_count = function->indexed_setters.size();
+	function->_indexed_setters_ptr = function->indexed_setters.size() ? function->indexed_setters.ptr() : nullptr;
+	function->_indexed_getters_count = function->indexed_getters.size();
+	function->_indexed_getters_ptr = function->indexed_getters.size() ? function->indexed_getters.ptr() : nullptr;
+	function->_builtin_methods_count = function->builtin_methods.size();
+	function->_builtin_methods_ptr = function->builtin_methods.size() ? function->builtin_methods.ptr() : nullptr;
+	function->_constructors_count = function->constructors.size();
+	function->_constructors_ptr = function->constructors.size() ? function->constructors.ptr() : nullptr;
+	function->_utilities_count = function->utilities.size();
+	function->_utilities_ptr = function->utilities.size() ? function->utilities.ptr() : nullptr;
+	function->_gds_utilities_count = function->gds_utilities.size();
+	function->_gds_utilities_ptr = function->gds_utilities.size() ? function->gds_utilities.ptr() : nullptr;
+	function->_methods_count = function->methods.size();
+	function->_methods_ptr = function->methods.size() ? function->methods.ptrw() : nullptr;
+	function->_lambdas_count = function->lambdas.size();
+	function->_lambdas_ptr = function->lambdas.size() ? function->lambdas.ptrw() : nullptr;
+	function->_direct_calls_count = function->direct_calls.size();
+	function->_direct_calls_ptr = function->direct_calls.size() ? function->direct_calls.ptrw() : nullptr;
+	function->_inline_caches_count = function->inline_caches.size();
+	function->_inline_caches_ptr = function->inline_caches.size() ? function->inline_caches.ptrw() : nullptr;
+
+#ifdef DEBUG_ENABLED
+	function->func_cname = (String(function->source) + " - " + String(function->name)).utf8();
+	function->_func_cname = function->func_cname.get_data();
+	if (EngineDebugger::is_active()) {
+		String class_prefix = p_script->name.is_empty() ? String() : p_script->name + ".";
+		function->profile.signature = String(function->source) + "::" + itos(function->_initial_line) + "::" + class_prefix + String(function->name);
+	}
+#endif
+
+	return function;
+}
+
+void GDScriptByteCodeCache::Reader::get_class_tree(GDScript *p_script) {
+	// Same as GDScriptCompiler::_make_scripts(), every class must exist before anything can refer to it.
+	p_script->subclasses.clear();
+
+	uint32_t count = get_count();
+	for (uint32_t i = 0; i < count && !failed; i++) {
+		StringName name = get_name();
+
+		Ref<GDScript> subclass;
+		subclass.instance();
+		subclass->_owner = p_script;
+		subclass->fully_qualified_name = p_script->fully_qualified_name + "::" + name;
+		p_script->subclasses.insert(name, subclass);
+
+		get_class_tree(subclass.ptr());
+	}
+}
+
+Error GDScriptByteCodeCache::Reader::get_class(GDScript *p_script) {
+	p_script->tool = get_u32();
+	p_script->name = get_name();
+
+	StringName native_name = get_name();
+	if (native_name != StringName()) {
+		const Map<StringName, int> &globals = GDScriptLanguage::get_singleton()->get_global_map();
+		ERR_FAIL_COND_V_MSG(!globals.has(native_name), ERR_FILE_CORRUPT, "Unknown native class '" + String(native_name) + "' in GDScript byte code.");
+		p_script->native = GDScriptLanguage::get_singleton()->get_global_array()[globals[native_name]];
+		ERR_FAIL_COND_V(p_script->native.is_null(), ERR_FILE_CORRUPT);
+	}
+
+	Ref<Script> base;
+	get_script(base);
+	p_script->base = base;
+	p_script->_base = p_script->base.ptr();
+
+	uint32_t member_count = get_count();
+	for (uint32_t i = 0; i < member_count && !failed; i++) {
+		p_script->members.insert(get_name());
+	}
+
+	uint32_t member_index_count = get_count();
+	for (uint32_t i = 0; i < member_index_count && !failed; i++) {
+		StringName name = get_name();
+		GDScript::MemberInfo minfo;
+		minfo.index = get_u32();
+		minfo.setter = get_name();
+		minfo.getter = get_name();
+		minfo.rpc_mode = MultiplayerAPI::RPCMode(get_u32());
+		minfo.data_type = get_data_type();
+		p_script->member_indices[name] = minfo;
+	}
+
+	uint32_t member_info_count = get_count();
+	for (uint32_t i = 0; i < member_info_count && !failed; i++) {
+		StringName name = get_name();
+		p_script->member_info[name] = get_property_info();
+	}
+
+	uint32_t signal_count = get_count();
+	for (uint32_t i = 0; i < signal_count && !failed; i++) {
+		StringName name = get_name();
+		Vector<StringName> parameters;
+		parameters.resize(get_count());
+		for (int j = 0; j < parameters.size(); j++) {
+			parameters.write[j] = get_name();
+		}
+		p_script->_signals[name] = parameters;
+	}
+
+	uint32_t constant_count = get_count();
+	for (uint32_t i = 0; i < constant_count && !failed; i++) {
+		StringName name = get_name();
+		p_script->constants[name] = get_variant();
+	}
+
+	uint32_t function_count = get_count();
+	for (uint32_t i = 0; i < function_count && !failed; i++) {
+		GDScriptFunction *function = get_function(p_script);
+		if (p_script->member_functions.has(function->name)) {
+			memdelete(p_script->member_functions[function->name]);
+		}
+		p_script->member_functions[function->name] = function;
+	}
+
+	uint32_t member_line_count = get_count();
+	for (uint32_t i = 0; i < member_line_count && !failed; i++) {
+		StringName name = get_name();
+#ifdef TOOLS_ENABLED
+		p_script->member_lines[name] = get_u32();
+#else
+		get_u32();
+#endif
+	}
+	uint32_t member_default_value_count = get_count();
+	for (uint32_t i = 0; i < member_default_value_count && !failed; i++) {
+		StringName name = get_name();
+#ifdef TOOLS_ENABLED
+		p_script->member_default_values[name] = get_variant();
+#else
+		get_variant();
+#endif
+	}
+
+	ERR_FAIL_COND_V_MSG(failed, ERR_FILE_CORRUPT, "Corrupt or incompatible GDScript byte code.");
+
+	const Map<StringName, GDScriptFunction *>::Element *initializer = p_script->member_functions.find(GDScriptLanguage::get_singleton()->strings._init);
+	p_script->initializer = initializer ? initializer->get() : nullptr;
+	const Map<StringName, GDScriptFunction *>::Element *implicit_initializer = p_script->member_functions.find("@implicit_new");
+	p_script->implicit_initializer = implicit_initializer ? implicit_initializer->get() : nullptr;
+
+	for (Map<StringName, Ref<GDScript>>::Element *E = p_script->subclasses.front(); E; E = E->next()) {
+		Error err = get_class(E->get().ptr());
+		if (err) {
+			return err;
+		}
+	}
+
+	p_script->valid = true;
+	return OK;
+}
+
+Error GDScriptByteCodeCache::Reader::read(GDScript *p_script, const Vector<uint8_t> &p_buffer) {
+	Error err = read_header(p_buffer);
+	if (err) {
+		return err;
+	}
+
+	strings.resize(get_count());
+	for (int i = 0; i < strings.size() && !failed; i++) {
+		strings.write[i] = get_utf8();
+	}
+	ERR_FAIL_COND_V(failed, ERR_FILE_CORRUPT);
+
+	root = p_script;
+
+	// Start from a clean state, like GDScriptCompiler::_parse_class_level().
+	p_script->valid = false;
+	p_script->native = Ref<GDScriptNativeClass>();
+	p_script->base = Ref<GDScript>();
+	p_script->_base = nullptr;
+	p_script->_owner = nullptr;
+	p_script->members.clear();
+	p_script->constants.clear();
+	for (Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
+		memdelete(E->get());
+	}
+	p_script->member_functions.clear();
+	GDScriptFunction::invalidate_direct_calls();
+	p_script->member_indices.clear();
+	p_script->member_info.clear();
+	p_script->_signals.clear();
+	p_script->initializer = nullptr;
+	p_script->implicit_initializer = nullptr;
+	p_script->fully_qualified_name = p_script->path;
+
+	get_class_tree(p_script);
+	ERR_FAIL_COND_V(failed, ERR_FILE_CORRUPT);
+
+	err = get_class(p_script);
+	if (err) {
+		return err;
+	}
+
+	if (!p_script->path.is_empty()) {
+		// Scripts only referred to by type or constant were loaded shallowly, finish them as the compiler would.
+		return GDScriptCache::finish_compiling(p_script->path);
+	}
+	return OK;
+}
+
+/* GDScriptByteCodeCache */
+
+Error GDScriptByteCodeCache::save(const GDScript *p_script, Vector<uint8_t> &r_buffer) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(!p_script->is_valid(), ERR_INVALID_PARAMETER, "Only successfully compiled scripts can be stored as byte code.");
+
+	Writer writer;
+	return writer.write(p_script, r_buffer);
+}
+
+Error GDScriptByteCodeCache::load(GDScript *p_script, const Vector<uint8_t> &p_buffer) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+
+	Reader reader;
+	return reader.read(p_script, p_buffer);
+}
+
+bool GDScriptByteCodeCache::is_built_from(const Vector<uint8_t> &p_buffer, const String &p_source) {
+	Reader reader;
+	uint64_t source_hash = 0;
+	if (reader.read_header(p_buffer, &source_hash) != OK) {
+		return false;
+	}
+	return source_hash == _get_source_hash(p_source);
+}
@@ -0,0 +1,55 @@
+/*************************************************************************/
+/*  gdscript_byte_code_cache.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_BYTE_CODE_CACHE_H
+#define GDSCRIPT_BYTE_CODE_CACHE_H
+
+#include "core/string/ustring.h"
+#include "core/templates/vector.h"
+
+class GDScript;
+
+// Serializes fully compiled scripts (classes, functions and their bytecode) so
+// they can be loaded without going through the parser, analyzer and compiler.
+// The validated function pointers used by the VM are stored by signature and
+// resolved again on load, so the data only depends on the engine version.
+class GDScriptByteCodeCache {
+	class Writer;
+	class Reader;
+
+public:
+	static Error save(const GDScript *p_script, Vector<uint8_t> &r_buffer);
+	static Error load(GDScript *p_script, const Vector<uint8_t> &p_buffer);
+
+	// Whether the buffer was produced from this exact source code.
+	static bool is_built_from(const Vector<uint8_t> &p_buffer, const String &p_source);
+};
+
+#endif // GDSCRIPT_BYTE_CODE_CACHE_H
@@ -33,6 +33,22 @@
 #include "core/debugger/engine_debugger.h"
 #include "gdscript.h"
 
+uint32_t GDScriptByteCodeGenerator::optimizations = GDScriptByteCodeGenerator::OPTIMIZE_ALL;
+
+static bool _is_same_address(const GDScriptCodeGenerator::Address &p_a, const GDScriptCodeGenerator::Address &p_b) {
+	switch (p_a.mode) {
+		case GDScriptCodeGenerator::Address::MEMBER:
+		case GDScriptCodeGenerator::Address::TEMPORARY:
+			return p_b.mode == p_a.mode && p_b.address == p_a.address;
+		case GDScriptCodeGenerator::Address::LOCAL_VARIABLE:
+		case GDScriptCodeGenerator::Address::FUNCTION_PARAMETER:
+			// Both live in the stack, parameters being the first locals.
+			return (p_b.mode == GDScriptCodeGenerator::Address::LOCAL_VARIABLE || p_b.mode == GDScriptCodeGenerator::Address::FUNCTION_PARAMETER) && p_b.address == p_a.address;
+		default:
+			return false;
+	}
+}
+
 uint32_t GDScriptByteCodeGenerator::add_parameter(const StringName &p_name, bool p_is_optional, const GDScriptDataType &p_type) {
 #ifdef TOOLS_ENABLED
 	function->arg_names.push_back(p_name);
@@ -139,6 +155,10 @@ uint32_t GDScriptByteCodeGenerator::add_temporary(const GDScriptDataType &p_type
 void GDScriptByteCodeGenerator::pop_temporary() {
 	ERR_FAIL_COND(used_temporaries.is_empty());
 	int slot_idx = used_temporaries.back()->get();
+	// The value can't be read anymore, so the last write to it may be redundant.
+	if (!_propagate_copy(slot_idx)) {
+		_eliminate_dead_store(slot_idx);
+	}
 	const StackSlot &slot = temporaries[slot_idx];
 	temporaries_pool[slot.type].push_back(slot_idx);
 	used_temporaries.pop_back();
@@ -148,6 +168,7 @@ void GDScriptByteCodeGenerator::start_parameters() {
 	if (function->_default_arg_count > 0) {
 		append(GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT);
 		function->default_arguments.push_back(opcodes.size());
+		add_label(opcodes.size());
 	}
 }
 
@@ -182,6 +203,10 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 #endif
 	append(GDScriptFunction::OPCODE_END, 0);
 
+	if (_is_optimizing(OPTIMIZE_JUMP_THREADING)) {
+		_thread_jumps();
+	}
+
 	for (int i = 0; i < temporaries.size(); i++) {
 		int stack_index = i + max_locals + RESERVED_STACK;
 		for (int j = 0; j < temporaries[i].bytecode_indices.size(); j++) {
@@ -393,6 +418,24 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		function->_lambdas_count = 0;
 	}
 
+	if (direct_calls.size()) {
+		function->direct_calls = direct_calls;
+		function->_direct_calls_ptr = function->direct_calls.ptrw();
+		function->_direct_calls_count = direct_calls.size();
+	} else {
+		function->_direct_calls_ptr = nullptr;
+		function->_direct_calls_count = 0;
+	}
+
+	if (inline_cache_count) {
+		function->inline_caches.resize(inline_cache_count);
+		function->_inline_caches_ptr = function->inline_caches.ptrw();
+		function->_inline_caches_count = inline_cache_count;
+	} else {
+		function->_inline_caches_ptr = nullptr;
+		function->_inline_caches_count = 0;
+	}
+
 	if (debug_stack) {
 		function->stack_debug = stack_debug;
 	}
@@ -404,6 +447,172 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 	return function;
 }
 
+void GDScriptByteCodeGenerator::_truncate_code(int p_position) {
+	for (int i = 0; i < temporaries.size(); i++) {
+		Vector<int> &indices = temporaries.write[i].bytecode_indices;
+		while (!indices.is_empty() && indices[indices.size() - 1] >= p_position) {
+			indices.resize(indices.size() - 1);
+		}
+	}
+	while (!jump_operands.is_empty() && jump_operands[jump_operands.size() - 1] >= p_position) {
+		jump_operands.resize(jump_operands.size() - 1);
+	}
+	opcodes.resize(p_position);
+
+	last_instruction_start = -1;
+	last_store = Store();
+	pending_copy = PendingCopy();
+}
+
+void GDScriptByteCodeGenerator::_record_store(const Address &p_target, int p_target_pos, Variant::Type p_result_type, bool p_validated, bool p_pure, const Address &p_left_operand, const Address &p_right_operand) {
+	last_store.start = last_instruction_start;
+	last_store.target_pos = p_target_pos;
+	last_store.target = p_target;
+	last_store.left_operand = p_left_operand;
+	last_store.right_operand = p_right_operand;
+	last_store.result_type = p_result_type;
+	last_store.validated = p_validated;
+	last_store.pure = p_pure;
+}
+
+bool GDScriptByteCodeGenerator::_fold_constant(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
+	if (!_is_optimizing(OPTIMIZE_CONSTANT_FOLDING)) {
+		return false;
+	}
+	if (p_left_operand.mode != Address::CONSTANT || (p_right_operand.mode != Address::CONSTANT && p_right_operand.mode != Address::NIL)) {
+		return false;
+	}
+
+	Variant left;
+	Variant right;
+	const Variant *K = nullptr;
+	while ((K = constant_map.next(K))) {
+		int idx = constant_map[*K];
+		if (idx == (int)p_left_operand.address) {
+			left = *K;
+		}
+		if (p_right_operand.mode == Address::CONSTANT && idx == (int)p_right_operand.address) {
+			right = *K;
+		}
+	}
+	// Objects may run script code when operated on.
+	if (left.get_type() == Variant::OBJECT || right.get_type() == Variant::OBJECT) {
+		return false;
+	}
+
+	Variant result;
+	bool valid;
+	Variant::evaluate(p_operator, left, right, result, valid);
+	// Only fold into value types, as constants are shared by every call of the function.
+	if (!valid || result.get_type() == Variant::NIL || result.get_type() >= Variant::OBJECT) {
+		return false;
+	}
+
+	GDScriptDataType type;
+	type.has_type = true;
+	type.kind = GDScriptDataType::BUILTIN;
+	type.builtin_type = result.get_type();
+	write_assign(p_target, Address(Address::CONSTANT, get_constant_pos(result), type));
+	return true;
+}
+
+bool GDScriptByteCodeGenerator::_propagate_copy(int p_temporary) {
+	if (!_is_optimizing(OPTIMIZE_COPY_PROPAGATION)) {
+		return false;
+	}
+	// The assignment from the temporary must be the last thing written, right after the instruction producing it.
+	if (pending_copy.start < 0 || pending_copy.temporary != p_temporary || pending_copy.start != last_instruction_start) {
+		return false;
+	}
+
+	Store source = pending_copy.source;
+	Address target = pending_copy.target;
+	if (last_label > source.start) {
+		return false; // Something jumps in between.
+	}
+	if (target.mode != Address::MEMBER && target.mode != Address::LOCAL_VARIABLE && target.mode != Address::FUNCTION_PARAMETER) {
+		return false;
+	}
+	if (target.mode == Address::MEMBER && _is_local_operator(opcodes[source.start])) {
+		return false; // Local operators only write to the stack.
+	}
+	if (target.type.has_type) {
+		// The assignment would have to check or convert the value.
+		if (target.type.kind != GDScriptDataType::BUILTIN || target.type.builtin_type != source.result_type || target.type.has_container_element_type()) {
+			return false;
+		}
+	}
+	if (_is_same_address(target, source.left_operand) || _is_same_address(target, source.right_operand)) {
+		// Validated operators read their operands before writing the result, unless they have to reset a reference counted result first.
+		if (!source.validated || source.result_type > Variant::COLOR) {
+			return false;
+		}
+	}
+
+	// Write to the target directly and drop the assignment.
+	Vector<int> &indices = temporaries.write[p_temporary].bytecode_indices;
+	int index = indices.find(source.target_pos);
+	ERR_FAIL_COND_V(index < 0, false);
+	indices.remove(index);
+	_truncate_code(pending_copy.start);
+	opcodes.write[source.target_pos] = address_of(target);
+
+	last_instruction_start = source.start;
+	last_store = source;
+	last_store.target = target;
+	return true;
+}
+
+bool GDScriptByteCodeGenerator::_eliminate_dead_store(int p_temporary) {
+	if (!_is_optimizing(OPTIMIZE_DEAD_STORE_ELIMINATION)) {
+		return false;
+	}
+	if (last_store.start < 0 || last_store.start != last_instruction_start || !last_store.pure) {
+		return false;
+	}
+	if (last_store.target.mode != Address::TEMPORARY || (int)last_store.target.address != p_temporary || last_label > last_store.start) {
+		return false;
+	}
+
+	_truncate_code(last_store.start);
+	return true;
+}
+
+void GDScriptByteCodeGenerator::_write_jump_if_not(const Address &p_condition) {
+	if (_is_optimizing(OPTIMIZE_SUPERINSTRUCTIONS) && last_store.start >= 0 && last_store.start == last_instruction_start && last_label <= last_store.start) {
+		// Fuse with the comparison producing the condition, the jump target is appended by the caller.
+		if ((opcodes[last_store.start] & GDScriptFunction::INSTR_MASK) == GDScriptFunction::OPCODE_OPERATOR_VALIDATED && last_store.result_type == Variant::BOOL && _is_same_address(last_store.target, p_condition)) {
+			opcodes.write[last_store.start] = GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT | (3 << GDScriptFunction::INSTR_BITS);
+			last_store = Store();
+			return;
+		}
+		if (_is_local_operator(opcodes[last_store.start]) && last_store.result_type == Variant::BOOL && _is_same_address(last_store.target, p_condition)) {
+			bool is_int = (opcodes[last_store.start] & GDScriptFunction::INSTR_MASK) == GDScriptFunction::OPCODE_OPERATOR_INT_LOCAL;
+			opcodes.write[last_store.start] = is_int ? GDScriptFunction::OPCODE_OPERATOR_INT_LOCAL_JUMP_IF_NOT : GDScriptFunction::OPCODE_OPERATOR_FLOAT_LOCAL_JUMP_IF_NOT;
+			last_store = Store();
+			return;
+		}
+	}
+
+	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
+	append(p_condition);
+}
+
+void GDScriptByteCodeGenerator::_thread_jumps() {
+	for (int i = 0; i < jump_operands.size(); i++) {
+		int operand = jump_operands[i];
+		int target = opcodes[operand];
+		// Limit the hops, as jumps may form a cycle.
+		for (int hops = 0; hops < 8; hops++) {
+			if (target < 0 || target + 1 >= opcodes.size() || (opcodes[target] & GDScriptFunction::INSTR_MASK) != GDScriptFunction::OPCODE_JUMP) {
+				break;
+			}
+			target = opcodes[target + 1];
+		}
+		opcodes.write[operand] = target;
+	}
+}
+
 #ifdef DEBUG_ENABLED
 void GDScriptByteCodeGenerator::set_signature(const String &p_signature) {
 	function->profile.signature = p_signature;
@@ -420,6 +629,18 @@ void GDScriptByteCodeGenerator::set_initial_line(int p_line) {
 #define IS_BUILTIN_TYPE(m_var, m_type) \
 	(m_var.type.has_type && m_var.type.kind == GDScriptDataType::BUILTIN && m_var.type.builtin_type == m_type)
 
+// Returns the element type of typed arrays the VM accesses in place, or NIL.
+static Variant::Type _get_direct_array_element_type(const GDScriptDataType &p_type) {
+	if (!p_type.has_type || p_type.kind != GDScriptDataType::BUILTIN || p_type.builtin_type != Variant::ARRAY || !p_type.has_container_element_type()) {
+		return Variant::NIL;
+	}
+	GDScriptDataType element_type = p_type.get_container_element_type();
+	if (element_type.kind != GDScriptDataType::BUILTIN || !GDScriptFunction::is_direct_array_element_type(element_type.builtin_type)) {
+		return Variant::NIL;
+	}
+	return element_type.builtin_type;
+}
+
 void GDScriptByteCodeGenerator::write_type_adjust(const Address &p_target, Variant::Type p_new_type) {
 	switch (p_new_type) {
 		case Variant::BOOL:
@@ -532,6 +753,10 @@ void GDScriptByteCodeGenerator::write_type_adjust(const Address &p_target, Varia
 }
 
 void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand) {
+	if (_fold_constant(p_target, p_operator, p_left_operand, Address())) {
+		return;
+	}
+
 	if (HAS_BUILTIN_TYPE(p_left_operand)) {
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, Variant::NIL);
@@ -541,6 +766,7 @@ void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Va
 		append(Address());
 		append(p_target);
 		append(op_func);
+		_record_store(p_target, opcodes.size() - 2, Variant::get_operator_return_type(p_operator, p_left_operand.type.builtin_type, Variant::NIL), true, true, p_left_operand);
 		return;
 	}
 
@@ -550,10 +776,19 @@ void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Va
 	append(Address());
 	append(p_target);
 	append(p_operator);
+	_record_store(p_target, opcodes.size() - 2, Variant::VARIANT_MAX, false, false, p_left_operand);
 }
 
 void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
+	if (_fold_constant(p_target, p_operator, p_left_operand, p_right_operand)) {
+		return;
+	}
+
 	if (HAS_BUILTIN_TYPE(p_left_operand) && HAS_BUILTIN_TYPE(p_right_operand)) {
+		if (_write_local_operator(p_target, p_operator, p_left_operand, p_right_operand)) {
+			return;
+		}
+
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
@@ -562,6 +797,7 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 		append(p_right_operand);
 		append(p_target);
 		append(op_func);
+		_record_store(p_target, opcodes.size() - 2, Variant::get_operator_return_type(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type), true, true, p_left_operand, p_right_operand);
 		return;
 	}
 
@@ -571,6 +807,49 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 	append(p_right_operand);
 	append(p_target);
 	append(p_operator);
+	_record_store(p_target, opcodes.size() - 2, Variant::VARIANT_MAX, false, false, p_left_operand, p_right_operand);
+}
+
+// Typed numbers on the stack always hold a value of their type, so operators on them can work
+// on the payloads in place, without decoding generic arguments or calling operator functions.
+bool GDScriptByteCodeGenerator::_write_local_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
+	if (!_is_optimizing(OPTIMIZE_SUPERINSTRUCTIONS)) {
+		return false;
+	}
+	if (!_is_local_operand(p_left_operand) || !_is_local_operand(p_right_operand) || p_left_operand.type.builtin_type != p_right_operand.type.builtin_type) {
+		return false;
+	}
+	if (p_target.mode != Address::LOCAL_VARIABLE && p_target.mode != Address::FUNCTION_PARAMETER && p_target.mode != Address::TEMPORARY) {
+		return false;
+	}
+
+	bool comparison = p_operator <= Variant::OP_GREATER_EQUAL;
+	GDScriptFunction::Opcode opcode;
+	switch (p_left_operand.type.builtin_type) {
+		case Variant::INT:
+			// Division and modulo have to report a division by zero.
+			if (!comparison && p_operator != Variant::OP_ADD && p_operator != Variant::OP_SUBTRACT && p_operator != Variant::OP_MULTIPLY && p_operator != Variant::OP_BIT_AND && p_operator != Variant::OP_BIT_OR && p_operator != Variant::OP_BIT_XOR) {
+				return false;
+			}
+			opcode = GDScriptFunction::OPCODE_OPERATOR_INT_LOCAL;
+			break;
+		case Variant::FLOAT:
+			if (!comparison && p_operator != Variant::OP_ADD && p_operator != Variant::OP_SUBTRACT && p_operator != Variant::OP_MULTIPLY && p_operator != Variant::OP_DIVIDE) {
+				return false;
+			}
+			opcode = GDScriptFunction::OPCODE_OPERATOR_FLOAT_LOCAL;
+			break;
+		default:
+			return false;
+	}
+
+	append(opcode, 0);
+	append(p_left_operand);
+	append(p_right_operand);
+	append(p_target);
+	append(p_operator);
+	_record_store(p_target, opcodes.size() - 2, comparison ? Variant::BOOL : p_left_operand.type.builtin_type, true, true, p_left_operand, p_right_operand);
+	return true;
 }
 
 void GDScriptByteCodeGenerator::write_type_test(const Address &p_target, const Address &p_source, const Address &p_type) {
@@ -588,17 +867,15 @@ void GDScriptByteCodeGenerator::write_type_test_builtin(const Address &p_target,
 }
 
 void GDScriptByteCodeGenerator::write_and_left_operand(const Address &p_left_operand) {
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_left_operand);
+	_write_jump_if_not(p_left_operand);
 	logic_op_jump_pos1.push_back(opcodes.size());
-	append(0); // Jump target, will be patched.
+	append_jump_target(0); // Jump target, will be patched.
 }
 
 void GDScriptByteCodeGenerator::write_and_right_operand(const Address &p_right_operand) {
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_right_operand);
+	_write_jump_if_not(p_right_operand);
 	logic_op_jump_pos2.push_back(opcodes.size());
-	append(0); // Jump target, will be patched.
+	append_jump_target(0); // Jump target, will be patched.
 }
 
 void GDScriptByteCodeGenerator::write_end_and(const Address &p_target) {
@@ -607,7 +884,8 @@ void GDScriptByteCodeGenerator::write_end_and(const Address &p_target) {
 	append(p_target);
 	// Jump away from the fail condition.
 	append(GDScriptFunction::OPCODE_JUMP, 0);
-	append(opcodes.size() + 3);
+	add_label(opcodes.size() + 3);
+	append_jump_target(opcodes.size() + 3);
 	// Here it means one of operands is false.
 	patch_jump(logic_op_jump_pos1.back()->get());
 	patch_jump(logic_op_jump_pos2.back()->get());
@@ -621,14 +899,14 @@ void GDScriptByteCodeGenerator::write_or_left_operand(const Address &p_left_oper
 	append(GDScriptFunction::OPCODE_JUMP_IF, 1);
 	append(p_left_operand);
 	logic_op_jump_pos1.push_back(opcodes.size());
-	append(0); // Jump target, will be patched.
+	append_jump_target(0); // Jump target, will be patched.
 }
 
 void GDScriptByteCodeGenerator::write_or_right_operand(const Address &p_right_operand) {
 	append(GDScriptFunction::OPCODE_JUMP_IF, 1);
 	append(p_right_operand);
 	logic_op_jump_pos2.push_back(opcodes.size());
-	append(0); // Jump target, will be patched.
+	append_jump_target(0); // Jump target, will be patched.
 }
 
 void GDScriptByteCodeGenerator::write_end_or(const Address &p_target) {
@@ -637,7 +915,8 @@ void GDScriptByteCodeGenerator::write_end_or(const Address &p_target) {
 	append(p_target);
 	// Jump away from the success condition.
 	append(GDScriptFunction::OPCODE_JUMP, 0);
-	append(opcodes.size() + 3);
+	add_label(opcodes.size() + 3);
+	append_jump_target(opcodes.size() + 3);
 	// Here it means one of operands is true.
 	patch_jump(logic_op_jump_pos1.back()->get());
 	patch_jump(logic_op_jump_pos2.back()->get());
@@ -652,10 +931,9 @@ void GDScriptByteCodeGenerator::write_start_ternary(const Address &p_target) {
 }
 
 void GDScriptByteCodeGenerator::write_ternary_condition(const Address &p_condition) {
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_condition);
+	_write_jump_if_not(p_condition);
 	ternary_jump_fail_pos.push_back(opcodes.size());
-	append(0); // Jump target, will be patched.
+	append_jump_target(0); // Jump target, will be patched.
 }
 
 void GDScriptByteCodeGenerator::write_ternary_true_expr(const Address &p_expr) {
@@ -665,7 +943,7 @@ void GDScriptByteCodeGenerator::write_ternary_true_expr(const Address &p_expr) {
 	// Jump away from the false path.
 	append(GDScriptFunction::OPCODE_JUMP, 0);
 	ternary_jump_skip_pos.push_back(opcodes.size());
-	append(0);
+	append_jump_target(0);
 	// Fail must jump here.
 	patch_jump(ternary_jump_fail_pos.back()->get());
 	ternary_jump_fail_pos.pop_back();
@@ -683,6 +961,16 @@ void GDScriptByteCodeGenerator::write_end_ternary() {
 }
 
 void GDScriptByteCodeGenerator::write_set(const Address &p_target, const Address &p_index, const Address &p_source) {
+	Variant::Type element_type = _get_direct_array_element_type(p_target.type);
+	if (element_type != Variant::NIL && IS_BUILTIN_TYPE(p_index, Variant::INT)) {
+		append(GDScriptFunction::OPCODE_SET_INDEXED_TYPED_ARRAY, 3);
+		append(p_target);
+		append(p_index);
+		append(p_source);
+		append(element_type);
+		return;
+	}
+
 	if (HAS_BUILTIN_TYPE(p_target)) {
 		if (IS_BUILTIN_TYPE(p_index, Variant::INT) && Variant::get_member_validated_indexed_setter(p_target.type.builtin_type)) {
 			// Use indexed setter instead.
@@ -711,6 +999,16 @@ void GDScriptByteCodeGenerator::write_set(const Address &p_target, const Address
 }
 
 void GDScriptByteCodeGenerator::write_get(const Address &p_target, const Address &p_index, const Address &p_source) {
+	Variant::Type element_type = _get_direct_array_element_type(p_source.type);
+	if (element_type != Variant::NIL && IS_BUILTIN_TYPE(p_index, Variant::INT)) {
+		append(GDScriptFunction::OPCODE_GET_INDEXED_TYPED_ARRAY, 3);
+		append(p_source);
+		append(p_index);
+		append(p_target);
+		append(element_type);
+		return;
+	}
+
 	if (HAS_BUILTIN_TYPE(p_source)) {
 		if (IS_BUILTIN_TYPE(p_index, Variant::INT) && Variant::get_member_validated_indexed_getter(p_source.type.builtin_type)) {
 			// Use indexed getter instead.
@@ -750,6 +1048,7 @@ void GDScriptByteCodeGenerator::write_set_named(const Address &p_target, const S
 	append(p_target);
 	append(p_source);
 	append(p_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -765,6 +1064,7 @@ void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const S
 	append(p_source);
 	append(p_target);
 	append(p_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
@@ -780,6 +1080,13 @@ void GDScriptByteCodeGenerator::write_get_member(const Address &p_target, const
 }
 
 void GDScriptByteCodeGenerator::write_assign(const Address &p_target, const Address &p_source) {
+	// Copying the result of the previous instruction may be folded into it when the temporary is popped.
+	Store source_store;
+	if (p_source.mode == Address::TEMPORARY && last_store.start >= 0 && last_store.start == last_instruction_start && _is_same_address(last_store.target, p_source)) {
+		source_store = last_store;
+	}
+	int start = opcodes.size();
+
 	if (p_target.type.has_type && !p_source.type.has_type) {
 		// Typed assignment.
 		switch (p_target.type.kind) {
@@ -839,23 +1146,34 @@ void GDScriptByteCodeGenerator::write_assign(const Address &p_target, const Addr
 			append(GDScriptFunction::OPCODE_ASSIGN, 2);
 			append(p_target);
 			append(p_source);
+			_record_store(p_target, opcodes.size() - 2, HAS_BUILTIN_TYPE(p_source) ? p_source.type.builtin_type : Variant::VARIANT_MAX, true, true, p_source);
 		}
 	}
+
+	if (source_store.start >= 0) {
+		pending_copy.start = start;
+		pending_copy.temporary = p_source.address;
+		pending_copy.target = p_target;
+		pending_copy.source = source_store;
+	}
 }
 
 void GDScriptByteCodeGenerator::write_assign_true(const Address &p_target) {
 	append(GDScriptFunction::OPCODE_ASSIGN_TRUE, 1);
 	append(p_target);
+	_record_store(p_target, opcodes.size() - 1, Variant::BOOL, true, true);
 }
 
 void GDScriptByteCodeGenerator::write_assign_false(const Address &p_target) {
 	append(GDScriptFunction::OPCODE_ASSIGN_FALSE, 1);
 	append(p_target);
+	_record_store(p_target, opcodes.size() - 1, Variant::BOOL, true, true);
 }
 
 void GDScriptByteCodeGenerator::write_assign_default_parameter(const Address &p_dst, const Address &p_src) {
 	write_assign(p_dst, p_src);
 	function->default_arguments.push_back(opcodes.size());
+	add_label(opcodes.size());
 }
 
 void GDScriptByteCodeGenerator::write_store_named_global(const Address &p_dst, const StringName &p_global) {
@@ -904,6 +1222,7 @@ void GDScriptByteCodeGenerator::write_call(const Address &p_target, const Addres
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_super_call(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) {
@@ -925,6 +1244,7 @@ void GDScriptByteCodeGenerator::write_call_async(const Address &p_target, const
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_call_gdscript_utility(const Address &p_target, GDScriptUtilityFunctions::FunctionPtr p_function, const Vector<Address> &p_arguments) {
@@ -1154,6 +1474,7 @@ void GDScriptByteCodeGenerator::write_call_self(const Address &p_target, const S
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) {
@@ -1165,17 +1486,18 @@ void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, c
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 }
 
-void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) {
-	append(p_target.mode == Address::NIL ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN, 2 + p_arguments.size());
+void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_target, const Address &p_base, GDScript *p_script, const StringName &p_function_name, const Vector<Address> &p_arguments) {
+	append(p_target.mode == Address::NIL ? GDScriptFunction::OPCODE_CALL_SCRIPT_FUNCTION : GDScriptFunction::OPCODE_CALL_SCRIPT_FUNCTION_RETURN, 2 + p_arguments.size());
 	for (int i = 0; i < p_arguments.size(); i++) {
 		append(p_arguments[i]);
 	}
 	append(p_base);
 	append(p_target);
 	append(p_arguments.size());
-	append(p_function_name);
+	append(get_direct_call_pos(p_script, p_function_name));
 }
 
 void GDScriptByteCodeGenerator::write_lambda(const Address &p_target, GDScriptFunction *p_function, const Vector<Address> &p_captures) {
@@ -1284,16 +1606,15 @@ void GDScriptByteCodeGenerator::write_await(const Address &p_target, const Addre
 }
 
 void GDScriptByteCodeGenerator::write_if(const Address &p_condition) {
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_condition);
+	_write_jump_if_not(p_condition);
 	if_jmp_addrs.push_back(opcodes.size());
-	append(0); // Jump destination, will be patched.
+	append_jump_target(0); // Jump destination, will be patched.
 }
 
 void GDScriptByteCodeGenerator::write_else() {
 	append(GDScriptFunction::OPCODE_JUMP, 0); // Jump from true if block;
 	int else_jmp_addr = opcodes.size();
-	append(0); // Jump destination, will be patched.
+	append_jump_target(0); // Jump destination, will be patched.
 
 	patch_jump(if_jmp_addrs.back()->get());
 	if_jmp_addrs.pop_back();
@@ -1371,8 +1692,13 @@ void GDScriptByteCodeGenerator::write_for() {
 					iterate_opcode = GDScriptFunction::OPCODE_ITERATE_DICTIONARY;
 					break;
 				case Variant::ARRAY:
-					begin_opcode = GDScriptFunction::OPCODE_ITERATE_BEGIN_ARRAY;
-					iterate_opcode = GDScriptFunction::OPCODE_ITERATE_ARRAY;
+					if (_get_direct_array_element_type(container.type) != Variant::NIL) {
+						begin_opcode = GDScriptFunction::OPCODE_ITERATE_BEGIN_TYPED_ARRAY;
+						iterate_opcode = GDScriptFunction::OPCODE_ITERATE_TYPED_ARRAY;
+					} else {
+						begin_opcode = GDScriptFunction::OPCODE_ITERATE_BEGIN_ARRAY;
+						iterate_opcode = GDScriptFunction::OPCODE_ITERATE_ARRAY;
+					}
 					break;
 				case Variant::PACKED_BYTE_ARRAY:
 					begin_opcode = GDScriptFunction::OPCODE_ITERATE_BEGIN_PACKED_BYTE_ARRAY;
@@ -1427,11 +1753,13 @@ void GDScriptByteCodeGenerator::write_for() {
 	for_jmp_addrs.push_back(opcodes.size());
 	append(0); // End of loop address, will be patched.
 	append(GDScriptFunction::OPCODE_JUMP, 0);
-	append(opcodes.size() + 6); // Skip over 'continue' code.
+	add_label(opcodes.size() + 6);
+	append_jump_target(opcodes.size() + 6); // Skip over 'continue' code.
 
 	// Next iteration.
 	int continue_addr = opcodes.size();
 	continue_addrs.push_back(continue_addr);
+	add_label(continue_addr);
 	append(iterate_opcode, 3);
 	append(counter);
 	append(container);
@@ -1443,7 +1771,7 @@ void GDScriptByteCodeGenerator::write_for() {
 void GDScriptByteCodeGenerator::write_endfor() {
 	// Jump back to loop check.
 	append(GDScriptFunction::OPCODE_JUMP, 0);
-	append(continue_addrs.back()->get());
+	append_jump_target(continue_addrs.back()->get());
 	continue_addrs.pop_back();
 
 	// Patch end jumps (two of them).
@@ -1467,20 +1795,20 @@ void GDScriptByteCodeGenerator::write_endfor() {
 void GDScriptByteCodeGenerator::start_while_condition() {
 	current_breaks_to_patch.push_back(List<int>());
 	continue_addrs.push_back(opcodes.size());
+	add_label(opcodes.size());
 }
 
 void GDScriptByteCodeGenerator::write_while(const Address &p_condition) {
 	// Condition check.
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_condition);
+	_write_jump_if_not(p_condition);
 	while_jmp_addrs.push_back(opcodes.size());
-	append(0); // End of loop address, will be patched.
+	append_jump_target(0); // End of loop address, will be patched.
 }
 
 void GDScriptByteCodeGenerator::write_endwhile() {
 	// Jump back to loop check.
 	append(GDScriptFunction::OPCODE_JUMP, 0);
-	append(continue_addrs.back()->get());
+	append_jump_target(continue_addrs.back()->get());
 	continue_addrs.pop_back();
 
 	// Patch end jump.
@@ -1519,18 +1847,18 @@ void GDScriptByteCodeGenerator::end_match() {
 void GDScriptByteCodeGenerator::write_break() {
 	append(GDScriptFunction::OPCODE_JUMP, 0);
 	current_breaks_to_patch.back()->get().push_back(opcodes.size());
-	append(0);
+	append_jump_target(0);
 }
 
 void GDScriptByteCodeGenerator::write_continue() {
 	append(GDScriptFunction::OPCODE_JUMP, 0);
-	append(continue_addrs.back()->get());
+	append_jump_target(continue_addrs.back()->get());
 }
 
 void GDScriptByteCodeGenerator::write_continue_match() {
 	append(GDScriptFunction::OPCODE_JUMP, 0);
 	match_continues_to_patch.back()->get().push_back(opcodes.size());
-	append(0);
+	append_jump_target(0);
 }
 
 void GDScriptByteCodeGenerator::write_breakpoint() {
@@ -37,6 +37,19 @@
 #include "gdscript_utility_functions.h"
 
 class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
+public:
+	enum Optimization {
+		OPTIMIZE_CONSTANT_FOLDING = 1 << 0,
+		OPTIMIZE_COPY_PROPAGATION = 1 << 1,
+		OPTIMIZE_DEAD_STORE_ELIMINATION = 1 << 2,
+		OPTIMIZE_JUMP_THREADING = 1 << 3,
+		OPTIMIZE_SUPERINSTRUCTIONS = 1 << 4,
+		OPTIMIZE_ALL = (1 << 5) - 1,
+	};
+
+private:
+	static uint32_t optimizations;
+
 	struct StackSlot {
 		Variant::Type type = Variant::NIL;
 		Vector<int> bytecode_indices;
@@ -71,6 +84,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	int current_line = 0;
 	int instr_args_max = 0;
 	int ptrcall_max = 0;
+	int inline_cache_count = 0;
 
 #ifdef DEBUG_ENABLED
 	List<int> temp_stack;
@@ -94,6 +108,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	Map<GDScriptUtilityFunctions::FunctionPtr, int> gds_utilities_map;
 	Map<MethodBind *, int> method_bind_map;
 	Map<GDScriptFunction *, int> lambdas_map;
+	Vector<GDScriptFunction::DirectCall> direct_calls;
 
 	// Lists since these can be nested.
 	List<int> if_jmp_addrs;
@@ -115,6 +130,58 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	List<List<int>> current_breaks_to_patch;
 	List<List<int>> match_continues_to_patch;
 
+	// Peephole optimizer state. The code is only ever appended to, so the
+	// optimizations look at the last written instructions and rewrite or drop
+	// them before anything else can refer to their positions.
+	struct Store {
+		int start = -1; // Position of the instruction, -1 if unknown.
+		int target_pos = -1; // Position of the operand written by the instruction.
+		Address target;
+		Address left_operand;
+		Address right_operand;
+		Variant::Type result_type = Variant::VARIANT_MAX; // VARIANT_MAX if unknown.
+		bool validated = false;
+		bool pure = false; // No side effects other than writing the target.
+	};
+
+	struct PendingCopy {
+		int start = -1; // Position of the assignment, -1 if none.
+		int temporary = -1;
+		Address target;
+		Store source;
+	};
+
+	int last_instruction_start = -1;
+	int last_label = -1; // Highest position used as jump destination so far.
+	Store last_store;
+	PendingCopy pending_copy;
+	Vector<int> jump_operands;
+
+	bool _is_optimizing(Optimization p_optimization) const {
+		return optimizations & p_optimization;
+	}
+
+	static bool _is_local_operand(const Address &p_address) {
+		if (!p_address.type.has_type || p_address.type.kind != GDScriptDataType::BUILTIN) {
+			return false;
+		}
+		return p_address.mode == Address::LOCAL_VARIABLE || p_address.mode == Address::FUNCTION_PARAMETER || p_address.mode == Address::TEMPORARY || p_address.mode == Address::CONSTANT;
+	}
+
+	static bool _is_local_operator(int p_code) {
+		int opcode = p_code & GDScriptFunction::INSTR_MASK;
+		return opcode == GDScriptFunction::OPCODE_OPERATOR_INT_LOCAL || opcode == GDScriptFunction::OPCODE_OPERATOR_FLOAT_LOCAL;
+	}
+
+	void _truncate_code(int p_position);
+	void _record_store(const Address &p_target, int p_target_pos, Variant::Type p_result_type, bool p_validated, bool p_pure, const Address &p_left_operand = Address(), const Address &p_right_operand = Address());
+	bool _fold_constant(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand);
+	bool _write_local_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand);
+	bool _propagate_copy(int p_temporary);
+	bool _eliminate_dead_store(int p_temporary);
+	void _write_jump_if_not(const Address &p_condition);
+	void _thread_jumps();
+
 	void add_stack_identifier(const StringName &p_id, int p_stackpos) {
 		if (locals.size() > max_locals) {
 			max_locals = locals.size();
@@ -303,6 +370,19 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 		return pos;
 	}
 
+	int get_direct_call_pos(GDScript *p_script, const StringName &p_function_name) {
+		for (int i = 0; i < direct_calls.size(); i++) {
+			if (direct_calls[i].script == p_script && direct_calls[i].name == p_function_name) {
+				return i;
+			}
+		}
+		GDScriptFunction::DirectCall call;
+		call.script = p_script;
+		call.name = p_function_name;
+		direct_calls.push_back(call);
+		return direct_calls.size() - 1;
+	}
+
 	void alloc_ptrcall(int p_params) {
 		if (p_params >= ptrcall_max) {
 			ptrcall_max = p_params;
@@ -332,6 +412,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	}
 
 	void append(GDScriptFunction::Opcode p_code, int p_argument_count) {
+		last_instruction_start = opcodes.size();
 		opcodes.push_back((p_code & GDScriptFunction::INSTR_MASK) | (p_argument_count << GDScriptFunction::INSTR_BITS));
 		instr_args_max = MAX(instr_args_max, p_argument_count);
 	}
@@ -400,11 +481,29 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 		opcodes.push_back(get_lambda_function_pos(p_lambda_function));
 	}
 
+	// Every untyped named access or call gets its own cache, since it's the site that sees the same receivers.
+	void append_inline_cache() {
+		opcodes.push_back(inline_cache_count++);
+	}
+
+	void append_jump_target(int p_address) {
+		jump_operands.push_back(opcodes.size());
+		opcodes.push_back(p_address);
+	}
+
+	void add_label(int p_address) {
+		last_label = MAX(last_label, p_address);
+	}
+
 	void patch_jump(int p_address) {
 		opcodes.write[p_address] = opcodes.size();
+		add_label(opcodes.size());
 	}
 
 public:
+	static void set_optimizations(uint32_t p_optimizations) { optimizations = p_optimizations; }
+	static uint32_t get_optimizations() { return optimizations; }
+
 	virtual uint32_t add_parameter(const StringName &p_name, bool p_is_optional, const GDScriptDataType &p_type) override;
 	virtual uint32_t add_local(const StringName &p_name, const GDScriptDataType &p_type) override;
 	virtual uint32_t add_local_constant(const StringName &p_name, const Variant &p_constant) override;
@@ -466,7 +565,7 @@ public:
 	virtual void write_call_ptrcall(const Address &p_target, const Address &p_base, MethodBind *p_method, const Vector<Address> &p_arguments) override;
 	virtual void write_call_self(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) override;
 	virtual void write_call_self_async(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) override;
-	virtual void write_call_script_function(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) override;
+	virtual void write_call_script_function(const Address &p_target, const Address &p_base, GDScript *p_script, const StringName &p_function_name, const Vector<Address> &p_arguments) override;
 	virtual void write_lambda(const Address &p_target, GDScriptFunction *p_function, const Vector<Address> &p_captures) override;
 	virtual void write_construct(const Address &p_target, Variant::Type p_type, const Vector<Address> &p_arguments) override;
 	virtual void write_construct_array(const Address &p_target, const Vector<Address> &p_arguments) override;
@@ -30,7 +30,10 @@
 
 #include "gdscript_cache.h"
 
+#include "core/io/resource_loader.h"
 #include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/templates/vector.h"
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
@@ -101,6 +104,13 @@ Error GDScriptParserRef::raise_status(Status p_new_status) {
 	return result;
 }
 
+Error GDScriptParserRef::_parse(const String &p_source) {
+	ERR_FAIL_COND_V(status != EMPTY, ERR_ALREADY_IN_USE);
+
+	status = PARSED;
+	return parser->parse(p_source, path, false);
+}
+
 GDScriptParserRef::~GDScriptParserRef() {
 	if (parser != nullptr) {
 		memdelete(parser);
@@ -109,11 +119,21 @@ GDScriptParserRef::~GDScriptParserRef() {
 		memdelete(analyzer);
 	}
 	MutexLock lock(GDScriptCache::singleton->lock);
-	GDScriptCache::singleton->parser_map.erase(path);
+	// Parsers kept for GDScript::reload() are not shared through the map.
+	GDScriptParserRef **mapped = GDScriptCache::singleton->parser_map.getptr(path);
+	if (mapped && *mapped == this) {
+		GDScriptCache::singleton->parser_map.erase(path);
+	}
 }
 
 GDScriptCache *GDScriptCache::singleton = nullptr;
 
+// Exported projects replace scripts with their byte code through a path remap.
+static String _get_byte_code_path(const String &p_path) {
+	String path = p_path.get_extension() == "gdc" ? p_path : ResourceLoader::path_remap(p_path);
+	return path.get_extension() == "gdc" ? path : String();
+}
+
 void GDScriptCache::remove_script(const String &p_path) {
 	MutexLock lock(singleton->lock);
 	singleton->shallow_gdscript_cache.erase(p_path);
@@ -183,13 +203,17 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, const Stri
 	script.instance();
 	script->set_path(p_path, true);
 	script->set_script_path(p_path);
-	script->load_source_code(p_path);
+	if (_get_byte_code_path(p_path).is_empty()) {
+		script->load_source_code(p_path);
+	}
 
 	singleton->shallow_gdscript_cache[p_path] = script.ptr();
 	return script;
 }
 
 Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_error, const String &p_owner) {
+	_preparse_for_compile(p_path);
+
 	MutexLock lock(singleton->lock);
 
 	if (p_owner != String()) {
@@ -202,6 +226,26 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 	}
 	Ref<GDScript> script = get_shallow_script(p_path);
 
+	String byte_code_path = _get_byte_code_path(p_path);
+	if (!byte_code_path.is_empty()) {
+		// Mark it as loaded beforehand, like finish_compiling() does, so cyclic references don't load it twice.
+		singleton->full_gdscript_cache[p_path] = script.ptr();
+		singleton->shallow_gdscript_cache.erase(p_path);
+
+		r_error = script->load_byte_code(byte_code_path);
+		if (r_error == OK) {
+			return script;
+		}
+
+		singleton->full_gdscript_cache.erase(p_path);
+		singleton->shallow_gdscript_cache[p_path] = script.ptr();
+
+		// Outdated or incompatible byte code, compile the source instead if there is one.
+		if (byte_code_path == p_path || !FileAccess::exists(p_path)) {
+			return script;
+		}
+	}
+
 	r_error = script->load_source_code(p_path);
 
 	if (r_error) {
@@ -243,11 +287,179 @@ Error GDScriptCache::finish_compiling(const String &p_owner) {
 	return err;
 }
 
+Ref<GDScriptParserRef> GDScriptCache::_create_parser_ref(const String &p_path) {
+	Ref<GDScriptParserRef> ref;
+	ref.instance();
+	ref->parser = memnew(GDScriptParser);
+	ref->path = p_path;
+	return ref;
+}
+
+void GDScriptCache::_find_scripts(const String &p_path, Set<String> &r_visited, Vector<String> &r_scripts) {
+	if (r_visited.has(p_path)) {
+		return;
+	}
+	r_visited.insert(p_path);
+
+	String extension = p_path.get_extension().to_lower();
+	if (extension == "gd") {
+		if (_get_byte_code_path(p_path).is_empty() && FileAccess::exists(p_path)) {
+			r_scripts.push_back(p_path);
+		}
+		return;
+	}
+	if (extension == "gdc") {
+		return; // Byte code loads what it depends on by itself.
+	}
+
+	List<String> resource_dependencies;
+	ResourceLoader::get_dependencies(p_path, &resource_dependencies);
+	for (const List<String>::Element *E = resource_dependencies.front(); E; E = E->next()) {
+		_find_scripts(E->get().get_slice("::", 0), r_visited, r_scripts);
+	}
+}
+
+void GDScriptCache::_preparse_script(uint32_t p_index, PreparseItem *p_items) {
+	PreparseItem &item = p_items[p_index];
+
+	item.source = get_source_code(item.path);
+	if (item.source.is_empty()) {
+		item.error = ERR_FILE_CANT_READ;
+		return;
+	}
+
+	item.error = item.parser->_parse(item.source);
+	if (item.error == OK) {
+		item.dependencies = item.parser->get_parser()->get_dependencies();
+	}
+}
+
+void GDScriptCache::_preparse_for_compile(const String &p_path) {
+	{
+		MutexLock lock(singleton->lock);
+		if (singleton->full_gdscript_cache.has(p_path) || singleton->preparsed_scripts.has(p_path)) {
+			return;
+		}
+	}
+
+	if (!_get_byte_code_path(p_path).is_empty() || !FileAccess::exists(p_path)) {
+		return;
+	}
+
+	// Only linking the script needs the lock, parsing it first lets threads loading different scripts work at the same time.
+	PreparsedScript preparsed;
+	preparsed.source = get_source_code(p_path);
+	if (preparsed.source.is_empty()) {
+		return;
+	}
+	preparsed.parser = _create_parser_ref(p_path);
+	if (preparsed.parser->_parse(preparsed.source) != OK) {
+		return; // Let GDScript::reload() report the errors.
+	}
+
+	MutexLock lock(singleton->lock);
+	if (!singleton->preparsed_scripts.has(p_path)) {
+		singleton->preparsed_scripts[p_path] = preparsed;
+	}
+}
+
+void GDScriptCache::preparse_scripts(const Vector<String> &p_paths, ThreadWorkPool &p_thread_pool) {
+	uint64_t start = OS::get_singleton()->get_ticks_usec();
+
+	Set<String> visited;
+	Vector<String> pending;
+	for (int i = 0; i < p_paths.size(); i++) {
+		_find_scripts(p_paths[i], visited, pending);
+	}
+
+	// Dependencies are only known once a script is parsed, so every pass parses the scripts found by the previous one.
+	int parsed_count = 0;
+	while (!pending.is_empty()) {
+		Vector<PreparseItem> items;
+		items.resize(pending.size());
+		for (int i = 0; i < pending.size(); i++) {
+			PreparseItem &item = items.write[i];
+			item.path = pending[i];
+			item.parser = _create_parser_ref(item.path);
+		}
+		pending.clear();
+
+		p_thread_pool.do_work(items.size(), singleton, &GDScriptCache::_preparse_script, items.ptrw());
+
+		{
+			MutexLock lock(singleton->lock);
+			PreparseItem *items_ptr = items.ptrw();
+			for (int i = 0; i < items.size(); i++) {
+				PreparseItem &item = items_ptr[i];
+				if (item.error != OK || singleton->full_gdscript_cache.has(item.path) || singleton->preparsed_scripts.has(item.path)) {
+					continue;
+				}
+
+				PreparsedScript preparsed;
+				preparsed.source = item.source;
+				preparsed.parser = item.parser;
+				if (!singleton->parser_map.has(item.path)) {
+					singleton->parser_map[item.path] = item.parser.ptr();
+				}
+				singleton->preparsed_scripts[item.path] = preparsed;
+				parsed_count++;
+			}
+		}
+
+		for (int i = 0; i < items.size(); i++) {
+			for (const List<String>::Element *E = items[i].dependencies.front(); E; E = E->next()) {
+				_find_scripts(E->get(), visited, pending);
+			}
+		}
+	}
+
+	print_verbose(vformat("GDScript: Parsed %d scripts ahead of loading them in %d msec, using %d threads.", parsed_count, (OS::get_singleton()->get_ticks_usec() - start) / 1000, p_thread_pool.get_thread_count()));
+}
+
+Ref<GDScriptParserRef> GDScriptCache::take_preparsed_parser(const String &p_path, const String &p_source) {
+	MutexLock lock(singleton->lock);
+
+	PreparsedScript *preparsed = singleton->preparsed_scripts.getptr(p_path);
+	if (!preparsed || preparsed->taken) {
+		return Ref<GDScriptParserRef>();
+	}
+
+	Ref<GDScriptParserRef> parser = preparsed->parser;
+	// Analyzing the scripts depending on it drops the parser if it has errors, parse it again to report them.
+	if (preparsed->source != p_source || !parser->is_valid()) {
+		parser.unref();
+	}
+
+	// Keep the ones in parser_map until clear_preparsed_scripts(), so later dependents don't parse them again.
+	GDScriptParserRef **mapped = singleton->parser_map.getptr(p_path);
+	if (mapped && *mapped == preparsed->parser.ptr()) {
+		preparsed->taken = true;
+	} else {
+		singleton->preparsed_scripts.erase(p_path);
+	}
+
+	return parser;
+}
+
+void GDScriptCache::clear_preparsed_scripts() {
+	HashMap<String, PreparsedScript> preparsed;
+	{
+		MutexLock lock(singleton->lock);
+		if (singleton->preparsed_scripts.is_empty()) {
+			return;
+		}
+		SWAP(preparsed, singleton->preparsed_scripts);
+	}
+	// Freeing the parsers takes the lock again to remove them from the map.
+	preparsed.clear();
+}
+
 GDScriptCache::GDScriptCache() {
 	singleton = this;
 }
 
 GDScriptCache::~GDScriptCache() {
+	preparsed_scripts.clear();
 	parser_map.clear();
 	shallow_gdscript_cache.clear();
 	full_gdscript_cache.clear();
@@ -39,6 +39,7 @@
 
 class GDScriptAnalyzer;
 class GDScriptParser;
+class ThreadWorkPool;
 
 class GDScriptParserRef : public Reference {
 public:
@@ -58,6 +59,8 @@ private:
 
 	friend class GDScriptCache;
 
+	Error _parse(const String &p_source);
+
 public:
 	bool is_valid() const;
 	Status get_status() const;
@@ -75,6 +78,22 @@ class GDScriptCache {
 	HashMap<String, GDScript *> full_gdscript_cache;
 	HashMap<String, Set<String>> dependencies;
 
+	// Scripts parsed ahead of compiling them, see preparse_scripts().
+	struct PreparsedScript {
+		String source;
+		Ref<GDScriptParserRef> parser; // Compiled by GDScript::reload(), and analyzed by the scripts depending on it when it's in parser_map.
+		bool taken = false;
+	};
+	HashMap<String, PreparsedScript> preparsed_scripts;
+
+	struct PreparseItem {
+		String path;
+		String source;
+		Ref<GDScriptParserRef> parser;
+		List<String> dependencies;
+		Error error = OK;
+	};
+
 	friend class GDScript;
 	friend class GDScriptParserRef;
 
@@ -83,6 +102,11 @@ class GDScriptCache {
 	Mutex lock;
 	static void remove_script(const String &p_path);
 
+	static Ref<GDScriptParserRef> _create_parser_ref(const String &p_path);
+	static void _find_scripts(const String &p_path, Set<String> &r_visited, Vector<String> &r_scripts);
+	void _preparse_script(uint32_t p_index, PreparseItem *p_items);
+	static void _preparse_for_compile(const String &p_path);
+
 public:
 	static Ref<GDScriptParserRef> get_parser(const String &p_path, GDScriptParserRef::Status status, Error &r_error, const String &p_owner = String());
 	static String get_source_code(const String &p_path);
@@ -90,6 +114,10 @@ public:
 	static Ref<GDScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String());
 	static Error finish_compiling(const String &p_owner);
 
+	static void preparse_scripts(const Vector<String> &p_paths, ThreadWorkPool &p_thread_pool);
+	static Ref<GDScriptParserRef> take_preparsed_parser(const String &p_path, const String &p_source);
+	static void clear_preparsed_scripts();
+
 	GDScriptCache();
 	~GDScriptCache();
 };
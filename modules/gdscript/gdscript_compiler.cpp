@@ -530,7 +530,10 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 							if (within_await) {
 								gen->write_call_self_async(result, call->function_name, arguments);
 							} else {
-								gen->write_call_self(result, call->function_name, arguments);
+								// Script function, call it directly while self is exactly of this class.
+								GDScriptCodeGenerator::Address self;
+								self.mode = GDScriptCodeGenerator::Address::SELF;
+								gen->write_call_script_function(result, self, codegen.script, call->function_name, arguments);
 							}
 						}
 					} else if (callee->type == GDScriptParser::Node::SUBSCRIPT) {
@@ -564,11 +567,16 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 											// Not exact arguments, but still can use method bind call.
 											gen->write_call_method_bind(result, base, method, arguments);
 										}
+									} else if (base.type.kind == GDScriptDataType::GDSCRIPT && base.type.script_type) {
+										// Script function, call it directly while the base is exactly of its static type.
+										gen->write_call_script_function(result, base, static_cast<GDScript *>(base.type.script_type), call->function_name, arguments);
 									} else {
 										gen->write_call(result, base, call->function_name, arguments);
 									}
 								} else if (base.type.has_type && base.type.kind == GDScriptDataType::BUILTIN) {
 									gen->write_call_builtin_type(result, base, base.type.builtin_type, call->function_name, arguments);
+								} else if (base.mode == GDScriptCodeGenerator::Address::SELF && !ClassDB::has_method(codegen.script->native->get_name(), call->function_name)) {
+									gen->write_call_script_function(result, base, codegen.script, call->function_name, arguments);
 								} else {
 									gen->write_call(result, base, call->function_name, arguments);
 								}
@@ -2168,6 +2176,7 @@ Error GDScriptCompiler::_parse_class_level(GDScript *p_script, const GDScriptPar
 		memdelete(E->get());
 	}
 	p_script->member_functions.clear();
+	GDScriptFunction::invalidate_direct_calls();
 	p_script->member_indices.clear();
 	p_script->member_info.clear();
 	p_script->_signals.clear();
@@ -134,6 +134,49 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			case OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT: {
+				text += "validated operator ";
+
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += " <operator function> ";
+				text += DADDR(2);
+				text += ", jump-if-not to ";
+				text += itos(_code_ptr[ip + 5]);
+
+				incr += 6;
+			} break;
+			case OPCODE_OPERATOR_INT_LOCAL:
+			case OPCODE_OPERATOR_FLOAT_LOCAL: {
+				text += code == OPCODE_OPERATOR_INT_LOCAL ? "local int operator " : "local float operator ";
+
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += " ";
+				text += Variant::get_operator_name(Variant::Operator(_code_ptr[ip + 4]));
+				text += " ";
+				text += DADDR(2);
+
+				incr += 5;
+			} break;
+			case OPCODE_OPERATOR_INT_LOCAL_JUMP_IF_NOT:
+			case OPCODE_OPERATOR_FLOAT_LOCAL_JUMP_IF_NOT: {
+				text += code == OPCODE_OPERATOR_INT_LOCAL_JUMP_IF_NOT ? "local int operator " : "local float operator ";
+
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += " ";
+				text += Variant::get_operator_name(Variant::Operator(_code_ptr[ip + 4]));
+				text += " ";
+				text += DADDR(2);
+				text += ", jump-if-not to ";
+				text += itos(_code_ptr[ip + 5]);
+
+				incr += 6;
+			} break;
 			case OPCODE_EXTENDS_TEST: {
 				text += "is object ";
 				text += DADDR(3);
@@ -217,6 +260,31 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			case OPCODE_SET_INDEXED_TYPED_ARRAY: {
+				text += "set indexed typed array (";
+				text += Variant::get_type_name((Variant::Type)_code_ptr[ip + 4]);
+				text += ") ";
+				text += DADDR(1);
+				text += "[";
+				text += DADDR(2);
+				text += "] = ";
+				text += DADDR(3);
+
+				incr += 5;
+			} break;
+			case OPCODE_GET_INDEXED_TYPED_ARRAY: {
+				text += "get indexed typed array (";
+				text += Variant::get_type_name((Variant::Type)_code_ptr[ip + 4]);
+				text += ") ";
+				text += DADDR(3);
+				text += " = ";
+				text += DADDR(1);
+				text += "[";
+				text += DADDR(2);
+				text += "]";
+
+				incr += 5;
+			} break;
 			case OPCODE_SET_NAMED: {
 				text += "set_named ";
 				text += DADDR(1);
@@ -225,7 +293,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += "\"] = ";
 				text += DADDR(2);
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_SET_NAMED_VALIDATED: {
 				text += "set_named validated ";
@@ -246,7 +314,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"]";
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
@@ -509,7 +577,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				}
 				text += ")";
 
-				incr = 5 + argc;
+				incr = 6 + argc;
 			} break;
 			case OPCODE_CALL_METHOD_BIND:
 			case OPCODE_CALL_METHOD_BIND_RET: {
@@ -720,6 +788,35 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr = 4 + argc;
 			} break;
+			case OPCODE_CALL_SCRIPT_FUNCTION:
+			case OPCODE_CALL_SCRIPT_FUNCTION_RETURN: {
+				bool ret = (_code_ptr[ip] & INSTR_MASK) == OPCODE_CALL_SCRIPT_FUNCTION_RETURN;
+
+				if (ret) {
+					text += "call-script-function-ret ";
+				} else {
+					text += "call-script-function ";
+				}
+
+				int argc = _code_ptr[ip + 1 + instr_var_args];
+				if (ret) {
+					text += DADDR(2 + argc) + " = ";
+				}
+
+				text += DADDR(1 + argc) + ".";
+				text += String(_direct_calls_ptr[_code_ptr[ip + 2 + instr_var_args]].name);
+				text += "(";
+
+				for (int i = 0; i < argc; i++) {
+					if (i > 0) {
+						text += ", ";
+					}
+					text += DADDR(1 + i);
+				}
+				text += ")";
+
+				incr = 5 + argc;
+			} break;
 			case OPCODE_CALL_SELF_BASE: {
 				text += "call-self-base ";
 
@@ -877,6 +974,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 	m_macro(STRING);                       \
 	m_macro(DICTIONARY);                   \
 	m_macro(ARRAY);                        \
+	m_macro(TYPED_ARRAY);                  \
 	m_macro(PACKED_BYTE_ARRAY);            \
 	m_macro(PACKED_INT32_ARRAY);           \
 	m_macro(PACKED_INT64_ARRAY);           \
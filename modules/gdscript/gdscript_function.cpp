@@ -30,8 +30,11 @@
 
 #include "gdscript_function.h"
 
+#include "core/os/os.h"
 #include "gdscript.h"
 
+SafeNumeric<uint32_t> GDScriptFunction::direct_call_generation(1);
+
 const int *GDScriptFunction::get_code() const {
 	return _code_ptr;
 }
@@ -154,6 +157,10 @@ GDScriptFunction::~GDScriptFunction() {
 		memdelete(lambdas[i]);
 	}
 
+#ifdef GDSCRIPT_JIT_ENABLED
+	GDScriptJIT::free_code(jit_code);
+#endif
+
 #ifdef DEBUG_ENABLED
 
 	MutexLock lock(GDScriptLanguage::get_singleton()->lock);
@@ -164,6 +171,88 @@ GDScriptFunction::~GDScriptFunction() {
 
 /////////////////////
 
+SpinLock GDScriptFunctionState::frame_pool_lock;
+LocalVector<uint8_t *> GDScriptFunctionState::frame_pool[FRAME_POOL_BUCKETS];
+
+SafeNumeric<uint64_t> GDScriptFunctionState::live_count;
+SafeNumeric<uint64_t> GDScriptFunctionState::peak_live_count;
+SafeNumeric<uint64_t> GDScriptFunctionState::await_count;
+SafeNumeric<uint64_t> GDScriptFunctionState::resume_count;
+SafeNumeric<uint64_t> GDScriptFunctionState::resume_usec;
+SafeNumeric<uint64_t> GDScriptFunctionState::max_resume_usec;
+SafeNumeric<uint64_t> GDScriptFunctionState::frames_allocated;
+SafeNumeric<uint64_t> GDScriptFunctionState::frames_reused;
+
+uint8_t *GDScriptFunctionState::_alloc_frame(uint32_t p_size) {
+	peak_live_count.exchange_if_greater(live_count.increment());
+
+	uint32_t bucket = nearest_shift(p_size - 1);
+	uint8_t *frame = nullptr;
+
+	frame_pool_lock.lock();
+	if (frame_pool[bucket].size()) {
+		frame = frame_pool[bucket][frame_pool[bucket].size() - 1];
+		frame_pool[bucket].resize(frame_pool[bucket].size() - 1);
+	}
+	frame_pool_lock.unlock();
+
+	if (frame) {
+		frames_reused.increment();
+		return frame;
+	}
+
+	frames_allocated.increment();
+	return (uint8_t *)memalloc(1 << bucket);
+}
+
+void GDScriptFunctionState::_free_frame(uint8_t *p_frame, uint32_t p_size) {
+	live_count.decrement();
+
+	uint32_t bucket = nearest_shift(p_size - 1);
+
+	frame_pool_lock.lock();
+	if (frame_pool[bucket].size() < FRAME_POOL_MAX_FREE) {
+		frame_pool[bucket].push_back(p_frame);
+		p_frame = nullptr;
+	}
+	frame_pool_lock.unlock();
+
+	if (p_frame) {
+		memfree(p_frame);
+	}
+}
+
+void GDScriptFunctionState::clear_frame_pool() {
+	frame_pool_lock.lock();
+	for (int i = 0; i < FRAME_POOL_BUCKETS; i++) {
+		for (uint32_t j = 0; j < frame_pool[i].size(); j++) {
+			memfree(frame_pool[i][j]);
+		}
+		frame_pool[i].reset();
+	}
+	frame_pool_lock.unlock();
+}
+
+GDScriptFunctionState::CoroutineStats GDScriptFunctionState::get_coroutine_stats() {
+	CoroutineStats stats;
+	stats.live = live_count.get();
+	stats.peak_live = peak_live_count.get();
+	stats.awaits = await_count.get();
+	stats.resumes = resume_count.get();
+	stats.resume_usec = resume_usec.get();
+	stats.max_resume_usec = max_resume_usec.get();
+	stats.frames_allocated = frames_allocated.get();
+	stats.frames_reused = frames_reused.get();
+
+	frame_pool_lock.lock();
+	for (int i = 0; i < FRAME_POOL_BUCKETS; i++) {
+		stats.frames_pooled += frame_pool[i].size();
+	}
+	frame_pool_lock.unlock();
+
+	return stats;
+}
+
 Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
 	Variant arg;
 	r_error.error = Callable::CallError::CALL_OK;
@@ -243,7 +332,16 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 
 	state.result = p_arg;
 	Callable::CallError err;
+	uint64_t resume_start = OS::get_singleton()->get_ticks_usec();
 	Variant ret = function->call(nullptr, nullptr, 0, err, &state);
+	uint64_t resume_time = OS::get_singleton()->get_ticks_usec() - resume_start;
+
+	resume_count.increment();
+	resume_usec.add(resume_time);
+	max_resume_usec.exchange_if_greater(resume_time);
+
+	// Awaiting again moved the frame to the new state, otherwise it's done and can be reused right away.
+	_clear_stack();
 
 	bool completed = true;
 
@@ -278,13 +376,23 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 }
 
 void GDScriptFunctionState::_clear_stack() {
-	if (state.stack_size) {
-		Variant *stack = (Variant *)state.stack.ptr();
-		for (int i = 0; i < state.stack_size; i++) {
-			stack[i].~Variant();
-		}
-		state.stack_size = 0;
+	if (!state.stack) {
+		return;
 	}
+
+	// Detach the frame first, freeing the variants may free this state as well.
+	uint8_t *frame = state.stack;
+	int stack_size = state.stack_size;
+	uint32_t alloca_size = state.alloca_size;
+	state.stack = nullptr;
+	state.stack_size = 0;
+
+	Variant *stack = (Variant *)frame;
+	for (int i = 0; i < stack_size; i++) {
+		stack[i].~Variant();
+	}
+
+	_free_frame(frame, alloca_size);
 }
 
 void GDScriptFunctionState::_bind_methods() {
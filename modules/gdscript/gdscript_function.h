@@ -33,11 +33,15 @@
 
 #include "core/object/reference.h"
 #include "core/object/script_language.h"
+#include "core/os/spin_lock.h"
 #include "core/os/thread.h"
 #include "core/string/string_name.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/pair.h"
+#include "core/templates/safe_refcount.h"
 #include "core/templates/self_list.h"
 #include "core/variant/variant.h"
+#include "gdscript_jit.h"
 #include "gdscript_utility_functions.h"
 
 class GDScriptInstance;
@@ -224,6 +228,11 @@ public:
 	enum Opcode {
 		OPCODE_OPERATOR,
 		OPCODE_OPERATOR_VALIDATED,
+		OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT,
+		OPCODE_OPERATOR_INT_LOCAL,
+		OPCODE_OPERATOR_INT_LOCAL_JUMP_IF_NOT,
+		OPCODE_OPERATOR_FLOAT_LOCAL,
+		OPCODE_OPERATOR_FLOAT_LOCAL_JUMP_IF_NOT,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET_KEYED,
@@ -232,6 +241,8 @@ public:
 		OPCODE_GET_KEYED,
 		OPCODE_GET_KEYED_VALIDATED,
 		OPCODE_GET_INDEXED_VALIDATED,
+		OPCODE_SET_INDEXED_TYPED_ARRAY,
+		OPCODE_GET_INDEXED_TYPED_ARRAY,
 		OPCODE_SET_NAMED,
 		OPCODE_SET_NAMED_VALIDATED,
 		OPCODE_GET_NAMED,
@@ -261,6 +272,8 @@ public:
 		OPCODE_CALL_GDSCRIPT_UTILITY,
 		OPCODE_CALL_BUILTIN_TYPE_VALIDATED,
 		OPCODE_CALL_SELF_BASE,
+		OPCODE_CALL_SCRIPT_FUNCTION,
+		OPCODE_CALL_SCRIPT_FUNCTION_RETURN,
 		OPCODE_CALL_METHOD_BIND,
 		OPCODE_CALL_METHOD_BIND_RET,
 		OPCODE_CALL_BUILTIN_STATIC,
@@ -322,6 +335,7 @@ public:
 		OPCODE_ITERATE_BEGIN_STRING,
 		OPCODE_ITERATE_BEGIN_DICTIONARY,
 		OPCODE_ITERATE_BEGIN_ARRAY,
+		OPCODE_ITERATE_BEGIN_TYPED_ARRAY,
 		OPCODE_ITERATE_BEGIN_PACKED_BYTE_ARRAY,
 		OPCODE_ITERATE_BEGIN_PACKED_INT32_ARRAY,
 		OPCODE_ITERATE_BEGIN_PACKED_INT64_ARRAY,
@@ -342,6 +356,7 @@ public:
 		OPCODE_ITERATE_STRING,
 		OPCODE_ITERATE_DICTIONARY,
 		OPCODE_ITERATE_ARRAY,
+		OPCODE_ITERATE_TYPED_ARRAY,
 		OPCODE_ITERATE_PACKED_BYTE_ARRAY,
 		OPCODE_ITERATE_PACKED_INT32_ARRAY,
 		OPCODE_ITERATE_PACKED_INT64_ARRAY,
@@ -417,6 +432,28 @@ public:
 		INSTR_ARGS_MASK = ~INSTR_MASK,
 	};
 
+	// Element types of typed arrays whose values the VM reads and writes in place,
+	// see OPCODE_SET_INDEXED_TYPED_ARRAY, OPCODE_GET_INDEXED_TYPED_ARRAY and OPCODE_ITERATE_TYPED_ARRAY.
+	static _FORCE_INLINE_ bool is_direct_array_element_type(Variant::Type p_type) {
+		switch (p_type) {
+			case Variant::BOOL:
+			case Variant::INT:
+			case Variant::FLOAT:
+			case Variant::VECTOR2:
+			case Variant::VECTOR2I:
+			case Variant::RECT2:
+			case Variant::RECT2I:
+			case Variant::VECTOR3:
+			case Variant::VECTOR3I:
+			case Variant::PLANE:
+			case Variant::QUAT:
+			case Variant::COLOR:
+				return true;
+			default:
+				return false;
+		}
+	}
+
 	struct StackDebug {
 		int line;
 		int pos;
@@ -424,9 +461,73 @@ public:
 		StringName identifier;
 	};
 
+	// Call to a GDScript function known at compile time, see OPCODE_CALL_SCRIPT_FUNCTION.
+	// The callee is looked up on first use and kept until any script's functions change.
+	struct DirectCall {
+		GDScript *script = nullptr; // Only instances of exactly this class take the direct path.
+		StringName name;
+		GDScriptFunction *function = nullptr;
+		SafeNumeric<uint32_t> generation;
+
+		DirectCall() {}
+		DirectCall(const DirectCall &p_other) {
+			*this = p_other;
+		}
+		void operator=(const DirectCall &p_other) {
+			script = p_other.script;
+			name = p_other.name;
+			function = nullptr;
+			generation.set(0);
+		}
+	};
+
+	// Per-instruction cache for untyped named access and calls, see OPCODE_GET_NAMED, OPCODE_SET_NAMED and OPCODE_CALL.
+	// Remembers how the name was resolved for the last few receiver classes, until any script's functions change.
+	struct InlineCache {
+		enum Access {
+			ACCESS_GET,
+			ACCESS_SET,
+			ACCESS_CALL,
+		};
+
+		enum Kind {
+			KIND_BUILTIN, // Validated member getter or setter of a built-in type.
+			KIND_MEMBER, // Member variable of a GDScript instance.
+			KIND_FUNCTION, // Member function of a GDScript instance.
+			KIND_NATIVE, // Method, or property getter or setter, of a native class.
+		};
+
+		struct Entry {
+			SafeNumeric<uint32_t> generation;
+			// Receivers must have the same type, script and native class to use the entry.
+			Variant::Type type = Variant::NIL;
+			const GDScript *script = nullptr;
+			const StringName *class_name = nullptr;
+
+			Kind kind = KIND_BUILTIN;
+			Variant::ValidatedGetter getter = nullptr;
+			Variant::ValidatedSetter setter = nullptr;
+			Variant::Type value_type = Variant::VARIANT_MAX; // The only type the setter takes, or VARIANT_MAX for any.
+			MethodBind *method = nullptr;
+			int index = -1; // Member index, or property index passed to the native getter or setter.
+			GDScriptFunction *function = nullptr;
+		};
+
+		// Sites seeing more receiver classes than this are left to the regular lookup.
+		static const int MAX_ENTRIES = 4;
+		Entry entries[MAX_ENTRIES];
+
+		InlineCache() {}
+		InlineCache(const InlineCache &p_other) {}
+		void operator=(const InlineCache &p_other) {}
+	};
+
 private:
 	friend class GDScriptCompiler;
 	friend class GDScriptByteCodeGenerator;
+	friend class GDScriptByteCodeCache;
+	friend class GDScriptJIT;
+	friend class GDScriptJITCompiler;
 
 	StringName source;
 
@@ -463,6 +564,10 @@ private:
 	MethodBind **_methods_ptr = nullptr;
 	int _lambdas_count = 0;
 	GDScriptFunction **_lambdas_ptr = nullptr;
+	int _direct_calls_count = 0;
+	DirectCall *_direct_calls_ptr = nullptr;
+	int _inline_caches_count = 0;
+	InlineCache *_inline_caches_ptr = nullptr;
 	const int *_code_ptr = nullptr;
 	int _code_size = 0;
 	int _argument_count = 0;
@@ -493,6 +598,8 @@ private:
 	Vector<GDScriptUtilityFunctions::FunctionPtr> gds_utilities;
 	Vector<MethodBind *> methods;
 	Vector<GDScriptFunction *> lambdas;
+	Vector<DirectCall> direct_calls;
+	Vector<InlineCache> inline_caches;
 	Vector<int> code;
 	Vector<GDScriptDataType> argument_types;
 	GDScriptDataType return_type;
@@ -506,11 +613,21 @@ private:
 
 	List<StackDebug> stack_debug;
 
+#ifdef GDSCRIPT_JIT_ENABLED
+	GDScriptJIT::Code *jit_code = nullptr;
+	SafeFlag jit_compiled;
+	SafeNumeric<uint32_t> jit_hotness;
+#endif
+
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, Variant *p_stack, String &r_error) const;
+	_FORCE_INLINE_ Variant *_get_local_operand(int p_address, Variant *p_stack) const;
 	_FORCE_INLINE_ String _get_call_error(const Callable::CallError &p_err, const String &p_where, const Variant **argptrs) const;
+	static InlineCache::Entry *_get_inline_cache_entry(InlineCache *p_cache, InlineCache::Access p_access, const Variant *p_base, const StringName &p_name, Object *&r_object, GDScriptInstance *&r_instance, bool &r_hit);
 
 	friend class GDScriptLanguage;
 
+	static SafeNumeric<uint32_t> direct_call_generation;
+
 	SelfList<GDScriptFunction> function_list{ this };
 #ifdef DEBUG_ENABLED
 	CharString func_cname;
@@ -527,6 +644,12 @@ private:
 		uint64_t last_frame_call_count = 0;
 		uint64_t last_frame_self_time = 0;
 		uint64_t last_frame_total_time = 0;
+		uint64_t inline_cache_hits = 0;
+		uint64_t inline_cache_misses = 0;
+		uint64_t frame_inline_cache_hits = 0;
+		uint64_t frame_inline_cache_misses = 0;
+		uint64_t last_frame_inline_cache_hits = 0;
+		uint64_t last_frame_inline_cache_misses = 0;
 	} profile;
 
 #endif
@@ -539,7 +662,7 @@ public:
 		StringName function_name;
 		String script_path;
 #endif
-		Vector<uint8_t> stack;
+		uint8_t *stack = nullptr; // Pooled frame of alloca_size bytes, see GDScriptFunctionState::_alloc_frame().
 		int stack_size = 0;
 		uint32_t alloca_size = 0;
 		int ip = 0;
@@ -588,6 +711,9 @@ public:
 
 	Variant call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state = nullptr);
 
+	// Must be called whenever script functions are freed or replaced, so no direct call keeps using them.
+	static void invalidate_direct_calls() { direct_call_generation.increment(); }
+
 #ifdef DEBUG_ENABLED
 	void disassemble(const Vector<String> &p_code_lines) const;
 #endif
@@ -608,10 +734,46 @@ class GDScriptFunctionState : public Reference {
 	SelfList<GDScriptFunctionState> scripts_list;
 	SelfList<GDScriptFunctionState> instances_list;
 
+	// Frames of suspended functions are recycled, bucketed by their size rounded up to a power of two.
+	enum {
+		FRAME_POOL_BUCKETS = 32,
+		FRAME_POOL_MAX_FREE = 1024, // Per bucket, frames released past this are freed.
+	};
+
+	static SpinLock frame_pool_lock;
+	static LocalVector<uint8_t *> frame_pool[FRAME_POOL_BUCKETS];
+
+	static SafeNumeric<uint64_t> live_count;
+	static SafeNumeric<uint64_t> peak_live_count;
+	static SafeNumeric<uint64_t> await_count;
+	static SafeNumeric<uint64_t> resume_count;
+	static SafeNumeric<uint64_t> resume_usec;
+	static SafeNumeric<uint64_t> max_resume_usec;
+	static SafeNumeric<uint64_t> frames_allocated;
+	static SafeNumeric<uint64_t> frames_reused;
+
+	static uint8_t *_alloc_frame(uint32_t p_size);
+	static void _free_frame(uint8_t *p_frame, uint32_t p_size);
+
 protected:
 	static void _bind_methods();
 
 public:
+	struct CoroutineStats {
+		uint64_t live = 0; // Functions currently suspended in an await.
+		uint64_t peak_live = 0;
+		uint64_t awaits = 0; // Suspensions, including awaiting again after a resume.
+		uint64_t resumes = 0;
+		uint64_t resume_usec = 0; // Time spent in resumed functions until they returned or awaited again.
+		uint64_t max_resume_usec = 0;
+		uint64_t frames_allocated = 0;
+		uint64_t frames_reused = 0; // Frames taken from the pool instead of allocated.
+		uint64_t frames_pooled = 0; // Frames currently waiting in the pool.
+	};
+
+	static CoroutineStats get_coroutine_stats();
+	static void clear_frame_pool();
+
 	bool is_valid(bool p_extended_check = false) const;
 	Variant resume(const Variant &p_arg = Variant());
 
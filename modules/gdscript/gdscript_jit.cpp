@@ -0,0 +1,1429 @@
+/*************************************************************************/
+/*  gdscript_jit.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_jit.h"
+
+#include "core/object/class_db.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant_internal.h"
+#include "gdscript_function.h"
+
+#include <stddef.h>
+
+#ifdef GDSCRIPT_JIT_ENABLED
+#ifdef WINDOWS_ENABLED
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#endif
+
+bool GDScriptJIT::enabled = false;
+bool GDScriptJIT::verify = false;
+uint32_t GDScriptJIT::hot_threshold = 1000;
+SafeNumeric<uint64_t> GDScriptJIT::verify_mismatches;
+Mutex GDScriptJIT::mutex;
+thread_local GDScriptJIT::VerifyPass GDScriptJIT::verify_pass = GDScriptJIT::VERIFY_PASS_NONE;
+
+class GDScriptJIT::Code {
+public:
+	uint8_t *memory = nullptr;
+	size_t memory_size = 0;
+	// Offset of the native code of each instruction, 0 for instructions left to the interpreter.
+	LocalVector<uint32_t> entries;
+	const Variant *constants = nullptr;
+	bool uses_members = false;
+};
+
+#ifdef GDSCRIPT_JIT_ENABLED
+
+extern void (*type_init_function_table[])(Variant *);
+
+// State shared between the VM and native code, r14 points to it while native code runs.
+struct GDScriptJITFrame {
+	Variant *stack = nullptr;
+	const Variant *constants = nullptr;
+	Variant *members = nullptr;
+	int32_t line = 0;
+};
+
+typedef int (*GDScriptJITEntry)(GDScriptJITFrame *p_frame, const uint8_t *p_target);
+
+// Native code reads the type and the inline data of variants directly.
+static const int VARIANT_TYPE_OFFSET = 0;
+static const int VARIANT_DATA_OFFSET = 8;
+
+// Types without a destructor and initialized by setting the type alone, which native code can overwrite in place.
+static const uint64_t TRIVIAL_TYPES = (1ULL << Variant::NIL) | (1ULL << Variant::BOOL) | (1ULL << Variant::INT) | (1ULL << Variant::FLOAT) |
+		(1ULL << Variant::VECTOR2) | (1ULL << Variant::VECTOR2I) | (1ULL << Variant::RECT2) | (1ULL << Variant::RECT2I) |
+		(1ULL << Variant::VECTOR3) | (1ULL << Variant::VECTOR3I) | (1ULL << Variant::PLANE) | (1ULL << Variant::QUAT) |
+		(1ULL << Variant::COLOR) | (1ULL << Variant::RID);
+
+static _FORCE_INLINE_ bool _is_trivial_type(int p_type) {
+	return p_type >= 0 && p_type < Variant::VARIANT_MAX && (TRIVIAL_TYPES & (1ULL << p_type));
+}
+
+// Slow paths of native code, doing what the interpreter would.
+
+static void _jit_assign(Variant *p_dst, const Variant *p_src) {
+	*p_dst = *p_src;
+}
+
+static void _jit_assign_bool(Variant *p_dst, bool p_value) {
+	*p_dst = p_value;
+}
+
+static bool _jit_assign_typed_builtin(Variant *p_dst, const Variant *p_src, int p_type) {
+	Variant::Type var_type = (Variant::Type)p_type;
+	if (p_src->get_type() == var_type) {
+		*p_dst = *p_src;
+		return true;
+	}
+#ifdef DEBUG_ENABLED
+	if (!Variant::can_convert_strict(p_src->get_type(), var_type)) {
+		// Let the interpreter report the error.
+		return false;
+	}
+#endif
+	Callable::CallError ce;
+	Variant::construct(var_type, *p_dst, &p_src, 1, ce);
+	return true;
+}
+
+static bool _jit_booleanize(const Variant *p_value) {
+	return p_value->booleanize();
+}
+
+static void _jit_type_adjust(Variant *p_value, int p_type) {
+	if (p_type == Variant::OBJECT) {
+		VariantTypeAdjust<Object *>::adjust(p_value);
+		return;
+	}
+	VariantInternal::clear(p_value);
+	type_init_function_table[p_type](p_value);
+}
+
+static void _jit_initialize_int(Variant *p_value) {
+	VariantInternal::initialize(p_value, Variant::INT);
+}
+
+// Minimal x86-64 encoder, only for the instructions the compiler needs.
+// Memory operands are always a base register plus a 32-bit displacement.
+class GDScriptJITAssembler {
+public:
+	enum Register {
+		RAX,
+		RCX,
+		RDX,
+		RBX,
+		RSP,
+		RBP,
+		RSI,
+		RDI,
+		R8,
+		R9,
+		R10,
+		R11,
+		R12,
+		R13,
+		R14,
+		R15,
+	};
+
+	enum XMMRegister {
+		XMM0,
+		XMM1,
+		XMM2,
+	};
+
+	enum Condition {
+		CC_B = 0x2,
+		CC_AE = 0x3,
+		CC_E = 0x4,
+		CC_NE = 0x5,
+		CC_BE = 0x6,
+		CC_A = 0x7,
+		CC_P = 0xA,
+		CC_NP = 0xB,
+		CC_L = 0xC,
+		CC_GE = 0xD,
+		CC_LE = 0xE,
+		CC_G = 0xF,
+	};
+
+	// Two byte opcodes are written as 0x0Fxx.
+	enum {
+		OP_ADD = 0x03,
+		OP_OR = 0x0B,
+		OP_AND = 0x23,
+		OP_SUB = 0x2B,
+		OP_XOR = 0x33,
+		OP_CMP = 0x3B,
+		OP_IMUL = 0x0FAF,
+		SSE_MOV_LOAD = 0x0F10,
+		SSE_MOV_STORE = 0x0F11,
+		SSE_ADD = 0x0F58,
+		SSE_MUL = 0x0F59,
+		SSE_CONVERT = 0x0F5A,
+		SSE_SUB = 0x0F5C,
+		SSE_DIV = 0x0F5E,
+		PREFIX_DOUBLE = 0xF2,
+		PREFIX_SINGLE = 0xF3,
+	};
+
+	struct Memory {
+		Register base = RAX;
+		int32_t offset = 0;
+
+		Memory operator+(int32_t p_offset) const {
+			Memory m = *this;
+			m.offset += p_offset;
+			return m;
+		}
+	};
+
+private:
+	struct Fixup {
+		int position;
+		int label;
+	};
+
+	LocalVector<uint8_t> code;
+	LocalVector<int> label_positions;
+	LocalVector<Fixup> fixups;
+
+	void _rex(bool p_wide, int p_reg, int p_base) {
+		uint8_t rex = 0x40 | (p_wide ? 0x8 : 0) | ((p_reg & 8) ? 0x4 : 0) | ((p_base & 8) ? 0x1 : 0);
+		if (rex != 0x40) {
+			byte(rex);
+		}
+	}
+
+	void _opcode(uint32_t p_opcode) {
+		if (p_opcode > 0xFF) {
+			byte(p_opcode >> 8);
+		}
+		byte(p_opcode & 0xFF);
+	}
+
+	void _rel32(int p_label) {
+		fixups.push_back({ (int)code.size(), p_label });
+		dword(0);
+	}
+
+public:
+	void byte(uint8_t p_byte) { code.push_back(p_byte); }
+
+	void dword(uint32_t p_dword) {
+		for (int i = 0; i < 4; i++) {
+			byte((p_dword >> (i * 8)) & 0xFF);
+		}
+	}
+
+	void qword(uint64_t p_qword) {
+		for (int i = 0; i < 8; i++) {
+			byte((p_qword >> (i * 8)) & 0xFF);
+		}
+	}
+
+	void op_memory(uint8_t p_prefix, bool p_wide, uint32_t p_opcode, int p_reg, const Memory &p_memory) {
+		if (p_prefix) {
+			byte(p_prefix);
+		}
+		_rex(p_wide, p_reg, p_memory.base);
+		_opcode(p_opcode);
+		byte(0x80 | ((p_reg & 7) << 3) | (p_memory.base & 7));
+		if ((p_memory.base & 7) == RSP) {
+			byte(0x24); // SIB without index.
+		}
+		dword(p_memory.offset);
+	}
+
+	void op_register(uint8_t p_prefix, bool p_wide, uint32_t p_opcode, int p_reg, int p_rm) {
+		if (p_prefix) {
+			byte(p_prefix);
+		}
+		_rex(p_wide, p_reg, p_rm);
+		_opcode(p_opcode);
+		byte(0xC0 | ((p_reg & 7) << 3) | (p_rm & 7));
+	}
+
+	int position() const { return code.size(); }
+	const LocalVector<uint8_t> &get_code() const { return code; }
+
+	int create_label() {
+		label_positions.push_back(-1);
+		return label_positions.size() - 1;
+	}
+	void bind(int p_label) { label_positions[p_label] = code.size(); }
+	bool is_bound(int p_label) const { return label_positions[p_label] != -1; }
+
+	void finalize() {
+		for (uint32_t i = 0; i < fixups.size(); i++) {
+			const Fixup &fixup = fixups[i];
+			int32_t relative = label_positions[fixup.label] - (fixup.position + 4);
+			for (int j = 0; j < 4; j++) {
+				code[fixup.position + j] = (relative >> (j * 8)) & 0xFF;
+			}
+		}
+	}
+
+	void mov(Register p_dst, const Memory &p_src) { op_memory(0, true, 0x8B, p_dst, p_src); }
+	void mov(const Memory &p_dst, Register p_src) { op_memory(0, true, 0x89, p_src, p_dst); }
+	void mov(Register p_dst, Register p_src) { op_register(0, true, 0x89, p_src, p_dst); }
+	void mov32(Register p_dst, const Memory &p_src) { op_memory(0, false, 0x8B, p_dst, p_src); }
+	void mov8(const Memory &p_dst, Register p_src) { op_memory(0, false, 0x88, p_src, p_dst); }
+	void movzx8(Register p_dst, const Memory &p_src) { op_memory(0, false, 0x0FB6, p_dst, p_src); }
+	void lea(Register p_dst, const Memory &p_src) { op_memory(0, true, 0x8D, p_dst, p_src); }
+
+	void mov_imm(Register p_dst, uint64_t p_value) {
+		_rex(true, 0, p_dst);
+		byte(0xB8 + (p_dst & 7));
+		qword(p_value);
+	}
+
+	void mov_imm32(Register p_dst, uint32_t p_value) {
+		_rex(false, 0, p_dst);
+		byte(0xB8 + (p_dst & 7));
+		dword(p_value);
+	}
+
+	void store_imm64(const Memory &p_dst, int32_t p_value) {
+		op_memory(0, true, 0xC7, 0, p_dst);
+		dword(p_value);
+	}
+
+	void store_imm32(const Memory &p_dst, int32_t p_value) {
+		op_memory(0, false, 0xC7, 0, p_dst);
+		dword(p_value);
+	}
+
+	void store_imm8(const Memory &p_dst, uint8_t p_value) {
+		op_memory(0, false, 0xC6, 0, p_dst);
+		byte(p_value);
+	}
+
+	void cmp_imm32(const Memory &p_a, int32_t p_value) {
+		op_memory(0, false, 0x81, 7, p_a);
+		dword(p_value);
+	}
+
+	void cmp_imm8(const Memory &p_a, uint8_t p_value) {
+		op_memory(0, false, 0x80, 7, p_a);
+		byte(p_value);
+	}
+
+	void alu(uint32_t p_opcode, Register p_dst, const Memory &p_src) { op_memory(0, true, p_opcode, p_dst, p_src); }
+
+	void add_imm8(Register p_dst, int8_t p_value) {
+		op_register(0, true, 0x83, 0, p_dst);
+		byte(p_value);
+	}
+
+	void add_rsp(int32_t p_value) {
+		op_register(0, true, 0x81, 0, RSP);
+		dword(p_value);
+	}
+
+	void sub_rsp(int32_t p_value) {
+		op_register(0, true, 0x81, 5, RSP);
+		dword(p_value);
+	}
+
+	void test(Register p_a, Register p_b) { op_register(0, true, 0x85, p_b, p_a); }
+	void test8(Register p_a, Register p_b) { op_register(0, false, 0x84, p_b, p_a); }
+	// Bit test, sets the carry flag to bit p_bit of p_base.
+	void bt(Register p_base, Register p_bit) { op_register(0, true, 0x0FA3, p_bit, p_base); }
+	// Byte operations, only for AL, CL, DL and BL.
+	void setcc(Condition p_condition, Register p_dst) { op_register(0, false, 0x0F90 | p_condition, 0, p_dst); }
+	void and8(Register p_dst, Register p_src) { op_register(0, false, 0x20, p_src, p_dst); }
+	void or8(Register p_dst, Register p_src) { op_register(0, false, 0x08, p_src, p_dst); }
+
+	void sse(uint8_t p_prefix, uint32_t p_opcode, XMMRegister p_reg, const Memory &p_memory) { op_memory(p_prefix, false, p_opcode, p_reg, p_memory); }
+	void sse(uint8_t p_prefix, uint32_t p_opcode, XMMRegister p_reg, XMMRegister p_rm) { op_register(p_prefix, false, p_opcode, p_reg, p_rm); }
+	void ucomisd(XMMRegister p_a, const Memory &p_b) { op_memory(0x66, false, 0x0F2E, p_a, p_b); }
+
+	void push(Register p_reg) {
+		_rex(false, 0, p_reg);
+		byte(0x50 + (p_reg & 7));
+	}
+
+	void pop(Register p_reg) {
+		_rex(false, 0, p_reg);
+		byte(0x58 + (p_reg & 7));
+	}
+
+	void call(Register p_reg) { op_register(0, false, 0xFF, 2, p_reg); }
+	void jmp(Register p_reg) { op_register(0, false, 0xFF, 4, p_reg); }
+	void ret() { byte(0xC3); }
+
+	void jmp(int p_label) {
+		byte(0xE9);
+		_rel32(p_label);
+	}
+
+	void jcc(Condition p_condition, int p_label) {
+		byte(0x0F);
+		byte(0x80 | p_condition);
+		_rel32(p_label);
+	}
+};
+
+typedef GDScriptJITAssembler ASM;
+
+#ifdef WINDOWS_ENABLED
+static const ASM::Register ARGUMENT_REGISTERS[4] = { ASM::RCX, ASM::RDX, ASM::R8, ASM::R9 };
+#else
+static const ASM::Register ARGUMENT_REGISTERS[4] = { ASM::RDI, ASM::RSI, ASM::RDX, ASM::RCX };
+#endif
+
+// Operators native code evaluates itself, anything else calls the validated evaluator.
+struct GDScriptJITOperator {
+	Variant::Operator op;
+	Variant::Type left;
+	Variant::Type right;
+	Variant::ValidatedOperatorEvaluator evaluator;
+};
+
+static GDScriptJITOperator jit_operators[] = {
+	{ Variant::OP_ADD, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_SUBTRACT, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_MULTIPLY, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_BIT_AND, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_BIT_OR, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_BIT_XOR, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_EQUAL, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_NOT_EQUAL, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_LESS, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_LESS_EQUAL, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_GREATER, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_GREATER_EQUAL, Variant::INT, Variant::INT, nullptr },
+	{ Variant::OP_ADD, Variant::FLOAT, Variant::FLOAT, nullptr },
+	{ Variant::OP_SUBTRACT, Variant::FLOAT, Variant::FLOAT, nullptr },
+	{ Variant::OP_MULTIPLY, Variant::FLOAT, Variant::FLOAT, nullptr },
+	{ Variant::OP_DIVIDE, Variant::FLOAT, Variant::FLOAT, nullptr },
+	{ Variant::OP_EQUAL, Variant::FLOAT, Variant::FLOAT, nullptr },
+	{ Variant::OP_NOT_EQUAL, Variant::FLOAT, Variant::FLOAT, nullptr },
+	{ Variant::OP_LESS, Variant::FLOAT, Variant::FLOAT, nullptr },
+	{ Variant::OP_LESS_EQUAL, Variant::FLOAT, Variant::FLOAT, nullptr },
+	{ Variant::OP_GREATER, Variant::FLOAT, Variant::FLOAT, nullptr },
+	{ Variant::OP_GREATER_EQUAL, Variant::FLOAT, Variant::FLOAT, nullptr },
+#ifndef REAL_T_IS_DOUBLE
+	{ Variant::OP_ADD, Variant::VECTOR2, Variant::VECTOR2, nullptr },
+	{ Variant::OP_SUBTRACT, Variant::VECTOR2, Variant::VECTOR2, nullptr },
+	{ Variant::OP_MULTIPLY, Variant::VECTOR2, Variant::VECTOR2, nullptr },
+	{ Variant::OP_MULTIPLY, Variant::VECTOR2, Variant::FLOAT, nullptr },
+	{ Variant::OP_ADD, Variant::VECTOR3, Variant::VECTOR3, nullptr },
+	{ Variant::OP_SUBTRACT, Variant::VECTOR3, Variant::VECTOR3, nullptr },
+	{ Variant::OP_MULTIPLY, Variant::VECTOR3, Variant::VECTOR3, nullptr },
+	{ Variant::OP_MULTIPLY, Variant::VECTOR3, Variant::FLOAT, nullptr },
+#endif
+};
+
+static const GDScriptJITOperator *_find_jit_operator(Variant::ValidatedOperatorEvaluator p_evaluator) {
+	static bool initialized = false;
+	if (!initialized) {
+		for (GDScriptJITOperator &op : jit_operators) {
+			op.evaluator = Variant::get_validated_operator_evaluator(op.op, op.left, op.right);
+		}
+		initialized = true;
+	}
+
+	for (const GDScriptJITOperator &op : jit_operators) {
+		if (op.evaluator && op.evaluator == p_evaluator) {
+			return &op;
+		}
+	}
+	return nullptr;
+}
+
+// Register use in native code:
+// rbx: function stack, r12: constants, r13: instance members, r14: GDScriptJITFrame, r15: scratch kept across calls.
+// rax, rcx, rdx, xmm0-2: scratch.
+class GDScriptJITCompiler {
+	// Outgoing call area: shadow space for Windows, the out of bounds flag of indexed accesses, and argument pointers.
+	static const int MAX_CALL_ARGUMENTS = 16;
+	static const int OOB_OFFSET = 32;
+	static const int ARGUMENTS_OFFSET = 40;
+	static const int FRAME_SIZE = ARGUMENTS_OFFSET + MAX_CALL_ARGUMENTS * 8; // Keeps the stack 16-byte aligned after 8 pushes.
+
+	struct Exit {
+		int label;
+		int ip;
+	};
+
+	const GDScriptFunction *function;
+	const int *code;
+	int code_size;
+
+	ASM as;
+	int epilogue = -1;
+	LocalVector<int> ip_labels;
+	LocalVector<int> worklist;
+	LocalVector<Exit> exits;
+	LocalVector<uint32_t> entries;
+	bool uses_members = false;
+
+	int _label_for_ip(int p_ip) {
+		if (ip_labels[p_ip] == -1) {
+			ip_labels[p_ip] = as.create_label();
+			worklist.push_back(p_ip);
+		}
+		return ip_labels[p_ip];
+	}
+
+	// Returns to the interpreter at p_ip, which then reports the error or runs the instruction.
+	int _exit_label(int p_ip) {
+		Exit exit;
+		exit.label = as.create_label();
+		exit.ip = p_ip;
+		exits.push_back(exit);
+		return exit.label;
+	}
+
+	void _emit_exit(int p_ip) {
+		as.mov_imm32(ASM::RAX, p_ip);
+		as.jmp(epilogue);
+	}
+
+	bool _get_operand(int p_position, ASM::Memory &r_memory) {
+		if (p_position >= code_size) {
+			return false;
+		}
+		int address = code[p_position] & GDScriptFunction::ADDR_MASK;
+		switch ((code[p_position] & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+			case GDScriptFunction::ADDR_TYPE_STACK: {
+				if (address >= function->_stack_size) {
+					return false;
+				}
+				r_memory = ASM::Memory{ ASM::RBX, (int32_t)(address * sizeof(Variant)) };
+				return true;
+			}
+			case GDScriptFunction::ADDR_TYPE_CONSTANT: {
+				if (address >= function->_constant_count) {
+					return false;
+				}
+				r_memory = ASM::Memory{ ASM::R12, (int32_t)(address * sizeof(Variant)) };
+				return true;
+			}
+			case GDScriptFunction::ADDR_TYPE_MEMBER: {
+				uses_members = true;
+				r_memory = ASM::Memory{ ASM::R13, (int32_t)(address * sizeof(Variant)) };
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool _is_jump_target(int p_ip) const {
+		// The last instruction is always OPCODE_END, so any valid target is an instruction.
+		return p_ip >= 0 && p_ip < code_size;
+	}
+
+	void _call(const void *p_function) {
+		as.mov_imm(ASM::RAX, (uint64_t)p_function);
+		as.call(ASM::RAX);
+	}
+
+	// Jumps to p_slow unless the variant has a trivial type, clobbers rax and rcx.
+	void _require_trivial(const ASM::Memory &p_value, int p_slow) {
+		as.mov_imm(ASM::RCX, TRIVIAL_TYPES);
+		as.mov32(ASM::RAX, p_value + VARIANT_TYPE_OFFSET);
+		as.bt(ASM::RCX, ASM::RAX);
+		as.jcc(ASM::CC_AE, p_slow);
+	}
+
+	// Makes p_dst hold a variant of type p_type, like VariantTypeChanger does, without touching its data.
+	// Jumps to p_slow when it has a type that must be destroyed first.
+	void _change_type(const ASM::Memory &p_dst, Variant::Type p_type, int p_slow) {
+		int done = as.create_label();
+		as.cmp_imm32(p_dst + VARIANT_TYPE_OFFSET, p_type);
+		as.jcc(ASM::CC_E, done);
+		_require_trivial(p_dst, p_slow);
+		as.store_imm32(p_dst + VARIANT_TYPE_OFFSET, p_type);
+		as.bind(done);
+	}
+
+	void _copy_variant(const ASM::Memory &p_dst, const ASM::Memory &p_src) {
+		for (int i = 0; i < (int)sizeof(Variant); i += 8) {
+			as.mov(ASM::RAX, p_src + i);
+			as.mov(p_dst + i, ASM::RAX);
+		}
+	}
+
+	void _emit_assign(const ASM::Memory &p_dst, const ASM::Memory &p_src) {
+		int slow = as.create_label();
+		int done = as.create_label();
+		_require_trivial(p_src, slow);
+		_require_trivial(p_dst, slow);
+		_copy_variant(p_dst, p_src);
+		as.jmp(done);
+
+		as.bind(slow);
+		as.lea(ARGUMENT_REGISTERS[0], p_dst);
+		as.lea(ARGUMENT_REGISTERS[1], p_src);
+		_call((const void *)&_jit_assign);
+		as.bind(done);
+	}
+
+	void _emit_assign_bool(const ASM::Memory &p_dst, bool p_value) {
+		int slow = as.create_label();
+		int done = as.create_label();
+		_require_trivial(p_dst, slow);
+		as.store_imm32(p_dst + VARIANT_TYPE_OFFSET, Variant::BOOL);
+		as.store_imm8(p_dst + VARIANT_DATA_OFFSET, p_value);
+		as.jmp(done);
+
+		as.bind(slow);
+		as.lea(ARGUMENT_REGISTERS[0], p_dst);
+		as.mov_imm32(ARGUMENT_REGISTERS[1], p_value);
+		_call((const void *)&_jit_assign_bool);
+		as.bind(done);
+	}
+
+	// Sets p_value to an integer 0, as OPCODE_ITERATE_BEGIN_INT does with the counter and the iterator.
+	void _emit_initialize_int(const ASM::Memory &p_value) {
+		int slow = as.create_label();
+		int set = as.create_label();
+		_require_trivial(p_value, slow);
+		as.store_imm32(p_value + VARIANT_TYPE_OFFSET, Variant::INT);
+		as.jmp(set);
+
+		as.bind(slow);
+		as.lea(ARGUMENT_REGISTERS[0], p_value);
+		_call((const void *)&_jit_initialize_int);
+		as.bind(set);
+		as.store_imm64(p_value + VARIANT_DATA_OFFSET, 0);
+	}
+
+	void _emit_int_operator(const GDScriptJITOperator &p_op, const ASM::Memory &p_a, const ASM::Memory &p_b, const ASM::Memory &p_dst) {
+		as.mov(ASM::RAX, p_a + VARIANT_DATA_OFFSET);
+		ASM::Condition condition = ASM::CC_E;
+		switch (p_op.op) {
+			case Variant::OP_ADD:
+				as.alu(ASM::OP_ADD, ASM::RAX, p_b + VARIANT_DATA_OFFSET);
+				break;
+			case Variant::OP_SUBTRACT:
+				as.alu(ASM::OP_SUB, ASM::RAX, p_b + VARIANT_DATA_OFFSET);
+				break;
+			case Variant::OP_MULTIPLY:
+				as.alu(ASM::OP_IMUL, ASM::RAX, p_b + VARIANT_DATA_OFFSET);
+				break;
+			case Variant::OP_BIT_AND:
+				as.alu(ASM::OP_AND, ASM::RAX, p_b + VARIANT_DATA_OFFSET);
+				break;
+			case Variant::OP_BIT_OR:
+				as.alu(ASM::OP_OR, ASM::RAX, p_b + VARIANT_DATA_OFFSET);
+				break;
+			case Variant::OP_BIT_XOR:
+				as.alu(ASM::OP_XOR, ASM::RAX, p_b + VARIANT_DATA_OFFSET);
+				break;
+			default: {
+				switch (p_op.op) {
+					case Variant::OP_NOT_EQUAL:
+						condition = ASM::CC_NE;
+						break;
+					case Variant::OP_LESS:
+						condition = ASM::CC_L;
+						break;
+					case Variant::OP_LESS_EQUAL:
+						condition = ASM::CC_LE;
+						break;
+					case Variant::OP_GREATER:
+						condition = ASM::CC_G;
+						break;
+					case Variant::OP_GREATER_EQUAL:
+						condition = ASM::CC_GE;
+						break;
+					default:
+						break;
+				}
+				as.alu(ASM::OP_CMP, ASM::RAX, p_b + VARIANT_DATA_OFFSET);
+				as.setcc(condition, ASM::RAX);
+				as.mov8(p_dst + VARIANT_DATA_OFFSET, ASM::RAX);
+				return;
+			}
+		}
+		as.mov(p_dst + VARIANT_DATA_OFFSET, ASM::RAX);
+	}
+
+	void _emit_float_operator(const GDScriptJITOperator &p_op, const ASM::Memory &p_a, const ASM::Memory &p_b, const ASM::Memory &p_dst) {
+		uint32_t arithmetic = 0;
+		switch (p_op.op) {
+			case Variant::OP_ADD:
+				arithmetic = ASM::SSE_ADD;
+				break;
+			case Variant::OP_SUBTRACT:
+				arithmetic = ASM::SSE_SUB;
+				break;
+			case Variant::OP_MULTIPLY:
+				arithmetic = ASM::SSE_MUL;
+				break;
+			case Variant::OP_DIVIDE:
+				arithmetic = ASM::SSE_DIV;
+				break;
+			default:
+				break;
+		}
+
+		if (arithmetic) {
+			as.sse(ASM::PREFIX_DOUBLE, ASM::SSE_MOV_LOAD, ASM::XMM0, p_a + VARIANT_DATA_OFFSET);
+			as.sse(ASM::PREFIX_DOUBLE, arithmetic, ASM::XMM0, p_b + VARIANT_DATA_OFFSET);
+			as.sse(ASM::PREFIX_DOUBLE, ASM::SSE_MOV_STORE, ASM::XMM0, p_dst + VARIANT_DATA_OFFSET);
+			return;
+		}
+
+		// Unordered comparisons set ZF, PF and CF, pick conditions that are false for NaN like C++ does.
+		switch (p_op.op) {
+			case Variant::OP_LESS:
+			case Variant::OP_LESS_EQUAL:
+				as.sse(ASM::PREFIX_DOUBLE, ASM::SSE_MOV_LOAD, ASM::XMM0, p_b + VARIANT_DATA_OFFSET);
+				as.ucomisd(ASM::XMM0, p_a + VARIANT_DATA_OFFSET);
+				as.setcc(p_op.op == Variant::OP_LESS ? ASM::CC_A : ASM::CC_AE, ASM::RAX);
+				break;
+			case Variant::OP_GREATER:
+			case Variant::OP_GREATER_EQUAL:
+				as.sse(ASM::PREFIX_DOUBLE, ASM::SSE_MOV_LOAD, ASM::XMM0, p_a + VARIANT_DATA_OFFSET);
+				as.ucomisd(ASM::XMM0, p_b + VARIANT_DATA_OFFSET);
+				as.setcc(p_op.op == Variant::OP_GREATER ? ASM::CC_A : ASM::CC_AE, ASM::RAX);
+				break;
+			case Variant::OP_EQUAL:
+				as.sse(ASM::PREFIX_DOUBLE, ASM::SSE_MOV_LOAD, ASM::XMM0, p_a + VARIANT_DATA_OFFSET);
+				as.ucomisd(ASM::XMM0, p_b + VARIANT_DATA_OFFSET);
+				as.setcc(ASM::CC_E, ASM::RAX);
+				as.setcc(ASM::CC_NP, ASM::RCX);
+				as.and8(ASM::RAX, ASM::RCX);
+				break;
+			default: // Not equal.
+				as.sse(ASM::PREFIX_DOUBLE, ASM::SSE_MOV_LOAD, ASM::XMM0, p_a + VARIANT_DATA_OFFSET);
+				as.ucomisd(ASM::XMM0, p_b + VARIANT_DATA_OFFSET);
+				as.setcc(ASM::CC_NE, ASM::RAX);
+				as.setcc(ASM::CC_P, ASM::RCX);
+				as.or8(ASM::RAX, ASM::RCX);
+				break;
+		}
+		as.mov8(p_dst + VARIANT_DATA_OFFSET, ASM::RAX);
+	}
+
+	// Component-wise on real_t components, each one is read before it's written so the result may alias an operand.
+	void _emit_vector_operator(const GDScriptJITOperator &p_op, const ASM::Memory &p_a, const ASM::Memory &p_b, const ASM::Memory &p_dst) {
+		int components = p_op.left == Variant::VECTOR2 ? 2 : 3;
+		uint32_t arithmetic = p_op.op == Variant::OP_ADD ? ASM::SSE_ADD : (p_op.op == Variant::OP_SUBTRACT ? ASM::SSE_SUB : ASM::SSE_MUL);
+
+		if (p_op.right == Variant::FLOAT) {
+			// Vectors multiply by a real_t, so the double is rounded first.
+			as.sse(ASM::PREFIX_DOUBLE, ASM::SSE_CONVERT, ASM::XMM1, p_b + VARIANT_DATA_OFFSET);
+		}
+
+		for (int i = 0; i < components; i++) {
+			int offset = VARIANT_DATA_OFFSET + i * sizeof(real_t);
+			as.sse(ASM::PREFIX_SINGLE, ASM::SSE_MOV_LOAD, ASM::XMM0, p_a + offset);
+			if (p_op.right == Variant::FLOAT) {
+				as.sse(ASM::PREFIX_SINGLE, arithmetic, ASM::XMM0, ASM::XMM1);
+			} else {
+				as.sse(ASM::PREFIX_SINGLE, arithmetic, ASM::XMM0, p_b + offset);
+			}
+			as.sse(ASM::PREFIX_SINGLE, ASM::SSE_MOV_STORE, ASM::XMM0, p_dst + offset);
+		}
+	}
+
+	// Evaluates a validated operator, inline when the operand types are simple enough.
+	// With p_false_ip, also jumps there when the (boolean) result is false.
+	void _emit_operator(Variant::ValidatedOperatorEvaluator p_evaluator, const ASM::Memory &p_a, const ASM::Memory &p_b, const ASM::Memory &p_dst, int p_false_ip = -1) {
+		const GDScriptJITOperator *op = _find_jit_operator(p_evaluator);
+		int slow = as.create_label();
+		int done = as.create_label();
+
+		if (op) {
+			bool comparison = op->op >= Variant::OP_EQUAL && op->op <= Variant::OP_GREATER_EQUAL;
+			// Only the type is written before the operands are read, so the result may alias an operand.
+			_change_type(p_dst, comparison ? Variant::BOOL : op->left, slow);
+			if (op->left == Variant::INT) {
+				_emit_int_operator(*op, p_a, p_b, p_dst);
+			} else if (op->left == Variant::FLOAT) {
+				_emit_float_operator(*op, p_a, p_b, p_dst);
+			} else {
+				_emit_vector_operator(*op, p_a, p_b, p_dst);
+			}
+			as.jmp(done);
+		}
+
+		as.bind(slow);
+		as.lea(ARGUMENT_REGISTERS[0], p_a);
+		as.lea(ARGUMENT_REGISTERS[1], p_b);
+		as.lea(ARGUMENT_REGISTERS[2], p_dst);
+		_call((const void *)p_evaluator);
+		as.bind(done);
+
+		if (p_false_ip != -1) {
+			as.cmp_imm8(p_dst + VARIANT_DATA_OFFSET, 0);
+			as.jcc(ASM::CC_E, _label_for_ip(p_false_ip));
+		}
+	}
+
+	void _emit_jump_if(const ASM::Memory &p_test, bool p_jump_if_true, int p_target_ip) {
+		int slow = as.create_label();
+		int test = as.create_label();
+		as.cmp_imm32(p_test + VARIANT_TYPE_OFFSET, Variant::BOOL);
+		as.jcc(ASM::CC_NE, slow);
+		as.movzx8(ASM::RAX, p_test + VARIANT_DATA_OFFSET);
+		as.jmp(test);
+
+		as.bind(slow);
+		as.lea(ARGUMENT_REGISTERS[0], p_test);
+		_call((const void *)&_jit_booleanize);
+		as.bind(test);
+		as.test8(ASM::RAX, ASM::RAX);
+		as.jcc(p_jump_if_true ? ASM::CC_NE : ASM::CC_E, _label_for_ip(p_target_ip));
+	}
+
+	// Stores the pointers to the arguments of a validated call in the outgoing call area.
+	bool _emit_argument_pointers(int p_ip, int p_argc) {
+		if (p_argc < 0 || p_argc > MAX_CALL_ARGUMENTS) {
+			return false;
+		}
+		LocalVector<ASM::Memory> arguments;
+		for (int i = 0; i < p_argc; i++) {
+			ASM::Memory argument;
+			if (!_get_operand(p_ip + 1 + i, argument)) {
+				return false;
+			}
+			arguments.push_back(argument);
+		}
+		for (int i = 0; i < p_argc; i++) {
+			as.lea(ASM::RAX, arguments[i]);
+			as.mov(ASM::Memory{ ASM::RSP, ARGUMENTS_OFFSET + i * 8 }, ASM::RAX);
+		}
+		return true;
+	}
+
+	// Instructions of known size the compiler leaves to the interpreter, so the code after them can still be compiled.
+	int _get_interpreted_size(int p_ip) const {
+		int opcode = code[p_ip] & GDScriptFunction::INSTR_MASK;
+		int instr_arg_count = (code[p_ip] & GDScriptFunction::INSTR_ARGS_MASK) >> GDScriptFunction::INSTR_BITS;
+		if (opcode >= GDScriptFunction::OPCODE_CALL_PTRCALL_NO_RETURN && opcode <= GDScriptFunction::OPCODE_CALL_PTRCALL_PACKED_COLOR_ARRAY) {
+			return instr_arg_count + 3;
+		}
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_BREAKPOINT:
+				return 1;
+			case GDScriptFunction::OPCODE_SET_MEMBER:
+			case GDScriptFunction::OPCODE_GET_MEMBER:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_ARRAY:
+			case GDScriptFunction::OPCODE_STORE_NAMED_GLOBAL:
+			case GDScriptFunction::OPCODE_ASSERT:
+				return 3;
+			case GDScriptFunction::OPCODE_EXTENDS_TEST:
+			case GDScriptFunction::OPCODE_IS_BUILTIN:
+			case GDScriptFunction::OPCODE_SET_KEYED:
+			case GDScriptFunction::OPCODE_GET_KEYED:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE:
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_SCRIPT:
+			case GDScriptFunction::OPCODE_CAST_TO_BUILTIN:
+			case GDScriptFunction::OPCODE_CAST_TO_NATIVE:
+			case GDScriptFunction::OPCODE_CAST_TO_SCRIPT:
+				return 4;
+			case GDScriptFunction::OPCODE_OPERATOR:
+			case GDScriptFunction::OPCODE_SET_KEYED_VALIDATED:
+			case GDScriptFunction::OPCODE_GET_KEYED_VALIDATED:
+			case GDScriptFunction::OPCODE_SET_INDEXED_TYPED_ARRAY:
+			case GDScriptFunction::OPCODE_GET_INDEXED_TYPED_ARRAY:
+			case GDScriptFunction::OPCODE_SET_NAMED:
+			case GDScriptFunction::OPCODE_GET_NAMED:
+				return 5;
+			case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY:
+			case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY:
+				return instr_arg_count + 2;
+			case GDScriptFunction::OPCODE_CONSTRUCT:
+			case GDScriptFunction::OPCODE_CALL_UTILITY:
+			case GDScriptFunction::OPCODE_CALL_GDSCRIPT_UTILITY:
+			case GDScriptFunction::OPCODE_CALL_SELF_BASE:
+			case GDScriptFunction::OPCODE_CALL_SCRIPT_FUNCTION:
+			case GDScriptFunction::OPCODE_CALL_SCRIPT_FUNCTION_RETURN:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND:
+			case GDScriptFunction::OPCODE_CALL_METHOD_BIND_RET:
+			case GDScriptFunction::OPCODE_CREATE_LAMBDA:
+				return instr_arg_count + 3;
+			case GDScriptFunction::OPCODE_CONSTRUCT_TYPED_ARRAY:
+			case GDScriptFunction::OPCODE_CALL_BUILTIN_STATIC:
+			case GDScriptFunction::OPCODE_CALL:
+			case GDScriptFunction::OPCODE_CALL_RETURN:
+			case GDScriptFunction::OPCODE_CALL_ASYNC:
+				return instr_arg_count + 4;
+			default:
+				// Returns, awaits, jumps and iterations the compiler doesn't handle.
+				return 0;
+		}
+	}
+
+	// Emits the native code of one instruction. Everything is validated before any code is written,
+	// so returning false leaves nothing behind. r_next is the instruction that follows, or -1 after
+	// an unconditional jump.
+	bool _compile_instruction(int p_ip, int &r_next) {
+		const int ip = p_ip;
+		const int opcode = code[ip] & GDScriptFunction::INSTR_MASK;
+		const int instr_arg_count = (code[ip] & GDScriptFunction::INSTR_ARGS_MASK) >> GDScriptFunction::INSTR_BITS;
+
+#define JIT_SPACE(m_space)                   \
+	if (ip + (m_space) >= code_size) {       \
+		return false;                        \
+	}                                        \
+	r_next = ip + (m_space);
+#define JIT_OPERAND(m_name, m_code_ofs)                \
+	ASM::Memory m_name;                                \
+	if (!_get_operand(ip + (m_code_ofs), m_name)) {    \
+		return false;                                  \
+	}
+
+		switch (opcode) {
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT: {
+				bool jump = opcode == GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT;
+				JIT_SPACE(jump ? 6 : 5);
+				JIT_OPERAND(a, 1);
+				JIT_OPERAND(b, 2);
+				JIT_OPERAND(dst, 3);
+				int operator_idx = code[ip + 4];
+				if (operator_idx < 0 || operator_idx >= function->_operator_funcs_count) {
+					return false;
+				}
+				if (jump && !_is_jump_target(code[ip + 5])) {
+					return false;
+				}
+				_emit_operator(function->_operator_funcs_ptr[operator_idx], a, b, dst, jump ? code[ip + 5] : -1);
+			} break;
+			case GDScriptFunction::OPCODE_OPERATOR_INT_LOCAL:
+			case GDScriptFunction::OPCODE_OPERATOR_INT_LOCAL_JUMP_IF_NOT:
+			case GDScriptFunction::OPCODE_OPERATOR_FLOAT_LOCAL:
+			case GDScriptFunction::OPCODE_OPERATOR_FLOAT_LOCAL_JUMP_IF_NOT: {
+				bool jump = opcode == GDScriptFunction::OPCODE_OPERATOR_INT_LOCAL_JUMP_IF_NOT || opcode == GDScriptFunction::OPCODE_OPERATOR_FLOAT_LOCAL_JUMP_IF_NOT;
+				JIT_SPACE(jump ? 6 : 5);
+				JIT_OPERAND(a, 1);
+				JIT_OPERAND(b, 2);
+				JIT_OPERAND(dst, 3);
+				int op = code[ip + 4];
+				if (op < 0 || op >= Variant::OP_MAX) {
+					return false;
+				}
+				if (jump && !_is_jump_target(code[ip + 5])) {
+					return false;
+				}
+				// The same operations as the validated operators, which already have native versions.
+				Variant::Type type = (opcode == GDScriptFunction::OPCODE_OPERATOR_INT_LOCAL || opcode == GDScriptFunction::OPCODE_OPERATOR_INT_LOCAL_JUMP_IF_NOT) ? Variant::INT : Variant::FLOAT;
+				Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator(Variant::Operator(op), type, type);
+				if (!evaluator) {
+					return false;
+				}
+				_emit_operator(evaluator, a, b, dst, jump ? code[ip + 5] : -1);
+			} break;
+			case GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED:
+			case GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED: {
+				JIT_SPACE(5);
+				JIT_OPERAND(base, 1);
+				JIT_OPERAND(index, 2);
+				JIT_OPERAND(value, 3);
+				int accessor_idx = code[ip + 4];
+				const void *accessor = nullptr;
+				if (opcode == GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED) {
+					if (accessor_idx < 0 || accessor_idx >= function->_indexed_setters_count) {
+						return false;
+					}
+					accessor = (const void *)function->_indexed_setters_ptr[accessor_idx];
+				} else {
+					if (accessor_idx < 0 || accessor_idx >= function->_indexed_getters_count) {
+						return false;
+					}
+					accessor = (const void *)function->_indexed_getters_ptr[accessor_idx];
+				}
+				as.lea(ARGUMENT_REGISTERS[0], base);
+				as.mov(ARGUMENT_REGISTERS[1], index + VARIANT_DATA_OFFSET);
+				as.lea(ARGUMENT_REGISTERS[2], value);
+				as.lea(ARGUMENT_REGISTERS[3], ASM::Memory{ ASM::RSP, OOB_OFFSET });
+				_call(accessor);
+#ifdef DEBUG_ENABLED
+				// Out of bounds accesses don't change anything, the interpreter runs it again to report the error.
+				as.cmp_imm8(ASM::Memory{ ASM::RSP, OOB_OFFSET }, 0);
+				as.jcc(ASM::CC_NE, _exit_label(ip));
+#endif
+			} break;
+			case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED:
+			case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED: {
+				JIT_SPACE(4);
+				JIT_OPERAND(a, 1);
+				JIT_OPERAND(b, 2);
+				int accessor_idx = code[ip + 3];
+				const void *accessor = nullptr;
+				if (opcode == GDScriptFunction::OPCODE_SET_NAMED_VALIDATED) {
+					if (accessor_idx < 0 || accessor_idx >= function->_setters_count) {
+						return false;
+					}
+					accessor = (const void *)function->_setters_ptr[accessor_idx];
+				} else {
+					if (accessor_idx < 0 || accessor_idx >= function->_getters_count) {
+						return false;
+					}
+					accessor = (const void *)function->_getters_ptr[accessor_idx];
+				}
+				as.lea(ARGUMENT_REGISTERS[0], a);
+				as.lea(ARGUMENT_REGISTERS[1], b);
+				_call(accessor);
+			} break;
+			case GDScriptFunction::OPCODE_ASSIGN: {
+				JIT_SPACE(3);
+				JIT_OPERAND(dst, 1);
+				JIT_OPERAND(src, 2);
+				_emit_assign(dst, src);
+			} break;
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE: {
+				JIT_SPACE(2);
+				JIT_OPERAND(dst, 1);
+				_emit_assign_bool(dst, opcode == GDScriptFunction::OPCODE_ASSIGN_TRUE);
+			} break;
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+				JIT_SPACE(4);
+				JIT_OPERAND(dst, 1);
+				JIT_OPERAND(src, 2);
+				int var_type = code[ip + 3];
+				if (var_type < 0 || var_type >= Variant::VARIANT_MAX) {
+					return false;
+				}
+				int slow = as.create_label();
+				int done = as.create_label();
+				if (_is_trivial_type(var_type)) {
+					as.cmp_imm32(src + VARIANT_TYPE_OFFSET, var_type);
+					as.jcc(ASM::CC_NE, slow);
+					_require_trivial(dst, slow);
+					_copy_variant(dst, src);
+					as.jmp(done);
+				}
+				as.bind(slow);
+				as.lea(ARGUMENT_REGISTERS[0], dst);
+				as.lea(ARGUMENT_REGISTERS[1], src);
+				as.mov_imm32(ARGUMENT_REGISTERS[2], var_type);
+				_call((const void *)&_jit_assign_typed_builtin);
+				as.test8(ASM::RAX, ASM::RAX);
+				as.jcc(ASM::CC_E, _exit_label(ip));
+				as.bind(done);
+			} break;
+			case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED: {
+				JIT_SPACE(instr_arg_count + 3);
+				int argc = code[ip + instr_arg_count + 1];
+				int constructor_idx = code[ip + instr_arg_count + 2];
+				if (argc != instr_arg_count - 1 || constructor_idx < 0 || constructor_idx >= function->_constructors_count) {
+					return false;
+				}
+				JIT_OPERAND(dst, 1 + argc);
+				if (!_emit_argument_pointers(ip, argc)) {
+					return false;
+				}
+				as.lea(ARGUMENT_REGISTERS[0], dst);
+				as.lea(ARGUMENT_REGISTERS[1], ASM::Memory{ ASM::RSP, ARGUMENTS_OFFSET });
+				_call((const void *)function->_constructors_ptr[constructor_idx]);
+			} break;
+			case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED: {
+				JIT_SPACE(instr_arg_count + 3);
+				int argc = code[ip + instr_arg_count + 1];
+				int utility_idx = code[ip + instr_arg_count + 2];
+				if (argc != instr_arg_count - 1 || utility_idx < 0 || utility_idx >= function->_utilities_count) {
+					return false;
+				}
+				JIT_OPERAND(dst, 1 + argc);
+				if (!_emit_argument_pointers(ip, argc)) {
+					return false;
+				}
+				as.lea(ARGUMENT_REGISTERS[0], dst);
+				as.lea(ARGUMENT_REGISTERS[1], ASM::Memory{ ASM::RSP, ARGUMENTS_OFFSET });
+				as.mov_imm32(ARGUMENT_REGISTERS[2], argc);
+				_call((const void *)function->_utilities_ptr[utility_idx]);
+			} break;
+			case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED: {
+				JIT_SPACE(instr_arg_count + 3);
+				int argc = code[ip + instr_arg_count + 1];
+				int method_idx = code[ip + instr_arg_count + 2];
+				if (argc != instr_arg_count - 2 || method_idx < 0 || method_idx >= function->_builtin_methods_count) {
+					return false;
+				}
+				JIT_OPERAND(base, 1 + argc);
+				JIT_OPERAND(ret, 2 + argc);
+				if (!_emit_argument_pointers(ip, argc)) {
+					return false;
+				}
+				as.lea(ARGUMENT_REGISTERS[0], base);
+				as.lea(ARGUMENT_REGISTERS[1], ASM::Memory{ ASM::RSP, ARGUMENTS_OFFSET });
+				as.mov_imm32(ARGUMENT_REGISTERS[2], argc);
+				as.lea(ARGUMENT_REGISTERS[3], ret);
+				_call((const void *)function->_builtin_methods_ptr[method_idx]);
+			} break;
+			case GDScriptFunction::OPCODE_JUMP: {
+				if (ip + 2 > code_size || !_is_jump_target(code[ip + 1])) {
+					return false;
+				}
+				as.jmp(_label_for_ip(code[ip + 1]));
+				r_next = -1;
+			} break;
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+				JIT_SPACE(3);
+				JIT_OPERAND(test, 1);
+				if (!_is_jump_target(code[ip + 2])) {
+					return false;
+				}
+				_emit_jump_if(test, opcode == GDScriptFunction::OPCODE_JUMP_IF, code[ip + 2]);
+			} break;
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT: {
+				JIT_SPACE(5);
+				JIT_OPERAND(counter, 1);
+				JIT_OPERAND(container, 2);
+				JIT_OPERAND(iterator, 3);
+				if (!_is_jump_target(code[ip + 4])) {
+					return false;
+				}
+				as.mov(ASM::R15, container + VARIANT_DATA_OFFSET);
+				_emit_initialize_int(counter);
+				as.test(ASM::R15, ASM::R15);
+				as.jcc(ASM::CC_LE, _label_for_ip(code[ip + 4]));
+				_emit_initialize_int(iterator);
+			} break;
+			case GDScriptFunction::OPCODE_ITERATE_INT: {
+				JIT_SPACE(5);
+				JIT_OPERAND(counter, 1);
+				JIT_OPERAND(container, 2);
+				JIT_OPERAND(iterator, 3);
+				if (!_is_jump_target(code[ip + 4])) {
+					return false;
+				}
+				as.mov(ASM::RCX, container + VARIANT_DATA_OFFSET);
+				as.mov(ASM::RAX, counter + VARIANT_DATA_OFFSET);
+				as.add_imm8(ASM::RAX, 1);
+				as.mov(counter + VARIANT_DATA_OFFSET, ASM::RAX);
+				as.op_register(0, true, 0x39, ASM::RCX, ASM::RAX); // cmp rax, rcx
+				as.jcc(ASM::CC_GE, _label_for_ip(code[ip + 4]));
+				as.mov(iterator + VARIANT_DATA_OFFSET, ASM::RAX);
+			} break;
+			case GDScriptFunction::OPCODE_LINE: {
+				JIT_SPACE(2);
+				as.store_imm32(ASM::Memory{ ASM::R14, (int32_t)offsetof(GDScriptJITFrame, line) }, code[ip + 1]);
+			} break;
+			default: {
+				if (opcode >= GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL && opcode <= GDScriptFunction::OPCODE_TYPE_ADJUST_PACKED_COLOR_ARRAY) {
+					JIT_SPACE(2);
+					JIT_OPERAND(value, 1);
+					int type = opcode - GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL + Variant::BOOL;
+					int slow = as.create_label();
+					int done = as.create_label();
+					// Like VariantTypeChanger, packed arrays and objects are always reset.
+					if (type < Variant::PACKED_BYTE_ARRAY && type != Variant::OBJECT) {
+						as.cmp_imm32(value + VARIANT_TYPE_OFFSET, type);
+						as.jcc(ASM::CC_E, done);
+					}
+					if (_is_trivial_type(type)) {
+						_require_trivial(value, slow);
+						as.store_imm32(value + VARIANT_TYPE_OFFSET, type);
+						as.jmp(done);
+					}
+					as.bind(slow);
+					as.lea(ARGUMENT_REGISTERS[0], value);
+					as.mov_imm32(ARGUMENT_REGISTERS[1], type);
+					_call((const void *)&_jit_type_adjust);
+					as.bind(done);
+					break;
+				}
+				return false;
+			}
+		}
+
+#undef JIT_SPACE
+#undef JIT_OPERAND
+
+		return true;
+	}
+
+	// Compiles instructions in order from p_ip, until reaching one that is already compiled,
+	// an unconditional jump or an instruction left to the interpreter.
+	void _compile_from(int p_ip) {
+		int ip = p_ip;
+		while (true) {
+			int label = ip_labels[ip];
+			if (label != -1 && as.is_bound(label)) {
+				as.jmp(label);
+				return;
+			}
+			if (label == -1) {
+				label = as.create_label();
+				ip_labels[ip] = label;
+			}
+			as.bind(label);
+
+			int position = as.position();
+			int next = -1;
+			if (_compile_instruction(ip, next)) {
+				entries[ip] = position;
+				if (next == -1) {
+					return;
+				}
+				ip = next;
+				continue;
+			}
+
+			// Keep compiling after the instruction, so loops there still have native code to enter.
+			int size = _get_interpreted_size(ip);
+			if (size > 0 && ip + size < code_size) {
+				_label_for_ip(ip + size);
+			}
+			_emit_exit(ip);
+			return;
+		}
+	}
+
+public:
+	GDScriptJIT::Code *compile() {
+		ip_labels.resize(code_size);
+		entries.resize(code_size);
+		for (int i = 0; i < code_size; i++) {
+			ip_labels[i] = -1;
+			entries[i] = 0;
+		}
+
+		// Entry point: native code is called with the frame and the address to start at.
+		static const ASM::Register saved_registers[] = { ASM::RBP, ASM::RBX, ASM::R12, ASM::R13, ASM::R14, ASM::R15, ASM::RSI, ASM::RDI };
+		for (ASM::Register reg : saved_registers) {
+			as.push(reg);
+		}
+		as.sub_rsp(FRAME_SIZE);
+		as.mov(ASM::R14, ARGUMENT_REGISTERS[0]);
+		as.mov(ASM::RBX, ASM::Memory{ ASM::R14, (int32_t)offsetof(GDScriptJITFrame, stack) });
+		as.mov(ASM::R12, ASM::Memory{ ASM::R14, (int32_t)offsetof(GDScriptJITFrame, constants) });
+		as.mov(ASM::R13, ASM::Memory{ ASM::R14, (int32_t)offsetof(GDScriptJITFrame, members) });
+		as.jmp(ARGUMENT_REGISTERS[1]);
+
+		// Every exit returns the instruction the interpreter continues with in eax.
+		epilogue = as.create_label();
+		as.bind(epilogue);
+		as.add_rsp(FRAME_SIZE);
+		for (int i = (int)(sizeof(saved_registers) / sizeof(saved_registers[0])) - 1; i >= 0; i--) {
+			as.pop(saved_registers[i]);
+		}
+		as.ret();
+
+		_label_for_ip(0);
+		for (int i = 0; i < function->default_arguments.size(); i++) {
+			if (_is_jump_target(function->default_arguments[i])) {
+				_label_for_ip(function->default_arguments[i]);
+			}
+		}
+
+		while (!worklist.is_empty()) {
+			int ip = worklist[worklist.size() - 1];
+			worklist.resize(worklist.size() - 1);
+			if (!as.is_bound(ip_labels[ip])) {
+				_compile_from(ip);
+			}
+		}
+
+		for (uint32_t i = 0; i < exits.size(); i++) {
+			as.bind(exits[i].label);
+			_emit_exit(exits[i].ip);
+		}
+
+		as.finalize();
+
+		bool has_entries = false;
+		for (uint32_t i = 0; i < entries.size(); i++) {
+			if (entries[i]) {
+				has_entries = true;
+				break;
+			}
+		}
+		if (!has_entries) {
+			return nullptr;
+		}
+
+		const LocalVector<uint8_t> &machine_code = as.get_code();
+		size_t memory_size = 0;
+		uint8_t *memory = nullptr;
+
+#ifdef WINDOWS_ENABLED
+		memory_size = machine_code.size();
+		memory = (uint8_t *)VirtualAlloc(nullptr, memory_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+		if (!memory) {
+			return nullptr;
+		}
+		memcpy(memory, machine_code.ptr(), machine_code.size());
+		DWORD old_protect;
+		if (!VirtualProtect(memory, memory_size, PAGE_EXECUTE_READ, &old_protect)) {
+			VirtualFree(memory, 0, MEM_RELEASE);
+			return nullptr;
+		}
+		FlushInstructionCache(GetCurrentProcess(), memory, memory_size);
+#else
+		size_t page_size = sysconf(_SC_PAGESIZE);
+		memory_size = (machine_code.size() + page_size - 1) / page_size * page_size;
+		void *mapped = mmap(nullptr, memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mapped == MAP_FAILED) {
+			return nullptr;
+		}
+		memory = (uint8_t *)mapped;
+		memcpy(memory, machine_code.ptr(), machine_code.size());
+		// Never writable and executable at the same time.
+		if (mprotect(memory, memory_size, PROT_READ | PROT_EXEC) != 0) {
+			munmap(memory, memory_size);
+			return nullptr;
+		}
+#endif
+
+		GDScriptJIT::Code *jit_code = memnew(GDScriptJIT::Code);
+		jit_code->memory = memory;
+		jit_code->memory_size = memory_size;
+		jit_code->entries = entries;
+		jit_code->constants = function->_constants_ptr;
+		jit_code->uses_members = uses_members;
+		return jit_code;
+	}
+
+	GDScriptJITCompiler(const GDScriptFunction *p_function) {
+		function = p_function;
+		code = p_function->_code_ptr;
+		code_size = p_function->_code_size;
+	}
+};
+
+#endif // GDSCRIPT_JIT_ENABLED
+
+bool GDScriptJIT::is_supported() {
+#ifdef GDSCRIPT_JIT_ENABLED
+	static int supported = -1;
+	if (supported == -1) {
+		// Check the variant layout native code relies on.
+		Variant value = 1;
+		supported = sizeof(Variant::Type) == 4 && sizeof(Variant) % 8 == 0 &&
+				*(const uint32_t *)((const uint8_t *)&value + VARIANT_TYPE_OFFSET) == Variant::INT &&
+				(const uint8_t *)VariantInternal::get_int(&value) - (const uint8_t *)&value == VARIANT_DATA_OFFSET;
+	}
+	return supported;
+#else
+	return false;
+#endif
+}
+
+GDScriptJIT::Code *GDScriptJIT::compile(const GDScriptFunction *p_function) {
+#ifdef GDSCRIPT_JIT_ENABLED
+	if (!is_supported() || p_function->_code_size == 0) {
+		return nullptr;
+	}
+	GDScriptJITCompiler compiler(p_function);
+	return compiler.compile();
+#else
+	return nullptr;
+#endif
+}
+
+const GDScriptJIT::Code *GDScriptJIT::get_code(GDScriptFunction *p_function) {
+#ifdef GDSCRIPT_JIT_ENABLED
+	if (p_function->jit_compiled.is_set()) {
+		return p_function->jit_code;
+	}
+	if (p_function->jit_hotness.increment() < hot_threshold) {
+		return nullptr;
+	}
+
+	MutexLock lock(mutex);
+	if (!p_function->jit_compiled.is_set()) {
+		// Functions that can't be compiled stay interpreted, without trying again.
+		p_function->jit_code = compile(p_function);
+		p_function->jit_compiled.set();
+	}
+	return p_function->jit_code;
+#else
+	return nullptr;
+#endif
+}
+
+int GDScriptJIT::run(const Code *p_code, int p_ip, Variant *p_stack, Variant *p_members, int &r_line) {
+#ifdef GDSCRIPT_JIT_ENABLED
+	if (p_ip < 0 || p_ip >= (int)p_code->entries.size() || p_code->entries[p_ip] == 0) {
+		return p_ip;
+	}
+	if (p_code->uses_members && !p_members) {
+		return p_ip;
+	}
+
+	GDScriptJITFrame frame;
+	frame.stack = p_stack;
+	frame.constants = p_code->constants;
+	frame.members = p_members;
+	frame.line = r_line;
+
+	GDScriptJITEntry entry = reinterpret_cast<GDScriptJITEntry>(p_code->memory);
+	int ip = entry(&frame, p_code->memory + p_code->entries[p_ip]);
+
+	r_line = frame.line;
+	return ip;
+#else
+	return p_ip;
+#endif
+}
+
+Variant GDScriptJIT::verify_call(GDScriptFunction *p_function, GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err) {
+	// Functions called from here run once, in the same way as their caller.
+	verify_pass = VERIFY_PASS_INTERPRETED;
+	Callable::CallError interpreted_err;
+	Variant interpreted = p_function->call(p_instance, p_args, p_argcount, interpreted_err);
+
+	verify_pass = VERIFY_PASS_COMPILED;
+	Variant compiled = p_function->call(p_instance, p_args, p_argcount, r_err);
+	verify_pass = VERIFY_PASS_NONE;
+
+	// Objects created by each run are different instances, only compare their type.
+	bool same = interpreted_err.error == r_err.error && interpreted.get_type() == compiled.get_type();
+	if (same && compiled.get_type() != Variant::OBJECT) {
+		same = interpreted.hash_compare(compiled);
+	}
+	if (!same) {
+		verify_mismatches.increment();
+		ERR_PRINT(vformat("GDScript JIT: Function \"%s\" returned %s when compiled, but %s when interpreted.", p_function->get_name(), compiled.get_construct_string(), interpreted.get_construct_string()));
+	}
+	return compiled;
+}
+
+void GDScriptJIT::free_code(Code *p_code) {
+	if (!p_code) {
+		return;
+	}
+#ifdef GDSCRIPT_JIT_ENABLED
+#ifdef WINDOWS_ENABLED
+	VirtualFree(p_code->memory, 0, MEM_RELEASE);
+#else
+	munmap(p_code->memory, p_code->memory_size);
+#endif
+#endif
+	memdelete(p_code);
+}
@@ -0,0 +1,97 @@
+/*************************************************************************/
+/*  gdscript_jit.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_JIT_H
+#define GDSCRIPT_JIT_H
+
+#include "core/os/mutex.h"
+#include "core/templates/safe_refcount.h"
+#include "core/variant/variant.h"
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(UNIX_ENABLED) || defined(WINDOWS_ENABLED))
+#define GDSCRIPT_JIT_ENABLED
+#endif
+
+class GDScriptFunction;
+class GDScriptInstance;
+
+// Baseline compiler from GDScript byte code to x86-64 machine code.
+//
+// A function is compiled once it has been called or looped enough times. Typed operators,
+// assignments, jumps, integer loops and validated calls become native code, every other
+// instruction is left to the interpreter: native code returns to the VM before it, and the VM
+// enters native code again at the next instruction. The VM only runs native code when no
+// debugger is attached and the profiler is off, so breakpoints and timings stay exact.
+class GDScriptJIT {
+public:
+	class Code;
+
+private:
+	enum VerifyPass {
+		VERIFY_PASS_NONE,
+		VERIFY_PASS_INTERPRETED,
+		VERIFY_PASS_COMPILED,
+	};
+
+	static bool enabled;
+	static bool verify;
+	static uint32_t hot_threshold;
+	static SafeNumeric<uint64_t> verify_mismatches;
+	static Mutex mutex;
+	static thread_local VerifyPass verify_pass;
+
+	static Code *compile(const GDScriptFunction *p_function);
+
+public:
+	static bool is_supported();
+
+	static void set_enabled(bool p_enabled) { enabled = p_enabled && is_supported(); }
+	static bool is_enabled() { return enabled; }
+	// Number of calls and backward jumps before a function is compiled.
+	static void set_hot_threshold(uint32_t p_threshold) { hot_threshold = p_threshold; }
+	static uint32_t get_hot_threshold() { return hot_threshold; }
+	// Runs every function both interpreted and compiled and reports different results.
+	// Functions run twice, so this is only meant for testing code without side effects.
+	static void set_verify(bool p_verify) { verify = p_verify; }
+	static bool is_verify_enabled() { return verify; }
+	static uint64_t get_verify_mismatches() { return verify_mismatches.get(); }
+
+	_FORCE_INLINE_ static bool can_run() { return enabled && verify_pass != VERIFY_PASS_INTERPRETED; }
+	_FORCE_INLINE_ static bool should_verify() { return enabled && verify && verify_pass == VERIFY_PASS_NONE; }
+
+	// Counts a call or loop iteration, and returns the native code once the function got hot.
+	static const Code *get_code(GDScriptFunction *p_function);
+	// Runs native code from the instruction at p_ip, returns the instruction the interpreter continues with.
+	static int run(const Code *p_code, int p_ip, Variant *p_stack, Variant *p_members, int &r_line);
+	static Variant verify_call(GDScriptFunction *p_function, GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err);
+	static void free_code(Code *p_code);
+};
+
+#endif // GDSCRIPT_JIT_H
@@ -195,6 +195,26 @@ void GDScriptParser::clear() {
 	for_completion = false;
 	errors.clear();
 	multiline_stack.clear();
+	dependency_paths.clear();
+	dependency_classes.clear();
+}
+
+const List<String> GDScriptParser::get_dependencies() const {
+	List<String> dependencies;
+	for (const Set<String>::Element *E = dependency_paths.front(); E; E = E->next()) {
+		String path = E->get();
+		if (path.is_rel_path()) {
+			path = script_path.get_base_dir().plus_file(path);
+		}
+		dependencies.push_back(path.simplify_path());
+	}
+	// Only global classes can be resolved without analyzing the script.
+	for (const Set<StringName>::Element *E = dependency_classes.front(); E; E = E->next()) {
+		if (ScriptServer::is_global_class(E->get())) {
+			dependencies.push_back(ScriptServer::get_global_class_path(E->get()));
+		}
+	}
+	return dependencies;
 }
 
 void GDScriptParser::push_error(const String &p_message, const Node *p_origin) {
@@ -697,6 +717,7 @@ void GDScriptParser::parse_extends() {
 			push_error(vformat(R"(Only strings or identifiers can be used after "extends", found "%s" instead.)", Variant::get_type_name(previous.literal.get_type())));
 		}
 		current_class->extends_path = previous.literal;
+		dependency_paths.insert(current_class->extends_path);
 
 		if (!match(GDScriptTokenizer::Token::PERIOD)) {
 			return;
@@ -709,6 +730,9 @@ void GDScriptParser::parse_extends() {
 		return;
 	}
 	current_class->extends.push_back(previous.literal);
+	if (current_class->extends.size() == 1 && current_class->extends_path.is_empty()) {
+		dependency_classes.insert(previous.literal);
+	}
 
 	while (match(GDScriptTokenizer::Token::PERIOD)) {
 		make_completion_context(COMPLETION_INHERIT_TYPE, current_class, chain_index++);
@@ -2722,6 +2746,8 @@ GDScriptParser::ExpressionNode *GDScriptParser::parse_preload(ExpressionNode *p_
 
 	if (preload->path == nullptr) {
 		push_error(R"(Expected resource path after "(".)");
+	} else if (preload->path->type == Node::LITERAL && static_cast<LiteralNode *>(preload->path)->value.get_type() == Variant::STRING) {
+		dependency_paths.insert(static_cast<LiteralNode *>(preload->path)->value);
 	}
 
 	pop_completion_call();
@@ -2826,6 +2852,7 @@ GDScriptParser::TypeNode *GDScriptParser::parse_type(bool p_allow_void) {
 	IdentifierNode *type_element = parse_identifier();
 
 	type->type_chain.push_back(type_element);
+	dependency_classes.insert(type_element->name);
 
 	if (match(GDScriptTokenizer::Token::BRACKET_OPEN)) {
 		// Typed collection (like Array[int]).
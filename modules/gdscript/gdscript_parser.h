@@ -1197,6 +1197,9 @@ private:
 	ClassNode *head = nullptr;
 	Node *list = nullptr;
 	List<ParserError> errors;
+	// Literal paths of extends and preload, and class names used as base or type, see get_dependencies().
+	Set<String> dependency_paths;
+	Set<StringName> dependency_classes;
 #ifdef DEBUG_ENABLED
 	List<GDScriptWarning> warnings;
 	Set<String> ignored_warnings;
@@ -1405,10 +1408,7 @@ public:
 	void get_annotation_list(List<MethodInfo> *r_annotations) const;
 
 	const List<ParserError> &get_errors() const { return errors; }
-	const List<String> get_dependencies() const {
-		// TODO: Keep track of deps.
-		return List<String>();
-	}
+	const List<String> get_dependencies() const;
 #ifdef DEBUG_ENABLED
 	const List<GDScriptWarning> &get_warnings() const { return warnings; }
 	const Set<int> &get_unsafe_lines() const { return unsafe_lines; }
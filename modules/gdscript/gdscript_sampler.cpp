@@ -0,0 +1,129 @@
+/*************************************************************************/
+/*  gdscript_sampler.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_sampler.h"
+
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/templates/local_vector.h"
+#include "gdscript_function.h"
+
+SafeFlag GDScriptSampler::active;
+uint32_t GDScriptSampler::interval_usec = 1000;
+SafeNumeric<uint32_t> GDScriptSampler::ticks;
+SafeFlag GDScriptSampler::exit_thread;
+Thread GDScriptSampler::thread;
+Mutex GDScriptSampler::mutex;
+HashMap<String, uint64_t> GDScriptSampler::stacks;
+uint64_t GDScriptSampler::sample_count = 0;
+
+thread_local GDScriptSampler::Frame *GDScriptSampler::current_frame = nullptr;
+thread_local uint32_t GDScriptSampler::last_tick = 0;
+
+void GDScriptSampler::_thread_func(void *p_userdata) {
+	while (!exit_thread.is_set()) {
+		OS::get_singleton()->delay_usec(interval_usec);
+		ticks.increment();
+	}
+}
+
+void GDScriptSampler::_take_sample(uint32_t p_weight) {
+	if (!current_frame) {
+		return;
+	}
+
+	LocalVector<String> frames;
+	for (const Frame *frame = current_frame; frame; frame = frame->caller) {
+		String path = frame->function->get_source();
+		frames.push_back((path.is_empty() ? String("built-in") : path) + ":" + String(frame->function->get_name()) + ":" + itos(*frame->line));
+	}
+
+	String stack = frames[frames.size() - 1];
+	for (int i = int(frames.size()) - 2; i >= 0; i--) {
+		stack += ";" + frames[i];
+	}
+
+	MutexLock lock(mutex);
+	stacks[stack] += p_weight;
+	sample_count += p_weight;
+}
+
+void GDScriptSampler::start(uint32_t p_interval_usec) {
+	ERR_FAIL_COND(p_interval_usec == 0);
+	if (active.is_set()) {
+		return;
+	}
+
+	interval_usec = p_interval_usec;
+	exit_thread.clear();
+	thread.start(_thread_func, nullptr);
+	active.set();
+}
+
+void GDScriptSampler::stop() {
+	if (!active.is_set()) {
+		return;
+	}
+
+	active.clear();
+	exit_thread.set();
+	thread.wait_to_finish();
+}
+
+void GDScriptSampler::clear() {
+	MutexLock lock(mutex);
+	stacks.clear();
+	sample_count = 0;
+}
+
+uint64_t GDScriptSampler::get_sample_count() {
+	MutexLock lock(mutex);
+	return sample_count;
+}
+
+String GDScriptSampler::get_folded_stacks() {
+	MutexLock lock(mutex);
+
+	String folded;
+	const String *key = nullptr;
+	while ((key = stacks.next(key))) {
+		folded += *key + " " + itos(stacks[*key]) + "\n";
+	}
+	return folded;
+}
+
+Error GDScriptSampler::save_folded_stacks(const String &p_path) {
+	Error err;
+	FileAccessRef file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot save GDScript samples to '" + p_path + "'.");
+
+	file->store_string(get_folded_stacks());
+	return OK;
+}
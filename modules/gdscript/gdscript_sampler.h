@@ -0,0 +1,111 @@
+/*************************************************************************/
+/*  gdscript_sampler.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLER_H
+#define GDSCRIPT_SAMPLER_H
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/string/ustring.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/safe_refcount.h"
+
+class GDScriptFunction;
+
+// Sampling profiler for GDScript.
+//
+// A timer thread ticks at a fixed interval, and each thread running GDScript samples its own call
+// stack at the next line it reaches after a tick, weighted by the number of ticks since its last
+// sample. Sampling on the running thread keeps the stack safe to read without suspending anything,
+// and time spent in native code is attributed to the script line that called it. Stacks are
+// aggregated as folded stacks, the format flame graph tools read: one line per distinct stack,
+// with frames from the outermost call separated by ';' and followed by the sample count.
+class GDScriptSampler {
+public:
+	// Pushed by every function call while sampling, lives on the stack of GDScriptFunction::call().
+	struct Frame {
+		const GDScriptFunction *function = nullptr;
+		const int *line = nullptr;
+		Frame *caller = nullptr;
+	};
+
+private:
+	static SafeFlag active; // Read by every thread running scripts.
+	static uint32_t interval_usec;
+	static SafeNumeric<uint32_t> ticks;
+	static SafeFlag exit_thread;
+	static Thread thread;
+	static Mutex mutex;
+	static HashMap<String, uint64_t> stacks;
+	static uint64_t sample_count;
+
+	static thread_local Frame *current_frame;
+	static thread_local uint32_t last_tick;
+
+	static void _thread_func(void *p_userdata);
+	static void _take_sample(uint32_t p_weight);
+
+public:
+	static void start(uint32_t p_interval_usec = 1000);
+	static void stop();
+	_FORCE_INLINE_ static bool is_active() { return active.is_set(); }
+
+	static void clear();
+	static uint64_t get_sample_count();
+	// One "path:function:line;...;path:function:line count" line per distinct stack.
+	static String get_folded_stacks();
+	static Error save_folded_stacks(const String &p_path);
+
+	_FORCE_INLINE_ static void enter(Frame *p_frame, const GDScriptFunction *p_function, const int *p_line) {
+		p_frame->function = p_function;
+		p_frame->line = p_line;
+		p_frame->caller = current_frame;
+		if (!current_frame) {
+			// Time spent outside of scripts isn't sampled.
+			last_tick = ticks.get();
+		}
+		current_frame = p_frame;
+	}
+
+	_FORCE_INLINE_ static void poll() {
+		uint32_t tick = ticks.get();
+		if (unlikely(tick != last_tick)) {
+			_take_sample(tick - last_tick);
+			last_tick = tick;
+		}
+	}
+
+	_FORCE_INLINE_ static void exit(Frame *p_frame) {
+		poll();
+		current_frame = p_frame->caller;
+	}
+};
+
+#endif // GDSCRIPT_SAMPLER_H
@@ -30,10 +30,14 @@
 
 #include "gdscript_function.h"
 
+#include "core/config/engine.h"
 #include "core/core_string_names.h"
+#include "core/object/class_db.h"
 #include "core/os/os.h"
+#include "core/os/spin_lock.h"
 #include "gdscript.h"
 #include "gdscript_lambda_callable.h"
+#include "gdscript_sampler.h"
 
 Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_instance, Variant *p_stack, String &r_error) const {
 	int address = p_address & ADDR_MASK;
@@ -68,6 +72,22 @@ Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_insta
 	return nullptr;
 }
 
+// Operands of the local operator instructions are only ever on the stack or constants.
+Variant *GDScriptFunction::_get_local_operand(int p_address, Variant *p_stack) const {
+	int address = p_address & ADDR_MASK;
+	if ((p_address & ADDR_TYPE_MASK) == (ADDR_TYPE_CONSTANT << ADDR_BITS)) {
+#ifdef DEBUG_ENABLED
+		ERR_FAIL_INDEX_V(address, _constant_count, nullptr);
+#endif
+		return &_constants_ptr[address];
+	}
+#ifdef DEBUG_ENABLED
+	ERR_FAIL_COND_V_MSG((p_address & ADDR_TYPE_MASK) != (ADDR_TYPE_STACK << ADDR_BITS), nullptr, "Bad code! (local operand outside of the stack).");
+	ERR_FAIL_INDEX_V(address, _stack_size, nullptr);
+#endif
+	return &p_stack[address];
+}
+
 #ifdef DEBUG_ENABLED
 static String _get_script_name(const Ref<Script> p_script) {
 	Ref<GDScript> gdscript = p_script;
@@ -152,6 +172,241 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 	return err_text;
 }
 
+template <class T>
+static _FORCE_INLINE_ void _copy_value(Variant *p_dst, const Variant *p_src) {
+	VariantTypeChanger<T>::change(p_dst);
+	*VariantGetInternalPtr<T>::get_ptr(p_dst) = *VariantGetInternalPtr<T>::get_ptr(p_src);
+}
+
+// Copies a value of the given type. Values of the types the VM accesses in place in typed arrays
+// only have their data copied, without the generic assignment.
+static _FORCE_INLINE_ void _copy_direct_value(Variant::Type p_type, Variant *p_dst, const Variant *p_src) {
+	switch (p_type) {
+		case Variant::BOOL:
+			_copy_value<bool>(p_dst, p_src);
+			break;
+		case Variant::INT:
+			_copy_value<int64_t>(p_dst, p_src);
+			break;
+		case Variant::FLOAT:
+			_copy_value<double>(p_dst, p_src);
+			break;
+		case Variant::VECTOR2:
+			_copy_value<Vector2>(p_dst, p_src);
+			break;
+		case Variant::VECTOR2I:
+			_copy_value<Vector2i>(p_dst, p_src);
+			break;
+		case Variant::RECT2:
+			_copy_value<Rect2>(p_dst, p_src);
+			break;
+		case Variant::RECT2I:
+			_copy_value<Rect2i>(p_dst, p_src);
+			break;
+		case Variant::VECTOR3:
+			_copy_value<Vector3>(p_dst, p_src);
+			break;
+		case Variant::VECTOR3I:
+			_copy_value<Vector3i>(p_dst, p_src);
+			break;
+		case Variant::PLANE:
+			_copy_value<Plane>(p_dst, p_src);
+			break;
+		case Variant::QUAT:
+			_copy_value<Quat>(p_dst, p_src);
+			break;
+		case Variant::COLOR:
+			_copy_value<Color>(p_dst, p_src);
+			break;
+		default:
+			*p_dst = *p_src;
+			break;
+	}
+}
+
+template <class T>
+static _FORCE_INLINE_ bool _compare_local(int p_operator, T p_a, T p_b) {
+	switch (p_operator) {
+		case Variant::OP_EQUAL:
+			return p_a == p_b;
+		case Variant::OP_NOT_EQUAL:
+			return p_a != p_b;
+		case Variant::OP_LESS:
+			return p_a < p_b;
+		case Variant::OP_LESS_EQUAL:
+			return p_a <= p_b;
+		case Variant::OP_GREATER:
+			return p_a > p_b;
+		default:
+			return p_a >= p_b;
+	}
+}
+
+static SpinLock inline_cache_lock;
+
+GDScriptFunction::InlineCache::Entry *GDScriptFunction::_get_inline_cache_entry(InlineCache *p_cache, InlineCache::Access p_access, const Variant *p_base, const StringName &p_name, Object *&r_object, GDScriptInstance *&r_instance, bool &r_hit) {
+	r_object = nullptr;
+	r_instance = nullptr;
+	r_hit = false;
+
+	Variant::Type type = p_base->get_type();
+	const GDScript *script = nullptr;
+	const StringName *class_name = nullptr;
+
+	if (type == Variant::OBJECT) {
+		r_object = p_base->get_validated_object();
+		if (!r_object) {
+			return nullptr;
+		}
+		ScriptInstance *script_instance = r_object->get_script_instance();
+		if (script_instance) {
+			// Other languages may resolve names in any way, leave them to the regular lookup.
+			if (script_instance->get_language() != GDScriptLanguage::get_singleton() || script_instance->is_placeholder()) {
+				return nullptr;
+			}
+			r_instance = static_cast<GDScriptInstance *>(script_instance);
+			script = r_instance->script.ptr();
+		}
+		class_name = &r_object->get_class_name();
+	} else if (p_access == InlineCache::ACCESS_CALL) {
+		return nullptr; // Built-in methods are resolved at compile time when the type is known, don't bother.
+	}
+
+	uint32_t generation = direct_call_generation.get();
+	for (int i = 0; i < InlineCache::MAX_ENTRIES; i++) {
+		InlineCache::Entry *entry = &p_cache->entries[i];
+		if (entry->generation.get() == generation && entry->type == type && entry->script == script && entry->class_name == class_name) {
+			r_hit = true;
+			return entry;
+		}
+	}
+
+	// Resolve the name like Variant::get_named(), Variant::set_named() and Variant::call() do,
+	// giving up on anything that could end up somewhere else for another receiver of the same class.
+	InlineCache::Kind kind = InlineCache::KIND_NATIVE;
+	Variant::ValidatedGetter getter = nullptr;
+	Variant::ValidatedSetter setter = nullptr;
+	Variant::Type value_type = Variant::VARIANT_MAX;
+	MethodBind *method = nullptr;
+	int index = -1;
+	GDScriptFunction *function = nullptr;
+
+	if (type != Variant::OBJECT) {
+		kind = InlineCache::KIND_BUILTIN;
+		if (p_access == InlineCache::ACCESS_GET) {
+			getter = Variant::get_member_validated_getter(type, p_name);
+			if (!getter) {
+				return nullptr;
+			}
+		} else {
+			setter = Variant::get_member_validated_setter(type, p_name);
+			if (!setter) {
+				return nullptr;
+			}
+			value_type = Variant::get_member_type(type, p_name);
+		}
+	} else {
+		if (script && p_access != InlineCache::ACCESS_CALL) {
+			const Map<StringName, GDScript::MemberInfo>::Element *E = script->member_indices.find(p_name);
+			if (E) {
+				const GDScript::MemberInfo &member = E->get();
+				if (p_access == InlineCache::ACCESS_GET ? member.getter != StringName() : member.setter != StringName()) {
+					return nullptr;
+				}
+				if (p_access == InlineCache::ACCESS_SET && member.data_type.has_type) {
+					// Only exact types are cached, anything needing a conversion or check takes the regular path.
+					if (member.data_type.kind != GDScriptDataType::BUILTIN || (member.data_type.builtin_type == Variant::ARRAY && member.data_type.has_container_element_type())) {
+						return nullptr;
+					}
+					value_type = member.data_type.builtin_type;
+				}
+				kind = InlineCache::KIND_MEMBER;
+				index = member.index;
+			}
+		}
+
+		if (script && kind != InlineCache::KIND_MEMBER) {
+			const StringName &get_name = GDScriptLanguage::get_singleton()->strings._get;
+			const StringName &set_name = GDScriptLanguage::get_singleton()->strings._set;
+			for (const GDScript *gds = script; gds; gds = gds->_base) {
+				if (p_access == InlineCache::ACCESS_CALL) {
+					const Map<StringName, GDScriptFunction *>::Element *E = gds->member_functions.find(p_name);
+					if (E) {
+						kind = InlineCache::KIND_FUNCTION;
+						function = E->get();
+						break;
+					}
+				} else if (p_access == InlineCache::ACCESS_GET) {
+					if (gds->constants.has(p_name) || gds->_signals.has(p_name) || gds->member_functions.has(p_name) || gds->member_functions.has(get_name)) {
+						return nullptr;
+					}
+				} else if (gds->member_functions.has(set_name)) {
+					return nullptr;
+				}
+			}
+		}
+
+		if (kind == InlineCache::KIND_NATIVE) {
+			StringName method_name = p_name;
+			if (p_access == InlineCache::ACCESS_CALL) {
+				if (p_name == CoreStringNames::get_singleton()->_free) {
+					return nullptr;
+				}
+			} else {
+#ifdef TOOLS_ENABLED
+				if (p_access == InlineCache::ACCESS_SET && Engine::get_singleton()->is_editor_hint()) {
+					return nullptr; // Object::set() also marks the object as edited.
+				}
+#endif
+				method_name = p_access == InlineCache::ACCESS_GET ? ClassDB::get_property_getter(*class_name, p_name) : ClassDB::get_property_setter(*class_name, p_name);
+				if (method_name == StringName()) {
+					return nullptr;
+				}
+				// Accessors without a method pointer are called by name, so scripts could override them.
+				if (script) {
+					for (const GDScript *gds = script; gds; gds = gds->_base) {
+						if (gds->member_functions.has(method_name)) {
+							return nullptr;
+						}
+					}
+				}
+				index = ClassDB::get_property_index(*class_name, p_name);
+			}
+			method = ClassDB::get_method(*class_name, method_name);
+			if (!method) {
+				return nullptr;
+			}
+		}
+	}
+
+	InlineCache::Entry *entry = nullptr;
+
+	inline_cache_lock.lock();
+	for (int i = 0; i < InlineCache::MAX_ENTRIES; i++) {
+		if (p_cache->entries[i].generation.get() != generation) {
+			entry = &p_cache->entries[i];
+			break;
+		}
+	}
+	if (entry) {
+		entry->type = type;
+		entry->script = script;
+		entry->class_name = class_name;
+		entry->kind = kind;
+		entry->getter = getter;
+		entry->setter = setter;
+		entry->value_type = value_type;
+		entry->method = method;
+		entry->index = index;
+		entry->function = function;
+		entry->generation.set(generation);
+	}
+	inline_cache_lock.unlock();
+
+	// Without a free entry the site is megamorphic, the caller falls back to the regular lookup.
+	return entry;
+}
+
 void (*type_init_function_table[])(Variant *) = {
 	nullptr, // NIL (shouldn't be called).
 	&VariantInitializer<bool>::init, // BOOL.
@@ -195,6 +450,11 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {        \
 		&&OPCODE_OPERATOR,                           \
 		&&OPCODE_OPERATOR_VALIDATED,                 \
+		&&OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT,     \
+		&&OPCODE_OPERATOR_INT_LOCAL,                 \
+		&&OPCODE_OPERATOR_INT_LOCAL_JUMP_IF_NOT,     \
+		&&OPCODE_OPERATOR_FLOAT_LOCAL,               \
+		&&OPCODE_OPERATOR_FLOAT_LOCAL_JUMP_IF_NOT,   \
 		&&OPCODE_EXTENDS_TEST,                       \
 		&&OPCODE_IS_BUILTIN,                         \
 		&&OPCODE_SET_KEYED,                          \
@@ -203,6 +463,8 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_GET_KEYED,                          \
 		&&OPCODE_GET_KEYED_VALIDATED,                \
 		&&OPCODE_GET_INDEXED_VALIDATED,              \
+		&&OPCODE_SET_INDEXED_TYPED_ARRAY,            \
+		&&OPCODE_GET_INDEXED_TYPED_ARRAY,            \
 		&&OPCODE_SET_NAMED,                          \
 		&&OPCODE_SET_NAMED_VALIDATED,                \
 		&&OPCODE_GET_NAMED,                          \
@@ -232,6 +494,8 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_CALL_GDSCRIPT_UTILITY,              \
 		&&OPCODE_CALL_BUILTIN_TYPE_VALIDATED,        \
 		&&OPCODE_CALL_SELF_BASE,                     \
+		&&OPCODE_CALL_SCRIPT_FUNCTION,               \
+		&&OPCODE_CALL_SCRIPT_FUNCTION_RETURN,        \
 		&&OPCODE_CALL_METHOD_BIND,                   \
 		&&OPCODE_CALL_METHOD_BIND_RET,               \
 		&&OPCODE_CALL_BUILTIN_STATIC,                \
@@ -292,6 +556,7 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_ITERATE_BEGIN_STRING,               \
 		&&OPCODE_ITERATE_BEGIN_DICTIONARY,           \
 		&&OPCODE_ITERATE_BEGIN_ARRAY,                \
+		&&OPCODE_ITERATE_BEGIN_TYPED_ARRAY,          \
 		&&OPCODE_ITERATE_BEGIN_PACKED_BYTE_ARRAY,    \
 		&&OPCODE_ITERATE_BEGIN_PACKED_INT32_ARRAY,   \
 		&&OPCODE_ITERATE_BEGIN_PACKED_INT64_ARRAY,   \
@@ -312,6 +577,7 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_ITERATE_STRING,                     \
 		&&OPCODE_ITERATE_DICTIONARY,                 \
 		&&OPCODE_ITERATE_ARRAY,                      \
+		&&OPCODE_ITERATE_TYPED_ARRAY,                \
 		&&OPCODE_ITERATE_PACKED_BYTE_ARRAY,          \
 		&&OPCODE_ITERATE_PACKED_INT32_ARRAY,         \
 		&&OPCODE_ITERATE_PACKED_INT64_ARRAY,         \
@@ -430,6 +696,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		return Variant();
 	}
 
+#ifdef GDSCRIPT_JIT_ENABLED
+	if (unlikely(GDScriptJIT::should_verify()) && !p_state) {
+		return GDScriptJIT::verify_call(this, p_instance, p_args, p_argcount, r_err);
+	}
+#endif
+
 	r_err.error = Callable::CallError::CALL_OK;
 
 	Variant retvalue;
@@ -451,11 +723,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	if (p_state) {
 		//use existing (supplied) state (awaited)
-		stack = (Variant *)p_state->stack.ptr();
-		instruction_args = (Variant **)&p_state->stack.ptr()[sizeof(Variant) * p_state->stack_size]; //ptr() to avoid bounds check
+		stack = (Variant *)p_state->stack;
+		instruction_args = (Variant **)&p_state->stack[sizeof(Variant) * p_state->stack_size];
 		line = p_state->line;
 		ip = p_state->ip;
-		alloca_size = p_state->stack.size();
+		alloca_size = p_state->alloca_size;
 		script = p_state->script;
 		p_instance = p_state->instance;
 		defarg = p_state->defarg;
@@ -521,6 +793,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			memnew_placement(&stack[ADDR_STACK_SELF], Variant);
 			script = _script;
 		}
+
+		// A resumed frame still holds these, constructing them again would leak the old values.
+		memnew_placement(&stack[ADDR_STACK_CLASS], Variant(script));
+
+		for (const Map<int, Variant::Type>::Element *E = temporary_slots.front(); E; E = E->next()) {
+			type_init_function_table[E->get()](&stack[E->key()]);
+		}
 	}
 	if (_ptrcall_args_size) {
 		call_args_ptr = (const void **)alloca(_ptrcall_args_size * sizeof(void *));
@@ -528,14 +807,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		call_args_ptr = nullptr;
 	}
 
-	memnew_placement(&stack[ADDR_STACK_CLASS], Variant(script));
+	String err_text;
 
-	for (const Map<int, Variant::Type>::Element *E = temporary_slots.front(); E; E = E->next()) {
-		type_init_function_table[E->get()](&stack[E->key()]);
+	GDScriptSampler::Frame sample_frame;
+	bool sampled = GDScriptSampler::is_active();
+	if (unlikely(sampled)) {
+		GDScriptSampler::enter(&sample_frame, this, &line);
 	}
 
-	String err_text;
-
 #ifdef DEBUG_ENABLED
 
 	if (EngineDebugger::is_active()) {
@@ -571,6 +850,33 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #define GET_INSTRUCTION_ARG(m_v, m_idx) \
 	Variant *m_v = instruction_args[m_idx]
 
+// Local operator instructions have no generic arguments, their operands are read straight from the code.
+#ifdef DEBUG_ENABLED
+#define GET_LOCAL_OPERAND(m_v, m_code_ofs)                                \
+	Variant *m_v = _get_local_operand(_code_ptr[ip + m_code_ofs], stack); \
+	GD_ERR_BREAK(!m_v)
+#else
+#define GET_LOCAL_OPERAND(m_v, m_code_ofs) \
+	Variant *m_v = _get_local_operand(_code_ptr[ip + m_code_ofs], stack)
+#endif
+
+#ifdef DEBUG_ENABLED
+#define COUNT_INLINE_CACHE(m_hit)                           \
+	{                                                       \
+		if (GDScriptLanguage::get_singleton()->profiling) { \
+			if (m_hit) {                                    \
+				profile.inline_cache_hits++;                \
+				profile.frame_inline_cache_hits++;          \
+			} else {                                        \
+				profile.inline_cache_misses++;              \
+				profile.frame_inline_cache_misses++;        \
+			}                                               \
+		}                                                   \
+	}
+#else
+#define COUNT_INLINE_CACHE(m_hit)
+#endif
+
 #ifdef DEBUG_ENABLED
 
 	uint64_t function_start_time = 0;
@@ -586,6 +892,26 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	bool awaited = false;
 #endif
 
+	// Set when the stack was handed over to a GDScriptFunctionState on await.
+	bool frame_moved = false;
+
+#ifdef GDSCRIPT_JIT_ENABLED
+	// Native code is only entered here, at loop back-edges and at default argument jumps, so the
+	// dispatch loop itself has no JIT checks.
+	const GDScriptJIT::Code *jit_code = nullptr;
+#ifdef DEBUG_ENABLED
+	bool jit_allowed = GDScriptJIT::can_run() && !EngineDebugger::is_active() && !GDScriptLanguage::get_singleton()->profiling && !sampled;
+#else
+	bool jit_allowed = GDScriptJIT::can_run() && !EngineDebugger::is_active() && !sampled;
+#endif
+	if (jit_allowed) {
+		jit_code = GDScriptJIT::get_code(this);
+		if (jit_code) {
+			ip = GDScriptJIT::run(jit_code, ip, stack, p_instance ? p_instance->members.ptrw() : nullptr, line);
+		}
+	}
+#endif
+
 #ifdef DEBUG_ENABLED
 	OPCODE_WHILE(ip < _code_size) {
 		int last_opcode = _code_ptr[ip] & INSTR_MASK;
@@ -652,6 +978,152 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT) {
+				CHECK_SPACE(6);
+
+				int operator_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(operator_idx < 0 || operator_idx >= _operator_funcs_count);
+				Variant::ValidatedOperatorEvaluator operator_func = _operator_funcs_ptr[operator_idx];
+
+				GET_INSTRUCTION_ARG(a, 0);
+				GET_INSTRUCTION_ARG(b, 1);
+				GET_INSTRUCTION_ARG(dst, 2);
+
+				operator_func(a, b, dst);
+
+				// Only emitted for operators returning a bool, so no need to booleanize.
+				if (!*VariantInternal::get_bool(dst)) {
+					int to = _code_ptr[ip + 5];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 6;
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_INT_LOCAL) {
+				CHECK_SPACE(5);
+
+				GET_LOCAL_OPERAND(a, 1);
+				GET_LOCAL_OPERAND(b, 2);
+				GET_LOCAL_OPERAND(dst, 3);
+				int op = _code_ptr[ip + 4];
+
+				int64_t left = *VariantInternal::get_int(a);
+				int64_t right = *VariantInternal::get_int(b);
+				if (op <= Variant::OP_GREATER_EQUAL) {
+					VariantTypeChanger<bool>::change(dst);
+					*VariantInternal::get_bool(dst) = _compare_local(op, left, right);
+				} else {
+					int64_t result;
+					switch (op) {
+						case Variant::OP_ADD:
+							result = left + right;
+							break;
+						case Variant::OP_SUBTRACT:
+							result = left - right;
+							break;
+						case Variant::OP_MULTIPLY:
+							result = left * right;
+							break;
+						case Variant::OP_BIT_AND:
+							result = left & right;
+							break;
+						case Variant::OP_BIT_OR:
+							result = left | right;
+							break;
+						default:
+							result = left ^ right;
+							break;
+					}
+					VariantTypeChanger<int64_t>::change(dst);
+					*VariantInternal::get_int(dst) = result;
+				}
+
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_INT_LOCAL_JUMP_IF_NOT) {
+				CHECK_SPACE(6);
+
+				GET_LOCAL_OPERAND(a, 1);
+				GET_LOCAL_OPERAND(b, 2);
+				GET_LOCAL_OPERAND(dst, 3);
+
+				bool result = _compare_local(_code_ptr[ip + 4], *VariantInternal::get_int(a), *VariantInternal::get_int(b));
+				VariantTypeChanger<bool>::change(dst);
+				*VariantInternal::get_bool(dst) = result;
+
+				if (!result) {
+					int to = _code_ptr[ip + 5];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 6;
+				}
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_FLOAT_LOCAL) {
+				CHECK_SPACE(5);
+
+				GET_LOCAL_OPERAND(a, 1);
+				GET_LOCAL_OPERAND(b, 2);
+				GET_LOCAL_OPERAND(dst, 3);
+				int op = _code_ptr[ip + 4];
+
+				double left = *VariantInternal::get_float(a);
+				double right = *VariantInternal::get_float(b);
+				if (op <= Variant::OP_GREATER_EQUAL) {
+					VariantTypeChanger<bool>::change(dst);
+					*VariantInternal::get_bool(dst) = _compare_local(op, left, right);
+				} else {
+					double result;
+					switch (op) {
+						case Variant::OP_ADD:
+							result = left + right;
+							break;
+						case Variant::OP_SUBTRACT:
+							result = left - right;
+							break;
+						case Variant::OP_MULTIPLY:
+							result = left * right;
+							break;
+						default:
+							result = left / right;
+							break;
+					}
+					VariantTypeChanger<double>::change(dst);
+					*VariantInternal::get_float(dst) = result;
+				}
+
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_FLOAT_LOCAL_JUMP_IF_NOT) {
+				CHECK_SPACE(6);
+
+				GET_LOCAL_OPERAND(a, 1);
+				GET_LOCAL_OPERAND(b, 2);
+				GET_LOCAL_OPERAND(dst, 3);
+
+				bool result = _compare_local(_code_ptr[ip + 4], *VariantInternal::get_float(a), *VariantInternal::get_float(b));
+				VariantTypeChanger<bool>::change(dst);
+				*VariantInternal::get_bool(dst) = result;
+
+				if (!result) {
+					int to = _code_ptr[ip + 5];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 6;
+				}
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 				CHECK_SPACE(4);
 
@@ -913,6 +1385,89 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				bool oob;
 				getter(src, int_index, dst, &oob);
 
+#ifdef DEBUG_ENABLED
+				if (oob) {
+					String v = index->operator String();
+					if (v != "") {
+						v = "'" + v + "'";
+					} else {
+						v = "of type '" + _get_var_type(index) + "'";
+					}
+					err_text = "Out of bounds get index " + v + " (on base: '" + _get_var_type(src) + "')";
+					OPCODE_BREAK;
+				}
+#endif
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_SET_INDEXED_TYPED_ARRAY) {
+				CHECK_SPACE(4);
+
+				GET_INSTRUCTION_ARG(dst, 0);
+				GET_INSTRUCTION_ARG(index, 1);
+				GET_INSTRUCTION_ARG(value, 2);
+
+				Variant::Type element_type = (Variant::Type)_code_ptr[ip + 4];
+				Array *array = VariantInternal::get_array(dst);
+				int64_t int_index = *VariantInternal::get_int(index);
+				int64_t size = array->size();
+				if (int_index < 0) {
+					int_index += size;
+				}
+				bool oob = int_index < 0 || int_index >= size;
+
+				if (likely(!oob)) {
+					// Every element of a typed array has its type, so values of that type are copied in place.
+					if (likely(value->get_type() == element_type && array->get_typed_builtin() == (uint32_t)element_type)) {
+						_copy_direct_value(element_type, &(*array)[int_index], value);
+					} else {
+						array->set(int_index, *value);
+					}
+				}
+
+#ifdef DEBUG_ENABLED
+				if (oob) {
+					String v = index->operator String();
+					if (v != "") {
+						v = "'" + v + "'";
+					} else {
+						v = "of type '" + _get_var_type(index) + "'";
+					}
+					err_text = "Out of bounds set index " + v + " (on base: '" + _get_var_type(dst) + "')";
+					OPCODE_BREAK;
+				}
+#endif
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_GET_INDEXED_TYPED_ARRAY) {
+				CHECK_SPACE(4);
+
+				GET_INSTRUCTION_ARG(src, 0);
+				GET_INSTRUCTION_ARG(index, 1);
+				GET_INSTRUCTION_ARG(dst, 2);
+
+				Variant::Type element_type = (Variant::Type)_code_ptr[ip + 4];
+				const Array *array = VariantInternal::get_array((const Variant *)src);
+				int64_t int_index = *VariantInternal::get_int(index);
+				int64_t size = array->size();
+				if (int_index < 0) {
+					int_index += size;
+				}
+				bool oob = int_index < 0 || int_index >= size;
+
+				if (likely(!oob)) {
+					// Resizing leaves null elements, so check the element rather than the array.
+					const Variant *element = &(*array)[int_index];
+					if (likely(element->get_type() == element_type)) {
+						_copy_direct_value(element_type, dst, element);
+					} else {
+						*dst = *element;
+					}
+				}
+
 #ifdef DEBUG_ENABLED
 				if (oob) {
 					String v = index->operator String();
@@ -930,7 +1485,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(5);
 
 				GET_INSTRUCTION_ARG(dst, 0);
 				GET_INSTRUCTION_ARG(value, 1);
@@ -940,8 +1495,43 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-				dst->set_named(*index, *value, valid);
+				int cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
+
+				Object *obj;
+				GDScriptInstance *instance;
+				bool cache_hit;
+				InlineCache::Entry *entry = _get_inline_cache_entry(&_inline_caches_ptr[cache_idx], InlineCache::ACCESS_SET, dst, *index, obj, instance, cache_hit);
+				if (entry && entry->value_type != Variant::VARIANT_MAX && entry->value_type != value->get_type()) {
+					entry = nullptr; // Needs a conversion.
+				}
+				COUNT_INLINE_CACHE(cache_hit && entry);
+
+				bool valid = true;
+				if (entry) {
+					switch (entry->kind) {
+						case InlineCache::KIND_BUILTIN: {
+							entry->setter(dst, value);
+						} break;
+						case InlineCache::KIND_MEMBER: {
+							instance->members.write[entry->index] = *value;
+						} break;
+						default: {
+							Callable::CallError ce;
+							if (entry->index >= 0) {
+								Variant property_index = entry->index;
+								const Variant *args[2] = { &property_index, value };
+								entry->method->call(obj, args, 2, ce);
+							} else {
+								const Variant *args[1] = { value };
+								entry->method->call(obj, args, 1, ce);
+							}
+							valid = ce.error == Callable::CallError::CALL_OK;
+						} break;
+					}
+				} else {
+					dst->set_named(*index, *value, valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -950,7 +1540,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -970,7 +1560,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_INSTRUCTION_ARG(src, 0);
 				GET_INSTRUCTION_ARG(dst, 1);
@@ -980,14 +1570,40 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+				int cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
 
-#else
-				*dst = src->get_named(*index, valid);
-#endif
+				Object *obj;
+				GDScriptInstance *instance;
+				bool cache_hit;
+				InlineCache::Entry *entry = _get_inline_cache_entry(&_inline_caches_ptr[cache_idx], InlineCache::ACCESS_GET, src, *index, obj, instance, cache_hit);
+				COUNT_INLINE_CACHE(cache_hit);
+
+				// Get into a temporary, src and dst may be the same stack position.
+				bool valid = true;
+				Variant ret;
+				if (entry) {
+					switch (entry->kind) {
+						case InlineCache::KIND_BUILTIN: {
+							entry->getter(src, &ret);
+						} break;
+						case InlineCache::KIND_MEMBER: {
+							ret = instance->members[entry->index];
+						} break;
+						default: {
+							Callable::CallError ce;
+							if (entry->index >= 0) {
+								Variant property_index = entry->index;
+								const Variant *args[1] = { &property_index };
+								ret = entry->method->call(obj, args, 1, ce);
+							} else {
+								ret = entry->method->call(obj, nullptr, 0, ce);
+							}
+						} break;
+					}
+				} else {
+					ret = src->get_named(*index, valid);
+				}
 #ifdef DEBUG_ENABLED
 				if (!valid) {
 					if (src->has_method(*index)) {
@@ -997,9 +1613,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					}
 					OPCODE_BREAK;
 				}
-				*dst = ret;
 #endif
-				ip += 4;
+				*dst = ret;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1439,7 +2055,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_CALL_ASYNC)
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 				bool call_ret = (_code_ptr[ip] & INSTR_MASK) != OPCODE_CALL;
 #ifdef DEBUG_ENABLED
 				bool call_async = (_code_ptr[ip] & INSTR_MASK) == OPCODE_CALL_ASYNC;
@@ -1454,9 +2070,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+				int cache_idx = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
+				Object *cached_object;
+				GDScriptInstance *instance;
+				bool cache_hit;
+				InlineCache::Entry *entry = _get_inline_cache_entry(&_inline_caches_ptr[cache_idx], InlineCache::ACCESS_CALL, base, *methodname, cached_object, instance, cache_hit);
+				COUNT_INLINE_CACHE(cache_hit);
+
 #ifdef DEBUG_ENABLED
 				uint64_t call_time = 0;
 
@@ -1468,7 +2093,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->call(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					if (!entry) {
+						base->call(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					} else if (entry->kind == InlineCache::KIND_FUNCTION) {
+						*ret = entry->function->call(instance, (const Variant **)argptrs, argc, err);
+					} else {
+						*ret = entry->method->call(cached_object, (const Variant **)argptrs, argc, err);
+					}
 #ifdef DEBUG_ENABLED
 					if (!call_async && ret->get_type() == Variant::OBJECT) {
 						// Check if getting a function state without await.
@@ -1485,9 +2116,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 						}
 					}
 #endif
-				} else {
+				} else if (!entry) {
 					Variant ret;
 					base->call(*methodname, (const Variant **)argptrs, argc, ret, err);
+				} else if (entry->kind == InlineCache::KIND_FUNCTION) {
+					entry->function->call(instance, (const Variant **)argptrs, argc, err);
+				} else {
+					entry->method->call(cached_object, (const Variant **)argptrs, argc, err);
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1532,6 +2167,108 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif
 
+				ip += 4;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_CALL_SCRIPT_FUNCTION_RETURN)
+			OPCODE(OPCODE_CALL_SCRIPT_FUNCTION) {
+				CHECK_SPACE(3 + instr_arg_count);
+				bool call_ret = (_code_ptr[ip] & INSTR_MASK) == OPCODE_CALL_SCRIPT_FUNCTION_RETURN;
+
+				ip += instr_arg_count;
+
+				int argc = _code_ptr[ip + 1];
+				GD_ERR_BREAK(argc < 0);
+
+				int direct_call_idx = _code_ptr[ip + 2];
+				GD_ERR_BREAK(direct_call_idx < 0 || direct_call_idx >= _direct_calls_count);
+				DirectCall *direct_call = &_direct_calls_ptr[direct_call_idx];
+
+				GET_INSTRUCTION_ARG(base, argc);
+				Variant **argptrs = instruction_args;
+
+				GDScriptInstance *callee_instance = nullptr;
+				if (base == &stack[ADDR_STACK_SELF]) {
+					callee_instance = p_instance;
+				} else {
+					Object *obj = base->get_validated_object();
+					ScriptInstance *script_instance = obj ? obj->get_script_instance() : nullptr;
+					if (script_instance && script_instance->get_language() == GDScriptLanguage::get_singleton()) {
+						callee_instance = static_cast<GDScriptInstance *>(script_instance);
+					}
+				}
+
+				// Subclasses may override the callee, so anything else goes through the regular call.
+				GDScriptFunction *callee = nullptr;
+				if (callee_instance && callee_instance->script.ptr() == direct_call->script) {
+					uint32_t generation = direct_call_generation.get();
+					if (direct_call->generation.get() != generation) {
+						// Same lookup as GDScriptInstance::call().
+						GDScriptFunction *function = nullptr;
+						for (const GDScript *gds = direct_call->script; gds && !function; gds = gds->_base) {
+							const Map<StringName, GDScriptFunction *>::Element *E = gds->member_functions.find(direct_call->name);
+							if (E) {
+								function = E->get();
+							}
+						}
+						direct_call->function = function;
+						direct_call->generation.set(generation);
+					}
+					callee = direct_call->function;
+				}
+
+#ifdef DEBUG_ENABLED
+				uint64_t call_time = 0;
+
+				if (GDScriptLanguage::get_singleton()->profiling) {
+					call_time = OS::get_singleton()->get_ticks_usec();
+				}
+
+#endif
+				Callable::CallError err;
+				if (call_ret) {
+					GET_INSTRUCTION_ARG(ret, argc + 1);
+					if (callee) {
+						*ret = callee->call(callee_instance, (const Variant **)argptrs, argc, err);
+					} else {
+						base->call(direct_call->name, (const Variant **)argptrs, argc, *ret, err);
+					}
+#ifdef DEBUG_ENABLED
+					if (ret->get_type() == Variant::OBJECT) {
+						// Check if getting a function state without await.
+						bool was_freed = false;
+						Object *obj = ret->get_validated_object_with_check(was_freed);
+
+						if (was_freed) {
+							err_text = "Got a freed object as a result of the call.";
+							OPCODE_BREAK;
+						}
+						if (obj && obj->is_class_ptr(GDScriptFunctionState::get_class_ptr_static())) {
+							err_text = R"(Trying to call an async function without "await".)";
+							OPCODE_BREAK;
+						}
+					}
+#endif
+				} else if (callee) {
+					callee->call(callee_instance, (const Variant **)argptrs, argc, err);
+				} else {
+					Variant ret;
+					base->call(direct_call->name, (const Variant **)argptrs, argc, ret, err);
+				}
+#ifdef DEBUG_ENABLED
+				if (GDScriptLanguage::get_singleton()->profiling) {
+					function_call_time += OS::get_singleton()->get_ticks_usec() - call_time;
+				}
+
+				if (err.error != Callable::CallError::CALL_OK) {
+					String methodstr = direct_call->name;
+					String basestr = _get_var_type(base);
+					err_text = _get_call_error(err, "function '" + methodstr + "' in base '" + basestr + "'", (const Variant **)argptrs);
+					OPCODE_BREAK;
+				}
+#endif
+
 				ip += 3;
 			}
 			DISPATCH_OPCODE;
@@ -2093,11 +2830,19 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
 					gdfs->function = this;
 
-					gdfs->state.stack.resize(alloca_size);
-					//copy variant stack
-					for (int i = 0; i < _stack_size; i++) {
-						memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
+					if (p_state) {
+						// Awaiting again after a resume, the frame is already on the heap so hand it over as is.
+						gdfs->state.stack = p_state->stack;
+						p_state->stack = nullptr;
+						p_state->stack_size = 0;
+					} else {
+						// Variants don't point into themselves, so they can be relocated without copying their contents.
+						gdfs->state.stack = GDScriptFunctionState::_alloc_frame(alloca_size);
+						memcpy(gdfs->state.stack, (void *)stack, sizeof(Variant) * _stack_size);
 					}
+					frame_moved = true;
+					GDScriptFunctionState::await_count.increment();
+
 					gdfs->state.stack_size = _stack_size;
 					gdfs->state.alloca_size = alloca_size;
 					gdfs->state.ip = ip + 2;
@@ -2184,6 +2929,17 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				int to = _code_ptr[ip + 1];
 
 				GD_ERR_BREAK(to < 0 || to > _code_size);
+#ifdef GDSCRIPT_JIT_ENABLED
+				// Loops count towards compiling the function, so long running calls switch to native code.
+				if (to <= ip && jit_allowed) {
+					if (!jit_code) {
+						jit_code = GDScriptJIT::get_code(this);
+					}
+					if (jit_code) {
+						to = GDScriptJIT::run(jit_code, to, stack, p_instance ? p_instance->members.ptrw() : nullptr, line);
+					}
+				}
+#endif
 				ip = to;
 			}
 			DISPATCH_OPCODE;
@@ -2225,6 +2981,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_JUMP_TO_DEF_ARGUMENT) {
 				CHECK_SPACE(2);
 				ip = _default_arg_ptr[defarg];
+#ifdef GDSCRIPT_JIT_ENABLED
+				if (jit_code) {
+					ip = GDScriptJIT::run(jit_code, ip, stack, p_instance ? p_instance->members.ptrw() : nullptr, line);
+				}
+#endif
 			}
 			DISPATCH_OPCODE;
 
@@ -2696,6 +3457,32 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 			}
 			DISPATCH_OPCODE;
+			OPCODE(OPCODE_ITERATE_BEGIN_TYPED_ARRAY) {
+				CHECK_SPACE(8); // Check space for iterate instruction too.
+
+				GET_INSTRUCTION_ARG(counter, 0);
+				GET_INSTRUCTION_ARG(container, 1);
+
+				const Array *array = VariantInternal::get_array((const Variant *)container);
+
+				VariantInternal::initialize(counter, Variant::INT);
+				*VariantInternal::get_int(counter) = 0;
+
+				if (!array->is_empty()) {
+					GET_INSTRUCTION_ARG(iterator, 2);
+					const Variant *element = &(*array)[0];
+					_copy_direct_value(element->get_type(), iterator, element);
+
+					// Skip regular iterate.
+					ip += 5;
+				} else {
+					// Jump to end of loop.
+					int jumpto = _code_ptr[ip + 4];
+					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+					ip = jumpto;
+				}
+			}
+			DISPATCH_OPCODE;
 
 #define OPCODE_ITERATE_BEGIN_PACKED_ARRAY(m_var_type, m_elem_type, m_get_func, m_var_ret_type, m_ret_type, m_ret_get_func) \
 	OPCODE(OPCODE_ITERATE_BEGIN_PACKED_##m_var_type##_ARRAY) {                                                             \
@@ -3029,6 +3816,29 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 			}
 			DISPATCH_OPCODE;
+			OPCODE(OPCODE_ITERATE_TYPED_ARRAY) {
+				CHECK_SPACE(4);
+
+				GET_INSTRUCTION_ARG(counter, 0);
+				GET_INSTRUCTION_ARG(container, 1);
+
+				const Array *array = VariantInternal::get_array((const Variant *)container);
+				int64_t *idx = VariantInternal::get_int(counter);
+				(*idx)++;
+
+				if (*idx >= array->size()) {
+					int jumpto = _code_ptr[ip + 4];
+					GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+					ip = jumpto;
+				} else {
+					GET_INSTRUCTION_ARG(iterator, 2);
+					const Variant *element = &(*array)[*idx];
+					_copy_direct_value(element->get_type(), iterator, element);
+
+					ip += 5; // Loop again.
+				}
+			}
+			DISPATCH_OPCODE;
 
 #define OPCODE_ITERATE_PACKED_ARRAY(m_var_type, m_elem_type, m_get_func, m_ret_get_func)            \
 	OPCODE(OPCODE_ITERATE_PACKED_##m_var_type##_ARRAY) {                                            \
@@ -3212,6 +4022,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_LINE) {
 				CHECK_SPACE(2);
 
+				if (unlikely(sampled)) {
+					// Before moving on, so the time since the last tick goes to the line that took it.
+					GDScriptSampler::poll();
+				}
+
 				line = _code_ptr[ip + 1];
 				ip += 2;
 
@@ -3312,7 +4127,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		}
 #endif
 
-		if (_stack_size) {
+		if (_stack_size && !frame_moved) {
 			//free stack
 			for (int i = 0; i < _stack_size; i++) {
 				stack[i].~Variant();
@@ -3323,5 +4138,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	}
 #endif
 
+	if (unlikely(sampled)) {
+		GDScriptSampler::exit(&sample_frame);
+	}
+
 	return retvalue;
 }
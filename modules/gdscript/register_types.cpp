@@ -69,24 +69,56 @@ Ref<GDScriptEditorTranslationParserPlugin> gdscript_translation_parser_plugin;
 class EditorExportGDScript : public EditorExportPlugin {
 	GDCLASS(EditorExportGDScript, EditorExportPlugin);
 
+	// Same matching as the PCK writer uses to pick the files it encrypts.
+	static bool _matches_filters(const String &p_path, const String &p_filters) {
+		Vector<String> filters = p_filters.split(",");
+		for (int i = 0; i < filters.size(); i++) {
+			String filter = filters[i].strip_edges();
+			if (!filter.is_empty() && (p_path.matchn(filter) || p_path.replace("res://", "").matchn(filter))) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static bool _is_encrypted(const Ref<EditorExportPreset> &p_preset, const String &p_path) {
+		return p_preset->get_enc_pck() && _matches_filters(p_path, p_preset->get_enc_in_filter()) && !_matches_filters(p_path, p_preset->get_enc_ex_filter());
+	}
+
 public:
 	virtual void _export_file(const String &p_path, const String &p_type, const Set<String> &p_features) override {
 		int script_mode = EditorExportPreset::MODE_SCRIPT_COMPILED;
-		String script_key;
 
 		const Ref<EditorExportPreset> &preset = get_export_preset();
 
 		if (preset.is_valid()) {
 			script_mode = preset->get_script_export_mode();
-			script_key = preset->get_script_encryption_key().to_lower();
 		}
 
 		if (!p_path.ends_with(".gd") || script_mode == EditorExportPreset::MODE_SCRIPT_TEXT) {
 			return;
 		}
 
-		// TODO: Re-add compiled GDScript on export.
-		return;
+		String byte_code_path = p_path.get_basename() + ".gdc";
+		if (preset.is_valid() && _is_encrypted(preset, p_path) && !_is_encrypted(preset, byte_code_path)) {
+			// Never ship a script the user asked to encrypt in a form that isn't.
+			WARN_PRINT("Script '" + p_path + "' is encrypted by the export preset but its byte code '" + byte_code_path + "' wouldn't be, exporting it as text. Add '*.gdc' to the encryption filters to export it as byte code.");
+			return;
+		}
+
+		Ref<GDScript> script = ResourceLoader::load(p_path);
+		if (script.is_null() || !script->is_valid()) {
+			return; // Export the source, so errors are reported the same way when running.
+		}
+
+		Vector<uint8_t> byte_code = script->get_as_byte_code();
+		if (byte_code.is_empty()) {
+			WARN_PRINT("Script '" + p_path + "' can't be stored as byte code, exporting it as text.");
+			return;
+		}
+
+		// Remapped, so the source is left out and the byte code is loaded in its place.
+		add_file(byte_code_path, byte_code, true);
 	}
 };
 
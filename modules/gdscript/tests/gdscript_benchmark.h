@@ -0,0 +1,302 @@
+/*************************************************************************/
+/*  gdscript_benchmark.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_BENCHMARK_H
+#define GDSCRIPT_BENCHMARK_H
+
+#include "../gdscript.h"
+#include "../gdscript_byte_codegen.h"
+#include "../gdscript_jit.h"
+
+#include "core/os/os.h"
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+struct BenchmarkScript {
+	const char *name;
+	const char *source;
+};
+
+// Each script has a `run(count)` function doing `count` iterations of typical game logic.
+static const BenchmarkScript benchmark_scripts[] = {
+	{ "typed int loop", R"(
+extends Reference
+
+func run(p_count: int) -> int:
+	var total := 0
+	var i := 0
+	while i < p_count:
+		total += i & 7
+		i += 1
+	return total
+)" },
+	{ "branches", R"(
+extends Reference
+
+func run(p_count: int) -> int:
+	var count := 0
+	for i in p_count:
+		if i % 3 == 0 and i % 5 != 0:
+			count += 1
+		elif i > p_count / 2:
+			count -= 1
+	return count
+)" },
+	{ "float math", R"(
+extends Reference
+
+const STEP = 0.001
+
+func run(p_count: int) -> float:
+	var x := 0.0
+	for i in p_count:
+		x = x * 0.5 + STEP * 2.0 - (1.0 / 3.0)
+	return x
+)" },
+	{ "untyped", R"(
+extends Reference
+
+func run(p_count):
+	var total = 0
+	for i in p_count:
+		var v = i * 2
+		total = total + v - i
+	return total
+)" },
+	{ "calls", R"(
+extends Reference
+
+func add(p_a: int, p_b: int) -> int:
+	return p_a + p_b
+
+func run(p_count: int) -> int:
+	var total := 0
+	for i in p_count:
+		total = add(total, i % 10)
+	return total
+)" },
+	{ "strings", R"(
+extends Reference
+
+func run(p_count: int) -> int:
+	var text := ""
+	for i in p_count / 10:
+		text += "a" if i % 2 == 0 else "b"
+	return text.length()
+)" },
+	{ "typed arrays", R"(
+extends Reference
+
+func run(p_count: int) -> float:
+	var values: Array[float] = []
+	for i in 100:
+		values.push_back(i * 0.5)
+	for i in p_count:
+		var index := int(i) % 100
+		values[index] = values[index] * 0.5 + 1.0
+	var total := 0.0
+	for value in values:
+		total += value
+	return total
+)" },
+	{ "typed locals", R"(
+extends Reference
+
+func run(p_count: int) -> float:
+	var sum := 0.0
+	var scale := 0.25
+	var hits := 0
+	var i := 0
+	while i < p_count:
+		var x := float(i) * scale
+		if x >= 10.0 and x / 3.0 < 100.0:
+			hits = hits + (i ^ 3) * 2
+		sum = sum - x + scale
+		i = i + 1
+	return sum + hits
+)" },
+	{ "typed edge values", R"(
+extends Reference
+
+func run(p_count: int) -> int:
+	var total := 0
+	var big := 9223372036854775807
+	var i := -p_count
+	while i < p_count:
+		var a := i * 7919
+		var b := -i - 3
+		total = (total * 31 + (a ^ b) + (a & b) - (a | -b)) & 0xFFFFFFFF
+		total = total ^ (big & a) ^ (big | b) ^ (-big ^ i)
+		if a < b or -a >= b or big <= a or -big > b:
+			total = total + 1
+		var f := float(i) / -3.0
+		if f < -0.5 and f * -2.0 >= float(b):
+			total = total - 2
+		i = i + 1
+	return total
+)" },
+};
+
+struct BenchmarkOptimization {
+	const char *name;
+	uint32_t flags;
+};
+
+static const BenchmarkOptimization benchmark_optimizations[] = {
+	{ "none", 0 },
+	{ "constant folding", GDScriptByteCodeGenerator::OPTIMIZE_CONSTANT_FOLDING },
+	{ "copy propagation", GDScriptByteCodeGenerator::OPTIMIZE_COPY_PROPAGATION },
+	{ "dead store elimination", GDScriptByteCodeGenerator::OPTIMIZE_DEAD_STORE_ELIMINATION },
+	{ "jump threading", GDScriptByteCodeGenerator::OPTIMIZE_JUMP_THREADING },
+	{ "superinstructions", GDScriptByteCodeGenerator::OPTIMIZE_SUPERINSTRUCTIONS },
+	{ "all", GDScriptByteCodeGenerator::OPTIMIZE_ALL },
+};
+
+// Compiles the script with the given optimizations and returns the result of `run()`.
+static Variant run_benchmark_script(const BenchmarkScript &p_script, uint32_t p_optimizations, int p_count, uint64_t *r_usec = nullptr) {
+	const uint32_t previous_optimizations = GDScriptByteCodeGenerator::get_optimizations();
+	GDScriptByteCodeGenerator::set_optimizations(p_optimizations);
+
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(p_script.source);
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	GDScriptByteCodeGenerator::set_optimizations(previous_optimizations);
+	if (error != OK) {
+		return Variant();
+	}
+
+	Ref<Reference> reference = memnew(Reference);
+	reference->set_script(gdscript);
+
+	const uint64_t from = OS::get_singleton()->get_ticks_usec();
+	Variant result = reference->call("run", p_count);
+	if (r_usec) {
+		*r_usec = OS::get_singleton()->get_ticks_usec() - from;
+	}
+	return result;
+}
+
+TEST_CASE("[Modules][GDScript] Byte code optimizations don't change results") {
+	for (const BenchmarkScript &script : benchmark_scripts) {
+		const Variant expected = run_benchmark_script(script, 0, 1000);
+		REQUIRE_MESSAGE(expected.get_type() != Variant::NIL, "The \"", script.name, "\" script should compile and run.");
+
+		for (const BenchmarkOptimization &optimization : benchmark_optimizations) {
+			CHECK_MESSAGE(run_benchmark_script(script, optimization.flags, 1000) == expected,
+					"The \"", script.name, "\" script should return the same with ", optimization.name, " optimizations.");
+		}
+	}
+}
+
+// Run it with `--test --no-skip` on an optimized build, timings are only meaningful relative to each other.
+TEST_CASE("[Modules][GDScript][Benchmark] Byte code optimizations" * doctest::skip()) {
+	const int count = 1000000;
+	const int runs = 3;
+
+	for (const BenchmarkScript &script : benchmark_scripts) {
+		for (const BenchmarkOptimization &optimization : benchmark_optimizations) {
+			// Keep the fastest run, to reduce the noise from the rest of the system.
+			uint64_t best_usec = UINT64_MAX;
+			for (int i = 0; i < runs; i++) {
+				uint64_t usec = 0;
+				run_benchmark_script(script, optimization.flags, count, &usec);
+				best_usec = MIN(best_usec, usec);
+			}
+			MESSAGE(script.name, " with ", optimization.name, " optimizations: ", best_usec / 1000.0, " msec.");
+		}
+	}
+}
+
+// Runs the benchmark scripts with the JIT compiling functions on their first call.
+class BenchmarkJIT {
+	bool enabled = GDScriptJIT::is_enabled();
+	bool verify = GDScriptJIT::is_verify_enabled();
+	uint32_t hot_threshold = GDScriptJIT::get_hot_threshold();
+
+public:
+	BenchmarkJIT(bool p_verify) {
+		GDScriptJIT::set_enabled(true);
+		GDScriptJIT::set_verify(p_verify);
+		GDScriptJIT::set_hot_threshold(1);
+	}
+
+	~BenchmarkJIT() {
+		GDScriptJIT::set_enabled(enabled);
+		GDScriptJIT::set_verify(verify);
+		GDScriptJIT::set_hot_threshold(hot_threshold);
+	}
+};
+
+TEST_CASE("[Modules][GDScript] JIT doesn't change results") {
+	if (!GDScriptJIT::is_supported()) {
+		return;
+	}
+
+	for (const BenchmarkScript &script : benchmark_scripts) {
+		const Variant expected = run_benchmark_script(script, GDScriptByteCodeGenerator::OPTIMIZE_ALL, 1000);
+		REQUIRE_MESSAGE(expected.get_type() != Variant::NIL, "The \"", script.name, "\" script should compile and run.");
+
+		BenchmarkJIT jit(true);
+		const uint64_t mismatches = GDScriptJIT::get_verify_mismatches();
+		CHECK_MESSAGE(run_benchmark_script(script, GDScriptByteCodeGenerator::OPTIMIZE_ALL, 1000) == expected,
+				"The \"", script.name, "\" script should return the same when compiled.");
+		CHECK_MESSAGE(GDScriptJIT::get_verify_mismatches() == mismatches,
+				"Functions of the \"", script.name, "\" script should return the same when compiled.");
+	}
+}
+
+TEST_CASE("[Modules][GDScript][Benchmark] JIT" * doctest::skip()) {
+	const int count = 1000000;
+	const int runs = 3;
+
+	for (const BenchmarkScript &script : benchmark_scripts) {
+		for (int jit_enabled = 0; jit_enabled < 2; jit_enabled++) {
+			uint64_t best_usec = UINT64_MAX;
+			for (int i = 0; i < runs; i++) {
+				uint64_t usec = 0;
+				if (jit_enabled) {
+					BenchmarkJIT jit(false);
+					run_benchmark_script(script, GDScriptByteCodeGenerator::OPTIMIZE_ALL, count, &usec);
+				} else {
+					run_benchmark_script(script, GDScriptByteCodeGenerator::OPTIMIZE_ALL, count, &usec);
+				}
+				best_usec = MIN(best_usec, usec);
+			}
+			MESSAGE(script.name, jit_enabled ? " compiled: " : " interpreted: ", best_usec / 1000.0, " msec.");
+		}
+	}
+}
+
+} // namespace GDScriptTests
+
+#endif // GDSCRIPT_BENCHMARK_H
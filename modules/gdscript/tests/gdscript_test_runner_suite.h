@@ -31,6 +31,8 @@
 #ifndef GDSCRIPT_TEST_RUNNER_SUITE_H
 #define GDSCRIPT_TEST_RUNNER_SUITE_H
 
+#include "../gdscript_parser.h"
+#include "../gdscript_sampler.h"
 #include "gdscript_test_runner.h"
 #include "tests/test_macros.h"
 
@@ -69,6 +71,270 @@ func _init():
 	CHECK_MESSAGE(int(reference->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
 
+// Compiles the source, returns a null reference if it doesn't compile.
+static Ref<GDScript> compile_test_script(const String &p_source, const String &p_path = String()) {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(p_source);
+	if (!p_path.is_empty()) {
+		gdscript->set_path(p_path);
+	}
+	// Silence the spurious `Condition "err" is true` message, see above.
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	if (error != OK) {
+		return Ref<GDScript>();
+	}
+	return gdscript;
+}
+
+TEST_CASE("[Modules][GDScript] Store a compiled script as byte code and run it") {
+	Ref<GDScript> source_script = compile_test_script(R"(
+extends Reference
+
+const SCALE = 2
+
+class Counter:
+	var total := 0
+
+	func add(p_amount: int) -> int:
+		total += p_amount
+		return total
+
+func _init():
+	var counter := Counter.new()
+	for value in [1, 2, 3]:
+		counter.add(value * SCALE)
+	var square := func(x): return x * x
+	set_meta("result", square.call(counter.total) + Vector2(3, 4).length())
+)");
+	REQUIRE_MESSAGE(source_script.is_valid(), "The script should parse successfully.");
+
+	const Vector<uint8_t> byte_code = source_script->get_as_byte_code();
+	REQUIRE_MESSAGE(!byte_code.is_empty(), "The compiled script should be stored as byte code.");
+
+	Ref<GDScript> gdscript = memnew(GDScript);
+	CHECK_MESSAGE(gdscript->load_byte_code_from_buffer(byte_code) == OK, "The byte code should load without compiling.");
+	CHECK_MESSAGE(gdscript->get_subclasses().has("Counter"), "Inner classes should be restored.");
+
+	Ref<Reference> reference = memnew(Reference);
+	reference->set_script(gdscript);
+	CHECK_MESSAGE(float(reference->get_meta("result")) == doctest::Approx(149), "The script should run the same as when compiled from source.");
+}
+
+TEST_CASE("[Modules][GDScript] Call script functions directly without missing overrides") {
+	Ref<GDScript> gdscript = compile_test_script(R"(
+extends Reference
+
+class Base:
+	func value() -> int:
+		return 1
+
+	func get_value() -> int:
+		return value()
+
+class Derived extends Base:
+	func value() -> int:
+		return 10
+
+func _init():
+	var base := Base.new()
+	var derived: Base = Derived.new()
+	var total := 0
+	for i in 3:
+		total += base.get_value() + derived.get_value() + derived.value()
+	set_meta("result", total)
+)");
+	REQUIRE_MESSAGE(gdscript.is_valid(), "The script should parse successfully.");
+
+	Ref<Reference> reference = memnew(Reference);
+	reference->set_script(gdscript);
+	CHECK_MESSAGE(int(reference->get_meta("result")) == 63, "Calls on instances of a subclass should reach its overrides.");
+}
+
+TEST_CASE("[Modules][GDScript] Cache untyped member accesses and calls per receiver class") {
+	Ref<GDScript> gdscript = compile_test_script(R"(
+extends Reference
+
+class A:
+	var value = 1
+
+	func step(x):
+		return x + value
+
+class B:
+	var value = 10
+
+	func step(x):
+		return x * value
+
+class C extends A:
+	func step(x):
+		return x - value
+
+class D extends B:
+	pass
+
+class E extends C:
+	pass
+
+func _init():
+	var receivers = [A.new(), B.new(), C.new(), Resource.new(), Vector2(1, 2)]
+	var total = 0
+	for i in 4:
+		for r in receivers:
+			if typeof(r) == TYPE_VECTOR2:
+				r.x = i # Needs a conversion to float.
+				total += r.x + r.y
+			elif r is Resource:
+				r.resource_name = str(i)
+				total += r.resource_name.to_int()
+			else:
+				r.value = r.value + 1
+				total += r.step(2)
+
+	# More classes than a single site keeps track of.
+	var many = [A.new(), B.new(), C.new(), D.new(), E.new()]
+	for i in 3:
+		for o in many:
+			total += o.value
+	set_meta("result", total)
+)");
+	REQUIRE_MESSAGE(gdscript.is_valid(), "The script should parse successfully.");
+
+#ifdef DEBUG_ENABLED
+	GDScriptLanguage::get_singleton()->profiling_start();
+#endif
+
+	Ref<Reference> reference = memnew(Reference);
+	reference->set_script(gdscript);
+	CHECK_MESSAGE(int(reference->get_meta("result")) == 205, "Cached lookups should resolve to the same members and functions as the regular ones.");
+
+#ifdef DEBUG_ENABLED
+	Vector<ScriptLanguage::ProfilingInfo> info;
+	info.resize(1024);
+	int count = GDScriptLanguage::get_singleton()->profiling_get_accumulated_data(info.ptrw(), info.size());
+	GDScriptLanguage::get_singleton()->profiling_stop();
+
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	for (int i = 0; i < count; i++) {
+		hits += info[i].inline_cache_hits;
+		misses += info[i].inline_cache_misses;
+	}
+	CHECK_MESSAGE(hits > 0, "Repeated accesses on the same classes should hit the caches.");
+	CHECK_MESSAGE(misses > 0, "The first access on each class should miss the caches.");
+#endif
+}
+
+TEST_CASE("[Modules][GDScript] Move coroutine frames between awaits") {
+	Ref<GDScript> gdscript = compile_test_script(R"(
+extends Reference
+
+signal step
+
+var done = 0
+
+func worker(count):
+	var held = [count, "held by the frame"]
+	var total = 0
+	for i in count:
+		await step
+		total += held[0]
+	done += total
+
+func start():
+	for i in 8:
+		call("worker", 3) # Don't wait for it.
+)");
+	REQUIRE_MESSAGE(gdscript.is_valid(), "The script should parse successfully.");
+
+	Ref<Reference> reference = memnew(Reference);
+	reference->set_script(gdscript);
+	const int script_references = gdscript->reference_get_count();
+
+	for (int run = 0; run < 2; run++) {
+		const GDScriptFunctionState::CoroutineStats before = GDScriptFunctionState::get_coroutine_stats();
+
+		reference->call("start");
+		const GDScriptFunctionState::CoroutineStats started = GDScriptFunctionState::get_coroutine_stats();
+		CHECK_MESSAGE(started.live - before.live == 8, "Each suspended function should hold a frame.");
+		CHECK_MESSAGE((started.frames_allocated + started.frames_reused) - (before.frames_allocated + before.frames_reused) == 8, "Only the first await of a function should take a frame.");
+		if (run > 0) {
+			CHECK_MESSAGE(started.frames_reused - before.frames_reused == 8, "Frames of completed functions should be reused.");
+		}
+
+		for (int i = 0; i < 3; i++) {
+			reference->emit_signal("step");
+		}
+
+		const GDScriptFunctionState::CoroutineStats after = GDScriptFunctionState::get_coroutine_stats();
+		CHECK_MESSAGE(int(reference->get("done")) == 72 * (run + 1), "Locals should survive being moved between awaits.");
+		CHECK_MESSAGE(after.live == before.live, "Completed functions should release their frames.");
+		CHECK_MESSAGE(after.awaits - before.awaits == 24, "Every await should be counted.");
+		CHECK_MESSAGE(after.resumes - before.resumes == 24, "Every resume should be counted.");
+		CHECK_MESSAGE(after.frames_allocated + after.frames_reused == started.frames_allocated + started.frames_reused, "Awaiting again after a resume should not take another frame.");
+		CHECK_MESSAGE(gdscript->reference_get_count() == script_references, "Completed functions should release the script held by their frames.");
+	}
+}
+
+TEST_CASE("[Modules][GDScript] Find the dependencies of a script without analyzing it") {
+	GDScriptParser parser;
+	const Error error = parser.parse(R"(
+extends "base.gd"
+
+const Scene = preload("res://levels/level.tscn")
+const Helper = preload("../helpers/helper.gd")
+
+var not_a_dependency = load("res://runtime.gd")
+var path = "res://also_not.gd"
+
+func _init():
+	var p = preload("base.gd")
+)",
+			"res://scripts/player.gd", false);
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	List<String> dependencies = parser.get_dependencies();
+	CHECK_MESSAGE(dependencies.size() == 3, "Every literal path should be listed once.");
+	CHECK_MESSAGE(dependencies.find("res://scripts/base.gd") != nullptr, "Relative base class paths should be resolved from the script.");
+	CHECK_MESSAGE(dependencies.find("res://levels/level.tscn") != nullptr, "Preloaded resources should be listed.");
+	CHECK_MESSAGE(dependencies.find("res://helpers/helper.gd") != nullptr, "Relative preload paths should be resolved from the script.");
+}
+
+TEST_CASE("[Modules][GDScript] Sample call stacks with their lines") {
+	Ref<GDScript> gdscript = compile_test_script(R"(
+extends Reference
+
+func spin(usec):
+	var end = OS.get_ticks_usec() + usec
+	while OS.get_ticks_usec() < end:
+		pass
+
+func run(usec):
+	spin(usec)
+)",
+			"res://sampled.gd");
+	REQUIRE_MESSAGE(gdscript.is_valid(), "The script should parse successfully.");
+
+	Ref<Reference> reference = memnew(Reference);
+	reference->set_script(gdscript);
+
+	GDScriptSampler::clear();
+	GDScriptSampler::start(500);
+	// Scheduling can delay the timer thread, so keep running until it ticked.
+	for (int i = 0; i < 100 && GDScriptSampler::get_sample_count() == 0; i++) {
+		reference->call("run", 20000);
+	}
+	GDScriptSampler::stop();
+
+	const String folded = GDScriptSampler::get_folded_stacks();
+	GDScriptSampler::clear();
+
+	CHECK_MESSAGE(!folded.is_empty(), "Running a script should be sampled.");
+	CHECK_MESSAGE(folded.find("res://sampled.gd:run:10;res://sampled.gd:spin:") != -1, "Frames should start from the outermost call, with the line of every call.");
+}
+
 } // namespace GDScriptTests
 
 #endif // GDSCRIPT_TEST_RUNNER_SUITE_H
@@ -30,6 +30,7 @@
 
 #include "register_types.h"
 
+#include "core/config/project_settings.h"
 #include "lightmap_raycaster.h"
 #include "raycast_occlusion_cull.h"
 
@@ -39,7 +40,9 @@ void register_raycast_types() {
 #ifdef TOOLS_ENABLED
 	LightmapRaycasterEmbree::make_default_raycaster();
 #endif
-	raycast_occlusion_cull = memnew(RaycastOcclusionCull);
+	if (int(GLOBAL_GET("rendering/occlusion_culling/backend")) == 0) {
+		raycast_occlusion_cull = memnew(RaycastOcclusionCull);
+	}
 }
 
 void unregister_raycast_types() {
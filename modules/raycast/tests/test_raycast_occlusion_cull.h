@@ -0,0 +1,176 @@
+/*************************************************************************/
+/*  test_raycast_occlusion_cull.h                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RAYCAST_OCCLUSION_CULL_H
+#define TEST_RAYCAST_OCCLUSION_CULL_H
+
+#include "core/os/os.h"
+#include "modules/raycast/raycast_occlusion_cull.h"
+#include "servers/rendering/renderer_scene_occlusion_cull_raster.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRaycastOcclusionCull {
+
+// Builds the same scene of box occluders in both occlusion culling backends and
+// compares their results and per-frame cost. Run it with `--test --no-skip`.
+class OcclusionCullBenchmark {
+	static const int GRID_SIZE = 32;
+
+	RendererSceneOcclusionCull *culler = nullptr;
+	RID box;
+	RID scenario = RID::from_uint64(1);
+	RID buffer = RID::from_uint64(2);
+
+	Transform _get_camera_transform(int p_frame) const {
+		Transform xform;
+		xform.basis = Basis(Vector3(0, 1, 0), Math::sin(p_frame * 0.05) * 0.3);
+		xform.origin = Vector3(0, 2, 0);
+		return xform;
+	}
+
+public:
+	CameraMatrix cam_projection;
+
+	OcclusionCullBenchmark(RendererSceneOcclusionCull *p_culler, const Size2i &p_buffer_size) {
+		culler = p_culler;
+
+		PackedVector3Array vertices;
+		for (int i = 0; i < 8; i++) {
+			vertices.push_back(Vector3(i & 1 ? 0.5 : -0.5, i & 2 ? 0.5 : -0.5, i & 4 ? 0.5 : -0.5));
+		}
+		const int faces[6][4] = { { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 } };
+		PackedInt32Array indices;
+		for (int i = 0; i < 6; i++) {
+			indices.push_back(faces[i][0]);
+			indices.push_back(faces[i][1]);
+			indices.push_back(faces[i][2]);
+			indices.push_back(faces[i][0]);
+			indices.push_back(faces[i][2]);
+			indices.push_back(faces[i][3]);
+		}
+
+		box = culler->occluder_allocate();
+		culler->occluder_initialize(box);
+		culler->occluder_set_mesh(box, vertices, indices);
+
+		culler->add_scenario(scenario);
+
+		// A field of boxes of varying height in front of the camera.
+		for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+			int x = i % GRID_SIZE - GRID_SIZE / 2;
+			int z = i / GRID_SIZE;
+			Transform xform;
+			xform.basis.scale(Vector3(1.5, 1 + (i * 7) % 5, 1.5));
+			xform.origin = Vector3(x * 4, 0, -10 - z * 4);
+			culler->scenario_set_instance(scenario, RID::from_uint64(100 + i), box, xform, true);
+		}
+
+		culler->add_buffer(buffer);
+		culler->buffer_set_scenario(buffer, scenario);
+		culler->buffer_set_size(buffer, p_buffer_size);
+
+		cam_projection.set_perspective(70, float(p_buffer_size.x) / p_buffer_size.y, 0.05, 200);
+	}
+
+	~OcclusionCullBenchmark() {
+		for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+			culler->scenario_remove_instance(scenario, RID::from_uint64(100 + i));
+		}
+		culler->remove_buffer(buffer);
+		culler->free_occluder(box);
+	}
+
+	uint64_t update(int p_frame, ThreadWorkPool &p_thread_pool) {
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		culler->buffer_update(buffer, _get_camera_transform(p_frame), cam_projection, false, p_thread_pool);
+		return OS::get_singleton()->get_ticks_usec() - from;
+	}
+
+	bool is_occluded(int p_frame, const AABB &p_aabb) {
+		Transform cam_transform = _get_camera_transform(p_frame);
+		const float bounds[6] = { p_aabb.position.x, p_aabb.position.y, p_aabb.position.z, p_aabb.position.x + p_aabb.size.x, p_aabb.position.y + p_aabb.size.y, p_aabb.position.z + p_aabb.size.z };
+		return culler->buffer_get_ptr(buffer)->is_occluded(bounds, cam_transform.origin, cam_transform.affine_inverse(), cam_projection, cam_projection.get_z_near());
+	}
+};
+
+TEST_CASE("[RaycastOcclusionCull][Benchmark] Compare with the software rasterizer" * doctest::skip()) {
+	const int warmup_frames = 20;
+	const int frames = 200;
+	const Size2i buffer_size = Size2i(128, 72);
+
+	ThreadWorkPool thread_pool;
+	thread_pool.init();
+
+	RaycastOcclusionCull *raycast = memnew(RaycastOcclusionCull);
+	RendererSceneOcclusionCullRaster *raster = memnew(RendererSceneOcclusionCullRaster);
+
+	OcclusionCullBenchmark *raycast_scene = memnew(OcclusionCullBenchmark(raycast, buffer_size));
+	OcclusionCullBenchmark *raster_scene = memnew(OcclusionCullBenchmark(raster, buffer_size));
+
+	// The raycast backend commits its scene asynchronously, give it time to become available.
+	for (int i = 0; i < warmup_frames; i++) {
+		raycast_scene->update(0, thread_pool);
+		raster_scene->update(0, thread_pool);
+		OS::get_singleton()->delay_usec(10000);
+	}
+
+	uint64_t raycast_usec = 0;
+	uint64_t raster_usec = 0;
+	int tested = 0;
+	int mismatches = 0;
+
+	for (int frame = 0; frame < frames; frame++) {
+		raycast_usec += raycast_scene->update(frame, thread_pool);
+		raster_usec += raster_scene->update(frame, thread_pool);
+
+		// Probe AABBs on a grid between the occluders.
+		for (int i = 0; i < 64; i++) {
+			AABB aabb = AABB(Vector3((i % 8) * 8 - 30, 0, -12 - (i / 8) * 12), Vector3(1, 1, 1));
+			tested++;
+			if (raycast_scene->is_occluded(frame, aabb) != raster_scene->is_occluded(frame, aabb)) {
+				mismatches++;
+			}
+		}
+	}
+
+	MESSAGE("Raycast: ", raycast_usec / frames, " usec/frame, rasterizer: ", raster_usec / frames, " usec/frame.");
+	CHECK_MESSAGE(mismatches <= tested / 20, "Both backends should agree on at least 95% of the occlusion queries.");
+
+	memdelete(raster_scene);
+	memdelete(raycast_scene);
+	memdelete(raster);
+	memdelete(raycast);
+	thread_pool.finish();
+}
+
+} // namespace TestRaycastOcclusionCull
+
+#endif // TEST_RAYCAST_OCCLUSION_CULL_H
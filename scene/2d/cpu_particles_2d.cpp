@@ -31,6 +31,7 @@
 #include "cpu_particles_2d.h"
 
 #include "core/core_string_names.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/2d/gpu_particles_2d.h"
 #include "scene/main/canvas_item.h"
 #include "scene/resources/particles_material.h"
@@ -514,6 +515,21 @@ static real_t rand_from_seed(uint32_t &seed) {
 	return (seed % uint32_t(65536)) / 65535.0;
 }
 
+static Basis _get_hue_rotation(float p_angle) {
+	float c = Math::cos(p_angle);
+	float s = Math::sin(p_angle);
+
+	Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
+	Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
+	Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
+
+	Basis hue_rot_mat;
+	for (int j = 0; j < 3; j++) {
+		hue_rot_mat[j] = mat1[j] + mat2[j] * c + mat3[j] * s;
+	}
+	return hue_rot_mat;
+}
+
 void CPUParticles2D::_update_internal() {
 	if (particles.size() == 0 || !is_visible_in_tree()) {
 		_set_redraw(false);
@@ -584,11 +600,6 @@ void CPUParticles2D::_update_internal() {
 void CPUParticles2D::_particles_process(float p_delta) {
 	p_delta *= speed_scale;
 
-	int pcount = particles.size();
-	Particle *w = particles.ptrw();
-
-	Particle *parray = w;
-
 	float prev_time = time;
 	time += p_delta;
 	if (time > lifetime) {
@@ -600,397 +611,431 @@ void CPUParticles2D::_particles_process(float p_delta) {
 		}
 	}
 
-	Transform2D emission_xform;
-	Transform2D velocity_xform;
+	int pcount = particles.size();
+
+	process_state.particles = particles.ptrw();
+	process_state.particle_count = pcount;
+	process_state.delta = p_delta;
+	process_state.prev_time = prev_time;
+	process_state.system_phase = time / lifetime;
+	process_state.random_seed = Math::rand();
+
+	process_state.emission_xform = Transform2D();
+	process_state.velocity_xform = Transform2D();
 	if (!local_coords) {
-		emission_xform = get_global_transform();
-		velocity_xform = emission_xform;
-		velocity_xform[2] = Vector2();
+		process_state.emission_xform = get_global_transform();
+		process_state.velocity_xform = process_state.emission_xform;
+		process_state.velocity_xform[2] = Vector2();
+	}
+
+	// Without variation over lifetime or between particles, all of them share the same hue rotation.
+	process_state.uniform_hue_rotation = curve_parameters[PARAM_HUE_VARIATION].is_null() && randomness[PARAM_HUE_VARIATION] == 0.0;
+	if (process_state.uniform_hue_rotation) {
+		process_state.hue_rot_mat = _get_hue_rotation(parameters[PARAM_HUE_VARIATION] * Math_TAU);
 	}
 
-	float system_phase = time / lifetime;
+	if (color_ramp.is_valid()) {
+		color_ramp->get_color_at_offset(0.0); // Sort the points now, threads only read them.
+	}
 
-	for (int i = 0; i < pcount; i++) {
-		Particle &p = parray[i];
+	// In index order, particles are written to particle_data as they are processed, without a
+	// separate fill pass. The server owns the multimesh buffer and may live on another thread,
+	// so particle_data is still handed over with multimesh_set_buffer() afterwards.
+	MutexLock lock(update_mutex);
+	process_state.buffer = draw_order == DRAW_ORDER_INDEX ? particle_data.ptrw() : nullptr;
 
-		if (!emitting && !p.active) {
-			continue;
+	if (pcount >= PARALLEL_PROCESS_THRESHOLD && is_inside_tree()) {
+		ThreadWorkPool *work_pool = get_tree()->get_thread_work_pool();
+		if (work_pool && work_pool->get_thread_count() > 1) {
+			work_pool->do_work((pcount + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE, this, &CPUParticles2D::_particles_process_chunk, (int)PROCESS_CHUNK_SIZE);
+			return;
 		}
+	}
 
-		float local_delta = p_delta;
+	_particles_process_chunk(0, pcount);
+}
 
-		// The phase is a ratio between 0 (birth) and 1 (end of life) for each particle.
-		// While we use time in tests later on, for randomness we use the phase as done in the
-		// original shader code, and we later multiply by lifetime to get the time.
-		real_t restart_phase = real_t(i) / real_t(pcount);
+void CPUParticles2D::_particles_process_chunk(uint32_t p_chunk, int p_chunk_size) {
+	int from = p_chunk * p_chunk_size;
+	int to = MIN(from + p_chunk_size, process_state.particle_count);
 
-		if (randomness_ratio > 0.0) {
-			uint32_t seed = cycle;
-			if (restart_phase >= system_phase) {
-				seed -= uint32_t(1);
-			}
-			seed *= uint32_t(pcount);
-			seed += uint32_t(i);
-			real_t random = (idhash(seed) % uint32_t(65536)) / 65536.0;
-			restart_phase += randomness_ratio * random * 1.0 / pcount;
+	for (int i = from; i < to; i++) {
+		_process_particle(i);
+		if (process_state.buffer) {
+			_fill_particle_data(process_state.buffer + i * 16, process_state.particles[i]);
 		}
+	}
+}
 
-		restart_phase *= (1.0 - explosiveness_ratio);
-		float restart_time = restart_phase * lifetime;
-		bool restart = false;
+void CPUParticles2D::_fill_particle_data(float *p_ptr, const Particle &p_particle) const {
+	if (p_particle.active) {
+		Transform2D t = local_coords ? p_particle.transform : inv_emission_transform * p_particle.transform;
+		p_ptr[0] = t.elements[0][0];
+		p_ptr[1] = t.elements[1][0];
+		p_ptr[2] = 0;
+		p_ptr[3] = t.elements[2][0];
+		p_ptr[4] = t.elements[0][1];
+		p_ptr[5] = t.elements[1][1];
+		p_ptr[6] = 0;
+		p_ptr[7] = t.elements[2][1];
+	} else {
+		memset(p_ptr, 0, sizeof(float) * 8);
+	}
 
-		if (time > prev_time) {
-			// restart_time >= prev_time is used so particles emit in the first frame they are processed
+	p_ptr[8] = p_particle.color.r;
+	p_ptr[9] = p_particle.color.g;
+	p_ptr[10] = p_particle.color.b;
+	p_ptr[11] = p_particle.color.a;
 
-			if (restart_time >= prev_time && restart_time < time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = time - restart_time;
-				}
-			}
+	p_ptr[12] = p_particle.custom[0];
+	p_ptr[13] = p_particle.custom[1];
+	p_ptr[14] = p_particle.custom[2];
+	p_ptr[15] = p_particle.custom[3];
+}
 
-		} else if (local_delta > 0.0) {
-			if (restart_time >= prev_time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = lifetime - restart_time + time;
-				}
+void CPUParticles2D::_process_particle(int p_index) {
+	Particle &p = process_state.particles[p_index];
+	int pcount = process_state.particle_count;
+	float prev_time = process_state.prev_time;
+	float system_phase = process_state.system_phase;
+	const Transform2D &emission_xform = process_state.emission_xform;
+	const Transform2D &velocity_xform = process_state.velocity_xform;
 
-			} else if (restart_time < time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = time - restart_time;
-				}
-			}
-		}
+	if (!emitting && !p.active) {
+		return;
+	}
 
-		if (p.time * (1.0 - explosiveness_ratio) > p.lifetime) {
-			restart = true;
+	float local_delta = process_state.delta;
+
+	// The phase is a ratio between 0 (birth) and 1 (end of life) for each particle.
+	// While we use time in tests later on, for randomness we use the phase as done in the
+	// original shader code, and we later multiply by lifetime to get the time.
+	real_t restart_phase = real_t(p_index) / real_t(pcount);
+
+	if (randomness_ratio > 0.0) {
+		uint32_t seed = cycle;
+		if (restart_phase >= system_phase) {
+			seed -= uint32_t(1);
 		}
+		seed *= uint32_t(pcount);
+		seed += uint32_t(p_index);
+		real_t random = (idhash(seed) % uint32_t(65536)) / 65536.0;
+		restart_phase += randomness_ratio * random * 1.0 / pcount;
+	}
 
-		float tv = 0.0;
+	restart_phase *= (1.0 - explosiveness_ratio);
+	float restart_time = restart_phase * lifetime;
+	bool restart = false;
 
-		if (restart) {
-			if (!emitting) {
-				p.active = false;
-				continue;
-			}
-			p.active = true;
+	if (time > prev_time) {
+		// restart_time >= prev_time is used so particles emit in the first frame they are processed
 
-			/*real_t tex_linear_velocity = 0;
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(0);
-			}*/
+		if (restart_time >= prev_time && restart_time < time) {
+			restart = true;
+			if (fractional_delta) {
+				local_delta = time - restart_time;
+			}
+		}
 
-			real_t tex_angle = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+	} else if (local_delta > 0.0) {
+		if (restart_time >= prev_time) {
+			restart = true;
+			if (fractional_delta) {
+				local_delta = lifetime - restart_time + time;
 			}
 
-			real_t tex_anim_offset = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+		} else if (restart_time < time) {
+			restart = true;
+			if (fractional_delta) {
+				local_delta = time - restart_time;
 			}
+		}
+	}
 
-			p.seed = Math::rand();
-
-			p.angle_rand = Math::randf();
-			p.scale_rand = Math::randf();
-			p.hue_rot_rand = Math::randf();
-			p.anim_offset_rand = Math::randf();
-
-			real_t angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg2rad((Math::randf() * 2.0 - 1.0) * spread);
-			Vector2 rot = Vector2(Math::cos(angle1_rad), Math::sin(angle1_rad));
-			p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp((real_t)1.0, real_t(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
-
-			real_t base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp((real_t)1.0, p.angle_rand, randomness[PARAM_ANGLE]);
-			p.rotation = Math::deg2rad(base_angle);
-
-			p.custom[0] = 0.0; // unused
-			p.custom[1] = 0.0; // phase [0..1]
-			p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp((real_t)1.0, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]); //animation phase [0..1]
-			p.custom[3] = 0.0;
-			p.transform = Transform2D();
-			p.time = 0;
-			p.lifetime = lifetime * (1.0 - Math::randf() * lifetime_randomness);
-			p.base_color = Color(1, 1, 1, 1);
-
-			switch (emission_shape) {
-				case EMISSION_SHAPE_POINT: {
-					//do none
-				} break;
-				case EMISSION_SHAPE_SPHERE: {
-					real_t s = Math::randf(), t = Math_TAU * Math::randf();
-					real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
-					p.transform[2] = Vector2(Math::cos(t), Math::sin(t)) * radius;
-				} break;
-				case EMISSION_SHAPE_RECTANGLE: {
-					p.transform[2] = Vector2(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0) * emission_rect_extents;
-				} break;
-				case EMISSION_SHAPE_POINTS:
-				case EMISSION_SHAPE_DIRECTED_POINTS: {
-					int pc = emission_points.size();
-					if (pc == 0) {
-						break;
-					}
+	if (p.time * (1.0 - explosiveness_ratio) > p.lifetime) {
+		restart = true;
+	}
 
-					int random_idx = Math::rand() % pc;
+	float tv = 0.0;
 
-					p.transform[2] = emission_points.get(random_idx);
+	if (restart) {
+		if (!emitting) {
+			p.active = false;
+			return;
+		}
+		p.active = true;
 
-					if (emission_shape == EMISSION_SHAPE_DIRECTED_POINTS && emission_normals.size() == pc) {
-						Vector2 normal = emission_normals.get(random_idx);
-						Transform2D m2;
-						m2.set_axis(0, normal);
-						m2.set_axis(1, normal.orthogonal());
-						p.velocity = m2.basis_xform(p.velocity);
-					}
+		/*real_t tex_linear_velocity = 0;
+		if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(0);
+		}*/
 
-					if (emission_colors.size() == pc) {
-						p.base_color = emission_colors.get(random_idx);
-					}
-				} break;
-				case EMISSION_SHAPE_MAX: { // Max value for validity check.
+		real_t tex_angle = 0.0;
+		if (curve_parameters[PARAM_ANGLE].is_valid()) {
+			tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+		}
+
+		real_t tex_anim_offset = 0.0;
+		if (curve_parameters[PARAM_ANGLE].is_valid()) {
+			tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+		}
+
+		uint32_t restart_seed = idhash(process_state.random_seed + uint32_t(p_index));
+		p.seed = restart_seed;
+
+		p.angle_rand = rand_from_seed(restart_seed);
+		p.scale_rand = rand_from_seed(restart_seed);
+		p.hue_rot_rand = rand_from_seed(restart_seed);
+		p.anim_offset_rand = rand_from_seed(restart_seed);
+
+		real_t angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg2rad((rand_from_seed(restart_seed) * 2.0 - 1.0) * spread);
+		Vector2 rot = Vector2(Math::cos(angle1_rad), Math::sin(angle1_rad));
+		p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp((real_t)1.0, real_t(rand_from_seed(restart_seed)), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
+
+		real_t base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp((real_t)1.0, p.angle_rand, randomness[PARAM_ANGLE]);
+		p.rotation = Math::deg2rad(base_angle);
+
+		p.custom[0] = 0.0; // unused
+		p.custom[1] = 0.0; // phase [0..1]
+		p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp((real_t)1.0, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]); //animation phase [0..1]
+		p.custom[3] = 0.0;
+		p.transform = Transform2D();
+		p.time = 0;
+		p.lifetime = lifetime * (1.0 - rand_from_seed(restart_seed) * lifetime_randomness);
+		p.base_color = Color(1, 1, 1, 1);
+
+		switch (emission_shape) {
+			case EMISSION_SHAPE_POINT: {
+				//do none
+			} break;
+			case EMISSION_SHAPE_SPHERE: {
+				real_t s = rand_from_seed(restart_seed), t = Math_TAU * rand_from_seed(restart_seed);
+				real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
+				p.transform[2] = Vector2(Math::cos(t), Math::sin(t)) * radius;
+			} break;
+			case EMISSION_SHAPE_RECTANGLE: {
+				p.transform[2] = Vector2(rand_from_seed(restart_seed) * 2.0 - 1.0, rand_from_seed(restart_seed) * 2.0 - 1.0) * emission_rect_extents;
+			} break;
+			case EMISSION_SHAPE_POINTS:
+			case EMISSION_SHAPE_DIRECTED_POINTS: {
+				int pc = emission_points.size();
+				if (pc == 0) {
 					break;
 				}
-			}
 
-			if (!local_coords) {
-				p.velocity = velocity_xform.xform(p.velocity);
-				p.transform = emission_xform * p.transform;
-			}
+				int random_idx = idhash(restart_seed) % pc;
 
-		} else if (!p.active) {
-			continue;
-		} else if (p.time > p.lifetime) {
-			p.active = false;
-			tv = 1.0;
-		} else {
-			uint32_t alt_seed = p.seed;
+				p.transform[2] = emission_points.get(random_idx);
 
-			p.time += local_delta;
-			p.custom[1] = p.time / lifetime;
-			tv = p.time / p.lifetime;
-
-			real_t tex_linear_velocity = 0.0;
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(tv);
-			}
+				if (emission_shape == EMISSION_SHAPE_DIRECTED_POINTS && emission_normals.size() == pc) {
+					Vector2 normal = emission_normals.get(random_idx);
+					Transform2D m2;
+					m2.set_axis(0, normal);
+					m2.set_axis(1, normal.orthogonal());
+					p.velocity = m2.basis_xform(p.velocity);
+				}
 
-			real_t tex_orbit_velocity = 0.0;
-			if (curve_parameters[PARAM_ORBIT_VELOCITY].is_valid()) {
-				tex_orbit_velocity = curve_parameters[PARAM_ORBIT_VELOCITY]->interpolate(tv);
+				if (emission_colors.size() == pc) {
+					p.base_color = emission_colors.get(random_idx);
+				}
+			} break;
+			case EMISSION_SHAPE_MAX: { // Max value for validity check.
+				break;
 			}
+		}
 
-			real_t tex_angular_velocity = 0.0;
-			if (curve_parameters[PARAM_ANGULAR_VELOCITY].is_valid()) {
-				tex_angular_velocity = curve_parameters[PARAM_ANGULAR_VELOCITY]->interpolate(tv);
-			}
+		if (!local_coords) {
+			p.velocity = velocity_xform.xform(p.velocity);
+			p.transform = emission_xform * p.transform;
+		}
 
-			real_t tex_linear_accel = 0.0;
-			if (curve_parameters[PARAM_LINEAR_ACCEL].is_valid()) {
-				tex_linear_accel = curve_parameters[PARAM_LINEAR_ACCEL]->interpolate(tv);
-			}
+	} else if (!p.active) {
+		return;
+	} else if (p.time > p.lifetime) {
+		p.active = false;
+		tv = 1.0;
+	} else {
+		uint32_t alt_seed = p.seed;
 
-			real_t tex_tangential_accel = 0.0;
-			if (curve_parameters[PARAM_TANGENTIAL_ACCEL].is_valid()) {
-				tex_tangential_accel = curve_parameters[PARAM_TANGENTIAL_ACCEL]->interpolate(tv);
-			}
+		p.time += local_delta;
+		p.custom[1] = p.time / lifetime;
+		tv = p.time / p.lifetime;
 
-			real_t tex_radial_accel = 0.0;
-			if (curve_parameters[PARAM_RADIAL_ACCEL].is_valid()) {
-				tex_radial_accel = curve_parameters[PARAM_RADIAL_ACCEL]->interpolate(tv);
-			}
+		real_t tex_linear_velocity = 0.0;
+		if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(tv);
+		}
 
-			real_t tex_damping = 0.0;
-			if (curve_parameters[PARAM_DAMPING].is_valid()) {
-				tex_damping = curve_parameters[PARAM_DAMPING]->interpolate(tv);
-			}
+		real_t tex_orbit_velocity = 0.0;
+		if (curve_parameters[PARAM_ORBIT_VELOCITY].is_valid()) {
+			tex_orbit_velocity = curve_parameters[PARAM_ORBIT_VELOCITY]->interpolate(tv);
+		}
 
-			real_t tex_angle = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(tv);
-			}
-			real_t tex_anim_speed = 0.0;
-			if (curve_parameters[PARAM_ANIM_SPEED].is_valid()) {
-				tex_anim_speed = curve_parameters[PARAM_ANIM_SPEED]->interpolate(tv);
-			}
+		real_t tex_angular_velocity = 0.0;
+		if (curve_parameters[PARAM_ANGULAR_VELOCITY].is_valid()) {
+			tex_angular_velocity = curve_parameters[PARAM_ANGULAR_VELOCITY]->interpolate(tv);
+		}
 
-			real_t tex_anim_offset = 0.0;
-			if (curve_parameters[PARAM_ANIM_OFFSET].is_valid()) {
-				tex_anim_offset = curve_parameters[PARAM_ANIM_OFFSET]->interpolate(tv);
-			}
+		real_t tex_linear_accel = 0.0;
+		if (curve_parameters[PARAM_LINEAR_ACCEL].is_valid()) {
+			tex_linear_accel = curve_parameters[PARAM_LINEAR_ACCEL]->interpolate(tv);
+		}
 
-			Vector2 force = gravity;
-			Vector2 pos = p.transform[2];
-
-			//apply linear acceleration
-			force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector2();
-			//apply radial acceleration
-			Vector2 org = emission_xform[2];
-			Vector2 diff = pos - org;
-			force += diff.length() > 0.0 ? diff.normalized() * (parameters[PARAM_RADIAL_ACCEL] + tex_radial_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_RADIAL_ACCEL]) : Vector2();
-			//apply tangential acceleration;
-			Vector2 yx = Vector2(diff.y, diff.x);
-			force += yx.length() > 0.0 ? (yx * Vector2(-1.0, 1.0)).normalized() * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector2();
-			//apply attractor forces
-			p.velocity += force * local_delta;
-			//orbit velocity
-			real_t orbit_amount = (parameters[PARAM_ORBIT_VELOCITY] + tex_orbit_velocity) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_ORBIT_VELOCITY]);
-			if (orbit_amount != 0.0) {
-				real_t ang = orbit_amount * local_delta * Math_TAU;
-				// Not sure why the ParticlesMaterial code uses a clockwise rotation matrix,
-				// but we use -ang here to reproduce its behavior.
-				Transform2D rot = Transform2D(-ang, Vector2());
-				p.transform[2] -= diff;
-				p.transform[2] += rot.basis_xform(diff);
-			}
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				p.velocity = p.velocity.normalized() * tex_linear_velocity;
-			}
+		real_t tex_tangential_accel = 0.0;
+		if (curve_parameters[PARAM_TANGENTIAL_ACCEL].is_valid()) {
+			tex_tangential_accel = curve_parameters[PARAM_TANGENTIAL_ACCEL]->interpolate(tv);
+		}
 
-			if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
-				real_t v = p.velocity.length();
-				real_t damp = (parameters[PARAM_DAMPING] + tex_damping) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_DAMPING]);
-				v -= damp * local_delta;
-				if (v < 0.0) {
-					p.velocity = Vector2();
-				} else {
-					p.velocity = p.velocity.normalized() * v;
-				}
-			}
-			real_t base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp((real_t)1.0, p.angle_rand, randomness[PARAM_ANGLE]);
-			base_angle += p.custom[1] * lifetime * (parameters[PARAM_ANGULAR_VELOCITY] + tex_angular_velocity) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed) * 2.0f - 1.0f, randomness[PARAM_ANGULAR_VELOCITY]);
-			p.rotation = Math::deg2rad(base_angle); //angle
-			real_t animation_phase = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp((real_t)1.0, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]) + p.custom[1] * (parameters[PARAM_ANIM_SPEED] + tex_anim_speed) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_ANIM_SPEED]);
-			p.custom[2] = animation_phase;
+		real_t tex_radial_accel = 0.0;
+		if (curve_parameters[PARAM_RADIAL_ACCEL].is_valid()) {
+			tex_radial_accel = curve_parameters[PARAM_RADIAL_ACCEL]->interpolate(tv);
 		}
-		//apply color
-		//apply hue rotation
 
-		real_t tex_scale = 1.0;
-		if (curve_parameters[PARAM_SCALE].is_valid()) {
-			tex_scale = curve_parameters[PARAM_SCALE]->interpolate(tv);
+		real_t tex_damping = 0.0;
+		if (curve_parameters[PARAM_DAMPING].is_valid()) {
+			tex_damping = curve_parameters[PARAM_DAMPING]->interpolate(tv);
 		}
 
-		real_t tex_hue_variation = 0.0;
-		if (curve_parameters[PARAM_HUE_VARIATION].is_valid()) {
-			tex_hue_variation = curve_parameters[PARAM_HUE_VARIATION]->interpolate(tv);
+		real_t tex_angle = 0.0;
+		if (curve_parameters[PARAM_ANGLE].is_valid()) {
+			tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+		}
+		real_t tex_anim_speed = 0.0;
+		if (curve_parameters[PARAM_ANIM_SPEED].is_valid()) {
+			tex_anim_speed = curve_parameters[PARAM_ANIM_SPEED]->interpolate(tv);
 		}
 
-		real_t hue_rot_angle = (parameters[PARAM_HUE_VARIATION] + tex_hue_variation) * Math_TAU * Math::lerp(1.0f, p.hue_rot_rand * 2.0f - 1.0f, randomness[PARAM_HUE_VARIATION]);
-		real_t hue_rot_c = Math::cos(hue_rot_angle);
-		real_t hue_rot_s = Math::sin(hue_rot_angle);
+		real_t tex_anim_offset = 0.0;
+		if (curve_parameters[PARAM_ANIM_OFFSET].is_valid()) {
+			tex_anim_offset = curve_parameters[PARAM_ANIM_OFFSET]->interpolate(tv);
+		}
 
-		Basis hue_rot_mat;
-		{
-			Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
-			Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
-			Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
+		Vector2 force = gravity;
+		Vector2 pos = p.transform[2];
+
+		//apply linear acceleration
+		force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector2();
+		//apply radial acceleration
+		Vector2 org = emission_xform[2];
+		Vector2 diff = pos - org;
+		force += diff.length() > 0.0 ? diff.normalized() * (parameters[PARAM_RADIAL_ACCEL] + tex_radial_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_RADIAL_ACCEL]) : Vector2();
+		//apply tangential acceleration;
+		Vector2 yx = Vector2(diff.y, diff.x);
+		force += yx.length() > 0.0 ? (yx * Vector2(-1.0, 1.0)).normalized() * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector2();
+		//apply attractor forces
+		p.velocity += force * local_delta;
+		//orbit velocity
+		real_t orbit_amount = (parameters[PARAM_ORBIT_VELOCITY] + tex_orbit_velocity) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_ORBIT_VELOCITY]);
+		if (orbit_amount != 0.0) {
+			real_t ang = orbit_amount * local_delta * Math_TAU;
+			// Not sure why the ParticlesMaterial code uses a clockwise rotation matrix,
+			// but we use -ang here to reproduce its behavior.
+			Transform2D rot = Transform2D(-ang, Vector2());
+			p.transform[2] -= diff;
+			p.transform[2] += rot.basis_xform(diff);
+		}
+		if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			p.velocity = p.velocity.normalized() * tex_linear_velocity;
+		}
 
-			for (int j = 0; j < 3; j++) {
-				hue_rot_mat[j] = mat1[j] + mat2[j] * hue_rot_c + mat3[j] * hue_rot_s;
+		if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
+			real_t v = p.velocity.length();
+			real_t damp = (parameters[PARAM_DAMPING] + tex_damping) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_DAMPING]);
+			v -= damp * local_delta;
+			if (v < 0.0) {
+				p.velocity = Vector2();
+			} else {
+				p.velocity = p.velocity.normalized() * v;
 			}
 		}
+		real_t base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp((real_t)1.0, p.angle_rand, randomness[PARAM_ANGLE]);
+		base_angle += p.custom[1] * lifetime * (parameters[PARAM_ANGULAR_VELOCITY] + tex_angular_velocity) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed) * 2.0f - 1.0f, randomness[PARAM_ANGULAR_VELOCITY]);
+		p.rotation = Math::deg2rad(base_angle); //angle
+		real_t animation_phase = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp((real_t)1.0, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]) + p.custom[1] * (parameters[PARAM_ANIM_SPEED] + tex_anim_speed) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_ANIM_SPEED]);
+		p.custom[2] = animation_phase;
+	}
+	//apply color
+	//apply hue rotation
 
-		if (color_ramp.is_valid()) {
-			p.color = color_ramp->get_color_at_offset(tv) * color;
-		} else {
-			p.color = color;
+	real_t tex_scale = 1.0;
+	if (curve_parameters[PARAM_SCALE].is_valid()) {
+		tex_scale = curve_parameters[PARAM_SCALE]->interpolate(tv);
+	}
+
+	Basis hue_rot_mat;
+	if (process_state.uniform_hue_rotation) {
+		hue_rot_mat = process_state.hue_rot_mat;
+	} else {
+		real_t tex_hue_variation = 0.0;
+		if (curve_parameters[PARAM_HUE_VARIATION].is_valid()) {
+			tex_hue_variation = curve_parameters[PARAM_HUE_VARIATION]->interpolate(tv);
 		}
 
-		Vector3 color_rgb = hue_rot_mat.xform_inv(Vector3(p.color.r, p.color.g, p.color.b));
-		p.color.r = color_rgb.x;
-		p.color.g = color_rgb.y;
-		p.color.b = color_rgb.z;
+		real_t hue_rot_angle = (parameters[PARAM_HUE_VARIATION] + tex_hue_variation) * Math_TAU * Math::lerp(1.0f, p.hue_rot_rand * 2.0f - 1.0f, randomness[PARAM_HUE_VARIATION]);
+		hue_rot_mat = _get_hue_rotation(hue_rot_angle);
+	}
 
-		p.color *= p.base_color;
+	if (color_ramp.is_valid()) {
+		p.color = color_ramp->get_color_at_offset(tv) * color;
+	} else {
+		p.color = color;
+	}
 
-		if (particle_flags[PARTICLE_FLAG_ALIGN_Y_TO_VELOCITY]) {
-			if (p.velocity.length() > 0.0) {
-				p.transform.elements[1] = p.velocity.normalized();
-				p.transform.elements[0] = p.transform.elements[1].orthogonal();
-			}
+	Vector3 color_rgb = hue_rot_mat.xform_inv(Vector3(p.color.r, p.color.g, p.color.b));
+	p.color.r = color_rgb.x;
+	p.color.g = color_rgb.y;
+	p.color.b = color_rgb.z;
 
-		} else {
-			p.transform.elements[0] = Vector2(Math::cos(p.rotation), -Math::sin(p.rotation));
-			p.transform.elements[1] = Vector2(Math::sin(p.rotation), Math::cos(p.rotation));
-		}
+	p.color *= p.base_color;
 
-		//scale by scale
-		real_t base_scale = tex_scale * Math::lerp(parameters[PARAM_SCALE], (real_t)1.0, p.scale_rand * randomness[PARAM_SCALE]);
-		if (base_scale < 0.000001) {
-			base_scale = 0.000001;
+	if (particle_flags[PARTICLE_FLAG_ALIGN_Y_TO_VELOCITY]) {
+		if (p.velocity.length() > 0.0) {
+			p.transform.elements[1] = p.velocity.normalized();
+			p.transform.elements[0] = p.transform.elements[1].orthogonal();
 		}
 
-		p.transform.elements[0] *= base_scale;
-		p.transform.elements[1] *= base_scale;
+	} else {
+		p.transform.elements[0] = Vector2(Math::cos(p.rotation), -Math::sin(p.rotation));
+		p.transform.elements[1] = Vector2(Math::sin(p.rotation), Math::cos(p.rotation));
+	}
 
-		p.transform[2] += p.velocity * local_delta;
+	//scale by scale
+	real_t base_scale = tex_scale * Math::lerp(parameters[PARAM_SCALE], (real_t)1.0, p.scale_rand * randomness[PARAM_SCALE]);
+	if (base_scale < 0.000001) {
+		base_scale = 0.000001;
 	}
+
+	p.transform.elements[0] *= base_scale;
+	p.transform.elements[1] *= base_scale;
+
+	p.transform[2] += p.velocity * local_delta;
 }
 
 void CPUParticles2D::_update_particle_data_buffer() {
 	MutexLock lock(update_mutex);
 
-	int pc = particles.size();
+	if (draw_order == DRAW_ORDER_INDEX) {
+		// Already written by _particles_process().
+		return;
+	}
 
-	int *ow;
-	int *order = nullptr;
+	int pc = particles.size();
 
-	float *w = particle_data.ptrw();
+	int *order = particle_order.ptrw();
+	float *ptr = particle_data.ptrw();
 	const Particle *r = particles.ptr();
-	float *ptr = w;
 
-	if (draw_order != DRAW_ORDER_INDEX) {
-		ow = particle_order.ptrw();
-		order = ow;
-
-		for (int i = 0; i < pc; i++) {
-			order[i] = i;
-		}
-		if (draw_order == DRAW_ORDER_LIFETIME) {
-			SortArray<int, SortLifetime> sorter;
-			sorter.compare.particles = r;
-			sorter.sort(order, pc);
-		}
+	for (int i = 0; i < pc; i++) {
+		order[i] = i;
+	}
+	if (draw_order == DRAW_ORDER_LIFETIME) {
+		SortArray<int, SortLifetime> sorter;
+		sorter.compare.particles = r;
+		sorter.sort(order, pc);
 	}
 
 	for (int i = 0; i < pc; i++) {
-		int idx = order ? order[i] : i;
-
-		Transform2D t = r[idx].transform;
-
-		if (!local_coords) {
-			t = inv_emission_transform * t;
-		}
-
-		if (r[idx].active) {
-			ptr[0] = t.elements[0][0];
-			ptr[1] = t.elements[1][0];
-			ptr[2] = 0;
-			ptr[3] = t.elements[2][0];
-			ptr[4] = t.elements[0][1];
-			ptr[5] = t.elements[1][1];
-			ptr[6] = 0;
-			ptr[7] = t.elements[2][1];
-
-		} else {
-			memset(ptr, 0, sizeof(float) * 8);
-		}
-
-		Color c = r[idx].color;
-
-		ptr[8] = c.r;
-		ptr[9] = c.g;
-		ptr[10] = c.b;
-		ptr[11] = c.a;
-
-		ptr[12] = r[idx].custom[0];
-		ptr[13] = r[idx].custom[1];
-		ptr[14] = r[idx].custom[2];
-		ptr[15] = r[idx].custom[3];
-
+		_fill_particle_data(ptr, r[order[i]]);
 		ptr += 16;
 	}
 }
@@ -171,8 +171,31 @@ private:
 
 	Vector2 gravity = Vector2(0, 980);
 
+	enum {
+		PARALLEL_PROCESS_THRESHOLD = 1024,
+		PROCESS_CHUNK_SIZE = 256,
+	};
+
+	// State shared by all particles for one simulation step, read by the worker threads.
+	struct ProcessState {
+		Particle *particles = nullptr;
+		float *buffer = nullptr;
+		int particle_count = 0;
+		float delta = 0.0;
+		float prev_time = 0.0;
+		float system_phase = 0.0;
+		uint32_t random_seed = 0;
+		Transform2D emission_xform;
+		Transform2D velocity_xform;
+		bool uniform_hue_rotation = false;
+		Basis hue_rot_mat;
+	} process_state;
+
 	void _update_internal();
 	void _particles_process(float p_delta);
+	void _particles_process_chunk(uint32_t p_chunk, int p_chunk_size);
+	void _process_particle(int p_index);
+	void _fill_particle_data(float *p_ptr, const Particle &p_particle) const;
 	void _update_particle_data_buffer();
 
 	Mutex update_mutex;
@@ -131,15 +131,22 @@ void Node2D::_update_transform() {
 	_mat.set_rotation_scale_and_skew(angle, _scale, skew);
 	_mat.elements[2] = pos;
 
-	RenderingServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
-
 	if (!is_inside_tree()) {
+		RenderingServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
 		return;
 	}
 
+	_queue_canvas_item_transform();
 	_notify_transform();
 }
 
+void Node2D::_queue_canvas_item_transform() {
+	// The SceneTree sends all queued canvas item transforms in one batch when flushing transforms.
+	if (!xform_batch.in_list()) {
+		get_tree()->canvas_item_xform_list.add(&xform_batch);
+	}
+}
+
 void Node2D::set_position(const Point2 &p_pos) {
 	if (_xform_dirty) {
 		((Node2D *)this)->_update_xform_values();
@@ -319,12 +326,12 @@ void Node2D::set_transform(const Transform2D &p_transform) {
 	_mat = p_transform;
 	_xform_dirty = true;
 
-	RenderingServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
-
 	if (!is_inside_tree()) {
+		RenderingServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
 		return;
 	}
 
+	_queue_canvas_item_transform();
 	_notify_transform();
 }
 
@@ -391,6 +398,17 @@ Point2 Node2D::to_global(Point2 p_local) const {
 	return get_global_transform().xform(p_local);
 }
 
+void Node2D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_EXIT_TREE: {
+			if (xform_batch.in_list()) {
+				get_tree()->canvas_item_xform_list.remove(&xform_batch);
+				RenderingServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
+			}
+		} break;
+	}
+}
+
 void Node2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_position", "position"), &Node2D::set_position);
 	ClassDB::bind_method(D_METHOD("set_rotation", "radians"), &Node2D::set_rotation);
@@ -458,3 +476,7 @@ void Node2D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "z_index", PROPERTY_HINT_RANGE, itos(RS::CANVAS_ITEM_Z_MIN) + "," + itos(RS::CANVAS_ITEM_Z_MAX) + ",1"), "set_z_index", "get_z_index");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "z_as_relative"), "set_z_as_relative", "is_z_relative");
 }
+
+Node2D::Node2D() :
+		xform_batch(this) {
+}
@@ -47,11 +47,15 @@ class Node2D : public CanvasItem {
 
 	bool _xform_dirty = false;
 
+	SelfList<Node> xform_batch;
+
 	void _update_transform();
+	void _queue_canvas_item_transform();
 
 	void _update_xform_values();
 
 protected:
+	void _notification(int p_what);
 	static void _bind_methods();
 
 public:
@@ -121,7 +125,7 @@ public:
 
 	Transform2D get_transform() const override;
 
-	Node2D() {}
+	Node2D();
 };
 
 #endif // NODE2D_H
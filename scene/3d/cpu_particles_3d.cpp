@@ -30,6 +30,7 @@
 
 #include "cpu_particles_3d.h"
 
+#include "core/templates/thread_work_pool.h"
 #include "scene/3d/camera_3d.h"
 #include "scene/3d/gpu_particles_3d.h"
 #include "scene/resources/particles_material.h"
@@ -481,6 +482,21 @@ static float rand_from_seed(uint32_t &seed) {
 	return float(seed % uint32_t(65536)) / 65535.0;
 }
 
+static Basis _get_hue_rotation(float p_angle) {
+	float c = Math::cos(p_angle);
+	float s = Math::sin(p_angle);
+
+	Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
+	Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
+	Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
+
+	Basis hue_rot_mat;
+	for (int j = 0; j < 3; j++) {
+		hue_rot_mat[j] = mat1[j] + mat2[j] * c + mat3[j] * s;
+	}
+	return hue_rot_mat;
+}
+
 void CPUParticles3D::_update_internal() {
 	if (particles.size() == 0 || !is_visible_in_tree()) {
 		_set_redraw(false);
@@ -558,11 +574,6 @@ void CPUParticles3D::_update_internal() {
 void CPUParticles3D::_particles_process(float p_delta) {
 	p_delta *= speed_scale;
 
-	int pcount = particles.size();
-	Particle *w = particles.ptrw();
-
-	Particle *parray = w;
-
 	float prev_time = time;
 	time += p_delta;
 	if (time > lifetime) {
@@ -574,497 +585,533 @@ void CPUParticles3D::_particles_process(float p_delta) {
 		}
 	}
 
-	Transform emission_xform;
-	Basis velocity_xform;
+	int pcount = particles.size();
+
+	process_state.particles = particles.ptrw();
+	process_state.particle_count = pcount;
+	process_state.delta = p_delta;
+	process_state.prev_time = prev_time;
+	process_state.system_phase = time / lifetime;
+	process_state.random_seed = Math::rand();
+
+	process_state.emission_xform = Transform();
+	process_state.velocity_xform = Basis();
 	if (!local_coords) {
-		emission_xform = get_global_transform();
-		velocity_xform = emission_xform.basis;
+		process_state.emission_xform = get_global_transform();
+		process_state.velocity_xform = process_state.emission_xform.basis;
 	}
 
-	float system_phase = time / lifetime;
+	// Without variation over lifetime or between particles, all of them share the same hue rotation.
+	process_state.uniform_hue_rotation = curve_parameters[PARAM_HUE_VARIATION].is_null() && randomness[PARAM_HUE_VARIATION] == 0.0;
+	if (process_state.uniform_hue_rotation) {
+		process_state.hue_rot_mat = _get_hue_rotation(parameters[PARAM_HUE_VARIATION] * Math_TAU);
+	}
 
-	for (int i = 0; i < pcount; i++) {
-		Particle &p = parray[i];
+	if (color_ramp.is_valid()) {
+		color_ramp->get_color_at_offset(0.0); // Sort the points now, threads only read them.
+	}
+
+	// In index order, particles are written to particle_data as they are processed, without a
+	// separate fill pass. The server owns the multimesh buffer and may live on another thread,
+	// so particle_data is still handed over with multimesh_set_buffer() afterwards.
+	MutexLock lock(update_mutex);
+	process_state.buffer = draw_order == DRAW_ORDER_INDEX ? particle_data.ptrw() : nullptr;
 
-		if (!emitting && !p.active) {
-			continue;
+	if (pcount >= PARALLEL_PROCESS_THRESHOLD && is_inside_tree()) {
+		ThreadWorkPool *work_pool = get_tree()->get_thread_work_pool();
+		if (work_pool && work_pool->get_thread_count() > 1) {
+			work_pool->do_work((pcount + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE, this, &CPUParticles3D::_particles_process_chunk, (int)PROCESS_CHUNK_SIZE);
+			return;
 		}
+	}
 
-		float local_delta = p_delta;
+	_particles_process_chunk(0, pcount);
+}
 
-		// The phase is a ratio between 0 (birth) and 1 (end of life) for each particle.
-		// While we use time in tests later on, for randomness we use the phase as done in the
-		// original shader code, and we later multiply by lifetime to get the time.
-		float restart_phase = float(i) / float(pcount);
+void CPUParticles3D::_particles_process_chunk(uint32_t p_chunk, int p_chunk_size) {
+	int from = p_chunk * p_chunk_size;
+	int to = MIN(from + p_chunk_size, process_state.particle_count);
 
-		if (randomness_ratio > 0.0) {
-			uint32_t seed = cycle;
-			if (restart_phase >= system_phase) {
-				seed -= uint32_t(1);
-			}
-			seed *= uint32_t(pcount);
-			seed += uint32_t(i);
-			float random = float(idhash(seed) % uint32_t(65536)) / 65536.0;
-			restart_phase += randomness_ratio * random * 1.0 / float(pcount);
+	for (int i = from; i < to; i++) {
+		_process_particle(i);
+		if (process_state.buffer) {
+			_fill_particle_data(process_state.buffer + i * 20, process_state.particles[i]);
 		}
+	}
+}
 
-		restart_phase *= (1.0 - explosiveness_ratio);
-		float restart_time = restart_phase * lifetime;
-		bool restart = false;
+void CPUParticles3D::_fill_particle_data(float *p_ptr, const Particle &p_particle) const {
+	if (p_particle.active) {
+		Transform t = local_coords ? p_particle.transform : inv_emission_transform * p_particle.transform;
+		p_ptr[0] = t.basis.elements[0][0];
+		p_ptr[1] = t.basis.elements[0][1];
+		p_ptr[2] = t.basis.elements[0][2];
+		p_ptr[3] = t.origin.x;
+		p_ptr[4] = t.basis.elements[1][0];
+		p_ptr[5] = t.basis.elements[1][1];
+		p_ptr[6] = t.basis.elements[1][2];
+		p_ptr[7] = t.origin.y;
+		p_ptr[8] = t.basis.elements[2][0];
+		p_ptr[9] = t.basis.elements[2][1];
+		p_ptr[10] = t.basis.elements[2][2];
+		p_ptr[11] = t.origin.z;
+	} else {
+		memset(p_ptr, 0, sizeof(float) * 12);
+	}
 
-		if (time > prev_time) {
-			// restart_time >= prev_time is used so particles emit in the first frame they are processed
+	p_ptr[12] = p_particle.color.r;
+	p_ptr[13] = p_particle.color.g;
+	p_ptr[14] = p_particle.color.b;
+	p_ptr[15] = p_particle.color.a;
 
-			if (restart_time >= prev_time && restart_time < time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = time - restart_time;
-				}
-			}
+	p_ptr[16] = p_particle.custom[0];
+	p_ptr[17] = p_particle.custom[1];
+	p_ptr[18] = p_particle.custom[2];
+	p_ptr[19] = p_particle.custom[3];
+}
 
-		} else if (local_delta > 0.0) {
-			if (restart_time >= prev_time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = lifetime - restart_time + time;
-				}
+void CPUParticles3D::_process_particle(int p_index) {
+	Particle &p = process_state.particles[p_index];
+	int pcount = process_state.particle_count;
+	float prev_time = process_state.prev_time;
+	float system_phase = process_state.system_phase;
+	const Transform &emission_xform = process_state.emission_xform;
+	const Basis &velocity_xform = process_state.velocity_xform;
 
-			} else if (restart_time < time) {
-				restart = true;
-				if (fractional_delta) {
-					local_delta = time - restart_time;
-				}
-			}
-		}
+	if (!emitting && !p.active) {
+		return;
+	}
 
-		if (p.time * (1.0 - explosiveness_ratio) > p.lifetime) {
-			restart = true;
+	float local_delta = process_state.delta;
+
+	// The phase is a ratio between 0 (birth) and 1 (end of life) for each particle.
+	// While we use time in tests later on, for randomness we use the phase as done in the
+	// original shader code, and we later multiply by lifetime to get the time.
+	float restart_phase = float(p_index) / float(pcount);
+
+	if (randomness_ratio > 0.0) {
+		uint32_t seed = cycle;
+		if (restart_phase >= system_phase) {
+			seed -= uint32_t(1);
 		}
+		seed *= uint32_t(pcount);
+		seed += uint32_t(p_index);
+		float random = float(idhash(seed) % uint32_t(65536)) / 65536.0;
+		restart_phase += randomness_ratio * random * 1.0 / float(pcount);
+	}
 
-		float tv = 0.0;
+	restart_phase *= (1.0 - explosiveness_ratio);
+	float restart_time = restart_phase * lifetime;
+	bool restart = false;
 
-		if (restart) {
-			if (!emitting) {
-				p.active = false;
-				continue;
-			}
-			p.active = true;
+	if (time > prev_time) {
+		// restart_time >= prev_time is used so particles emit in the first frame they are processed
 
-			/*float tex_linear_velocity = 0;
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(0);
-			}*/
+		if (restart_time >= prev_time && restart_time < time) {
+			restart = true;
+			if (fractional_delta) {
+				local_delta = time - restart_time;
+			}
+		}
 
-			float tex_angle = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+	} else if (local_delta > 0.0) {
+		if (restart_time >= prev_time) {
+			restart = true;
+			if (fractional_delta) {
+				local_delta = lifetime - restart_time + time;
 			}
 
-			float tex_anim_offset = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+		} else if (restart_time < time) {
+			restart = true;
+			if (fractional_delta) {
+				local_delta = time - restart_time;
 			}
+		}
+	}
 
-			p.seed = Math::rand();
+	if (p.time * (1.0 - explosiveness_ratio) > p.lifetime) {
+		restart = true;
+	}
 
-			p.angle_rand = Math::randf();
-			p.scale_rand = Math::randf();
-			p.hue_rot_rand = Math::randf();
-			p.anim_offset_rand = Math::randf();
+	float tv = 0.0;
 
-			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				float angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg2rad((Math::randf() * 2.0 - 1.0) * spread);
-				Vector3 rot = Vector3(Math::cos(angle1_rad), Math::sin(angle1_rad), 0.0);
-				p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
-			} else {
-				//initiate velocity spread in 3D
-				float angle1_rad = Math::atan2(direction.x, direction.z) + Math::deg2rad((Math::randf() * 2.0 - 1.0) * spread);
-				float angle2_rad = Math::atan2(direction.y, Math::abs(direction.z)) + Math::deg2rad((Math::randf() * 2.0 - 1.0) * (1.0 - flatness) * spread);
-
-				Vector3 direction_xz = Vector3(Math::sin(angle1_rad), 0, Math::cos(angle1_rad));
-				Vector3 direction_yz = Vector3(0, Math::sin(angle2_rad), Math::cos(angle2_rad));
-				direction_yz.z = direction_yz.z / MAX(0.0001, Math::sqrt(ABS(direction_yz.z))); //better uniform distribution
-				Vector3 direction = Vector3(direction_xz.x * direction_yz.z, direction_yz.y, direction_xz.z * direction_yz.z);
-				direction.normalize();
-				p.velocity = direction * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(Math::randf()), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
-			}
+	if (restart) {
+		if (!emitting) {
+			p.active = false;
+			return;
+		}
+		p.active = true;
 
-			float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
-			p.custom[0] = Math::deg2rad(base_angle); //angle
-			p.custom[1] = 0.0; //phase
-			p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]); //animation offset (0-1)
-			p.transform = Transform();
-			p.time = 0;
-			p.lifetime = lifetime * (1.0 - Math::randf() * lifetime_randomness);
-			p.base_color = Color(1, 1, 1, 1);
-
-			switch (emission_shape) {
-				case EMISSION_SHAPE_POINT: {
-					//do none
-				} break;
-				case EMISSION_SHAPE_SPHERE: {
-					real_t s = 2.0 * Math::randf() - 1.0;
-					real_t t = Math_TAU * Math::randf();
-					real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
-					p.transform.origin = Vector3(radius * Math::cos(t), radius * Math::sin(t), emission_sphere_radius * s);
-				} break;
-				case EMISSION_SHAPE_BOX: {
-					p.transform.origin = Vector3(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0) * emission_box_extents;
-				} break;
-				case EMISSION_SHAPE_POINTS:
-				case EMISSION_SHAPE_DIRECTED_POINTS: {
-					int pc = emission_points.size();
-					if (pc == 0) {
-						break;
-					}
+		/*float tex_linear_velocity = 0;
+		if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(0);
+		}*/
 
-					int random_idx = Math::rand() % pc;
-
-					p.transform.origin = emission_points.get(random_idx);
-
-					if (emission_shape == EMISSION_SHAPE_DIRECTED_POINTS && emission_normals.size() == pc) {
-						if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-							Vector3 normal = emission_normals.get(random_idx);
-							Vector2 normal_2d(normal.x, normal.y);
-							Transform2D m2;
-							m2.set_axis(0, normal_2d);
-							m2.set_axis(1, normal_2d.orthogonal());
-							Vector2 velocity_2d(p.velocity.x, p.velocity.y);
-							velocity_2d = m2.basis_xform(velocity_2d);
-							p.velocity.x = velocity_2d.x;
-							p.velocity.y = velocity_2d.y;
-						} else {
-							Vector3 normal = emission_normals.get(random_idx);
-							Vector3 v0 = Math::abs(normal.z) < 0.999 ? Vector3(0.0, 0.0, 1.0) : Vector3(0, 1.0, 0.0);
-							Vector3 tangent = v0.cross(normal).normalized();
-							Vector3 bitangent = tangent.cross(normal).normalized();
-							Basis m3;
-							m3.set_axis(0, tangent);
-							m3.set_axis(1, bitangent);
-							m3.set_axis(2, normal);
-							p.velocity = m3.xform(p.velocity);
-						}
-					}
+		float tex_angle = 0.0;
+		if (curve_parameters[PARAM_ANGLE].is_valid()) {
+			tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+		}
 
-					if (emission_colors.size() == pc) {
-						p.base_color = emission_colors.get(random_idx);
-					}
-				} break;
-				case EMISSION_SHAPE_MAX: { // Max value for validity check.
-					break;
-				}
-			}
+		float tex_anim_offset = 0.0;
+		if (curve_parameters[PARAM_ANGLE].is_valid()) {
+			tex_anim_offset = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+		}
 
-			if (!local_coords) {
-				p.velocity = velocity_xform.xform(p.velocity);
-				p.transform = emission_xform * p.transform;
-			}
+		uint32_t restart_seed = idhash(process_state.random_seed + uint32_t(p_index));
+		p.seed = restart_seed;
 
-			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				p.velocity.z = 0.0;
-				p.transform.origin.z = 0.0;
-			}
+		p.angle_rand = rand_from_seed(restart_seed);
+		p.scale_rand = rand_from_seed(restart_seed);
+		p.hue_rot_rand = rand_from_seed(restart_seed);
+		p.anim_offset_rand = rand_from_seed(restart_seed);
 
-		} else if (!p.active) {
-			continue;
-		} else if (p.time > p.lifetime) {
-			p.active = false;
-			tv = 1.0;
+		if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
+			float angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg2rad((rand_from_seed(restart_seed) * 2.0 - 1.0) * spread);
+			Vector3 rot = Vector3(Math::cos(angle1_rad), Math::sin(angle1_rad), 0.0);
+			p.velocity = rot * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(rand_from_seed(restart_seed)), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
 		} else {
-			uint32_t alt_seed = p.seed;
+			//initiate velocity spread in 3D
+			float angle1_rad = Math::atan2(direction.x, direction.z) + Math::deg2rad((rand_from_seed(restart_seed) * 2.0 - 1.0) * spread);
+			float angle2_rad = Math::atan2(direction.y, Math::abs(direction.z)) + Math::deg2rad((rand_from_seed(restart_seed) * 2.0 - 1.0) * (1.0 - flatness) * spread);
+
+			Vector3 direction_xz = Vector3(Math::sin(angle1_rad), 0, Math::cos(angle1_rad));
+			Vector3 direction_yz = Vector3(0, Math::sin(angle2_rad), Math::cos(angle2_rad));
+			direction_yz.z = direction_yz.z / MAX(0.0001, Math::sqrt(ABS(direction_yz.z))); //better uniform distribution
+			Vector3 direction = Vector3(direction_xz.x * direction_yz.z, direction_yz.y, direction_xz.z * direction_yz.z);
+			direction.normalize();
+			p.velocity = direction * parameters[PARAM_INITIAL_LINEAR_VELOCITY] * Math::lerp(1.0f, float(rand_from_seed(restart_seed)), randomness[PARAM_INITIAL_LINEAR_VELOCITY]);
+		}
 
-			p.time += local_delta;
-			p.custom[1] = p.time / lifetime;
-			tv = p.time / p.lifetime;
+		float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
+		p.custom[0] = Math::deg2rad(base_angle); //angle
+		p.custom[1] = 0.0; //phase
+		p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]); //animation offset (0-1)
+		p.transform = Transform();
+		p.time = 0;
+		p.lifetime = lifetime * (1.0 - rand_from_seed(restart_seed) * lifetime_randomness);
+		p.base_color = Color(1, 1, 1, 1);
+
+		switch (emission_shape) {
+			case EMISSION_SHAPE_POINT: {
+				//do none
+			} break;
+			case EMISSION_SHAPE_SPHERE: {
+				real_t s = 2.0 * rand_from_seed(restart_seed) - 1.0;
+				real_t t = Math_TAU * rand_from_seed(restart_seed);
+				real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
+				p.transform.origin = Vector3(radius * Math::cos(t), radius * Math::sin(t), emission_sphere_radius * s);
+			} break;
+			case EMISSION_SHAPE_BOX: {
+				p.transform.origin = Vector3(rand_from_seed(restart_seed) * 2.0 - 1.0, rand_from_seed(restart_seed) * 2.0 - 1.0, rand_from_seed(restart_seed) * 2.0 - 1.0) * emission_box_extents;
+			} break;
+			case EMISSION_SHAPE_POINTS:
+			case EMISSION_SHAPE_DIRECTED_POINTS: {
+				int pc = emission_points.size();
+				if (pc == 0) {
+					break;
+				}
 
-			float tex_linear_velocity = 0.0;
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(tv);
-			}
+				int random_idx = idhash(restart_seed) % pc;
+
+				p.transform.origin = emission_points.get(random_idx);
+
+				if (emission_shape == EMISSION_SHAPE_DIRECTED_POINTS && emission_normals.size() == pc) {
+					if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
+						Vector3 normal = emission_normals.get(random_idx);
+						Vector2 normal_2d(normal.x, normal.y);
+						Transform2D m2;
+						m2.set_axis(0, normal_2d);
+						m2.set_axis(1, normal_2d.orthogonal());
+						Vector2 velocity_2d(p.velocity.x, p.velocity.y);
+						velocity_2d = m2.basis_xform(velocity_2d);
+						p.velocity.x = velocity_2d.x;
+						p.velocity.y = velocity_2d.y;
+					} else {
+						Vector3 normal = emission_normals.get(random_idx);
+						Vector3 v0 = Math::abs(normal.z) < 0.999 ? Vector3(0.0, 0.0, 1.0) : Vector3(0, 1.0, 0.0);
+						Vector3 tangent = v0.cross(normal).normalized();
+						Vector3 bitangent = tangent.cross(normal).normalized();
+						Basis m3;
+						m3.set_axis(0, tangent);
+						m3.set_axis(1, bitangent);
+						m3.set_axis(2, normal);
+						p.velocity = m3.xform(p.velocity);
+					}
+				}
 
-			float tex_orbit_velocity = 0.0;
-			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				if (curve_parameters[PARAM_ORBIT_VELOCITY].is_valid()) {
-					tex_orbit_velocity = curve_parameters[PARAM_ORBIT_VELOCITY]->interpolate(tv);
+				if (emission_colors.size() == pc) {
+					p.base_color = emission_colors.get(random_idx);
 				}
+			} break;
+			case EMISSION_SHAPE_MAX: { // Max value for validity check.
+				break;
 			}
+		}
 
-			float tex_angular_velocity = 0.0;
-			if (curve_parameters[PARAM_ANGULAR_VELOCITY].is_valid()) {
-				tex_angular_velocity = curve_parameters[PARAM_ANGULAR_VELOCITY]->interpolate(tv);
-			}
+		if (!local_coords) {
+			p.velocity = velocity_xform.xform(p.velocity);
+			p.transform = emission_xform * p.transform;
+		}
 
-			float tex_linear_accel = 0.0;
-			if (curve_parameters[PARAM_LINEAR_ACCEL].is_valid()) {
-				tex_linear_accel = curve_parameters[PARAM_LINEAR_ACCEL]->interpolate(tv);
-			}
+		if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
+			p.velocity.z = 0.0;
+			p.transform.origin.z = 0.0;
+		}
 
-			float tex_tangential_accel = 0.0;
-			if (curve_parameters[PARAM_TANGENTIAL_ACCEL].is_valid()) {
-				tex_tangential_accel = curve_parameters[PARAM_TANGENTIAL_ACCEL]->interpolate(tv);
-			}
+	} else if (!p.active) {
+		return;
+	} else if (p.time > p.lifetime) {
+		p.active = false;
+		tv = 1.0;
+	} else {
+		uint32_t alt_seed = p.seed;
 
-			float tex_radial_accel = 0.0;
-			if (curve_parameters[PARAM_RADIAL_ACCEL].is_valid()) {
-				tex_radial_accel = curve_parameters[PARAM_RADIAL_ACCEL]->interpolate(tv);
-			}
+		p.time += local_delta;
+		p.custom[1] = p.time / lifetime;
+		tv = p.time / p.lifetime;
 
-			float tex_damping = 0.0;
-			if (curve_parameters[PARAM_DAMPING].is_valid()) {
-				tex_damping = curve_parameters[PARAM_DAMPING]->interpolate(tv);
-			}
+		float tex_linear_velocity = 0.0;
+		if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(tv);
+		}
 
-			float tex_angle = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(tv);
-			}
-			float tex_anim_speed = 0.0;
-			if (curve_parameters[PARAM_ANIM_SPEED].is_valid()) {
-				tex_anim_speed = curve_parameters[PARAM_ANIM_SPEED]->interpolate(tv);
+		float tex_orbit_velocity = 0.0;
+		if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
+			if (curve_parameters[PARAM_ORBIT_VELOCITY].is_valid()) {
+				tex_orbit_velocity = curve_parameters[PARAM_ORBIT_VELOCITY]->interpolate(tv);
 			}
+		}
 
-			float tex_anim_offset = 0.0;
-			if (curve_parameters[PARAM_ANIM_OFFSET].is_valid()) {
-				tex_anim_offset = curve_parameters[PARAM_ANIM_OFFSET]->interpolate(tv);
-			}
+		float tex_angular_velocity = 0.0;
+		if (curve_parameters[PARAM_ANGULAR_VELOCITY].is_valid()) {
+			tex_angular_velocity = curve_parameters[PARAM_ANGULAR_VELOCITY]->interpolate(tv);
+		}
 
-			Vector3 force = gravity;
-			Vector3 position = p.transform.origin;
-			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				position.z = 0.0;
-			}
-			//apply linear acceleration
-			force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector3();
-			//apply radial acceleration
-			Vector3 org = emission_xform.origin;
-			Vector3 diff = position - org;
-			force += diff.length() > 0.0 ? diff.normalized() * (parameters[PARAM_RADIAL_ACCEL] + tex_radial_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_RADIAL_ACCEL]) : Vector3();
-			//apply tangential acceleration;
-			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				Vector2 yx = Vector2(diff.y, diff.x);
-				Vector2 yx2 = (yx * Vector2(-1.0, 1.0)).normalized();
-				force += yx.length() > 0.0 ? Vector3(yx2.x, yx2.y, 0.0) * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector3();
+		float tex_linear_accel = 0.0;
+		if (curve_parameters[PARAM_LINEAR_ACCEL].is_valid()) {
+			tex_linear_accel = curve_parameters[PARAM_LINEAR_ACCEL]->interpolate(tv);
+		}
 
-			} else {
-				Vector3 crossDiff = diff.normalized().cross(gravity.normalized());
-				force += crossDiff.length() > 0.0 ? crossDiff.normalized() * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector3();
-			}
-			//apply attractor forces
-			p.velocity += force * local_delta;
-			//orbit velocity
-			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				float orbit_amount = (parameters[PARAM_ORBIT_VELOCITY] + tex_orbit_velocity) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_ORBIT_VELOCITY]);
-				if (orbit_amount != 0.0) {
-					float ang = orbit_amount * local_delta * Math_TAU;
-					// Not sure why the ParticlesMaterial code uses a clockwise rotation matrix,
-					// but we use -ang here to reproduce its behavior.
-					Transform2D rot = Transform2D(-ang, Vector2());
-					Vector2 rotv = rot.basis_xform(Vector2(diff.x, diff.y));
-					p.transform.origin -= Vector3(diff.x, diff.y, 0);
-					p.transform.origin += Vector3(rotv.x, rotv.y, 0);
-				}
-			}
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				p.velocity = p.velocity.normalized() * tex_linear_velocity;
-			}
-			if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
-				float v = p.velocity.length();
-				float damp = (parameters[PARAM_DAMPING] + tex_damping) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_DAMPING]);
-				v -= damp * local_delta;
-				if (v < 0.0) {
-					p.velocity = Vector3();
-				} else {
-					p.velocity = p.velocity.normalized() * v;
-				}
-			}
-			float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
-			base_angle += p.custom[1] * lifetime * (parameters[PARAM_ANGULAR_VELOCITY] + tex_angular_velocity) * Math::lerp(1.0f, rand_from_seed(alt_seed) * 2.0f - 1.0f, randomness[PARAM_ANGULAR_VELOCITY]);
-			p.custom[0] = Math::deg2rad(base_angle); //angle
-			p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]) + p.custom[1] * (parameters[PARAM_ANIM_SPEED] + tex_anim_speed) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_ANIM_SPEED]); //angle
+		float tex_tangential_accel = 0.0;
+		if (curve_parameters[PARAM_TANGENTIAL_ACCEL].is_valid()) {
+			tex_tangential_accel = curve_parameters[PARAM_TANGENTIAL_ACCEL]->interpolate(tv);
 		}
-		//apply color
-		//apply hue rotation
 
-		float tex_scale = 1.0;
-		if (curve_parameters[PARAM_SCALE].is_valid()) {
-			tex_scale = curve_parameters[PARAM_SCALE]->interpolate(tv);
+		float tex_radial_accel = 0.0;
+		if (curve_parameters[PARAM_RADIAL_ACCEL].is_valid()) {
+			tex_radial_accel = curve_parameters[PARAM_RADIAL_ACCEL]->interpolate(tv);
 		}
 
-		float tex_hue_variation = 0.0;
-		if (curve_parameters[PARAM_HUE_VARIATION].is_valid()) {
-			tex_hue_variation = curve_parameters[PARAM_HUE_VARIATION]->interpolate(tv);
+		float tex_damping = 0.0;
+		if (curve_parameters[PARAM_DAMPING].is_valid()) {
+			tex_damping = curve_parameters[PARAM_DAMPING]->interpolate(tv);
 		}
 
-		float hue_rot_angle = (parameters[PARAM_HUE_VARIATION] + tex_hue_variation) * Math_TAU * Math::lerp(1.0f, p.hue_rot_rand * 2.0f - 1.0f, randomness[PARAM_HUE_VARIATION]);
-		float hue_rot_c = Math::cos(hue_rot_angle);
-		float hue_rot_s = Math::sin(hue_rot_angle);
+		float tex_angle = 0.0;
+		if (curve_parameters[PARAM_ANGLE].is_valid()) {
+			tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+		}
+		float tex_anim_speed = 0.0;
+		if (curve_parameters[PARAM_ANIM_SPEED].is_valid()) {
+			tex_anim_speed = curve_parameters[PARAM_ANIM_SPEED]->interpolate(tv);
+		}
 
-		Basis hue_rot_mat;
-		{
-			Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
-			Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
-			Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
+		float tex_anim_offset = 0.0;
+		if (curve_parameters[PARAM_ANIM_OFFSET].is_valid()) {
+			tex_anim_offset = curve_parameters[PARAM_ANIM_OFFSET]->interpolate(tv);
+		}
 
-			for (int j = 0; j < 3; j++) {
-				hue_rot_mat[j] = mat1[j] + mat2[j] * hue_rot_c + mat3[j] * hue_rot_s;
-			}
+		Vector3 force = gravity;
+		Vector3 position = p.transform.origin;
+		if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
+			position.z = 0.0;
 		}
+		//apply linear acceleration
+		force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector3();
+		//apply radial acceleration
+		Vector3 org = emission_xform.origin;
+		Vector3 diff = position - org;
+		force += diff.length() > 0.0 ? diff.normalized() * (parameters[PARAM_RADIAL_ACCEL] + tex_radial_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_RADIAL_ACCEL]) : Vector3();
+		//apply tangential acceleration;
+		if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
+			Vector2 yx = Vector2(diff.y, diff.x);
+			Vector2 yx2 = (yx * Vector2(-1.0, 1.0)).normalized();
+			force += yx.length() > 0.0 ? Vector3(yx2.x, yx2.y, 0.0) * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector3();
 
-		if (color_ramp.is_valid()) {
-			p.color = color_ramp->get_color_at_offset(tv) * color;
 		} else {
-			p.color = color;
+			Vector3 crossDiff = diff.normalized().cross(gravity.normalized());
+			force += crossDiff.length() > 0.0 ? crossDiff.normalized() * ((parameters[PARAM_TANGENTIAL_ACCEL] + tex_tangential_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_TANGENTIAL_ACCEL])) : Vector3();
+		}
+		//apply attractor forces
+		p.velocity += force * local_delta;
+		//orbit velocity
+		if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
+			float orbit_amount = (parameters[PARAM_ORBIT_VELOCITY] + tex_orbit_velocity) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_ORBIT_VELOCITY]);
+			if (orbit_amount != 0.0) {
+				float ang = orbit_amount * local_delta * Math_TAU;
+				// Not sure why the ParticlesMaterial code uses a clockwise rotation matrix,
+				// but we use -ang here to reproduce its behavior.
+				Transform2D rot = Transform2D(-ang, Vector2());
+				Vector2 rotv = rot.basis_xform(Vector2(diff.x, diff.y));
+				p.transform.origin -= Vector3(diff.x, diff.y, 0);
+				p.transform.origin += Vector3(rotv.x, rotv.y, 0);
+			}
+		}
+		if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			p.velocity = p.velocity.normalized() * tex_linear_velocity;
+		}
+		if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
+			float v = p.velocity.length();
+			float damp = (parameters[PARAM_DAMPING] + tex_damping) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_DAMPING]);
+			v -= damp * local_delta;
+			if (v < 0.0) {
+				p.velocity = Vector3();
+			} else {
+				p.velocity = p.velocity.normalized() * v;
+			}
+		}
+		float base_angle = (parameters[PARAM_ANGLE] + tex_angle) * Math::lerp(1.0f, p.angle_rand, randomness[PARAM_ANGLE]);
+		base_angle += p.custom[1] * lifetime * (parameters[PARAM_ANGULAR_VELOCITY] + tex_angular_velocity) * Math::lerp(1.0f, rand_from_seed(alt_seed) * 2.0f - 1.0f, randomness[PARAM_ANGULAR_VELOCITY]);
+		p.custom[0] = Math::deg2rad(base_angle); //angle
+		p.custom[2] = (parameters[PARAM_ANIM_OFFSET] + tex_anim_offset) * Math::lerp(1.0f, p.anim_offset_rand, randomness[PARAM_ANIM_OFFSET]) + p.custom[1] * (parameters[PARAM_ANIM_SPEED] + tex_anim_speed) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_ANIM_SPEED]); //angle
+	}
+	//apply color
+	//apply hue rotation
+
+	float tex_scale = 1.0;
+	if (curve_parameters[PARAM_SCALE].is_valid()) {
+		tex_scale = curve_parameters[PARAM_SCALE]->interpolate(tv);
+	}
+
+	Basis hue_rot_mat;
+	if (process_state.uniform_hue_rotation) {
+		hue_rot_mat = process_state.hue_rot_mat;
+	} else {
+		float tex_hue_variation = 0.0;
+		if (curve_parameters[PARAM_HUE_VARIATION].is_valid()) {
+			tex_hue_variation = curve_parameters[PARAM_HUE_VARIATION]->interpolate(tv);
 		}
 
-		Vector3 color_rgb = hue_rot_mat.xform_inv(Vector3(p.color.r, p.color.g, p.color.b));
-		p.color.r = color_rgb.x;
-		p.color.g = color_rgb.y;
-		p.color.b = color_rgb.z;
+		float hue_rot_angle = (parameters[PARAM_HUE_VARIATION] + tex_hue_variation) * Math_TAU * Math::lerp(1.0f, p.hue_rot_rand * 2.0f - 1.0f, randomness[PARAM_HUE_VARIATION]);
+		hue_rot_mat = _get_hue_rotation(hue_rot_angle);
+	}
 
-		p.color *= p.base_color;
+	if (color_ramp.is_valid()) {
+		p.color = color_ramp->get_color_at_offset(tv) * color;
+	} else {
+		p.color = color;
+	}
 
-		if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-			if (particle_flags[PARTICLE_FLAG_ALIGN_Y_TO_VELOCITY]) {
-				if (p.velocity.length() > 0.0) {
-					p.transform.basis.set_axis(1, p.velocity.normalized());
-				} else {
-					p.transform.basis.set_axis(1, p.transform.basis.get_axis(1));
-				}
-				p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
-				p.transform.basis.set_axis(2, Vector3(0, 0, 1));
+	Vector3 color_rgb = hue_rot_mat.xform_inv(Vector3(p.color.r, p.color.g, p.color.b));
+	p.color.r = color_rgb.x;
+	p.color.g = color_rgb.y;
+	p.color.b = color_rgb.z;
+
+	p.color *= p.base_color;
 
+	if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
+		if (particle_flags[PARTICLE_FLAG_ALIGN_Y_TO_VELOCITY]) {
+			if (p.velocity.length() > 0.0) {
+				p.transform.basis.set_axis(1, p.velocity.normalized());
 			} else {
-				p.transform.basis.set_axis(0, Vector3(Math::cos(p.custom[0]), -Math::sin(p.custom[0]), 0.0));
-				p.transform.basis.set_axis(1, Vector3(Math::sin(p.custom[0]), Math::cos(p.custom[0]), 0.0));
-				p.transform.basis.set_axis(2, Vector3(0, 0, 1));
+				p.transform.basis.set_axis(1, p.transform.basis.get_axis(1));
 			}
+			p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
+			p.transform.basis.set_axis(2, Vector3(0, 0, 1));
 
 		} else {
-			//orient particle Y towards velocity
-			if (particle_flags[PARTICLE_FLAG_ALIGN_Y_TO_VELOCITY]) {
-				if (p.velocity.length() > 0.0) {
-					p.transform.basis.set_axis(1, p.velocity.normalized());
-				} else {
-					p.transform.basis.set_axis(1, p.transform.basis.get_axis(1).normalized());
-				}
-				if (p.transform.basis.get_axis(1) == p.transform.basis.get_axis(0)) {
-					p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
-					p.transform.basis.set_axis(2, p.transform.basis.get_axis(0).cross(p.transform.basis.get_axis(1)).normalized());
-				} else {
-					p.transform.basis.set_axis(2, p.transform.basis.get_axis(0).cross(p.transform.basis.get_axis(1)).normalized());
-					p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
-				}
+			p.transform.basis.set_axis(0, Vector3(Math::cos(p.custom[0]), -Math::sin(p.custom[0]), 0.0));
+			p.transform.basis.set_axis(1, Vector3(Math::sin(p.custom[0]), Math::cos(p.custom[0]), 0.0));
+			p.transform.basis.set_axis(2, Vector3(0, 0, 1));
+		}
+
+	} else {
+		//orient particle Y towards velocity
+		if (particle_flags[PARTICLE_FLAG_ALIGN_Y_TO_VELOCITY]) {
+			if (p.velocity.length() > 0.0) {
+				p.transform.basis.set_axis(1, p.velocity.normalized());
 			} else {
-				p.transform.basis.orthonormalize();
+				p.transform.basis.set_axis(1, p.transform.basis.get_axis(1).normalized());
 			}
-
-			//turn particle by rotation in Y
-			if (particle_flags[PARTICLE_FLAG_ROTATE_Y]) {
-				Basis rot_y(Vector3(0, 1, 0), p.custom[0]);
-				p.transform.basis = p.transform.basis * rot_y;
+			if (p.transform.basis.get_axis(1) == p.transform.basis.get_axis(0)) {
+				p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
+				p.transform.basis.set_axis(2, p.transform.basis.get_axis(0).cross(p.transform.basis.get_axis(1)).normalized());
+			} else {
+				p.transform.basis.set_axis(2, p.transform.basis.get_axis(0).cross(p.transform.basis.get_axis(1)).normalized());
+				p.transform.basis.set_axis(0, p.transform.basis.get_axis(1).cross(p.transform.basis.get_axis(2)).normalized());
 			}
+		} else {
+			p.transform.basis.orthonormalize();
 		}
 
-		//scale by scale
-		float base_scale = tex_scale * Math::lerp(parameters[PARAM_SCALE], 1.0f, p.scale_rand * randomness[PARAM_SCALE]);
-		if (base_scale < 0.000001) {
-			base_scale = 0.000001;
+		//turn particle by rotation in Y
+		if (particle_flags[PARTICLE_FLAG_ROTATE_Y]) {
+			Basis rot_y(Vector3(0, 1, 0), p.custom[0]);
+			p.transform.basis = p.transform.basis * rot_y;
 		}
+	}
 
-		p.transform.basis.scale(Vector3(1, 1, 1) * base_scale);
+	//scale by scale
+	float base_scale = tex_scale * Math::lerp(parameters[PARAM_SCALE], 1.0f, p.scale_rand * randomness[PARAM_SCALE]);
+	if (base_scale < 0.000001) {
+		base_scale = 0.000001;
+	}
 
-		if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-			p.velocity.z = 0.0;
-			p.transform.origin.z = 0.0;
-		}
+	p.transform.basis.scale(Vector3(1, 1, 1) * base_scale);
 
-		p.transform.origin += p.velocity * local_delta;
+	if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
+		p.velocity.z = 0.0;
+		p.transform.origin.z = 0.0;
 	}
+
+	p.transform.origin += p.velocity * local_delta;
 }
 
 void CPUParticles3D::_update_particle_data_buffer() {
 	MutexLock lock(update_mutex);
 
-	int pc = particles.size();
+	if (draw_order == DRAW_ORDER_INDEX) {
+		// Already written by _particles_process().
+		can_update.set();
+		return;
+	}
 
-	int *ow;
-	int *order = nullptr;
+	int pc = particles.size();
 
-	float *w = particle_data.ptrw();
+	int *order = particle_order.ptrw();
+	float *ptr = particle_data.ptrw();
 	const Particle *r = particles.ptr();
-	float *ptr = w;
 
-	if (draw_order != DRAW_ORDER_INDEX) {
-		ow = particle_order.ptrw();
-		order = ow;
+	for (int i = 0; i < pc; i++) {
+		order[i] = i;
+	}
+	if (draw_order == DRAW_ORDER_LIFETIME) {
+		SortArray<int, SortLifetime> sorter;
+		sorter.compare.particles = r;
+		sorter.sort(order, pc);
+	} else if (draw_order == DRAW_ORDER_VIEW_DEPTH) {
+		ERR_FAIL_NULL(get_viewport());
+		Camera3D *c = get_viewport()->get_camera();
+		if (c) {
+			Vector3 dir = c->get_global_transform().basis.get_axis(2); //far away to close
+
+			if (local_coords) {
+				// will look different from Particles in editor as this is based on the camera in the scenetree
+				// and not the editor camera
+				dir = inv_emission_transform.xform(dir).normalized();
+			} else {
+				dir = dir.normalized();
+			}
 
-		for (int i = 0; i < pc; i++) {
-			order[i] = i;
-		}
-		if (draw_order == DRAW_ORDER_LIFETIME) {
-			SortArray<int, SortLifetime> sorter;
+			SortArray<int, SortAxis> sorter;
 			sorter.compare.particles = r;
+			sorter.compare.axis = dir;
 			sorter.sort(order, pc);
-		} else if (draw_order == DRAW_ORDER_VIEW_DEPTH) {
-			ERR_FAIL_NULL(get_viewport());
-			Camera3D *c = get_viewport()->get_camera();
-			if (c) {
-				Vector3 dir = c->get_global_transform().basis.get_axis(2); //far away to close
-
-				if (local_coords) {
-					// will look different from Particles in editor as this is based on the camera in the scenetree
-					// and not the editor camera
-					dir = inv_emission_transform.xform(dir).normalized();
-				} else {
-					dir = dir.normalized();
-				}
-
-				SortArray<int, SortAxis> sorter;
-				sorter.compare.particles = r;
-				sorter.compare.axis = dir;
-				sorter.sort(order, pc);
-			}
 		}
 	}
 
 	for (int i = 0; i < pc; i++) {
-		int idx = order ? order[i] : i;
-
-		Transform t = r[idx].transform;
-
-		if (!local_coords) {
-			t = inv_emission_transform * t;
-		}
-
-		if (r[idx].active) {
-			ptr[0] = t.basis.elements[0][0];
-			ptr[1] = t.basis.elements[0][1];
-			ptr[2] = t.basis.elements[0][2];
-			ptr[3] = t.origin.x;
-			ptr[4] = t.basis.elements[1][0];
-			ptr[5] = t.basis.elements[1][1];
-			ptr[6] = t.basis.elements[1][2];
-			ptr[7] = t.origin.y;
-			ptr[8] = t.basis.elements[2][0];
-			ptr[9] = t.basis.elements[2][1];
-			ptr[10] = t.basis.elements[2][2];
-			ptr[11] = t.origin.z;
-		} else {
-			memset(ptr, 0, sizeof(float) * 12);
-		}
-
-		Color c = r[idx].color;
-
-		ptr[12] = c.r;
-		ptr[13] = c.g;
-		ptr[14] = c.b;
-		ptr[15] = c.a;
-
-		ptr[16] = r[idx].custom[0];
-		ptr[17] = r[idx].custom[1];
-		ptr[18] = r[idx].custom[2];
-		ptr[19] = r[idx].custom[3];
-
+		_fill_particle_data(ptr, r[order[i]]);
 		ptr += 20;
 	}
 
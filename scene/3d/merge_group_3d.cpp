@@ -0,0 +1,366 @@
+/*************************************************************************/
+/*  merge_group_3d.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "merge_group_3d.h"
+
+#include "core/config/engine.h"
+#include "scene/resources/surface_tool.h"
+
+void MergeGroup3D::_find_instances(Node *p_node, const Transform &p_parent_xform, Map<InstanceKey, SurfaceMap> &r_instances, LocalVector<MeshInstance3D *> &r_sources) {
+	if (Object::cast_to<MergeGroup3D>(p_node)) {
+		return; // Nested groups merge their own children.
+	}
+
+	// Only nodes placed by the group are merged. Transforms are accumulated from the group
+	// rather than taken from the tree, so scenes can be merged before they enter it.
+	Node3D *node_3d = Object::cast_to<Node3D>(p_node);
+	if (!node_3d || node_3d->is_set_as_top_level() || !node_3d->is_visible()) {
+		return;
+	}
+
+	Transform xform = p_parent_xform * node_3d->get_transform();
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_find_instances(p_node->get_child(i), xform, r_instances, r_sources);
+	}
+
+	MeshInstance3D *mi = Object::cast_to<MeshInstance3D>(p_node);
+	// Sources merged at runtime keep their visibility, but no longer have a base.
+	if (!mi || !mi->get_base().is_valid() || mi->has_meta("_merged_mesh")) {
+		return;
+	}
+
+	Ref<Mesh> mesh = mi->get_mesh();
+	if (mesh.is_null() || mesh->get_surface_count() == 0 || mesh->get_blend_shape_count() > 0 || mi->get_skin().is_valid()) {
+		return;
+	}
+
+	const uint32_t format_mask = ((1 << RS::ARRAY_COMPRESS_FLAGS_BASE) - 1) & ~RS::ARRAY_FORMAT_INDEX;
+
+	for (int i = 0; i < mesh->get_surface_count(); i++) {
+		if (mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES) {
+			return;
+		}
+		uint32_t format = mesh->surface_get_format(i);
+		if (format & (RS::ARRAY_FORMAT_BONES | RS::ARRAY_FLAG_USE_2D_VERTICES)) {
+			return;
+		}
+	}
+
+	InstanceKey instance_key;
+	AABB aabb = xform.xform(mesh->get_aabb());
+	Vector3 center = aabb.position + aabb.size * 0.5;
+	instance_key.cell = Vector3i(Math::floor(center.x / cell_size), Math::floor(center.y / cell_size), Math::floor(center.z / cell_size));
+	instance_key.cast_shadows = mi->get_cast_shadows_setting();
+	instance_key.layers = mi->get_layer_mask();
+
+	SurfaceMap &surfaces = r_instances[instance_key];
+
+	for (int i = 0; i < mesh->get_surface_count(); i++) {
+		SurfaceKey surface_key;
+		surface_key.material = mi->get_material_override().is_valid() ? mi->get_material_override() : mi->get_active_material(i);
+		surface_key.format = mesh->surface_get_format(i) & format_mask;
+
+		SurfaceSource source;
+		source.mesh = mesh;
+		source.surface = i;
+		source.xform = xform;
+		surfaces[surface_key].push_back(source);
+	}
+
+	r_sources.push_back(mi);
+}
+
+static void _append_custom_array(Variant &r_dst, const Variant &p_src) {
+	if (r_dst.get_type() == Variant::NIL) {
+		r_dst = p_src;
+	} else if (p_src.get_type() == Variant::PACKED_BYTE_ARRAY) {
+		PackedByteArray dst = r_dst;
+		dst.append_array(p_src);
+		r_dst = dst;
+	} else if (p_src.get_type() == Variant::PACKED_FLOAT32_ARRAY) {
+		PackedFloat32Array dst = r_dst;
+		dst.append_array(p_src);
+		r_dst = dst;
+	}
+}
+
+Array MergeGroup3D::_merge_surfaces(const LocalVector<SurfaceSource> &p_sources, uint32_t p_format) {
+	PackedVector3Array vertices;
+	PackedVector3Array normals;
+	PackedFloat32Array tangents;
+	PackedColorArray colors;
+	PackedVector2Array uvs;
+	PackedVector2Array uv2s;
+	Variant customs[RS::ARRAY_CUSTOM_COUNT];
+	PackedInt32Array indices;
+
+	for (uint32_t i = 0; i < p_sources.size(); i++) {
+		const SurfaceSource &source = p_sources[i];
+		Array arrays = source.mesh->surface_get_arrays(source.surface);
+
+		int vertex_from = vertices.size();
+		// Mirrored instances flip the winding of their triangles and the handedness of their tangents.
+		bool mirrored = source.xform.basis.determinant() < 0;
+
+		PackedVector3Array src_vertices = arrays[RS::ARRAY_VERTEX];
+		for (int j = 0; j < src_vertices.size(); j++) {
+			vertices.push_back(source.xform.xform(src_vertices[j]));
+		}
+
+		if (p_format & RS::ARRAY_FORMAT_NORMAL) {
+			Basis normal_basis = source.xform.basis.inverse().transposed();
+			PackedVector3Array src_normals = arrays[RS::ARRAY_NORMAL];
+			for (int j = 0; j < src_normals.size(); j++) {
+				normals.push_back(normal_basis.xform(src_normals[j]).normalized());
+			}
+		}
+
+		if (p_format & RS::ARRAY_FORMAT_TANGENT) {
+			PackedFloat32Array src_tangents = arrays[RS::ARRAY_TANGENT];
+			for (int j = 0; j < src_tangents.size() / 4; j++) {
+				Vector3 tangent = source.xform.basis.xform(Vector3(src_tangents[j * 4 + 0], src_tangents[j * 4 + 1], src_tangents[j * 4 + 2])).normalized();
+				tangents.push_back(tangent.x);
+				tangents.push_back(tangent.y);
+				tangents.push_back(tangent.z);
+				tangents.push_back(mirrored ? -src_tangents[j * 4 + 3] : src_tangents[j * 4 + 3]);
+			}
+		}
+
+		if (p_format & RS::ARRAY_FORMAT_COLOR) {
+			colors.append_array(arrays[RS::ARRAY_COLOR]);
+		}
+		if (p_format & RS::ARRAY_FORMAT_TEX_UV) {
+			uvs.append_array(arrays[RS::ARRAY_TEX_UV]);
+		}
+		if (p_format & RS::ARRAY_FORMAT_TEX_UV2) {
+			uv2s.append_array(arrays[RS::ARRAY_TEX_UV2]);
+		}
+		for (int j = 0; j < RS::ARRAY_CUSTOM_COUNT; j++) {
+			if (p_format & (RS::ARRAY_FORMAT_CUSTOM0 << j)) {
+				_append_custom_array(customs[j], arrays[RS::ARRAY_CUSTOM0 + j]);
+			}
+		}
+
+		PackedInt32Array src_indices = arrays[RS::ARRAY_INDEX];
+		int index_count = src_indices.size() ? src_indices.size() : src_vertices.size();
+		for (int j = 0; j < index_count; j += 3) {
+			int tri[3];
+			for (int k = 0; k < 3; k++) {
+				tri[k] = vertex_from + (src_indices.size() ? src_indices[j + k] : j + k);
+			}
+			if (mirrored) {
+				SWAP(tri[1], tri[2]);
+			}
+			indices.push_back(tri[0]);
+			indices.push_back(tri[1]);
+			indices.push_back(tri[2]);
+		}
+	}
+
+	Array arrays;
+	arrays.resize(RS::ARRAY_MAX);
+	arrays[RS::ARRAY_VERTEX] = vertices;
+	if (p_format & RS::ARRAY_FORMAT_NORMAL) {
+		arrays[RS::ARRAY_NORMAL] = normals;
+	}
+	if (p_format & RS::ARRAY_FORMAT_TANGENT) {
+		arrays[RS::ARRAY_TANGENT] = tangents;
+	}
+	if (p_format & RS::ARRAY_FORMAT_COLOR) {
+		arrays[RS::ARRAY_COLOR] = colors;
+	}
+	if (p_format & RS::ARRAY_FORMAT_TEX_UV) {
+		arrays[RS::ARRAY_TEX_UV] = uvs;
+	}
+	if (p_format & RS::ARRAY_FORMAT_TEX_UV2) {
+		arrays[RS::ARRAY_TEX_UV2] = uv2s;
+	}
+	for (int i = 0; i < RS::ARRAY_CUSTOM_COUNT; i++) {
+		if (p_format & (RS::ARRAY_FORMAT_CUSTOM0 << i)) {
+			arrays[RS::ARRAY_CUSTOM0 + i] = customs[i];
+		}
+	}
+	arrays[RS::ARRAY_INDEX] = indices;
+
+	return arrays;
+}
+
+Dictionary MergeGroup3D::_generate_lods(const Array &p_arrays) {
+	Dictionary lods;
+
+	if (!SurfaceTool::simplify_func || !SurfaceTool::simplify_scale_func) {
+		return lods;
+	}
+
+	// Same progression as the scene importer: halve the index count until the simplifier can't keep up.
+	Vector<Vector3> vertices = p_arrays[RS::ARRAY_VERTEX];
+	Vector<int> indices = p_arrays[RS::ARRAY_INDEX];
+	const int min_indices = 10;
+	int index_target = indices.size() / 2;
+
+	float mesh_scale = SurfaceTool::simplify_scale_func((const float *)vertices.ptr(), vertices.size(), sizeof(Vector3));
+	const float target_error = 1e-3f;
+	float abs_target_error = target_error / mesh_scale;
+
+	while (index_target > min_indices) {
+		float error;
+		Vector<int> new_indices;
+		new_indices.resize(indices.size());
+		size_t new_len = SurfaceTool::simplify_func((unsigned int *)new_indices.ptrw(), (const unsigned int *)indices.ptr(), indices.size(), (const float *)vertices.ptr(), vertices.size(), sizeof(Vector3), index_target, abs_target_error, &error);
+		if ((int)new_len > (index_target * 120 / 100)) {
+			break; // 20 percent tolerance
+		}
+
+		float distance = error * mesh_scale;
+		if (Math::is_zero_approx(distance)) {
+			break;
+		}
+
+		new_indices.resize(new_len);
+		lods[distance] = new_indices;
+		abs_target_error = distance;
+		index_target /= 2;
+	}
+
+	return lods;
+}
+
+void MergeGroup3D::build_merged_meshes(LocalVector<MeshInstance3D *> &r_merged, LocalVector<MeshInstance3D *> &r_sources) {
+	ERR_FAIL_COND(cell_size <= 0);
+
+	Map<InstanceKey, SurfaceMap> instances;
+	LocalVector<MeshInstance3D *> sources;
+
+	for (int i = 0; i < get_child_count(); i++) {
+		_find_instances(get_child(i), Transform(), instances, sources);
+	}
+
+	if (sources.size() < 2) {
+		return;
+	}
+
+	for (Map<InstanceKey, SurfaceMap>::Element *E = instances.front(); E; E = E->next()) {
+		Ref<ArrayMesh> mesh;
+		mesh.instance();
+
+		for (SurfaceMap::Element *F = E->get().front(); F; F = F->next()) {
+			Array arrays = _merge_surfaces(F->get(), F->key().format);
+			mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays, Array(), generate_lods ? _generate_lods(arrays) : Dictionary());
+			mesh->surface_set_material(mesh->get_surface_count() - 1, F->key().material);
+		}
+
+		MeshInstance3D *mi = memnew(MeshInstance3D);
+		mi->set_name("MergedMesh");
+		mi->set_mesh(mesh);
+		mi->set_cast_shadows_setting(E->key().cast_shadows);
+		mi->set_layer_mask(E->key().layers);
+		mi->set_meta("_merged_mesh", true);
+		r_merged.push_back(mi);
+	}
+
+	for (uint32_t i = 0; i < sources.size(); i++) {
+		r_sources.push_back(sources[i]);
+	}
+}
+
+int MergeGroup3D::merge_meshes() {
+	LocalVector<MeshInstance3D *> merged;
+	LocalVector<MeshInstance3D *> sources;
+	build_merged_meshes(merged, sources);
+
+	Node *owner = get_owner() ? get_owner() : this;
+	for (uint32_t i = 0; i < merged.size(); i++) {
+		add_child(merged[i], true);
+		merged[i]->set_owner(owner);
+	}
+
+	for (uint32_t i = 0; i < sources.size(); i++) {
+		if (Engine::get_singleton()->is_editor_hint()) {
+			// Keep the originals in the saved scene, so merging can be undone by deleting the merged meshes.
+			sources[i]->hide();
+		} else {
+			// Only drop the rendering side, scripts and children (such as collision) keep working.
+			sources[i]->set_base(RID());
+		}
+	}
+
+	return merged.size();
+}
+
+void MergeGroup3D::set_cell_size(float p_size) {
+	ERR_FAIL_COND(p_size <= 0);
+	cell_size = p_size;
+}
+
+float MergeGroup3D::get_cell_size() const {
+	return cell_size;
+}
+
+void MergeGroup3D::set_generate_lods(bool p_enable) {
+	generate_lods = p_enable;
+}
+
+bool MergeGroup3D::is_generating_lods() const {
+	return generate_lods;
+}
+
+void MergeGroup3D::set_merge_on_ready(bool p_enable) {
+	merge_on_ready = p_enable;
+}
+
+bool MergeGroup3D::is_merge_on_ready() const {
+	return merge_on_ready;
+}
+
+void MergeGroup3D::_notification(int p_what) {
+	if (p_what == NOTIFICATION_READY) {
+		if (merge_on_ready && !Engine::get_singleton()->is_editor_hint()) {
+			merge_meshes();
+		}
+	}
+}
+
+void MergeGroup3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_cell_size", "size"), &MergeGroup3D::set_cell_size);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &MergeGroup3D::get_cell_size);
+	ClassDB::bind_method(D_METHOD("set_generate_lods", "enable"), &MergeGroup3D::set_generate_lods);
+	ClassDB::bind_method(D_METHOD("is_generating_lods"), &MergeGroup3D::is_generating_lods);
+	ClassDB::bind_method(D_METHOD("set_merge_on_ready", "enable"), &MergeGroup3D::set_merge_on_ready);
+	ClassDB::bind_method(D_METHOD("is_merge_on_ready"), &MergeGroup3D::is_merge_on_ready);
+	ClassDB::bind_method(D_METHOD("merge_meshes"), &MergeGroup3D::merge_meshes);
+
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cell_size", PROPERTY_HINT_RANGE, "0.5,1024,0.5,or_greater"), "set_cell_size", "get_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "generate_lods"), "set_generate_lods", "is_generating_lods");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "merge_on_ready"), "set_merge_on_ready", "is_merge_on_ready");
+}
+
+MergeGroup3D::MergeGroup3D() {
+}
@@ -0,0 +1,105 @@
+/*************************************************************************/
+/*  merge_group_3d.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef MERGE_GROUP_3D_H
+#define MERGE_GROUP_3D_H
+
+#include "core/templates/local_vector.h"
+#include "scene/3d/mesh_instance_3d.h"
+
+class MergeGroup3D : public Node3D {
+	GDCLASS(MergeGroup3D, Node3D);
+
+	float cell_size = 32.0;
+	bool generate_lods = true;
+	bool merge_on_ready = true;
+
+	struct InstanceKey {
+		Vector3i cell;
+		GeometryInstance3D::ShadowCastingSetting cast_shadows = GeometryInstance3D::SHADOW_CASTING_SETTING_ON;
+		uint32_t layers = 0;
+
+		bool operator<(const InstanceKey &p_key) const {
+			if (cell != p_key.cell) {
+				return cell < p_key.cell;
+			}
+			if (cast_shadows != p_key.cast_shadows) {
+				return cast_shadows < p_key.cast_shadows;
+			}
+			return layers < p_key.layers;
+		}
+	};
+
+	struct SurfaceKey {
+		Ref<Material> material;
+		uint32_t format = 0;
+
+		bool operator<(const SurfaceKey &p_key) const {
+			if (material != p_key.material) {
+				return material.ptr() < p_key.material.ptr();
+			}
+			return format < p_key.format;
+		}
+	};
+
+	struct SurfaceSource {
+		Ref<Mesh> mesh;
+		int surface = 0;
+		Transform xform;
+	};
+
+	typedef Map<SurfaceKey, LocalVector<SurfaceSource>> SurfaceMap;
+
+	void _find_instances(Node *p_node, const Transform &p_parent_xform, Map<InstanceKey, SurfaceMap> &r_instances, LocalVector<MeshInstance3D *> &r_sources);
+	static Array _merge_surfaces(const LocalVector<SurfaceSource> &p_sources, uint32_t p_format);
+	static Dictionary _generate_lods(const Array &p_arrays);
+
+protected:
+	void _notification(int p_what);
+	static void _bind_methods();
+
+public:
+	void set_cell_size(float p_size);
+	float get_cell_size() const;
+
+	void set_generate_lods(bool p_enable);
+	bool is_generating_lods() const;
+
+	void set_merge_on_ready(bool p_enable);
+	bool is_merge_on_ready() const;
+
+	// Builds the merged meshes without adding them to the tree or touching the sources, for tools that apply the result themselves.
+	void build_merged_meshes(LocalVector<MeshInstance3D *> &r_merged, LocalVector<MeshInstance3D *> &r_sources);
+	int merge_meshes();
+
+	MergeGroup3D();
+};
+
+#endif // MERGE_GROUP_3D_H
@@ -33,6 +33,7 @@
 #include "core/config/engine.h"
 #include "core/config/project_settings.h"
 #include "core/object/message_queue.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/variant/type_info.h"
 #include "scene/3d/physics_body_3d.h"
 #include "scene/resources/surface_tool.h"
@@ -69,6 +70,8 @@ SkinReference::~SkinReference() {
 
 ///////////////////////////////////////
 
+SelfList<Skeleton3D>::List Skeleton3D::dirty_skeletons;
+
 bool Skeleton3D::_set(const StringName &p_path, const Variant &p_value) {
 	String path = p_path;
 
@@ -223,146 +226,232 @@ void Skeleton3D::_update_process_order() {
 	process_order_dirty = false;
 }
 
-void Skeleton3D::_notification(int p_what) {
-	switch (p_what) {
-		case NOTIFICATION_UPDATE_SKELETON: {
-			RenderingServer *rs = RenderingServer::get_singleton();
-			Bone *bonesptr = bones.ptrw();
-			int len = bones.size();
+void Skeleton3D::_update_dirty_skeletons() {
+	UpdateBatch batch;
+	LocalVector<Skeleton3D *> &skeletons = batch.skeletons;
+	while (dirty_skeletons.first()) {
+		Skeleton3D *skeleton = dirty_skeletons.first()->self();
+		dirty_skeletons.remove(dirty_skeletons.first());
 
-			_update_process_order();
+		skeleton->_update_process_order();
+		skeleton->bones.ptrw(); // Make sure the bones are not shared before threads write to them.
+		skeletons.push_back(skeleton);
+	}
 
-			const int *order = process_order.ptr();
+	ThreadWorkPool *work_pool = nullptr;
+	if (skeletons.size() >= PARALLEL_UPDATE_THRESHOLD && SceneTree::get_singleton()) {
+		work_pool = SceneTree::get_singleton()->get_thread_work_pool();
+	}
 
-			for (int i = 0; i < len; i++) {
-				Bone &b = bonesptr[order[i]];
+	if (work_pool && work_pool->get_thread_count() > 1) {
+		work_pool->do_work(skeletons.size(), &batch, &UpdateBatch::update_bone_poses, (void *)nullptr);
+	} else {
+		for (uint32_t i = 0; i < skeletons.size(); i++) {
+			skeletons[i]->_update_bone_poses();
+		}
+	}
 
-				if (b.disable_rest) {
-					if (b.enabled) {
-						Transform pose = b.pose;
-						if (b.custom_pose_enable) {
-							pose = b.custom_pose * pose;
-						}
-						if (b.parent >= 0) {
-							b.pose_global = bonesptr[b.parent].pose_global * pose;
-							b.pose_global_no_override = bonesptr[b.parent].pose_global * pose;
-						} else {
-							b.pose_global = pose;
-							b.pose_global_no_override = pose;
-						}
-					} else {
-						if (b.parent >= 0) {
-							b.pose_global = bonesptr[b.parent].pose_global;
-							b.pose_global_no_override = bonesptr[b.parent].pose_global;
-						} else {
-							b.pose_global = Transform();
-							b.pose_global_no_override = Transform();
-						}
-					}
+	// Bound nodes and the rendering server are only touched from the main thread.
+	for (uint32_t i = 0; i < skeletons.size(); i++) {
+		skeletons[i]->_update_bound_nodes_and_skins();
+	}
+}
+
+void Skeleton3D::_update_skeleton() {
+	dirty_skeletons.remove(&dirty_list);
+
+	_update_process_order();
+	_update_bone_poses();
+	_update_bound_nodes_and_skins();
+}
+
+void Skeleton3D::_update_bone_poses() {
+	Bone *bonesptr = bones.ptrw();
+	int len = bones.size();
+	const int *order = process_order.ptr();
+
+	for (int i = 0; i < len; i++) {
+		Bone &b = bonesptr[order[i]];
 
+		// Bones are processed parents first, so only dirty bones and their descendants are recomputed.
+		if (!b.pose_dirty && (b.parent < 0 || !bonesptr[b.parent].pose_updated)) {
+			b.pose_updated = false;
+			continue;
+		}
+
+		b.pose_dirty = false;
+		b.pose_updated = true;
+
+		if (b.disable_rest) {
+			if (b.enabled) {
+				Transform pose = b.pose;
+				if (b.custom_pose_enable) {
+					pose = b.custom_pose * pose;
+				}
+				if (b.parent >= 0) {
+					b.pose_global = bonesptr[b.parent].pose_global * pose;
+					b.pose_global_no_override = bonesptr[b.parent].pose_global * pose;
 				} else {
-					if (b.enabled) {
-						Transform pose = b.pose;
-						if (b.custom_pose_enable) {
-							pose = b.custom_pose * pose;
-						}
-						if (b.parent >= 0) {
-							b.pose_global = bonesptr[b.parent].pose_global * (b.rest * pose);
-							b.pose_global_no_override = bonesptr[b.parent].pose_global * (b.rest * pose);
-						} else {
-							b.pose_global = b.rest * pose;
-							b.pose_global_no_override = b.rest * pose;
-						}
-					} else {
-						if (b.parent >= 0) {
-							b.pose_global = bonesptr[b.parent].pose_global * b.rest;
-							b.pose_global_no_override = bonesptr[b.parent].pose_global * b.rest;
-						} else {
-							b.pose_global = b.rest;
-							b.pose_global_no_override = b.rest;
-						}
-					}
+					b.pose_global = pose;
+					b.pose_global_no_override = pose;
 				}
-
-				if (b.global_pose_override_amount >= CMP_EPSILON) {
-					b.pose_global = b.pose_global.interpolate_with(b.global_pose_override, b.global_pose_override_amount);
+			} else {
+				if (b.parent >= 0) {
+					b.pose_global = bonesptr[b.parent].pose_global;
+					b.pose_global_no_override = bonesptr[b.parent].pose_global;
+				} else {
+					b.pose_global = Transform();
+					b.pose_global_no_override = Transform();
 				}
+			}
 
-				if (b.global_pose_override_reset) {
-					b.global_pose_override_amount = 0.0;
+		} else {
+			if (b.enabled) {
+				Transform pose = b.pose;
+				if (b.custom_pose_enable) {
+					pose = b.custom_pose * pose;
 				}
-
-				for (List<ObjectID>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
-					Object *obj = ObjectDB::get_instance(E->get());
-					ERR_CONTINUE(!obj);
-					Node3D *node_3d = Object::cast_to<Node3D>(obj);
-					ERR_CONTINUE(!node_3d);
-					node_3d->set_transform(b.pose_global);
+				if (b.parent >= 0) {
+					b.pose_global = bonesptr[b.parent].pose_global * (b.rest * pose);
+					b.pose_global_no_override = bonesptr[b.parent].pose_global * (b.rest * pose);
+				} else {
+					b.pose_global = b.rest * pose;
+					b.pose_global_no_override = b.rest * pose;
+				}
+			} else {
+				if (b.parent >= 0) {
+					b.pose_global = bonesptr[b.parent].pose_global * b.rest;
+					b.pose_global_no_override = bonesptr[b.parent].pose_global * b.rest;
+				} else {
+					b.pose_global = b.rest;
+					b.pose_global_no_override = b.rest;
 				}
 			}
+		}
 
-			//update skins
-			for (Set<SkinReference *>::Element *E = skin_bindings.front(); E; E = E->next()) {
-				const Skin *skin = E->get()->skin.operator->();
-				RID skeleton = E->get()->skeleton;
-				uint32_t bind_count = skin->get_bind_count();
-
-				if (E->get()->bind_count != bind_count) {
-					RS::get_singleton()->skeleton_allocate_data(skeleton, bind_count);
-					E->get()->bind_count = bind_count;
-					E->get()->skin_bone_indices.resize(bind_count);
-					E->get()->skin_bone_indices_ptrs = E->get()->skin_bone_indices.ptrw();
-				}
+		if (b.global_pose_override_amount >= CMP_EPSILON) {
+			b.pose_global = b.pose_global.interpolate_with(b.global_pose_override, b.global_pose_override_amount);
+		}
+
+		if (b.global_pose_override_reset && b.global_pose_override_amount >= CMP_EPSILON) {
+			b.global_pose_override_amount = 0.0;
+			b.pose_dirty = true; // Drop the override on the next update.
+		}
+	}
+}
+
+void Skeleton3D::_update_bound_nodes_and_skins() {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	const Bone *bonesptr = bones.ptr();
+	int len = bones.size();
+
+	for (int i = 0; i < len; i++) {
+		const Bone &b = bonesptr[i];
+		if (!b.pose_updated) {
+			continue;
+		}
 
-				if (E->get()->skeleton_version != version) {
-					for (uint32_t i = 0; i < bind_count; i++) {
-						StringName bind_name = skin->get_bind_name(i);
-
-						if (bind_name != StringName()) {
-							//bind name used, use this
-							bool found = false;
-							for (int j = 0; j < len; j++) {
-								if (bonesptr[j].name == bind_name) {
-									E->get()->skin_bone_indices_ptrs[i] = j;
-									found = true;
-									break;
-								}
-							}
-
-							if (!found) {
-								ERR_PRINT("Skin bind #" + itos(i) + " contains named bind '" + String(bind_name) + "' but Skeleton3D has no bone by that name.");
-								E->get()->skin_bone_indices_ptrs[i] = 0;
-							}
-						} else if (skin->get_bind_bone(i) >= 0) {
-							int bind_index = skin->get_bind_bone(i);
-							if (bind_index >= len) {
-								ERR_PRINT("Skin bind #" + itos(i) + " contains bone index bind: " + itos(bind_index) + " , which is greater than the skeleton bone count: " + itos(len) + ".");
-								E->get()->skin_bone_indices_ptrs[i] = 0;
-							} else {
-								E->get()->skin_bone_indices_ptrs[i] = bind_index;
-							}
-						} else {
-							ERR_PRINT("Skin bind #" + itos(i) + " does not contain a name nor a bone index.");
-							E->get()->skin_bone_indices_ptrs[i] = 0;
+		for (const List<ObjectID>::Element *E = b.nodes_bound.front(); E; E = E->next()) {
+			Object *obj = ObjectDB::get_instance(E->get());
+			ERR_CONTINUE(!obj);
+			Node3D *node_3d = Object::cast_to<Node3D>(obj);
+			ERR_CONTINUE(!node_3d);
+			node_3d->set_transform(b.pose_global);
+		}
+	}
+
+	// Update skins, sending all the bones of each skin in a single call.
+	PackedFloat32Array bone_transforms;
+	for (Set<SkinReference *>::Element *E = skin_bindings.front(); E; E = E->next()) {
+		const Skin *skin = E->get()->skin.operator->();
+		RID skeleton = E->get()->skeleton;
+		uint32_t bind_count = skin->get_bind_count();
+
+		if (E->get()->bind_count != bind_count) {
+			RS::get_singleton()->skeleton_allocate_data(skeleton, bind_count);
+			E->get()->bind_count = bind_count;
+			E->get()->skin_bone_indices.resize(bind_count);
+			E->get()->skin_bone_indices_ptrs = E->get()->skin_bone_indices.ptrw();
+		}
+
+		if (E->get()->skeleton_version != version) {
+			for (uint32_t i = 0; i < bind_count; i++) {
+				StringName bind_name = skin->get_bind_name(i);
+
+				if (bind_name != StringName()) {
+					//bind name used, use this
+					bool found = false;
+					for (int j = 0; j < len; j++) {
+						if (bonesptr[j].name == bind_name) {
+							E->get()->skin_bone_indices_ptrs[i] = j;
+							found = true;
+							break;
 						}
 					}
 
-					E->get()->skeleton_version = version;
+					if (!found) {
+						ERR_PRINT("Skin bind #" + itos(i) + " contains named bind '" + String(bind_name) + "' but Skeleton3D has no bone by that name.");
+						E->get()->skin_bone_indices_ptrs[i] = 0;
+					}
+				} else if (skin->get_bind_bone(i) >= 0) {
+					int bind_index = skin->get_bind_bone(i);
+					if (bind_index >= len) {
+						ERR_PRINT("Skin bind #" + itos(i) + " contains bone index bind: " + itos(bind_index) + " , which is greater than the skeleton bone count: " + itos(len) + ".");
+						E->get()->skin_bone_indices_ptrs[i] = 0;
+					} else {
+						E->get()->skin_bone_indices_ptrs[i] = bind_index;
+					}
+				} else {
+					ERR_PRINT("Skin bind #" + itos(i) + " does not contain a name nor a bone index.");
+					E->get()->skin_bone_indices_ptrs[i] = 0;
 				}
+			}
 
-				for (uint32_t i = 0; i < bind_count; i++) {
-					uint32_t bone_index = E->get()->skin_bone_indices_ptrs[i];
-					ERR_CONTINUE(bone_index >= (uint32_t)len);
-					rs->skeleton_bone_set_transform(skeleton, i, bonesptr[bone_index].pose_global * skin->get_bind_pose(i));
-				}
+			E->get()->skeleton_version = version;
+		}
+
+		bone_transforms.resize(bind_count * 12);
+		float *dataptr = bone_transforms.ptrw();
+		for (uint32_t i = 0; i < bind_count; i++) {
+			uint32_t bone_index = E->get()->skin_bone_indices_ptrs[i];
+			Transform xform;
+			if (bone_index < (uint32_t)len) {
+				xform = bonesptr[bone_index].pose_global * skin->get_bind_pose(i);
+			} else {
+				ERR_PRINT("Skin bind #" + itos(i) + " points to invalid bone index " + itos(bone_index) + ".");
 			}
 
-			dirty = false;
+			dataptr[0] = xform.basis.elements[0][0];
+			dataptr[1] = xform.basis.elements[0][1];
+			dataptr[2] = xform.basis.elements[0][2];
+			dataptr[3] = xform.origin.x;
+			dataptr[4] = xform.basis.elements[1][0];
+			dataptr[5] = xform.basis.elements[1][1];
+			dataptr[6] = xform.basis.elements[1][2];
+			dataptr[7] = xform.origin.y;
+			dataptr[8] = xform.basis.elements[2][0];
+			dataptr[9] = xform.basis.elements[2][1];
+			dataptr[10] = xform.basis.elements[2][2];
+			dataptr[11] = xform.origin.z;
+			dataptr += 12;
+		}
+		rs->skeleton_set_bone_transforms(skeleton, bone_transforms);
+	}
+
+	dirty = false;
 
 #ifdef TOOLS_ENABLED
-			emit_signal(SceneStringNames::get_singleton()->pose_updated);
+	emit_signal(SceneStringNames::get_singleton()->pose_updated);
 #endif // TOOLS_ENABLED
+}
 
+void Skeleton3D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_UPDATE_SKELETON: {
+			// Dirty skeletons are updated in batches, so this one may already be up to date.
+			if (dirty) {
+				_update_dirty_skeletons();
+			}
 		} break;
 
 #ifndef _3D_DISABLED
@@ -401,13 +490,14 @@ void Skeleton3D::set_bone_global_pose_override(int p_bone, const Transform &p_po
 	bones.write[p_bone].global_pose_override_amount = p_amount;
 	bones.write[p_bone].global_pose_override = p_pose;
 	bones.write[p_bone].global_pose_override_reset = !p_persistent;
-	_make_dirty();
+	_make_bone_dirty(p_bone);
 }
 
 Transform Skeleton3D::get_bone_global_pose(int p_bone) const {
 	ERR_FAIL_INDEX_V(p_bone, bones.size(), Transform());
 	if (dirty) {
-		const_cast<Skeleton3D *>(this)->notification(NOTIFICATION_UPDATE_SKELETON);
+		// Only this skeleton is needed now, the others are updated with the rest of the batch.
+		const_cast<Skeleton3D *>(this)->_update_skeleton();
 	}
 	return bones[p_bone].pose_global;
 }
@@ -415,7 +505,8 @@ Transform Skeleton3D::get_bone_global_pose(int p_bone) const {
 Transform Skeleton3D::get_bone_global_pose_no_override(int p_bone) const {
 	ERR_FAIL_INDEX_V(p_bone, bones.size(), Transform());
 	if (dirty) {
-		const_cast<Skeleton3D *>(this)->notification(NOTIFICATION_UPDATE_SKELETON);
+		// Only this skeleton is needed now, the others are updated with the rest of the batch.
+		const_cast<Skeleton3D *>(this)->_update_skeleton();
 	}
 	return bones[p_bone].pose_global_no_override;
 }
@@ -528,7 +619,7 @@ void Skeleton3D::set_bone_rest(int p_bone, const Transform &p_rest) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
 	bones.write[p_bone].rest = p_rest;
-	_make_dirty();
+	_make_bone_dirty(p_bone);
 }
 
 Transform Skeleton3D::get_bone_rest(int p_bone) const {
@@ -541,7 +632,7 @@ void Skeleton3D::set_bone_enabled(int p_bone, bool p_enabled) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
 	bones.write[p_bone].enabled = p_enabled;
-	_make_dirty();
+	_make_bone_dirty(p_bone);
 }
 
 bool Skeleton3D::is_bone_enabled(int p_bone) const {
@@ -595,8 +686,9 @@ void Skeleton3D::set_bone_pose(int p_bone, const Transform &p_pose) {
 	ERR_FAIL_INDEX(p_bone, bones.size());
 
 	bones.write[p_bone].pose = p_pose;
+	bones.write[p_bone].pose_dirty = true;
 	if (is_inside_tree()) {
-		_make_dirty();
+		_make_bone_dirty(p_bone);
 	}
 }
 
@@ -612,7 +704,7 @@ void Skeleton3D::set_bone_custom_pose(int p_bone, const Transform &p_custom_pose
 	bones.write[p_bone].custom_pose_enable = (p_custom_pose != Transform());
 	bones.write[p_bone].custom_pose = p_custom_pose;
 
-	_make_dirty();
+	_make_bone_dirty(p_bone);
 }
 
 Transform Skeleton3D::get_bone_custom_pose(int p_bone) const {
@@ -621,11 +713,29 @@ Transform Skeleton3D::get_bone_custom_pose(int p_bone) const {
 }
 
 void Skeleton3D::_make_dirty() {
+	Bone *bonesptr = bones.ptrw();
+	for (int i = 0; i < bones.size(); i++) {
+		bonesptr[i].pose_dirty = true;
+	}
+
+	if (dirty) {
+		return;
+	}
+
+	MessageQueue::get_singleton()->push_notification(this, NOTIFICATION_UPDATE_SKELETON);
+	dirty_skeletons.add(&dirty_list);
+	dirty = true;
+}
+
+void Skeleton3D::_make_bone_dirty(int p_bone) {
+	bones.write[p_bone].pose_dirty = true;
+
 	if (dirty) {
 		return;
 	}
 
 	MessageQueue::get_singleton()->push_notification(this, NOTIFICATION_UPDATE_SKELETON);
+	dirty_skeletons.add(&dirty_list);
 	dirty = true;
 }
 
@@ -952,7 +1062,8 @@ void Skeleton3D::_bind_methods() {
 	BIND_CONSTANT(NOTIFICATION_UPDATE_SKELETON);
 }
 
-Skeleton3D::Skeleton3D() {
+Skeleton3D::Skeleton3D() :
+		dirty_list(this) {
 }
 
 Skeleton3D::~Skeleton3D() {
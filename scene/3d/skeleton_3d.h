@@ -31,7 +31,9 @@
 #ifndef SKELETON_3D_H
 #define SKELETON_3D_H
 
+#include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
+#include "core/templates/self_list.h"
 #include "scene/3d/node_3d.h"
 #include "scene/resources/skin.h"
 
@@ -92,6 +94,9 @@ private:
 		bool global_pose_override_reset = false;
 		Transform global_pose_override;
 
+		bool pose_dirty = true; // The global pose of this bone must be recomputed.
+		bool pose_updated = false; // The global pose changed in the last update, so children must follow.
+
 #ifndef _3D_DISABLED
 		PhysicalBone3D *physical_bone = nullptr;
 		PhysicalBone3D *cache_parent_physical_bone = nullptr;
@@ -110,8 +115,28 @@ private:
 	bool process_order_dirty = true;
 
 	void _make_dirty();
+	void _make_bone_dirty(int p_bone);
 	bool dirty = false;
 
+	// Skeletons made dirty during a frame are updated together, so their poses can be computed in parallel.
+	enum {
+		PARALLEL_UPDATE_THRESHOLD = 4,
+	};
+
+	SelfList<Skeleton3D> dirty_list;
+	static SelfList<Skeleton3D>::List dirty_skeletons;
+
+	// The skeletons of one batched update, the thread pool calls a method of this for each of them.
+	struct UpdateBatch {
+		LocalVector<Skeleton3D *> skeletons;
+		void update_bone_poses(uint32_t p_index, void *p_userdata) { skeletons[p_index]->_update_bone_poses(); }
+	};
+
+	static void _update_dirty_skeletons();
+	void _update_skeleton();
+	void _update_bone_poses();
+	void _update_bound_nodes_and_skins();
+
 	uint64_t version = 1;
 
 	// bind helpers
@@ -40,8 +40,10 @@
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
+#include "core/templates/thread_work_pool.h"
 #include "node.h"
 #include "scene/debugger/scene_debugger.h"
+#include "scene/main/canvas_item.h"
 #include "scene/resources/font.h"
 #include "scene/resources/material.h"
 #include "scene/resources/mesh.h"
@@ -147,6 +149,10 @@ void SceneTree::make_group_changed(const StringName &p_group) {
 }
 
 void SceneTree::flush_transform_notifications() {
+	// Visual instances notified below queue their new transforms instead of calling the server one by one.
+	bool was_batching = batching_instance_xforms;
+	batching_instance_xforms = true;
+
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
 		Node *node = n->self();
@@ -155,6 +161,87 @@ void SceneTree::flush_transform_notifications() {
 		n = nx;
 		node->notification(NOTIFICATION_TRANSFORM_CHANGED);
 	}
+
+	batching_instance_xforms = was_batching;
+	if (!batching_instance_xforms) {
+		_flush_instance_transforms();
+	}
+
+	_flush_canvas_item_transforms();
+}
+
+void SceneTree::_batch_instance_transform(RID p_instance, const Transform &p_transform) {
+	if (!batching_instance_xforms) {
+		RenderingServer::get_singleton()->instance_set_transform(p_instance, p_transform);
+		return;
+	}
+
+	int index = batched_instances.size();
+	batched_instances.push_back(p_instance);
+	batched_instance_xforms.resize((index + 1) * 12);
+
+	float *w = batched_instance_xforms.ptrw() + index * 12;
+	w[0] = p_transform.basis.elements[0][0];
+	w[1] = p_transform.basis.elements[0][1];
+	w[2] = p_transform.basis.elements[0][2];
+	w[3] = p_transform.origin.x;
+	w[4] = p_transform.basis.elements[1][0];
+	w[5] = p_transform.basis.elements[1][1];
+	w[6] = p_transform.basis.elements[1][2];
+	w[7] = p_transform.origin.y;
+	w[8] = p_transform.basis.elements[2][0];
+	w[9] = p_transform.basis.elements[2][1];
+	w[10] = p_transform.basis.elements[2][2];
+	w[11] = p_transform.origin.z;
+}
+
+void SceneTree::_flush_instance_transforms() {
+	if (batched_instances.is_empty()) {
+		return;
+	}
+
+	RenderingServer::get_singleton()->instances_set_transforms(batched_instances, batched_instance_xforms);
+	batched_instances.clear();
+	batched_instance_xforms.clear();
+}
+
+void SceneTree::_flush_canvas_item_transforms() {
+	int count = 0;
+	for (SelfList<Node> *n = canvas_item_xform_list.first(); n; n = n->next()) {
+		count++;
+	}
+
+	if (count == 0) {
+		return;
+	}
+
+	Vector<RID> items;
+	PackedFloat32Array xforms;
+	items.resize(count);
+	xforms.resize(count * 6);
+
+	RID *items_w = items.ptrw();
+	float *xforms_w = xforms.ptrw();
+
+	// Only nodes inside the tree are listed, and they leave the list when exiting it, so every RID is alive.
+	SelfList<Node> *n = canvas_item_xform_list.first();
+	for (int i = 0; i < count; i++) {
+		CanvasItem *ci = static_cast<CanvasItem *>(n->self());
+		SelfList<Node> *nx = n->next();
+		canvas_item_xform_list.remove(n);
+		n = nx;
+
+		Transform2D xform = ci->get_transform();
+		items_w[i] = ci->get_canvas_item();
+		xforms_w[i * 6 + 0] = xform.elements[0].x;
+		xforms_w[i * 6 + 1] = xform.elements[0].y;
+		xforms_w[i * 6 + 2] = xform.elements[1].x;
+		xforms_w[i * 6 + 3] = xform.elements[1].y;
+		xforms_w[i * 6 + 4] = xform.elements[2].x;
+		xforms_w[i * 6 + 5] = xform.elements[2].y;
+	}
+
+	RenderingServer::get_singleton()->canvas_items_set_transforms(items, xforms);
 }
 
 void SceneTree::_flush_ugc() {
@@ -481,6 +568,7 @@ bool SceneTree::process(float p_time) {
 	flush_transform_notifications(); //additional transforms after timers update
 
 	_call_idle_callbacks();
+	_flush_canvas_item_transforms(); //anything moved by idle callbacks must still make it into this frame
 
 #ifdef TOOLS_ENABLED
 
@@ -1305,6 +1393,16 @@ void SceneTree::add_idle_callback(IdleCallback p_callback) {
 	idle_callbacks[idle_callback_count++] = p_callback;
 }
 
+ThreadWorkPool *SceneTree::get_thread_work_pool() {
+	// Work is dispatched one batch at a time, so the pool can't be shared with other threads.
+	ERR_FAIL_COND_V_MSG(Thread::get_caller_id() != Thread::get_main_id(), nullptr, "The scene thread work pool can only be used from the main thread.");
+	if (!thread_work_pool) {
+		thread_work_pool = memnew(ThreadWorkPool);
+		thread_work_pool->init();
+	}
+	return thread_work_pool;
+}
+
 void SceneTree::get_argument_options(const StringName &p_function, int p_idx, List<String> *r_options) const {
 	if (p_function == "change_scene") {
 		DirAccessRef dir_access = DirAccess::create(DirAccess::ACCESS_RESOURCES);
@@ -1469,6 +1567,11 @@ SceneTree::~SceneTree() {
 		memdelete(root);
 	}
 
+	if (thread_work_pool) {
+		thread_work_pool->finish();
+		memdelete(thread_work_pool);
+	}
+
 	if (singleton == this) {
 		singleton = nullptr;
 	}
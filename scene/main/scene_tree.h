@@ -47,6 +47,7 @@ class Window;
 class Material;
 class Mesh;
 class SceneDebugger;
+class ThreadWorkPool;
 
 class SceneTreeTimer : public Reference {
 	GDCLASS(SceneTreeTimer, Reference);
@@ -164,6 +165,9 @@ private:
 	void _connection_failed();
 	void _server_disconnected();
 
+	// Shared by the nodes that spread their processing over threads, started when first needed.
+	ThreadWorkPool *thread_work_pool = nullptr;
+
 	static SceneTree *singleton;
 	friend class Node;
 
@@ -183,11 +187,23 @@ private:
 	void _flush_delete_queue();
 	// Optimization.
 	friend class CanvasItem;
+	friend class Node2D;
 	friend class Node3D;
 	friend class Viewport;
+	friend class VisualInstance3D;
 
 	SelfList<Node>::List xform_change_list;
 
+	// Transforms are sent to the RenderingServer in one batch per flush instead of one call per node.
+	SelfList<Node>::List canvas_item_xform_list;
+	bool batching_instance_xforms = false;
+	Vector<RID> batched_instances;
+	PackedFloat32Array batched_instance_xforms;
+
+	void _batch_instance_transform(RID p_instance, const Transform &p_transform);
+	void _flush_instance_transforms();
+	void _flush_canvas_item_transforms();
+
 #ifdef DEBUG_ENABLED // No live editor in release build.
 	friend class LiveEditor;
 #endif
@@ -345,6 +361,8 @@ public:
 
 	static void add_idle_callback(IdleCallback p_callback);
 
+	ThreadWorkPool *get_thread_work_pool();
+
 	//default texture settings
 
 	SceneTree();
@@ -52,6 +52,7 @@ private:
 	bool use_custom_data = false;
 	int instance_count = 0;
 	int visible_instance_count = -1;
+	int chunk_size = 0;
 
 protected:
 	static void _bind_methods();
@@ -92,6 +93,9 @@ public:
 	void set_visible_instance_count(int p_count);
 	int get_visible_instance_count() const;
 
+	void set_chunk_size(int p_size);
+	int get_chunk_size() const;
+
 	void set_instance_transform(int p_instance, const Transform &p_transform);
 	void set_instance_transform_2d(int p_instance, const Transform2D &p_transform);
 	Transform get_instance_transform(int p_instance) const;
@@ -30,8 +30,11 @@
 
 #include "texture.h"
 
+#include "core/config/engine.h"
+#include "core/config/project_settings.h"
 #include "core/core_string_names.h"
 #include "core/io/image_loader.h"
+#include "core/object/message_queue.h"
 #include "core/os/os.h"
 #include "mesh.h"
 #include "scene/resources/bit_map.h"
@@ -338,6 +341,8 @@ Ref<Image> StreamTexture2D::load_image_from_file(FileAccess *f, int p_size_limit
 		uint64_t total_size = 0;
 
 		bool first = true;
+		int first_w = sw;
+		int first_h = sh;
 
 		for (uint32_t i = 0; i < mipmaps + 1; i++) {
 			uint32_t size = f->get_32();
@@ -374,6 +379,8 @@ Ref<Image> StreamTexture2D::load_image_from_file(FileAccess *f, int p_size_limit
 				//format will actually be the format of the first image,
 				//as it may have changed on compression
 				format = img->get_format();
+				first_w = sw;
+				first_h = sh;
 				first = false;
 			} else if (img->get_format() != format) {
 				img->convert(format); //all needs to be the same format
@@ -415,24 +422,26 @@ Ref<Image> StreamTexture2D::load_image_from_file(FileAccess *f, int p_size_limit
 				}
 			}
 
-			image->create(w, h, true, mipmap_images[0]->get_format(), img_data);
+			image->create(first_w, first_h, true, mipmap_images[0]->get_format(), img_data);
 			return image;
 		}
 
 	} else if (data_format == DATA_FORMAT_IMAGE) {
 		int size = Image::get_image_data_size(w, h, format, mipmaps ? true : false);
+		uint64_t data_pos = f->get_position();
 
 		for (uint32_t i = 0; i < mipmaps + 1; i++) {
 			int tw, th;
 			int ofs = Image::get_image_mipmap_offset_and_dimensions(w, h, format, i, tw, th);
 
-			if (p_size_limit > 0 && i < mipmaps && (p_size_limit > tw || p_size_limit > th)) {
-				if (ofs) {
-					f->seek(f->get_position() + ofs);
-				}
+			if (p_size_limit > 0 && i < mipmaps && (tw > p_size_limit || th > p_size_limit)) {
 				continue; //oops, size limit enforced, go to next
 			}
 
+			if (ofs) {
+				f->seek(data_pos + ofs);
+			}
+
 			Vector<uint8_t> data;
 			data.resize(size - ofs);
 
@@ -482,6 +491,117 @@ void StreamTexture2D::_requested_normal(void *p_ud) {
 	request_normal_callback(stex);
 }
 
+Thread StreamTexture2D::stream_thread;
+Mutex StreamTexture2D::stream_mutex;
+Semaphore StreamTexture2D::stream_semaphore;
+SafeFlag StreamTexture2D::stream_exit;
+List<StreamTexture2D::StreamRequest> StreamTexture2D::stream_requests;
+Map<ObjectID, String> StreamTexture2D::stream_paths;
+
+void StreamTexture2D::_requested_stream(ObjectID p_owner, int p_size) {
+	// Called from the rendering thread, the texture may be freed at any time.
+	MutexLock lock(stream_mutex);
+
+	const Map<ObjectID, String>::Element *E = stream_paths.find(p_owner);
+	if (!E) {
+		return; // Freed, or no longer streamed.
+	}
+
+	StreamRequest request;
+	request.owner = p_owner;
+	request.path = E->get();
+	request.size = p_size;
+
+#ifdef NO_THREADS
+	_load_stream_request(request);
+#else
+	// Only the last requested size matters.
+	for (List<StreamRequest>::Element *R = stream_requests.front(); R; R = R->next()) {
+		if (R->get().owner == p_owner) {
+			R->get() = request;
+			return;
+		}
+	}
+	stream_requests.push_back(request);
+
+	if (!stream_thread.is_started()) {
+		stream_exit.clear();
+		stream_thread.start(_stream_thread_func, nullptr);
+	}
+	stream_semaphore.post();
+#endif
+}
+
+void StreamTexture2D::_stream_thread_func(void *p_ud) {
+	while (true) {
+		stream_semaphore.wait();
+		if (stream_exit.is_set()) {
+			break;
+		}
+
+		StreamRequest request;
+		{
+			MutexLock lock(stream_mutex);
+			if (stream_requests.is_empty()) {
+				continue;
+			}
+			request = stream_requests.front()->get();
+			stream_requests.pop_front();
+		}
+
+		_load_stream_request(request);
+	}
+}
+
+void StreamTexture2D::_load_stream_request(const StreamRequest &p_request) {
+	int lw, lh, lwc, lhc;
+	Ref<Image> image;
+	image.instance();
+
+	bool request_3d;
+	bool request_normal;
+	bool request_roughness;
+	int mipmap_limit;
+
+	Error err = _load_data(p_request.path, lw, lh, lwc, lhc, image, request_3d, request_normal, request_roughness, mipmap_limit, p_request.size);
+	ERR_FAIL_COND(err != OK);
+
+	// Dropped by the message queue if the texture was freed in the meantime.
+	MessageQueue::get_singleton()->push_call(p_request.owner, "_apply_streamed_image", image, p_request.path);
+}
+
+void StreamTexture2D::_set_streamed(const String &p_path) {
+	MutexLock lock(stream_mutex);
+	if (p_path.is_empty()) {
+		stream_paths.erase(get_instance_id());
+	} else {
+		stream_paths[get_instance_id()] = p_path;
+	}
+}
+
+void StreamTexture2D::_apply_streamed_image(const Ref<Image> &p_image, const String &p_path) {
+	if (!texture.is_valid() || p_path != path_to_file) {
+		return; // Loaded from another file since it was requested.
+	}
+
+	alpha_cache.unref();
+	RID new_texture = RS::get_singleton()->texture_2d_create(p_image);
+	RS::get_singleton()->texture_replace(texture, new_texture);
+	RS::get_singleton()->texture_set_size_override(texture, w, h);
+}
+
+void StreamTexture2D::finish_streaming() {
+	if (stream_thread.is_started()) {
+		stream_exit.set();
+		stream_semaphore.post();
+		stream_thread.wait_to_finish();
+	}
+
+	MutexLock lock(stream_mutex);
+	stream_requests.clear();
+	stream_paths.clear();
+}
+
 StreamTexture2D::TextureFormatRequestCallback StreamTexture2D::request_3d_callback = nullptr;
 StreamTexture2D::TextureFormatRoughnessRequestCallback StreamTexture2D::request_roughness_callback = nullptr;
 StreamTexture2D::TextureFormatRequestCallback StreamTexture2D::request_normal_callback = nullptr;
@@ -491,8 +611,6 @@ Image::Format StreamTexture2D::get_format() const {
 }
 
 Error StreamTexture2D::_load_data(const String &p_path, int &tw, int &th, int &tw_custom, int &th_custom, Ref<Image> &image, bool &r_request_3d, bool &r_request_normal, bool &r_request_roughness, int &mipmap_limit, int p_size_limit) {
-	alpha_cache.unref();
-
 	ERR_FAIL_COND_V(image.is_null(), ERR_INVALID_PARAMETER);
 
 	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
@@ -560,7 +678,15 @@ Error StreamTexture2D::load(const String &p_path) {
 	bool request_roughness;
 	int mipmap_limit;
 
-	Error err = _load_data(p_path, lw, lh, lwc, lhc, image, request_3d, request_normal, request_roughness, mipmap_limit);
+	// Streamed textures start with their smallest mipmaps, the renderer requests the rest as they get closer.
+	int size_limit = 0;
+	if (!Engine::get_singleton()->is_editor_hint() && bool(GLOBAL_GET("rendering/textures/streaming/enabled"))) {
+		size_limit = GLOBAL_GET("rendering/textures/streaming/min_size");
+	}
+
+	alpha_cache.unref();
+
+	Error err = _load_data(p_path, lw, lh, lwc, lhc, image, request_3d, request_normal, request_roughness, mipmap_limit, size_limit);
 	if (err) {
 		return err;
 	}
@@ -575,6 +701,14 @@ Error StreamTexture2D::load(const String &p_path) {
 		RS::get_singleton()->texture_set_size_override(texture, lwc, lhc);
 	}
 
+	if (size_limit > 0 && lwc && lhc && MAX(image->get_width(), image->get_height()) < MAX(lwc, lhc)) {
+		_set_streamed(p_path);
+		RS::get_singleton()->texture_set_stream_callback(texture, Size2i(lwc, lhc), _requested_stream, get_instance_id());
+	} else {
+		_set_streamed(String());
+		RS::get_singleton()->texture_set_stream_callback(texture, Size2i(), nullptr, ObjectID());
+	}
+
 	w = lwc ? lwc : lw;
 	h = lhc ? lhc : lh;
 	path_to_file = p_path;
@@ -724,6 +858,7 @@ void StreamTexture2D::_validate_property(PropertyInfo &property) const {
 void StreamTexture2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("load", "path"), &StreamTexture2D::load);
 	ClassDB::bind_method(D_METHOD("get_load_path"), &StreamTexture2D::get_load_path);
+	ClassDB::bind_method(D_METHOD("_apply_streamed_image", "image", "path"), &StreamTexture2D::_apply_streamed_image);
 
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "load_path", PROPERTY_HINT_FILE, "*.stex"), "load", "get_load_path");
 }
@@ -731,6 +866,7 @@ void StreamTexture2D::_bind_methods() {
 StreamTexture2D::StreamTexture2D() {}
 
 StreamTexture2D::~StreamTexture2D() {
+	_set_streamed(String());
 	if (texture.is_valid()) {
 		RS::get_singleton()->free(texture);
 	}
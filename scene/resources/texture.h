@@ -37,7 +37,10 @@
 #include "core/os/file_access.h"
 #include "core/os/mutex.h"
 #include "core/os/rw_lock.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/safe_refcount.h"
 #include "scene/resources/curve.h"
 #include "scene/resources/gradient.h"
 #include "servers/camera_server.h"
@@ -158,7 +161,7 @@ public:
 	};
 
 private:
-	Error _load_data(const String &p_path, int &tw, int &th, int &tw_custom, int &th_custom, Ref<Image> &image, bool &r_request_3d, bool &r_request_normal, bool &r_request_roughness, int &mipmap_limit, int p_size_limit = 0);
+	static Error _load_data(const String &p_path, int &tw, int &th, int &tw_custom, int &th_custom, Ref<Image> &image, bool &r_request_3d, bool &r_request_normal, bool &r_request_roughness, int &mipmap_limit, int p_size_limit = 0);
 	String path_to_file;
 	mutable RID texture;
 	Image::Format format = Image::FORMAT_MAX;
@@ -171,6 +174,25 @@ private:
 	static void _requested_3d(void *p_ud);
 	static void _requested_roughness(void *p_ud, const String &p_normal_path, RS::TextureDetectRoughnessChannel p_roughness_channel);
 	static void _requested_normal(void *p_ud);
+	// Larger mipmaps of streamed textures are loaded on a thread, and only swapped in on the main thread.
+	struct StreamRequest {
+		ObjectID owner;
+		String path;
+		int size = 0;
+	};
+
+	static Thread stream_thread;
+	static Mutex stream_mutex;
+	static Semaphore stream_semaphore;
+	static SafeFlag stream_exit;
+	static List<StreamRequest> stream_requests;
+	static Map<ObjectID, String> stream_paths; // Files of the streamed textures, read without touching the textures themselves.
+
+	static void _requested_stream(ObjectID p_owner, int p_size);
+	static void _stream_thread_func(void *p_ud);
+	static void _load_stream_request(const StreamRequest &p_request);
+	void _set_streamed(const String &p_path);
+	void _apply_streamed_image(const Ref<Image> &p_image, const String &p_path);
 
 protected:
 	static void _bind_methods();
@@ -186,6 +208,8 @@ public:
 	static TextureFormatRoughnessRequestCallback request_roughness_callback;
 	static TextureFormatRequestCallback request_normal_callback;
 
+	static void finish_streaming();
+
 	Image::Format get_format() const;
 	Error load(const String &p_path);
 	String get_load_path() const;
@@ -30,6 +30,7 @@
 
 #include "renderer_canvas_cull.h"
 
+#include "core/config/project_settings.h"
 #include "core/math/geometry_2d.h"
 #include "renderer_viewport.h"
 #include "rendering_server_default.h"
@@ -37,14 +38,19 @@
 
 static const int z_range = RS::CANVAS_ITEM_Z_MAX - RS::CANVAS_ITEM_Z_MIN + 1;
 
-void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel) {
+void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, ChildBVH *p_child_bvh, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel) {
 	RENDER_TIMESTAMP("Cull CanvasItem Tree");
 
 	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 
-	for (int i = 0; i < p_child_item_count; i++) {
-		_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr);
+	if (p_child_bvh) {
+		// Nothing is drawn behind a canvas, so unindexed children are never skipped here.
+		_cull_child_bvh(p_child_bvh, false, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr);
+	} else {
+		for (int i = 0; i < p_child_item_count; i++) {
+			_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr);
+		}
 	}
 	if (p_canvas_item) {
 		_cull_canvas_item(p_canvas_item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr);
@@ -114,6 +120,9 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 	if (ci->children_order_dirty) {
 		ci->child_items.sort_custom<ItemIndexSort>();
 		ci->children_order_dirty = false;
+		if (ci->child_bvh) {
+			ci->child_bvh->unindexed_dirty = true;
+		}
 	}
 
 	Rect2 rect = ci->get_rect();
@@ -185,6 +194,16 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 		canvas_group_from = z_last_list[zidx];
 	}
 
+	// Y-sorting and canvas groups need every child, so the child BVH is only used without them.
+	bool use_bvh = ci->child_bvh != nullptr && !ci->sort_y && !use_canvas_group;
+	if (use_bvh) {
+		_update_child_bvh(ci);
+
+		// Indexed children are never drawn behind their parent, only the others need checking here.
+		child_item_count = ci->child_bvh->unindexed_items.size();
+		child_items = ci->child_bvh->unindexed_items.ptr();
+	}
+
 	for (int i = 0; i < child_item_count; i++) {
 		if ((!child_items[i]->behind && !use_canvas_group) || (ci->sort_y && child_items[i]->sort_y)) {
 			continue;
@@ -292,6 +311,11 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 		ci->next = nullptr;
 	}
 
+	if (use_bvh) {
+		_cull_child_bvh(ci->child_bvh, true, xform, p_clip_rect, modulate, p_z, z_list, z_last_list, (Item *)ci->final_clip_owner, p_material_owner);
+		return;
+	}
+
 	for (int i = 0; i < child_item_count; i++) {
 		if (child_items[i]->behind || use_canvas_group || (ci->sort_y && child_items[i]->sort_y)) {
 			continue;
@@ -304,6 +328,218 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 	}
 }
 
+void RendererCanvasCull::_cull_child_bvh(ChildBVH *p_child_bvh, bool p_skip_behind, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner) {
+	Item **visible_items = p_child_bvh->cull_result.ptr();
+	int visible_count = 0;
+
+	if (p_child_bvh->indexed_count && p_transform.basis_determinant() != 0) {
+		// Same test as in _cull_canvas_item(), done in the parent's space. The extra unit
+		// accounts for children origins being floored when snapping transforms to pixels.
+		Rect2 local_clip_rect = p_transform.affine_inverse().xform(Rect2(Point2(), p_clip_rect.size)).grow(1.0);
+
+		p_child_bvh->cull_result.resize(p_child_bvh->indexed_count);
+		visible_items = p_child_bvh->cull_result.ptr();
+		visible_count = p_child_bvh->bvh.cull_aabb(local_clip_rect, visible_items, p_child_bvh->indexed_count);
+
+		SortArray<Item *, ItemIndexSort> sorter;
+		sorter.sort(visible_items, visible_count);
+	}
+
+	// Merge the visible indexed children with the unindexed ones, keeping the draw order.
+	Item **unindexed_items = p_child_bvh->unindexed_items.ptr();
+	int unindexed_count = p_child_bvh->unindexed_items.size();
+
+	int u = 0;
+	int v = 0;
+	while (u < unindexed_count || v < visible_count) {
+		Item *child;
+		if (v == visible_count || (u < unindexed_count && unindexed_items[u]->index <= visible_items[v]->index)) {
+			child = unindexed_items[u++];
+			if (p_skip_behind && child->behind) {
+				continue;
+			}
+		} else {
+			child = visible_items[v++];
+		}
+
+		_cull_canvas_item(child, p_transform, p_clip_rect, p_modulate, p_z, z_list, z_last_list, p_canvas_clip, p_material_owner);
+	}
+}
+
+bool RendererCanvasCull::_is_child_bvh_leaf(const Item *p_item) const {
+	if (p_item->child_items.size() || p_item->behind || p_item->update_when_visible || p_item->copy_back_buffer || p_item->vp_render || p_item->canvas_group || p_item->sort_y || p_item->skeleton.is_valid()) {
+		return false;
+	}
+
+	// The bounds of these commands can change without the canvas item being touched.
+	for (const Item::Command *c = p_item->commands; c; c = c->next) {
+		if (c->type == Item::Command::TYPE_MESH || c->type == Item::Command::TYPE_MULTIMESH || c->type == Item::Command::TYPE_PARTICLES) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+RendererCanvasCull::ChildBVH *RendererCanvasCull::_get_parent_child_bvh(Item *p_item) {
+	if (canvas_item_owner.owns(p_item->parent)) {
+		return canvas_item_owner.getornull(p_item->parent)->child_bvh;
+	}
+
+	Canvas *canvas = canvas_owner.getornull(p_item->parent);
+	return canvas ? canvas->child_bvh : nullptr;
+}
+
+void RendererCanvasCull::_child_bvh_mark_dirty(Item *p_item) {
+	if (p_item->bvh_dirty || p_item->parent.is_null()) {
+		return;
+	}
+
+	ChildBVH *child_bvh = _get_parent_child_bvh(p_item);
+	if (!child_bvh) {
+		return;
+	}
+
+	p_item->bvh_dirty = true;
+	child_bvh->dirty_items.push_back(p_item);
+}
+
+void RendererCanvasCull::_child_bvh_queue(ChildBVH *p_child_bvh, Item *p_item) {
+	p_child_bvh->unindexed_dirty = true;
+	if (!p_item->bvh_dirty) {
+		p_item->bvh_dirty = true;
+		p_child_bvh->dirty_items.push_back(p_item);
+	}
+}
+
+void RendererCanvasCull::_child_bvh_erase(ChildBVH *p_child_bvh, Item *p_item) {
+	if (p_item->bvh_dirty) {
+		p_child_bvh->dirty_items.erase(p_item);
+		p_item->bvh_dirty = false;
+	}
+	if (!p_item->bvh_handle.is_invalid()) {
+		p_child_bvh->bvh.erase(p_item->bvh_handle);
+		p_item->bvh_handle.set_invalid();
+		p_child_bvh->indexed_count--;
+	}
+	p_child_bvh->unindexed_dirty = true;
+}
+
+void RendererCanvasCull::_child_bvh_add(Item *p_parent, Item *p_item) {
+	if (p_parent->child_items.size() == 1) {
+		// No longer a leaf.
+		_child_bvh_mark_dirty(p_parent);
+	}
+
+	if (p_parent->child_bvh) {
+		_child_bvh_queue(p_parent->child_bvh, p_item);
+		return;
+	}
+
+	if (!use_child_bvh || p_parent->child_items.size() < CHILD_BVH_MIN_CHILDREN) {
+		return;
+	}
+
+	p_parent->child_bvh = memnew(ChildBVH);
+	for (int i = 0; i < p_parent->child_items.size(); i++) {
+		_child_bvh_queue(p_parent->child_bvh, p_parent->child_items[i]);
+	}
+}
+
+void RendererCanvasCull::_child_bvh_add(Canvas *p_canvas, Item *p_item) {
+	if (p_canvas->child_bvh) {
+		_child_bvh_queue(p_canvas->child_bvh, p_item);
+		return;
+	}
+
+	if (!use_child_bvh || p_canvas->child_items.size() < CHILD_BVH_MIN_CHILDREN) {
+		return;
+	}
+
+	p_canvas->child_bvh = memnew(ChildBVH);
+	for (int i = 0; i < p_canvas->child_items.size(); i++) {
+		_child_bvh_queue(p_canvas->child_bvh, p_canvas->child_items[i].item);
+	}
+}
+
+void RendererCanvasCull::_child_bvh_remove(Item *p_parent, Item *p_item) {
+	if (p_parent->child_bvh) {
+		_child_bvh_erase(p_parent->child_bvh, p_item);
+	}
+
+	if (p_parent->child_items.is_empty()) {
+		// A leaf again.
+		_child_bvh_mark_dirty(p_parent);
+	}
+}
+
+void RendererCanvasCull::_child_bvh_remove(Canvas *p_canvas, Item *p_item) {
+	if (p_canvas->child_bvh) {
+		_child_bvh_erase(p_canvas->child_bvh, p_item);
+	}
+}
+
+void RendererCanvasCull::_update_child_bvh_index(ChildBVH *p_child_bvh) {
+	if (p_child_bvh->dirty_items.is_empty()) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < p_child_bvh->dirty_items.size(); i++) {
+		Item *child = p_child_bvh->dirty_items[i];
+		child->bvh_dirty = false;
+
+		bool indexed = !child->bvh_handle.is_invalid();
+		if (_is_child_bvh_leaf(child)) {
+			Rect2 rect = child->xform.xform(child->get_rect());
+			if (indexed) {
+				p_child_bvh->bvh.move(child->bvh_handle, rect);
+			} else {
+				child->bvh_handle = p_child_bvh->bvh.create(child, true, rect);
+				p_child_bvh->indexed_count++;
+				p_child_bvh->unindexed_dirty = true;
+			}
+		} else if (indexed) {
+			p_child_bvh->bvh.erase(child->bvh_handle);
+			child->bvh_handle.set_invalid();
+			p_child_bvh->indexed_count--;
+			p_child_bvh->unindexed_dirty = true;
+		}
+	}
+
+	p_child_bvh->dirty_items.clear();
+	p_child_bvh->bvh.update();
+}
+
+void RendererCanvasCull::_update_child_bvh(Item *p_canvas_item) {
+	ChildBVH *child_bvh = p_canvas_item->child_bvh;
+	_update_child_bvh_index(child_bvh);
+
+	if (child_bvh->unindexed_dirty) {
+		child_bvh->unindexed_items.clear();
+		for (int i = 0; i < p_canvas_item->child_items.size(); i++) {
+			if (p_canvas_item->child_items[i]->bvh_handle.is_invalid()) {
+				child_bvh->unindexed_items.push_back(p_canvas_item->child_items[i]);
+			}
+		}
+		child_bvh->unindexed_dirty = false;
+	}
+}
+
+void RendererCanvasCull::_update_child_bvh(Canvas *p_canvas) {
+	ChildBVH *child_bvh = p_canvas->child_bvh;
+	_update_child_bvh_index(child_bvh);
+
+	if (child_bvh->unindexed_dirty) {
+		child_bvh->unindexed_items.clear();
+		for (int i = 0; i < p_canvas->child_items.size(); i++) {
+			if (p_canvas->child_items[i].item->bvh_handle.is_invalid()) {
+				child_bvh->unindexed_items.push_back(p_canvas->child_items[i].item);
+			}
+		}
+		child_bvh->unindexed_dirty = false;
+	}
+}
+
 void RendererCanvasCull::render_canvas(RID p_render_target, Canvas *p_canvas, const Transform2D &p_transform, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, const Rect2 &p_clip_rect, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_transforms_to_pixel, bool p_snap_2d_vertices_to_pixel) {
 	RENDER_TIMESTAMP(">Render Canvas");
 
@@ -313,6 +549,9 @@ void RendererCanvasCull::render_canvas(RID p_render_target, Canvas *p_canvas, co
 	if (p_canvas->children_order_dirty) {
 		p_canvas->child_items.sort();
 		p_canvas->children_order_dirty = false;
+		if (p_canvas->child_bvh) {
+			p_canvas->child_bvh->unindexed_dirty = true;
+		}
 	}
 
 	int l = p_canvas->child_items.size();
@@ -327,26 +566,30 @@ void RendererCanvasCull::render_canvas(RID p_render_target, Canvas *p_canvas, co
 	}
 
 	if (!has_mirror) {
-		_render_canvas_item_tree(p_render_target, ci, l, nullptr, p_transform, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel);
+		// Mirrored children are drawn one by one below, so the child BVH is only used without them.
+		if (p_canvas->child_bvh) {
+			_update_child_bvh(p_canvas);
+		}
+		_render_canvas_item_tree(p_render_target, ci, l, p_canvas->child_bvh, nullptr, p_transform, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel);
 
 	} else {
 		//used for parallaxlayer mirroring
 		for (int i = 0; i < l; i++) {
 			const Canvas::ChildItem &ci2 = p_canvas->child_items[i];
-			_render_canvas_item_tree(p_render_target, nullptr, 0, ci2.item, p_transform, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel);
+			_render_canvas_item_tree(p_render_target, nullptr, 0, nullptr, ci2.item, p_transform, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel);
 
 			//mirroring (useful for scrolling backgrounds)
 			if (ci2.mirror.x != 0) {
 				Transform2D xform2 = p_transform * Transform2D(0, Vector2(ci2.mirror.x, 0));
-				_render_canvas_item_tree(p_render_target, nullptr, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel);
+				_render_canvas_item_tree(p_render_target, nullptr, 0, nullptr, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel);
 			}
 			if (ci2.mirror.y != 0) {
 				Transform2D xform2 = p_transform * Transform2D(0, Vector2(0, ci2.mirror.y));
-				_render_canvas_item_tree(p_render_target, nullptr, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel);
+				_render_canvas_item_tree(p_render_target, nullptr, 0, nullptr, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel);
 			}
 			if (ci2.mirror.y != 0 && ci2.mirror.x != 0) {
 				Transform2D xform2 = p_transform * Transform2D(0, ci2.mirror);
-				_render_canvas_item_tree(p_render_target, nullptr, 0, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel);
+				_render_canvas_item_tree(p_render_target, nullptr, 0, nullptr, ci2.item, xform2, p_clip_rect, p_canvas->modulate, p_lights, p_directional_lights, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel);
 			}
 		}
 	}
@@ -411,9 +654,11 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 		if (canvas_owner.owns(canvas_item->parent)) {
 			Canvas *canvas = canvas_owner.getornull(canvas_item->parent);
 			canvas->erase_item(canvas_item);
+			_child_bvh_remove(canvas, canvas_item);
 		} else if (canvas_item_owner.owns(canvas_item->parent)) {
 			Item *item_owner = canvas_item_owner.getornull(canvas_item->parent);
 			item_owner->child_items.erase(canvas_item);
+			_child_bvh_remove(item_owner, canvas_item);
 
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -430,10 +675,12 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 			ci.item = canvas_item;
 			canvas->child_items.push_back(ci);
 			canvas->children_order_dirty = true;
+			_child_bvh_add(canvas, canvas_item);
 		} else if (canvas_item_owner.owns(p_parent)) {
 			Item *item_owner = canvas_item_owner.getornull(p_parent);
 			item_owner->child_items.push_back(canvas_item);
 			item_owner->children_order_dirty = true;
+			_child_bvh_add(item_owner, canvas_item);
 
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -466,10 +713,28 @@ void RendererCanvasCull::canvas_item_set_light_mask(RID p_item, int p_mask) {
 void RendererCanvasCull::canvas_item_set_transform(RID p_item, const Transform2D &p_transform) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	canvas_item->xform = p_transform;
 }
 
+void RendererCanvasCull::canvas_items_set_transforms(const Vector<RID> &p_items, const PackedFloat32Array &p_transforms) {
+	ERR_FAIL_COND(p_transforms.size() != p_items.size() * 6);
+
+	const RID *items = p_items.ptr();
+	const float *r = p_transforms.ptr();
+
+	for (int i = 0; i < p_items.size(); i++, r += 6) {
+		Item *canvas_item = canvas_item_owner.getornull(items[i]);
+		ERR_CONTINUE(!canvas_item);
+		_child_bvh_mark_dirty(canvas_item);
+
+		canvas_item->xform.elements[0] = Vector2(r[0], r[1]);
+		canvas_item->xform.elements[1] = Vector2(r[2], r[3]);
+		canvas_item->xform.elements[2] = Vector2(r[4], r[5]);
+	}
+}
+
 void RendererCanvasCull::canvas_item_set_clip(RID p_item, bool p_clip) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
@@ -487,6 +752,7 @@ void RendererCanvasCull::canvas_item_set_distance_field_mode(RID p_item, bool p_
 void RendererCanvasCull::canvas_item_set_custom_rect(RID p_item, bool p_custom_rect, const Rect2 &p_rect) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
@@ -509,6 +775,7 @@ void RendererCanvasCull::canvas_item_set_self_modulate(RID p_item, const Color &
 void RendererCanvasCull::canvas_item_set_draw_behind_parent(RID p_item, bool p_enable) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	canvas_item->behind = p_enable;
 }
@@ -516,6 +783,7 @@ void RendererCanvasCull::canvas_item_set_draw_behind_parent(RID p_item, bool p_e
 void RendererCanvasCull::canvas_item_set_update_when_visible(RID p_item, bool p_update) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	canvas_item->update_when_visible = p_update;
 }
@@ -523,6 +791,7 @@ void RendererCanvasCull::canvas_item_set_update_when_visible(RID p_item, bool p_
 void RendererCanvasCull::canvas_item_add_line(RID p_item, const Point2 &p_from, const Point2 &p_to, const Color &p_color, float p_width) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandPrimitive *line = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_COND(!line);
@@ -547,6 +816,7 @@ void RendererCanvasCull::canvas_item_add_polyline(RID p_item, const Vector<Point
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Color color = Color(1, 1, 1, 1);
 
@@ -686,6 +956,7 @@ void RendererCanvasCull::canvas_item_add_multiline(RID p_item, const Vector<Poin
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandPolygon *pline = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!pline);
@@ -702,6 +973,7 @@ void RendererCanvasCull::canvas_item_add_multiline(RID p_item, const Vector<Poin
 void RendererCanvasCull::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, const Color &p_color) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -712,6 +984,7 @@ void RendererCanvasCull::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, c
 void RendererCanvasCull::canvas_item_add_circle(RID p_item, const Point2 &p_pos, float p_radius, const Color &p_color) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandPolygon *circle = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!circle);
@@ -748,6 +1021,7 @@ void RendererCanvasCull::canvas_item_add_circle(RID p_item, const Point2 &p_pos,
 void RendererCanvasCull::canvas_item_add_texture_rect(RID p_item, const Rect2 &p_rect, RID p_texture, bool p_tile, const Color &p_modulate, bool p_transpose) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -779,6 +1053,7 @@ void RendererCanvasCull::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, bool p_transpose, bool p_clip_uv) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -820,6 +1095,7 @@ void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const R
 void RendererCanvasCull::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, RS::NinePatchAxisMode p_x_axis_mode, RS::NinePatchAxisMode p_y_axis_mode, bool p_draw_center, const Color &p_modulate) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandNinePatch *style = canvas_item->alloc_command<Item::CommandNinePatch>();
 	ERR_FAIL_COND(!style);
@@ -844,6 +1120,7 @@ void RendererCanvasCull::canvas_item_add_primitive(RID p_item, const Vector<Poin
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandPrimitive *prim = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_COND(!prim);
@@ -870,6 +1147,8 @@ void RendererCanvasCull::canvas_item_add_primitive(RID p_item, const Vector<Poin
 void RendererCanvasCull::canvas_item_add_polygon(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
+
 #ifdef DEBUG_ENABLED
 	int pointcount = p_points.size();
 	ERR_FAIL_COND(pointcount < 3);
@@ -891,6 +1170,7 @@ void RendererCanvasCull::canvas_item_add_polygon(RID p_item, const Vector<Point2
 void RendererCanvasCull::canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, const Vector<int> &p_bones, const Vector<float> &p_weights, RID p_texture, int p_count) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	int vertex_count = p_points.size();
 	ERR_FAIL_COND(vertex_count == 0);
@@ -914,6 +1194,7 @@ void RendererCanvasCull::canvas_item_add_triangle_array(RID p_item, const Vector
 void RendererCanvasCull::canvas_item_add_set_transform(RID p_item, const Transform2D &p_transform) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandTransform *tr = canvas_item->alloc_command<Item::CommandTransform>();
 	ERR_FAIL_COND(!tr);
@@ -923,6 +1204,7 @@ void RendererCanvasCull::canvas_item_add_set_transform(RID p_item, const Transfo
 void RendererCanvasCull::canvas_item_add_mesh(RID p_item, const RID &p_mesh, const Transform2D &p_transform, const Color &p_modulate, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 	ERR_FAIL_COND(!p_mesh.is_valid());
 
 	Item::CommandMesh *m = canvas_item->alloc_command<Item::CommandMesh>();
@@ -942,6 +1224,7 @@ void RendererCanvasCull::canvas_item_add_mesh(RID p_item, const RID &p_mesh, con
 void RendererCanvasCull::canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandParticles *part = canvas_item->alloc_command<Item::CommandParticles>();
 	ERR_FAIL_COND(!part);
@@ -956,6 +1239,7 @@ void RendererCanvasCull::canvas_item_add_particles(RID p_item, RID p_particles,
 void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandMultiMesh *mm = canvas_item->alloc_command<Item::CommandMultiMesh>();
 	ERR_FAIL_COND(!mm);
@@ -967,6 +1251,7 @@ void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p
 void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	Item::CommandClipIgnore *ci = canvas_item->alloc_command<Item::CommandClipIgnore>();
 	ERR_FAIL_COND(!ci);
@@ -976,6 +1261,7 @@ void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore)
 void RendererCanvasCull::canvas_item_set_sort_children_by_y(RID p_item, bool p_enable) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	canvas_item->sort_y = p_enable;
 
@@ -1001,6 +1287,7 @@ void RendererCanvasCull::canvas_item_set_z_as_relative_to_parent(RID p_item, boo
 void RendererCanvasCull::canvas_item_attach_skeleton(RID p_item, RID p_skeleton) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 	if (canvas_item->skeleton == p_skeleton) {
 		return;
 	}
@@ -1030,6 +1317,7 @@ void RendererCanvasCull::canvas_item_attach_skeleton(RID p_item, RID p_skeleton)
 void RendererCanvasCull::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_enable, const Rect2 &p_rect) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 	if (p_enable && (canvas_item->copy_back_buffer == nullptr)) {
 		canvas_item->copy_back_buffer = memnew(RendererCanvasRender::Item::CopyBackBuffer);
 	}
@@ -1047,6 +1335,7 @@ void RendererCanvasCull::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_e
 void RendererCanvasCull::canvas_item_clear(RID p_item) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	canvas_item->clear();
 }
@@ -1087,6 +1376,7 @@ void RendererCanvasCull::canvas_item_set_use_parent_material(RID p_item, bool p_
 void RendererCanvasCull::canvas_item_set_canvas_group_mode(RID p_item, RS::CanvasGroupMode p_mode, float p_clear_margin, bool p_fit_empty, float p_fit_margin, bool p_blur_mipmaps) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_child_bvh_mark_dirty(canvas_item);
 
 	if (p_mode == RS::CANVAS_GROUP_MODE_DISABLED) {
 		if (canvas_item->canvas_group != nullptr) {
@@ -1484,6 +1774,12 @@ bool RendererCanvasCull::free(RID p_rid) {
 
 		for (int i = 0; i < canvas->child_items.size(); i++) {
 			canvas->child_items[i].item->parent = RID();
+			canvas->child_items[i].item->bvh_handle.set_invalid();
+			canvas->child_items[i].item->bvh_dirty = false;
+		}
+
+		if (canvas->child_bvh) {
+			memdelete(canvas->child_bvh);
 		}
 
 		for (Set<RendererCanvasRender::Light *>::Element *E = canvas->lights.front(); E; E = E->next()) {
@@ -1506,9 +1802,11 @@ bool RendererCanvasCull::free(RID p_rid) {
 			if (canvas_owner.owns(canvas_item->parent)) {
 				Canvas *canvas = canvas_owner.getornull(canvas_item->parent);
 				canvas->erase_item(canvas_item);
+				_child_bvh_remove(canvas, canvas_item);
 			} else if (canvas_item_owner.owns(canvas_item->parent)) {
 				Item *item_owner = canvas_item_owner.getornull(canvas_item->parent);
 				item_owner->child_items.erase(canvas_item);
+				_child_bvh_remove(item_owner, canvas_item);
 
 				if (item_owner->sort_y) {
 					_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -1518,6 +1816,12 @@ bool RendererCanvasCull::free(RID p_rid) {
 
 		for (int i = 0; i < canvas_item->child_items.size(); i++) {
 			canvas_item->child_items[i]->parent = RID();
+			canvas_item->child_items[i]->bvh_handle.set_invalid();
+			canvas_item->child_items[i]->bvh_dirty = false;
+		}
+
+		if (canvas_item->child_bvh) {
+			memdelete(canvas_item->child_bvh);
 		}
 
 		/*
@@ -1589,6 +1893,7 @@ RendererCanvasCull::RendererCanvasCull() {
 	z_last_list = (RendererCanvasRender::Item **)memalloc(z_range * sizeof(RendererCanvasRender::Item *));
 
 	disable_scale = false;
+	use_child_bvh = GLOBAL_GET("rendering/2d/culling/use_bvh");
 }
 
 RendererCanvasCull::~RendererCanvasCull() {
@@ -31,11 +31,14 @@
 #ifndef RENDERING_SERVER_CANVAS_CULL_H
 #define RENDERING_SERVER_CANVAS_CULL_H
 
+#include "core/math/bvh.h"
 #include "renderer_compositor.h"
 #include "renderer_viewport.h"
 
 class RendererCanvasCull {
 public:
+	struct ChildBVH;
+
 	struct Item : public RendererCanvasRender::Item {
 		RID parent; // canvas it belongs to
 		List<Item *>::Element *E;
@@ -55,6 +58,10 @@ public:
 
 		Vector<Item *> child_items;
 
+		ChildBVH *child_bvh;
+		BVHHandle bvh_handle; // In the parent's child BVH, invalid if not indexed.
+		bool bvh_dirty;
+
 		Item() {
 			children_order_dirty = true;
 			E = nullptr;
@@ -69,9 +76,28 @@ public:
 			ysort_xform = Transform2D();
 			ysort_pos = Vector2();
 			ysort_index = 0;
+			child_bvh = nullptr;
+			bvh_handle.set_invalid();
+			bvh_dirty = false;
 		}
 	};
 
+	// Items and canvases with many children index them by their rect in the parent's space, so
+	// culling only visits children that can be on screen. Only leaf children whose rect can't change without
+	// the server knowing are indexed (see _is_child_bvh_leaf()), the rest are culled as usual.
+	struct ChildBVH {
+		BVH_Manager<Item, false, 128, Rect2, Vector2> bvh;
+		uint32_t indexed_count = 0;
+		LocalVector<Item *> dirty_items;
+		LocalVector<Item *> unindexed_items; // Sorted by index, like child_items.
+		bool unindexed_dirty = true;
+		LocalVector<Item *> cull_result;
+	};
+
+	enum {
+		CHILD_BVH_MIN_CHILDREN = 128
+	};
+
 	struct ItemIndexSort {
 		_FORCE_INLINE_ bool operator()(const Item *p_left, const Item *p_right) const {
 			return p_left->index < p_right->index;
@@ -122,6 +148,7 @@ public:
 
 		bool children_order_dirty;
 		Vector<ChildItem> child_items;
+		ChildBVH *child_bvh;
 		Color modulate;
 		RID parent;
 		float parent_scale;
@@ -144,6 +171,7 @@ public:
 		Canvas() {
 			modulate = Color(1, 1, 1, 1);
 			children_order_dirty = true;
+			child_bvh = nullptr;
 			parent_scale = 1.0;
 		}
 	};
@@ -155,9 +183,24 @@ public:
 	bool disable_scale;
 	bool sdf_used = false;
 	bool snapping_2d_transforms_to_pixel = false;
+	bool use_child_bvh = true;
 
 private:
-	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel);
+	bool _is_child_bvh_leaf(const Item *p_item) const;
+	ChildBVH *_get_parent_child_bvh(Item *p_item);
+	void _child_bvh_mark_dirty(Item *p_item);
+	void _child_bvh_queue(ChildBVH *p_child_bvh, Item *p_item);
+	void _child_bvh_erase(ChildBVH *p_child_bvh, Item *p_item);
+	void _child_bvh_remove(Item *p_parent, Item *p_item);
+	void _child_bvh_remove(Canvas *p_canvas, Item *p_item);
+	void _child_bvh_add(Item *p_parent, Item *p_item);
+	void _child_bvh_add(Canvas *p_canvas, Item *p_item);
+	void _update_child_bvh_index(ChildBVH *p_child_bvh);
+	void _update_child_bvh(Item *p_canvas_item);
+	void _update_child_bvh(Canvas *p_canvas);
+	void _cull_child_bvh(ChildBVH *p_child_bvh, bool p_skip_behind, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
+
+	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, ChildBVH *p_child_bvh, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel);
 	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
 
 	RendererCanvasRender::Item **z_list;
@@ -185,6 +228,7 @@ public:
 	void canvas_item_set_light_mask(RID p_item, int p_mask);
 
 	void canvas_item_set_transform(RID p_item, const Transform2D &p_transform);
+	void canvas_items_set_transforms(const Vector<RID> &p_items, const PackedFloat32Array &p_transforms);
 	void canvas_item_set_clip(RID p_item, bool p_clip);
 	void canvas_item_set_distance_field_mode(RID p_item, bool p_enable);
 	void canvas_item_set_custom_rect(RID p_item, bool p_custom_rect, const Rect2 &p_rect = Rect2());
@@ -326,12 +326,21 @@ void RenderForwardClustered::_render_list_template(RenderingDevice::DrawListID p
 	} else {
 		push_constant.uv_offset = 0;
 	}
+	push_constant.pad = 0;
 
 	for (uint32_t i = p_from_element; i < p_to_element; i++) {
 		const GeometryInstanceSurfaceDataCache *surf = p_params->elements[i];
 		const RenderElementInfo &element_info = p_params->element_info[i];
 
-		push_constant.base_index = i + p_params->element_offset;
+		// Batches culled on the GPU read their instances from the visible list, and their count from the indirect command.
+		uint32_t gpu_cull_draw = p_params->gpu_cull_draws ? p_params->gpu_cull_draws[i] : uint32_t(GPU_CULL_DRAW_NONE);
+		if (gpu_cull_draw != GPU_CULL_DRAW_NONE) {
+			push_constant.base_index = instance_culler->get_draw_visible_offset(gpu_cull_draw);
+			push_constant.use_visible_instances = 1;
+		} else {
+			push_constant.base_index = i + p_params->element_offset;
+			push_constant.use_visible_instances = 0;
+		}
 
 		RID material_uniform_set;
 		SceneShaderForwardClustered::ShaderData *shader;
@@ -463,12 +472,16 @@ void RenderForwardClustered::_render_list_template(RenderingDevice::DrawListID p
 
 		RD::get_singleton()->draw_list_set_push_constant(draw_list, &push_constant, sizeof(SceneState::PushConstant));
 
-		uint32_t instance_count = surf->owner->instance_count > 1 ? surf->owner->instance_count : element_info.repeat;
-		if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_PARTICLE_TRAILS) {
-			instance_count /= surf->owner->trail_steps;
-		}
+		if (gpu_cull_draw != GPU_CULL_DRAW_NONE) {
+			RD::get_singleton()->draw_list_draw_indirect(draw_list, index_array_rd.is_valid(), instance_culler->get_draw_command_buffer(), gpu_cull_draw * sizeof(InstanceCullerRD::DrawCommand));
+		} else {
+			uint32_t instance_count = surf->owner->instance_count > 1 ? surf->owner->instance_count : element_info.repeat;
+			if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_PARTICLE_TRAILS) {
+				instance_count /= surf->owner->trail_steps;
+			}
 
-		RD::get_singleton()->draw_list_draw(draw_list, index_array_rd.is_valid(), instance_count);
+			RD::get_singleton()->draw_list_draw(draw_list, index_array_rd.is_valid(), instance_count);
+		}
 		i += element_info.repeat - 1; //skip equal elements
 	}
 }
@@ -867,44 +880,72 @@ void RenderForwardClustered::_fill_instance_data(RenderListType p_render_list, u
 	}
 }
 
-void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, const RenderDataRD *p_render_data, PassMode p_pass_mode, bool p_using_sdfgi, bool p_using_opaque_gi, bool p_append) {
-	if (p_render_list == RENDER_LIST_OPAQUE) {
-		scene_state.used_sss = false;
-		scene_state.used_screen_texture = false;
-		scene_state.used_normal_texture = false;
-		scene_state.used_depth_texture = false;
+void RenderForwardClustered::_fill_gpu_cull_data() {
+	RenderList *rl = &render_list[RENDER_LIST_OPAQUE];
+
+	gpu_cull_draws.resize(rl->elements.size());
+	for (uint32_t i = 0; i < gpu_cull_draws.size(); i++) {
+		gpu_cull_draws[i] = GPU_CULL_DRAW_NONE;
 	}
-	uint32_t lightmap_captures_used = 0;
 
-	Plane near_plane(p_render_data->cam_transform.origin, -p_render_data->cam_transform.basis.get_axis(Vector3::AXIS_Z));
-	near_plane.d += p_render_data->cam_projection.get_z_near();
-	float z_max = p_render_data->cam_projection.get_z_far() - p_render_data->cam_projection.get_z_near();
+	instance_culler->begin();
 
-	RenderList *rl = &render_list[p_render_list];
-	_update_dirty_geometry_instances();
+	// Each batch of repeated elements becomes one indirect draw, with one cull item per element.
+	for (uint32_t i = 0; i < rl->elements.size(); i += rl->element_info[i].repeat) {
+		GeometryInstanceSurfaceDataCache *surf = rl->elements[i];
+		const RenderElementInfo &element_info = rl->element_info[i];
 
-	if (!p_append) {
-		rl->clear();
-		if (p_render_list == RENDER_LIST_OPAQUE) {
-			render_list[RENDER_LIST_ALPHA].clear(); //opaque fills alpha too
+		if (!surf->surface) {
+			continue;
+		}
+
+		// Multimeshes and particles draw all their instances from a single element, they are left to the CPU culling.
+		if ((scene_state.instance_data[RENDER_LIST_OPAQUE][i].flags & INSTANCE_DATA_FLAG_MULTIMESH) || surf->owner->instance_count > 1 || (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_PARTICLE_TRAILS)) {
+			continue;
 		}
+
+		uint32_t count;
+		if (storage->mesh_surface_get_index_array(surf->surface, element_info.lod_index).is_valid()) {
+			count = storage->mesh_surface_get_index_count(surf->surface, element_info.lod_index);
+		} else {
+			count = storage->mesh_surface_get_vertex_count(surf->surface);
+		}
+
+		uint32_t draw = instance_culler->add_draw(count);
+		for (uint32_t j = i; j < i + element_info.repeat; j++) {
+			instance_culler->add_instance(draw, j, rl->elements[j]->owner->transformed_aabb);
+		}
+		gpu_cull_draws[i] = draw;
 	}
+}
 
-	//fill list
+void RenderForwardClustered::_fill_render_list_chunk(uint32_t p_chunk, RenderListFillParameters *p_params) {
+	RenderListFillChunk &chunk = render_list_fill_chunks[p_chunk];
+	chunk.elements.clear();
+	chunk.alpha_elements.clear();
+	chunk.used_flags = 0;
 
-	for (int i = 0; i < (int)p_render_data->instances->size(); i++) {
-		GeometryInstanceForwardClustered *inst = static_cast<GeometryInstanceForwardClustered *>((*p_render_data->instances)[i]);
+	const RenderDataRD *render_data = p_params->render_data;
+	uint32_t from = p_chunk * p_params->instances_per_chunk;
+	uint32_t to = MIN(from + p_params->instances_per_chunk, (uint32_t)render_data->instances->size());
 
-		Vector3 support_min = inst->transformed_aabb.get_support(-near_plane.normal);
-		inst->depth = near_plane.distance_to(support_min);
-		uint32_t depth_layer = CLAMP(int(inst->depth * 16 / z_max), 0, 15);
+	for (uint32_t i = from; i < to; i++) {
+		GeometryInstanceForwardClustered *inst = static_cast<GeometryInstanceForwardClustered *>((*render_data->instances)[i]);
+
+		if (inst->instance_count == 0 && inst->data->base_type == RS::INSTANCE_MULTIMESH) {
+			continue; //no instances to draw, or all of its chunks were culled
+		}
+
+		Vector3 support_min = inst->transformed_aabb.get_support(-p_params->near_plane.normal);
+		inst->depth = p_params->near_plane.distance_to(support_min);
+		uint32_t depth_layer = CLAMP(int(inst->depth * 16 / p_params->z_max), 0, 15);
 
 		uint32_t flags = inst->base_flags; //fill flags if appropriate
 
 		bool uses_lightmap = false;
 		bool uses_gi = false;
 
-		if (p_render_list == RENDER_LIST_OPAQUE) {
+		if (p_params->render_list == RENDER_LIST_OPAQUE) {
 			//setup GI
 
 			if (inst->lightmap_instance.is_valid()) {
@@ -928,9 +969,13 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 				}
 
 			} else if (inst->lightmap_sh) {
-				if (lightmap_captures_used < scene_state.max_lightmap_captures) {
+				uint32_t capture_index = p_params->lightmap_captures_used.load(std::memory_order_relaxed);
+				if (capture_index < scene_state.max_lightmap_captures) {
+					capture_index = p_params->lightmap_captures_used.fetch_add(1, std::memory_order_relaxed);
+				}
+				if (capture_index < scene_state.max_lightmap_captures) {
 					const Color *src_capture = inst->lightmap_sh->sh;
-					LightmapCaptureData &lcd = scene_state.lightmap_captures[lightmap_captures_used];
+					LightmapCaptureData &lcd = scene_state.lightmap_captures[capture_index];
 					for (int j = 0; j < 9; j++) {
 						lcd.sh[j * 4 + 0] = src_capture[j].r;
 						lcd.sh[j * 4 + 1] = src_capture[j].g;
@@ -938,13 +983,12 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 						lcd.sh[j * 4 + 3] = src_capture[j].a;
 					}
 					flags |= INSTANCE_DATA_FLAG_USE_LIGHTMAP_CAPTURE;
-					inst->gi_offset_cache = lightmap_captures_used;
-					lightmap_captures_used++;
+					inst->gi_offset_cache = capture_index;
 					uses_lightmap = true;
 				}
 
 			} else {
-				if (p_using_opaque_gi) {
+				if (p_params->using_opaque_gi) {
 					flags |= INSTANCE_DATA_FLAG_USE_GI_BUFFERS;
 				}
 
@@ -969,7 +1013,7 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 					flags |= INSTANCE_DATA_FLAG_USE_GIPROBE;
 					uses_gi = true;
 				} else {
-					if (p_using_sdfgi && inst->can_sdfgi) {
+					if (p_params->using_sdfgi && inst->can_sdfgi) {
 						flags |= INSTANCE_DATA_FLAG_USE_SDFGI;
 						uses_gi = true;
 					}
@@ -987,13 +1031,13 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 
 			// LOD
 
-			if (p_render_data->screen_lod_threshold > 0.0 && storage->mesh_surface_has_lod(surf->surface)) {
+			if (render_data->screen_lod_threshold > 0.0 && storage->mesh_surface_has_lod(surf->surface)) {
 				//lod
-				Vector3 lod_support_min = inst->transformed_aabb.get_support(-p_render_data->lod_camera_plane.normal);
-				Vector3 lod_support_max = inst->transformed_aabb.get_support(p_render_data->lod_camera_plane.normal);
+				Vector3 lod_support_min = inst->transformed_aabb.get_support(-render_data->lod_camera_plane.normal);
+				Vector3 lod_support_max = inst->transformed_aabb.get_support(render_data->lod_camera_plane.normal);
 
-				float distance_min = p_render_data->lod_camera_plane.distance_to(lod_support_min);
-				float distance_max = p_render_data->lod_camera_plane.distance_to(lod_support_max);
+				float distance_min = render_data->lod_camera_plane.distance_to(lod_support_min);
+				float distance_max = render_data->lod_camera_plane.distance_to(lod_support_max);
 
 				float distance = 0.0;
 
@@ -1006,18 +1050,18 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 					distance = -distance_max;
 				}
 
-				surf->sort.lod_index = storage->mesh_surface_get_lod(surf->surface, inst->lod_model_scale * inst->lod_bias, distance * p_render_data->lod_distance_multiplier, p_render_data->screen_lod_threshold);
+				surf->sort.lod_index = storage->mesh_surface_get_lod(surf->surface, inst->lod_model_scale * inst->lod_bias, distance * render_data->lod_distance_multiplier, render_data->screen_lod_threshold);
 			} else {
 				surf->sort.lod_index = 0;
 			}
 
 			// ADD Element
-			if (p_pass_mode == PASS_MODE_COLOR) {
+			if (p_params->pass_mode == PASS_MODE_COLOR) {
 				if (surf->flags & (GeometryInstanceSurfaceDataCache::FLAG_PASS_DEPTH | GeometryInstanceSurfaceDataCache::FLAG_PASS_OPAQUE)) {
-					rl->add_element(surf);
+					chunk.elements.push_back(surf);
 				}
 				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_PASS_ALPHA) {
-					render_list[RENDER_LIST_ALPHA].add_element(surf);
+					chunk.alpha_elements.push_back(surf);
 					if (uses_gi) {
 						surf->sort.uses_forward_gi = 1;
 					}
@@ -1027,26 +1071,15 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 					surf->sort.uses_lightmap = 1;
 				}
 
-				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_SUBSURFACE_SCATTERING) {
-					scene_state.used_sss = true;
-				}
-				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_SCREEN_TEXTURE) {
-					scene_state.used_screen_texture = true;
-				}
-				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_NORMAL_TEXTURE) {
-					scene_state.used_normal_texture = true;
-				}
-				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_DEPTH_TEXTURE) {
-					scene_state.used_depth_texture = true;
-				}
+				chunk.used_flags |= surf->flags;
 
-			} else if (p_pass_mode == PASS_MODE_SHADOW || p_pass_mode == PASS_MODE_SHADOW_DP) {
+			} else if (p_params->pass_mode == PASS_MODE_SHADOW || p_params->pass_mode == PASS_MODE_SHADOW_DP) {
 				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_PASS_SHADOW) {
-					rl->add_element(surf);
+					chunk.elements.push_back(surf);
 				}
 			} else {
 				if (surf->flags & (GeometryInstanceSurfaceDataCache::FLAG_PASS_DEPTH | GeometryInstanceSurfaceDataCache::FLAG_PASS_OPAQUE)) {
-					rl->add_element(surf);
+					chunk.elements.push_back(surf);
 				}
 			}
 
@@ -1055,6 +1088,90 @@ void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, con
 			surf = surf->next;
 		}
 	}
+}
+
+void RenderForwardClustered::_fill_render_list(RenderListType p_render_list, const RenderDataRD *p_render_data, PassMode p_pass_mode, bool p_using_sdfgi, bool p_using_opaque_gi, bool p_append) {
+	if (p_render_list == RENDER_LIST_OPAQUE) {
+		scene_state.used_sss = false;
+		scene_state.used_screen_texture = false;
+		scene_state.used_normal_texture = false;
+		scene_state.used_depth_texture = false;
+	}
+
+	Plane near_plane(p_render_data->cam_transform.origin, -p_render_data->cam_transform.basis.get_axis(Vector3::AXIS_Z));
+	near_plane.d += p_render_data->cam_projection.get_z_near();
+	float z_max = p_render_data->cam_projection.get_z_far() - p_render_data->cam_projection.get_z_near();
+
+	RenderList *rl = &render_list[p_render_list];
+	_update_dirty_geometry_instances();
+
+	if (!p_append) {
+		rl->clear();
+		if (p_render_list == RENDER_LIST_OPAQUE) {
+			render_list[RENDER_LIST_ALPHA].clear(); //opaque fills alpha too
+		}
+	}
+
+	//fill list, in chunks of instances so it can be split between threads
+
+	RenderListFillParameters params;
+	params.render_list = p_render_list;
+	params.render_data = p_render_data;
+	params.pass_mode = p_pass_mode;
+	params.using_sdfgi = p_using_sdfgi;
+	params.using_opaque_gi = p_using_opaque_gi;
+	params.near_plane = near_plane;
+	params.z_max = z_max;
+	params.lightmap_captures_used.store(0, std::memory_order_relaxed);
+
+	uint32_t instance_count = p_render_data->instances->size();
+	ThreadWorkPool &thread_work_pool = RendererThreadPool::singleton->thread_work_pool;
+	uint32_t chunk_count = 1;
+
+	if (instance_count > render_list_fill_chunk_size * 2 && thread_work_pool.get_thread_count() > 1 && !thread_work_pool.is_working()) {
+		params.instances_per_chunk = render_list_fill_chunk_size;
+		chunk_count = (instance_count + render_list_fill_chunk_size - 1) / render_list_fill_chunk_size;
+		if (render_list_fill_chunks.size() < chunk_count) {
+			render_list_fill_chunks.resize(chunk_count);
+		}
+		thread_work_pool.do_work(chunk_count, this, &RenderForwardClustered::_fill_render_list_chunk, &params);
+	} else {
+		params.instances_per_chunk = instance_count;
+		if (render_list_fill_chunks.size() == 0) {
+			render_list_fill_chunks.resize(1);
+		}
+		_fill_render_list_chunk(0, &params);
+	}
+
+	// Merge in chunk order, so the lists are the same as when filled serially.
+	uint32_t used_flags = 0;
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		const RenderListFillChunk &chunk = render_list_fill_chunks[i];
+		for (uint32_t j = 0; j < chunk.elements.size(); j++) {
+			rl->add_element(chunk.elements[j]);
+		}
+		for (uint32_t j = 0; j < chunk.alpha_elements.size(); j++) {
+			render_list[RENDER_LIST_ALPHA].add_element(chunk.alpha_elements[j]);
+		}
+		used_flags |= chunk.used_flags;
+	}
+
+	if (p_pass_mode == PASS_MODE_COLOR) {
+		if (used_flags & GeometryInstanceSurfaceDataCache::FLAG_USES_SUBSURFACE_SCATTERING) {
+			scene_state.used_sss = true;
+		}
+		if (used_flags & GeometryInstanceSurfaceDataCache::FLAG_USES_SCREEN_TEXTURE) {
+			scene_state.used_screen_texture = true;
+		}
+		if (used_flags & GeometryInstanceSurfaceDataCache::FLAG_USES_NORMAL_TEXTURE) {
+			scene_state.used_normal_texture = true;
+		}
+		if (used_flags & GeometryInstanceSurfaceDataCache::FLAG_USES_DEPTH_TEXTURE) {
+			scene_state.used_depth_texture = true;
+		}
+	}
+
+	uint32_t lightmap_captures_used = MIN(params.lightmap_captures_used.load(std::memory_order_relaxed), scene_state.max_lightmap_captures);
 
 	if (p_render_list == RENDER_LIST_OPAQUE && lightmap_captures_used) {
 		RD::get_singleton()->buffer_update(scene_state.lightmap_capture_buffer, 0, sizeof(LightmapCaptureData) * lightmap_captures_used, scene_state.lightmap_captures, RD::BARRIER_MASK_RASTER);
@@ -1209,6 +1326,13 @@ void RenderForwardClustered::_render_scene(RenderDataRD *p_render_data, const Co
 	_fill_instance_data(RENDER_LIST_OPAQUE);
 	_fill_instance_data(RENDER_LIST_ALPHA);
 
+	// The culling pass tests against the depth prepass, which only viewports with render buffers have.
+	bool using_gpu_culling = instance_culler && render_buffer && render_list[RENDER_LIST_OPAQUE].elements.size() > 0;
+	if (using_gpu_culling) {
+		_fill_gpu_cull_data();
+		using_gpu_culling = instance_culler->get_draw_count() > 0;
+	}
+
 	RD::get_singleton()->draw_command_end_label();
 
 	bool using_sss = render_buffer && scene_state.used_sss && sub_surface_scattering_get_quality() != RS::SUB_SURFACE_SCATTERING_QUALITY_DISABLED;
@@ -1319,7 +1443,7 @@ void RenderForwardClustered::_render_scene(RenderDataRD *p_render_data, const Co
 
 		RID rp_uniform_set = _setup_render_pass_uniform_set(RENDER_LIST_OPAQUE, nullptr, RID());
 
-		bool finish_depth = using_ssao || using_sdfgi || using_giprobe;
+		bool finish_depth = using_ssao || using_sdfgi || using_giprobe || using_gpu_culling;
 		RenderListParameters render_list_params(render_list[RENDER_LIST_OPAQUE].elements.ptr(), render_list[RENDER_LIST_OPAQUE].element_info.ptr(), render_list[RENDER_LIST_OPAQUE].elements.size(), reverse_cull, depth_pass_mode, render_buffer == nullptr, rp_uniform_set, get_debug_draw_mode() == RS::VIEWPORT_DEBUG_DRAW_WIREFRAME, Vector2(), p_render_data->lod_camera_plane, p_render_data->lod_distance_multiplier, p_render_data->screen_lod_threshold);
 		_render_list_with_threads(&render_list_params, depth_framebuffer, needs_pre_resolve ? RD::INITIAL_ACTION_CONTINUE : RD::INITIAL_ACTION_CLEAR, RD::FINAL_ACTION_READ, needs_pre_resolve ? RD::INITIAL_ACTION_CONTINUE : RD::INITIAL_ACTION_CLEAR, finish_depth ? RD::FINAL_ACTION_READ : RD::FINAL_ACTION_CONTINUE, needs_pre_resolve ? Vector<Color>() : depth_pass_clear);
 
@@ -1344,6 +1468,18 @@ void RenderForwardClustered::_render_scene(RenderDataRD *p_render_data, const Co
 			RD::get_singleton()->draw_command_end_label();
 		}
 
+		if (using_gpu_culling) {
+			RENDER_TIMESTAMP("GPU Instance Culling");
+			RD::get_singleton()->draw_command_begin_label("GPU Instance Culling");
+
+			CameraMatrix correction;
+			correction.set_depth_correction(true);
+			CameraMatrix view_projection = correction * p_render_data->cam_projection * CameraMatrix(p_render_data->cam_transform.affine_inverse());
+			instance_culler->cull(render_buffer->depth, screen_size, view_projection);
+
+			RD::get_singleton()->draw_command_end_label();
+		}
+
 		continue_depth = !finish_depth;
 	}
 
@@ -1379,6 +1515,9 @@ void RenderForwardClustered::_render_scene(RenderDataRD *p_render_data, const Co
 
 		RID framebuffer = using_separate_specular ? opaque_specular_framebuffer : opaque_framebuffer;
 		RenderListParameters render_list_params(render_list[RENDER_LIST_OPAQUE].elements.ptr(), render_list[RENDER_LIST_OPAQUE].element_info.ptr(), render_list[RENDER_LIST_OPAQUE].elements.size(), reverse_cull, using_separate_specular ? PASS_MODE_COLOR_SPECULAR : PASS_MODE_COLOR, render_buffer == nullptr, rp_uniform_set, get_debug_draw_mode() == RS::VIEWPORT_DEBUG_DRAW_WIREFRAME, Vector2(), p_render_data->lod_camera_plane, p_render_data->lod_distance_multiplier, p_render_data->screen_lod_threshold);
+		if (using_gpu_culling) {
+			render_list_params.gpu_cull_draws = gpu_cull_draws.ptr();
+		}
 		_render_list_with_threads(&render_list_params, framebuffer, keep_color ? RD::INITIAL_ACTION_KEEP : RD::INITIAL_ACTION_CLEAR, will_continue_color ? RD::FINAL_ACTION_CONTINUE : RD::FINAL_ACTION_READ, depth_pre_pass ? (continue_depth ? RD::INITIAL_ACTION_CONTINUE : RD::INITIAL_ACTION_KEEP) : RD::INITIAL_ACTION_CLEAR, will_continue_depth ? RD::FINAL_ACTION_CONTINUE : RD::FINAL_ACTION_READ, c, 1.0, 0);
 		if (will_continue_color && using_separate_specular) {
 			// close the specular framebuffer, as it's no longer used
@@ -2190,6 +2329,15 @@ RID RenderForwardClustered::_setup_render_pass_uniform_set(RenderListType p_rend
 		}
 	}
 
+	{
+		RD::Uniform u;
+		u.binding = 19;
+		u.uniform_type = RD::UNIFORM_TYPE_STORAGE_BUFFER;
+		RID visible_instances = instance_culler ? instance_culler->get_visible_instance_buffer() : RID();
+		u.ids.push_back(visible_instances.is_valid() ? visible_instances : scene_shader.default_vec4_xform_buffer);
+		uniforms.push_back(u);
+	}
+
 	if (p_index >= (int)render_pass_uniform_sets.size()) {
 		render_pass_uniform_sets.resize(p_index + 1);
 	}
@@ -2888,6 +3036,10 @@ RenderForwardClustered::RenderForwardClustered(RendererStorageRD *p_storage) :
 	}
 
 	render_list_thread_threshold = GLOBAL_GET("rendering/limits/forward_renderer/threaded_render_minimum_instances");
+
+	if (GLOBAL_GET("rendering/occlusion_culling/gpu_instance_culling")) {
+		instance_culler = memnew(InstanceCullerRD(p_storage));
+	}
 }
 
 RenderForwardClustered::~RenderForwardClustered() {
@@ -2922,4 +3074,8 @@ RenderForwardClustered::~RenderForwardClustered() {
 		RD::get_singleton()->free(sdfgi_framebuffer_size_cache.front()->get());
 		sdfgi_framebuffer_size_cache.erase(sdfgi_framebuffer_size_cache.front());
 	}
+
+	if (instance_culler) {
+		memdelete(instance_culler);
+	}
 }
@@ -32,11 +32,14 @@
 #define RENDERING_SERVER_SCENE_RENDER_FORWARD_CLUSTERED_H
 
 #include "core/templates/paged_allocator.h"
+#include "core/templates/radix_sort.h"
 #include "servers/rendering/renderer_rd/forward_clustered/scene_shader_forward_clustered.h"
+#include "servers/rendering/renderer_rd/instance_culler_rd.h"
 #include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
 #include "servers/rendering/renderer_rd/renderer_scene_render_rd.h"
 #include "servers/rendering/renderer_rd/renderer_storage_rd.h"
 #include "servers/rendering/renderer_rd/shaders/scene_forward_clustered.glsl.gen.h"
+#include "servers/rendering/renderer_thread_pool.h"
 
 namespace RendererSceneRenderImplementation {
 
@@ -156,6 +159,7 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 		RD::FramebufferFormatID framebuffer_format = 0;
 		uint32_t element_offset = 0;
 		uint32_t barrier = RD::BARRIER_MASK_ALL;
+		const uint32_t *gpu_cull_draws = nullptr; // Per element, the indirect draw of the batch it starts when culled on the GPU.
 
 		RenderListParameters(GeometryInstanceSurfaceDataCache **p_elements, RenderElementInfo *p_element_info, int p_element_count, bool p_reverse_cull, PassMode p_pass_mode, bool p_no_gi, RID p_render_pass_uniform_set, bool p_force_wireframe = false, const Vector2 &p_uv_offset = Vector2(), const Plane &p_lod_plane = Plane(), float p_lod_distance_multiplier = 0.0, float p_screen_lod_threshold = 0.0, uint32_t p_element_offset = 0, uint32_t p_barrier = RD::BARRIER_MASK_ALL) {
 			elements = p_elements;
@@ -287,7 +291,8 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 		struct PushConstant {
 			uint32_t base_index; //
 			uint32_t uv_offset; //packed
-			uint32_t pad[2];
+			uint32_t use_visible_instances; // base_index is an offset in the visible instance list
+			uint32_t pad;
 		};
 
 		struct InstanceData {
@@ -371,10 +376,40 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 
 	uint32_t render_list_thread_threshold = 500;
 
+	enum {
+		GPU_CULL_DRAW_NONE = 0xFFFFFFFF
+	};
+
+	InstanceCullerRD *instance_culler = nullptr;
+	LocalVector<uint32_t> gpu_cull_draws;
+	void _fill_gpu_cull_data();
+
 	void _update_instance_data_buffer(RenderListType p_render_list);
 	void _fill_instance_data(RenderListType p_render_list, uint32_t p_offset = 0, int32_t p_max_elements = -1, bool p_update_buffer = true);
 	void _fill_render_list(RenderListType p_render_list, const RenderDataRD *p_render_data, PassMode p_pass_mode, bool p_using_sdfgi = false, bool p_using_opaque_gi = false, bool p_append = false);
 
+	struct RenderListFillChunk {
+		LocalVector<GeometryInstanceSurfaceDataCache *> elements;
+		LocalVector<GeometryInstanceSurfaceDataCache *> alpha_elements;
+		uint32_t used_flags = 0; // FLAG_USES_* of the surfaces added.
+	};
+
+	struct RenderListFillParameters {
+		RenderListType render_list;
+		const RenderDataRD *render_data;
+		PassMode pass_mode;
+		bool using_sdfgi;
+		bool using_opaque_gi;
+		Plane near_plane;
+		float z_max;
+		uint32_t instances_per_chunk;
+		std::atomic<uint32_t> lightmap_captures_used;
+	};
+
+	LocalVector<RenderListFillChunk> render_list_fill_chunks;
+	uint32_t render_list_fill_chunk_size = 256; // Instances per chunk when filling with threads.
+	void _fill_render_list_chunk(uint32_t p_chunk, RenderListFillParameters *p_params);
+
 	Map<Size2i, RID> sdfgi_framebuffer_size_cache;
 
 	struct GeometryInstanceData;
@@ -516,22 +551,34 @@ class RenderForwardClustered : public RendererSceneRenderRD {
 			element_info.clear();
 		}
 
-		//should eventually be replaced by radix
-
 		struct SortByKey {
 			_FORCE_INLINE_ bool operator()(const GeometryInstanceSurfaceDataCache *A, const GeometryInstanceSurfaceDataCache *B) const {
 				return (A->sort.sort_key2 == B->sort.sort_key2) ? (A->sort.sort_key1 < B->sort.sort_key1) : (A->sort.sort_key2 < B->sort.sort_key2);
 			}
 		};
 
-		void sort_by_key() {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr(), elements.size());
-		}
+		struct SortKeys {
+			_FORCE_INLINE_ uint64_t get_low(const GeometryInstanceSurfaceDataCache *p_element) const { return p_element->sort.sort_key1; }
+			_FORCE_INLINE_ uint64_t get_high(const GeometryInstanceSurfaceDataCache *p_element) const { return p_element->sort.sort_key2; }
+		};
+
+		enum {
+			RADIX_SORT_THRESHOLD = 512, // Below this, comparison sort is faster.
+		};
+
+		RadixSort<GeometryInstanceSurfaceDataCache *, SortKeys> radix_sort;
 
 		void sort_by_key_range(uint32_t p_from, uint32_t p_size) {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr() + p_from, p_size);
+			if (p_size < RADIX_SORT_THRESHOLD) {
+				SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
+				sorter.sort(elements.ptr() + p_from, p_size);
+			} else {
+				radix_sort.sort(elements.ptr() + p_from, p_size, &RendererThreadPool::singleton->thread_work_pool);
+			}
+		}
+
+		void sort_by_key() {
+			sort_by_key_range(0, elements.size());
 		}
 
 		struct SortByDepth {
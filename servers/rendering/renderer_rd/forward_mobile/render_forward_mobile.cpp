@@ -916,46 +916,33 @@ RID RenderForwardMobile::_render_buffers_get_normal_texture(RID p_render_buffers
 	return RID();
 }
 
-void RenderForwardMobile::_fill_render_list(RenderListType p_render_list, const RenderDataRD *p_render_data, PassMode p_pass_mode, bool p_append) {
-	if (p_render_list == RENDER_LIST_OPAQUE) {
-		scene_state.used_sss = false;
-		scene_state.used_screen_texture = false;
-		scene_state.used_normal_texture = false;
-		scene_state.used_depth_texture = false;
-	}
-	uint32_t lightmap_captures_used = 0;
-
-	Plane near_plane(p_render_data->cam_transform.origin, -p_render_data->cam_transform.basis.get_axis(Vector3::AXIS_Z));
-	near_plane.d += p_render_data->cam_projection.get_z_near();
-	float z_max = p_render_data->cam_projection.get_z_far() - p_render_data->cam_projection.get_z_near();
+void RenderForwardMobile::_fill_render_list_chunk(uint32_t p_chunk, RenderListFillParameters *p_params) {
+	RenderListFillChunk &chunk = render_list_fill_chunks[p_chunk];
+	chunk.elements.clear();
+	chunk.alpha_elements.clear();
+	chunk.used_flags = 0;
 
-	RenderList *rl = &render_list[p_render_list];
+	const RenderDataRD *render_data = p_params->render_data;
+	uint32_t from = p_chunk * p_params->instances_per_chunk;
+	uint32_t to = MIN(from + p_params->instances_per_chunk, (uint32_t)render_data->instances->size());
 
-	// Parse any updates on our geometry, updates surface caches and such
-	_update_dirty_geometry_instances();
+	for (uint32_t i = from; i < to; i++) {
+		GeometryInstanceForwardMobile *inst = static_cast<GeometryInstanceForwardMobile *>((*render_data->instances)[i]);
 
-	if (!p_append) {
-		rl->clear();
-		if (p_render_list == RENDER_LIST_OPAQUE) {
-			render_list[RENDER_LIST_ALPHA].clear(); //opaque fills alpha too
+		if (inst->instance_count == 0 && inst->data->base_type == RS::INSTANCE_MULTIMESH) {
+			continue; //no instances to draw, or all of its chunks were culled
 		}
-	}
-
-	//fill list
-
-	for (int i = 0; i < (int)p_render_data->instances->size(); i++) {
-		GeometryInstanceForwardMobile *inst = static_cast<GeometryInstanceForwardMobile *>((*p_render_data->instances)[i]);
 
-		Vector3 support_min = inst->transformed_aabb.get_support(-near_plane.normal);
-		inst->depth = near_plane.distance_to(support_min);
-		uint32_t depth_layer = CLAMP(int(inst->depth * 16 / z_max), 0, 15);
+		Vector3 support_min = inst->transformed_aabb.get_support(-p_params->near_plane.normal);
+		inst->depth = p_params->near_plane.distance_to(support_min);
+		uint32_t depth_layer = CLAMP(int(inst->depth * 16 / p_params->z_max), 0, 15);
 
 		uint32_t flags = inst->base_flags; //fill flags if appropriate
 
 		bool uses_lightmap = false;
 		// bool uses_gi = false;
 
-		if (p_render_list == RENDER_LIST_OPAQUE) {
+		if (p_params->render_list == RENDER_LIST_OPAQUE) {
 			if (inst->lightmap_instance.is_valid()) {
 				int32_t lightmap_cull_index = -1;
 				for (uint32_t j = 0; j < scene_state.lightmaps_used; j++) {
@@ -977,9 +964,13 @@ void RenderForwardMobile::_fill_render_list(RenderListType p_render_list, const
 				}
 
 			} else if (inst->lightmap_sh) {
-				if (lightmap_captures_used < scene_state.max_lightmap_captures) {
+				uint32_t capture_index = p_params->lightmap_captures_used.load(std::memory_order_relaxed);
+				if (capture_index < scene_state.max_lightmap_captures) {
+					capture_index = p_params->lightmap_captures_used.fetch_add(1, std::memory_order_relaxed);
+				}
+				if (capture_index < scene_state.max_lightmap_captures) {
 					const Color *src_capture = inst->lightmap_sh->sh;
-					LightmapCaptureData &lcd = scene_state.lightmap_captures[lightmap_captures_used];
+					LightmapCaptureData &lcd = scene_state.lightmap_captures[capture_index];
 					for (int j = 0; j < 9; j++) {
 						lcd.sh[j * 4 + 0] = src_capture[j].r;
 						lcd.sh[j * 4 + 1] = src_capture[j].g;
@@ -987,8 +978,7 @@ void RenderForwardMobile::_fill_render_list(RenderListType p_render_list, const
 						lcd.sh[j * 4 + 3] = src_capture[j].a;
 					}
 					flags |= INSTANCE_DATA_FLAG_USE_LIGHTMAP_CAPTURE;
-					inst->gi_offset_cache = lightmap_captures_used;
-					lightmap_captures_used++;
+					inst->gi_offset_cache = capture_index;
 					uses_lightmap = true;
 				}
 			}
@@ -1002,13 +992,13 @@ void RenderForwardMobile::_fill_render_list(RenderListType p_render_list, const
 
 			// LOD
 
-			if (p_render_data->screen_lod_threshold > 0.0 && storage->mesh_surface_has_lod(surf->surface)) {
+			if (render_data->screen_lod_threshold > 0.0 && storage->mesh_surface_has_lod(surf->surface)) {
 				//lod
-				Vector3 lod_support_min = inst->transformed_aabb.get_support(-p_render_data->lod_camera_plane.normal);
-				Vector3 lod_support_max = inst->transformed_aabb.get_support(p_render_data->lod_camera_plane.normal);
+				Vector3 lod_support_min = inst->transformed_aabb.get_support(-render_data->lod_camera_plane.normal);
+				Vector3 lod_support_max = inst->transformed_aabb.get_support(render_data->lod_camera_plane.normal);
 
-				float distance_min = p_render_data->lod_camera_plane.distance_to(lod_support_min);
-				float distance_max = p_render_data->lod_camera_plane.distance_to(lod_support_max);
+				float distance_min = render_data->lod_camera_plane.distance_to(lod_support_min);
+				float distance_max = render_data->lod_camera_plane.distance_to(lod_support_max);
 
 				float distance = 0.0;
 
@@ -1021,18 +1011,18 @@ void RenderForwardMobile::_fill_render_list(RenderListType p_render_list, const
 					distance = -distance_max;
 				}
 
-				surf->lod_index = storage->mesh_surface_get_lod(surf->surface, inst->lod_model_scale * inst->lod_bias, distance * p_render_data->lod_distance_multiplier, p_render_data->screen_lod_threshold);
+				surf->lod_index = storage->mesh_surface_get_lod(surf->surface, inst->lod_model_scale * inst->lod_bias, distance * render_data->lod_distance_multiplier, render_data->screen_lod_threshold);
 			} else {
 				surf->lod_index = 0;
 			}
 
 			// ADD Element
-			if (p_pass_mode == PASS_MODE_COLOR) {
+			if (p_params->pass_mode == PASS_MODE_COLOR) {
 				if (surf->flags & (GeometryInstanceSurfaceDataCache::FLAG_PASS_DEPTH | GeometryInstanceSurfaceDataCache::FLAG_PASS_OPAQUE)) {
-					rl->add_element(surf);
+					chunk.elements.push_back(surf);
 				}
 				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_PASS_ALPHA) {
-					render_list[RENDER_LIST_ALPHA].add_element(surf);
+					chunk.alpha_elements.push_back(surf);
 					// if (uses_gi) {
 					//	surf->sort.uses_forward_gi = 1;
 					// }
@@ -1042,26 +1032,15 @@ void RenderForwardMobile::_fill_render_list(RenderListType p_render_list, const
 					surf->sort.uses_lightmap = 1; // This needs to become our lightmap index but we'll do that in a separate PR.
 				}
 
-				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_SUBSURFACE_SCATTERING) {
-					scene_state.used_sss = true;
-				}
-				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_SCREEN_TEXTURE) {
-					scene_state.used_screen_texture = true;
-				}
-				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_NORMAL_TEXTURE) {
-					scene_state.used_normal_texture = true;
-				}
-				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_USES_DEPTH_TEXTURE) {
-					scene_state.used_depth_texture = true;
-				}
+				chunk.used_flags |= surf->flags;
 
-			} else if (p_pass_mode == PASS_MODE_SHADOW || p_pass_mode == PASS_MODE_SHADOW_DP) {
+			} else if (p_params->pass_mode == PASS_MODE_SHADOW || p_params->pass_mode == PASS_MODE_SHADOW_DP) {
 				if (surf->flags & GeometryInstanceSurfaceDataCache::FLAG_PASS_SHADOW) {
-					rl->add_element(surf);
+					chunk.elements.push_back(surf);
 				}
 			} else {
 				if (surf->flags & (GeometryInstanceSurfaceDataCache::FLAG_PASS_DEPTH | GeometryInstanceSurfaceDataCache::FLAG_PASS_OPAQUE)) {
-					rl->add_element(surf);
+					chunk.elements.push_back(surf);
 				}
 			}
 
@@ -1072,6 +1051,88 @@ void RenderForwardMobile::_fill_render_list(RenderListType p_render_list, const
 	}
 }
 
+void RenderForwardMobile::_fill_render_list(RenderListType p_render_list, const RenderDataRD *p_render_data, PassMode p_pass_mode, bool p_append) {
+	if (p_render_list == RENDER_LIST_OPAQUE) {
+		scene_state.used_sss = false;
+		scene_state.used_screen_texture = false;
+		scene_state.used_normal_texture = false;
+		scene_state.used_depth_texture = false;
+	}
+
+	Plane near_plane(p_render_data->cam_transform.origin, -p_render_data->cam_transform.basis.get_axis(Vector3::AXIS_Z));
+	near_plane.d += p_render_data->cam_projection.get_z_near();
+	float z_max = p_render_data->cam_projection.get_z_far() - p_render_data->cam_projection.get_z_near();
+
+	RenderList *rl = &render_list[p_render_list];
+
+	// Parse any updates on our geometry, updates surface caches and such
+	_update_dirty_geometry_instances();
+
+	if (!p_append) {
+		rl->clear();
+		if (p_render_list == RENDER_LIST_OPAQUE) {
+			render_list[RENDER_LIST_ALPHA].clear(); //opaque fills alpha too
+		}
+	}
+
+	//fill list, in chunks of instances so it can be split between threads
+
+	RenderListFillParameters params;
+	params.render_list = p_render_list;
+	params.render_data = p_render_data;
+	params.pass_mode = p_pass_mode;
+	params.near_plane = near_plane;
+	params.z_max = z_max;
+	params.lightmap_captures_used.store(0, std::memory_order_relaxed);
+
+	uint32_t instance_count = p_render_data->instances->size();
+	ThreadWorkPool &thread_work_pool = RendererThreadPool::singleton->thread_work_pool;
+	uint32_t chunk_count = 1;
+
+	if (instance_count > render_list_fill_chunk_size * 2 && thread_work_pool.get_thread_count() > 1 && !thread_work_pool.is_working()) {
+		params.instances_per_chunk = render_list_fill_chunk_size;
+		chunk_count = (instance_count + render_list_fill_chunk_size - 1) / render_list_fill_chunk_size;
+		if (render_list_fill_chunks.size() < chunk_count) {
+			render_list_fill_chunks.resize(chunk_count);
+		}
+		thread_work_pool.do_work(chunk_count, this, &RenderForwardMobile::_fill_render_list_chunk, &params);
+	} else {
+		params.instances_per_chunk = instance_count;
+		if (render_list_fill_chunks.size() == 0) {
+			render_list_fill_chunks.resize(1);
+		}
+		_fill_render_list_chunk(0, &params);
+	}
+
+	// Merge in chunk order, so the lists are the same as when filled serially.
+	uint32_t used_flags = 0;
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		const RenderListFillChunk &chunk = render_list_fill_chunks[i];
+		for (uint32_t j = 0; j < chunk.elements.size(); j++) {
+			rl->add_element(chunk.elements[j]);
+		}
+		for (uint32_t j = 0; j < chunk.alpha_elements.size(); j++) {
+			render_list[RENDER_LIST_ALPHA].add_element(chunk.alpha_elements[j]);
+		}
+		used_flags |= chunk.used_flags;
+	}
+
+	if (p_pass_mode == PASS_MODE_COLOR) {
+		if (used_flags & GeometryInstanceSurfaceDataCache::FLAG_USES_SUBSURFACE_SCATTERING) {
+			scene_state.used_sss = true;
+		}
+		if (used_flags & GeometryInstanceSurfaceDataCache::FLAG_USES_SCREEN_TEXTURE) {
+			scene_state.used_screen_texture = true;
+		}
+		if (used_flags & GeometryInstanceSurfaceDataCache::FLAG_USES_NORMAL_TEXTURE) {
+			scene_state.used_normal_texture = true;
+		}
+		if (used_flags & GeometryInstanceSurfaceDataCache::FLAG_USES_DEPTH_TEXTURE) {
+			scene_state.used_depth_texture = true;
+		}
+	}
+}
+
 void RenderForwardMobile::_setup_environment(const RenderDataRD *p_render_data, bool p_no_fog, const Size2i &p_screen_size, bool p_flip_y, const Color &p_default_bg_color, bool p_opaque_render_buffers, bool p_pancake_shadows, int p_index) {
 	//!BAS! need to go through this and find out what we don't need anymore
 
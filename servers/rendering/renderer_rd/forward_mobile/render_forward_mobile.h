@@ -32,10 +32,12 @@
 #define RENDERING_SERVER_SCENE_RENDER_FORWARD_MOBILE_H
 
 #include "core/templates/paged_allocator.h"
+#include "core/templates/radix_sort.h"
 #include "servers/rendering/renderer_rd/forward_mobile/scene_shader_forward_mobile.h"
 #include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
 #include "servers/rendering/renderer_rd/renderer_scene_render_rd.h"
 #include "servers/rendering/renderer_rd/renderer_storage_rd.h"
+#include "servers/rendering/renderer_thread_pool.h"
 
 namespace RendererSceneRenderImplementation {
 
@@ -168,6 +170,26 @@ protected:
 	virtual RID _render_buffers_get_normal_texture(RID p_render_buffers);
 
 	void _fill_render_list(RenderListType p_render_list, const RenderDataRD *p_render_data, PassMode p_pass_mode, bool p_append = false);
+
+	struct RenderListFillChunk {
+		LocalVector<GeometryInstanceSurfaceDataCache *> elements;
+		LocalVector<GeometryInstanceSurfaceDataCache *> alpha_elements;
+		uint32_t used_flags = 0; // FLAG_USES_* of the surfaces added.
+	};
+
+	struct RenderListFillParameters {
+		RenderListType render_list;
+		const RenderDataRD *render_data;
+		PassMode pass_mode;
+		Plane near_plane;
+		float z_max;
+		uint32_t instances_per_chunk;
+		std::atomic<uint32_t> lightmap_captures_used;
+	};
+
+	LocalVector<RenderListFillChunk> render_list_fill_chunks;
+	uint32_t render_list_fill_chunk_size = 256; // Instances per chunk when filling with threads.
+	void _fill_render_list_chunk(uint32_t p_chunk, RenderListFillParameters *p_params);
 	void _fill_instance_data(RenderListType p_render_list, uint32_t p_offset = 0, int32_t p_max_elements = -1, bool p_update_buffer = true);
 	// void _update_instance_data_buffer(RenderListType p_render_list);
 
@@ -315,22 +337,34 @@ protected:
 			element_info.clear();
 		}
 
-		//should eventually be replaced by radix
-
 		struct SortByKey {
 			_FORCE_INLINE_ bool operator()(const GeometryInstanceSurfaceDataCache *A, const GeometryInstanceSurfaceDataCache *B) const {
 				return (A->sort.sort_key2 == B->sort.sort_key2) ? (A->sort.sort_key1 < B->sort.sort_key1) : (A->sort.sort_key2 < B->sort.sort_key2);
 			}
 		};
 
-		void sort_by_key() {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr(), elements.size());
-		}
+		struct SortKeys {
+			_FORCE_INLINE_ uint64_t get_low(const GeometryInstanceSurfaceDataCache *p_element) const { return p_element->sort.sort_key1; }
+			_FORCE_INLINE_ uint64_t get_high(const GeometryInstanceSurfaceDataCache *p_element) const { return p_element->sort.sort_key2; }
+		};
+
+		enum {
+			RADIX_SORT_THRESHOLD = 512, // Below this, comparison sort is faster.
+		};
+
+		RadixSort<GeometryInstanceSurfaceDataCache *, SortKeys> radix_sort;
 
 		void sort_by_key_range(uint32_t p_from, uint32_t p_size) {
-			SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
-			sorter.sort(elements.ptr() + p_from, p_size);
+			if (p_size < RADIX_SORT_THRESHOLD) {
+				SortArray<GeometryInstanceSurfaceDataCache *, SortByKey> sorter;
+				sorter.sort(elements.ptr() + p_from, p_size);
+			} else {
+				radix_sort.sort(elements.ptr() + p_from, p_size, &RendererThreadPool::singleton->thread_work_pool);
+			}
+		}
+
+		void sort_by_key() {
+			sort_by_key_range(0, elements.size());
 		}
 
 		struct SortByDepth {
@@ -0,0 +1,276 @@
+/*************************************************************************/
+/*  instance_culler_rd.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "instance_culler_rd.h"
+
+void InstanceCullerRD::_clear_uniform_sets() {
+	for (uint32_t i = 0; i < hzb_reduce_sets.size(); i++) {
+		if (hzb_reduce_sets[i].is_valid() && RD::get_singleton()->uniform_set_is_valid(hzb_reduce_sets[i])) {
+			RD::get_singleton()->free(hzb_reduce_sets[i]);
+		}
+	}
+	hzb_reduce_sets.clear();
+
+	if (cull_set.is_valid() && RD::get_singleton()->uniform_set_is_valid(cull_set)) {
+		RD::get_singleton()->free(cull_set);
+	}
+	cull_set = RID();
+	hzb_texture = RID();
+	depth_texture = RID();
+}
+
+void InstanceCullerRD::_update_buffers() {
+	if (items.size() > item_buffer_capacity) {
+		_clear_uniform_sets();
+		if (item_buffer.is_valid()) {
+			RD::get_singleton()->free(item_buffer);
+			RD::get_singleton()->free(visible_buffer);
+		}
+		item_buffer_capacity = next_power_of_2(items.size());
+		item_buffer = RD::get_singleton()->storage_buffer_create(item_buffer_capacity * sizeof(CullItem));
+		visible_buffer = RD::get_singleton()->storage_buffer_create(item_buffer_capacity * sizeof(uint32_t));
+	}
+
+	if (draws.size() > draw_buffer_capacity) {
+		_clear_uniform_sets();
+		if (draw_buffer.is_valid()) {
+			RD::get_singleton()->free(draw_buffer);
+		}
+		draw_buffer_capacity = next_power_of_2(draws.size());
+		draw_buffer = RD::get_singleton()->storage_buffer_create(draw_buffer_capacity * sizeof(DrawCommand), Vector<uint8_t>(), RD::STORAGE_BUFFER_USAGE_DISPATCH_INDIRECT);
+	}
+
+	// Uploading the commands also resets the instance counts the cull pass accumulates into.
+	RD::get_singleton()->buffer_update(item_buffer, 0, items.size() * sizeof(CullItem), items.ptr(), RD::BARRIER_MASK_COMPUTE);
+	RD::get_singleton()->buffer_update(draw_buffer, 0, draws.size() * sizeof(DrawCommand), draws.ptr(), RD::BARRIER_MASK_COMPUTE);
+}
+
+void InstanceCullerRD::begin() {
+	items.clear();
+	draws.clear();
+}
+
+uint32_t InstanceCullerRD::add_draw(uint32_t p_count) {
+	DrawCommand draw;
+	draw.count = p_count;
+	draw.instance_count = 0;
+	draw.first_index = 0;
+	draw.vertex_offset = 0;
+	draw.first_instance = 0;
+	draw.visible_offset = items.size();
+	draw.pad[0] = 0;
+	draw.pad[1] = 0;
+	draws.push_back(draw);
+	return draws.size() - 1;
+}
+
+void InstanceCullerRD::add_instance(uint32_t p_draw, uint32_t p_instance_index, const AABB &p_aabb) {
+	CullItem item;
+	item.aabb_min[0] = p_aabb.position.x;
+	item.aabb_min[1] = p_aabb.position.y;
+	item.aabb_min[2] = p_aabb.position.z;
+	item.draw_index = p_draw;
+	item.aabb_max[0] = p_aabb.position.x + p_aabb.size.x;
+	item.aabb_max[1] = p_aabb.position.y + p_aabb.size.y;
+	item.aabb_max[2] = p_aabb.position.z + p_aabb.size.z;
+	item.instance_index = p_instance_index;
+	items.push_back(item);
+}
+
+void InstanceCullerRD::cull(RID p_depth, const Size2i &p_size, const CameraMatrix &p_view_projection) {
+	if (draws.is_empty()) {
+		return;
+	}
+
+	_update_buffers();
+
+	// Each level halves the previous one rounding up, so the first level is padded until all of them divide evenly.
+	Size2i hzb_size = Size2i((p_size.width + 1) / 2, (p_size.height + 1) / 2);
+	uint32_t mipmaps = 1;
+	while (mipmaps < HZB_MAX_MIPMAPS && (MAX(hzb_size.width, hzb_size.height) >> mipmaps) > 0) {
+		mipmaps++;
+	}
+	uint32_t alignment = 1 << (mipmaps - 1);
+	hzb_size.width = (hzb_size.width + alignment - 1) & ~(alignment - 1);
+	hzb_size.height = (hzb_size.height + alignment - 1) & ~(alignment - 1);
+
+	RenderGraphRD *graph = storage->get_render_graph();
+	graph->begin();
+
+	RD::TextureFormat tf;
+	tf.format = RD::DATA_FORMAT_R32_SFLOAT;
+	tf.width = hzb_size.width;
+	tf.height = hzb_size.height;
+	tf.mipmaps = mipmaps;
+	tf.texture_type = RD::TEXTURE_TYPE_2D;
+	tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_STORAGE_BIT;
+	RenderGraphRD::ResourceID hzb = graph->create_texture(tf, "Instance Cull HZB");
+
+	// The opaque pass keeps using the depth buffer as attachment after the cull.
+	RenderGraphRD::ResourceID depth = graph->import_texture(p_depth, RD::BARRIER_MASK_RASTER);
+
+	RenderGraphRD::PassID hzb_pass = graph->add_pass("Instance Cull HZB", RenderGraphRD::STAGE_COMPUTE);
+	graph->pass_read(hzb_pass, depth);
+	graph->pass_write(hzb_pass, hzb);
+
+	RenderGraphRD::PassID cull_pass = graph->add_pass("Instance Cull", RenderGraphRD::STAGE_COMPUTE);
+	graph->pass_read(cull_pass, hzb);
+
+	graph->compile();
+
+	if (hzb_texture != graph->get_texture(hzb) || depth_texture != p_depth || !RD::get_singleton()->uniform_set_is_valid(cull_set)) {
+		_clear_uniform_sets();
+		hzb_texture = graph->get_texture(hzb);
+		depth_texture = p_depth;
+
+		RID sampler = storage->sampler_rd_get_default(RS::CANVAS_ITEM_TEXTURE_FILTER_NEAREST, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED);
+		RID shader_rd = shader.version_get_shader(shader_version, MODE_HZB_REDUCE);
+
+		for (uint32_t i = 0; i < mipmaps; i++) {
+			Vector<RD::Uniform> uniforms;
+			{
+				RD::Uniform u;
+				u.uniform_type = RD::UNIFORM_TYPE_SAMPLER_WITH_TEXTURE;
+				u.binding = 0;
+				u.ids.push_back(sampler);
+				u.ids.push_back(i == 0 ? p_depth : graph->get_texture_slice(hzb, 0, i - 1));
+				uniforms.push_back(u);
+			}
+			{
+				RD::Uniform u;
+				u.uniform_type = RD::UNIFORM_TYPE_IMAGE;
+				u.binding = 1;
+				u.ids.push_back(graph->get_texture_slice(hzb, 0, i));
+				uniforms.push_back(u);
+			}
+			hzb_reduce_sets.push_back(RD::get_singleton()->uniform_set_create(uniforms, shader_rd, 0));
+		}
+
+		Vector<RD::Uniform> uniforms;
+		{
+			RD::Uniform u;
+			u.uniform_type = RD::UNIFORM_TYPE_SAMPLER_WITH_TEXTURE;
+			u.binding = 0;
+			u.ids.push_back(sampler);
+			u.ids.push_back(hzb_texture);
+			uniforms.push_back(u);
+		}
+		{
+			RD::Uniform u;
+			u.uniform_type = RD::UNIFORM_TYPE_STORAGE_BUFFER;
+			u.binding = 1;
+			u.ids.push_back(item_buffer);
+			uniforms.push_back(u);
+		}
+		{
+			RD::Uniform u;
+			u.uniform_type = RD::UNIFORM_TYPE_STORAGE_BUFFER;
+			u.binding = 2;
+			u.ids.push_back(draw_buffer);
+			uniforms.push_back(u);
+		}
+		{
+			RD::Uniform u;
+			u.uniform_type = RD::UNIFORM_TYPE_STORAGE_BUFFER;
+			u.binding = 3;
+			u.ids.push_back(visible_buffer);
+			uniforms.push_back(u);
+		}
+		cull_set = RD::get_singleton()->uniform_set_create(uniforms, shader.version_get_shader(shader_version, MODE_CULL), 0);
+	}
+
+	RD::ComputeListID compute_list = RD::get_singleton()->compute_list_begin();
+	RD::get_singleton()->compute_list_bind_compute_pipeline(compute_list, pipelines[MODE_HZB_REDUCE]);
+
+	Size2i source_size = p_size;
+	for (uint32_t i = 0; i < mipmaps; i++) {
+		Size2i dest_size = Size2i(MAX(1, hzb_size.width >> i), MAX(1, hzb_size.height >> i));
+
+		HZBReducePushConstant push_constant;
+		push_constant.source_size[0] = source_size.width;
+		push_constant.source_size[1] = source_size.height;
+		push_constant.dest_size[0] = dest_size.width;
+		push_constant.dest_size[1] = dest_size.height;
+
+		RD::get_singleton()->compute_list_bind_uniform_set(compute_list, hzb_reduce_sets[i], 0);
+		RD::get_singleton()->compute_list_set_push_constant(compute_list, &push_constant, sizeof(HZBReducePushConstant));
+		RD::get_singleton()->compute_list_dispatch_threads(compute_list, dest_size.width, dest_size.height, 1);
+		if (i < mipmaps - 1) {
+			RD::get_singleton()->compute_list_add_barrier(compute_list);
+		}
+
+		source_size = dest_size;
+	}
+
+	RD::get_singleton()->compute_list_end(graph->get_pass_barrier(hzb_pass));
+
+	CullPushConstant push_constant;
+	RendererStorageRD::store_camera(p_view_projection, push_constant.view_projection);
+	push_constant.screen_size[0] = p_size.width;
+	push_constant.screen_size[1] = p_size.height;
+	push_constant.hzb_mipmaps = mipmaps;
+	push_constant.item_count = items.size();
+
+	compute_list = RD::get_singleton()->compute_list_begin();
+	RD::get_singleton()->compute_list_bind_compute_pipeline(compute_list, pipelines[MODE_CULL]);
+	RD::get_singleton()->compute_list_bind_uniform_set(compute_list, cull_set, 0);
+	RD::get_singleton()->compute_list_set_push_constant(compute_list, &push_constant, sizeof(CullPushConstant));
+	RD::get_singleton()->compute_list_dispatch_threads(compute_list, items.size(), 1, 1);
+	// The commands and visible instances are read by the opaque pass, which the graph does not know about.
+	RD::get_singleton()->compute_list_end(graph->get_pass_barrier(cull_pass) | RD::BARRIER_MASK_RASTER);
+
+	graph->end();
+}
+
+InstanceCullerRD::InstanceCullerRD(RendererStorageRD *p_storage) {
+	storage = p_storage;
+
+	Vector<String> modes;
+	modes.push_back("\n#define MODE_HZB_REDUCE\n");
+	modes.push_back("\n#define MODE_CULL\n");
+
+	shader.initialize(modes);
+	shader_version = shader.version_create();
+	for (int i = 0; i < MODE_MAX; i++) {
+		pipelines[i] = RD::get_singleton()->compute_pipeline_create(shader.version_get_shader(shader_version, i));
+	}
+}
+
+InstanceCullerRD::~InstanceCullerRD() {
+	_clear_uniform_sets();
+	if (item_buffer.is_valid()) {
+		RD::get_singleton()->free(item_buffer);
+		RD::get_singleton()->free(visible_buffer);
+	}
+	if (draw_buffer.is_valid()) {
+		RD::get_singleton()->free(draw_buffer);
+	}
+	shader.version_free(shader_version);
+}
@@ -0,0 +1,128 @@
+/*************************************************************************/
+/*  instance_culler_rd.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef INSTANCE_CULLER_RD_H
+#define INSTANCE_CULLER_RD_H
+
+#include "core/math/camera_matrix.h"
+#include "core/templates/local_vector.h"
+#include "servers/rendering/renderer_rd/renderer_storage_rd.h"
+#include "servers/rendering/renderer_rd/shaders/instance_cull.glsl.gen.h"
+
+// Culls instances on the GPU against the view frustum and a depth pyramid built from the depth prepass.
+// Every draw gets an indirect command whose instance count is filled by the cull pass, along with the
+// list of its visible instances that the vertex shader reads its instance indices from.
+class InstanceCullerRD {
+public:
+	// Matches VkDrawIndexedIndirectCommand (and VkDrawIndirectCommand in its first fields), padded to 32 bytes.
+	struct DrawCommand {
+		uint32_t count;
+		uint32_t instance_count;
+		uint32_t first_index;
+		int32_t vertex_offset;
+		uint32_t first_instance;
+		uint32_t visible_offset; // Where the visible instances of the draw start in the visible instance buffer.
+		uint32_t pad[2];
+	};
+
+private:
+	enum {
+		HZB_MAX_MIPMAPS = 8,
+	};
+
+	enum Mode {
+		MODE_HZB_REDUCE,
+		MODE_CULL,
+		MODE_MAX
+	};
+
+	struct CullItem {
+		float aabb_min[3];
+		uint32_t draw_index;
+		float aabb_max[3];
+		uint32_t instance_index;
+	};
+
+	struct HZBReducePushConstant {
+		int32_t source_size[2];
+		int32_t dest_size[2];
+	};
+
+	struct CullPushConstant {
+		float view_projection[16];
+		float screen_size[2];
+		uint32_t hzb_mipmaps;
+		uint32_t item_count;
+	};
+
+	RendererStorageRD *storage = nullptr;
+
+	InstanceCullShaderRD shader;
+	RID shader_version;
+	RID pipelines[MODE_MAX];
+
+	LocalVector<CullItem> items;
+	LocalVector<DrawCommand> draws;
+
+	RID item_buffer;
+	uint32_t item_buffer_capacity = 0;
+	RID draw_buffer;
+	uint32_t draw_buffer_capacity = 0;
+	RID visible_buffer;
+
+	// The pyramid is a transient texture, so the sets are only rebuilt when the pool hands out a different one.
+	RID hzb_texture;
+	RID depth_texture;
+	LocalVector<RID> hzb_reduce_sets;
+	RID cull_set;
+
+	void _update_buffers();
+	void _clear_uniform_sets();
+
+public:
+	void begin();
+	// Returns the index of the draw, its instances must be added right after.
+	uint32_t add_draw(uint32_t p_count);
+	void add_instance(uint32_t p_draw, uint32_t p_instance_index, const AABB &p_aabb);
+
+	_FORCE_INLINE_ uint32_t get_draw_count() const { return draws.size(); }
+	_FORCE_INLINE_ uint32_t get_draw_visible_offset(uint32_t p_draw) const { return draws[p_draw].visible_offset; }
+
+	// Must be called after the depth prepass, with the resolved depth of the viewport.
+	void cull(RID p_depth, const Size2i &p_size, const CameraMatrix &p_view_projection);
+
+	RID get_draw_command_buffer() const { return draw_buffer; }
+	RID get_visible_instance_buffer() const { return visible_buffer; }
+
+	InstanceCullerRD(RendererStorageRD *p_storage);
+	~InstanceCullerRD();
+};
+
+#endif // INSTANCE_CULLER_RD_H
@@ -0,0 +1,321 @@
+/*************************************************************************/
+/*  render_graph_rd.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "render_graph_rd.h"
+
+bool RenderGraphRD::_is_format_compatible(const RD::TextureFormat &p_pooled, const RD::TextureFormat &p_format) {
+	return p_pooled.format == p_format.format &&
+			p_pooled.width == p_format.width &&
+			p_pooled.height == p_format.height &&
+			p_pooled.depth == p_format.depth &&
+			p_pooled.array_layers == p_format.array_layers &&
+			p_pooled.mipmaps == p_format.mipmaps &&
+			p_pooled.texture_type == p_format.texture_type &&
+			p_pooled.samples == p_format.samples &&
+			(p_pooled.usage_bits & p_format.usage_bits) == p_format.usage_bits &&
+			p_pooled.shareable_formats == p_format.shareable_formats;
+}
+
+int32_t RenderGraphRD::_pool_acquire(const RD::TextureFormat &p_format, const String &p_name, PassID p_first_pass) {
+	for (uint32_t i = 0; i < pool.size(); i++) {
+		if (pool[i]->busy_until < p_first_pass && _is_format_compatible(pool[i]->format, p_format)) {
+			return i;
+		}
+	}
+
+	PooledTexture *pooled = memnew(PooledTexture);
+	pooled->format = p_format;
+	pooled->texture = _texture_create(p_format, p_name, pooled->memory);
+
+	if (pooled->texture.is_null()) {
+		memdelete(pooled);
+		ERR_FAIL_V_MSG(-1, "Unable to create transient texture '" + p_name + "'.");
+	}
+
+	pool_memory += pooled->memory;
+	pool.push_back(pooled);
+	return pool.size() - 1;
+}
+
+void RenderGraphRD::_pool_free(uint32_t p_index) {
+	PooledTexture *pooled = pool[p_index];
+	_texture_free(pooled->texture);
+	pool_memory -= pooled->memory;
+	memdelete(pooled);
+	pool.remove_unordered(p_index);
+}
+
+void RenderGraphRD::_pass_use(PassID p_pass, ResourceID p_resource) {
+	Resource &resource = resources[p_resource];
+	if (resource.first_pass == -1) {
+		resource.first_pass = p_pass;
+	}
+	resource.last_pass = MAX(resource.last_pass, p_pass);
+}
+
+RID RenderGraphRD::_texture_create(const RD::TextureFormat &p_format, const String &p_name, uint64_t &r_memory) {
+	uint64_t memory_before = RD::get_singleton()->get_memory_usage();
+	RID texture = RD::get_singleton()->texture_create(p_format, RD::TextureView());
+	r_memory = RD::get_singleton()->get_memory_usage() - memory_before;
+	if (texture.is_valid()) {
+		RD::get_singleton()->set_resource_name(texture, "Transient " + p_name);
+	}
+	return texture;
+}
+
+void RenderGraphRD::_texture_free(RID p_texture) {
+	// Slices are freed along with the texture they were created from.
+	RD::get_singleton()->free(p_texture);
+}
+
+void RenderGraphRD::_barrier(uint32_t p_from, uint32_t p_to) {
+	RD::get_singleton()->barrier(p_from, p_to);
+}
+
+void RenderGraphRD::update(uint64_t p_frame) {
+	if (p_frame == frame) {
+		return;
+	}
+	frame = p_frame;
+
+	last_frame_stats = frame_stats;
+	frame_stats = Stats();
+
+	for (uint32_t i = 0; i < pool.size(); i++) {
+		if (frame - pool[i]->last_frame > POOL_MAX_IDLE_FRAMES) {
+			_pool_free(i);
+			i--;
+		}
+	}
+}
+
+void RenderGraphRD::begin() {
+	ERR_FAIL_COND_MSG(recording, "A render graph is already being recorded, end() it first.");
+	recording = true;
+	compiled = false;
+}
+
+RenderGraphRD::ResourceID RenderGraphRD::import_texture(RID p_texture, uint32_t p_external_stages) {
+	ERR_FAIL_COND_V(!recording || compiled, -1);
+	Resource resource;
+	resource.imported = p_texture;
+	resource.external_stages = p_external_stages & RD::BARRIER_MASK_ALL;
+	resources.push_back(resource);
+	return resources.size() - 1;
+}
+
+RenderGraphRD::ResourceID RenderGraphRD::create_texture(const RD::TextureFormat &p_format, const String &p_name) {
+	ERR_FAIL_COND_V(!recording || compiled, -1);
+	Resource resource;
+	resource.format = p_format;
+	resource.name = p_name;
+	resources.push_back(resource);
+	return resources.size() - 1;
+}
+
+RenderGraphRD::PassID RenderGraphRD::add_pass(const String &p_name, Stage p_stage) {
+	ERR_FAIL_COND_V(!recording || compiled, -1);
+	Pass pass;
+	pass.name = p_name;
+	pass.stage = p_stage;
+	passes.push_back(pass);
+	return passes.size() - 1;
+}
+
+void RenderGraphRD::pass_read(PassID p_pass, ResourceID p_resource) {
+	ERR_FAIL_COND(!recording || compiled);
+	ERR_FAIL_INDEX(p_pass, (int)passes.size());
+	ERR_FAIL_INDEX(p_resource, (int)resources.size());
+	passes[p_pass].reads.push_back(p_resource);
+	_pass_use(p_pass, p_resource);
+}
+
+void RenderGraphRD::pass_write(PassID p_pass, ResourceID p_resource) {
+	ERR_FAIL_COND(!recording || compiled);
+	ERR_FAIL_INDEX(p_pass, (int)passes.size());
+	ERR_FAIL_INDEX(p_resource, (int)resources.size());
+	passes[p_pass].writes.push_back(p_resource);
+	_pass_use(p_pass, p_resource);
+}
+
+void RenderGraphRD::compile() {
+	ERR_FAIL_COND(!recording || compiled);
+	compiled = true;
+
+	// Dependencies inside the graph: a write must be visible to every later access, and a read
+	// must be done before any later write.
+	for (uint32_t i = 0; i < passes.size(); i++) {
+		Pass &pass = passes[i];
+		for (uint32_t j = i + 1; j < passes.size(); j++) {
+			const Pass &later = passes[j];
+			bool depends = false;
+			for (uint32_t k = 0; k < pass.writes.size() && !depends; k++) {
+				depends = later.reads.find(pass.writes[k]) != -1 || later.writes.find(pass.writes[k]) != -1;
+			}
+			for (uint32_t k = 0; k < pass.reads.size() && !depends; k++) {
+				depends = later.writes.find(pass.reads[k]) != -1;
+			}
+			if (depends) {
+				pass.barrier |= later.stage;
+			}
+		}
+	}
+
+	// Imported textures are used again after the graph.
+	for (uint32_t i = 0; i < resources.size(); i++) {
+		const Resource &resource = resources[i];
+		if (resource.imported.is_valid() && resource.last_pass != -1) {
+			passes[resource.last_pass].barrier |= resource.external_stages;
+		}
+	}
+
+	// Assign transient textures in pass order, so a pooled texture is reused as soon as the
+	// previous resource using it is done with it.
+	for (uint32_t i = 0; i < passes.size(); i++) {
+		for (uint32_t j = 0; j < resources.size(); j++) {
+			Resource &resource = resources[j];
+			if (resource.imported.is_valid() || resource.first_pass != (PassID)i) {
+				continue;
+			}
+
+			resource.pooled = _pool_acquire(resource.format, resource.name, i);
+			if (resource.pooled == -1) {
+				continue;
+			}
+			PooledTexture *pooled = pool[resource.pooled];
+
+			if (pooled->passes.size()) {
+				// Aliased with an earlier resource of this graph, the passes using it must be done first.
+				for (uint32_t k = 0; k < pooled->passes.size(); k++) {
+					passes[pooled->passes[k]].barrier |= passes[i].stage;
+				}
+				pooled->passes.clear();
+			} else if (pooled->pending_stages && (passes[i].stage & ~pooled->synced_stages)) {
+				// Last used by a previous graph that did not wait for this stage, which already
+				// finished recording, so the barrier goes right before this graph.
+				_barrier(pooled->pending_stages, passes[i].stage);
+				frame_stats.barriers++;
+			}
+
+			for (uint32_t k = resource.first_pass; k <= (uint32_t)resource.last_pass; k++) {
+				if (passes[k].reads.find(j) != -1 || passes[k].writes.find(j) != -1) {
+					pooled->passes.push_back(k);
+				}
+			}
+			pooled->busy_until = resource.last_pass;
+			pooled->last_frame = frame;
+			frame_stats.transient_memory_requested += pooled->memory;
+		}
+	}
+
+	for (uint32_t i = 0; i < passes.size(); i++) {
+		uint32_t waited = 0;
+		for (uint32_t stage = STAGE_RASTER; stage <= STAGE_TRANSFER; stage <<= 1) {
+			if (passes[i].barrier & stage) {
+				waited++;
+			}
+		}
+		frame_stats.barriers += waited;
+		frame_stats.barriers_elided += 3 - waited;
+	}
+}
+
+RID RenderGraphRD::get_texture(ResourceID p_resource) const {
+	ERR_FAIL_COND_V_MSG(!compiled, RID(), "Textures are assigned when the render graph is compiled.");
+	ERR_FAIL_INDEX_V(p_resource, (int)resources.size(), RID());
+	const Resource &resource = resources[p_resource];
+	if (resource.imported.is_valid()) {
+		return resource.imported;
+	}
+	ERR_FAIL_COND_V_MSG(resource.pooled == -1, RID(), "Transient texture '" + resource.name + "' is not used by any pass.");
+	return pool[resource.pooled]->texture;
+}
+
+RID RenderGraphRD::get_texture_slice(ResourceID p_resource, uint32_t p_layer, uint32_t p_mipmap, RD::TextureSliceType p_slice_type) {
+	ERR_FAIL_COND_V_MSG(!compiled, RID(), "Textures are assigned when the render graph is compiled.");
+	ERR_FAIL_INDEX_V(p_resource, (int)resources.size(), RID());
+	const Resource &resource = resources[p_resource];
+	ERR_FAIL_COND_V_MSG(resource.pooled == -1, RID(), "Only transient textures keep their slices in the render graph.");
+
+	// Slices are kept with the pooled texture, so they stay valid while it is reused.
+	PooledTexture *pooled = pool[resource.pooled];
+	uint64_t key = (uint64_t(p_slice_type) << 48) | (uint64_t(p_mipmap) << 32) | p_layer;
+	Map<uint64_t, RID>::Element *E = pooled->slices.find(key);
+	if (E) {
+		return E->get();
+	}
+
+	RID slice = RD::get_singleton()->texture_create_shared_from_slice(RD::TextureView(), pooled->texture, p_layer, p_mipmap, p_slice_type);
+	ERR_FAIL_COND_V(slice.is_null(), RID());
+	RD::get_singleton()->set_resource_name(slice, "Transient " + resource.name + " Layer " + itos(p_layer) + " Mip " + itos(p_mipmap));
+	pooled->slices[key] = slice;
+	return slice;
+}
+
+uint32_t RenderGraphRD::get_pass_barrier(PassID p_pass) const {
+	ERR_FAIL_COND_V_MSG(!compiled, RD::BARRIER_MASK_ALL, "Barriers are known when the render graph is compiled.");
+	ERR_FAIL_INDEX_V(p_pass, (int)passes.size(), RD::BARRIER_MASK_ALL);
+	return passes[p_pass].barrier ? passes[p_pass].barrier : uint32_t(RD::BARRIER_MASK_NO_BARRIER);
+}
+
+void RenderGraphRD::end() {
+	ERR_FAIL_COND(!recording);
+
+	for (uint32_t i = 0; i < pool.size(); i++) {
+		PooledTexture *pooled = pool[i];
+		if (pooled->passes.size()) {
+			// Remember what the next graph using it has to wait for.
+			pooled->pending_stages = 0;
+			pooled->synced_stages = RD::BARRIER_MASK_ALL;
+			for (uint32_t j = 0; j < pooled->passes.size(); j++) {
+				pooled->pending_stages |= passes[pooled->passes[j]].stage;
+				pooled->synced_stages &= passes[pooled->passes[j]].barrier;
+			}
+			pooled->passes.clear();
+		}
+		pooled->busy_until = -1;
+	}
+
+	resources.clear();
+	passes.clear();
+	recording = false;
+	compiled = false;
+}
+
+void RenderGraphRD::clear_pool() {
+	ERR_FAIL_COND(recording);
+	while (pool.size()) {
+		_pool_free(pool.size() - 1);
+	}
+}
+
+RenderGraphRD::~RenderGraphRD() {
+	clear_pool();
+}
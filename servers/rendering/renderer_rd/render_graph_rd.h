@@ -0,0 +1,151 @@
+/*************************************************************************/
+/*  render_graph_rd.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RENDER_GRAPH_RD_H
+#define RENDER_GRAPH_RD_H
+
+#include "core/templates/local_vector.h"
+#include "core/templates/map.h"
+#include "servers/rendering/rendering_device.h"
+
+// Describes a part of the frame as passes declaring which textures they read and write.
+// Transient textures only exist between their first and last pass, so they are taken from a
+// pool shared by every graph, and textures whose lifetimes do not overlap reuse the same one.
+// The barrier after each pass only waits for the stages of the passes that depend on it.
+//
+// So far only SSAO and SSR are described this way, each in a graph of its own around the effect,
+// so their textures are only shared through the pool, with a barrier between the graphs when
+// needed. Bloom, depth of field and volumetric fog still keep their textures in RenderBuffers.
+class RenderGraphRD {
+public:
+	enum Stage {
+		STAGE_RASTER = RD::BARRIER_MASK_RASTER,
+		STAGE_COMPUTE = RD::BARRIER_MASK_COMPUTE,
+		STAGE_TRANSFER = RD::BARRIER_MASK_TRANSFER,
+	};
+
+	typedef int32_t ResourceID;
+	typedef int32_t PassID;
+
+	struct Stats {
+		uint64_t transient_memory_requested = 0; // What the transient textures would use if each had its own.
+		uint64_t barriers = 0; // Stages waited on after passes, plus barriers between graphs reusing a texture.
+		uint64_t barriers_elided = 0; // Stages a full barrier after every pass would also have waited on.
+	};
+
+private:
+	enum {
+		POOL_MAX_IDLE_FRAMES = 30,
+	};
+
+	struct PooledTexture {
+		RD::TextureFormat format;
+		RID texture;
+		uint64_t memory = 0;
+		Map<uint64_t, RID> slices;
+		uint64_t last_frame = 0;
+		PassID busy_until = -1; // Last pass of the current graph using it.
+		LocalVector<PassID> passes; // Passes of the current graph using it.
+		uint32_t pending_stages = 0; // Stages that used it in a previous graph.
+		uint32_t synced_stages = RD::BARRIER_MASK_ALL; // Stages those uses are synchronized with.
+	};
+
+	struct Resource {
+		RD::TextureFormat format;
+		String name;
+		RID imported;
+		uint32_t external_stages = 0;
+		PassID first_pass = -1;
+		PassID last_pass = -1;
+		int32_t pooled = -1;
+	};
+
+	struct Pass {
+		String name;
+		uint32_t stage = 0;
+		LocalVector<ResourceID> reads;
+		LocalVector<ResourceID> writes;
+		uint32_t barrier = 0;
+	};
+
+	LocalVector<PooledTexture *> pool;
+	uint64_t pool_memory = 0;
+
+	LocalVector<Resource> resources;
+	LocalVector<Pass> passes;
+	bool recording = false;
+	bool compiled = false;
+
+	uint64_t frame = 0;
+	Stats frame_stats;
+	Stats last_frame_stats;
+
+	static bool _is_format_compatible(const RD::TextureFormat &p_pooled, const RD::TextureFormat &p_format);
+	int32_t _pool_acquire(const RD::TextureFormat &p_format, const String &p_name, PassID p_first_pass);
+	void _pool_free(uint32_t p_index);
+	void _pass_use(PassID p_pass, ResourceID p_resource);
+
+protected:
+	// Everything the graph asks from the rendering device for its own textures and barriers.
+	virtual RID _texture_create(const RD::TextureFormat &p_format, const String &p_name, uint64_t &r_memory);
+	virtual void _texture_free(RID p_texture);
+	virtual void _barrier(uint32_t p_from, uint32_t p_to);
+
+public:
+	// Called once per frame, rolls the statistics over and releases textures no graph used in a while.
+	void update(uint64_t p_frame);
+
+	void begin();
+
+	// External stages are the ones that access the texture after the graph, the last pass using it waits for them.
+	ResourceID import_texture(RID p_texture, uint32_t p_external_stages = RD::BARRIER_MASK_ALL);
+	ResourceID create_texture(const RD::TextureFormat &p_format, const String &p_name);
+
+	PassID add_pass(const String &p_name, Stage p_stage);
+	void pass_read(PassID p_pass, ResourceID p_resource);
+	void pass_write(PassID p_pass, ResourceID p_resource);
+
+	void compile();
+
+	RID get_texture(ResourceID p_resource) const;
+	RID get_texture_slice(ResourceID p_resource, uint32_t p_layer, uint32_t p_mipmap, RD::TextureSliceType p_slice_type = RD::TEXTURE_SLICE_2D);
+	uint32_t get_pass_barrier(PassID p_pass) const;
+
+	void end();
+
+	uint64_t get_transient_memory_used() const { return pool_memory; }
+	const Stats &get_last_frame_stats() const { return last_frame_stats; }
+
+	void clear_pool();
+
+	virtual ~RenderGraphRD();
+};
+
+#endif // RENDER_GRAPH_RD_H
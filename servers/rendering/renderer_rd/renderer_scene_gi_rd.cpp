@@ -800,7 +800,24 @@ void RendererSceneGIRD::SDFGI::update(RendererSceneEnvironmentRD *p_env, const V
 		world_position.y *= y_mult;
 		Vector3i pos_in_cascade = Vector3i((world_position + probe_half_size) / cascade.cell_size);
 
+		bool camera_cut = false;
 		for (int j = 0; j < 3; j++) {
+			if (uint32_t(ABS(pos_in_cascade[j] - cascade.position[j])) >= cascade_size) {
+				camera_cut = true;
+				break;
+			}
+		}
+
+		if (camera_cut) {
+			//camera cut or teleport, nothing in the cascade can be reused, so center it again like a new one instead of dragging it all the way
+			int32_t probe_cells = cascade_size / SDFGI::PROBE_DIVISOR;
+			Vector3 probe_size = Vector3(1, 1, 1) * cascade.cell_size * probe_cells;
+			Vector3i probe_pos = Vector3i((world_position / probe_size + Vector3(0.5, 0.5, 0.5)).floor());
+			cascade.position = probe_pos * probe_cells;
+			cascade.dirty_regions = SDFGI::Cascade::DIRTY_ALL;
+		}
+
+		for (int j = 0; j < 3 && !camera_cut; j++) {
 			if (pos_in_cascade[j] < cascade.position[j]) {
 				while (pos_in_cascade[j] < (cascade.position[j] - drag_margin)) {
 					cascade.position[j] -= drag_margin * 2;
@@ -835,6 +852,86 @@ void RendererSceneGIRD::SDFGI::update(RendererSceneEnvironmentRD *p_env, const V
 				cascade.dirty_regions = SDFGI::Cascade::DIRTY_ALL;
 			}
 		}
+
+		if (cascade.dirty_regions == SDFGI::Cascade::DIRTY_ALL) {
+			//probes are not scrolled along, so their history belongs to the old place
+			cascade.probe_history_dirty = true;
+		}
+
+		cascade.refresh_offset = Vector3i();
+		cascade.refresh_size = Vector3i();
+
+		if (cascade.refresh_pending_size == Vector3i()) {
+			continue;
+		}
+
+		if (cascade.dirty_regions == SDFGI::Cascade::DIRTY_ALL) {
+			//everything is re-voxelized anyway
+			cascade.refresh_pending_offset = Vector3i();
+			cascade.refresh_pending_size = Vector3i();
+		} else if (cascade.dirty_regions != Vector3i()) {
+			//scrolling, keep the pending cells for a later frame, moved along with the existing data
+			Vector3i from = cascade.refresh_pending_offset + cascade.dirty_regions;
+			Vector3i to = from + cascade.refresh_pending_size;
+			for (int j = 0; j < 3; j++) {
+				from[j] = CLAMP(from[j], 0, int32_t(cascade_size));
+				to[j] = CLAMP(to[j], 0, int32_t(cascade_size));
+				if (from[j] >= to[j]) {
+					//scrolled out of the cascade
+					from = Vector3i();
+					to = Vector3i();
+					break;
+				}
+			}
+			cascade.refresh_pending_offset = from;
+			cascade.refresh_pending_size = to - from;
+		} else {
+			cascade.refresh_offset = cascade.refresh_pending_offset;
+			cascade.refresh_size = cascade.refresh_pending_size;
+			cascade.refresh_pending_offset = Vector3i();
+			cascade.refresh_pending_size = Vector3i();
+		}
+	}
+}
+
+void RendererSceneGIRD::SDFGI::mark_static_dirty(const AABB &p_aabb) {
+	Vector3 world_from = p_aabb.position;
+	Vector3 world_to = p_aabb.position + p_aabb.size;
+	world_from.y *= y_mult;
+	world_to.y *= y_mult;
+
+	for (uint32_t i = 0; i < cascades.size(); i++) {
+		SDFGI::Cascade &cascade = cascades[i];
+		Vector3i cascade_from = cascade.position - Vector3i(1, 1, 1) * int32_t(cascade_size >> 1);
+
+		//one cell of margin, voxelization is conservative
+		Vector3i from = Vector3i((world_from / cascade.cell_size).floor()) - cascade_from - Vector3i(1, 1, 1);
+		Vector3i to = Vector3i((world_to / cascade.cell_size).floor()) - cascade_from + Vector3i(2, 2, 2);
+
+		bool outside = false;
+		for (int j = 0; j < 3; j++) {
+			from[j] = MAX(from[j], 0);
+			to[j] = MIN(to[j], int32_t(cascade_size));
+			if (from[j] >= to[j]) {
+				outside = true;
+				break;
+			}
+		}
+
+		if (outside) {
+			continue;
+		}
+
+		if (cascade.refresh_pending_size != Vector3i()) {
+			Vector3i pending_to = cascade.refresh_pending_offset + cascade.refresh_pending_size;
+			for (int j = 0; j < 3; j++) {
+				from[j] = MIN(from[j], cascade.refresh_pending_offset[j]);
+				to[j] = MAX(to[j], pending_to[j]);
+			}
+		}
+
+		cascade.refresh_pending_offset = from;
+		cascade.refresh_pending_size = to - from;
 	}
 }
 
@@ -1037,6 +1134,18 @@ int RendererSceneGIRD::SDFGI::get_pending_region_data(int p_region, Vector3i &r_
 				return i;
 			}
 			dirty_count++;
+		} else if (c.dirty_regions == Vector3i()) {
+			if (c.refresh_size != Vector3i()) {
+				if (dirty_count == p_region) {
+					r_local_offset = c.refresh_offset;
+					r_local_size = c.refresh_size;
+
+					r_bounds.position = Vector3(c.refresh_offset + Vector3i(1, 1, 1) * -int32_t(cascade_size >> 1) + c.position) * c.cell_size * Vector3(1, 1.0 / y_mult, 1);
+					r_bounds.size = Vector3(r_local_size) * c.cell_size * Vector3(1, 1.0 / y_mult, 1);
+					return i;
+				}
+				dirty_count++;
+			}
 		} else {
 			for (int j = 0; j < 3; j++) {
 				if (c.dirty_regions[j] != 0) {
@@ -1078,6 +1187,29 @@ int RendererSceneGIRD::SDFGI::get_pending_region_data(int p_region, Vector3i &r_
 	return -1;
 }
 
+int RendererSceneGIRD::SDFGI::get_pending_region_count() const {
+	int dirty_count = 0;
+	for (uint32_t i = 0; i < cascades.size(); i++) {
+		const SDFGI::Cascade &c = cascades[i];
+
+		if (c.dirty_regions == SDFGI::Cascade::DIRTY_ALL) {
+			dirty_count++;
+		} else if (c.dirty_regions == Vector3i()) {
+			if (c.refresh_size != Vector3i()) {
+				dirty_count++;
+			}
+		} else {
+			for (int j = 0; j < 3; j++) {
+				if (c.dirty_regions[j] != 0) {
+					dirty_count++;
+				}
+			}
+		}
+	}
+
+	return dirty_count;
+}
+
 void RendererSceneGIRD::SDFGI::update_cascades() {
 	//update cascades
 	SDFGI::Cascade::UBO cascade_data[SDFGI::MAX_CASCADES];
@@ -1575,6 +1707,13 @@ void RendererSceneGIRD::SDFGI::render_region(RID p_render_buffers, int p_region,
 			push_constant.scroll[0] = dirty.x;
 			push_constant.scroll[1] = dirty.y;
 			push_constant.scroll[2] = dirty.z;
+
+			//cells that were just re-voxelized must not be overwritten by the old data
+			Vector3i refresh_to = cascades[cascade].refresh_offset + cascades[cascade].refresh_size;
+			for (int j = 0; j < 3; j++) {
+				push_constant.refresh_from[j] = cascades[cascade].refresh_offset[j];
+				push_constant.refresh_to[j] = refresh_to[j];
+			}
 		} else {
 			//for no scroll
 			push_constant.scroll[0] = 0;
@@ -1582,6 +1721,13 @@ void RendererSceneGIRD::SDFGI::render_region(RID p_render_buffers, int p_region,
 			push_constant.scroll[2] = 0;
 		}
 
+		if (cascades[cascade].probe_history_dirty) {
+			//start accumulating again, averaging in the history of the old place would leak its light into the new one
+			RD::get_singleton()->texture_clear(cascades[cascade].lightprobe_history_tex, Color(0, 0, 0, 0), 0, 1, 0, history_size);
+			RD::get_singleton()->texture_clear(cascades[cascade].lightprobe_average_tex, Color(0, 0, 0, 0), 0, 1, 0, 1);
+			cascades[cascade].probe_history_dirty = false;
+		}
+
 		cascades[cascade].all_dynamic_lights_dirty = true;
 
 		push_constant.grid_size = cascade_size;
@@ -1612,7 +1758,7 @@ void RendererSceneGIRD::SDFGI::render_region(RID p_render_buffers, int p_region,
 
 			//no barrier, continue together
 
-			{
+			if (dirty != Vector3i()) {
 				//scroll probes and their history also
 
 				SDFGIShader::IntegratePushConstant ipush_constant;
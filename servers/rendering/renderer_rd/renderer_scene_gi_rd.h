@@ -182,6 +182,12 @@ private:
 			uint32_t occlusion_index;
 			int32_t cascade;
 			uint32_t pad;
+
+			int32_t refresh_from[3];
+			uint32_t pad2;
+
+			int32_t refresh_to[3];
+			uint32_t pad3;
 		};
 
 		SdfgiPreprocessShaderRD preprocess;
@@ -445,6 +451,12 @@ public:
 			static const Vector3i DIRTY_ALL;
 			Vector3i dirty_regions; //(0,0,0 is not dirty, negative is refresh from the end, DIRTY_ALL is refresh all.
 
+			//cells touched by static geometry changes, re-voxelized when the cascade is not scrolling (empty size is nothing to refresh)
+			Vector3i refresh_offset;
+			Vector3i refresh_size;
+			Vector3i refresh_pending_offset;
+			Vector3i refresh_pending_size;
+
 			RID sdf_store_uniform_set;
 			RID sdf_direct_light_uniform_set;
 			RID scroll_uniform_set;
@@ -453,6 +465,7 @@ public:
 			RID lights_buffer;
 
 			bool all_dynamic_lights_dirty = true;
+			bool probe_history_dirty = false;
 		};
 
 		// access to our containers
@@ -525,6 +538,8 @@ public:
 		void update_probes(RendererSceneEnvironmentRD *p_env, RendererSceneSkyRD::Sky *p_sky);
 		void store_probes();
 		int get_pending_region_data(int p_region, Vector3i &r_local_offset, Vector3i &r_local_size, AABB &r_bounds) const;
+		int get_pending_region_count() const;
+		void mark_static_dirty(const AABB &p_aabb);
 		void update_cascades();
 
 		void debug_draw(const CameraMatrix &p_projection, const Transform &p_transform, int p_width, int p_height, RID p_render_target, RID p_texture);
@@ -91,22 +91,18 @@ int RendererSceneRenderRD::sdfgi_get_pending_region_count(RID p_render_buffers)
 		return 0;
 	}
 
-	int dirty_count = 0;
-	for (uint32_t i = 0; i < rb->sdfgi->cascades.size(); i++) {
-		const RendererSceneGIRD::SDFGI::Cascade &c = rb->sdfgi->cascades[i];
+	return rb->sdfgi->get_pending_region_count();
+}
 
-		if (c.dirty_regions == RendererSceneGIRD::SDFGI::Cascade::DIRTY_ALL) {
-			dirty_count++;
-		} else {
-			for (int j = 0; j < 3; j++) {
-				if (c.dirty_regions[j] != 0) {
-					dirty_count++;
-				}
-			}
-		}
+void RendererSceneRenderRD::sdfgi_mark_static_dirty(RID p_render_buffers, const AABB &p_aabb) {
+	RenderBuffers *rb = render_buffers_owner.getornull(p_render_buffers);
+	ERR_FAIL_COND(rb == nullptr);
+
+	if (rb->sdfgi == nullptr) {
+		return;
 	}
 
-	return dirty_count;
+	rb->sdfgi->mark_static_dirty(p_aabb);
 }
 
 AABB RendererSceneRenderRD::sdfgi_get_pending_region_bounds(RID p_render_buffers, int p_region) const {
@@ -805,7 +801,7 @@ void RendererSceneRenderRD::_update_shadow_atlas(ShadowAtlas *shadow_atlas) {
 		tf.format = shadow_atlas->use_16_bits ? RD::DATA_FORMAT_D16_UNORM : RD::DATA_FORMAT_D32_SFLOAT;
 		tf.width = shadow_atlas->size;
 		tf.height = shadow_atlas->size;
-		tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | RD::TEXTURE_USAGE_CAN_COPY_TO_BIT;
 
 		shadow_atlas->depth = RD::get_singleton()->texture_create(tf, RD::TextureView());
 		Vector<RID> fb_tex;
@@ -829,6 +825,10 @@ void RendererSceneRenderRD::shadow_atlas_set_size(RID p_atlas, int p_size, bool
 		RD::get_singleton()->free(shadow_atlas->depth);
 		shadow_atlas->depth = RID();
 	}
+	if (shadow_atlas->static_depth.is_valid()) {
+		RD::get_singleton()->free(shadow_atlas->static_depth);
+		shadow_atlas->static_depth = RID();
+	}
 	for (int i = 0; i < 4; i++) {
 		//clear subdivisions
 		shadow_atlas->quadrants[i].shadows.resize(0);
@@ -1107,7 +1107,7 @@ void RendererSceneRenderRD::_update_directional_shadow_atlas() {
 		tf.format = directional_shadow.use_16_bits ? RD::DATA_FORMAT_D16_UNORM : RD::DATA_FORMAT_D32_SFLOAT;
 		tf.width = directional_shadow.size;
 		tf.height = directional_shadow.size;
-		tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | RD::TEXTURE_USAGE_CAN_COPY_TO_BIT;
 
 		directional_shadow.depth = RD::get_singleton()->texture_create(tf, RD::TextureView());
 		Vector<RID> fb_tex;
@@ -1129,6 +1129,10 @@ void RendererSceneRenderRD::directional_shadow_atlas_set_size(int p_size, bool p
 		directional_shadow.depth = RID();
 		_base_uniforms_changed();
 	}
+	if (directional_shadow.static_depth.is_valid()) {
+		RD::get_singleton()->free(directional_shadow.static_depth);
+		directional_shadow.static_depth = RID();
+	}
 }
 
 void RendererSceneRenderRD::set_directional_shadow_count(int p_count) {
@@ -1474,38 +1478,9 @@ void RendererSceneRenderRD::_free_render_buffer_data(RenderBuffers *rb) {
 		rb->luminance.current = RID();
 	}
 
-	if (rb->ssao.depth.is_valid()) {
-		RD::get_singleton()->free(rb->ssao.depth);
-		RD::get_singleton()->free(rb->ssao.ao_deinterleaved);
-		RD::get_singleton()->free(rb->ssao.ao_pong);
+	if (rb->ssao.ao_final.is_valid()) {
 		RD::get_singleton()->free(rb->ssao.ao_final);
-
-		RD::get_singleton()->free(rb->ssao.importance_map[0]);
-		RD::get_singleton()->free(rb->ssao.importance_map[1]);
-
-		rb->ssao.depth = RID();
-		rb->ssao.ao_deinterleaved = RID();
-		rb->ssao.ao_pong = RID();
 		rb->ssao.ao_final = RID();
-		rb->ssao.importance_map[0] = RID();
-		rb->ssao.importance_map[1] = RID();
-		rb->ssao.depth_slices.clear();
-		rb->ssao.ao_deinterleaved_slices.clear();
-		rb->ssao.ao_pong_slices.clear();
-	}
-
-	if (rb->ssr.blur_radius[0].is_valid()) {
-		RD::get_singleton()->free(rb->ssr.blur_radius[0]);
-		RD::get_singleton()->free(rb->ssr.blur_radius[1]);
-		rb->ssr.blur_radius[0] = RID();
-		rb->ssr.blur_radius[1] = RID();
-	}
-
-	if (rb->ssr.depth_scaled.is_valid()) {
-		RD::get_singleton()->free(rb->ssr.depth_scaled);
-		rb->ssr.depth_scaled = RID();
-		RD::get_singleton()->free(rb->ssr.normal_scaled);
-		rb->ssr.normal_scaled = RID();
 	}
 
 	if (rb->ambient_buffer.is_valid()) {
@@ -1551,38 +1526,69 @@ void RendererSceneRenderRD::_process_ssr(RID p_render_buffers, RID p_dest_frameb
 
 	ERR_FAIL_COND(!env->ssr_enabled);
 
-	if (rb->ssr.depth_scaled.is_null()) {
-		RD::TextureFormat tf;
-		tf.format = RD::DATA_FORMAT_R32_SFLOAT;
-		tf.width = rb->width / 2;
-		tf.height = rb->height / 2;
-		tf.texture_type = RD::TEXTURE_TYPE_2D;
-		tf.usage_bits = RD::TEXTURE_USAGE_STORAGE_BIT;
+	if (rb->blur[0].texture.is_null()) {
+		_allocate_blur_textures(rb);
+	}
 
-		rb->ssr.depth_scaled = RD::get_singleton()->texture_create(tf, RD::TextureView());
+	// Everything but the result only lives during the effect, so it comes from the render graph pool.
+	RenderGraphRD *graph = storage->get_render_graph();
+	graph->begin();
 
-		tf.format = RD::DATA_FORMAT_R8G8B8A8_UNORM;
+	RD::TextureFormat tf;
+	tf.format = RD::DATA_FORMAT_R32_SFLOAT;
+	tf.width = rb->width / 2;
+	tf.height = rb->height / 2;
+	tf.texture_type = RD::TEXTURE_TYPE_2D;
+	tf.usage_bits = RD::TEXTURE_USAGE_STORAGE_BIT;
+	RenderGraphRD::ResourceID depth_scaled = graph->create_texture(tf, "SSR Depth Scaled");
 
-		rb->ssr.normal_scaled = RD::get_singleton()->texture_create(tf, RD::TextureView());
-	}
+	tf.format = RD::DATA_FORMAT_R8G8B8A8_UNORM;
+	RenderGraphRD::ResourceID normal_scaled = graph->create_texture(tf, "SSR Normal Scaled");
 
-	if (ssr_roughness_quality != RS::ENV_SSR_ROUGNESS_QUALITY_DISABLED && !rb->ssr.blur_radius[0].is_valid()) {
-		RD::TextureFormat tf;
+	tf.format = RD::DATA_FORMAT_R16G16B16A16_SFLOAT;
+	RenderGraphRD::ResourceID output_blur = graph->create_texture(tf, "SSR Blur");
+
+	RenderGraphRD::ResourceID blur_radius[2] = { -1, -1 };
+	if (ssr_roughness_quality != RS::ENV_SSR_ROUGNESS_QUALITY_DISABLED) {
 		tf.format = RD::DATA_FORMAT_R8_UNORM;
-		tf.width = rb->width / 2;
-		tf.height = rb->height / 2;
-		tf.texture_type = RD::TEXTURE_TYPE_2D;
 		tf.usage_bits = RD::TEXTURE_USAGE_STORAGE_BIT | RD::TEXTURE_USAGE_SAMPLING_BIT;
+		blur_radius[0] = graph->create_texture(tf, "SSR Blur Radius");
+		blur_radius[1] = graph->create_texture(tf, "SSR Blur Radius Pong");
+	}
+
+	// Merging the specular right after is a raster pass, and its own barrier carries the
+	// dependency over to anything later in the frame.
+	RenderGraphRD::ResourceID diffuse = graph->import_texture(rb->texture, RD::BARRIER_MASK_RASTER);
+	RenderGraphRD::ResourceID depth = graph->import_texture(rb->depth_texture, RD::BARRIER_MASK_RASTER);
+	RenderGraphRD::ResourceID normal = graph->import_texture(p_normal_buffer, RD::BARRIER_MASK_RASTER);
+	RenderGraphRD::ResourceID metallic = graph->import_texture(p_metallic, RD::BARRIER_MASK_RASTER);
+	RenderGraphRD::ResourceID output = graph->import_texture(rb->blur[0].mipmaps[1].texture, RD::BARRIER_MASK_RASTER);
 
-		rb->ssr.blur_radius[0] = RD::get_singleton()->texture_create(tf, RD::TextureView());
-		rb->ssr.blur_radius[1] = RD::get_singleton()->texture_create(tf, RD::TextureView());
+	RenderGraphRD::PassID ssr_pass = graph->add_pass("Screen Space Reflection", RenderGraphRD::STAGE_COMPUTE);
+	graph->pass_read(ssr_pass, diffuse);
+	graph->pass_read(ssr_pass, depth);
+	graph->pass_read(ssr_pass, normal);
+	graph->pass_read(ssr_pass, metallic);
+	graph->pass_write(ssr_pass, depth_scaled);
+	graph->pass_write(ssr_pass, normal_scaled);
+	graph->pass_write(ssr_pass, output_blur);
+	graph->pass_write(ssr_pass, output);
+	if (blur_radius[0] != -1) {
+		graph->pass_write(ssr_pass, blur_radius[0]);
+		graph->pass_write(ssr_pass, blur_radius[1]);
 	}
 
-	if (rb->blur[0].texture.is_null()) {
-		_allocate_blur_textures(rb);
+	graph->compile();
+
+	RID blur_radius_texture[2];
+	if (blur_radius[0] != -1) {
+		blur_radius_texture[0] = graph->get_texture(blur_radius[0]);
+		blur_radius_texture[1] = graph->get_texture(blur_radius[1]);
 	}
 
-	storage->get_effects()->screen_space_reflection(rb->texture, p_normal_buffer, ssr_roughness_quality, rb->ssr.blur_radius[0], rb->ssr.blur_radius[1], p_metallic, p_metallic_mask, rb->depth_texture, rb->ssr.depth_scaled, rb->ssr.normal_scaled, rb->blur[0].mipmaps[1].texture, rb->blur[1].mipmaps[0].texture, Size2i(rb->width / 2, rb->height / 2), env->ssr_max_steps, env->ssr_fade_in, env->ssr_fade_out, env->ssr_depth_tolerance, p_projection);
+	storage->get_effects()->screen_space_reflection(rb->texture, p_normal_buffer, ssr_roughness_quality, blur_radius_texture[0], blur_radius_texture[1], p_metallic, p_metallic_mask, rb->depth_texture, graph->get_texture(depth_scaled), graph->get_texture(normal_scaled), graph->get_texture(output), graph->get_texture(output_blur), Size2i(rb->width / 2, rb->height / 2), env->ssr_max_steps, env->ssr_fade_in, env->ssr_fade_out, env->ssr_depth_tolerance, p_projection, graph->get_pass_barrier(ssr_pass));
+	graph->end();
+
 	storage->get_effects()->merge_specular(p_dest_framebuffer, p_specular_buffer, p_use_additive ? RID() : rb->texture, rb->blur[0].mipmaps[1].texture);
 }
 
@@ -1595,26 +1601,6 @@ void RendererSceneRenderRD::_process_ssao(RID p_render_buffers, RID p_environmen
 
 	RENDER_TIMESTAMP("Process SSAO");
 
-	if (rb->ssao.ao_final.is_valid() && ssao_using_half_size != ssao_half_size) {
-		RD::get_singleton()->free(rb->ssao.depth);
-		RD::get_singleton()->free(rb->ssao.ao_deinterleaved);
-		RD::get_singleton()->free(rb->ssao.ao_pong);
-		RD::get_singleton()->free(rb->ssao.ao_final);
-
-		RD::get_singleton()->free(rb->ssao.importance_map[0]);
-		RD::get_singleton()->free(rb->ssao.importance_map[1]);
-
-		rb->ssao.depth = RID();
-		rb->ssao.ao_deinterleaved = RID();
-		rb->ssao.ao_pong = RID();
-		rb->ssao.ao_final = RID();
-		rb->ssao.importance_map[0] = RID();
-		rb->ssao.importance_map[1] = RID();
-		rb->ssao.depth_slices.clear();
-		rb->ssao.ao_deinterleaved_slices.clear();
-		rb->ssao.ao_pong_slices.clear();
-	}
-
 	int buffer_width;
 	int buffer_height;
 	int half_width;
@@ -1630,84 +1616,86 @@ void RendererSceneRenderRD::_process_ssao(RID p_render_buffers, RID p_environmen
 		half_width = (rb->width + 3) / 4;
 		half_height = (rb->height + 3) / 4;
 	}
-	bool uniform_sets_are_invalid = false;
-	if (rb->ssao.depth.is_null()) {
-		//allocate depth slices
+	if (rb->ssao.ao_final.is_null()) {
+		RD::TextureFormat tf;
+		tf.format = RD::DATA_FORMAT_R8_UNORM;
+		tf.width = rb->width;
+		tf.height = rb->height;
+		tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_STORAGE_BIT;
+		rb->ssao.ao_final = RD::get_singleton()->texture_create(tf, RD::TextureView());
+		RD::get_singleton()->set_resource_name(rb->ssao.ao_final, "SSAO Final");
+	}
 
-		{
-			RD::TextureFormat tf;
-			tf.format = RD::DATA_FORMAT_R16_SFLOAT;
-			tf.texture_type = RD::TEXTURE_TYPE_2D_ARRAY;
-			tf.width = buffer_width;
-			tf.height = buffer_height;
-			tf.mipmaps = 4;
-			tf.array_layers = 4;
-			tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_STORAGE_BIT;
-			rb->ssao.depth = RD::get_singleton()->texture_create(tf, RD::TextureView());
-			RD::get_singleton()->set_resource_name(rb->ssao.depth, "SSAO Depth");
-			for (uint32_t i = 0; i < tf.mipmaps; i++) {
-				RID slice = RD::get_singleton()->texture_create_shared_from_slice(RD::TextureView(), rb->ssao.depth, 0, i, RD::TEXTURE_SLICE_2D_ARRAY);
-				rb->ssao.depth_slices.push_back(slice);
-				RD::get_singleton()->set_resource_name(rb->ssao.depth_slices[i], "SSAO Depth Mip " + itos(i) + " ");
-			}
-		}
+	// Only the final AO outlives the effect, the rest comes from the render graph pool.
+	RenderGraphRD *graph = storage->get_render_graph();
+	graph->begin();
 
-		{
-			RD::TextureFormat tf;
-			tf.format = RD::DATA_FORMAT_R8G8_UNORM;
-			tf.texture_type = RD::TEXTURE_TYPE_2D_ARRAY;
-			tf.width = buffer_width;
-			tf.height = buffer_height;
-			tf.array_layers = 4;
-			tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_STORAGE_BIT;
-			rb->ssao.ao_deinterleaved = RD::get_singleton()->texture_create(tf, RD::TextureView());
-			RD::get_singleton()->set_resource_name(rb->ssao.ao_deinterleaved, "SSAO De-interleaved Array");
-			for (uint32_t i = 0; i < 4; i++) {
-				RID slice = RD::get_singleton()->texture_create_shared_from_slice(RD::TextureView(), rb->ssao.ao_deinterleaved, i, 0);
-				rb->ssao.ao_deinterleaved_slices.push_back(slice);
-				RD::get_singleton()->set_resource_name(rb->ssao.ao_deinterleaved_slices[i], "SSAO De-interleaved Array Layer " + itos(i) + " ");
-			}
-		}
+	RenderGraphRD::ResourceID depth;
+	RenderGraphRD::ResourceID ao_deinterleaved;
+	RenderGraphRD::ResourceID ao_pong;
+	RenderGraphRD::ResourceID importance_map[2];
+	{
+		RD::TextureFormat tf;
+		tf.format = RD::DATA_FORMAT_R16_SFLOAT;
+		tf.texture_type = RD::TEXTURE_TYPE_2D_ARRAY;
+		tf.width = buffer_width;
+		tf.height = buffer_height;
+		tf.mipmaps = 4;
+		tf.array_layers = 4;
+		tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_STORAGE_BIT;
+		depth = graph->create_texture(tf, "SSAO Depth");
 
-		{
-			RD::TextureFormat tf;
-			tf.format = RD::DATA_FORMAT_R8G8_UNORM;
-			tf.texture_type = RD::TEXTURE_TYPE_2D_ARRAY;
-			tf.width = buffer_width;
-			tf.height = buffer_height;
-			tf.array_layers = 4;
-			tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_STORAGE_BIT;
-			rb->ssao.ao_pong = RD::get_singleton()->texture_create(tf, RD::TextureView());
-			RD::get_singleton()->set_resource_name(rb->ssao.ao_pong, "SSAO De-interleaved Array Pong");
-			for (uint32_t i = 0; i < 4; i++) {
-				RID slice = RD::get_singleton()->texture_create_shared_from_slice(RD::TextureView(), rb->ssao.ao_pong, i, 0);
-				rb->ssao.ao_pong_slices.push_back(slice);
-				RD::get_singleton()->set_resource_name(rb->ssao.ao_deinterleaved_slices[i], "SSAO De-interleaved Array Layer " + itos(i) + " Pong");
-			}
-		}
+		tf.format = RD::DATA_FORMAT_R8G8_UNORM;
+		tf.mipmaps = 1;
+		ao_deinterleaved = graph->create_texture(tf, "SSAO De-interleaved Array");
+		ao_pong = graph->create_texture(tf, "SSAO De-interleaved Array Pong");
+	}
+	{
+		RD::TextureFormat tf;
+		tf.format = RD::DATA_FORMAT_R8_UNORM;
+		tf.width = half_width;
+		tf.height = half_height;
+		tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_STORAGE_BIT;
+		importance_map[0] = graph->create_texture(tf, "SSAO Importance Map");
+		importance_map[1] = graph->create_texture(tf, "SSAO Importance Map Pong");
+	}
 
-		{
-			RD::TextureFormat tf;
-			tf.format = RD::DATA_FORMAT_R8_UNORM;
-			tf.width = half_width;
-			tf.height = half_height;
-			tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_STORAGE_BIT;
-			rb->ssao.importance_map[0] = RD::get_singleton()->texture_create(tf, RD::TextureView());
-			RD::get_singleton()->set_resource_name(rb->ssao.importance_map[0], "SSAO Importance Map");
-			rb->ssao.importance_map[1] = RD::get_singleton()->texture_create(tf, RD::TextureView());
-			RD::get_singleton()->set_resource_name(rb->ssao.importance_map[1], "SSAO Importance Map Pong");
-		}
-		{
-			RD::TextureFormat tf;
-			tf.format = RD::DATA_FORMAT_R8_UNORM;
-			tf.width = rb->width;
-			tf.height = rb->height;
-			tf.usage_bits = RD::TEXTURE_USAGE_SAMPLING_BIT | RD::TEXTURE_USAGE_STORAGE_BIT;
-			rb->ssao.ao_final = RD::get_singleton()->texture_create(tf, RD::TextureView());
-			RD::get_singleton()->set_resource_name(rb->ssao.ao_final, "SSAO Final");
+	// The full barrier before the opaque pass covers everything SSAO reads and writes.
+	RenderGraphRD::ResourceID depth_buffer = graph->import_texture(rb->depth_texture, 0);
+	RenderGraphRD::ResourceID normal_buffer = graph->import_texture(p_normal_buffer, 0);
+	RenderGraphRD::ResourceID ao_final = graph->import_texture(rb->ssao.ao_final, 0);
+
+	RenderGraphRD::PassID ssao_pass = graph->add_pass("SSAO", RenderGraphRD::STAGE_COMPUTE);
+	graph->pass_read(ssao_pass, depth_buffer);
+	graph->pass_read(ssao_pass, normal_buffer);
+	graph->pass_write(ssao_pass, depth);
+	graph->pass_write(ssao_pass, ao_deinterleaved);
+	graph->pass_write(ssao_pass, ao_pong);
+	graph->pass_write(ssao_pass, importance_map[0]);
+	graph->pass_write(ssao_pass, importance_map[1]);
+	graph->pass_write(ssao_pass, ao_final);
+
+	graph->compile();
+
+	Vector<RID> depth_slices;
+	for (uint32_t i = 0; i < 4; i++) {
+		depth_slices.push_back(graph->get_texture_slice(depth, 0, i, RD::TEXTURE_SLICE_2D_ARRAY));
+	}
+	Vector<RID> ao_deinterleaved_slices;
+	Vector<RID> ao_pong_slices;
+	for (uint32_t i = 0; i < 4; i++) {
+		ao_deinterleaved_slices.push_back(graph->get_texture_slice(ao_deinterleaved, i, 0));
+		ao_pong_slices.push_back(graph->get_texture_slice(ao_pong, i, 0));
+	}
+
+	// The uniform sets of the effect are only rebuilt when the pool hands out different textures.
+	RID ssao_textures[SSAO_UNIFORM_SET_TEXTURES] = { graph->get_texture(depth), graph->get_texture(ao_pong), graph->get_texture(importance_map[0]), p_normal_buffer };
+	bool uniform_sets_are_invalid = false;
+	for (int i = 0; i < SSAO_UNIFORM_SET_TEXTURES; i++) {
+		if (ssao_uniform_set_textures[i] != ssao_textures[i]) {
+			ssao_uniform_set_textures[i] = ssao_textures[i];
+			uniform_sets_are_invalid = true;
 		}
-		ssao_using_half_size = ssao_half_size;
-		uniform_sets_are_invalid = true;
 	}
 
 	EffectsRD::SSAOSettings settings;
@@ -1728,7 +1716,8 @@ void RendererSceneRenderRD::_process_ssao(RID p_render_buffers, RID p_environmen
 	settings.half_screen_size = Size2i(buffer_width, buffer_height);
 	settings.quarter_screen_size = Size2i(half_width, half_height);
 
-	storage->get_effects()->generate_ssao(rb->depth_texture, p_normal_buffer, rb->ssao.depth, rb->ssao.depth_slices, rb->ssao.ao_deinterleaved, rb->ssao.ao_deinterleaved_slices, rb->ssao.ao_pong, rb->ssao.ao_pong_slices, rb->ssao.ao_final, rb->ssao.importance_map[0], rb->ssao.importance_map[1], p_projection, settings, uniform_sets_are_invalid);
+	storage->get_effects()->generate_ssao(rb->depth_texture, p_normal_buffer, graph->get_texture(depth), depth_slices, graph->get_texture(ao_deinterleaved), ao_deinterleaved_slices, graph->get_texture(ao_pong), ao_pong_slices, rb->ssao.ao_final, graph->get_texture(importance_map[0]), graph->get_texture(importance_map[1]), p_projection, settings, uniform_sets_are_invalid, graph->get_pass_barrier(ssao_pass));
+	graph->end();
 }
 
 void RendererSceneRenderRD::_render_buffers_post_process_and_tonemap(const RenderDataRD *p_render_data) {
@@ -3530,10 +3519,36 @@ void RendererSceneRenderRD::_pre_opaque_render(RenderDataRD *p_render_data, bool
 			_render_shadow_pass(render_state.render_shadows[render_state.cube_shadows[i]].light, p_render_data->shadow_atlas, render_state.render_shadows[render_state.cube_shadows[i]].pass, render_state.render_shadows[render_state.cube_shadows[i]].instances, camera_plane, lod_distance_multiplier, p_render_data->screen_lod_threshold, true, true, true);
 		}
 
+		//static layers are redrawn if needed and copied to the atlases, dynamic casters are then drawn on top
+		render_state.directional_static = false;
+		render_state.positional_static = false;
+
 		if (render_state.directional_shadows.size()) {
-			//open the pass for directional shadows
 			_update_directional_shadow_atlas();
-			RD::get_singleton()->draw_list_begin(directional_shadow.fb, RD::INITIAL_ACTION_DROP, RD::FINAL_ACTION_DISCARD, RD::INITIAL_ACTION_CLEAR, RD::FINAL_ACTION_CONTINUE);
+			for (uint32_t i = 0; i < render_state.directional_shadows.size(); i++) {
+				const RenderShadowData &shadow = render_state.render_shadows[render_state.directional_shadows[i]];
+				if (shadow.static_version) {
+					_render_shadow_pass(shadow.light, p_render_data->shadow_atlas, shadow.pass, shadow.static_instances, camera_plane, lod_distance_multiplier, p_render_data->screen_lod_threshold, true, true, true, shadow.static_version);
+					render_state.directional_static = true;
+				}
+			}
+
+			//open the pass for directional shadows, keeping the static layers if any was copied
+			RD::get_singleton()->draw_list_begin(directional_shadow.fb, RD::INITIAL_ACTION_DROP, RD::FINAL_ACTION_DISCARD, render_state.directional_static ? RD::INITIAL_ACTION_KEEP : RD::INITIAL_ACTION_CLEAR, RD::FINAL_ACTION_CONTINUE);
+			RD::get_singleton()->draw_list_end();
+		}
+
+		for (uint32_t i = 0; i < render_state.shadows.size(); i++) {
+			const RenderShadowData &shadow = render_state.render_shadows[render_state.shadows[i]];
+			if (shadow.static_version) {
+				_render_shadow_pass(shadow.light, p_render_data->shadow_atlas, shadow.pass, shadow.static_instances, camera_plane, lod_distance_multiplier, p_render_data->screen_lod_threshold, true, true, true, shadow.static_version);
+				render_state.positional_static = true;
+			}
+		}
+
+		if (render_state.positional_static) {
+			ShadowAtlas *shadow_atlas = shadow_atlas_owner.getornull(p_render_data->shadow_atlas);
+			RD::get_singleton()->draw_list_begin(shadow_atlas->fb, RD::INITIAL_ACTION_DROP, RD::FINAL_ACTION_DISCARD, RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_CONTINUE);
 			RD::get_singleton()->draw_list_end();
 		}
 	}
@@ -3555,13 +3570,15 @@ void RendererSceneRenderRD::_pre_opaque_render(RenderDataRD *p_render_data, bool
 	if (render_shadows) {
 		_render_shadow_begin();
 
-		//render directional shadows
+		//render directional shadows, the atlas was not cleared when static layers were copied to it
 		for (uint32_t i = 0; i < render_state.directional_shadows.size(); i++) {
-			_render_shadow_pass(render_state.render_shadows[render_state.directional_shadows[i]].light, p_render_data->shadow_atlas, render_state.render_shadows[render_state.directional_shadows[i]].pass, render_state.render_shadows[render_state.directional_shadows[i]].instances, camera_plane, lod_distance_multiplier, p_render_data->screen_lod_threshold, false, i == render_state.directional_shadows.size() - 1, false);
+			const RenderShadowData &shadow = render_state.render_shadows[render_state.directional_shadows[i]];
+			_render_shadow_pass(shadow.light, p_render_data->shadow_atlas, shadow.pass, shadow.instances, camera_plane, lod_distance_multiplier, p_render_data->screen_lod_threshold, false, i == render_state.directional_shadows.size() - 1, render_state.directional_static && !shadow.static_version);
 		}
-		//render positional shadows
+		//render positional shadows, passes over a static layer must not clear it
 		for (uint32_t i = 0; i < render_state.shadows.size(); i++) {
-			_render_shadow_pass(render_state.render_shadows[render_state.shadows[i]].light, p_render_data->shadow_atlas, render_state.render_shadows[render_state.shadows[i]].pass, render_state.render_shadows[render_state.shadows[i]].instances, camera_plane, lod_distance_multiplier, p_render_data->screen_lod_threshold, i == 0, i == render_state.shadows.size() - 1, true);
+			const RenderShadowData &shadow = render_state.render_shadows[render_state.shadows[i]];
+			_render_shadow_pass(shadow.light, p_render_data->shadow_atlas, shadow.pass, shadow.instances, camera_plane, lod_distance_multiplier, p_render_data->screen_lod_threshold, i == 0 && !render_state.positional_static, i == render_state.shadows.size() - 1, !shadow.static_version);
 		}
 
 		_render_shadow_process();
@@ -3787,7 +3804,7 @@ void RendererSceneRenderRD::render_scene(RID p_render_buffers, const Transform &
 	}
 }
 
-void RendererSceneRenderRD::_render_shadow_pass(RID p_light, RID p_shadow_atlas, int p_pass, const PagedArray<GeometryInstance *> &p_instances, const Plane &p_camera_plane, float p_lod_distance_multiplier, float p_screen_lod_threshold, bool p_open_pass, bool p_close_pass, bool p_clear_region) {
+void RendererSceneRenderRD::_render_shadow_pass(RID p_light, RID p_shadow_atlas, int p_pass, const PagedArray<GeometryInstance *> &p_instances, const Plane &p_camera_plane, float p_lod_distance_multiplier, float p_screen_lod_threshold, bool p_open_pass, bool p_close_pass, bool p_clear_region, uint64_t p_static_version) {
 	LightInstance *light_instance = light_instance_owner.getornull(p_light);
 	ERR_FAIL_COND(!light_instance);
 
@@ -3810,6 +3827,11 @@ void RendererSceneRenderRD::_render_shadow_pass(RID p_light, RID p_shadow_atlas,
 	CameraMatrix light_projection;
 	Transform light_transform;
 
+	RID static_fb;
+	RID static_texture;
+	RID static_dest_texture;
+	bool static_valid = false;
+
 	if (storage->light_get_type(light_instance->light) == RS::LIGHT_DIRECTIONAL) {
 		//set pssm stuff
 		if (light_instance->last_scene_shadow_pass != scene_pass) {
@@ -3859,6 +3881,32 @@ void RendererSceneRenderRD::_render_shadow_pass(RID p_light, RID p_shadow_atlas,
 		render_texture = RID();
 		flip_y = true;
 
+		if (p_static_version) {
+			if (directional_shadow.static_depth.is_null()) {
+				RD::TextureFormat tf;
+				tf.format = directional_shadow.use_16_bits ? RD::DATA_FORMAT_D16_UNORM : RD::DATA_FORMAT_D32_SFLOAT;
+				tf.width = directional_shadow.size;
+				tf.height = directional_shadow.size;
+				tf.usage_bits = RD::TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | RD::TEXTURE_USAGE_CAN_COPY_FROM_BIT;
+
+				directional_shadow.static_depth = RD::get_singleton()->texture_create(tf, RD::TextureView());
+				Vector<RID> fb_tex;
+				fb_tex.push_back(directional_shadow.static_depth);
+				directional_shadow.static_fb = RD::get_singleton()->framebuffer_create(fb_tex);
+				directional_shadow.static_generation++;
+			}
+
+			LightInstance::DirectionalStatic &ds = light_instance->directional_static[p_pass];
+			static_valid = ds.version == p_static_version && ds.generation == directional_shadow.static_generation && ds.rect == atlas_rect;
+			ds.version = p_static_version;
+			ds.generation = directional_shadow.static_generation;
+			ds.rect = atlas_rect;
+
+			static_fb = directional_shadow.static_fb;
+			static_texture = directional_shadow.static_depth;
+			static_dest_texture = directional_shadow.depth;
+		}
+
 	} else {
 		//set from shadow atlas
 
@@ -3929,6 +3977,47 @@ void RendererSceneRenderRD::_render_shadow_pass(RID p_light, RID p_shadow_atlas,
 
 			flip_y = true;
 		}
+
+		if (p_static_version && !render_cubemap) {
+			if (shadow_atlas->static_depth.is_null()) {
+				RD::TextureFormat tf;
+				tf.format = shadow_atlas->use_16_bits ? RD::DATA_FORMAT_D16_UNORM : RD::DATA_FORMAT_D32_SFLOAT;
+				tf.width = shadow_atlas->size;
+				tf.height = shadow_atlas->size;
+				tf.usage_bits = RD::TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | RD::TEXTURE_USAGE_CAN_COPY_FROM_BIT;
+
+				shadow_atlas->static_depth = RD::get_singleton()->texture_create(tf, RD::TextureView());
+				Vector<RID> fb_tex;
+				fb_tex.push_back(shadow_atlas->static_depth);
+				shadow_atlas->static_fb = RD::get_singleton()->framebuffer_create(fb_tex);
+			}
+
+			ShadowAtlas::Quadrant::Shadow &atlas_shadow = shadow_atlas->quadrants[quadrant].shadows.write[shadow];
+			if (atlas_shadow.static_owner != p_light) {
+				atlas_shadow.static_owner = p_light;
+				atlas_shadow.static_version[0] = 0;
+				atlas_shadow.static_version[1] = 0;
+			}
+			static_valid = atlas_shadow.static_version[p_pass] == p_static_version;
+			atlas_shadow.static_version[p_pass] = p_static_version;
+
+			static_fb = shadow_atlas->static_fb;
+			static_texture = shadow_atlas->static_depth;
+			static_dest_texture = shadow_atlas->depth;
+		}
+	}
+
+	if (static_fb.is_valid()) {
+		//static layer, only redrawn when its casters changed, then copied to the atlas region
+		if (!static_valid) {
+			_render_shadow_begin();
+			_render_shadow_append(static_fb, p_instances, light_projection, light_transform, zfar, 0, 0, using_dual_paraboloid, using_dual_paraboloid_flip, use_pancake, p_camera_plane, p_lod_distance_multiplier, p_screen_lod_threshold, atlas_rect, flip_y, true, true, true);
+			_render_shadow_process();
+			_render_shadow_end();
+		}
+		Vector3 region_pos(atlas_rect.position.x, atlas_rect.position.y, 0);
+		RD::get_singleton()->texture_copy(static_texture, static_dest_texture, region_pos, region_pos, Vector3(atlas_rect.size.width, atlas_rect.size.height, 1), 0, 0, 0, 0);
+		return;
 	}
 
 	if (render_cubemap) {
@@ -233,6 +233,9 @@ private:
 				uint64_t fog_version; // used for fog
 				uint64_t alloc_tick;
 
+				RID static_owner; // owner of the static layer stored at the same place in static_depth
+				uint64_t static_version[2] = {};
+
 				Shadow() {
 					version = 0;
 					fog_version = 0;
@@ -257,6 +260,10 @@ private:
 		RID depth;
 		RID fb; //for copying
 
+		// Same layout as depth, holds the static casters, copied to depth before dynamic casters are drawn.
+		RID static_depth;
+		RID static_fb;
+
 		Map<RID, uint32_t> shadow_owners;
 	};
 
@@ -286,6 +293,10 @@ private:
 		RID depth;
 		RID fb; //when renderign direct
 
+		RID static_depth;
+		RID static_fb;
+		uint32_t static_generation = 0; // increased when static_depth is created, invalidates the cached layers
+
 		int light_count = 0;
 		int size = 0;
 		bool use_16_bits = false;
@@ -351,6 +362,12 @@ private:
 
 		Set<RID> shadow_atlases; //shadow atlases where this light is registered
 
+		struct DirectionalStatic {
+			uint64_t version = 0;
+			uint32_t generation = 0;
+			Rect2i rect;
+		} directional_static[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES];
+
 		LightInstance() {}
 	};
 
@@ -360,7 +377,6 @@ private:
 
 	RS::EnvironmentSSAOQuality ssao_quality = RS::ENV_SSAO_QUALITY_MEDIUM;
 	bool ssao_half_size = false;
-	bool ssao_using_half_size = false;
 	float ssao_adaptive_target = 0.5;
 	int ssao_blur_passes = 2;
 	float ssao_fadeout_from = 50.0;
@@ -446,22 +462,9 @@ private:
 		} luminance;
 
 		struct SSAO {
-			RID depth;
-			Vector<RID> depth_slices;
-			RID ao_deinterleaved;
-			Vector<RID> ao_deinterleaved_slices;
-			RID ao_pong;
-			Vector<RID> ao_pong_slices;
 			RID ao_final;
-			RID importance_map[2];
 		} ssao;
 
-		struct SSR {
-			RID normal_scaled;
-			RID depth_scaled;
-			RID blur_radius[2];
-		} ssr;
-
 		RID ambient_buffer;
 		RID reflection_buffer;
 	};
@@ -473,6 +476,12 @@ private:
 
 	mutable RID_Owner<RenderBuffers> render_buffers_owner;
 
+	enum {
+		SSAO_UNIFORM_SET_TEXTURES = 4
+	};
+
+	RID ssao_uniform_set_textures[SSAO_UNIFORM_SET_TEXTURES]; // Transient SSAO textures are pooled, the effect caches uniform sets using them.
+
 	void _free_render_buffer_data(RenderBuffers *rb);
 	void _allocate_blur_textures(RenderBuffers *rb);
 	void _allocate_luminance_textures(RenderBuffers *rb);
@@ -636,6 +645,8 @@ private:
 		LocalVector<int> cube_shadows;
 		LocalVector<int> shadows;
 		LocalVector<int> directional_shadows;
+		bool directional_static = false; // static layers were copied, the atlases are not cleared
+		bool positional_static = false;
 
 		bool depth_prepass_used; // this does not seem used anywhere...
 	} render_state;
@@ -737,7 +748,7 @@ private:
 
 	uint32_t max_cluster_elements = 512;
 
-	void _render_shadow_pass(RID p_light, RID p_shadow_atlas, int p_pass, const PagedArray<GeometryInstance *> &p_instances, const Plane &p_camera_plane = Plane(), float p_lod_distance_multiplier = 0, float p_screen_lod_threshold = 0.0, bool p_open_pass = true, bool p_close_pass = true, bool p_clear_region = true);
+	void _render_shadow_pass(RID p_light, RID p_shadow_atlas, int p_pass, const PagedArray<GeometryInstance *> &p_instances, const Plane &p_camera_plane = Plane(), float p_lod_distance_multiplier = 0, float p_screen_lod_threshold = 0.0, bool p_open_pass = true, bool p_close_pass = true, bool p_clear_region = true, uint64_t p_static_version = 0);
 
 public:
 	virtual Transform geometry_instance_get_transform(GeometryInstance *p_instance) = 0;
@@ -785,6 +796,7 @@ public:
 	virtual int sdfgi_get_pending_region_count(RID p_render_buffers) const;
 	virtual AABB sdfgi_get_pending_region_bounds(RID p_render_buffers, int p_region) const;
 	virtual uint32_t sdfgi_get_pending_region_cascade(RID p_render_buffers, int p_region) const;
+	virtual void sdfgi_mark_static_dirty(RID p_render_buffers, const AABB &p_aabb);
 	RID sdfgi_get_ubo() const { return gi.sdfgi_ubo; }
 
 	/* SKY API */
@@ -1132,10 +1132,23 @@ void RendererStorageRD::texture_replace(RID p_texture, RID p_by_texture) {
 	Vector<RID> proxies_to_update = tex->proxies;
 	Vector<RID> proxies_to_redirect = by_tex->proxies;
 
+	//streaming state belongs to the RID, not to the data replacing it
+	RS::TextureStreamCallback stream_callback = tex->stream_callback;
+	ObjectID stream_callback_owner = tex->stream_callback_owner;
+	Size2i stream_full_size = tex->stream_full_size;
+	uint32_t stream_size = tex->stream_size;
+	uint64_t stream_last_used_frame = tex->stream_last_used_frame;
+
 	*tex = *by_tex;
 
 	tex->proxies = proxies_to_update; //restore proxies, so they can be updated
 
+	tex->stream_callback = stream_callback;
+	tex->stream_callback_owner = stream_callback_owner;
+	tex->stream_full_size = stream_full_size;
+	tex->stream_size = stream_size;
+	tex->stream_last_used_frame = stream_last_used_frame;
+
 	if (tex->canvas_texture) {
 		tex->canvas_texture->diffuse = p_texture; //update
 	}
@@ -1195,6 +1208,30 @@ void RendererStorageRD::texture_set_detect_roughness_callback(RID p_texture, RS:
 	tex->detect_roughness_callback = p_callback;
 }
 
+void RendererStorageRD::texture_set_stream_callback(RID p_texture, const Size2i &p_full_size, RS::TextureStreamCallback p_callback, ObjectID p_owner) {
+	Texture *tex = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND(!tex);
+	ERR_FAIL_COND(tex->type != Texture::TYPE_2D);
+
+	if (!texture_streaming.enabled) {
+		return;
+	}
+
+	if (p_callback) {
+		if (!tex->stream_callback) {
+			texture_streaming.textures.push_back(p_texture);
+		}
+		tex->stream_size = MAX(tex->width, tex->height);
+		tex->stream_last_used_frame = texture_streaming.frame;
+	} else if (tex->stream_callback) {
+		texture_streaming.textures.erase(p_texture);
+	}
+
+	tex->stream_callback = p_callback;
+	tex->stream_callback_owner = p_owner;
+	tex->stream_full_size = p_full_size;
+}
+
 void RendererStorageRD::texture_debug_usage(List<RS::TextureInfo> *r_info) {
 }
 
@@ -1694,6 +1731,28 @@ void RendererStorageRD::material_update_dependency(RID p_material, DependencyTra
 	}
 }
 
+void RendererStorageRD::material_request_texture_stream_size(RID p_material, float p_pixel_size) {
+	Material *material = material_owner.getornull(p_material);
+	if (!material) {
+		return;
+	}
+
+	if (material->stream_request_frame != texture_streaming.frame) {
+		material->stream_request_frame = texture_streaming.frame;
+		material->stream_pixel_size = 0.0;
+		texture_streaming.requested_materials.push_back(p_material);
+	}
+
+	if (p_pixel_size <= material->stream_pixel_size) {
+		return; //also stops next pass cycles
+	}
+	material->stream_pixel_size = p_pixel_size;
+
+	if (material->next_pass.is_valid()) {
+		material_request_texture_stream_size(material->next_pass, p_pixel_size);
+	}
+}
+
 void RendererStorageRD::material_set_data_request_function(ShaderType p_shader_type, MaterialDataRequestFunction p_function) {
 	ERR_FAIL_INDEX(p_shader_type, SHADER_TYPE_MAX);
 	material_data_request_func[p_shader_type] = p_function;
@@ -2547,6 +2606,7 @@ void RendererStorageRD::mesh_add_surface(RID p_mesh, const RS::SurfaceData &p_su
 				uint32_t indices = p_surface.lods[i].index_data.size() / (is_index_16 ? 2 : 4);
 				s->lods[i].index_buffer = RD::get_singleton()->index_buffer_create(indices, is_index_16 ? RD::INDEX_BUFFER_FORMAT_UINT16 : RD::INDEX_BUFFER_FORMAT_UINT32, p_surface.lods[i].index_data);
 				s->lods[i].index_array = RD::get_singleton()->index_array_create(s->lods[i].index_buffer, 0, indices);
+				s->lods[i].index_count = indices;
 				s->lods[i].edge_length = p_surface.lods[i].edge_length;
 			}
 		}
@@ -3354,8 +3414,14 @@ void RendererStorageRD::multimesh_allocate_data(RID p_multimesh, int p_instances
 	multimesh->aabb_dirty = false;
 	multimesh->visible_instances = MIN(multimesh->visible_instances, multimesh->instances);
 
+	multimesh->chunks.clear();
+
 	if (multimesh->instances) {
 		multimesh->buffer = RD::get_singleton()->storage_buffer_create(multimesh->instances * multimesh->stride_cache * 4);
+
+		if (_multimesh_uses_chunks(multimesh)) {
+			_multimesh_make_local(multimesh); //chunks are compacted from the CPU copy
+		}
 	}
 
 	multimesh->dependency.changed_notify(DEPENDENCY_CHANGED_MULTIMESH);
@@ -3727,11 +3793,12 @@ void RendererStorageRD::multimesh_set_buffer(RID p_multimesh, const Vector<float
 	ERR_FAIL_COND(!multimesh);
 	ERR_FAIL_COND(p_buffer.size() != (multimesh->instances * (int)multimesh->stride_cache));
 
-	{
+	if (!_multimesh_uses_chunks(multimesh)) {
+		//chunked multimeshes upload the visible chunks when updated
 		const float *r = p_buffer.ptr();
 		RD::get_singleton()->buffer_update(multimesh->buffer, 0, p_buffer.size() * sizeof(float), r);
-		multimesh->buffer_set = true;
 	}
+	multimesh->buffer_set = true;
 
 	if (multimesh->data_cache.size()) {
 		//if we have a data cache, just update it
@@ -3802,6 +3869,59 @@ int RendererStorageRD::multimesh_get_visible_instances(RID p_multimesh) const {
 	return multimesh->visible_instances;
 }
 
+void RendererStorageRD::multimesh_set_chunk_size(RID p_multimesh, int p_size) {
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND(!multimesh);
+	ERR_FAIL_COND(p_size < 0);
+	if (multimesh->chunks.size == uint32_t(p_size)) {
+		return;
+	}
+
+	multimesh->chunks.size = p_size;
+	multimesh->chunks.clear();
+
+	if (multimesh->instances) {
+		_multimesh_make_local(multimesh);
+		//re-upload everything, either compacted in chunks or back in index order
+		_multimesh_mark_all_dirty(multimesh, true, multimesh->mesh.is_valid());
+	}
+
+	multimesh->dependency.changed_notify(DEPENDENCY_CHANGED_MULTIMESH_VISIBLE_INSTANCES);
+}
+
+int RendererStorageRD::multimesh_get_chunk_size(RID p_multimesh) const {
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND_V(!multimesh, 0);
+	return multimesh->chunks.size;
+}
+
+const AABB *RendererStorageRD::multimesh_get_chunk_aabbs(RID p_multimesh, uint32_t &r_chunk_count) const {
+	r_chunk_count = 0;
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND_V(!multimesh, nullptr);
+	if (!_multimesh_uses_chunks(multimesh)) {
+		return nullptr;
+	}
+	if (multimesh->dirty) {
+		const_cast<RendererStorageRD *>(this)->_update_dirty_multimeshes();
+	}
+	r_chunk_count = multimesh->chunks.aabbs.size();
+	return multimesh->chunks.aabbs.ptr();
+}
+
+void RendererStorageRD::multimesh_set_visible_chunks(RID p_multimesh, const uint8_t *p_visible) {
+	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+	ERR_FAIL_COND(!multimesh);
+	if (!_multimesh_uses_chunks(multimesh) || multimesh->chunks.visible.is_empty()) {
+		return;
+	}
+
+	if (!multimesh->chunks.set_visible(p_visible)) {
+		return; //same chunks as last time, buffer is up to date
+	}
+	_multimesh_compact_chunks(multimesh);
+}
+
 AABB RendererStorageRD::multimesh_get_aabb(RID p_multimesh) const {
 	MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
 	ERR_FAIL_COND_V(!multimesh, AABB());
@@ -3811,6 +3931,29 @@ AABB RendererStorageRD::multimesh_get_aabb(RID p_multimesh) const {
 	return multimesh->aabb;
 }
 
+void RendererStorageRD::_multimesh_update_chunks(MultiMesh *multimesh, const float *p_data, int p_instances) {
+	AABB mesh_aabb;
+	if (multimesh->mesh.is_valid()) {
+		mesh_aabb = mesh_get_aabb(multimesh->mesh);
+	} else {
+		p_instances = 0; //nothing is drawn without a mesh
+	}
+	multimesh->chunks.update(p_data, multimesh->stride_cache, p_instances, multimesh->aabb, mesh_aabb);
+}
+
+void RendererStorageRD::_multimesh_compact_chunks(MultiMesh *multimesh) {
+	uint32_t visible_instances = multimesh->chunks.visible_instances;
+	multimesh->chunks.pack(multimesh->data_cache.ptr(), multimesh->stride_cache);
+
+	if (multimesh->chunks.visible_instances) {
+		RD::get_singleton()->buffer_update(multimesh->buffer, 0, multimesh->chunks.visible_instances * multimesh->stride_cache * sizeof(float), multimesh->chunks.data.ptr());
+	}
+
+	if (multimesh->chunks.visible_instances != visible_instances) {
+		multimesh->dependency.changed_notify(DEPENDENCY_CHANGED_MULTIMESH_VISIBLE_INSTANCES);
+	}
+}
+
 void RendererStorageRD::_update_dirty_multimeshes() {
 	while (multimesh_dirty_list) {
 		MultiMesh *multimesh = multimesh_dirty_list;
@@ -3820,6 +3963,19 @@ void RendererStorageRD::_update_dirty_multimeshes() {
 
 			uint32_t visible_instances = multimesh->visible_instances >= 0 ? multimesh->visible_instances : multimesh->instances;
 
+			bool uses_chunks = _multimesh_uses_chunks(multimesh);
+			bool chunks_changed = uses_chunks && (multimesh->data_cache_used_dirty_regions || multimesh->aabb_dirty);
+			bool chunks_moved = uses_chunks && multimesh->aabb_dirty;
+
+			if (uses_chunks && multimesh->data_cache_used_dirty_regions) {
+				//the buffer only holds the visible chunks, they are compacted again below
+				uint32_t data_cache_dirty_region_count = (multimesh->instances - 1) / MULTIMESH_DIRTY_REGION_SIZE + 1;
+				for (uint32_t i = 0; i < data_cache_dirty_region_count; i++) {
+					multimesh->data_cache_dirty_regions[i] = false;
+				}
+				multimesh->data_cache_used_dirty_regions = 0;
+			}
+
 			if (multimesh->data_cache_used_dirty_regions) {
 				uint32_t data_cache_dirty_region_count = (multimesh->instances - 1) / MULTIMESH_DIRTY_REGION_SIZE + 1;
 				uint32_t visible_region_count = (visible_instances - 1) / MULTIMESH_DIRTY_REGION_SIZE + 1;
@@ -3853,6 +4009,13 @@ void RendererStorageRD::_update_dirty_multimeshes() {
 				multimesh->aabb_dirty = false;
 				multimesh->dependency.changed_notify(DEPENDENCY_CHANGED_AABB);
 			}
+
+			if (chunks_moved) {
+				_multimesh_update_chunks(multimesh, data, visible_instances);
+			}
+			if (chunks_changed) {
+				_multimesh_compact_chunks(multimesh);
+			}
 		}
 
 		multimesh_dirty_list = multimesh->dirty_list;
@@ -5557,6 +5720,18 @@ void RendererStorageRD::skeleton_bone_set_transform(RID p_skeleton, int p_bone,
 	_skeleton_make_dirty(skeleton);
 }
 
+void RendererStorageRD::skeleton_set_bone_transforms(RID p_skeleton, const PackedFloat32Array &p_transforms) {
+	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
+
+	ERR_FAIL_COND(!skeleton);
+	ERR_FAIL_COND(skeleton->use_2d);
+	ERR_FAIL_COND(p_transforms.size() != skeleton->size * 12);
+
+	memcpy(skeleton->data.ptrw(), p_transforms.ptr(), sizeof(float) * p_transforms.size());
+
+	_skeleton_make_dirty(skeleton);
+}
+
 Transform RendererStorageRD::skeleton_bone_get_transform(RID p_skeleton, int p_bone) const {
 	Skeleton *skeleton = skeleton_owner.getornull(p_skeleton);
 
@@ -8440,6 +8615,151 @@ void RendererStorageRD::update_dirty_resources() {
 	_update_dirty_multimeshes();
 	_update_dirty_skeletons();
 	_update_decal_atlas();
+	render_graph.update(RendererCompositorRD::singleton->get_frame_number());
+}
+
+uint32_t RendererStorageRD::_texture_stream_fit_size(const Texture *p_texture, uint32_t p_size_limit) const {
+	// Largest side of the biggest mipmap that fits in the limit, the same one StreamTexture2D loads.
+	uint32_t w = p_texture->stream_full_size.width;
+	uint32_t h = p_texture->stream_full_size.height;
+	while ((w > p_size_limit || h > p_size_limit) && (w > 1 || h > 1)) {
+		w = MAX(w >> 1, 1u);
+		h = MAX(h >> 1, 1u);
+	}
+	return MAX(w, h);
+}
+
+uint64_t RendererStorageRD::_texture_stream_get_memory(const Texture *p_texture, uint32_t p_size) const {
+	int w = p_texture->stream_full_size.width;
+	int h = p_texture->stream_full_size.height;
+	while (uint32_t(MAX(w, h)) > p_size && (w > 1 || h > 1)) {
+		w = MAX(w >> 1, 1);
+		h = MAX(h >> 1, 1);
+	}
+	return Image::get_image_data_size(w, h, p_texture->format, true);
+}
+
+void RendererStorageRD::update_texture_streaming() {
+	if (!texture_streaming.enabled) {
+		return;
+	}
+
+	// Turn the pixel sizes requested for materials this frame into texel sizes for the streamed textures they use.
+	static const StringName uv1_scale_name = "uv1_scale";
+
+	for (uint32_t i = 0; i < texture_streaming.requested_materials.size(); i++) {
+		Material *material = material_owner.getornull(texture_streaming.requested_materials[i]);
+		if (!material) {
+			continue;
+		}
+
+		// Tiled materials need more texels for the same screen area.
+		float uv_density = 1.0;
+		const Map<StringName, Variant>::Element *S = material->params.find(uv1_scale_name);
+		if (S && S->get().get_type() == Variant::VECTOR3) {
+			Vector3 uv_scale = S->get();
+			uv_density = MAX(1.0, MAX(Math::abs(uv_scale.x), Math::abs(uv_scale.y)));
+		}
+		uint32_t texel_size = uint32_t(MIN(material->stream_pixel_size * uv_density, 16384.0));
+
+		for (const Map<StringName, Variant>::Element *E = material->params.front(); E; E = E->next()) {
+			if (E->get().get_type() != Variant::RID && E->get().get_type() != Variant::OBJECT) {
+				continue;
+			}
+			Texture *tex = texture_owner.getornull(E->get());
+			if (tex && tex->stream_callback) {
+				tex->stream_requested_size = MAX(tex->stream_requested_size, texel_size);
+			}
+		}
+	}
+	texture_streaming.requested_materials.clear();
+
+	// Decide the size each texture wants, keeping the last one for a while when it goes out of view.
+	texture_streaming.wanted.resize(texture_streaming.textures.size());
+	uint64_t total_memory = 0;
+	uint32_t largest = 0;
+
+	for (uint32_t i = 0; i < texture_streaming.textures.size(); i++) {
+		Texture *tex = texture_owner.getornull(texture_streaming.textures[i]);
+		uint32_t wanted;
+		if (tex->stream_requested_size > 0) {
+			tex->stream_last_used_frame = texture_streaming.frame;
+			wanted = _texture_stream_fit_size(tex, next_power_of_2(tex->stream_requested_size));
+		} else if (texture_streaming.frame - tex->stream_last_used_frame < TextureStreaming::UNUSED_FRAMES_BEFORE_EVICTION) {
+			wanted = tex->stream_size;
+		} else {
+			wanted = 0;
+		}
+		tex->stream_requested_size = 0;
+
+		wanted = MAX(wanted, _texture_stream_fit_size(tex, texture_streaming.min_size));
+
+		texture_streaming.wanted[i].texture = tex;
+		texture_streaming.wanted[i].size = wanted;
+		total_memory += _texture_stream_get_memory(tex, wanted);
+		largest = MAX(largest, wanted);
+	}
+
+	// Over budget, drop a mipmap from the largest textures first.
+	uint32_t level = next_power_of_2(largest);
+	while (total_memory > texture_streaming.memory_budget && level > texture_streaming.min_size) {
+		level >>= 1;
+		for (uint32_t i = 0; i < texture_streaming.wanted.size() && total_memory > texture_streaming.memory_budget; i++) {
+			TextureStreaming::Wanted &w = texture_streaming.wanted[i];
+			uint32_t reduced = MAX(_texture_stream_fit_size(w.texture, level), _texture_stream_fit_size(w.texture, texture_streaming.min_size));
+			if (reduced < w.size) {
+				total_memory -= _texture_stream_get_memory(w.texture, w.size);
+				w.size = reduced;
+				total_memory += _texture_stream_get_memory(w.texture, w.size);
+			}
+		}
+	}
+
+	// Evictions free memory and always go through, loads are spread over frames.
+	uint32_t loads = 0;
+	uint64_t memory_used = 0;
+
+	for (uint32_t i = 0; i < texture_streaming.wanted.size(); i++) {
+		Texture *tex = texture_streaming.wanted[i].texture;
+		uint32_t wanted = texture_streaming.wanted[i].size;
+
+		if (wanted < tex->stream_size) {
+			tex->stream_size = wanted;
+			texture_streaming.evictions++;
+			tex->stream_callback(tex->stream_callback_owner, wanted);
+		} else if (wanted > tex->stream_size && loads < texture_streaming.max_loads_per_frame) {
+			tex->stream_size = wanted;
+			texture_streaming.loads++;
+			loads++;
+			tex->stream_callback(tex->stream_callback_owner, wanted);
+		}
+
+		memory_used += _texture_stream_get_memory(tex, tex->stream_size);
+	}
+
+	texture_streaming.memory_used = memory_used;
+	texture_streaming.frame++;
+}
+
+uint64_t RendererStorageRD::get_render_info(RS::RenderInfo p_info) {
+	switch (p_info) {
+		case RS::INFO_TEXTURE_STREAM_MEM_USED:
+			return texture_streaming.memory_used;
+		case RS::INFO_TEXTURE_STREAM_LOADS:
+			return texture_streaming.loads;
+		case RS::INFO_TEXTURE_STREAM_EVICTIONS:
+			return texture_streaming.evictions;
+		case RS::INFO_TRANSIENT_MEM_REQUESTED:
+			return render_graph.get_last_frame_stats().transient_memory_requested;
+		case RS::INFO_TRANSIENT_MEM_USED:
+			return render_graph.get_transient_memory_used();
+		case RS::INFO_BARRIERS_IN_FRAME:
+			return render_graph.get_last_frame_stats().barriers;
+		case RS::INFO_BARRIERS_ELIDED_IN_FRAME:
+			return render_graph.get_last_frame_stats().barriers_elided;
+		default:
+			return 0;
+	}
 }
 
 bool RendererStorageRD::has_os_feature(const String &p_feature) const {
@@ -8492,6 +8812,10 @@ bool RendererStorageRD::free(RID p_rid) {
 			//there is not much a point of making it dirty, just let it be.
 		}
 
+		if (t->stream_callback) {
+			texture_streaming.textures.erase(p_rid);
+		}
+
 		for (int i = 0; i < t->proxies.size(); i++) {
 			Texture *p = texture_owner.getornull(t->proxies[i]);
 			ERR_CONTINUE(!p);
@@ -8637,6 +8961,10 @@ EffectsRD *RendererStorageRD::get_effects() {
 	return &effects;
 }
 
+RenderGraphRD *RendererStorageRD::get_render_graph() {
+	return &render_graph;
+}
+
 void RendererStorageRD::capture_timestamps_begin() {
 	RD::get_singleton()->capture_timestamp("Frame Begin");
 }
@@ -9122,6 +9450,11 @@ RendererStorageRD::RendererStorageRD() {
 
 	lightmap_probe_capture_update_speed = GLOBAL_GET("rendering/lightmapping/probe_capture/update_speed");
 
+	texture_streaming.enabled = GLOBAL_GET("rendering/textures/streaming/enabled");
+	texture_streaming.memory_budget = uint64_t(int(GLOBAL_GET("rendering/textures/streaming/memory_budget_mb"))) * 1024 * 1024;
+	texture_streaming.min_size = MAX(int(GLOBAL_GET("rendering/textures/streaming/min_size")), 1);
+	texture_streaming.max_loads_per_frame = MAX(int(GLOBAL_GET("rendering/textures/streaming/max_loads_per_frame")), 1);
+
 	/* Particles */
 
 	{
@@ -36,6 +36,7 @@
 #include "core/templates/rid_owner.h"
 #include "servers/rendering/renderer_compositor.h"
 #include "servers/rendering/renderer_rd/effects_rd.h"
+#include "servers/rendering/renderer_rd/render_graph_rd.h"
 #include "servers/rendering/renderer_rd/shader_compiler_rd.h"
 #include "servers/rendering/renderer_rd/shaders/canvas_sdf.glsl.gen.h"
 #include "servers/rendering/renderer_rd/shaders/giprobe_sdf.glsl.gen.h"
@@ -281,6 +282,13 @@ private:
 		RS::TextureDetectRoughnessCallback detect_roughness_callback = nullptr;
 		void *detect_roughness_callback_ud = nullptr;
 
+		RS::TextureStreamCallback stream_callback = nullptr;
+		ObjectID stream_callback_owner;
+		Size2i stream_full_size;
+		uint32_t stream_size = 0; // Largest side of the mipmaps loaded, or last asked for.
+		uint32_t stream_requested_size = 0; // Texels needed by the geometry drawn this frame.
+		uint64_t stream_last_used_frame = 0;
+
 		CanvasTexture *canvas_texture = nullptr;
 	};
 
@@ -352,6 +360,33 @@ private:
 
 	} decal_atlas;
 
+	struct TextureStreaming {
+		enum {
+			UNUSED_FRAMES_BEFORE_EVICTION = 120
+		};
+
+		bool enabled = false;
+		uint64_t memory_budget = 0;
+		uint32_t min_size = 64;
+		uint32_t max_loads_per_frame = 4;
+
+		LocalVector<RID> textures;
+		LocalVector<RID> requested_materials;
+		struct Wanted {
+			Texture *texture = nullptr;
+			uint32_t size = 0;
+		};
+		LocalVector<Wanted> wanted;
+		uint64_t frame = 1;
+
+		uint64_t memory_used = 0;
+		uint64_t loads = 0;
+		uint64_t evictions = 0;
+	} texture_streaming;
+
+	uint32_t _texture_stream_fit_size(const Texture *p_texture, uint32_t p_size_limit) const;
+	uint64_t _texture_stream_get_memory(const Texture *p_texture, uint32_t p_size) const;
+
 	void _update_decal_atlas();
 
 	/* SHADER */
@@ -386,6 +421,8 @@ private:
 		int32_t priority;
 		RID next_pass;
 		Dependency dependency;
+		uint64_t stream_request_frame = 0;
+		float stream_pixel_size = 0.0;
 	};
 
 	MaterialDataRequestFunction material_data_request_func[SHADER_TYPE_MAX];
@@ -434,6 +471,7 @@ private:
 
 			struct LOD {
 				float edge_length = 0.0;
+				uint32_t index_count = 0;
 				RID index_buffer;
 				RID index_array;
 			};
@@ -582,6 +620,8 @@ private:
 		RID uniform_set_3d;
 		RID uniform_set_2d;
 
+		MultiMeshChunks chunks; // When chunked, only the visible chunks are compacted into the buffer.
+
 		bool dirty = false;
 		MultiMesh *dirty_list = nullptr;
 
@@ -596,6 +636,11 @@ private:
 	_FORCE_INLINE_ void _multimesh_mark_dirty(MultiMesh *multimesh, int p_index, bool p_aabb);
 	_FORCE_INLINE_ void _multimesh_mark_all_dirty(MultiMesh *multimesh, bool p_data, bool p_aabb);
 	_FORCE_INLINE_ void _multimesh_re_create_aabb(MultiMesh *multimesh, const float *p_data, int p_instances);
+	_FORCE_INLINE_ static bool _multimesh_uses_chunks(const MultiMesh *multimesh) {
+		return multimesh->chunks.size > 0 && multimesh->xform_format == RS::MULTIMESH_TRANSFORM_3D;
+	}
+	void _multimesh_update_chunks(MultiMesh *multimesh, const float *p_data, int p_instances);
+	void _multimesh_compact_chunks(MultiMesh *multimesh);
 	void _update_dirty_multimeshes();
 
 	/* PARTICLES */
@@ -1255,6 +1300,10 @@ private:
 
 	EffectsRD effects;
 
+	/* RENDER GRAPH */
+
+	RenderGraphRD render_graph;
+
 public:
 	virtual bool can_create_resources_async() const;
 
@@ -1292,6 +1341,7 @@ public:
 	virtual void texture_set_detect_3d_callback(RID p_texture, RS::TextureDetectCallback p_callback, void *p_userdata);
 	virtual void texture_set_detect_normal_callback(RID p_texture, RS::TextureDetectCallback p_callback, void *p_userdata);
 	virtual void texture_set_detect_roughness_callback(RID p_texture, RS::TextureDetectRoughnessCallback p_callback, void *p_userdata);
+	virtual void texture_set_stream_callback(RID p_texture, const Size2i &p_full_size, RS::TextureStreamCallback p_callback, ObjectID p_owner);
 
 	virtual void texture_debug_usage(List<RS::TextureInfo> *r_info);
 
@@ -1395,6 +1445,8 @@ public:
 	void material_get_instance_shader_parameters(RID p_material, List<InstanceShaderParam> *r_parameters);
 
 	void material_update_dependency(RID p_material, DependencyTracker *p_instance);
+
+	void material_request_texture_stream_size(RID p_material, float p_pixel_size);
 	void material_force_update_textures(RID p_material, ShaderType p_shader_type);
 
 	void material_set_data_request_function(ShaderType p_shader_type, MaterialDataRequestFunction p_function);
@@ -1525,6 +1577,21 @@ public:
 		}
 	}
 
+	_FORCE_INLINE_ uint32_t mesh_surface_get_index_count(void *p_surface, uint32_t p_lod) const {
+		Mesh::Surface *s = reinterpret_cast<Mesh::Surface *>(p_surface);
+
+		if (p_lod == 0) {
+			return s->index_count;
+		} else {
+			return s->lods[p_lod - 1].index_count;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t mesh_surface_get_vertex_count(void *p_surface) const {
+		Mesh::Surface *s = reinterpret_cast<Mesh::Surface *>(p_surface);
+		return s->vertex_count;
+	}
+
 	_FORCE_INLINE_ void mesh_surface_get_vertex_arrays_and_format(void *p_surface, uint32_t p_input_mask, RID &r_vertex_array_rd, RD::VertexFormatID &r_vertex_format) {
 		Mesh::Surface *s = reinterpret_cast<Mesh::Surface *>(p_surface);
 
@@ -1662,6 +1729,12 @@ public:
 	void multimesh_set_visible_instances(RID p_multimesh, int p_visible);
 	int multimesh_get_visible_instances(RID p_multimesh) const;
 
+	void multimesh_set_chunk_size(RID p_multimesh, int p_size);
+	int multimesh_get_chunk_size(RID p_multimesh) const;
+
+	const AABB *multimesh_get_chunk_aabbs(RID p_multimesh, uint32_t &r_chunk_count) const;
+	void multimesh_set_visible_chunks(RID p_multimesh, const uint8_t *p_visible);
+
 	AABB multimesh_get_aabb(RID p_multimesh) const;
 
 	_FORCE_INLINE_ RS::MultimeshTransformFormat multimesh_get_transform_format(RID p_multimesh) const {
@@ -1681,6 +1754,9 @@ public:
 
 	_FORCE_INLINE_ uint32_t multimesh_get_instances_to_draw(RID p_multimesh) const {
 		MultiMesh *multimesh = multimesh_owner.getornull(p_multimesh);
+		if (_multimesh_uses_chunks(multimesh)) {
+			return multimesh->chunks.visible_instances;
+		}
 		if (multimesh->visible_instances >= 0) {
 			return multimesh->visible_instances;
 		}
@@ -1746,6 +1822,7 @@ public:
 	int skeleton_get_bone_count(RID p_skeleton) const;
 	void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform);
 	Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const;
+	void skeleton_set_bone_transforms(RID p_skeleton, const PackedFloat32Array &p_transforms);
 	void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform);
 	Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const;
 
@@ -2300,6 +2377,7 @@ public:
 	bool has_os_feature(const String &p_feature) const;
 
 	void update_dirty_resources();
+	void update_texture_streaming();
 
 	void set_debug_generate_wireframes(bool p_generate) {}
 
@@ -2307,7 +2385,7 @@ public:
 	void render_info_end_capture() {}
 	int get_captured_render_info(RS::RenderInfo p_info) { return 0; }
 
-	uint64_t get_render_info(RS::RenderInfo p_info) { return 0; }
+	uint64_t get_render_info(RS::RenderInfo p_info);
 	String get_video_adapter_name() const { return String(); }
 	String get_video_adapter_vendor() const { return String(); }
 
@@ -2324,6 +2402,7 @@ public:
 	static RendererStorageRD *base_singleton;
 
 	EffectsRD *get_effects();
+	RenderGraphRD *get_render_graph();
 
 	RendererStorageRD();
 	~RendererStorageRD();
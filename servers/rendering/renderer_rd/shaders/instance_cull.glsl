@@ -0,0 +1,157 @@
+#[compute]
+
+#version 450
+
+#VERSION_DEFINES
+
+#ifdef MODE_HZB_REDUCE
+
+layout(local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout(set = 0, binding = 0) uniform sampler2D source_depth;
+layout(r32f, set = 0, binding = 1) uniform restrict writeonly image2D dest_depth;
+
+layout(push_constant, binding = 0, std430) uniform Params {
+	ivec2 source_size;
+	ivec2 dest_size;
+}
+params;
+
+void main() {
+	ivec2 pos = ivec2(gl_GlobalInvocationID.xy);
+	if (any(greaterThanEqual(pos, params.dest_size))) {
+		return;
+	}
+
+	// Keep the farthest depth of the footprint, so a texel is only as occluding as its least occluding pixel.
+	// Texels past the edge of a source with an odd size repeat its last row or column.
+	ivec2 base = pos * 2;
+	ivec2 limit = params.source_size - 1;
+	float depth = texelFetch(source_depth, min(base, limit), 0).r;
+	depth = max(depth, texelFetch(source_depth, min(base + ivec2(1, 0), limit), 0).r);
+	depth = max(depth, texelFetch(source_depth, min(base + ivec2(0, 1), limit), 0).r);
+	depth = max(depth, texelFetch(source_depth, min(base + ivec2(1, 1), limit), 0).r);
+
+	imageStore(dest_depth, pos, vec4(depth));
+}
+
+#endif
+
+#ifdef MODE_CULL
+
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+layout(set = 0, binding = 0) uniform sampler2D hzb;
+
+struct CullItem {
+	vec3 aabb_min;
+	uint draw_index;
+	vec3 aabb_max;
+	uint instance_index;
+};
+
+layout(set = 0, binding = 1, std430) restrict readonly buffer CullItems {
+	CullItem data[];
+}
+items;
+
+// Matches VkDrawIndexedIndirectCommand, padded to 32 bytes with the offset of the draw in the visible instance list.
+struct DrawCommand {
+	uint index_count;
+	uint instance_count;
+	uint first_index;
+	int vertex_offset;
+	uint first_instance;
+	uint visible_offset;
+	uint pad0;
+	uint pad1;
+};
+
+layout(set = 0, binding = 2, std430) restrict buffer DrawCommands {
+	DrawCommand data[];
+}
+draws;
+
+layout(set = 0, binding = 3, std430) restrict writeonly buffer VisibleInstances {
+	uint data[];
+}
+visible_instances;
+
+layout(push_constant, binding = 0, std430) uniform Params {
+	mat4 view_projection;
+	vec2 screen_size;
+	uint hzb_mipmaps;
+	uint item_count;
+}
+params;
+
+void main() {
+	uint index = gl_GlobalInvocationID.x;
+	if (index >= params.item_count) {
+		return;
+	}
+
+	CullItem item = items.data[index];
+
+	bvec3 outside_min = bvec3(true);
+	bvec3 outside_max = bvec3(true);
+	bool crosses_near = false;
+	vec2 rect_min = vec2(1.0);
+	vec2 rect_max = vec2(-1.0);
+	float min_depth = 1.0;
+
+	for (uint i = 0; i < 8; i++) {
+		vec3 corner = mix(item.aabb_min, item.aabb_max, bvec3((i & 1) != 0, (i & 2) != 0, (i & 4) != 0));
+		vec4 clip = params.view_projection * vec4(corner, 1.0);
+
+		outside_min = outside_min && lessThan(clip.xyz, vec3(-clip.w, -clip.w, 0.0));
+		outside_max = outside_max && greaterThan(clip.xyz, vec3(clip.w));
+
+		if (clip.w <= 0.0) {
+			crosses_near = true;
+		} else {
+			vec3 ndc = clip.xyz / clip.w;
+			rect_min = min(rect_min, ndc.xy);
+			rect_max = max(rect_max, ndc.xy);
+			min_depth = min(min_depth, ndc.z);
+		}
+	}
+
+	if (any(outside_min) || any(outside_max)) {
+		return; // Completely on the outer side of a frustum plane.
+	}
+
+	// Anything crossing the camera plane covers too much of the screen to be worth testing.
+	if (!crosses_near) {
+		// Each level halves the previous one rounding up, so a texel of level N covers exactly 2^(N+1) pixels per axis.
+		ivec2 screen_limit = ivec2(params.screen_size) - 1;
+		ivec2 pixel_min = clamp(ivec2((rect_min * 0.5 + 0.5) * params.screen_size), ivec2(0), screen_limit);
+		ivec2 pixel_max = clamp(ivec2((rect_max * 0.5 + 0.5) * params.screen_size), ivec2(0), screen_limit);
+
+		// Pick the level where the rect spans at most two texels on each axis, rects too large for the
+		// smallest level are simply considered visible.
+		ivec2 rect_size = pixel_max - pixel_min + 1;
+		int level = max(int(ceil(log2(float(max(rect_size.x, rect_size.y))))) - 1, 0);
+
+		if (level < int(params.hzb_mipmaps)) {
+			ivec2 from = pixel_min >> (level + 1);
+			ivec2 to = pixel_max >> (level + 1);
+
+			float max_depth = 0.0;
+			for (int y = from.y; y <= to.y; y++) {
+				for (int x = from.x; x <= to.x; x++) {
+					max_depth = max(max_depth, texelFetch(hzb, ivec2(x, y), level).r);
+				}
+			}
+
+			if (min_depth > max_depth) {
+				return; // Behind everything drawn in the depth prepass.
+			}
+		}
+	}
+
+	uint slot = atomicAdd(draws.data[item.draw_index].instance_count, 1);
+	visible_instances.data[draws.data[item.draw_index].visible_offset + slot] = item.instance_index;
+}
+
+#endif
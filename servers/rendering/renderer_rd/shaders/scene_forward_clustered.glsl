@@ -109,9 +109,16 @@ void main() {
 
 	instance_index = draw_call.instance_index;
 
-	bool is_multimesh = bool(instances.data[instance_index].flags & INSTANCE_FLAGS_MULTIMESH);
-	if (!is_multimesh) {
-		instance_index += gl_InstanceIndex;
+#ifndef MODE_RENDER_SDF
+	if (bool(draw_call.use_visible_instances)) {
+		instance_index = visible_instances.data[instance_index + gl_InstanceIndex];
+	} else
+#endif
+	{
+		bool is_multimesh = bool(instances.data[instance_index].flags & INSTANCE_FLAGS_MULTIMESH);
+		if (!is_multimesh) {
+			instance_index += gl_InstanceIndex;
+		}
 	}
 
 	mat4 world_matrix = instances.data[instance_index].transform;
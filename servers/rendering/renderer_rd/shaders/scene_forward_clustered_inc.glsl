@@ -22,10 +22,10 @@
 #endif
 
 layout(push_constant, binding = 0, std430) uniform DrawCall {
-	uint instance_index;
+	uint instance_index; // Offset in the visible instance list instead when use_visible_instances is set.
 	uint uv_offset;
-	uint pad0;
-	uint pad1;
+	uint use_visible_instances;
+	uint pad;
 }
 draw_call;
 
@@ -329,6 +329,12 @@ gi_probes;
 
 layout(set = 1, binding = 18) uniform texture3D volumetric_fog_texture;
 
+// Filled by the GPU instance culling pass.
+layout(set = 1, binding = 19, std430) restrict readonly buffer VisibleInstances {
+	uint data[];
+}
+visible_instances;
+
 #endif
 
 /* Set 2 Skeleton & Instancing (can change per item) */
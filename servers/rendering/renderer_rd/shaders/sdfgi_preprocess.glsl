@@ -167,6 +167,12 @@ layout(push_constant, binding = 0, std430) uniform Params {
 	uint occlusion_index;
 	int cascade;
 	uint pad;
+
+	ivec3 refresh_from;
+	uint pad2;
+
+	ivec3 refresh_to;
+	uint pad3;
 }
 params;
 
@@ -186,6 +192,10 @@ void main() {
 		return; //fits outside the 3D texture, dont do anything
 	}
 
+	if (all(greaterThanEqual(write_pos, params.refresh_from)) && all(lessThan(write_pos, params.refresh_to))) {
+		return; //re-voxelized this frame, keep the new data
+	}
+
 	uint albedo = ((src_process_voxels.data[index].albedo & 0x7FFF) << 1) | 1; //add solid bit
 	imageStore(dst_albedo, write_pos, uvec4(albedo));
 
@@ -750,7 +750,31 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform &
 	Instance *instance = instance_owner.getornull(p_instance);
 	ERR_FAIL_COND(!instance);
 
-	if (instance->transform == p_transform) {
+	_instance_set_transform(instance, p_transform);
+}
+
+void RendererSceneCull::instances_set_transforms(const Vector<RID> &p_instances, const PackedFloat32Array &p_transforms) {
+	ERR_FAIL_COND(p_transforms.size() != p_instances.size() * 12);
+
+	const RID *instances = p_instances.ptr();
+	const float *r = p_transforms.ptr();
+
+	for (int i = 0; i < p_instances.size(); i++, r += 12) {
+		Instance *instance = instance_owner.getornull(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		Transform xform;
+		xform.basis.elements[0] = Vector3(r[0], r[1], r[2]);
+		xform.basis.elements[1] = Vector3(r[4], r[5], r[6]);
+		xform.basis.elements[2] = Vector3(r[8], r[9], r[10]);
+		xform.origin = Vector3(r[3], r[7], r[11]);
+
+		_instance_set_transform(instance, xform);
+	}
+}
+
+void RendererSceneCull::_instance_set_transform(Instance *p_instance, const Transform &p_transform) {
+	if (p_instance->transform == p_transform) {
 		return; //must be checked to avoid worst evil
 	}
 
@@ -767,8 +791,8 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform &
 	}
 
 #endif
-	instance->transform = p_transform;
-	_instance_queue_update(instance, true);
+	p_instance->transform = p_transform;
+	_instance_queue_update(p_instance, true);
 }
 
 void RendererSceneCull::instance_attach_object_instance_id(RID p_instance, ObjectID p_id) {
@@ -993,6 +1017,10 @@ void RendererSceneCull::instance_geometry_set_flag(RID p_instance, RS::InstanceF
 
 	switch (p_flags) {
 		case RS::INSTANCE_FLAG_USE_BAKED_LIGHT: {
+			if (instance->scenario && instance->indexer_id.is_valid() && bool(instance->baked_light) != p_enabled && ((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK)) {
+				_scenario_mark_sdfgi_dirty(instance->scenario, instance->transformed_aabb);
+			}
+
 			instance->baked_light = p_enabled;
 
 			if (instance->scenario && instance->array_index >= 0) {
@@ -1218,6 +1246,10 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		scene_render->light_instance_set_transform(light->instance, p_instance->transform);
 		scene_render->light_instance_set_aabb(light->instance, p_instance->transform.xform(p_instance->aabb));
 		light->shadow_dirty = true;
+		light->static_shadow_dirty = true;
+		for (int i = 0; i < 6; i++) {
+			light->static_shadow_version[i] = 0; // Static layers are stale once the light changes.
+		}
 
 		RS::LightBakeMode bake_mode = RSG::storage->light_get_bake_mode(p_instance->base);
 		if (RSG::storage->light_get_type(p_instance->base) != RS::LIGHT_DIRECTIONAL && bake_mode != light->bake_mode) {
@@ -1290,6 +1322,16 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 
 	AABB new_aabb;
 	new_aabb = p_instance->transform.xform(p_instance->aabb);
+
+	if (p_instance->baked_light && p_instance->scenario && ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK)) {
+		if (!p_instance->indexer_id.is_valid()) {
+			_scenario_mark_sdfgi_dirty(p_instance->scenario, new_aabb);
+		} else if (p_instance->transformed_aabb != new_aabb) {
+			_scenario_mark_sdfgi_dirty(p_instance->scenario, p_instance->transformed_aabb);
+			_scenario_mark_sdfgi_dirty(p_instance->scenario, new_aabb);
+		}
+	}
+
 	p_instance->transformed_aabb = new_aabb;
 
 	if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
@@ -1301,6 +1343,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 				InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
 				light->shadow_dirty = true;
 			}
+			p_instance->last_shadow_change_frame = RSG::rasterizer->get_frame_number();
 		}
 
 		if (!p_instance->lightmap && geom->lightmap_captures.size()) {
@@ -1477,6 +1520,9 @@ void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 
 	if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
 		p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].remove(p_instance->indexer_id);
+		if (p_instance->baked_light) {
+			_scenario_mark_sdfgi_dirty(p_instance->scenario, p_instance->transformed_aabb);
+		}
 	} else {
 		p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].remove(p_instance->indexer_id);
 	}
@@ -1508,6 +1554,16 @@ void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 	}
 }
 
+void RendererSceneCull::_scenario_mark_sdfgi_dirty(Scenario *p_scenario, const AABB &p_aabb) {
+	LocalVector<AABB> &dirty_aabbs = p_scenario->sdfgi_dirty_aabbs;
+	if (dirty_aabbs.size() >= Scenario::SDFGI_MAX_DIRTY_AABBS && dirty_aabbs.size() > p_scenario->sdfgi_dirty_aabbs_rendered) {
+		// Nothing drew this scenario in a while, grow the last bounds instead of the list.
+		dirty_aabbs[dirty_aabbs.size() - 1].merge_with(p_aabb);
+		return;
+	}
+	dirty_aabbs.push_back(p_aabb);
+}
+
 void RendererSceneCull::_update_instance_aabb(Instance *p_instance) {
 	AABB new_aabb;
 
@@ -1719,6 +1775,7 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 	cull.shadow_count = p_shadow_index + 1;
 	cull.shadows[p_shadow_index].cascade_count = splits;
 	cull.shadows[p_shadow_index].light_instance = light->instance;
+	cull.shadows[p_shadow_index].light = light;
 
 	for (int i = 0; i < splits; i++) {
 		RENDER_TIMESTAMP("Culling Directional Light split" + itos(i));
@@ -1798,24 +1855,32 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 		real_t radius = 0;
 		real_t soft_shadow_expand = 0;
 		Vector3 center;
+		Vector3 light_center; // center in light space
+		real_t extent = 0;
 
 		{
 			//camera viewport stuff
 
+			//measured in camera space, so the radius does not change (even by rounding) as the camera moves
+			Vector3 local_endpoints[8];
+			camera_matrix.get_endpoints(Transform(), local_endpoints);
+
 			for (int j = 0; j < 8; j++) {
-				center += endpoints[j];
+				center += local_endpoints[j];
 			}
 			center /= 8.0;
 
 			//center=x_vec*(x_max-x_min)*0.5 + y_vec*(y_max-y_min)*0.5 + z_vec*(z_max-z_min)*0.5;
 
 			for (int j = 0; j < 8; j++) {
-				real_t d = center.distance_to(endpoints[j]);
+				real_t d = center.distance_to(local_endpoints[j]);
 				if (d > radius) {
 					radius = d;
 				}
 			}
 
+			center = p_cam_transform.xform(center);
+
 			radius *= texture_size / (texture_size - 2.0); //add a texel by each side
 
 			if (i == 0) {
@@ -1824,13 +1889,26 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 				bias_scale = radius / first_radius;
 			}
 
-			z_min_cam = z_vec.dot(center) - radius;
+			light_center = Vector3(x_vec.dot(center), y_vec.dot(center), z_vec.dot(center));
+			extent = radius;
+
+			if (static_shadow_cache_enabled) {
+				//static layers are reused while the cascade stays in place, so it moves in world space steps
+				//of a quarter of its radius, growing by half a step to still cover the whole split
+				real_t step = radius * 0.25;
+				for (int j = 0; j < 3; j++) {
+					light_center[j] = Math::snapped(light_center[j], step);
+				}
+				extent += step * 0.5;
+			}
+
+			z_min_cam = light_center.z - extent;
 
 			{
 				float soft_shadow_angle = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_SIZE);
 
 				if (soft_shadow_angle > 0.0) {
-					float z_range = (z_vec.dot(center) + radius + pancake_size) - z_min_cam;
+					float z_range = (light_center.z + extent + pancake_size) - z_min_cam;
 					soft_shadow_expand = Math::tan(Math::deg2rad(soft_shadow_angle)) * z_range;
 
 					x_max += soft_shadow_expand;
@@ -1841,22 +1919,31 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 				}
 			}
 
-			x_max_cam = x_vec.dot(center) + radius + soft_shadow_expand;
-			x_min_cam = x_vec.dot(center) - radius - soft_shadow_expand;
-			y_max_cam = y_vec.dot(center) + radius + soft_shadow_expand;
-			y_min_cam = y_vec.dot(center) - radius - soft_shadow_expand;
+			x_max_cam = light_center.x + extent + soft_shadow_expand;
+			x_min_cam = light_center.x - extent - soft_shadow_expand;
+			y_max_cam = light_center.y + extent + soft_shadow_expand;
+			y_min_cam = light_center.y - extent - soft_shadow_expand;
 
 			if (depth_range_mode == RS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_STABLE) {
 				//this trick here is what stabilizes the shadow (make potential jaggies to not move)
 				//at the cost of some wasted resolution. Still the quality increase is very well worth it
 
-				real_t unit = radius * 2.0 / texture_size;
+				real_t unit = extent * 2.0 / texture_size;
 
 				x_max_cam = Math::snapped(x_max_cam, unit);
 				x_min_cam = Math::snapped(x_min_cam, unit);
 				y_max_cam = Math::snapped(y_max_cam, unit);
 				y_min_cam = Math::snapped(y_min_cam, unit);
 			}
+
+			if (static_shadow_cache_enabled) {
+				//the static layer drawn now is reused as the camera moves, so it needs every caster in the cascade
+				x_min = x_min_cam;
+				x_max = x_max_cam;
+				y_min = y_min_cam;
+				y_max = y_max_cam;
+				z_min = z_min_cam;
+			}
 		}
 
 		//now that we know all ranges, we can proceed to make the light frustum planes, for culling octree
@@ -1876,8 +1963,8 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 
 		// a pre pass will need to be needed to determine the actual z-near to be used
 
-		if (pancake_size > 0) {
-			z_max = z_vec.dot(center) + radius + pancake_size;
+		if (pancake_size > 0 || static_shadow_cache_enabled) {
+			z_max = light_center.z + extent + pancake_size;
 		}
 
 		if (aspect != 1.0) {
@@ -1953,7 +2040,7 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 			cull.shadows[p_shadow_index].cascades[i].transform = ortho_transform;
 			cull.shadows[p_shadow_index].cascades[i].zfar = z_max - z_min_cam;
 			cull.shadows[p_shadow_index].cascades[i].split = distances[i + 1];
-			cull.shadows[p_shadow_index].cascades[i].shadow_texel_size = radius * 2.0 / texture_size;
+			cull.shadows[p_shadow_index].cascades[i].shadow_texel_size = extent * 2.0 / texture_size;
 			cull.shadows[p_shadow_index].cascades[i].bias_scale = bias_scale * aspect_bias_scale * min_distance_bias_scale;
 			cull.shadows[p_shadow_index].cascades[i].range_begin = z_max;
 			cull.shadows[p_shadow_index].cascades[i].uv_scale = uv_scale;
@@ -1969,11 +2056,17 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 	bool animated_material_found = false;
 
+	// Static casters are only worth caching once the light stopped changing, the static layer would be redrawn anyway.
+	uint64_t frame = RSG::rasterizer->get_frame_number();
+	bool use_static_cache = static_shadow_cache_enabled && !light->static_shadow_dirty;
+	light->static_shadow_dirty = false;
+
 	switch (RSG::storage->light_get_type(p_instance->base)) {
 		case RS::LIGHT_DIRECTIONAL: {
 		} break;
 		case RS::LIGHT_OMNI: {
 			RS::LightOmniShadowMode shadow_mode = RSG::storage->light_omni_get_shadow_mode(p_instance->base);
+			use_static_cache = use_static_cache && shadow_mode == RS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID; // Cube shadows are not cached.
 
 			if (shadow_mode == RS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID || !scene_render->light_instances_can_render_shadow_cube()) {
 				if (max_shadows_used + 2 > MAX_UPDATE_SHADOWS) {
@@ -2012,10 +2105,12 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 					cull_convex.result = &instance_shadow_cull_result;
 
 					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+					multimesh_chunk_volumes.push_back(planes);
 
 					Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
 
 					RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
+					uint64_t static_hash = 0;
 
 					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
 						Instance *instance = instance_shadow_cull_result[j];
@@ -2029,9 +2124,12 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 							if (instance->mesh_instance.is_valid()) {
 								RSG::storage->mesh_instance_check_for_update(instance->mesh_instance);
 							}
+							if (instance->base_type == RS::INSTANCE_MULTIMESH) {
+								frustum_cull_result.multimesh_instances.push_back(instance);
+							}
 						}
 
-						shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
+						_add_shadow_caster(shadow_data, instance, use_static_cache, frame, static_hash);
 					}
 
 					RSG::storage->update_mesh_instances();
@@ -2039,6 +2137,7 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 					scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, i, 0);
 					shadow_data.light = light->instance;
 					shadow_data.pass = i;
+					_update_static_shadow_version(light, i, shadow_data, use_static_cache, static_hash);
 				}
 			} else { //shadow cube
 
@@ -2092,6 +2191,7 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 					cull_convex.result = &instance_shadow_cull_result;
 
 					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+					multimesh_chunk_volumes.push_back(planes);
 
 					RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
 
@@ -2106,6 +2206,9 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 							if (instance->mesh_instance.is_valid()) {
 								RSG::storage->mesh_instance_check_for_update(instance->mesh_instance);
 							}
+							if (instance->base_type == RS::INSTANCE_MULTIMESH) {
+								frustum_cull_result.multimesh_instances.push_back(instance);
+							}
 						}
 
 						shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
@@ -2116,6 +2219,7 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 					shadow_data.light = light->instance;
 					shadow_data.pass = i;
+					shadow_data.static_version = 0;
 				}
 
 				//restore the regular DP matrix
@@ -2155,8 +2259,10 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 			cull_convex.result = &instance_shadow_cull_result;
 
 			p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+			multimesh_chunk_volumes.push_back(planes);
 
 			RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
+			uint64_t static_hash = 0;
 
 			for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
 				Instance *instance = instance_shadow_cull_result[j];
@@ -2170,8 +2276,11 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 					if (instance->mesh_instance.is_valid()) {
 						RSG::storage->mesh_instance_check_for_update(instance->mesh_instance);
 					}
+					if (instance->base_type == RS::INSTANCE_MULTIMESH) {
+						frustum_cull_result.multimesh_instances.push_back(instance);
+					}
 				}
-				shadow_data.instances.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
+				_add_shadow_caster(shadow_data, instance, use_static_cache, frame, static_hash);
 			}
 
 			RSG::storage->update_mesh_instances();
@@ -2179,6 +2288,7 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 			scene_render->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0, 0);
 			shadow_data.light = light->instance;
 			shadow_data.pass = 0;
+			_update_static_shadow_version(light, 0, shadow_data, use_static_cache, static_hash);
 
 		} break;
 	}
@@ -2186,6 +2296,21 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 	return animated_material_found;
 }
 
+void RendererSceneCull::_update_static_shadow_version(InstanceLightData *p_light, int p_pass, RendererSceneRender::RenderShadowData &r_shadow_data, bool p_use_static_cache, uint64_t p_static_hash) {
+	if (!p_use_static_cache) {
+		p_light->static_shadow_version[p_pass] = 0;
+		r_shadow_data.static_version = 0;
+		return;
+	}
+
+	if (p_light->static_shadow_version[p_pass] == 0 || p_light->static_shadow_hash[p_pass] != p_static_hash) {
+		// Versions are unique across lights, so a layer reassigned to another light is never mistaken as valid.
+		p_light->static_shadow_version[p_pass] = ++static_shadow_version;
+		p_light->static_shadow_hash[p_pass] = p_static_hash;
+	}
+	r_shadow_data.static_version = p_light->static_shadow_version[p_pass];
+}
+
 void RendererSceneCull::render_camera(RID p_render_buffers, RID p_camera, RID p_scenario, RID p_viewport, Size2 p_viewport_size, float p_screen_lod_threshold, RID p_shadow_atlas) {
 // render to mono camera
 #ifndef _3D_DISABLED
@@ -2235,6 +2360,10 @@ void RendererSceneCull::render_camera(RID p_render_buffers, RID p_camera, RID p_
 	RendererSceneOcclusionCull::get_singleton()->buffer_update(p_viewport, camera->transform, camera_matrix, ortho, RendererThreadPool::singleton->thread_work_pool);
 
 	_render_scene(camera->transform, camera_matrix, ortho, camera->vaspect, p_render_buffers, environment, camera->effects, camera->visible_layers, p_scenario, p_viewport, p_shadow_atlas, RID(), -1, p_screen_lod_threshold);
+
+	if (texture_streaming_enabled) {
+		_request_texture_streaming(camera->transform, camera_matrix, ortho, p_viewport_size.width);
+	}
 #endif
 }
 
@@ -2497,6 +2626,12 @@ void RendererSceneCull::_frustum_cull(CullData &cull_data, FrustumCullResult &cu
 
 				if (keep) {
 					cull_result.geometry_instances.push_back(idata.instance_geometry);
+					if (base_type == RS::INSTANCE_MULTIMESH) {
+						cull_result.multimesh_instances.push_back(idata.instance);
+					}
+					if (texture_streaming_enabled && (base_type == RS::INSTANCE_MESH || base_type == RS::INSTANCE_MULTIMESH)) {
+						cull_result.texture_stream_instances.push_back(idata.instance);
+					}
 				}
 			}
 		}
@@ -2508,7 +2643,14 @@ void RendererSceneCull::_frustum_cull(CullData &cull_data, FrustumCullResult &cu
 					uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
 
 					if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && idata.flags & InstanceData::FLAG_CAST_SHADOWS) {
-						cull_result.directional_shadows[j].cascade_geometry_instances[k].push_back(idata.instance_geometry);
+						if (static_shadow_cache_enabled && _is_static_shadow_caster(idata.instance, frame_number)) {
+							cull_result.directional_shadows[j].cascade_static_instances[k].push_back(idata.instance);
+						} else {
+							cull_result.directional_shadows[j].cascade_geometry_instances[k].push_back(idata.instance_geometry);
+						}
+						if (base_type == RS::INSTANCE_MULTIMESH) {
+							cull_result.multimesh_instances.push_back(idata.instance);
+						}
 						mesh_visible = true;
 					}
 				}
@@ -2532,6 +2674,9 @@ void RendererSceneCull::_frustum_cull(CullData &cull_data, FrustumCullResult &cu
 				} else if ((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) {
 					if (idata.flags & InstanceData::FLAG_USES_BAKED_LIGHT) {
 						cull_result.sdfgi_region_geometry_instances[j].push_back(idata.instance_geometry);
+						if (base_type == RS::INSTANCE_MULTIMESH) {
+							cull_result.multimesh_instances.push_back(idata.instance);
+						}
 						mesh_visible = true;
 					}
 				}
@@ -2544,6 +2689,130 @@ void RendererSceneCull::_frustum_cull(CullData &cull_data, FrustumCullResult &cu
 	}
 }
 
+void RendererSceneCull::_request_texture_streaming(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, float p_viewport_width) {
+	// Estimate how many pixels each visible instance covers, assuming its UVs span its largest side.
+	// The storage turns this into a texel size for every streamed texture its materials use.
+	float lod_multiplier = p_cam_projection.get_lod_multiplier();
+	float z_near = p_cam_projection.get_z_near();
+
+	for (uint32_t i = 0; i < frustum_cull_result.texture_stream_instances.size(); i++) {
+		Instance *ins = frustum_cull_result.texture_stream_instances[i];
+		const AABB &aabb = ins->transformed_aabb;
+
+		float screen_size;
+		if (p_cam_orthogonal) {
+			screen_size = aabb.get_longest_axis_size() / (lod_multiplier * 2.0);
+		} else {
+			Vector3 to_camera = (p_cam_transform.origin - (aabb.position + aabb.size * 0.5)).abs() - aabb.size * 0.5;
+			float distance = Vector3(MAX(to_camera.x, 0), MAX(to_camera.y, 0), MAX(to_camera.z, 0)).length();
+			screen_size = aabb.get_longest_axis_size() / (MAX(distance, z_near) * lod_multiplier);
+		}
+		float pixel_size = MIN(screen_size, 1.0) * p_viewport_width;
+
+		if (ins->material_override.is_valid()) {
+			RSG::storage->material_request_texture_stream_size(ins->material_override, pixel_size);
+			continue;
+		}
+
+		RID mesh = ins->base_type == RS::INSTANCE_MULTIMESH ? RSG::storage->multimesh_get_mesh(ins->base) : ins->base;
+		if (mesh.is_null()) {
+			continue;
+		}
+		int surface_count = RSG::storage->mesh_get_surface_count(mesh);
+		for (int j = 0; j < surface_count; j++) {
+			RID material = ins->base_type == RS::INSTANCE_MESH && j < ins->materials.size() && ins->materials[j].is_valid() ? ins->materials[j] : RSG::storage->mesh_surface_get_material(mesh, j);
+			if (material.is_valid()) {
+				RSG::storage->material_request_texture_stream_size(material, pixel_size);
+			}
+		}
+	}
+}
+
+void RendererSceneCull::_update_multimesh_chunk_visibility() {
+	if (frustum_cull_result.multimesh_instances.size() == 0) {
+		return;
+	}
+
+	// Chunks of multimeshes are culled against everything drawn in this render,
+	// then the storage packs the visible ones into the instance buffer.
+	for (uint32_t i = 0; i < cull.shadow_count; i++) {
+		for (uint32_t j = 0; j < cull.shadows[i].cascade_count; j++) {
+			multimesh_chunk_volumes.push_back(cull.shadows[i].cascades[j].frustum.planes);
+		}
+	}
+
+	for (uint32_t i = 0; i < cull.sdfgi.region_count; i++) {
+		const AABB &aabb = cull.sdfgi.region_aabb[i];
+		Vector3 end = aabb.position + aabb.size;
+		Vector<Plane> planes;
+		planes.push_back(Plane(Vector3(1, 0, 0), end.x));
+		planes.push_back(Plane(Vector3(0, 1, 0), end.y));
+		planes.push_back(Plane(Vector3(0, 0, 1), end.z));
+		planes.push_back(Plane(Vector3(-1, 0, 0), -aabb.position.x));
+		planes.push_back(Plane(Vector3(0, -1, 0), -aabb.position.y));
+		planes.push_back(Plane(Vector3(0, 0, -1), -aabb.position.z));
+		multimesh_chunk_volumes.push_back(planes);
+	}
+
+	// Group instances sharing a multimesh, the visible chunks are the union of all of them.
+	struct SortByBase {
+		_FORCE_INLINE_ bool operator()(const Instance *p_a, const Instance *p_b) const {
+			return p_a->base == p_b->base ? p_a < p_b : p_a->base < p_b->base;
+		}
+	};
+
+	multimesh_chunk_instances.resize(frustum_cull_result.multimesh_instances.size());
+	for (uint32_t i = 0; i < multimesh_chunk_instances.size(); i++) {
+		multimesh_chunk_instances[i] = frustum_cull_result.multimesh_instances[i];
+	}
+	multimesh_chunk_instances.sort_custom<SortByBase>();
+
+	uint32_t chunk_count = 0;
+	const AABB *chunk_aabbs = nullptr;
+
+	for (uint32_t i = 0; i < multimesh_chunk_instances.size(); i++) {
+		Instance *ins = multimesh_chunk_instances[i];
+		bool first = i == 0 || multimesh_chunk_instances[i - 1]->base != ins->base;
+		bool last = i == multimesh_chunk_instances.size() - 1 || multimesh_chunk_instances[i + 1]->base != ins->base;
+
+		if (first) {
+			chunk_aabbs = RSG::storage->multimesh_get_chunk_aabbs(ins->base, chunk_count);
+			multimesh_chunk_visible.resize(chunk_count);
+			for (uint32_t j = 0; j < chunk_count; j++) {
+				multimesh_chunk_visible[j] = 0;
+			}
+		}
+
+		if (chunk_count && (first || multimesh_chunk_instances[i - 1] != ins)) {
+			for (uint32_t j = 0; j < chunk_count; j++) {
+				if (multimesh_chunk_visible[j]) {
+					continue;
+				}
+				AABB aabb = ins->transform.xform(chunk_aabbs[j]);
+				for (uint32_t k = 0; k < multimesh_chunk_volumes.size(); k++) {
+					const Plane *planes = multimesh_chunk_volumes[k].ptr();
+					int plane_count = multimesh_chunk_volumes[k].size();
+					bool inside = true;
+					for (int l = 0; l < plane_count; l++) {
+						if (planes[l].distance_to(aabb.get_support(-planes[l].normal)) > 0) {
+							inside = false;
+							break;
+						}
+					}
+					if (inside) {
+						multimesh_chunk_visible[j] = 1;
+						break;
+					}
+				}
+			}
+		}
+
+		if (last && chunk_count) {
+			RSG::storage->multimesh_set_visible_chunks(ins->base, multimesh_chunk_visible.ptr());
+		}
+	}
+}
+
 void RendererSceneCull::_render_scene(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_render_buffers, RID p_environment, RID p_force_camera_effects, uint32_t p_visible_layers, RID p_scenario, RID p_viewport, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass, float p_screen_lod_threshold, bool p_using_shadows) {
 	// Note, in stereo rendering:
 	// - p_cam_transform will be a transform in the middle of our two eyes
@@ -2558,6 +2827,12 @@ void RendererSceneCull::_render_scene(const Transform &p_cam_transform, const Ca
 	scene_render->set_scene_pass(render_pass);
 
 	if (p_render_buffers.is_valid()) {
+		//only the cells touched by changed static geometry are re-voxelized, the rest is reused
+		for (uint32_t i = 0; i < scenario->sdfgi_dirty_aabbs.size(); i++) {
+			scene_render->sdfgi_mark_static_dirty(p_render_buffers, scenario->sdfgi_dirty_aabbs[i]);
+		}
+		scenario->sdfgi_dirty_aabbs_rendered = scenario->sdfgi_dirty_aabbs.size();
+
 		//no rendering code here, this is only to set up what needs to be done, request regions, etc.
 		scene_render->sdfgi_update(p_render_buffers, p_environment, p_cam_transform.origin); //update conditions for SDFGI (whether its used or not)
 	}
@@ -2574,6 +2849,9 @@ void RendererSceneCull::_render_scene(const Transform &p_cam_transform, const Ca
 
 	cull.frustum = Frustum(planes);
 
+	multimesh_chunk_volumes.clear();
+	multimesh_chunk_volumes.push_back(planes);
+
 	Vector<RID> directional_lights;
 	// directional lights
 	{
@@ -2705,10 +2983,29 @@ void RendererSceneCull::_render_scene(const Transform &p_cam_transform, const Ca
 				if (max_shadows_used == MAX_UPDATE_SHADOWS) {
 					continue;
 				}
-				render_shadow_data[max_shadows_used].light = cull.shadows[i].light_instance;
-				render_shadow_data[max_shadows_used].pass = j;
-				render_shadow_data[max_shadows_used].instances.merge_unordered(frustum_cull_result.directional_shadows[i].cascade_geometry_instances[j]);
-				max_shadows_used++;
+				RendererSceneRender::RenderShadowData &shadow_data = render_shadow_data[max_shadows_used++];
+				shadow_data.light = cull.shadows[i].light_instance;
+				shadow_data.pass = j;
+				shadow_data.instances.merge_unordered(frustum_cull_result.directional_shadows[i].cascade_geometry_instances[j]);
+
+				// Cascades move in steps with the camera (see _light_instance_setup_directional_shadow), the static layer is reused until the cascade moves.
+				InstanceLightData *light = cull.shadows[i].light;
+				bool use_static_cache = light->static_shadow_transform[j] == c.transform && light->static_shadow_projection[j] == c.projection;
+				light->static_shadow_transform[j] = c.transform;
+				light->static_shadow_projection[j] = c.projection;
+
+				const PagedArray<Instance *> &static_instances = frustum_cull_result.directional_shadows[i].cascade_static_instances[j];
+				uint64_t static_hash = 0;
+				for (uint32_t k = 0; k < static_instances.size(); k++) {
+					RendererSceneRender::GeometryInstance *geometry_instance = static_cast<InstanceGeometryData *>(static_instances[k]->base_data)->geometry_instance;
+					if (use_static_cache) {
+						shadow_data.static_instances.push_back(geometry_instance);
+						static_hash += hash_djb2_one_64(uint64_t(geometry_instance));
+					} else {
+						shadow_data.instances.push_back(geometry_instance);
+					}
+				}
+				_update_static_shadow_version(light, j, shadow_data, use_static_cache, static_hash);
 			}
 		}
 
@@ -2863,11 +3160,14 @@ void RendererSceneCull::_render_scene(const Transform &p_cam_transform, const Ca
 		occluders_tex = RSG::viewport->viewport_get_occluder_debug_texture(p_viewport);
 	}
 
+	_update_multimesh_chunk_visibility();
+
 	RENDER_TIMESTAMP("Render Scene ");
 	scene_render->render_scene(p_render_buffers, p_cam_transform, p_cam_projection, p_cam_orthogonal, frustum_cull_result.geometry_instances, frustum_cull_result.light_instances, frustum_cull_result.reflections, frustum_cull_result.gi_probes, frustum_cull_result.decals, frustum_cull_result.lightmaps, p_environment, camera_effects, p_shadow_atlas, occluders_tex, p_reflection_probe.is_valid() ? RID() : scenario->reflection_atlas, p_reflection_probe, p_reflection_probe_pass, p_screen_lod_threshold, render_shadow_data, max_shadows_used, render_sdfgi_data, cull.sdfgi.region_count, &sdfgi_update_data);
 
 	for (uint32_t i = 0; i < max_shadows_used; i++) {
 		render_shadow_data[i].instances.clear();
+		render_shadow_data[i].static_instances.clear();
 	}
 	max_shadows_used = 0;
 
@@ -3526,6 +3826,16 @@ void RendererSceneCull::update() {
 		Scenario *s = scenario_owner.get_ptr_by_index(i);
 		s->indexers[Scenario::INDEXER_GEOMETRY].optimize_incremental(indexer_update_iterations);
 		s->indexers[Scenario::INDEXER_VOLUMES].optimize_incremental(indexer_update_iterations);
+
+		if (s->sdfgi_dirty_aabbs_rendered > 0) {
+			//keep only the changes made after the last draw
+			uint32_t remaining = s->sdfgi_dirty_aabbs.size() - s->sdfgi_dirty_aabbs_rendered;
+			for (uint32_t j = 0; j < remaining; j++) {
+				s->sdfgi_dirty_aabbs[j] = s->sdfgi_dirty_aabbs[s->sdfgi_dirty_aabbs_rendered + j];
+			}
+			s->sdfgi_dirty_aabbs.resize(remaining);
+			s->sdfgi_dirty_aabbs_rendered = 0;
+		}
 	}
 	scene_render->update();
 	update_dirty_instances();
@@ -3614,6 +3924,7 @@ RendererSceneCull::RendererSceneCull() {
 
 	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
 		render_shadow_data[i].instances.set_page_pool(&geometry_instance_cull_page_pool);
+		render_shadow_data[i].static_instances.set_page_pool(&geometry_instance_cull_page_pool);
 	}
 	for (uint32_t i = 0; i < SDFGI_MAX_CASCADES * SDFGI_MAX_REGIONS_PER_CASCADE; i++) {
 		render_sdfgi_data[i].instances.set_page_pool(&geometry_instance_cull_page_pool);
@@ -3628,8 +3939,11 @@ RendererSceneCull::RendererSceneCull() {
 	indexer_update_iterations = GLOBAL_GET("rendering/limits/spatial_indexer/update_iterations_per_frame");
 	thread_cull_threshold = GLOBAL_GET("rendering/limits/spatial_indexer/threaded_cull_minimum_instances");
 	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)RendererThreadPool::singleton->thread_work_pool.get_thread_count()); //make sure there is at least one thread per CPU
+	texture_streaming_enabled = GLOBAL_GET("rendering/textures/streaming/enabled");
+	static_shadow_cache_enabled = GLOBAL_GET("rendering/shadows/static_shadow_cache/enabled");
 
-	dummy_occlusion_culling = memnew(RendererSceneOcclusionCull);
+	// The software rasterizer works on every platform, modules (e.g. raycast) can replace it with their own backend.
+	default_occlusion_culling = memnew(RendererSceneOcclusionCullRaster);
 }
 
 RendererSceneCull::~RendererSceneCull() {
@@ -3638,6 +3952,7 @@ RendererSceneCull::~RendererSceneCull() {
 
 	for (uint32_t i = 0; i < MAX_UPDATE_SHADOWS; i++) {
 		render_shadow_data[i].instances.reset();
+		render_shadow_data[i].static_instances.reset();
 	}
 	for (uint32_t i = 0; i < SDFGI_MAX_CASCADES * SDFGI_MAX_REGIONS_PER_CASCADE; i++) {
 		render_sdfgi_data[i].instances.reset();
@@ -3649,7 +3964,7 @@ RendererSceneCull::~RendererSceneCull() {
 	}
 	frustum_cull_result_threads.clear();
 
-	if (dummy_occlusion_culling) {
-		memdelete(dummy_occlusion_culling);
+	if (default_occlusion_culling) {
+		memdelete(default_occlusion_culling);
 	}
 }
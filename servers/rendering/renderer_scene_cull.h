@@ -46,6 +46,7 @@
 #include "core/templates/self_list.h"
 #include "servers/rendering/renderer_scene.h"
 #include "servers/rendering/renderer_scene_occlusion_cull.h"
+#include "servers/rendering/renderer_scene_occlusion_cull_raster.h"
 #include "servers/rendering/renderer_scene_render.h"
 #include "servers/xr/xr_interface.h"
 
@@ -117,7 +118,7 @@ public:
 	virtual void occluder_initialize(RID p_occluder);
 	virtual void occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices);
 
-	RendererSceneOcclusionCull *dummy_occlusion_culling;
+	RendererSceneOcclusionCull *default_occlusion_culling;
 
 	/* SCENARIO API */
 
@@ -300,6 +301,14 @@ public:
 		PagedArray<InstanceBounds> instance_aabbs;
 		PagedArray<InstanceData> instance_data;
 
+		enum {
+			SDFGI_MAX_DIRTY_AABBS = 256
+		};
+
+		// Bounds of static (baked light) geometry that changed, SDFGI re-voxelizes only these.
+		LocalVector<AABB> sdfgi_dirty_aabbs;
+		uint32_t sdfgi_dirty_aabbs_rendered = 0;
+
 		Scenario() {
 			indexers[INDEXER_GEOMETRY].set_index(INDEXER_GEOMETRY);
 			indexers[INDEXER_VOLUMES].set_index(INDEXER_VOLUMES);
@@ -421,6 +430,7 @@ public:
 		Vector<Color> lightmap_target_sh; //target is used for incrementally changing the SH over time, this avoids pops in some corner cases and when going interior <-> exterior
 
 		uint64_t last_frame_pass;
+		uint64_t last_shadow_change_frame; // last frame this instance changed as a shadow caster
 
 		uint64_t version; // changes to this, and changes to base increase version
 
@@ -501,6 +511,7 @@ public:
 			lod_end_hysteresis = 0;
 
 			last_frame_pass = 0;
+			last_shadow_change_frame = 0;
 			version = 1;
 			base_data = nullptr;
 
@@ -526,6 +537,7 @@ public:
 
 	SelfList<Instance>::List _instance_update_list;
 	void _instance_queue_update(Instance *p_instance, bool p_update_aabb, bool p_update_dependencies = false);
+	void _instance_set_transform(Instance *p_instance, const Transform &p_transform);
 
 	struct InstanceGeometryData : public InstanceBaseData {
 		RendererSceneRender::GeometryInstance *geometry_instance = nullptr;
@@ -582,6 +594,13 @@ public:
 		List<Instance *>::Element *D; // directional light in scenario
 
 		bool shadow_dirty;
+		bool static_shadow_dirty = true;
+
+		// Static shadow layer per pass (or cascade), the hash identifies the static casters drawn to it.
+		uint64_t static_shadow_version[6] = {};
+		uint64_t static_shadow_hash[6] = {};
+		CameraMatrix static_shadow_projection[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES];
+		Transform static_shadow_transform[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES];
 
 		Set<Instance *> geometries;
 
@@ -726,9 +745,12 @@ public:
 		PagedArray<RID> decals;
 		PagedArray<RID> gi_probes;
 		PagedArray<RID> mesh_instances;
+		PagedArray<Instance *> texture_stream_instances;
+		PagedArray<Instance *> multimesh_instances;
 
 		struct DirectionalShadow {
 			PagedArray<RendererSceneRender::GeometryInstance *> cascade_geometry_instances[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES];
+			PagedArray<Instance *> cascade_static_instances[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES];
 		} directional_shadows[RendererSceneRender::MAX_DIRECTIONAL_LIGHTS];
 
 		PagedArray<RendererSceneRender::GeometryInstance *> sdfgi_region_geometry_instances[SDFGI_MAX_CASCADES * SDFGI_MAX_REGIONS_PER_CASCADE];
@@ -743,9 +765,12 @@ public:
 			decals.clear();
 			gi_probes.clear();
 			mesh_instances.clear();
+			texture_stream_instances.clear();
+			multimesh_instances.clear();
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].clear();
+					directional_shadows[i].cascade_static_instances[j].clear();
 				}
 			}
 
@@ -767,9 +792,12 @@ public:
 			decals.reset();
 			gi_probes.reset();
 			mesh_instances.reset();
+			texture_stream_instances.reset();
+			multimesh_instances.reset();
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].reset();
+					directional_shadows[i].cascade_static_instances[j].reset();
 				}
 			}
 
@@ -791,10 +819,13 @@ public:
 			decals.merge_unordered(p_cull_result.decals);
 			gi_probes.merge_unordered(p_cull_result.gi_probes);
 			mesh_instances.merge_unordered(p_cull_result.mesh_instances);
+			texture_stream_instances.merge_unordered(p_cull_result.texture_stream_instances);
+			multimesh_instances.merge_unordered(p_cull_result.multimesh_instances);
 
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].merge_unordered(p_cull_result.directional_shadows[i].cascade_geometry_instances[j]);
+					directional_shadows[i].cascade_static_instances[j].merge_unordered(p_cull_result.directional_shadows[i].cascade_static_instances[j]);
 				}
 			}
 
@@ -816,9 +847,12 @@ public:
 			decals.set_page_pool(p_rid_pool);
 			gi_probes.set_page_pool(p_rid_pool);
 			mesh_instances.set_page_pool(p_rid_pool);
+			texture_stream_instances.set_page_pool(p_instance_pool);
+			multimesh_instances.set_page_pool(p_instance_pool);
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].set_page_pool(p_geometry_instance_pool);
+					directional_shadows[i].cascade_static_instances[j].set_page_pool(p_instance_pool);
 				}
 			}
 
@@ -841,7 +875,37 @@ public:
 	RendererSceneRender::RenderSDFGIData render_sdfgi_data[SDFGI_MAX_CASCADES * SDFGI_MAX_REGIONS_PER_CASCADE];
 	RendererSceneRender::RenderSDFGIUpdateData sdfgi_update_data;
 
+	// Volumes drawn this render (camera, shadows, SDFGI regions), used to cull chunked multimeshes.
+	LocalVector<Vector<Plane>> multimesh_chunk_volumes;
+	LocalVector<Instance *> multimesh_chunk_instances;
+	LocalVector<uint8_t> multimesh_chunk_visible;
+
 	uint32_t thread_cull_threshold = 200;
+	bool texture_streaming_enabled = false;
+
+	// Casters unchanged for this many frames are drawn to the cached static shadow layers.
+	static const uint64_t STATIC_SHADOW_CASTER_FRAMES = 30;
+	bool static_shadow_cache_enabled = false;
+	uint64_t static_shadow_version = 0;
+
+	_FORCE_INLINE_ bool _is_static_shadow_caster(const Instance *p_instance, uint64_t p_frame) const {
+		if (p_instance->base_type == RS::INSTANCE_PARTICLES || p_instance->mesh_instance.is_valid() || static_cast<InstanceGeometryData *>(p_instance->base_data)->material_is_animated) {
+			return false;
+		}
+		return p_frame - p_instance->last_shadow_change_frame > STATIC_SHADOW_CASTER_FRAMES;
+	}
+
+	_FORCE_INLINE_ void _add_shadow_caster(RendererSceneRender::RenderShadowData &r_shadow_data, Instance *p_instance, bool p_use_static_cache, uint64_t p_frame, uint64_t &r_static_hash) {
+		RendererSceneRender::GeometryInstance *geometry_instance = static_cast<InstanceGeometryData *>(p_instance->base_data)->geometry_instance;
+		if (p_use_static_cache && _is_static_shadow_caster(p_instance, p_frame)) {
+			r_shadow_data.static_instances.push_back(geometry_instance);
+			r_static_hash += hash_djb2_one_64(uint64_t(geometry_instance)); // Order independent, cull order is not stable.
+		} else {
+			r_shadow_data.instances.push_back(geometry_instance);
+		}
+	}
+
+	void _update_static_shadow_version(InstanceLightData *p_light, int p_pass, RendererSceneRender::RenderShadowData &r_shadow_data, bool p_use_static_cache, uint64_t p_static_hash);
 
 	RID_PtrOwner<Instance, true> instance_owner;
 
@@ -854,6 +918,7 @@ public:
 	virtual void instance_set_scenario(RID p_instance, RID p_scenario);
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask);
 	virtual void instance_set_transform(RID p_instance, const Transform &p_transform);
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const PackedFloat32Array &p_transforms);
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_id);
 	virtual void instance_set_blend_shape_weight(RID p_instance, int p_shape, float p_weight);
 	virtual void instance_set_surface_override_material(RID p_instance, int p_surface, RID p_material);
@@ -892,6 +957,7 @@ public:
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 	void _unpair_instance(Instance *p_instance);
+	void _scenario_mark_sdfgi_dirty(Scenario *p_scenario, const AABB &p_aabb);
 
 	void _light_instance_setup_directional_shadow(int p_shadow_index, Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect);
 
@@ -902,6 +968,7 @@ public:
 	struct Cull {
 		struct Shadow {
 			RID light_instance;
+			InstanceLightData *light = nullptr;
 			struct Cascade {
 				Frustum frustum;
 
@@ -950,6 +1017,8 @@ public:
 
 	void _frustum_cull_threaded(uint32_t p_thread, CullData *cull_data);
 	void _frustum_cull(CullData &cull_data, FrustumCullResult &cull_result, uint64_t p_from, uint64_t p_to);
+	void _request_texture_streaming(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, float p_viewport_width);
+	void _update_multimesh_chunk_visibility();
 
 	bool _render_reflection_probe_step(Instance *p_instance, int p_step);
 	void _render_scene(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_render_buffers, RID p_environment, RID p_force_camera_effects, uint32_t p_visible_layers, RID p_scenario, RID p_viewport, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass, float p_screen_lod_threshold, bool p_using_shadows = true);
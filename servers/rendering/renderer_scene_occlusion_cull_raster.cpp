@@ -0,0 +1,580 @@
+/*************************************************************************/
+/*  renderer_scene_occlusion_cull_raster.cpp                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "renderer_scene_occlusion_cull_raster.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+RendererSceneOcclusionCullRaster *RendererSceneOcclusionCullRaster::raster_singleton = nullptr;
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::clear() {
+	HZBuffer::clear();
+
+	triangles.clear();
+	bins.clear();
+	tiles_size = Size2i();
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::resize(const Size2i &p_size) {
+	if (p_size == Size2i()) {
+		clear();
+		return;
+	}
+
+	if (!sizes.is_empty() && p_size == sizes[0]) {
+		return; // Size didn't change
+	}
+
+	HZBuffer::resize(p_size);
+
+	tiles_size = Size2i((p_size.x + TILE_WIDTH - 1) / TILE_WIDTH, (p_size.y + TILE_HEIGHT - 1) / TILE_HEIGHT);
+	bins.clear();
+}
+
+bool RendererSceneOcclusionCullRaster::RasterHZBuffer::_setup_triangle(const Vector3 *p_view, const RasterThreadData *p_data, Triangle &r_triangle) const {
+	int w = sizes[0].x;
+	int h = sizes[0].y;
+
+	float x[3];
+	float y[3];
+	float depth[3];
+
+	for (int i = 0; i < 3; i++) {
+		Vector3 ndc = p_data->cam_projection.xform(p_view[i]);
+		x[i] = (ndc.x * 0.5f + 0.5f) * w;
+		y[i] = (ndc.y * 0.5f + 0.5f) * h;
+
+		float view_depth = MAX(-p_view[i].z, p_data->z_near);
+		depth[i] = p_data->cam_orthogonal ? view_depth : 1.0f / view_depth;
+	}
+
+	float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (Math::abs(area) < CMP_EPSILON) {
+		return false;
+	}
+
+	// Pixels are sampled at their centers.
+	r_triangle.min_x = MAX(0, (int)Math::ceil(MIN(x[0], MIN(x[1], x[2])) - 0.5f));
+	r_triangle.min_y = MAX(0, (int)Math::ceil(MIN(y[0], MIN(y[1], y[2])) - 0.5f));
+	r_triangle.max_x = MIN(w - 1, (int)Math::floor(MAX(x[0], MAX(x[1], x[2])) - 0.5f));
+	r_triangle.max_y = MIN(h - 1, (int)Math::floor(MAX(y[0], MAX(y[1], y[2])) - 0.5f));
+
+	if (r_triangle.min_x > r_triangle.max_x || r_triangle.min_y > r_triangle.max_y) {
+		return false; // Off-screen or between pixel centers.
+	}
+
+	// Occluders are double sided, flip the edges of back-facing triangles.
+	float sign = area > 0.0f ? 1.0f : -1.0f;
+	float inv_area = 1.0f / Math::abs(area);
+
+	r_triangle.depth_a = 0.0f;
+	r_triangle.depth_b = 0.0f;
+	r_triangle.depth_c = 0.0f;
+
+	for (int i = 0; i < 3; i++) {
+		int i1 = (i + 1) % 3;
+		int i2 = (i + 2) % 3;
+
+		r_triangle.edge_a[i] = (y[i1] - y[i2]) * sign;
+		r_triangle.edge_b[i] = (x[i2] - x[i1]) * sign;
+		r_triangle.edge_c[i] = (x[i1] * y[i2] - x[i2] * y[i1]) * sign;
+
+		r_triangle.depth_a += depth[i] * r_triangle.edge_a[i] * inv_area;
+		r_triangle.depth_b += depth[i] * r_triangle.edge_b[i] * inv_area;
+		r_triangle.depth_c += depth[i] * r_triangle.edge_c[i] * inv_area;
+	}
+
+	return true;
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::_setup_triangles_thread(uint32_t p_job, RasterThreadData *p_data) {
+	uint32_t tile_count = tiles_size.x * tiles_size.y;
+	LocalVector<uint32_t> *job_bins = &bins[p_job * tile_count];
+	for (uint32_t i = 0; i < tile_count; i++) {
+		job_bins[i].clear();
+	}
+
+	uint32_t from = p_job * TRIANGLES_PER_JOB;
+	uint32_t to = MIN(from + TRIANGLES_PER_JOB, p_data->triangle_count);
+
+	for (uint32_t i = from; i < to; i++) {
+		Vector3 view[3];
+		float near_distance[3];
+		for (int j = 0; j < 3; j++) {
+			view[j] = p_data->cam_inv_transform.xform(p_data->vertices[p_data->indices[i * 3 + j]]);
+			near_distance[j] = -view[j].z - p_data->z_near;
+		}
+
+		// Clip against the near plane, which can turn the triangle into a quad.
+		Vector3 clipped[4];
+		int clipped_count = 0;
+		for (int j = 0; j < 3; j++) {
+			int next = (j + 1) % 3;
+			if (near_distance[j] >= 0.0f) {
+				clipped[clipped_count++] = view[j];
+			}
+			if ((near_distance[j] >= 0.0f) != (near_distance[next] >= 0.0f)) {
+				float t = near_distance[j] / (near_distance[j] - near_distance[next]);
+				clipped[clipped_count++] = view[j].lerp(view[next], t);
+			}
+		}
+
+		for (int j = 0; j + 2 < clipped_count; j++) {
+			Vector3 fan[3] = { clipped[0], clipped[j + 1], clipped[j + 2] };
+			uint32_t triangle_index = i * 2 + j;
+			Triangle &triangle = triangles[triangle_index];
+
+			if (!_setup_triangle(fan, p_data, triangle)) {
+				continue;
+			}
+
+			int tile_min_x = triangle.min_x / TILE_WIDTH;
+			int tile_max_x = triangle.max_x / TILE_WIDTH;
+			int tile_min_y = triangle.min_y / TILE_HEIGHT;
+			int tile_max_y = triangle.max_y / TILE_HEIGHT;
+
+			for (int ty = tile_min_y; ty <= tile_max_y; ty++) {
+				for (int tx = tile_min_x; tx <= tile_max_x; tx++) {
+					job_bins[ty * tiles_size.x + tx].push_back(triangle_index);
+				}
+			}
+		}
+	}
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::_rasterize_triangle(const Triangle &p_triangle, int p_tile_x, int p_tile_y, bool p_orthogonal, float *r_tile_depth) const {
+	// Start at a multiple of 4 so every group of 4 pixels stays inside the (aligned) tile row.
+	int min_x = MAX(p_triangle.min_x, p_tile_x) & ~3;
+	int max_x = MIN(p_triangle.max_x, p_tile_x + TILE_WIDTH - 1);
+	int min_y = MAX(p_triangle.min_y, p_tile_y);
+	int max_y = MIN(p_triangle.max_y, p_tile_y + TILE_HEIGHT - 1);
+
+#ifdef __SSE2__
+	const __m128 lane_offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	const __m128 edge_a0 = _mm_set1_ps(p_triangle.edge_a[0]);
+	const __m128 edge_a1 = _mm_set1_ps(p_triangle.edge_a[1]);
+	const __m128 edge_a2 = _mm_set1_ps(p_triangle.edge_a[2]);
+	const __m128 depth_a = _mm_set1_ps(p_triangle.depth_a);
+
+	for (int y = min_y; y <= max_y; y++) {
+		float py = y + 0.5f;
+		const __m128 row_e0 = _mm_set1_ps(p_triangle.edge_b[0] * py + p_triangle.edge_c[0]);
+		const __m128 row_e1 = _mm_set1_ps(p_triangle.edge_b[1] * py + p_triangle.edge_c[1]);
+		const __m128 row_e2 = _mm_set1_ps(p_triangle.edge_b[2] * py + p_triangle.edge_c[2]);
+		const __m128 row_depth = _mm_set1_ps(p_triangle.depth_b * py + p_triangle.depth_c);
+
+		float *row = &r_tile_depth[(y - p_tile_y) * TILE_WIDTH - p_tile_x];
+
+		for (int x = min_x; x <= max_x; x += 4) {
+			__m128 px = _mm_add_ps(_mm_set1_ps((float)x), lane_offsets);
+
+			__m128 e0 = _mm_add_ps(_mm_mul_ps(edge_a0, px), row_e0);
+			__m128 e1 = _mm_add_ps(_mm_mul_ps(edge_a1, px), row_e1);
+			__m128 e2 = _mm_add_ps(_mm_mul_ps(edge_a2, px), row_e2);
+			__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+			if (_mm_movemask_ps(inside) == 0) {
+				continue;
+			}
+
+			__m128 depth = _mm_add_ps(_mm_mul_ps(depth_a, px), row_depth);
+			if (!p_orthogonal) {
+				depth = _mm_div_ps(one, depth);
+			}
+
+			__m128 prev = _mm_load_ps(&row[x]);
+			__m128 nearest = _mm_min_ps(prev, depth);
+			_mm_store_ps(&row[x], _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, prev)));
+		}
+	}
+#else
+	for (int y = min_y; y <= max_y; y++) {
+		float py = y + 0.5f;
+		float row_e0 = p_triangle.edge_b[0] * py + p_triangle.edge_c[0];
+		float row_e1 = p_triangle.edge_b[1] * py + p_triangle.edge_c[1];
+		float row_e2 = p_triangle.edge_b[2] * py + p_triangle.edge_c[2];
+		float row_depth = p_triangle.depth_b * py + p_triangle.depth_c;
+
+		float *row = &r_tile_depth[(y - p_tile_y) * TILE_WIDTH - p_tile_x];
+
+		for (int x = min_x; x <= max_x; x++) {
+			float px = x + 0.5f;
+			if (p_triangle.edge_a[0] * px + row_e0 < 0.0f || p_triangle.edge_a[1] * px + row_e1 < 0.0f || p_triangle.edge_a[2] * px + row_e2 < 0.0f) {
+				continue;
+			}
+
+			float depth = p_triangle.depth_a * px + row_depth;
+			if (!p_orthogonal) {
+				depth = 1.0f / depth;
+			}
+			row[x] = MIN(row[x], depth);
+		}
+	}
+#endif
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::_rasterize_tile_thread(uint32_t p_tile, RasterThreadData *p_data) {
+	alignas(16) float tile_depth[TILE_WIDTH * TILE_HEIGHT];
+	for (int i = 0; i < TILE_WIDTH * TILE_HEIGHT; i++) {
+		tile_depth[i] = FLT_MAX;
+	}
+
+	int tile_x = (p_tile % tiles_size.x) * TILE_WIDTH;
+	int tile_y = (p_tile / tiles_size.x) * TILE_HEIGHT;
+	uint32_t tile_count = tiles_size.x * tiles_size.y;
+
+	for (uint32_t job = 0; job < p_data->job_count; job++) {
+		const LocalVector<uint32_t> &bin = bins[job * tile_count + p_tile];
+		for (uint32_t i = 0; i < bin.size(); i++) {
+			_rasterize_triangle(triangles[bin[i]], tile_x, tile_y, p_data->cam_orthogonal, tile_depth);
+		}
+	}
+
+	// Convert view depth to the distance from the near plane along the pixel ray, which is what HZBuffer::is_occluded() expects.
+	int w = sizes[0].x;
+	int h = sizes[0].y;
+	const real_t(*m)[4] = p_data->cam_projection.matrix;
+
+	for (int y = tile_y; y < MIN(tile_y + TILE_HEIGHT, h); y++) {
+		float v = (y + 0.5f) / h * 2.0f - 1.0f;
+		float ray_y = (v + m[2][1]) / m[1][1];
+
+		for (int x = tile_x; x < MIN(tile_x + TILE_WIDTH, w); x++) {
+			float depth = tile_depth[(y - tile_y) * TILE_WIDTH + (x - tile_x)];
+			float distance = debug_tex_range;
+
+			if (depth != FLT_MAX) {
+				distance = MAX(depth - p_data->z_near, 0.0f);
+				if (!p_data->cam_orthogonal) {
+					float u = (x + 0.5f) / w * 2.0f - 1.0f;
+					float ray_x = (u + m[2][0]) / m[0][0];
+					distance *= Math::sqrt(1.0f + ray_x * ray_x + ray_y * ray_y);
+				}
+				distance = MIN(distance, debug_tex_range);
+			}
+
+			mips[0][y * w + x] = distance;
+		}
+	}
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::rasterize(const LocalVector<Vector3> &p_vertices, const LocalVector<uint32_t> &p_indices, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, ThreadWorkPool &p_thread_pool) {
+	if (is_empty()) {
+		return;
+	}
+
+	RasterThreadData td;
+	td.vertices = p_vertices.ptr();
+	td.indices = p_indices.ptr();
+	td.triangle_count = p_indices.size() / 3;
+	td.job_count = (td.triangle_count + TRIANGLES_PER_JOB - 1) / TRIANGLES_PER_JOB;
+	td.cam_inv_transform = p_cam_transform.affine_inverse();
+	td.cam_projection = p_cam_projection;
+	td.cam_orthogonal = p_cam_orthogonal;
+	td.z_near = p_cam_projection.get_z_near();
+	td.z_far = p_cam_projection.get_z_far();
+
+	debug_tex_range = td.z_far * 1.05f;
+
+	uint32_t tile_count = tiles_size.x * tiles_size.y;
+	if (bins.size() < td.job_count * tile_count) {
+		bins.resize(td.job_count * tile_count);
+	}
+	triangles.resize(td.triangle_count * 2);
+
+	p_thread_pool.do_work(td.job_count, this, &RasterHZBuffer::_setup_triangles_thread, &td);
+	p_thread_pool.do_work(tile_count, this, &RasterHZBuffer::_rasterize_tile_thread, &td);
+
+	update_mips();
+}
+
+////////////////////////////////////////////////////////
+
+bool RendererSceneOcclusionCullRaster::is_occluder(RID p_rid) {
+	return occluder_owner.owns(p_rid);
+}
+
+RID RendererSceneOcclusionCullRaster::occluder_allocate() {
+	return occluder_owner.allocate_rid();
+}
+
+void RendererSceneOcclusionCullRaster::occluder_initialize(RID p_occluder) {
+	Occluder *occluder = memnew(Occluder);
+	occluder_owner.initialize_rid(p_occluder, occluder);
+}
+
+void RendererSceneOcclusionCullRaster::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.getornull(p_occluder);
+	ERR_FAIL_COND(!occluder);
+
+	occluder->vertices = p_vertices;
+	occluder->indices = p_indices;
+
+	for (Set<InstanceID>::Element *E = occluder->users.front(); E; E = E->next()) {
+		Scenario *scenario = scenarios.getptr(E->get().scenario);
+		ERR_CONTINUE(!scenario);
+		_mark_instance_dirty(*scenario, E->get().instance);
+	}
+}
+
+void RendererSceneOcclusionCullRaster::free_occluder(RID p_occluder) {
+	Occluder *occluder = occluder_owner.getornull(p_occluder);
+	ERR_FAIL_COND(!occluder);
+	memdelete(occluder);
+	occluder_owner.free(p_occluder);
+}
+
+////////////////////////////////////////////////////////
+
+void RendererSceneOcclusionCullRaster::_mark_instance_dirty(Scenario &p_scenario, RID p_instance) {
+	OccluderInstance *instance = p_scenario.instances.getptr(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	if (!instance->dirty) {
+		instance->dirty = true;
+		p_scenario.dirty_instances_array.push_back(p_instance);
+	}
+	p_scenario.dirty = true;
+}
+
+void RendererSceneOcclusionCullRaster::add_scenario(RID p_scenario) {
+	if (!scenarios.has(p_scenario)) {
+		scenarios[p_scenario] = Scenario();
+	}
+}
+
+void RendererSceneOcclusionCullRaster::remove_scenario(RID p_scenario) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_COND(!scenario);
+
+	const RID *instance_rid = nullptr;
+	while ((instance_rid = scenario->instances.next(instance_rid))) {
+		Occluder *occluder = occluder_owner.getornull(scenario->instances[*instance_rid].occluder);
+		if (occluder) {
+			occluder->users.erase(InstanceID(p_scenario, *instance_rid));
+		}
+	}
+
+	scenarios.erase(p_scenario);
+}
+
+void RendererSceneOcclusionCullRaster::scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform &p_xform, bool p_enabled) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_COND(!scenario);
+
+	if (!scenario->instances.has(p_instance)) {
+		scenario->instances[p_instance] = OccluderInstance();
+		scenario->dirty_instances_array.push_back(p_instance);
+		scenario->dirty = true;
+	}
+
+	OccluderInstance &instance = scenario->instances[p_instance];
+
+	bool changed = false;
+
+	if (instance.occluder != p_occluder) {
+		Occluder *old_occluder = occluder_owner.getornull(instance.occluder);
+		if (old_occluder) {
+			old_occluder->users.erase(InstanceID(p_scenario, p_instance));
+		}
+
+		instance.occluder = p_occluder;
+
+		if (p_occluder.is_valid()) {
+			Occluder *occluder = occluder_owner.getornull(p_occluder);
+			ERR_FAIL_COND(!occluder);
+			occluder->users.insert(InstanceID(p_scenario, p_instance));
+		}
+		changed = true;
+	}
+
+	if (instance.xform != p_xform) {
+		instance.xform = p_xform;
+		changed = true;
+	}
+
+	if (instance.enabled != p_enabled) {
+		instance.enabled = p_enabled;
+		scenario->dirty = true; // The flattened geometry needs a rebuild, but the instance doesn't need an update.
+	}
+
+	if (changed) {
+		_mark_instance_dirty(*scenario, p_instance);
+	}
+}
+
+void RendererSceneOcclusionCullRaster::scenario_remove_instance(RID p_scenario, RID p_instance) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_COND(!scenario);
+
+	OccluderInstance *instance = scenario->instances.getptr(p_instance);
+	if (!instance) {
+		return;
+	}
+
+	Occluder *occluder = occluder_owner.getornull(instance->occluder);
+	if (occluder) {
+		occluder->users.erase(InstanceID(p_scenario, p_instance));
+	}
+
+	scenario->instances.erase(p_instance);
+	scenario->dirty = true;
+}
+
+void RendererSceneOcclusionCullRaster::Scenario::_update_dirty_instance(uint32_t p_idx, RID *p_instances) {
+	OccluderInstance *occ_inst = instances.getptr(p_instances[p_idx]);
+	if (!occ_inst) {
+		return; // Removed after being marked dirty.
+	}
+
+	occ_inst->dirty = false;
+
+	Occluder *occ = raster_singleton->occluder_owner.getornull(occ_inst->occluder);
+	if (!occ) {
+		occ_inst->xformed_vertices.clear();
+		return;
+	}
+
+	int vertex_count = occ->vertices.size();
+	occ_inst->xformed_vertices.resize(vertex_count);
+
+	const Vector3 *read = occ->vertices.ptr();
+	Vector3 *write = occ_inst->xformed_vertices.ptr();
+	for (int i = 0; i < vertex_count; i++) {
+		write[i] = occ_inst->xform.xform(read[i]);
+	}
+}
+
+void RendererSceneOcclusionCullRaster::Scenario::update(ThreadWorkPool &p_thread_pool) {
+	if (!dirty) {
+		return;
+	}
+
+	if (dirty_instances_array.size() / p_thread_pool.get_thread_count() > 128) {
+		p_thread_pool.do_work(dirty_instances_array.size(), this, &Scenario::_update_dirty_instance, dirty_instances_array.ptr());
+	} else {
+		for (uint32_t i = 0; i < dirty_instances_array.size(); i++) {
+			_update_dirty_instance(i, dirty_instances_array.ptr());
+		}
+	}
+	dirty_instances_array.clear();
+
+	vertices.clear();
+	indices.clear();
+
+	const RID *inst_rid = nullptr;
+	while ((inst_rid = instances.next(inst_rid))) {
+		const OccluderInstance &occ_inst = instances[*inst_rid];
+		Occluder *occ = raster_singleton->occluder_owner.getornull(occ_inst.occluder);
+
+		if (!occ || !occ_inst.enabled) {
+			continue;
+		}
+
+		uint32_t vertex_offset = vertices.size();
+		uint32_t vertex_count = occ_inst.xformed_vertices.size();
+		for (uint32_t i = 0; i < vertex_count; i++) {
+			vertices.push_back(occ_inst.xformed_vertices[i]);
+		}
+
+		int index_count = occ->indices.size() - occ->indices.size() % 3;
+		const int32_t *read = occ->indices.ptr();
+		for (int i = 0; i < index_count; i += 3) {
+			if ((uint32_t)read[i] >= vertex_count || (uint32_t)read[i + 1] >= vertex_count || (uint32_t)read[i + 2] >= vertex_count) {
+				continue;
+			}
+			indices.push_back(vertex_offset + read[i]);
+			indices.push_back(vertex_offset + read[i + 1]);
+			indices.push_back(vertex_offset + read[i + 2]);
+		}
+	}
+
+	dirty = false;
+}
+
+////////////////////////////////////////////////////////
+
+void RendererSceneOcclusionCullRaster::add_buffer(RID p_buffer) {
+	ERR_FAIL_COND(buffers.has(p_buffer));
+	buffers[p_buffer] = RasterHZBuffer();
+}
+
+void RendererSceneOcclusionCullRaster::remove_buffer(RID p_buffer) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers.erase(p_buffer);
+}
+
+void RendererSceneOcclusionCullRaster::buffer_set_scenario(RID p_buffer, RID p_scenario) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	ERR_FAIL_COND(p_scenario.is_valid() && !scenarios.has(p_scenario));
+	buffers[p_buffer].scenario_rid = p_scenario;
+}
+
+void RendererSceneOcclusionCullRaster::buffer_set_size(RID p_buffer, const Vector2i &p_size) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers[p_buffer].resize(p_size);
+}
+
+void RendererSceneOcclusionCullRaster::buffer_update(RID p_buffer, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, ThreadWorkPool &p_thread_pool) {
+	RasterHZBuffer *buffer = buffers.getptr(p_buffer);
+	if (!buffer || buffer->is_empty()) {
+		return;
+	}
+
+	Scenario *scenario = scenarios.getptr(buffer->scenario_rid);
+	if (!scenario) {
+		return;
+	}
+
+	scenario->update(p_thread_pool);
+	buffer->rasterize(scenario->vertices, scenario->indices, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_thread_pool);
+}
+
+RendererSceneOcclusionCullRaster::HZBuffer *RendererSceneOcclusionCullRaster::buffer_get_ptr(RID p_buffer) {
+	return buffers.getptr(p_buffer);
+}
+
+RID RendererSceneOcclusionCullRaster::buffer_get_debug_texture(RID p_buffer) {
+	ERR_FAIL_COND_V(!buffers.has(p_buffer), RID());
+	return buffers[p_buffer].get_debug_texture();
+}
+
+RendererSceneOcclusionCullRaster::RendererSceneOcclusionCullRaster() {
+	raster_singleton = this;
+}
+
+RendererSceneOcclusionCullRaster::~RendererSceneOcclusionCullRaster() {
+	raster_singleton = nullptr;
+}
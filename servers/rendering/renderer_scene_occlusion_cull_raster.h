@@ -0,0 +1,178 @@
+/*************************************************************************/
+/*  renderer_scene_occlusion_cull_raster.h                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RENDERER_SCENE_OCCLUSION_CULL_RASTER_H
+#define RENDERER_SCENE_OCCLUSION_CULL_RASTER_H
+
+#include "core/math/camera_matrix.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/rid_owner.h"
+#include "core/templates/set.h"
+#include "core/templates/thread_work_pool.h"
+#include "servers/rendering/renderer_scene_occlusion_cull.h"
+
+// Software occlusion culling backend. Occluder triangles are rasterized on the CPU
+// into the depth buffer (binned into screen tiles and rasterized in parallel), so
+// unlike the raycast backend it does not depend on any third-party library.
+class RendererSceneOcclusionCullRaster : public RendererSceneOcclusionCull {
+public:
+	static const int TILE_WIDTH = 32;
+	static const int TILE_HEIGHT = 8;
+	static const uint32_t TRIANGLES_PER_JOB = 256;
+
+	struct Triangle {
+		// Edge functions, positive inside the triangle: e = a * x + b * y + c.
+		float edge_a[3];
+		float edge_b[3];
+		float edge_c[3];
+
+		// Screen-space plane of the interpolated depth value:
+		// 1 / view depth for perspective projections, view depth for orthogonal ones.
+		float depth_a;
+		float depth_b;
+		float depth_c;
+
+		int min_x;
+		int min_y;
+		int max_x;
+		int max_y;
+	};
+
+	class RasterHZBuffer : public HZBuffer {
+	private:
+		struct RasterThreadData {
+			const Vector3 *vertices = nullptr;
+			const uint32_t *indices = nullptr;
+			uint32_t triangle_count = 0;
+			uint32_t job_count = 0;
+
+			Transform cam_inv_transform;
+			CameraMatrix cam_projection;
+			bool cam_orthogonal = false;
+			float z_near = 0.0f;
+			float z_far = 0.0f;
+		};
+
+		Size2i tiles_size;
+		LocalVector<Triangle> triangles; // Two slots per occluder triangle, near plane clipping can split it.
+		LocalVector<LocalVector<uint32_t>> bins; // Triangle indices, indexed by [job * tile_count + tile].
+
+		bool _setup_triangle(const Vector3 *p_view, const RasterThreadData *p_data, Triangle &r_triangle) const;
+		void _rasterize_triangle(const Triangle &p_triangle, int p_tile_x, int p_tile_y, bool p_orthogonal, float *r_tile_depth) const;
+
+		void _setup_triangles_thread(uint32_t p_job, RasterThreadData *p_data);
+		void _rasterize_tile_thread(uint32_t p_tile, RasterThreadData *p_data);
+
+	public:
+		RID scenario_rid;
+
+		virtual void clear() override;
+		virtual void resize(const Size2i &p_size) override;
+
+		void rasterize(const LocalVector<Vector3> &p_vertices, const LocalVector<uint32_t> &p_indices, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, ThreadWorkPool &p_thread_pool);
+	};
+
+private:
+	struct InstanceID {
+		RID scenario;
+		RID instance;
+
+		bool operator<(const InstanceID &rhs) const {
+			if (instance == rhs.instance) {
+				return rhs.scenario < scenario;
+			}
+			return instance < rhs.instance;
+		}
+
+		InstanceID() {}
+		InstanceID(RID s, RID i) :
+				scenario(s), instance(i) {}
+	};
+
+	struct Occluder {
+		PackedVector3Array vertices;
+		PackedInt32Array indices;
+		Set<InstanceID> users;
+	};
+
+	struct OccluderInstance {
+		RID occluder;
+		LocalVector<Vector3> xformed_vertices;
+		Transform xform;
+		bool enabled = true;
+		bool dirty = true;
+	};
+
+	struct Scenario {
+		HashMap<RID, OccluderInstance> instances;
+		LocalVector<RID> dirty_instances_array;
+		bool dirty = false;
+
+		// All enabled occluders, flattened in world space.
+		LocalVector<Vector3> vertices;
+		LocalVector<uint32_t> indices;
+
+		void _update_dirty_instance(uint32_t p_idx, RID *p_instances);
+		void update(ThreadWorkPool &p_thread_pool);
+	};
+
+	static RendererSceneOcclusionCullRaster *raster_singleton;
+
+	RID_PtrOwner<Occluder> occluder_owner;
+	HashMap<RID, Scenario> scenarios;
+	HashMap<RID, RasterHZBuffer> buffers;
+
+	void _mark_instance_dirty(Scenario &p_scenario, RID p_instance);
+
+public:
+	virtual bool is_occluder(RID p_rid) override;
+	virtual RID occluder_allocate() override;
+	virtual void occluder_initialize(RID p_occluder) override;
+	virtual void occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) override;
+	virtual void free_occluder(RID p_occluder) override;
+
+	virtual void add_scenario(RID p_scenario) override;
+	virtual void remove_scenario(RID p_scenario) override;
+	virtual void scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform &p_xform, bool p_enabled) override;
+	virtual void scenario_remove_instance(RID p_scenario, RID p_instance) override;
+
+	virtual void add_buffer(RID p_buffer) override;
+	virtual void remove_buffer(RID p_buffer) override;
+	virtual HZBuffer *buffer_get_ptr(RID p_buffer) override;
+	virtual void buffer_set_scenario(RID p_buffer, RID p_scenario) override;
+	virtual void buffer_set_size(RID p_buffer, const Vector2i &p_size) override;
+	virtual void buffer_update(RID p_buffer, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, ThreadWorkPool &p_thread_pool) override;
+	virtual RID buffer_get_debug_texture(RID p_buffer) override;
+
+	RendererSceneOcclusionCullRaster();
+	~RendererSceneOcclusionCullRaster();
+};
+
+#endif // RENDERER_SCENE_OCCLUSION_CULL_RASTER_H
@@ -86,6 +86,7 @@ public:
 	virtual int sdfgi_get_pending_region_count(RID p_render_buffers) const = 0;
 	virtual AABB sdfgi_get_pending_region_bounds(RID p_render_buffers, int p_region) const = 0;
 	virtual uint32_t sdfgi_get_pending_region_cascade(RID p_render_buffers, int p_region) const = 0;
+	virtual void sdfgi_mark_static_dirty(RID p_render_buffers, const AABB &p_aabb) = 0;
 
 	/* SKY API */
 
@@ -198,6 +199,10 @@ public:
 		RID light;
 		int pass = 0;
 		PagedArray<GeometryInstance *> instances;
+		// When static_version is not zero, instances only has the dynamic casters and
+		// static_instances is drawn to a cached layer, redrawn whenever the version changes.
+		PagedArray<GeometryInstance *> static_instances;
+		uint64_t static_version = 0;
 	};
 
 	struct RenderSDFGIData {
@@ -63,6 +63,102 @@ RendererStorage::Dependency::~Dependency() {
 #endif
 }
 
+void RendererStorage::MultiMeshChunks::clear() {
+	instances.clear();
+	aabbs.clear();
+	visible.clear();
+	data.clear();
+	visible_instances = 0;
+}
+
+void RendererStorage::MultiMeshChunks::update(const float *p_data, uint32_t p_stride, uint32_t p_instances, const AABB &p_aabb, const AABB &p_mesh_aabb) {
+	instances.clear();
+	aabbs.clear();
+	visible.clear();
+
+	if (size == 0 || p_instances == 0) {
+		return;
+	}
+
+	// Sort instances along a Morton curve of their origins, so consecutive
+	// instances (and thus chunks) stay close to each other.
+	Vector3 from = p_aabb.position;
+	Vector3 scale;
+	for (int i = 0; i < 3; i++) {
+		scale[i] = p_aabb.size[i] > CMP_EPSILON ? 1023.0 / p_aabb.size[i] : 0.0;
+	}
+
+	LocalVector<uint64_t> sort_keys;
+	sort_keys.resize(p_instances);
+	for (uint32_t i = 0; i < p_instances; i++) {
+		const float *d = p_data + p_stride * i;
+		Vector3 origin(d[3], d[7], d[11]);
+		uint64_t code = 0;
+		for (int j = 0; j < 3; j++) {
+			uint32_t q = CLAMP(int((origin[j] - from[j]) * scale[j]), 0, 1023);
+			for (int k = 0; k < 10; k++) {
+				code |= uint64_t((q >> k) & 1) << (k * 3 + j);
+			}
+		}
+		sort_keys[i] = (code << 32) | uint64_t(i);
+	}
+	sort_keys.sort();
+
+	uint32_t chunk_count = (p_instances + size - 1) / size;
+	instances.resize(p_instances);
+	aabbs.resize(chunk_count);
+	visible.resize(chunk_count);
+
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		uint32_t to = MIN((i + 1) * size, p_instances);
+		AABB aabb;
+		for (uint32_t j = i * size; j < to; j++) {
+			uint32_t index = uint32_t(sort_keys[j] & 0xFFFFFFFF);
+			instances[j] = index;
+
+			const float *d = p_data + p_stride * index;
+			Transform t;
+			t.basis.elements[0] = Vector3(d[0], d[1], d[2]);
+			t.basis.elements[1] = Vector3(d[4], d[5], d[6]);
+			t.basis.elements[2] = Vector3(d[8], d[9], d[10]);
+			t.origin = Vector3(d[3], d[7], d[11]);
+
+			if (j == i * size) {
+				aabb = t.xform(p_mesh_aabb);
+			} else {
+				aabb.merge_with(t.xform(p_mesh_aabb));
+			}
+		}
+		aabbs[i] = aabb;
+		visible[i] = 1; //until culled
+	}
+}
+
+bool RendererStorage::MultiMeshChunks::set_visible(const uint8_t *p_visible) {
+	if (memcmp(visible.ptr(), p_visible, visible.size()) == 0) {
+		return false;
+	}
+	memcpy(visible.ptr(), p_visible, visible.size());
+	return true;
+}
+
+void RendererStorage::MultiMeshChunks::pack(const float *p_data, uint32_t p_stride) {
+	data.resize(instances.size() * p_stride);
+	float *w = data.ptr();
+
+	visible_instances = 0;
+	for (uint32_t i = 0; i < visible.size(); i++) {
+		if (!visible[i]) {
+			continue;
+		}
+		uint32_t to = MIN((i + 1) * size, instances.size());
+		for (uint32_t j = i * size; j < to; j++) {
+			memcpy(w + visible_instances * p_stride, p_data + instances[j] * p_stride, p_stride * sizeof(float));
+			visible_instances++;
+		}
+	}
+}
+
 RendererStorage::RendererStorage() {
 	base_singleton = this;
 }
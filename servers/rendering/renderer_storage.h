@@ -31,6 +31,7 @@
 #ifndef RENDERINGSERVERSTORAGE_H
 #define RENDERINGSERVERSTORAGE_H
 
+#include "core/templates/local_vector.h"
 #include "servers/rendering_server.h"
 
 class RendererStorage {
@@ -65,6 +66,23 @@ protected:
 		Map<DependencyTracker *, uint32_t> instances;
 	};
 
+	// Instances of a chunked multimesh, grouped spatially so only the chunks
+	// visible in the current render are packed for drawing.
+	struct MultiMeshChunks {
+		uint32_t size = 0; // instances per chunk, 0 when not chunked
+		LocalVector<uint32_t> instances; // instance indices, in chunk order
+		LocalVector<AABB> aabbs; // local space
+		LocalVector<uint8_t> visible;
+		LocalVector<float> data; // instance data of the visible chunks, packed
+		uint32_t visible_instances = 0;
+
+		void clear();
+		// Takes 3D transforms, p_aabb must enclose the instances.
+		void update(const float *p_data, uint32_t p_stride, uint32_t p_instances, const AABB &p_aabb, const AABB &p_mesh_aabb);
+		bool set_visible(const uint8_t *p_visible); // Returns false if the same chunks were visible.
+		void pack(const float *p_data, uint32_t p_stride);
+	};
+
 public:
 	struct DependencyTracker {
 		void *userdata = nullptr;
@@ -153,6 +171,7 @@ public:
 	virtual void texture_set_detect_3d_callback(RID p_texture, RS::TextureDetectCallback p_callback, void *p_userdata) = 0;
 	virtual void texture_set_detect_normal_callback(RID p_texture, RS::TextureDetectCallback p_callback, void *p_userdata) = 0;
 	virtual void texture_set_detect_roughness_callback(RID p_texture, RS::TextureDetectRoughnessCallback p_callback, void *p_userdata) = 0;
+	virtual void texture_set_stream_callback(RID p_texture, const Size2i &p_full_size, RS::TextureStreamCallback p_callback, ObjectID p_owner) = 0;
 
 	virtual void texture_debug_usage(List<RS::TextureInfo> *r_info) = 0;
 
@@ -215,6 +234,8 @@ public:
 
 	virtual void material_update_dependency(RID p_material, DependencyTracker *p_instance) = 0;
 
+	virtual void material_request_texture_stream_size(RID p_material, float p_pixel_size) = 0;
+
 	/* MESH API */
 
 	virtual RID mesh_allocate() = 0;
@@ -286,6 +307,12 @@ public:
 	virtual void multimesh_set_visible_instances(RID p_multimesh, int p_visible) = 0;
 	virtual int multimesh_get_visible_instances(RID p_multimesh) const = 0;
 
+	virtual void multimesh_set_chunk_size(RID p_multimesh, int p_size) = 0;
+	virtual int multimesh_get_chunk_size(RID p_multimesh) const = 0;
+
+	virtual const AABB *multimesh_get_chunk_aabbs(RID p_multimesh, uint32_t &r_chunk_count) const = 0; // Local space, nullptr when not chunked.
+	virtual void multimesh_set_visible_chunks(RID p_multimesh, const uint8_t *p_visible) = 0;
+
 	virtual AABB multimesh_get_aabb(RID p_multimesh) const = 0;
 
 	/* IMMEDIATE API */
@@ -315,6 +342,7 @@ public:
 	virtual int skeleton_get_bone_count(RID p_skeleton) const = 0;
 	virtual void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform) = 0;
 	virtual Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const = 0;
+	virtual void skeleton_set_bone_transforms(RID p_skeleton, const PackedFloat32Array &p_transforms) = 0;
 	virtual void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform) = 0;
 	virtual Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const = 0;
 	virtual void skeleton_set_base_transform_2d(RID p_skeleton, const Transform2D &p_base_transform) = 0;
@@ -610,6 +638,7 @@ public:
 	virtual bool has_os_feature(const String &p_feature) const = 0;
 
 	virtual void update_dirty_resources() = 0;
+	virtual void update_texture_streaming() = 0;
 
 	virtual void set_debug_generate_wireframes(bool p_generate) = 0;
 
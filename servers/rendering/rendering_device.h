@@ -1010,6 +1010,9 @@ public:
 	virtual void draw_list_set_push_constant(DrawListID p_list, const void *p_data, uint32_t p_data_size) = 0;
 
 	virtual void draw_list_draw(DrawListID p_list, bool p_use_indices, uint32_t p_instances = 1, uint32_t p_procedural_vertices = 0) = 0;
+	// Takes the draw parameters from a storage buffer created with STORAGE_BUFFER_USAGE_DISPATCH_INDIRECT, laid out as the
+	// Vulkan indexed or non indexed indirect commands. A stride of zero means the commands are tightly packed.
+	virtual void draw_list_draw_indirect(DrawListID p_list, bool p_use_indices, RID p_buffer, uint32_t p_offset = 0, uint32_t p_draw_count = 1, uint32_t p_stride = 0) = 0;
 
 	virtual void draw_list_enable_scissor(DrawListID p_list, const Rect2 &p_rect) = 0;
 	virtual void draw_list_disable_scissor(DrawListID p_list) = 0;
@@ -97,6 +97,11 @@ void RenderingServerDefault::_draw(bool p_swap_buffers, double frame_step) {
 
 	changes = 0;
 
+	CommandQueueMT::Stats stats = command_queue.get_stats();
+	commands_in_frame = stats.commands - command_queue_stats.commands;
+	coalesced_commands_in_frame = stats.coalesced - command_queue_stats.coalesced;
+	command_queue_stats = stats;
+
 	RSG::rasterizer->begin_frame(frame_step);
 
 	TIMESTAMP_BEGIN()
@@ -114,6 +119,8 @@ void RenderingServerDefault::_draw(bool p_swap_buffers, double frame_step) {
 	RSG::viewport->draw_viewports();
 	RSG::canvas_render->update();
 
+	RSG::storage->update_texture_streaming(); //after all viewports were drawn and requested the textures they need
+
 	_draw_margins();
 	RSG::rasterizer->end_frame(p_swap_buffers);
 
@@ -258,7 +265,14 @@ void RenderingServerDefault::finish() {
 /* STATUS INFORMATION */
 
 uint64_t RenderingServerDefault::get_render_info(RenderInfo p_info) {
-	return RSG::storage->get_render_info(p_info);
+	switch (p_info) {
+		case INFO_COMMANDS_IN_FRAME:
+			return commands_in_frame;
+		case INFO_COALESCED_COMMANDS_IN_FRAME:
+			return coalesced_commands_in_frame;
+		default:
+			return RSG::storage->get_render_info(p_info);
+	}
 }
 
 String RenderingServerDefault::get_video_adapter_name() const {
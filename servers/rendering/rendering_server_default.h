@@ -84,6 +84,9 @@ class RenderingServerDefault : public RenderingServer {
 	uint32_t print_frame_profile_frame_count = 0;
 
 	mutable CommandQueueMT command_queue;
+	CommandQueueMT::Stats command_queue_stats; // As of the start of the last frame.
+	uint64_t commands_in_frame = 0;
+	uint64_t coalesced_commands_in_frame = 0;
 
 	static void _thread_callback(void *_instance);
 	void _thread_loop();
@@ -219,6 +222,7 @@ public:
 	FUNC3(texture_set_detect_3d_callback, RID, TextureDetectCallback, void *)
 	FUNC3(texture_set_detect_normal_callback, RID, TextureDetectCallback, void *)
 	FUNC3(texture_set_detect_roughness_callback, RID, TextureDetectRoughnessCallback, void *)
+	FUNC4(texture_set_stream_callback, RID, const Size2i &, TextureStreamCallback, ObjectID)
 
 	FUNC2(texture_set_path, RID, const String &)
 	FUNC1RC(String, texture_get_path, RID)
@@ -333,6 +337,9 @@ public:
 	FUNC2(multimesh_set_visible_instances, RID, int)
 	FUNC1RC(int, multimesh_get_visible_instances, RID)
 
+	FUNC2(multimesh_set_chunk_size, RID, int)
+	FUNC1RC(int, multimesh_get_chunk_size, RID)
+
 	/* IMMEDIATE API */
 
 	FUNCRIDSPLIT(immediate)
@@ -355,6 +362,7 @@ public:
 	FUNC1RC(int, skeleton_get_bone_count, RID)
 	FUNC3(skeleton_bone_set_transform, RID, int, const Transform &)
 	FUNC2RC(Transform, skeleton_bone_get_transform, RID, int)
+	FUNC2(skeleton_set_bone_transforms, RID, const PackedFloat32Array &)
 	FUNC3(skeleton_bone_set_transform_2d, RID, int, const Transform2D &)
 	FUNC2RC(Transform2D, skeleton_bone_get_transform_2d, RID, int)
 	FUNC2(skeleton_set_base_transform_2d, RID, const Transform2D &)
@@ -714,7 +722,8 @@ public:
 	FUNC2(instance_set_base, RID, RID)
 	FUNC2(instance_set_scenario, RID, RID)
 	FUNC2(instance_set_layer_mask, RID, uint32_t)
-	FUNC2(instance_set_transform, RID, const Transform &)
+	FUNC2COALESCE(instance_set_transform, RID, const Transform &)
+	FUNC2(instances_set_transforms, const Vector<RID> &, const PackedFloat32Array &)
 	FUNC2(instance_attach_object_instance_id, RID, ObjectID)
 	FUNC3(instance_set_blend_shape_weight, RID, int, float)
 	FUNC3(instance_set_surface_override_material, RID, int, RID)
@@ -782,7 +791,8 @@ public:
 
 	FUNC2(canvas_item_set_update_when_visible, RID, bool)
 
-	FUNC2(canvas_item_set_transform, RID, const Transform2D &)
+	FUNC2COALESCE(canvas_item_set_transform, RID, const Transform2D &)
+	FUNC2(canvas_items_set_transforms, const Vector<RID> &, const PackedFloat32Array &)
 	FUNC2(canvas_item_set_clip, RID, bool)
 	FUNC2(canvas_item_set_distance_field_mode, RID, bool)
 	FUNC3(canvas_item_set_custom_rect, RID, bool, const Rect2 &)
@@ -104,6 +104,24 @@ Array RenderingServer::_instances_cull_convex_bind(const Array &p_convex, RID p_
 	return to_array(ids);
 }
 
+static Vector<RID> to_rid_vector(const Array &p_array) {
+	Vector<RID> rids;
+	rids.resize(p_array.size());
+	RID *w = rids.ptrw();
+	for (int i = 0; i < p_array.size(); ++i) {
+		w[i] = p_array[i];
+	}
+	return rids;
+}
+
+void RenderingServer::_instances_set_transforms_bind(const Array &p_instances, const PackedFloat32Array &p_transforms) {
+	instances_set_transforms(to_rid_vector(p_instances), p_transforms);
+}
+
+void RenderingServer::_canvas_items_set_transforms_bind(const Array &p_items, const PackedFloat32Array &p_transforms) {
+	canvas_items_set_transforms(to_rid_vector(p_items), p_transforms);
+}
+
 RID RenderingServer::get_test_texture() {
 	if (test_texture.is_valid()) {
 		return test_texture;
@@ -1506,6 +1524,8 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("multimesh_instance_get_custom_data", "multimesh", "index"), &RenderingServer::multimesh_instance_get_custom_data);
 	ClassDB::bind_method(D_METHOD("multimesh_set_visible_instances", "multimesh", "visible"), &RenderingServer::multimesh_set_visible_instances);
 	ClassDB::bind_method(D_METHOD("multimesh_get_visible_instances", "multimesh"), &RenderingServer::multimesh_get_visible_instances);
+	ClassDB::bind_method(D_METHOD("multimesh_set_chunk_size", "multimesh", "size"), &RenderingServer::multimesh_set_chunk_size);
+	ClassDB::bind_method(D_METHOD("multimesh_get_chunk_size", "multimesh"), &RenderingServer::multimesh_get_chunk_size);
 	ClassDB::bind_method(D_METHOD("multimesh_set_buffer", "multimesh", "buffer"), &RenderingServer::multimesh_set_buffer);
 	ClassDB::bind_method(D_METHOD("multimesh_get_buffer", "multimesh"), &RenderingServer::multimesh_get_buffer);
 #ifndef _3D_DISABLED
@@ -1529,6 +1549,7 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("skeleton_get_bone_count", "skeleton"), &RenderingServer::skeleton_get_bone_count);
 	ClassDB::bind_method(D_METHOD("skeleton_bone_set_transform", "skeleton", "bone", "transform"), &RenderingServer::skeleton_bone_set_transform);
 	ClassDB::bind_method(D_METHOD("skeleton_bone_get_transform", "skeleton", "bone"), &RenderingServer::skeleton_bone_get_transform);
+	ClassDB::bind_method(D_METHOD("skeleton_set_bone_transforms", "skeleton", "transforms"), &RenderingServer::skeleton_set_bone_transforms);
 	ClassDB::bind_method(D_METHOD("skeleton_bone_set_transform_2d", "skeleton", "bone", "transform"), &RenderingServer::skeleton_bone_set_transform_2d);
 	ClassDB::bind_method(D_METHOD("skeleton_bone_get_transform_2d", "skeleton", "bone"), &RenderingServer::skeleton_bone_get_transform_2d);
 
@@ -1714,6 +1735,7 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("instance_set_scenario", "instance", "scenario"), &RenderingServer::instance_set_scenario);
 	ClassDB::bind_method(D_METHOD("instance_set_layer_mask", "instance", "mask"), &RenderingServer::instance_set_layer_mask);
 	ClassDB::bind_method(D_METHOD("instance_set_transform", "instance", "transform"), &RenderingServer::instance_set_transform);
+	ClassDB::bind_method(D_METHOD("instances_set_transforms", "instances", "transforms"), &RenderingServer::_instances_set_transforms_bind);
 	ClassDB::bind_method(D_METHOD("instance_attach_object_instance_id", "instance", "id"), &RenderingServer::instance_attach_object_instance_id);
 	ClassDB::bind_method(D_METHOD("instance_set_blend_shape_weight", "instance", "shape", "weight"), &RenderingServer::instance_set_blend_shape_weight);
 	ClassDB::bind_method(D_METHOD("instance_set_surface_override_material", "instance", "surface", "material"), &RenderingServer::instance_set_surface_override_material);
@@ -1746,6 +1768,7 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("canvas_item_set_visible", "item", "visible"), &RenderingServer::canvas_item_set_visible);
 	ClassDB::bind_method(D_METHOD("canvas_item_set_light_mask", "item", "mask"), &RenderingServer::canvas_item_set_light_mask);
 	ClassDB::bind_method(D_METHOD("canvas_item_set_transform", "item", "transform"), &RenderingServer::canvas_item_set_transform);
+	ClassDB::bind_method(D_METHOD("canvas_items_set_transforms", "items", "transforms"), &RenderingServer::_canvas_items_set_transforms_bind);
 	ClassDB::bind_method(D_METHOD("canvas_item_set_clip", "item", "clip"), &RenderingServer::canvas_item_set_clip);
 	ClassDB::bind_method(D_METHOD("canvas_item_set_distance_field_mode", "item", "enabled"), &RenderingServer::canvas_item_set_distance_field_mode);
 	ClassDB::bind_method(D_METHOD("canvas_item_set_custom_rect", "item", "use_custom_rect", "rect"), &RenderingServer::canvas_item_set_custom_rect, DEFVAL(Rect2()));
@@ -2213,6 +2236,15 @@ void RenderingServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_VIDEO_MEM_USED);
 	BIND_ENUM_CONSTANT(INFO_TEXTURE_MEM_USED);
 	BIND_ENUM_CONSTANT(INFO_VERTEX_MEM_USED);
+	BIND_ENUM_CONSTANT(INFO_TEXTURE_STREAM_MEM_USED);
+	BIND_ENUM_CONSTANT(INFO_TEXTURE_STREAM_LOADS);
+	BIND_ENUM_CONSTANT(INFO_TEXTURE_STREAM_EVICTIONS);
+	BIND_ENUM_CONSTANT(INFO_TRANSIENT_MEM_REQUESTED);
+	BIND_ENUM_CONSTANT(INFO_TRANSIENT_MEM_USED);
+	BIND_ENUM_CONSTANT(INFO_BARRIERS_IN_FRAME);
+	BIND_ENUM_CONSTANT(INFO_BARRIERS_ELIDED_IN_FRAME);
+	BIND_ENUM_CONSTANT(INFO_COMMANDS_IN_FRAME);
+	BIND_ENUM_CONSTANT(INFO_COALESCED_COMMANDS_IN_FRAME);
 
 	BIND_ENUM_CONSTANT(FEATURE_SHADERS);
 	BIND_ENUM_CONSTANT(FEATURE_MULTITHREADED);
@@ -2296,8 +2328,10 @@ RenderingServer::RenderingServer() {
 	GLOBAL_DEF("rendering/shadows/shadows/soft_shadow_quality", 2);
 	GLOBAL_DEF("rendering/shadows/shadows/soft_shadow_quality.mobile", 0);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/shadows/shadows/soft_shadow_quality", PropertyInfo(Variant::INT, "rendering/shadows/shadows/soft_shadow_quality", PROPERTY_HINT_ENUM, "Hard (Fastest),Soft Low (Fast),Soft Medium (Average),Soft High (Slow),Soft Ultra (Slowest)"));
+	GLOBAL_DEF_RST("rendering/shadows/static_shadow_cache/enabled", false);
 
 	GLOBAL_DEF("rendering/2d/shadow_atlas/size", 2048);
+	GLOBAL_DEF_RST("rendering/2d/culling/use_bvh", true);
 
 	GLOBAL_DEF_RST("rendering/vulkan/rendering/back_end", 0);
 	GLOBAL_DEF_RST("rendering/vulkan/rendering/back_end.mobile", 1);
@@ -2336,6 +2370,14 @@ RenderingServer::RenderingServer() {
 	GLOBAL_DEF("rendering/textures/default_filters/anisotropic_filtering_level", 2);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/textures/default_filters/anisotropic_filtering_level", PropertyInfo(Variant::INT, "rendering/textures/default_filters/anisotropic_filtering_level", PROPERTY_HINT_ENUM, "Disabled (Fastest),2x (Faster),4x (Fast),8x (Average),16x (Slow)"));
 
+	GLOBAL_DEF_RST("rendering/textures/streaming/enabled", false);
+	GLOBAL_DEF("rendering/textures/streaming/memory_budget_mb", 512);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/textures/streaming/memory_budget_mb", PropertyInfo(Variant::INT, "rendering/textures/streaming/memory_budget_mb", PROPERTY_HINT_RANGE, "16,16384,1,or_greater"));
+	GLOBAL_DEF("rendering/textures/streaming/min_size", 64);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/textures/streaming/min_size", PropertyInfo(Variant::INT, "rendering/textures/streaming/min_size", PROPERTY_HINT_RANGE, "1,4096,1"));
+	GLOBAL_DEF("rendering/textures/streaming/max_loads_per_frame", 4);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/textures/streaming/max_loads_per_frame", PropertyInfo(Variant::INT, "rendering/textures/streaming/max_loads_per_frame", PROPERTY_HINT_RANGE, "1,64,1"));
+
 	GLOBAL_DEF("rendering/camera/depth_of_field/depth_of_field_bokeh_shape", 1);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/camera/depth_of_field/depth_of_field_bokeh_shape", PropertyInfo(Variant::INT, "rendering/camera/depth_of_field/depth_of_field_bokeh_shape", PROPERTY_HINT_ENUM, "Box (Fast),Hexagon (Average),Circle (Slow)"));
 	GLOBAL_DEF("rendering/camera/depth_of_field/depth_of_field_bokeh_quality", 2);
@@ -2361,9 +2403,12 @@ RenderingServer::RenderingServer() {
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/anti_aliasing/screen_space_roughness_limiter/amount", PropertyInfo(Variant::FLOAT, "rendering/anti_aliasing/screen_space_roughness_limiter/amount", PROPERTY_HINT_RANGE, "0.01,4.0,0.01"));
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/anti_aliasing/screen_space_roughness_limiter/limit", PropertyInfo(Variant::FLOAT, "rendering/anti_aliasing/screen_space_roughness_limiter/limit", PROPERTY_HINT_RANGE, "0.01,1.0,0.01"));
 
+	GLOBAL_DEF_RST("rendering/occlusion_culling/backend", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/occlusion_culling/backend", PropertyInfo(Variant::INT, "rendering/occlusion_culling/backend", PROPERTY_HINT_ENUM, "Raycast (Embree),Rasterizer (Software)"));
 	GLOBAL_DEF_RST("rendering/occlusion_culling/occlusion_rays_per_thread", 512);
 	GLOBAL_DEF_RST("rendering/occlusion_culling/bvh_build_quality", 2);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/occlusion_culling/bvh_build_quality", PropertyInfo(Variant::INT, "rendering/occlusion_culling/bvh_build_quality", PROPERTY_HINT_ENUM, "Low,Medium,High"));
+	GLOBAL_DEF_RST("rendering/occlusion_culling/gpu_instance_culling", false);
 
 	GLOBAL_DEF("rendering/environment/glow/upscale_mode", 1);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/environment/glow/upscale_mode", PropertyInfo(Variant::INT, "rendering/environment/glow/upscale_mode", PROPERTY_HINT_ENUM, "Linear (Fast),Bicubic (Slow)"));
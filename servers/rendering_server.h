@@ -143,6 +143,11 @@ public:
 	typedef void (*TextureDetectRoughnessCallback)(void *, const String &, TextureDetectRoughnessChannel);
 	virtual void texture_set_detect_roughness_callback(RID p_texture, TextureDetectRoughnessCallback p_callback, void *p_userdata) = 0;
 
+	// Called from the rendering thread when a streamed texture should be reloaded with its mipmaps limited to the given size.
+	// The owner is passed by ID, as it may be freed before the callback runs.
+	typedef void (*TextureStreamCallback)(ObjectID, int);
+	virtual void texture_set_stream_callback(RID p_texture, const Size2i &p_full_size, TextureStreamCallback p_callback, ObjectID p_owner) = 0;
+
 	struct TextureInfo {
 		RID texture;
 		uint32_t width;
@@ -390,6 +395,9 @@ public:
 	virtual void multimesh_set_visible_instances(RID p_multimesh, int p_visible) = 0;
 	virtual int multimesh_get_visible_instances(RID p_multimesh) const = 0;
 
+	virtual void multimesh_set_chunk_size(RID p_multimesh, int p_size) = 0;
+	virtual int multimesh_get_chunk_size(RID p_multimesh) const = 0;
+
 	/* IMMEDIATE API */
 
 	virtual RID immediate_create() = 0;
@@ -413,6 +421,7 @@ public:
 	virtual int skeleton_get_bone_count(RID p_skeleton) const = 0;
 	virtual void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform &p_transform) = 0;
 	virtual Transform skeleton_bone_get_transform(RID p_skeleton, int p_bone) const = 0;
+	virtual void skeleton_set_bone_transforms(RID p_skeleton, const PackedFloat32Array &p_transforms) = 0;
 	virtual void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform) = 0;
 	virtual Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const = 0;
 	virtual void skeleton_set_base_transform_2d(RID p_skeleton, const Transform2D &p_base_transform) = 0;
@@ -1160,6 +1169,7 @@ public:
 	virtual void instance_set_scenario(RID p_instance, RID p_scenario) = 0;
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask) = 0;
 	virtual void instance_set_transform(RID p_instance, const Transform &p_transform) = 0;
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const PackedFloat32Array &p_transforms) = 0; // 12 floats per instance, same layout as multimesh buffers.
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_id) = 0;
 	virtual void instance_set_blend_shape_weight(RID p_instance, int p_shape, float p_weight) = 0;
 	virtual void instance_set_surface_override_material(RID p_instance, int p_surface, RID p_material) = 0;
@@ -1180,6 +1190,7 @@ public:
 	Array _instances_cull_aabb_bind(const AABB &p_aabb, RID p_scenario = RID()) const;
 	Array _instances_cull_ray_bind(const Vector3 &p_from, const Vector3 &p_to, RID p_scenario = RID()) const;
 	Array _instances_cull_convex_bind(const Array &p_convex, RID p_scenario = RID()) const;
+	void _instances_set_transforms_bind(const Array &p_instances, const PackedFloat32Array &p_transforms);
 
 	enum InstanceFlags {
 		INSTANCE_FLAG_USE_BAKED_LIGHT,
@@ -1256,6 +1267,8 @@ public:
 	virtual void canvas_item_set_update_when_visible(RID p_item, bool p_update) = 0;
 
 	virtual void canvas_item_set_transform(RID p_item, const Transform2D &p_transform) = 0;
+	virtual void canvas_items_set_transforms(const Vector<RID> &p_items, const PackedFloat32Array &p_transforms) = 0; // 6 floats per item: the x axis, the y axis and the origin.
+	void _canvas_items_set_transforms_bind(const Array &p_items, const PackedFloat32Array &p_transforms);
 	virtual void canvas_item_set_clip(RID p_item, bool p_clip) = 0;
 	virtual void canvas_item_set_distance_field_mode(RID p_item, bool p_enable) = 0;
 	virtual void canvas_item_set_custom_rect(RID p_item, bool p_custom_rect, const Rect2 &p_rect = Rect2()) = 0;
@@ -1456,6 +1469,15 @@ public:
 		INFO_VIDEO_MEM_USED,
 		INFO_TEXTURE_MEM_USED,
 		INFO_VERTEX_MEM_USED,
+		INFO_TEXTURE_STREAM_MEM_USED,
+		INFO_TEXTURE_STREAM_LOADS,
+		INFO_TEXTURE_STREAM_EVICTIONS,
+		INFO_TRANSIENT_MEM_REQUESTED,
+		INFO_TRANSIENT_MEM_USED,
+		INFO_BARRIERS_IN_FRAME,
+		INFO_BARRIERS_ELIDED_IN_FRAME,
+		INFO_COMMANDS_IN_FRAME,
+		INFO_COALESCED_COMMANDS_IN_FRAME,
 	};
 
 	virtual uint64_t get_render_info(RenderInfo p_info) = 0;
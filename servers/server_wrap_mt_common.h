@@ -260,6 +260,19 @@
 		}                                                                 \
 	}
 
+// Setter where only the last call matters: the new call is always queued, and a call
+// for the same RID that was not flushed yet is superseded and skipped by the server thread.
+#define FUNC2COALESCE(m_type, m_arg1, m_arg2)                                                    \
+	virtual void m_type(m_arg1 p1, m_arg2 p2) override {                                         \
+		WRITE_ACTION                                                                             \
+		if (Thread::get_caller_id() != server_thread) {                                          \
+			command_queue.push_coalesced(p1.get_id(), server_name, &ServerName::m_type, p1, p2); \
+		} else {                                                                                 \
+			command_queue.flush_if_pending();                                                    \
+			server_name->m_type(p1, p2);                                                         \
+		}                                                                                        \
+	}
+
 #define FUNC3R(m_r, m_type, m_arg1, m_arg2, m_arg3)                                         \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3) override {                          \
 		WRITE_ACTION                                                                        \
@@ -429,6 +429,107 @@ TEST_CASE("[CommandQueue] Test Queue Lapping") {
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
 
+class CoalesceTarget {
+public:
+	int calls = 0;
+	int values[4] = {};
+
+	void set_value(int p_index, int p_value) {
+		calls++;
+		values[p_index] = p_value;
+	}
+	void add_value(int p_index, int p_value) {
+		calls++;
+		values[p_index] += p_value;
+	}
+};
+
+TEST_CASE("[CommandQueue] Test coalesced commands") {
+	CommandQueueMT command_queue(false);
+	CoalesceTarget target;
+
+	for (int i = 1; i <= 10; i++) {
+		command_queue.push_coalesced(0, &target, &CoalesceTarget::set_value, 0, i);
+		command_queue.push_coalesced(1, &target, &CoalesceTarget::set_value, 1, i * 2);
+	}
+	command_queue.flush_all();
+	CHECK_MESSAGE(target.calls == 2,
+			"Pending commands with the same key should be coalesced into one.");
+	CHECK_MESSAGE(target.values[0] == 10,
+			"The coalesced command should use the arguments of the last push.");
+	CHECK_MESSAGE(target.values[1] == 20,
+			"The coalesced command should use the arguments of the last push.");
+
+	command_queue.push_coalesced(0, &target, &CoalesceTarget::set_value, 0, 30);
+	command_queue.flush_all();
+	CHECK_MESSAGE(target.calls == 3,
+			"A flushed command should not be coalesced with a new push.");
+	CHECK_MESSAGE(target.values[0] == 30,
+			"A new command should run after the previous one was flushed.");
+
+	command_queue.push_coalesced(2, &target, &CoalesceTarget::set_value, 2, 5);
+	command_queue.push_coalesced(2, &target, &CoalesceTarget::add_value, 2, 1);
+	command_queue.flush_all();
+	CHECK_MESSAGE(target.calls == 5,
+			"Commands for different methods should not be coalesced.");
+	CHECK_MESSAGE(target.values[2] == 6,
+			"Commands for different methods should run in order.");
+
+	command_queue.push_coalesced(3, &target, &CoalesceTarget::set_value, 3, 1);
+	command_queue.push(&target, &CoalesceTarget::set_value, 3, 2);
+	command_queue.push_coalesced(3, &target, &CoalesceTarget::set_value, 3, 3);
+	command_queue.flush_all();
+	CHECK_MESSAGE(target.calls == 7,
+			"Only the superseded command should be skipped.");
+	CHECK_MESSAGE(target.values[3] == 3,
+			"The last push should still run after a regular command pushed in between.");
+
+	CommandQueueMT::Stats stats = command_queue.get_stats();
+	CHECK_MESSAGE(stats.commands == 26,
+			"Every push should be written to the ring.");
+	CHECK_MESSAGE(stats.coalesced == 19,
+			"Every pending command superseded by a later push should be counted.");
+}
+
+TEST_CASE("[CommandQueue] Test command size stats") {
+	const char *COMMAND_QUEUE_SETTING = "memory/limits/command_queue/multithreading_queue_size_kb";
+	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING, 1);
+	SharedThreadState sts;
+	sts.init_threads();
+
+	sts.add_msg_to_write(SharedThreadState::TEST_MSG_FUNC1_TRANSFORM);
+	sts.add_msg_to_write(SharedThreadState::TEST_MSG_FUNC3_TRANSFORMx6);
+	sts.writer_threadwork.main_start_work();
+	sts.writer_threadwork.main_wait_for_done();
+
+	sts.message_count_to_read = -1;
+	sts.reader_threadwork.main_start_work();
+	sts.reader_threadwork.main_wait_for_done();
+
+	CommandQueueMT::Stats stats = sts.command_queue.get_stats();
+	CHECK_MESSAGE(stats.commands == 2,
+			"Both commands should be counted.");
+	CHECK_MESSAGE(stats.max_command_size > sizeof(Transform) * 6,
+			"The largest command should hold six transforms.");
+	CHECK_MESSAGE(stats.bytes > stats.max_command_size,
+			"Bytes should include every command.");
+
+	uint64_t histogram_total = 0;
+	for (int i = 0; i < CommandQueueMT::STATS_SIZE_BUCKETS; i++) {
+		histogram_total += stats.size_histogram[i];
+	}
+	CHECK_MESSAGE(histogram_total == 2,
+			"Each command should fall in one size bucket.");
+
+	sts.command_queue.reset_stats();
+	CHECK_MESSAGE(sts.command_queue.get_stats().commands == 0,
+			"Stats should be cleared after a reset.");
+
+	sts.destroy_threads();
+	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
+			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
+}
+
 TEST_CASE("[Stress][CommandQueue] Stress test command queue") {
 	const char *COMMAND_QUEUE_SETTING = "memory/limits/command_queue/multithreading_queue_size_kb";
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING, 1);
@@ -57,21 +57,28 @@
 #include "test_lru.h"
 #include "test_marshalls.h"
 #include "test_math.h"
+#include "test_merge_group_3d.h"
 #include "test_method_bind.h"
 #include "test_node_path.h"
 #include "test_oa_hash_map.h"
 #include "test_object.h"
+#include "test_occlusion_cull_raster.h"
 #include "test_ordered_hash_map.h"
 #include "test_paged_array.h"
 #include "test_path_3d.h"
 #include "test_pck_packer.h"
 #include "test_physics_2d.h"
 #include "test_physics_3d.h"
+#include "test_radix_sort.h"
 #include "test_random_number_generator.h"
 #include "test_rect2.h"
 #include "test_render.h"
+#include "test_render_graph.h"
+#include "test_rendering_server.h"
+#include "test_rendering_server_benchmark.h"
 #include "test_resource.h"
 #include "test_shader_lang.h"
+#include "test_skeleton_3d.h"
 #include "test_string.h"
 #include "test_text_server.h"
 #include "test_translation.h"
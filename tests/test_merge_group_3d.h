@@ -0,0 +1,225 @@
+/*************************************************************************/
+/*  test_merge_group_3d.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MERGE_GROUP_3D_H
+#define TEST_MERGE_GROUP_3D_H
+
+#include "core/config/engine.h"
+#include "drivers/dummy/rasterizer_dummy.h"
+#include "scene/3d/merge_group_3d.h"
+#include "scene/resources/material.h"
+#include "servers/rendering/rendering_server_default.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMergeGroup3D {
+
+static const Vector3 quad_vertices[4] = { Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(1, 1, 0), Vector3(0, 1, 0) };
+
+// A unit quad in the XY plane, facing +Z.
+static Ref<ArrayMesh> _create_quad(const Ref<Material> &p_material) {
+	PackedVector3Array vertices;
+	PackedVector3Array normals;
+	for (int i = 0; i < 4; i++) {
+		vertices.push_back(quad_vertices[i]);
+		normals.push_back(Vector3(0, 0, 1));
+	}
+	PackedInt32Array indices;
+	indices.push_back(0);
+	indices.push_back(2);
+	indices.push_back(1);
+	indices.push_back(0);
+	indices.push_back(3);
+	indices.push_back(2);
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_NORMAL] = normals;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+
+	Ref<ArrayMesh> mesh;
+	mesh.instance();
+	mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+	mesh->surface_set_material(0, p_material);
+	return mesh;
+}
+
+static MeshInstance3D *_add_quad(Node *p_parent, const Ref<ArrayMesh> &p_mesh, const Transform &p_xform) {
+	MeshInstance3D *mi = memnew(MeshInstance3D);
+	mi->set_mesh(p_mesh);
+	mi->set_transform(p_xform);
+	p_parent->add_child(mi);
+	return mi;
+}
+
+static int _find_surface(const Ref<ArrayMesh> &p_mesh, const Ref<Material> &p_material) {
+	for (int i = 0; i < p_mesh->get_surface_count(); i++) {
+		if (p_mesh->surface_get_material(i) == p_material) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+TEST_CASE("[MergeGroup3D] Merged meshes match their sources") {
+	// Meshes only need their surfaces, which the dummy storage keeps.
+	RasterizerDummy::make_current();
+	RenderingServer *rs = memnew(RenderingServerDefault(false));
+	rs->init();
+
+	Ref<ShaderMaterial> material_a;
+	material_a.instance();
+	Ref<ShaderMaterial> material_b;
+	material_b.instance();
+	Ref<ArrayMesh> quad_a = _create_quad(material_a);
+	Ref<ArrayMesh> quad_b = _create_quad(material_b);
+
+	// The group isn't in a tree and isn't at the origin, merged vertices are relative to it all the same.
+	MergeGroup3D *group = memnew(MergeGroup3D);
+	group->set_transform(Transform(Basis(), Vector3(100, 0, 0)));
+	group->set_cell_size(1000);
+	group->set_generate_lods(false);
+
+	const Transform xform_a(Basis(), Vector3(2, 0, 0));
+	MeshInstance3D *source_a = _add_quad(group, quad_a, xform_a);
+
+	Node3D *pivot = memnew(Node3D);
+	pivot->set_transform(Transform(Basis(Vector3(0, 1, 0), Math_PI * 0.5), Vector3(0, 3, 4)));
+	group->add_child(pivot);
+	const Transform xform_c(Basis(), Vector3(1, 0, 0));
+	MeshInstance3D *source_c = _add_quad(pivot, quad_a, xform_c);
+
+	const Transform xform_d(Basis().scaled(Vector3(2, 2, 2)), Vector3(0, 0, 5));
+	MeshInstance3D *source_d = _add_quad(group, quad_b, xform_d);
+
+	Node3D *hidden = memnew(Node3D);
+	hidden->hide();
+	group->add_child(hidden);
+	MeshInstance3D *hidden_source = _add_quad(hidden, quad_a, Transform());
+
+	MeshInstance3D *top_level_source = _add_quad(group, quad_a, Transform());
+	top_level_source->set_as_top_level(true);
+
+	const int child_count = group->get_child_count();
+
+	SUBCASE("Merged while running") {
+		REQUIRE_MESSAGE(group->merge_meshes() == 1, "All sources fit in a single cell.");
+		REQUIRE(group->get_child_count() == child_count + 1);
+
+		MeshInstance3D *merged = Object::cast_to<MeshInstance3D>(group->get_child(child_count));
+		REQUIRE(merged);
+		CHECK(merged->has_meta("_merged_mesh"));
+
+		Ref<ArrayMesh> mesh = merged->get_mesh();
+		REQUIRE(mesh.is_valid());
+		CHECK_MESSAGE(mesh->get_surface_count() == 2, "Surfaces should be merged per material.");
+
+		int surface_a = _find_surface(mesh, material_a);
+		int surface_b = _find_surface(mesh, material_b);
+		REQUIRE_MESSAGE(surface_a >= 0, "The merged mesh should keep the materials of its sources.");
+		REQUIRE_MESSAGE(surface_b >= 0, "The merged mesh should keep the materials of its sources.");
+		CHECK_MESSAGE(mesh->surface_get_array_len(surface_a) == 8, "Hidden and top level meshes should not be merged.");
+		CHECK(mesh->surface_get_array_index_len(surface_a) == 12);
+		CHECK(mesh->surface_get_array_len(surface_b) == 4);
+		CHECK(mesh->surface_get_array_index_len(surface_b) == 6);
+
+		// Sources are appended in tree order, each with its transform relative to the group.
+		const Transform xform_pivot_c = pivot->get_transform() * xform_c;
+		Array arrays_a = mesh->surface_get_arrays(surface_a);
+		PackedVector3Array vertices_a = arrays_a[Mesh::ARRAY_VERTEX];
+		PackedVector3Array normals_a = arrays_a[Mesh::ARRAY_NORMAL];
+		REQUIRE(vertices_a.size() == 8);
+		for (int i = 0; i < 4; i++) {
+			CHECK_MESSAGE(vertices_a[i].is_equal_approx(xform_a.xform(quad_vertices[i])), "Vertices should be moved by their source's transform.");
+			CHECK_MESSAGE(vertices_a[i + 4].is_equal_approx(xform_pivot_c.xform(quad_vertices[i])), "Vertices should be moved by their parents' transforms as well.");
+		}
+		REQUIRE(normals_a.size() == 8);
+		CHECK_MESSAGE(normals_a[0].dot(Vector3(0, 0, 1)) > 0.99, "Normals should be rotated by their source's transform.");
+		CHECK_MESSAGE(normals_a[4].dot(xform_pivot_c.basis.xform(Vector3(0, 0, 1))) > 0.99, "Normals should be rotated by their source's transform.");
+
+		Array arrays_b = mesh->surface_get_arrays(surface_b);
+		PackedVector3Array vertices_b = arrays_b[Mesh::ARRAY_VERTEX];
+		REQUIRE(vertices_b.size() == 4);
+		for (int i = 0; i < 4; i++) {
+			CHECK_MESSAGE(vertices_b[i].is_equal_approx(xform_d.xform(quad_vertices[i])), "Vertices should be scaled by their source's transform.");
+		}
+
+		// Sources stay in the tree for their scripts and children, but are no longer drawn.
+		for (MeshInstance3D *source : { source_a, source_c, source_d }) {
+			CHECK_MESSAGE(source->get_base() == RID(), "Merged sources should release their mesh.");
+			CHECK(source->is_visible());
+		}
+		CHECK_MESSAGE(hidden_source->get_base().is_valid(), "Skipped sources should be left untouched.");
+		CHECK_MESSAGE(top_level_source->get_base().is_valid(), "Skipped sources should be left untouched.");
+
+		CHECK_MESSAGE(group->merge_meshes() == 0, "Merging again should not duplicate the merged geometry.");
+		CHECK(group->get_child_count() == child_count + 1);
+	}
+
+#ifdef TOOLS_ENABLED
+	SUBCASE("Merged in the editor") {
+		Engine::get_singleton()->set_editor_hint(true);
+		REQUIRE(group->merge_meshes() == 1);
+		Engine::get_singleton()->set_editor_hint(false);
+
+		for (MeshInstance3D *source : { source_a, source_c, source_d }) {
+			CHECK_MESSAGE(!source->is_visible(), "Sources merged in the editor should be hidden.");
+			CHECK_MESSAGE(source->get_base().is_valid(), "Sources merged in the editor should keep their mesh.");
+		}
+		CHECK(group->merge_meshes() == 0);
+
+		// Undoing the merge removes the merged mesh and shows the sources, which can then be merged again.
+		Node *merged = group->get_child(child_count);
+		group->remove_child(merged);
+		memdelete(merged);
+		for (MeshInstance3D *source : { source_a, source_c, source_d }) {
+			source->show();
+		}
+
+		CHECK_MESSAGE(group->merge_meshes() == 1, "Restored sources should be merged again.");
+		Ref<ArrayMesh> mesh = Object::cast_to<MeshInstance3D>(group->get_child(child_count))->get_mesh();
+		CHECK(mesh->get_surface_count() == 2);
+	}
+#endif
+
+	memdelete(group);
+	quad_a.unref();
+	quad_b.unref();
+	material_a.unref();
+	material_b.unref();
+
+	rs->finish();
+	memdelete(rs);
+}
+
+} // namespace TestMergeGroup3D
+
+#endif // TEST_MERGE_GROUP_3D_H
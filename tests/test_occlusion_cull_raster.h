@@ -0,0 +1,161 @@
+/*************************************************************************/
+/*  test_occlusion_cull_raster.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_OCCLUSION_CULL_RASTER_H
+#define TEST_OCCLUSION_CULL_RASTER_H
+
+#include "servers/rendering/renderer_scene_occlusion_cull_raster.h"
+
+#include "tests/test_macros.h"
+
+namespace TestOcclusionCullRaster {
+
+class OcclusionCullRasterScene {
+public:
+	ThreadWorkPool thread_pool;
+	RendererSceneOcclusionCullRaster *culler = nullptr;
+
+	RID quad;
+	RID scenario = RID::from_uint64(1);
+	RID instance = RID::from_uint64(2);
+	RID buffer = RID::from_uint64(3);
+
+	Transform cam_transform;
+	CameraMatrix cam_projection;
+	bool cam_orthogonal = false;
+
+	OcclusionCullRasterScene() {
+		thread_pool.init(4);
+		culler = memnew(RendererSceneOcclusionCullRaster);
+
+		// A 2x2 quad on the XY plane.
+		PackedVector3Array vertices;
+		vertices.push_back(Vector3(-1, -1, 0));
+		vertices.push_back(Vector3(1, -1, 0));
+		vertices.push_back(Vector3(1, 1, 0));
+		vertices.push_back(Vector3(-1, 1, 0));
+		PackedInt32Array indices;
+		indices.push_back(0);
+		indices.push_back(1);
+		indices.push_back(2);
+		indices.push_back(0);
+		indices.push_back(2);
+		indices.push_back(3);
+
+		quad = culler->occluder_allocate();
+		culler->occluder_initialize(quad);
+		culler->occluder_set_mesh(quad, vertices, indices);
+
+		culler->add_scenario(scenario);
+		culler->add_buffer(buffer);
+		culler->buffer_set_scenario(buffer, scenario);
+		culler->buffer_set_size(buffer, Vector2i(64, 36));
+
+		cam_projection.set_perspective(70, 16.0 / 9.0, 0.05, 100);
+	}
+
+	~OcclusionCullRasterScene() {
+		culler->remove_buffer(buffer);
+		culler->remove_scenario(scenario);
+		culler->free_occluder(quad);
+		memdelete(culler);
+		thread_pool.finish();
+	}
+
+	void set_quad_transform(const Transform &p_xform, bool p_enabled = true) {
+		culler->scenario_set_instance(scenario, instance, quad, p_xform, p_enabled);
+	}
+
+	bool is_occluded(const AABB &p_aabb) {
+		culler->buffer_update(buffer, cam_transform, cam_projection, cam_orthogonal, thread_pool);
+		const RendererSceneOcclusionCull::HZBuffer *hzb = culler->buffer_get_ptr(buffer);
+		const float bounds[6] = { p_aabb.position.x, p_aabb.position.y, p_aabb.position.z, p_aabb.position.x + p_aabb.size.x, p_aabb.position.y + p_aabb.size.y, p_aabb.position.z + p_aabb.size.z };
+		return hzb->is_occluded(bounds, cam_transform.origin, cam_transform.affine_inverse(), cam_projection, cam_projection.get_z_near());
+	}
+};
+
+TEST_CASE("[OcclusionCullRaster] Wall in front of the camera") {
+	OcclusionCullRasterScene scene;
+
+	// 10x10 wall, 10 units in front of the camera.
+	Transform wall;
+	wall.basis.scale(Vector3(5, 5, 1));
+	wall.origin = Vector3(0, 0, -10);
+	scene.set_quad_transform(wall);
+
+	const AABB behind = AABB(Vector3(-1, -1, -30), Vector3(2, 2, 10));
+	const AABB in_front = AABB(Vector3(-1, -1, -8), Vector3(2, 2, 2));
+	const AABB beside = AABB(Vector3(20, -1, -30), Vector3(2, 2, 10));
+
+	SUBCASE("Perspective projection") {
+		CHECK_MESSAGE(scene.is_occluded(behind), "AABB behind the wall should be occluded.");
+		CHECK_MESSAGE(!scene.is_occluded(in_front), "AABB in front of the wall should be visible.");
+		CHECK_MESSAGE(!scene.is_occluded(beside), "AABB beside the wall should be visible.");
+	}
+
+	SUBCASE("Orthogonal projection") {
+		scene.cam_projection.set_orthogonal(20, 16.0 / 9.0, 0.05, 100);
+		scene.cam_orthogonal = true;
+
+		CHECK_MESSAGE(scene.is_occluded(behind), "AABB behind the wall should be occluded.");
+		CHECK_MESSAGE(!scene.is_occluded(in_front), "AABB in front of the wall should be visible.");
+		CHECK_MESSAGE(!scene.is_occluded(beside), "AABB beside the wall should be visible.");
+	}
+
+	SUBCASE("Disabled occluder") {
+		scene.set_quad_transform(wall, false);
+		CHECK_MESSAGE(!scene.is_occluded(behind), "Disabled occluders should not occlude anything.");
+
+		scene.set_quad_transform(wall, true);
+		CHECK_MESSAGE(scene.is_occluded(behind), "Re-enabled occluders should occlude again.");
+	}
+
+	SUBCASE("Removed occluder") {
+		scene.culler->scenario_remove_instance(scene.scenario, scene.instance);
+		CHECK_MESSAGE(!scene.is_occluded(behind), "Removed occluders should not occlude anything.");
+	}
+}
+
+TEST_CASE("[OcclusionCullRaster] Floor crossing the near plane") {
+	OcclusionCullRasterScene scene;
+
+	// 200x200 floor one unit below the camera, rasterizing it requires near plane clipping.
+	Transform floor;
+	floor.basis = Basis(Vector3(1, 0, 0), -Math_PI / 2) * Basis().scaled(Vector3(100, 100, 1));
+	floor.origin = Vector3(0, -1, 0);
+	scene.set_quad_transform(floor);
+
+	CHECK_MESSAGE(scene.is_occluded(AABB(Vector3(-1, -4, -20), Vector3(2, 2, 2))), "AABB below the floor should be occluded.");
+	CHECK_MESSAGE(!scene.is_occluded(AABB(Vector3(-1, -0.5, -20), Vector3(2, 2, 2))), "AABB above the floor should be visible.");
+}
+
+} // namespace TestOcclusionCullRaster
+
+#endif // TEST_OCCLUSION_CULL_RASTER_H
@@ -0,0 +1,134 @@
+/*************************************************************************/
+/*  test_radix_sort.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_RADIX_SORT_H
+#define TEST_RADIX_SORT_H
+
+#include "core/templates/radix_sort.h"
+#include "core/templates/sort_array.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestRadixSort {
+
+struct Item {
+	uint64_t low = 0;
+	uint64_t high = 0;
+	uint32_t index = 0;
+};
+
+struct ItemKeys {
+	_FORCE_INLINE_ uint64_t get_low(const Item *p_item) const { return p_item->low; }
+	_FORCE_INLINE_ uint64_t get_high(const Item *p_item) const { return p_item->high; }
+};
+
+// Same order the radix sort must produce, the index makes it stable.
+struct ItemCompare {
+	_FORCE_INLINE_ bool operator()(const Item *A, const Item *B) const {
+		if (A->high != B->high) {
+			return A->high < B->high;
+		}
+		if (A->low != B->low) {
+			return A->low < B->low;
+		}
+		return A->index < B->index;
+	}
+};
+
+static void fill_items(LocalVector<Item> &r_items, LocalVector<Item *> &r_pointers, uint32_t p_count) {
+	r_items.resize(p_count);
+	r_pointers.resize(p_count);
+	uint64_t seed = 12345;
+	for (uint32_t i = 0; i < p_count; i++) {
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		// Mostly constant bytes with a few varying fields, like render list keys.
+		r_items[i].low = (seed >> 16) & 0x00FF00FFFF00ULL;
+		r_items[i].high = (1ULL << 60) | ((seed >> 56) & 0x7);
+		r_items[i].index = i;
+		r_pointers[i] = &r_items[i];
+	}
+}
+
+static bool is_sorted_like_reference(const LocalVector<Item *> &p_sorted, const LocalVector<Item *> &p_unsorted) {
+	LocalVector<Item *> reference = p_unsorted;
+	SortArray<Item *, ItemCompare> sorter;
+	sorter.sort(reference.ptr(), reference.size());
+	for (uint32_t i = 0; i < reference.size(); i++) {
+		if (reference[i] != p_sorted[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[RadixSort] Stable sort by 128 bit key") {
+	LocalVector<Item> items;
+	LocalVector<Item *> pointers;
+	fill_items(items, pointers, 3000);
+
+	LocalVector<Item *> sorted = pointers;
+	RadixSort<Item *, ItemKeys> radix_sort;
+	radix_sort.sort(sorted.ptr(), sorted.size());
+
+	CHECK_MESSAGE(
+			is_sorted_like_reference(sorted, pointers),
+			"Radix sort should match a stable comparison sort.");
+
+	// Sorting again reuses the buffers and must not change a sorted array.
+	LocalVector<Item *> resorted = sorted;
+	radix_sort.sort(resorted.ptr(), resorted.size());
+	CHECK_MESSAGE(
+			is_sorted_like_reference(resorted, pointers),
+			"Radix sort should keep an already sorted array as is.");
+}
+
+TEST_CASE("[RadixSort] Parallel sort") {
+	ThreadWorkPool pool;
+	pool.init(4);
+
+	LocalVector<Item> items;
+	LocalVector<Item *> pointers;
+	fill_items(items, pointers, 50000);
+
+	LocalVector<Item *> sorted = pointers;
+	RadixSort<Item *, ItemKeys> radix_sort;
+	radix_sort.sort(sorted.ptr(), sorted.size(), &pool);
+
+	CHECK_MESSAGE(
+			is_sorted_like_reference(sorted, pointers),
+			"Parallel radix sort should match a stable comparison sort.");
+
+	pool.finish();
+}
+
+} // namespace TestRadixSort
+
+#endif // TEST_RADIX_SORT_H
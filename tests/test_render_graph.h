@@ -0,0 +1,209 @@
+/*************************************************************************/
+/*  test_render_graph.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDER_GRAPH_H
+#define TEST_RENDER_GRAPH_H
+
+#include "servers/rendering/renderer_rd/render_graph_rd.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderGraph {
+
+// Hands out fake textures and records barriers, so no rendering device is needed.
+class TestRenderGraphRD : public RenderGraphRD {
+	uint64_t last_id = 0;
+
+protected:
+	RID _texture_create(const RD::TextureFormat &p_format, const String &p_name, uint64_t &r_memory) override {
+		r_memory = p_format.width * p_format.height;
+		created++;
+		return RID::from_uint64(++last_id);
+	}
+
+	void _texture_free(RID p_texture) override {
+		freed++;
+	}
+
+	void _barrier(uint32_t p_from, uint32_t p_to) override {
+		barriers.push_back(Pair<uint32_t, uint32_t>(p_from, p_to));
+	}
+
+public:
+	int created = 0;
+	int freed = 0;
+	Vector<Pair<uint32_t, uint32_t>> barriers;
+
+	~TestRenderGraphRD() {
+		clear_pool();
+	}
+};
+
+RD::TextureFormat _texture_format(RD::DataFormat p_format) {
+	RD::TextureFormat tf;
+	tf.format = p_format;
+	tf.width = 64;
+	tf.height = 64;
+	tf.usage_bits = RD::TEXTURE_USAGE_STORAGE_BIT;
+	return tf;
+}
+
+TEST_CASE("[RenderGraph] Transient textures alias when their lifetimes don't overlap") {
+	TestRenderGraphRD graph;
+	graph.update(1);
+	graph.begin();
+
+	RenderGraphRD::ResourceID a = graph.create_texture(_texture_format(RD::DATA_FORMAT_R8_UNORM), "A");
+	RenderGraphRD::ResourceID b = graph.create_texture(_texture_format(RD::DATA_FORMAT_R8_UNORM), "B");
+	RenderGraphRD::ResourceID c = graph.create_texture(_texture_format(RD::DATA_FORMAT_R8_UNORM), "C");
+	RenderGraphRD::ResourceID d = graph.create_texture(_texture_format(RD::DATA_FORMAT_R16_SFLOAT), "D");
+
+	RenderGraphRD::PassID first = graph.add_pass("First", RenderGraphRD::STAGE_COMPUTE);
+	graph.pass_write(first, a);
+	RenderGraphRD::PassID second = graph.add_pass("Second", RenderGraphRD::STAGE_COMPUTE);
+	graph.pass_read(second, a);
+	graph.pass_write(second, b);
+	RenderGraphRD::PassID third = graph.add_pass("Third", RenderGraphRD::STAGE_RASTER);
+	graph.pass_read(third, b);
+	graph.pass_write(third, c);
+	graph.pass_write(third, d);
+
+	graph.compile();
+
+	CHECK_MESSAGE(graph.get_texture(a) != graph.get_texture(b), "Textures used by the same pass should not alias.");
+	CHECK_MESSAGE(graph.get_texture(c) == graph.get_texture(a), "A texture should be reused once its last pass is done.");
+	CHECK_MESSAGE(graph.get_texture(c) != graph.get_texture(b), "A texture should not be reused while it is still read.");
+	CHECK_MESSAGE(graph.get_texture(d) != graph.get_texture(a), "Textures of different formats should not alias.");
+	CHECK(graph.created == 3);
+
+	// The first pass waits for the second reading its output, and for the third reusing its texture.
+	CHECK(graph.get_pass_barrier(first) == (RD::BARRIER_MASK_COMPUTE | RD::BARRIER_MASK_RASTER));
+	CHECK(graph.get_pass_barrier(second) == RD::BARRIER_MASK_RASTER);
+	CHECK_MESSAGE(graph.get_pass_barrier(third) == RD::BARRIER_MASK_NO_BARRIER, "Nothing depends on the last pass.");
+
+	graph.end();
+
+	graph.update(2);
+	const RenderGraphRD::Stats &stats = graph.get_last_frame_stats();
+	CHECK(stats.transient_memory_requested == 4 * 64 * 64);
+	CHECK(graph.get_transient_memory_used() == 3 * 64 * 64);
+	CHECK(stats.barriers == 3);
+	CHECK(stats.barriers_elided == 6);
+}
+
+TEST_CASE("[RenderGraph] Imported textures wait for their external stages") {
+	TestRenderGraphRD graph;
+	graph.begin();
+
+	RenderGraphRD::ResourceID raster_output = graph.import_texture(RID::from_uint64(1000), RD::BARRIER_MASK_RASTER);
+	RenderGraphRD::ResourceID unsynced_output = graph.import_texture(RID::from_uint64(1001), 0);
+
+	RenderGraphRD::PassID first = graph.add_pass("First", RenderGraphRD::STAGE_COMPUTE);
+	graph.pass_write(first, raster_output);
+	RenderGraphRD::PassID second = graph.add_pass("Second", RenderGraphRD::STAGE_COMPUTE);
+	graph.pass_write(second, unsynced_output);
+
+	graph.compile();
+
+	CHECK(graph.get_texture(raster_output) == RID::from_uint64(1000));
+	CHECK(graph.get_pass_barrier(first) == RD::BARRIER_MASK_RASTER);
+	CHECK(graph.get_pass_barrier(second) == RD::BARRIER_MASK_NO_BARRIER);
+	CHECK_MESSAGE(graph.created == 0, "Imported textures should not be created.");
+
+	graph.end();
+}
+
+TEST_CASE("[RenderGraph] Graphs reusing a texture are synchronized") {
+	TestRenderGraphRD graph;
+	RD::TextureFormat tf = _texture_format(RD::DATA_FORMAT_R8_UNORM);
+
+	// Nothing waits for the compute pass, so the next graph has to.
+	graph.begin();
+	RenderGraphRD::ResourceID first_texture = graph.create_texture(tf, "First");
+	graph.pass_write(graph.add_pass("First", RenderGraphRD::STAGE_COMPUTE), first_texture);
+	graph.compile();
+	RID texture = graph.get_texture(first_texture);
+	graph.end();
+
+	graph.begin();
+	RenderGraphRD::ResourceID second_texture = graph.create_texture(tf, "Second");
+	graph.pass_write(graph.add_pass("Second", RenderGraphRD::STAGE_RASTER), second_texture);
+	graph.compile();
+	CHECK_MESSAGE(graph.get_texture(second_texture) == texture, "The pooled texture should be reused by the next graph.");
+	REQUIRE(graph.barriers.size() == 1);
+	CHECK(graph.barriers[0].first == RD::BARRIER_MASK_COMPUTE);
+	CHECK(graph.barriers[0].second == RD::BARRIER_MASK_RASTER);
+	graph.end();
+
+	// The compute pass already waits for raster work because of its output, so a raster pass
+	// reusing its texture needs nothing more.
+	graph.begin();
+	RenderGraphRD::ResourceID third_texture = graph.create_texture(tf, "Third");
+	RenderGraphRD::ResourceID raster_output = graph.import_texture(RID::from_uint64(1000), RD::BARRIER_MASK_RASTER);
+	RenderGraphRD::PassID third = graph.add_pass("Third", RenderGraphRD::STAGE_COMPUTE);
+	graph.pass_write(third, third_texture);
+	graph.pass_write(third, raster_output);
+	graph.compile();
+	graph.end();
+	int barrier_count = graph.barriers.size();
+
+	graph.begin();
+	RenderGraphRD::ResourceID fourth_texture = graph.create_texture(tf, "Fourth");
+	graph.pass_write(graph.add_pass("Fourth", RenderGraphRD::STAGE_RASTER), fourth_texture);
+	graph.compile();
+	CHECK(graph.get_texture(fourth_texture) == texture);
+	CHECK_MESSAGE(graph.barriers.size() == barrier_count, "No barrier should be added when the previous graph already waited.");
+	graph.end();
+
+	CHECK(graph.created == 1);
+}
+
+TEST_CASE("[RenderGraph] Idle pooled textures are released") {
+	TestRenderGraphRD graph;
+	graph.update(1);
+
+	graph.begin();
+	RenderGraphRD::ResourceID texture = graph.create_texture(_texture_format(RD::DATA_FORMAT_R8_UNORM), "Texture");
+	graph.pass_write(graph.add_pass("Pass", RenderGraphRD::STAGE_COMPUTE), texture);
+	graph.compile();
+	graph.end();
+
+	graph.update(31);
+	CHECK_MESSAGE(graph.freed == 0, "Textures used in the last 30 frames should be kept.");
+	CHECK(graph.get_transient_memory_used() == 64 * 64);
+
+	graph.update(32);
+	CHECK_MESSAGE(graph.freed == 1, "Textures idle for more than 30 frames should be released.");
+	CHECK(graph.get_transient_memory_used() == 0);
+}
+
+} // namespace TestRenderGraph
+
+#endif // TEST_RENDER_GRAPH_H
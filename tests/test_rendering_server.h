@@ -0,0 +1,369 @@
+/*************************************************************************/
+/*  test_rendering_server.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDERING_SERVER_H
+#define TEST_RENDERING_SERVER_H
+
+#include "core/math/random_pcg.h"
+#include "drivers/dummy/rasterizer_dummy.h"
+#include "servers/rendering/rendering_server_default.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderingServer {
+
+class RecordingCanvasRender : public RasterizerCanvasDummy {
+public:
+	Vector<RendererCanvasRender::Item *> drawn;
+
+	void canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, Light *p_directional_list, const Transform2D &p_canvas_transform, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, bool &r_sdf_used) override {
+		for (Item *ci = p_item_list; ci; ci = ci->next) {
+			drawn.push_back(ci);
+		}
+		r_sdf_used = false;
+	}
+};
+
+struct CanvasScene {
+	RID canvas;
+	Vector<RID> items;
+};
+
+// A grid of root items much larger than the view, with one of them holding enough children
+// to get its own child BVH, plus a few items that can't be indexed.
+CanvasScene _create_canvas_scene(bool p_use_child_bvh) {
+	RSG::canvas->use_child_bvh = p_use_child_bvh;
+
+	CanvasScene scene;
+	scene.canvas = RS::get_singleton()->canvas_create();
+
+	for (int i = 0; i < 300; i++) {
+		RID item = RS::get_singleton()->canvas_item_create();
+		RS::get_singleton()->canvas_item_set_parent(item, scene.canvas);
+		RS::get_singleton()->canvas_item_set_draw_index(item, i);
+		RS::get_singleton()->canvas_item_set_transform(item, Transform2D(0, Vector2(i % 20, i / 20) * 64));
+		RS::get_singleton()->canvas_item_add_rect(item, Rect2(0, 0, 32, 32), Color(1, 1, 1));
+		scene.items.push_back(item);
+	}
+
+	// Drawing behind the parent means nothing at the root, these must still be drawn.
+	RS::get_singleton()->canvas_item_set_draw_behind_parent(scene.items[21], true);
+
+	for (int i = 0; i < 150; i++) {
+		RID child = RS::get_singleton()->canvas_item_create();
+		RS::get_singleton()->canvas_item_set_parent(child, scene.items[0]);
+		RS::get_singleton()->canvas_item_set_draw_index(child, i);
+		RS::get_singleton()->canvas_item_set_transform(child, Transform2D(0, Vector2(i % 15, i / 15) * 40));
+		RS::get_singleton()->canvas_item_add_rect(child, Rect2(0, 0, 16, 16), Color(1, 1, 1));
+		scene.items.push_back(child);
+	}
+
+	RSG::canvas->use_child_bvh = true;
+	return scene;
+}
+
+// Returns the drawn items as indices into the scene, in draw order.
+Vector<int> _render_canvas_scene(const CanvasScene &p_scene, RecordingCanvasRender &r_recorder, const Transform2D &p_transform) {
+	r_recorder.drawn.clear();
+	RSG::canvas->render_canvas(RID(), RSG::canvas->canvas_owner.getornull(p_scene.canvas), p_transform, nullptr, nullptr, Rect2(0, 0, 320, 240), RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false);
+
+	Vector<int> drawn;
+	for (int i = 0; i < r_recorder.drawn.size(); i++) {
+		for (int j = 0; j < p_scene.items.size(); j++) {
+			if (RSG::canvas->canvas_item_owner.getornull(p_scene.items[j]) == r_recorder.drawn[i]) {
+				drawn.push_back(j);
+				break;
+			}
+		}
+	}
+	return drawn;
+}
+
+void _free_canvas_scene(const CanvasScene &p_scene) {
+	for (int i = p_scene.items.size() - 1; i >= 0; i--) {
+		RSG::canvas->free(p_scene.items[i]);
+	}
+	RSG::canvas->free(p_scene.canvas);
+}
+
+TEST_CASE("[RenderingServer] Batch transform setters read the documented layouts") {
+	// The cull classes keep the transforms, so the dummy backend is enough.
+	RasterizerDummy::make_current();
+	RenderingServer *rs = memnew(RenderingServerDefault(false));
+	rs->init();
+
+	// 12 floats per instance, row by row with the origin component at the end of each row.
+	Vector<RID> instances;
+	Vector<Transform> transforms;
+	PackedFloat32Array instance_data;
+	for (int i = 0; i < 3; i++) {
+		Transform xform(Basis(Vector3(1, 2, 3), Vector3(4, 5, 6), Vector3(7, 8, 10)) * (i + 1), Vector3(11, 12, 13) * (i + 1));
+		for (int row = 0; row < 3; row++) {
+			instance_data.push_back(xform.basis.elements[row][0]);
+			instance_data.push_back(xform.basis.elements[row][1]);
+			instance_data.push_back(xform.basis.elements[row][2]);
+			instance_data.push_back(xform.origin[row]);
+		}
+		instances.push_back(rs->instance_create());
+		transforms.push_back(xform);
+	}
+	rs->instances_set_transforms(instances, instance_data);
+
+	RendererSceneCull *scene = static_cast<RendererSceneCull *>(RSG::scene);
+	for (int i = 0; i < instances.size(); i++) {
+		CHECK_MESSAGE(scene->instance_owner.getornull(instances[i])->transform == transforms[i], "Instance transforms should be read row by row.");
+	}
+
+	// 6 floats per item: the x axis, the y axis and the origin.
+	Vector<RID> items;
+	Vector<Transform2D> transforms_2d;
+	PackedFloat32Array item_data;
+	for (int i = 0; i < 3; i++) {
+		Transform2D xform(1 + i, 2, 3, 4 + i, 5, 6 + i);
+		for (int column = 0; column < 3; column++) {
+			item_data.push_back(xform.elements[column].x);
+			item_data.push_back(xform.elements[column].y);
+		}
+		items.push_back(rs->canvas_item_create());
+		transforms_2d.push_back(xform);
+	}
+	rs->canvas_items_set_transforms(items, item_data);
+
+	for (int i = 0; i < items.size(); i++) {
+		CHECK_MESSAGE(RSG::canvas->canvas_item_owner.getornull(items[i])->xform == transforms_2d[i], "Canvas item transforms should be read axis by axis.");
+	}
+
+	// A buffer of the wrong size is rejected as a whole.
+	ERR_PRINT_OFF;
+	rs->canvas_items_set_transforms(items, PackedFloat32Array());
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(RSG::canvas->canvas_item_owner.getornull(items[0])->xform == transforms_2d[0], "A mismatched buffer should leave the transforms unchanged.");
+
+	for (int i = 0; i < instances.size(); i++) {
+		rs->free(instances[i]);
+	}
+	for (int i = 0; i < items.size(); i++) {
+		rs->free(items[i]);
+	}
+
+	rs->finish();
+	memdelete(rs);
+}
+
+TEST_CASE("[RenderingServer] Canvas child BVH culling draws the same items as plain culling") {
+	RasterizerDummy::make_current();
+	RenderingServer *rs = memnew(RenderingServerDefault(false));
+	rs->init();
+
+	RecordingCanvasRender recorder;
+	RendererCanvasRender *canvas_render = RSG::canvas_render;
+	RSG::canvas_render = &recorder;
+
+	CanvasScene plain = _create_canvas_scene(false);
+	CanvasScene indexed = _create_canvas_scene(true);
+
+	RendererCanvasCull::Canvas *indexed_canvas = RSG::canvas->canvas_owner.getornull(indexed.canvas);
+	REQUIRE_MESSAGE(indexed_canvas->child_bvh != nullptr, "A canvas with many children should index them.");
+	REQUIRE_MESSAGE(RSG::canvas->canvas_item_owner.getornull(indexed.items[0])->child_bvh != nullptr, "An item with many children should index them.");
+	REQUIRE(RSG::canvas->canvas_owner.getornull(plain.canvas)->child_bvh == nullptr);
+
+	const Transform2D views[] = {
+		Transform2D(),
+		Transform2D(0, Vector2(-400, -300)),
+		Transform2D(0.3, Vector2(100, -200)).scaled(Size2(0.5, 0.5)),
+	};
+
+	for (const Transform2D &view : views) {
+		Vector<int> drawn = _render_canvas_scene(indexed, recorder, view);
+		CHECK_MESSAGE(drawn == _render_canvas_scene(plain, recorder, view), "The same items should be drawn in the same order.");
+		CHECK_MESSAGE(drawn.size() < indexed.items.size(), "Items out of the view should be culled.");
+	}
+	CHECK_MESSAGE(_render_canvas_scene(indexed, recorder, Transform2D()).has(21), "Root items drawn behind their parent should not be skipped.");
+
+	// Moving, reordering, reparenting and hiding must keep both paths in sync.
+	for (const CanvasScene *scene : { &plain, &indexed }) {
+		RS::get_singleton()->canvas_item_set_transform(scene->items[299], Transform2D(0, Vector2(100, 100)));
+		RS::get_singleton()->canvas_item_set_transform(scene->items[1], Transform2D(0, Vector2(5000, 5000)));
+		RS::get_singleton()->canvas_item_set_draw_index(scene->items[2], 1000);
+		RS::get_singleton()->canvas_item_set_parent(scene->items[3], scene->items[4]);
+		RS::get_singleton()->canvas_item_set_visible(scene->items[22], false);
+		RS::get_singleton()->canvas_item_set_parent(scene->items[310], scene->canvas);
+		RS::get_singleton()->canvas_item_set_draw_index(scene->items[310], 2000);
+	}
+
+	for (const Transform2D &view : views) {
+		CHECK_MESSAGE(_render_canvas_scene(indexed, recorder, view) == _render_canvas_scene(plain, recorder, view), "The same items should be drawn after changes.");
+	}
+
+	_free_canvas_scene(plain);
+	_free_canvas_scene(indexed);
+
+	RSG::canvas_render = canvas_render;
+
+	rs->finish();
+	memdelete(rs);
+}
+
+// Instance data of unit boxes spread over a square, with some rotated and scaled.
+static Vector<float> _create_multimesh_buffer(int p_count, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	Vector<float> buffer;
+	for (int i = 0; i < p_count; i++) {
+		Basis basis(Vector3(0, 1, 0), rng.randf() * Math_TAU);
+		basis.scale(Vector3(1, 1, 1) * rng.random(0.5, 2.0));
+		Transform xform(basis, Vector3(rng.random(-50.0, 50.0), rng.random(-2.0, 2.0), rng.random(-50.0, 50.0)));
+		for (int row = 0; row < 3; row++) {
+			buffer.push_back(xform.basis.elements[row][0]);
+			buffer.push_back(xform.basis.elements[row][1]);
+			buffer.push_back(xform.basis.elements[row][2]);
+			buffer.push_back(xform.origin[row]);
+		}
+	}
+	return buffer;
+}
+
+// Counts the drawn boxes that touch the frustum.
+static int _count_boxes_in_view(const Vector<float> &p_buffer, const Vector<Plane> &p_frustum) {
+	int count = 0;
+	for (int i = 0; i < p_buffer.size(); i += 12) {
+		const float *d = p_buffer.ptr() + i;
+		Transform xform(d[0], d[1], d[2], d[4], d[5], d[6], d[8], d[9], d[10], d[3], d[7], d[11]);
+		AABB aabb = xform.xform(AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+		bool inside = true;
+		for (int j = 0; j < p_frustum.size(); j++) {
+			if (p_frustum[j].distance_to(aabb.get_support(-p_frustum[j].normal)) > 0) {
+				inside = false;
+				break;
+			}
+		}
+		count += inside;
+	}
+	return count;
+}
+
+// Renders each view with a plain and a chunked multimesh of the same instances, both must draw the boxes in view.
+static void _check_multimesh_views(RID p_camera, RID p_scenario, RID p_plain, RID p_chunked, const String &p_when) {
+	const Transform views[] = {
+		Transform(),
+		Transform(Basis(), Vector3(40, 5, 40)).looking_at(Vector3(60, 0, 60)),
+		Transform(Basis(), Vector3(0, 30, 0)).looking_at(Vector3(10, 0, 0), Vector3(0, 0, -1)),
+	};
+
+	RendererSceneCull *scene = static_cast<RendererSceneCull *>(RSG::scene);
+	RasterizerStorageDummy *storage = static_cast<RasterizerStorageDummy *>(RSG::storage);
+	CameraMatrix projection;
+	projection.set_perspective(70, 1920.0 / 1080.0, 0.05, 200);
+
+	for (const Transform &view : views) {
+		RS::get_singleton()->camera_set_transform(p_camera, view);
+		scene->update_dirty_instances();
+		scene->render_camera(RID(), p_camera, p_scenario, RID(), Size2(1920, 1080), 0.0, RID());
+
+		Vector<Plane> frustum = projection.get_projection_planes(view);
+		Vector<float> plain = storage->multimesh_get_draw_buffer(p_plain);
+		Vector<float> chunked = storage->multimesh_get_draw_buffer(p_chunked);
+		int in_view = _count_boxes_in_view(plain, frustum);
+		REQUIRE(in_view > 0);
+		CHECK_MESSAGE(_count_boxes_in_view(chunked, frustum) == in_view, vformat("Chunks should keep every instance in view %s.", p_when).utf8().ptr());
+		CHECK_MESSAGE(chunked.size() < plain.size(), vformat("Chunks out of view should not be drawn %s.", p_when).utf8().ptr());
+	}
+}
+
+TEST_CASE("[RenderingServer] Chunked multimeshes draw the same instances in view as plain ones") {
+	// The dummy storage chunks multimeshes with the same code as the renderers.
+	RasterizerDummy::make_current();
+	RenderingServer *rs = memnew(RenderingServerDefault(false));
+	rs->init();
+
+	RID mesh = rs->mesh_create();
+	Array arrays;
+	arrays.resize(RS::ARRAY_MAX);
+	PackedVector3Array vertices;
+	vertices.push_back(Vector3(-0.5, -0.5, -0.5));
+	vertices.push_back(Vector3(0.5, -0.5, 0.5));
+	vertices.push_back(Vector3(0, 0.5, 0));
+	arrays[RS::ARRAY_VERTEX] = vertices;
+	rs->mesh_add_surface_from_arrays(mesh, RS::PRIMITIVE_TRIANGLES, arrays);
+
+	RID scenario = rs->scenario_create();
+	RID camera = rs->camera_create();
+	rs->camera_set_perspective(camera, 70, 0.05, 200);
+
+	RID multimeshes[2];
+	RID instances[2];
+	for (int i = 0; i < 2; i++) {
+		multimeshes[i] = rs->multimesh_create();
+		rs->multimesh_set_mesh(multimeshes[i], mesh);
+		rs->multimesh_set_chunk_size(multimeshes[i], i == 0 ? 0 : 32);
+		rs->multimesh_allocate_data(multimeshes[i], 2000, RS::MULTIMESH_TRANSFORM_3D);
+		rs->multimesh_set_buffer(multimeshes[i], _create_multimesh_buffer(2000, 1));
+		instances[i] = rs->instance_create2(multimeshes[i], scenario);
+	}
+	_check_multimesh_views(camera, scenario, multimeshes[0], multimeshes[1], "at first");
+
+	for (int i = 0; i < 2; i++) {
+		rs->multimesh_set_buffer(multimeshes[i], _create_multimesh_buffer(2000, 2));
+	}
+	_check_multimesh_views(camera, scenario, multimeshes[0], multimeshes[1], "after a buffer update");
+
+	for (int i = 0; i < 2; i++) {
+		for (int j = 0; j < 2000; j += 100) {
+			rs->multimesh_instance_set_transform(multimeshes[i], j, Transform(Basis(), Vector3(j * 0.001, 0, -5)));
+		}
+	}
+	_check_multimesh_views(camera, scenario, multimeshes[0], multimeshes[1], "after moving instances");
+
+	for (int i = 0; i < 2; i++) {
+		rs->multimesh_allocate_data(multimeshes[i], 3000, RS::MULTIMESH_TRANSFORM_3D);
+		rs->multimesh_set_buffer(multimeshes[i], _create_multimesh_buffer(3000, 3));
+	}
+	_check_multimesh_views(camera, scenario, multimeshes[0], multimeshes[1], "after the instance count changed");
+
+	for (int i = 0; i < 2; i++) {
+		rs->multimesh_set_visible_instances(multimeshes[i], 1000);
+	}
+	_check_multimesh_views(camera, scenario, multimeshes[0], multimeshes[1], "with fewer visible instances");
+
+	for (int i = 0; i < 2; i++) {
+		rs->free(instances[i]);
+		rs->free(multimeshes[i]);
+	}
+	rs->free(mesh);
+	rs->free(camera);
+	rs->free(scenario);
+
+	rs->finish();
+	memdelete(rs);
+}
+
+} // namespace TestRenderingServer
+
+#endif // TEST_RENDERING_SERVER_H
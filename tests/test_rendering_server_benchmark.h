@@ -0,0 +1,782 @@
+/*************************************************************************/
+/*  test_rendering_server_benchmark.h                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDERING_SERVER_BENCHMARK_H
+#define TEST_RENDERING_SERVER_BENCHMARK_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "drivers/dummy/rasterizer_dummy.h"
+#include "servers/rendering/rendering_server_default.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRenderingServerBenchmark {
+
+struct ShadowPass {
+	RID light;
+	int pass = 0;
+	uint64_t static_version = 0;
+	int static_casters = 0;
+	int casters = 0;
+};
+
+// What reached the backend, summed over the measured frames.
+struct Recording {
+	uint64_t scenes = 0;
+	uint64_t instances = 0;
+	uint64_t lights = 0;
+	uint64_t shadow_passes = 0;
+	uint64_t shadow_casters = 0;
+	uint64_t canvas_items = 0;
+	Vector<ShadowPass> last_shadow_passes; // Of the last rendered scene.
+};
+
+// The dummy storage keeps meshes but no lights, so no light would ever be culled. This one also
+// keeps what the culling code reads from lights and still does no GPU work.
+class RecordingStorage : public RasterizerStorageDummy {
+	struct Light {
+		RS::LightType type = RS::LIGHT_OMNI;
+		float param[RS::LIGHT_PARAM_MAX] = {};
+		bool shadow = false;
+		RS::LightDirectionalShadowMode directional_shadow_mode = RS::LIGHT_DIRECTIONAL_SHADOW_ORTHOGONAL;
+		RS::LightOmniShadowMode omni_shadow_mode = RS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID;
+	};
+
+	mutable RID_PtrOwner<Light> light_owner;
+	RID_Owner<int> render_target_owner;
+
+	RID _light_allocate() {
+		Light *light = memnew(Light);
+		light->param[RS::LIGHT_PARAM_ENERGY] = 1.0;
+		light->param[RS::LIGHT_PARAM_RANGE] = 1.0;
+		light->param[RS::LIGHT_PARAM_SPOT_ANGLE] = 45;
+		light->param[RS::LIGHT_PARAM_SHADOW_SPLIT_1_OFFSET] = 0.1;
+		light->param[RS::LIGHT_PARAM_SHADOW_SPLIT_2_OFFSET] = 0.3;
+		light->param[RS::LIGHT_PARAM_SHADOW_SPLIT_3_OFFSET] = 0.6;
+		light->param[RS::LIGHT_PARAM_SHADOW_FADE_START] = 0.8;
+		light->param[RS::LIGHT_PARAM_SHADOW_PANCAKE_SIZE] = 20.0;
+		return light_owner.make_rid(light);
+	}
+
+	void _light_set_type(RID p_light, RS::LightType p_type) {
+		Light *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND(!light);
+		light->type = p_type;
+	}
+
+public:
+	RID directional_light_allocate() override { return _light_allocate(); }
+	void directional_light_initialize(RID p_rid) override { _light_set_type(p_rid, RS::LIGHT_DIRECTIONAL); }
+	RID omni_light_allocate() override { return _light_allocate(); }
+	void omni_light_initialize(RID p_rid) override { _light_set_type(p_rid, RS::LIGHT_OMNI); }
+	RID spot_light_allocate() override { return _light_allocate(); }
+	void spot_light_initialize(RID p_rid) override { _light_set_type(p_rid, RS::LIGHT_SPOT); }
+
+	void light_set_param(RID p_light, RS::LightParam p_param, float p_value) override {
+		Light *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND(!light);
+		ERR_FAIL_INDEX(p_param, RS::LIGHT_PARAM_MAX);
+		light->param[p_param] = p_value;
+	}
+	void light_set_shadow(RID p_light, bool p_enabled) override {
+		Light *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND(!light);
+		light->shadow = p_enabled;
+	}
+	void light_directional_set_shadow_mode(RID p_light, RS::LightDirectionalShadowMode p_mode) override {
+		Light *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND(!light);
+		light->directional_shadow_mode = p_mode;
+	}
+	void light_omni_set_shadow_mode(RID p_light, RS::LightOmniShadowMode p_mode) override {
+		Light *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND(!light);
+		light->omni_shadow_mode = p_mode;
+	}
+
+	RS::LightDirectionalShadowMode light_directional_get_shadow_mode(RID p_light) override {
+		const Light *light = light_owner.getornull(p_light);
+		return light ? light->directional_shadow_mode : RS::LIGHT_DIRECTIONAL_SHADOW_ORTHOGONAL;
+	}
+	RS::LightOmniShadowMode light_omni_get_shadow_mode(RID p_light) override {
+		const Light *light = light_owner.getornull(p_light);
+		return light ? light->omni_shadow_mode : RS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID;
+	}
+	bool light_has_shadow(RID p_light) const override {
+		const Light *light = light_owner.getornull(p_light);
+		return light && light->shadow;
+	}
+	RS::LightType light_get_type(RID p_light) const override {
+		const Light *light = light_owner.getornull(p_light);
+		return light ? light->type : RS::LIGHT_OMNI;
+	}
+	float light_get_param(RID p_light, RS::LightParam p_param) override {
+		const Light *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND_V(!light, 0.0);
+		ERR_FAIL_INDEX_V(p_param, RS::LIGHT_PARAM_MAX, 0.0);
+		return light->param[p_param];
+	}
+	AABB light_get_aabb(RID p_light) const override {
+		const Light *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND_V(!light, AABB());
+
+		switch (light->type) {
+			case RS::LIGHT_SPOT: {
+				float len = light->param[RS::LIGHT_PARAM_RANGE];
+				float size = Math::tan(Math::deg2rad(light->param[RS::LIGHT_PARAM_SPOT_ANGLE])) * len;
+				return AABB(Vector3(-size, -size, -len), Vector3(size * 2, size * 2, len));
+			}
+			case RS::LIGHT_OMNI: {
+				float r = light->param[RS::LIGHT_PARAM_RANGE];
+				return AABB(-Vector3(r, r, r), Vector3(r, r, r) * 2);
+			}
+			default: {
+				return AABB();
+			}
+		}
+	}
+
+	RID render_target_create() override { return render_target_owner.make_rid(0); }
+
+	RS::InstanceType get_base_type(RID p_rid) const override {
+		if (light_owner.owns(p_rid)) {
+			return RS::INSTANCE_LIGHT;
+		}
+		return RasterizerStorageDummy::get_base_type(p_rid);
+	}
+
+	bool free(RID p_rid) override {
+		if (light_owner.owns(p_rid)) {
+			memdelete(light_owner.getornull(p_rid));
+			light_owner.free(p_rid);
+		} else if (render_target_owner.owns(p_rid)) {
+			render_target_owner.free(p_rid);
+		} else {
+			return RasterizerStorageDummy::free(p_rid);
+		}
+		return true;
+	}
+};
+
+class RecordingScene : public RasterizerSceneDummy {
+	RID_Owner<int> handle_owner; // Light instances, shadow atlases and render buffers, only need to be valid.
+	Map<RID, uint64_t> shadow_versions;
+	Map<RID, RID> light_instance_lights;
+
+public:
+	Recording *recording = nullptr;
+
+	// Distinct, so the static shadow layers can tell their casters apart.
+	GeometryInstance *geometry_instance_create(RID p_base) override { return memnew(GeometryInstance); }
+	void geometry_instance_free(GeometryInstance *p_geometry_instance) override { memdelete(p_geometry_instance); }
+
+	RID light_instance_create(RID p_light) override {
+		RID light_instance = handle_owner.make_rid(0);
+		light_instance_lights[light_instance] = p_light;
+		return light_instance;
+	}
+	RID shadow_atlas_create() override { return handle_owner.make_rid(0); }
+	RID render_buffers_create() override { return handle_owner.make_rid(0); }
+
+	bool shadow_atlas_update_light(RID p_atlas, RID p_light_intance, float p_coverage, uint64_t p_light_version) override {
+		// Redraw only when the light version changed, like a real shadow atlas would.
+		Map<RID, uint64_t>::Element *E = shadow_versions.find(p_light_intance);
+		if (E && E->get() == p_light_version) {
+			return false;
+		}
+		shadow_versions[p_light_intance] = p_light_version;
+		return true;
+	}
+	int get_directional_light_shadow_size(RID p_light_intance) override { return 2048; }
+
+	void render_scene(RID p_render_buffers, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_ortogonal, const PagedArray<GeometryInstance *> &p_instances, const PagedArray<RID> &p_lights, const PagedArray<RID> &p_reflection_probes, const PagedArray<RID> &p_gi_probes, const PagedArray<RID> &p_decals, const PagedArray<RID> &p_lightmaps, RID p_environment, RID p_camera_effects, RID p_shadow_atlas, RID p_occluder_debug_tex, RID p_reflection_atlas, RID p_reflection_probe, int p_reflection_probe_pass, float p_screen_lod_threshold, const RenderShadowData *p_render_shadows, int p_render_shadow_count, const RenderSDFGIData *p_render_sdfgi_regions, int p_render_sdfgi_region_count, const RenderSDFGIUpdateData *p_sdfgi_update_data = nullptr) override {
+		recording->scenes++;
+		recording->instances += p_instances.size();
+		recording->lights += p_lights.size();
+		recording->shadow_passes += p_render_shadow_count;
+		recording->last_shadow_passes.clear();
+		for (int i = 0; i < p_render_shadow_count; i++) {
+			const RenderShadowData &shadow = p_render_shadows[i];
+			recording->shadow_casters += shadow.instances.size() + shadow.static_instances.size();
+
+			ShadowPass pass;
+			pass.light = light_instance_lights[shadow.light];
+			pass.pass = shadow.pass;
+			pass.static_version = shadow.static_version;
+			pass.static_casters = shadow.static_instances.size();
+			pass.casters = shadow.instances.size();
+			recording->last_shadow_passes.push_back(pass);
+		}
+	}
+
+	bool free(RID p_rid) override {
+		if (handle_owner.owns(p_rid)) {
+			shadow_versions.erase(p_rid);
+			light_instance_lights.erase(p_rid);
+			handle_owner.free(p_rid);
+			return true;
+		}
+		return false;
+	}
+};
+
+class RecordingCanvas : public RasterizerCanvasDummy {
+public:
+	Recording *recording = nullptr;
+
+	void canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, Light *p_directional_list, const Transform2D &p_canvas_transform, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, bool &r_sdf_used) override {
+		for (Item *item = p_item_list; item; item = item->next) {
+			recording->canvas_items++;
+		}
+	}
+
+	bool free(RID p_rid) override { return false; }
+};
+
+class RecordingCompositor : public RendererCompositor {
+	RecordingStorage storage;
+	RecordingCanvas canvas;
+	RecordingScene scene;
+
+	uint64_t frame = 1;
+	float delta = 0;
+
+	static RendererCompositor *_create_current() {
+		return memnew(RecordingCompositor);
+	}
+
+public:
+	Recording recording;
+
+	RendererStorage *get_storage() override { return &storage; }
+	RendererCanvasRender *get_canvas() override { return &canvas; }
+	RendererSceneRender *get_scene() override { return &scene; }
+
+	void set_boot_image(const Ref<Image> &p_image, const Color &p_color, bool p_scale, bool p_use_filter = true) override {}
+
+	void initialize() override {}
+	void begin_frame(double frame_step) override {
+		frame++;
+		delta = frame_step;
+	}
+
+	void prepare_for_blitting_render_targets() override {}
+	void blit_render_targets_to_screen(DisplayServer::WindowID p_screen, const BlitToScreen *p_render_targets, int p_amount) override {}
+
+	void end_frame(bool p_swap_buffers) override {}
+	void finalize() override {}
+
+	uint64_t get_frame_number() const override { return frame; }
+	float get_frame_delta_time() const override { return delta; }
+	bool is_low_end() const override { return false; }
+
+	static void make_current() {
+		_create_func = _create_current;
+	}
+
+	RecordingCompositor() {
+		canvas.recording = &recording;
+		scene.recording = &recording;
+	}
+};
+
+struct Settings {
+	int frames = 100;
+	int instances = 100000;
+	int moving_instances = 10000;
+	int lights = 64;
+	int canvas_items = 100000;
+	int canvas_depth = 100;
+};
+
+struct StageTime {
+	uint64_t total = 0;
+	uint64_t min = UINT64_MAX;
+	uint64_t max = 0;
+
+	void add(uint64_t p_usec) {
+		total += p_usec;
+		min = MIN(min, p_usec);
+		max = MAX(max, p_usec);
+	}
+};
+
+struct Result {
+	int frames = 0;
+	StageTime commands; // Issuing the rendering server calls that change the scenario.
+	StageTime scene_update; // Dirty instance updates and BVH optimization.
+	StageTime viewports; // Culling and everything else done to draw the viewports.
+	Recording recording;
+};
+
+class BenchmarkScenario {
+public:
+	virtual void update(RenderingServer *p_rs, int p_frame) = 0;
+	virtual ~BenchmarkScenario() {}
+};
+
+// A field of cubes with moving casters, moving shadowed omni and spot lights and a directional light.
+static RID _create_box_mesh(RenderingServer *p_rs) {
+	Array arrays;
+	arrays.resize(RS::ARRAY_MAX);
+	PackedVector3Array vertices;
+	for (int i = 0; i < 8; i++) {
+		vertices.push_back(Vector3(i & 1 ? 0.5 : -0.5, i & 2 ? 0.5 : -0.5, i & 4 ? 0.5 : -0.5));
+	}
+	const int faces[6][4] = { { 0, 1, 3, 2 }, { 4, 6, 7, 5 }, { 0, 4, 5, 1 }, { 2, 3, 7, 6 }, { 0, 2, 6, 4 }, { 1, 5, 7, 3 } };
+	PackedInt32Array indices;
+	for (int i = 0; i < 6; i++) {
+		indices.push_back(faces[i][0]);
+		indices.push_back(faces[i][1]);
+		indices.push_back(faces[i][2]);
+		indices.push_back(faces[i][0]);
+		indices.push_back(faces[i][2]);
+		indices.push_back(faces[i][3]);
+	}
+	arrays[RS::ARRAY_VERTEX] = vertices;
+	arrays[RS::ARRAY_INDEX] = indices;
+	RID mesh = p_rs->mesh_create();
+	p_rs->mesh_add_surface_from_arrays(mesh, RS::PRIMITIVE_TRIANGLES, arrays);
+	return mesh;
+}
+
+class Scenario3D : public BenchmarkScenario {
+	RID mesh;
+	RID scenario;
+	RID camera;
+	RID viewport;
+	RID directional_light;
+	RID directional_instance;
+
+	LocalVector<RID> instances;
+	LocalVector<Transform> transforms;
+	int moving_instances = 0;
+
+	LocalVector<RID> lights;
+	LocalVector<RID> light_instances;
+	LocalVector<Vector3> light_centers;
+
+public:
+	Scenario3D(RenderingServer *p_rs, const Settings &p_settings) {
+		RandomPCG rng(12345);
+
+		mesh = _create_box_mesh(p_rs);
+		scenario = p_rs->scenario_create();
+
+		float extent = Math::pow(float(p_settings.instances), 1.0f / 3.0f) * 2.0;
+		instances.resize(p_settings.instances);
+		transforms.resize(p_settings.instances);
+		for (int i = 0; i < p_settings.instances; i++) {
+			Transform xform;
+			xform.basis = Basis(Vector3(0, 1, 0), rng.randf() * Math_TAU);
+			xform.origin = Vector3(rng.random(-extent, extent), rng.random(-extent * 0.25, extent * 0.25), rng.random(-extent, extent));
+			transforms[i] = xform;
+			instances[i] = p_rs->instance_create2(mesh, scenario);
+			p_rs->instance_set_transform(instances[i], xform);
+		}
+		moving_instances = MIN(p_settings.moving_instances, p_settings.instances);
+
+		for (int i = 0; i < p_settings.lights; i++) {
+			RID light = (i & 1) ? p_rs->spot_light_create() : p_rs->omni_light_create();
+			p_rs->light_set_param(light, RS::LIGHT_PARAM_RANGE, (i & 1) ? 12.0 : 8.0);
+			p_rs->light_set_shadow(light, true);
+			lights.push_back(light);
+			light_instances.push_back(p_rs->instance_create2(light, scenario));
+			light_centers.push_back(Vector3(rng.random(-extent, extent), 0, rng.random(-extent, extent)));
+		}
+
+		directional_light = p_rs->directional_light_create();
+		p_rs->light_set_shadow(directional_light, true);
+		p_rs->light_set_param(directional_light, RS::LIGHT_PARAM_SHADOW_MAX_DISTANCE, 100.0);
+		p_rs->light_directional_set_shadow_mode(directional_light, RS::LIGHT_DIRECTIONAL_SHADOW_PARALLEL_4_SPLITS);
+		directional_instance = p_rs->instance_create2(directional_light, scenario);
+		Transform sun;
+		sun.set_look_at(Vector3(), Vector3(0.3, -1, -0.5), Vector3(0, 1, 0));
+		p_rs->instance_set_transform(directional_instance, sun);
+
+		camera = p_rs->camera_create();
+		p_rs->camera_set_perspective(camera, 70, 0.05, extent * 2.0);
+
+		viewport = p_rs->viewport_create();
+		p_rs->viewport_set_size(viewport, 1920, 1080);
+		p_rs->viewport_set_update_mode(viewport, RS::VIEWPORT_UPDATE_ALWAYS);
+		p_rs->viewport_set_shadow_atlas_size(viewport, 4096);
+		p_rs->viewport_attach_camera(viewport, camera);
+		p_rs->viewport_set_scenario(viewport, scenario);
+		p_rs->viewport_set_active(viewport, true);
+	}
+
+	void update(RenderingServer *p_rs, int p_frame) override {
+		p_rs->camera_set_transform(camera, Transform(Basis(Vector3(0, 1, 0), p_frame * 0.01), Vector3(0, 2, 0)));
+
+		for (int i = 0; i < moving_instances; i++) {
+			Transform xform = transforms[i];
+			xform.origin.y += Math::sin(p_frame * 0.1 + i);
+			p_rs->instance_set_transform(instances[i], xform);
+		}
+
+		for (uint32_t i = 0; i < light_instances.size(); i++) {
+			float angle = p_frame * 0.05 + i;
+			Transform xform;
+			xform.origin = light_centers[i] + Vector3(Math::cos(angle), 0, Math::sin(angle)) * 4.0;
+			xform.basis = Basis(Vector3(1, 0, 0), -Math_PI * 0.4);
+			p_rs->instance_set_transform(light_instances[i], xform);
+		}
+	}
+
+	~Scenario3D() {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		rs->free(viewport);
+		rs->free(camera);
+		for (uint32_t i = 0; i < instances.size(); i++) {
+			rs->free(instances[i]);
+		}
+		for (uint32_t i = 0; i < lights.size(); i++) {
+			rs->free(light_instances[i]);
+			rs->free(lights[i]);
+		}
+		rs->free(directional_instance);
+		rs->free(directional_light);
+		rs->free(scenario);
+		rs->free(mesh);
+	}
+};
+
+// Deep canvas item chains, the roots move every frame so every global transform changes.
+class Scenario2D : public BenchmarkScenario {
+	RID canvas;
+	RID viewport;
+	LocalVector<RID> items;
+	LocalVector<RID> roots;
+
+public:
+	Scenario2D(RenderingServer *p_rs, const Settings &p_settings) {
+		canvas = p_rs->canvas_create();
+
+		int depth = MAX(p_settings.canvas_depth, 1);
+		for (int i = 0; i < p_settings.canvas_items; i++) {
+			RID item = p_rs->canvas_item_create();
+			if (i % depth == 0) {
+				p_rs->canvas_item_set_parent(item, canvas);
+				roots.push_back(item);
+			} else {
+				p_rs->canvas_item_set_parent(item, items[i - 1]);
+				p_rs->canvas_item_set_transform(item, Transform2D(0.01, Vector2(4, 2)));
+			}
+			p_rs->canvas_item_add_rect(item, Rect2(0, 0, 16, 16), Color(1, 1, 1));
+			items.push_back(item);
+		}
+
+		viewport = p_rs->viewport_create();
+		p_rs->viewport_set_size(viewport, 1920, 1080);
+		p_rs->viewport_set_update_mode(viewport, RS::VIEWPORT_UPDATE_ALWAYS);
+		p_rs->viewport_attach_canvas(viewport, canvas);
+		p_rs->viewport_set_active(viewport, true);
+	}
+
+	void update(RenderingServer *p_rs, int p_frame) override {
+		// Spread the roots over an area larger than the viewport, so part of them are culled.
+		int columns = MAX(int(Math::sqrt(float(roots.size()))), 1);
+		for (uint32_t i = 0; i < roots.size(); i++) {
+			Vector2 position = Vector2((i % columns) * 4000.0 / columns, (i / columns) * 4000.0 / columns);
+			position += Vector2(Math::cos(p_frame * 0.05 + i), Math::sin(p_frame * 0.05 + i)) * 50.0;
+			p_rs->canvas_item_set_transform(roots[i], Transform2D(p_frame * 0.01, position));
+		}
+	}
+
+	~Scenario2D() {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		rs->free(viewport);
+		for (int i = items.size() - 1; i >= 0; i--) {
+			rs->free(items[i]);
+		}
+		rs->free(canvas);
+	}
+};
+
+// Runs the real RenderingServerDefault, RendererSceneCull and RendererCanvasCull over the recording backend.
+class Benchmark {
+	RenderingServer *rs = nullptr;
+	RecordingCompositor *compositor = nullptr;
+
+public:
+	RenderingServer *get_rendering_server() const { return rs; }
+
+	Result run(BenchmarkScenario *p_scenario, int p_frames) {
+		const int warmup_frames = 2;
+		Result result;
+		result.frames = p_frames;
+
+		for (int frame = 0; frame < warmup_frames + p_frames; frame++) {
+			if (frame == warmup_frames) {
+				compositor->recording = Recording();
+			}
+
+			uint64_t from = OS::get_singleton()->get_ticks_usec();
+			p_scenario->update(rs, frame);
+			uint64_t commands = OS::get_singleton()->get_ticks_usec() - from;
+
+			from = OS::get_singleton()->get_ticks_usec();
+			rs->draw(false, 1.0 / 60.0);
+			uint64_t draw = OS::get_singleton()->get_ticks_usec() - from;
+			uint64_t scene_update = MIN(uint64_t(rs->get_frame_setup_time_cpu() * 1000.0), draw);
+
+			if (frame >= warmup_frames) {
+				result.commands.add(commands);
+				result.scene_update.add(scene_update);
+				result.viewports.add(draw - scene_update);
+			}
+		}
+
+		result.recording = compositor->recording;
+		return result;
+	}
+
+	Benchmark() {
+		RecordingCompositor::make_current();
+		rs = memnew(RenderingServerDefault(false));
+		rs->init();
+		compositor = static_cast<RecordingCompositor *>(RSG::rasterizer);
+	}
+
+	~Benchmark() {
+		rs->finish();
+		memdelete(rs);
+	}
+};
+
+static void _print_stage(const String &p_name, const StageTime &p_time, int p_frames) {
+	print_line(vformat("  %s: avg %d usec, min %d usec, max %d usec", p_name, p_time.total / MAX(p_frames, 1), p_time.min, p_time.max));
+}
+
+static void _print_result(const String &p_name, const Result &p_result) {
+	int frames = MAX(p_result.frames, 1);
+	print_line(vformat("%s (%d frames):", p_name, p_result.frames));
+	_print_stage("commands", p_result.commands, frames);
+	_print_stage("scene update", p_result.scene_update, frames);
+	_print_stage("cull and draw viewports", p_result.viewports, frames);
+	const Recording &r = p_result.recording;
+	print_line(vformat("  per frame: %d instances, %d lights, %d shadow passes, %d shadow casters, %d canvas items", r.instances / frames, r.lights / frames, r.shadow_passes / frames, r.shadow_casters / frames, r.canvas_items / frames));
+}
+
+// Usage: godot --test rendering-server-benchmark [--frames N] [--instances N] [--moving-instances N] [--lights N] [--canvas-items N] [--canvas-depth N]
+static void benchmark() {
+	Settings settings;
+	List<String> args = OS::get_singleton()->get_cmdline_args();
+	for (List<String>::Element *E = args.front(); E && E->next(); E = E->next()) {
+		int value = E->next()->get().to_int();
+		if (E->get() == "--frames") {
+			settings.frames = value;
+		} else if (E->get() == "--instances") {
+			settings.instances = value;
+		} else if (E->get() == "--moving-instances") {
+			settings.moving_instances = value;
+		} else if (E->get() == "--lights") {
+			settings.lights = value;
+		} else if (E->get() == "--canvas-items") {
+			settings.canvas_items = value;
+		} else if (E->get() == "--canvas-depth") {
+			settings.canvas_depth = value;
+		}
+	}
+
+	Benchmark benchmark;
+	RenderingServer *rs = benchmark.get_rendering_server();
+
+	{
+		Scenario3D scenario(rs, settings);
+		_print_result(vformat("3D: %d instances, %d moving, %d shadowed lights", settings.instances, settings.moving_instances, settings.lights), benchmark.run(&scenario, settings.frames));
+	}
+	{
+		Scenario2D scenario(rs, settings);
+		_print_result(vformat("2D: %d canvas items, %d deep", settings.canvas_items, settings.canvas_depth), benchmark.run(&scenario, settings.frames));
+	}
+}
+
+REGISTER_TEST_COMMAND("rendering-server-benchmark", &benchmark);
+
+TEST_CASE("[RenderingServer] Benchmark scenarios reach the recording backend") {
+	Settings settings;
+	settings.frames = 3;
+	settings.instances = 2000;
+	settings.moving_instances = 200;
+	settings.lights = 8;
+	settings.canvas_items = 1000;
+	settings.canvas_depth = 10;
+
+	Benchmark benchmark;
+	RenderingServer *rs = benchmark.get_rendering_server();
+
+	{
+		Scenario3D scenario(rs, settings);
+		Result result = benchmark.run(&scenario, settings.frames);
+		CHECK_MESSAGE(result.recording.scenes == uint64_t(settings.frames), "The viewport should render its camera once per frame.");
+		CHECK_MESSAGE(result.recording.instances > 0, "Instances in front of the camera should reach the backend.");
+		CHECK_MESSAGE(result.recording.instances < uint64_t(settings.instances * settings.frames), "Instances behind the camera should be culled.");
+		CHECK_MESSAGE(result.recording.shadow_passes > 0, "The directional light cascades should be rendered.");
+	}
+	{
+		Scenario2D scenario(rs, settings);
+		Result result = benchmark.run(&scenario, settings.frames);
+		CHECK_MESSAGE(result.recording.canvas_items > 0, "Canvas items in the viewport should reach the backend.");
+		CHECK_MESSAGE(result.recording.canvas_items < uint64_t(settings.canvas_items * settings.frames), "Canvas items outside the viewport should be culled.");
+	}
+}
+
+// The last shadow pass drawn for the light, with no casters if it was not drawn.
+static ShadowPass _get_shadow_pass(RID p_light) {
+	const Vector<ShadowPass> &passes = static_cast<RecordingCompositor *>(RSG::rasterizer)->recording.last_shadow_passes;
+	for (int i = 0; i < passes.size(); i++) {
+		if (passes[i].light == p_light) {
+			return passes[i];
+		}
+	}
+	return ShadowPass();
+}
+
+// Moves a caster every frame, so the shadows are drawn every frame.
+static void _draw_shadow_frames(RenderingServer *p_rs, RID p_moving_instance, int &r_frame, int p_count) {
+	for (int i = 0; i < p_count; i++) {
+		r_frame++;
+		p_rs->instance_set_transform(p_moving_instance, Transform(Basis(), Vector3(Math::sin(r_frame * 0.1) * 2.0, 0.5, 0)));
+		p_rs->draw(false, 1.0 / 60.0);
+	}
+}
+
+TEST_CASE("[RenderingServer] Static shadow layers are redrawn only when their casters change") {
+	Benchmark benchmark;
+	RenderingServer *rs = benchmark.get_rendering_server();
+	static_cast<RendererSceneCull *>(RSG::scene)->static_shadow_cache_enabled = true;
+
+	RID mesh = _create_box_mesh(rs);
+	RID scenario = rs->scenario_create();
+
+	RID static_instances[4];
+	for (int i = 0; i < 4; i++) {
+		static_instances[i] = rs->instance_create2(mesh, scenario);
+		rs->instance_set_transform(static_instances[i], Transform(Basis(), Vector3(i * 2.0 - 3.0, 0, -2)));
+	}
+	RID moving_instance = rs->instance_create2(mesh, scenario);
+
+	RID spot = rs->spot_light_create();
+	rs->light_set_param(spot, RS::LIGHT_PARAM_RANGE, 20.0);
+	rs->light_set_shadow(spot, true);
+	RID spot_instance = rs->instance_create2(spot, scenario);
+	rs->instance_set_transform(spot_instance, Transform(Basis(Vector3(1, 0, 0), -Math_PI * 0.5), Vector3(0, 8, -1)));
+
+	RID sun = rs->directional_light_create();
+	rs->light_set_shadow(sun, true);
+	rs->light_set_param(sun, RS::LIGHT_PARAM_SHADOW_MAX_DISTANCE, 50.0);
+	RID sun_instance = rs->instance_create2(sun, scenario);
+	Transform sun_xform;
+	sun_xform.set_look_at(Vector3(), Vector3(0.3, -1, -0.5), Vector3(0, 1, 0));
+	rs->instance_set_transform(sun_instance, sun_xform);
+
+	RID camera = rs->camera_create();
+	rs->camera_set_perspective(camera, 70, 0.05, 100);
+	rs->camera_set_transform(camera, Transform(Basis(), Vector3(0, 2, 8)));
+
+	RID viewport = rs->viewport_create();
+	rs->viewport_set_size(viewport, 1920, 1080);
+	rs->viewport_set_update_mode(viewport, RS::VIEWPORT_UPDATE_ALWAYS);
+	rs->viewport_set_shadow_atlas_size(viewport, 4096);
+	rs->viewport_attach_camera(viewport, camera);
+	rs->viewport_set_scenario(viewport, scenario);
+	rs->viewport_set_active(viewport, true);
+
+	int frame = 0;
+	_draw_shadow_frames(rs, moving_instance, frame, 40);
+	ShadowPass spot_pass = _get_shadow_pass(spot);
+	ShadowPass sun_pass = _get_shadow_pass(sun);
+	REQUIRE_MESSAGE(spot_pass.static_version != 0, "Casters that stopped changing should be drawn to a static layer.");
+	REQUIRE(sun_pass.static_version != 0);
+	CHECK(spot_pass.static_casters == 4);
+	CHECK(sun_pass.static_casters == 4);
+	CHECK_MESSAGE(spot_pass.casters == 1, "The moving caster should be drawn over the static layer.");
+	CHECK(sun_pass.casters == 1);
+
+	_draw_shadow_frames(rs, moving_instance, frame, 5);
+	CHECK_MESSAGE(_get_shadow_pass(spot).static_version == spot_pass.static_version, "The static layer should be reused while its casters stay still.");
+	CHECK(_get_shadow_pass(sun).static_version == sun_pass.static_version);
+
+	// Cascades move in steps, a camera moving a little keeps using the same static layer.
+	rs->camera_set_transform(camera, Transform(Basis(), Vector3(0.2, 2, 8.2)));
+	_draw_shadow_frames(rs, moving_instance, frame, 1);
+	CHECK_MESSAGE(_get_shadow_pass(sun).static_version == sun_pass.static_version, "A small camera move should not redraw the static cascade.");
+	rs->camera_set_transform(camera, Transform(Basis(), Vector3(30, 2, 8)));
+	_draw_shadow_frames(rs, moving_instance, frame, 1);
+	CHECK_MESSAGE(_get_shadow_pass(sun).static_version != sun_pass.static_version, "A cascade that moved should redraw its static layer.");
+
+	rs->camera_set_transform(camera, Transform(Basis(), Vector3(0, 2, 8)));
+	_draw_shadow_frames(rs, moving_instance, frame, 2);
+	sun_pass = _get_shadow_pass(sun);
+
+	// A static caster that moves leaves the static layer, which is redrawn without it.
+	rs->instance_set_transform(static_instances[0], Transform(Basis(), Vector3(-3, 0, -4)));
+	_draw_shadow_frames(rs, moving_instance, frame, 1);
+	ShadowPass changed_pass = _get_shadow_pass(spot);
+	CHECK(changed_pass.static_casters == 3);
+	CHECK(changed_pass.casters == 2);
+	CHECK_MESSAGE(changed_pass.static_version != spot_pass.static_version, "The static layer should be redrawn when a static caster moves.");
+	CHECK_MESSAGE(_get_shadow_pass(sun).static_version != sun_pass.static_version, "The static cascade should be redrawn when a static caster moves.");
+
+	_draw_shadow_frames(rs, moving_instance, frame, 35);
+	spot_pass = _get_shadow_pass(spot);
+	CHECK_MESSAGE(spot_pass.static_casters == 4, "A caster that stopped moving again should return to the static layer.");
+	CHECK(spot_pass.static_version != changed_pass.static_version);
+
+	rs->instance_set_visible(static_instances[1], false);
+	_draw_shadow_frames(rs, moving_instance, frame, 1);
+	CHECK(_get_shadow_pass(spot).static_casters == 3);
+	CHECK_MESSAGE(_get_shadow_pass(spot).static_version != spot_pass.static_version, "The static layer should be redrawn when a static caster is hidden.");
+
+	rs->instance_set_transform(spot_instance, Transform(Basis(Vector3(1, 0, 0), -Math_PI * 0.5), Vector3(0, 8, 0)));
+	_draw_shadow_frames(rs, moving_instance, frame, 1);
+	CHECK_MESSAGE(_get_shadow_pass(spot).static_version == 0, "A light that moved should draw all its casters again.");
+	CHECK(_get_shadow_pass(spot).casters == 4);
+
+	rs->free(viewport);
+	rs->free(camera);
+	for (int i = 0; i < 4; i++) {
+		rs->free(static_instances[i]);
+	}
+	rs->free(moving_instance);
+	rs->free(spot_instance);
+	rs->free(spot);
+	rs->free(sun_instance);
+	rs->free(sun);
+	rs->free(scenario);
+	rs->free(mesh);
+}
+
+} // namespace TestRenderingServerBenchmark
+
+#endif // TEST_RENDERING_SERVER_BENCHMARK_H
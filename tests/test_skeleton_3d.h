@@ -0,0 +1,146 @@
+/*************************************************************************/
+/*  test_skeleton_3d.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SKELETON_3D_H
+#define TEST_SKELETON_3D_H
+
+#include "core/object/message_queue.h"
+#include "scene/3d/skeleton_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSkeleton3D {
+
+// Skeletons queue their updates, the test runner doesn't create a message queue.
+class ScopedMessageQueue {
+	MessageQueue *queue = nullptr;
+
+public:
+	ScopedMessageQueue() {
+		if (!MessageQueue::get_singleton()) {
+			queue = memnew(MessageQueue);
+		}
+	}
+	~ScopedMessageQueue() {
+		if (queue) {
+			memdelete(queue);
+		}
+	}
+};
+
+class PoseUpdateCounter : public Object {
+public:
+	int count = 0;
+	void pose_updated() { count++; }
+};
+
+// A chain of three bones, each offset along X from its parent and rotated by p_angle.
+static Skeleton3D *_create_chain(float p_angle) {
+	Skeleton3D *skeleton = memnew(Skeleton3D);
+	for (int i = 0; i < 3; i++) {
+		skeleton->add_bone("bone_" + itos(i));
+		skeleton->set_bone_parent(i, i - 1);
+		skeleton->set_bone_rest(i, Transform(Basis(), Vector3(1, 0, 0)));
+		skeleton->set_bone_pose(i, Transform(Basis(Vector3(0, 0, 1), p_angle), Vector3()));
+	}
+	return skeleton;
+}
+
+static Transform _expected_global_pose(float p_angle, int p_bone) {
+	Transform global;
+	for (int i = 0; i <= p_bone; i++) {
+		global = global * Transform(Basis(), Vector3(1, 0, 0)) * Transform(Basis(Vector3(0, 0, 1), p_angle), Vector3());
+	}
+	return global;
+}
+
+TEST_CASE("[Skeleton3D] Batched update computes every dirty skeleton") {
+	ScopedMessageQueue queue;
+
+	// More than the batch threshold, so the update may be split over threads.
+	Vector<Skeleton3D *> skeletons;
+	for (int i = 0; i < 8; i++) {
+		skeletons.push_back(_create_chain(0.1 * (i + 1)));
+	}
+
+	MessageQueue::get_singleton()->flush();
+
+	for (int i = 0; i < skeletons.size(); i++) {
+		for (int bone = 0; bone < 3; bone++) {
+			CHECK_MESSAGE(skeletons[i]->get_bone_global_pose(bone).is_equal_approx(_expected_global_pose(0.1 * (i + 1), bone)), "Every skeleton of the batch should have its global poses computed.");
+		}
+	}
+
+	// Only the changed bone and its descendants are recomputed, the result must still be complete.
+	skeletons[3]->set_bone_pose(1, Transform());
+	MessageQueue::get_singleton()->flush();
+	Transform expected = _expected_global_pose(0.4, 0) * Transform(Basis(), Vector3(1, 0, 0));
+	CHECK(skeletons[3]->get_bone_global_pose(0).is_equal_approx(_expected_global_pose(0.4, 0)));
+	CHECK(skeletons[3]->get_bone_global_pose(1).is_equal_approx(expected));
+	CHECK(skeletons[3]->get_bone_global_pose(2).is_equal_approx(expected * Transform(Basis(), Vector3(1, 0, 0)) * Transform(Basis(Vector3(0, 0, 1), 0.4), Vector3())));
+
+	for (int i = 0; i < skeletons.size(); i++) {
+		memdelete(skeletons[i]);
+	}
+}
+
+#ifdef TOOLS_ENABLED
+TEST_CASE("[Skeleton3D] Querying a global pose updates only the queried skeleton") {
+	ScopedMessageQueue queue;
+
+	Skeleton3D *queried = _create_chain(0.5);
+	Skeleton3D *other = _create_chain(0.25);
+	MessageQueue::get_singleton()->flush();
+
+	PoseUpdateCounter queried_updates;
+	PoseUpdateCounter other_updates;
+	queried->connect("pose_updated", callable_mp(&queried_updates, &PoseUpdateCounter::pose_updated));
+	other->connect("pose_updated", callable_mp(&other_updates, &PoseUpdateCounter::pose_updated));
+
+	queried->set_bone_pose(2, Transform());
+	other->set_bone_pose(2, Transform());
+
+	CHECK(queried->get_bone_global_pose(2).is_equal_approx(_expected_global_pose(0.5, 1) * Transform(Basis(), Vector3(1, 0, 0))));
+	CHECK_MESSAGE(queried_updates.count == 1, "The queried skeleton should be updated right away.");
+	CHECK_MESSAGE(other_updates.count == 0, "Other dirty skeletons should be left to the deferred update.");
+
+	MessageQueue::get_singleton()->flush();
+	CHECK_MESSAGE(queried_updates.count == 1, "The deferred update should skip the skeleton that is already up to date.");
+	CHECK_MESSAGE(other_updates.count == 1, "The deferred update should update the remaining skeletons.");
+	CHECK(other->get_bone_global_pose(2).is_equal_approx(_expected_global_pose(0.25, 1) * Transform(Basis(), Vector3(1, 0, 0))));
+
+	memdelete(queried);
+	memdelete(other);
+}
+#endif // TOOLS_ENABLED
+
+} // namespace TestSkeleton3D
+
+#endif // TEST_SKELETON_3D_H